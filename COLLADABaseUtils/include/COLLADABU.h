@@ -20,7 +20,10 @@
 #include "COLLADABUhash_map.h"
 #include "COLLADABUIDList.h"
 #include "COLLADABUNativeString.h"
+#ifdef GENERATEDSAXPARSER_VALIDATION
+// only built with the schema validation (USE_VALIDATION), the only user of PCRE
 #include "COLLADABUPcreCompiledPattern.h"
+#endif
 #include "COLLADABUPlatform.h"
 #include "COLLADABUStringUtils.h"
 #include "COLLADABUURI.h"
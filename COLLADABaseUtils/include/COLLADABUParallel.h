@@ -0,0 +1,50 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADABaseUtils.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADABU_PARALLEL_H__
+#define __COLLADABU_PARALLEL_H__
+
+#include "COLLADABUPrerequisites.h"
+
+
+namespace COLLADABU
+{
+
+	/** Work on a range of items, that can be split into independent sub ranges. Derived classes must not
+	modify state shared between sub ranges, other than the state owned by the thread with the index passed
+	to execute().*/
+	class ParallelTask
+	{
+	public:
+		virtual ~ParallelTask(){}
+
+		/** Processes the items with indices in [@a begin, @a end).
+		@param threadIndex The index of the thread processing this range, in [0, number of threads). No two
+		ranges with the same thread index are processed concurrently.*/
+		virtual void execute( size_t begin, size_t end, size_t threadIndex ) = 0;
+	};
+
+	/** Returns the number of threads the hardware can run concurrently. At least 1 is returned.*/
+	size_t getHardwareThreadCount();
+
+	/** Returns the number of threads parallelFor() uses to process @a itemCount items, if called with
+	@a maxThreadCount and @a minItemsPerThread.*/
+	size_t getParallelThreadCount( size_t itemCount, size_t maxThreadCount, size_t minItemsPerThread );
+
+	/** Splits the items [0, @a itemCount) into contiguous ranges of at least @a minItemsPerThread items and
+	processes each range with @a task on its own thread. The calling thread processes the first range. Returns
+	after all ranges have been processed. Exceptions thrown by @a task are rethrown on the calling thread.
+	@param maxThreadCount The maximum number of threads to use. If 0, getHardwareThreadCount() is used.
+	@return The number of threads used, see getParallelThreadCount().*/
+	size_t parallelFor( size_t itemCount, ParallelTask& task, size_t maxThreadCount = 0, size_t minItemsPerThread = 1 );
+
+} // namespace COLLADABU
+
+#endif // __COLLADABU_PARALLEL_H__
@@ -0,0 +1,44 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADABaseUtils.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADABU_TIMER_H__
+#define __COLLADABU_TIMER_H__
+
+#include "COLLADABUPrerequisites.h"
+
+
+namespace COLLADABU
+{
+
+	/** Measures wall clock time, using a monotonic clock. The timer starts, when it is created.*/
+	class Timer
+	{
+	private:
+		/** The time the timer has been started, in nanoseconds since an unspecified point in time.*/
+		long long mStartTime;
+
+	public:
+		/** Constructor. Starts the timer.*/
+		Timer();
+
+		/** Restarts the timer.*/
+		void restart();
+
+		/** Returns the seconds passed since the timer has been started.*/
+		double getElapsedSeconds() const;
+
+	private:
+		/** Returns the current time in nanoseconds since an unspecified point in time.*/
+		static long long now();
+	};
+
+} // namespace COLLADABU
+
+#endif // __COLLADABU_TIMER_H__
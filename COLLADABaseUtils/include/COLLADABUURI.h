@@ -364,6 +364,8 @@ namespace COLLADABU
 		*/
 		void initialize();
 
+    public:
+
 		/** Parses @a path and splits it in its components.*/
 		static void parsePath(const String& path,
 			/* out */ String& dir,
@@ -381,6 +383,7 @@ namespace COLLADABU
 			String& query,
 			String& fragment);
 
+    private:
 
 		/** Checks if th eURI is valid.*/
 		void validate(const URI* baseURI);
@@ -0,0 +1,18 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADABaseUtils.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADABU_PERFORMANCETEST_H__
+#define __COLLADABU_PERFORMANCETEST_H__
+
+/** Measures URI::parseUriRef() and URI::parsePath() against the PCRE implementations they replace.*/
+void performanceTest();
+
+
+#endif // __COLLADABU_PERFORMANCETEST_H__
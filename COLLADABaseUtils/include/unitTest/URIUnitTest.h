@@ -0,0 +1,38 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADABaseUtils.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADABU_URIUNITTEST_H__
+#define __COLLADABU_URIUNITTEST_H__
+
+#include "COLLADABUPrerequisites.h"
+
+
+/** Splits @a uriRef into its components like URI::parseUriRef(), using the regular expression of
+RFC 3986 appendix B, evaluated by PCRE. This is the implementation URI::parseUriRef() replaces.*/
+bool pcreParseUriRef( const COLLADABU::String& uriRef,
+					  COLLADABU::String& scheme,
+					  COLLADABU::String& authority,
+					  COLLADABU::String& path,
+					  COLLADABU::String& query,
+					  COLLADABU::String& fragment );
+
+/** Splits @a path into its components like URI::parsePath(), using the regular expressions for the
+directory and the extension, evaluated by PCRE. This is the implementation URI::parsePath() replaces.*/
+void pcreParsePath( const COLLADABU::String& path,
+					COLLADABU::String& dir,
+					COLLADABU::String& baseName,
+					COLLADABU::String& extension );
+
+/** Compares URI::parseUriRef() and URI::parsePath() with pcreParseUriRef() and pcreParsePath() on hand
+picked and on random input. Returns the number of differences.*/
+size_t uriUnitTest();
+
+
+#endif // __COLLADABU_URIUNITTEST_H__
@@ -0,0 +1,104 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADABaseUtils.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADABUStableHeaders.h"
+#include "COLLADABUParallel.h"
+
+#include <exception>
+#include <thread>
+#include <vector>
+
+
+namespace COLLADABU
+{
+
+	namespace
+	{
+		/** Executes one range of a ParallelTask and keeps the exception it might throw.*/
+		void executeRange( ParallelTask* task, size_t begin, size_t end, size_t threadIndex, std::exception_ptr* exception )
+		{
+			try
+			{
+				task->execute( begin, end, threadIndex );
+			}
+			catch ( ... )
+			{
+				*exception = std::current_exception();
+			}
+		}
+	}
+
+	//------------------------------
+	size_t getHardwareThreadCount()
+	{
+		size_t threadCount = std::thread::hardware_concurrency();
+		return threadCount > 0 ? threadCount : 1;
+	}
+
+	//------------------------------
+	size_t getParallelThreadCount( size_t itemCount, size_t maxThreadCount, size_t minItemsPerThread )
+	{
+		if ( maxThreadCount == 0 )
+			maxThreadCount = getHardwareThreadCount();
+		if ( minItemsPerThread == 0 )
+			minItemsPerThread = 1;
+
+		size_t threadCount = itemCount / minItemsPerThread;
+		if ( threadCount > maxThreadCount )
+			threadCount = maxThreadCount;
+		return threadCount > 0 ? threadCount : 1;
+	}
+
+	//------------------------------
+	size_t parallelFor( size_t itemCount, ParallelTask& task, size_t maxThreadCount, size_t minItemsPerThread )
+	{
+		size_t threadCount = getParallelThreadCount( itemCount, maxThreadCount, minItemsPerThread );
+		if ( itemCount == 0 )
+			return threadCount;
+
+		if ( threadCount == 1 )
+		{
+			task.execute( 0, itemCount, 0 );
+			return threadCount;
+		}
+
+		std::vector<std::exception_ptr> exceptions( threadCount );
+		std::vector<std::thread> threads;
+		threads.reserve( threadCount - 1 );
+
+		size_t itemsPerThread = itemCount / threadCount;
+		size_t remainder = itemCount % threadCount;
+
+		// the first range is processed by the calling thread
+		size_t firstEnd = itemsPerThread + (remainder > 0 ? 1 : 0);
+		size_t begin = firstEnd;
+		for ( size_t i = 1; i < threadCount; ++i )
+		{
+			size_t end = begin + itemsPerThread + (i < remainder ? 1 : 0);
+			threads.push_back( std::thread( executeRange, &task, begin, end, i, &exceptions[i] ) );
+			begin = end;
+		}
+
+		executeRange( &task, 0, firstEnd, 0, &exceptions[0] );
+
+		for ( size_t i = 0; i < threads.size(); ++i )
+		{
+			threads[i].join();
+		}
+
+		for ( size_t i = 0; i < threadCount; ++i )
+		{
+			if ( exceptions[i] )
+				std::rethrow_exception( exceptions[i] );
+		}
+		return threadCount;
+	}
+
+} // namespace COLLADABU
@@ -0,0 +1,44 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADABaseUtils.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADABUStableHeaders.h"
+#include "COLLADABUTimer.h"
+
+#include <chrono>
+
+
+namespace COLLADABU
+{
+
+	//------------------------------
+	Timer::Timer()
+		: mStartTime( now() )
+	{
+	}
+
+	//------------------------------
+	void Timer::restart()
+	{
+		mStartTime = now();
+	}
+
+	//------------------------------
+	double Timer::getElapsedSeconds() const
+	{
+		return (now() - mStartTime) * 1e-9;
+	}
+
+	//------------------------------
+	long long Timer::now()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+	}
+
+} // namespace COLLADABU
@@ -11,19 +11,14 @@
 #include "COLLADABUStableHeaders.h"
 #include "COLLADABUURI.h"
 #include "COLLADABUStringUtils.h"
-#include "COLLADABUPcreCompiledPattern.h"
 #include "COLLADABUHashFunctions.h"
 
 #include <algorithm>
-#include "pcre.h"
 
 namespace COLLADABU
 {
 
 
-	const int regExpMatchesVectorLength = 30;    /* should be a multiple of 3 */
-
-
 	const String URI::SCHEME_FILE = "file";
 	const String URI::SCHEME_HTTP = "http";
 	const String URI::SCHEME_HTTPS = "https";
@@ -130,17 +125,6 @@ namespace COLLADABU
 	}
 
 
-	void setStringFromMatches(String& matchString, const String& entireString, int *resultPositions, int index)
-	{
-		int& startPosition = resultPositions[2*index];
-		int& endPosition = resultPositions[2*index+1];
-		if ( startPosition >= 0)
-		{
-			matchString.assign( entireString, startPosition, endPosition - startPosition);
-		}
-	}
-
-
 	void URI::initialize()
 	{
 		reset();
@@ -291,56 +275,35 @@ namespace COLLADABU
 			// The following implementation cannot handle paths like this:
 			// /tmp/se.3/file
 
-			// regular expression: "(.*/)?(.*)?"
-			static const PcreCompiledPattern findDirCompiledPattern("(.*/)?(.*)?");
-
-			pcre* findDir = findDirCompiledPattern.getCompiledPattern();
-
-
-			// regular expression: "([^.]*)?(\.(.*))?"
-			static const PcreCompiledPattern findExtCompiledPattern("([^.]*)?(\\.(.*))?");
-			pcre* findExt = findExtCompiledPattern.getCompiledPattern();
-			
-			String tmpFile;
+			// This is a hand written equivalent of the regular expressions
+			// "(.*/)?(.*)?" for the directory and "([^.]*)?(\.(.*))?" for the extension.
+			// As in the regular expressions, '.' does not match a line feed, i.e. everything
+			// behind the first line feed is ignored.
 			dir.clear();
 			baseName.clear();
 			extension.clear();
 
-			int dirMatches[regExpMatchesVectorLength];
-
-			int  dirResult = pcre_exec(
-										findDir,           /* the compiled pattern */
-										0,                 /* no extra data - we didn't study the pattern */
-										path.c_str(),      /* the subject string */
-										(int)path.size(),  /* the length of the subject */
-										0,                 /* start at offset 0 in the subject */
-										0,                 /* default options */
-										dirMatches,     /* output vector for substring information */
-										regExpMatchesVectorLength); /* number of elements in the output vector */
-
-			if ( dirResult >= 0 )
-			{	
-				setStringFromMatches(dir, path, dirMatches, 1);
-				setStringFromMatches(tmpFile, path, dirMatches, 2);
-
-				int extMatches[regExpMatchesVectorLength];
-
-				int  extResult = pcre_exec(
-											findExt,           /* the compiled pattern */
-											0,                 /* no extra data - we didn't study the pattern */
-											tmpFile.c_str(),      /* the subject string */
-											(int)tmpFile.size(),  /* the length of the subject */
-											0,                 /* start at offset 0 in the subject */
-											0,                 /* default options */
-											extMatches,     /* output vector for substring information */
-											regExpMatchesVectorLength); /* number of elements in the output vector */
-
-				
-				if ( extResult >= 0 )
-				{
-					setStringFromMatches(baseName, tmpFile, extMatches, 1);
-					setStringFromMatches(extension, tmpFile, extMatches, 3);
-				}
+			size_t lineEnd = path.find('\n');
+			if ( lineEnd == String::npos )
+				lineEnd = path.length();
+
+			size_t fileStart = 0;
+			size_t lastSlash = lineEnd == 0 ? String::npos : path.rfind('/', lineEnd - 1);
+			if ( lastSlash != String::npos )
+			{
+				fileStart = lastSlash + 1;
+				dir.assign(path, 0, fileStart);
+			}
+
+			size_t dot = path.find('.', fileStart);
+			if ( (dot == String::npos) || (dot >= lineEnd) )
+			{
+				baseName.assign(path, fileStart, lineEnd - fileStart);
+			}
+			else
+			{
+				baseName.assign(path, fileStart, dot - fileStart);
+				extension.assign(path, dot + 1, lineEnd - dot - 1);
 			}
 	}
 
@@ -914,37 +877,61 @@ namespace COLLADABU
 		}
 
 
-		// This regular expression for parsing URI references comes from the URI spec:
+		// This is a hand written scanner equivalent to the regular expression for parsing
+		// URI references from the URI spec:
 		//   http://tools.ietf.org/html/rfc3986#appendix-B
 		// regular expression: "^(([^:/?#]+):)?(//([^/?#]*))?([^?#]*)(\?([^#]*))?(#(.*))?"
-		static const PcreCompiledPattern matchUriCompiledPattern("^(([^:/?#]+):)?(//([^/?#]*))?([^?#]*)(\\?([^#]*))?(#(.*))?");
-		pcre* matchUri = matchUriCompiledPattern.getCompiledPattern();
-
+		// As in the regular expression, the query contains the leading '?' and the fragment
+		// ends at the first line feed.
+		const char* const uriBegin = uriRef.c_str();
+		const char* const uriEnd = uriBegin + uriRef.length();
+		const char* pos = uriBegin;
+
+		// scheme: "(([^:/?#]+):)?"
+		const char* schemeEnd = uriBegin;
+		while ( (schemeEnd != uriEnd) && (*schemeEnd != ':') && (*schemeEnd != '/') && (*schemeEnd != '?') && (*schemeEnd != '#') )
+			++schemeEnd;
+		if ( (schemeEnd != uriBegin) && (schemeEnd != uriEnd) && (*schemeEnd == ':') )
+		{
+			scheme.assign(uriBegin, schemeEnd);
+			pos = schemeEnd + 1;
+		}
 
-		int uriMatches[regExpMatchesVectorLength];
+		// authority: "(//([^/?#]*))?"
+		if ( (uriEnd - pos >= 2) && (pos[0] == '/') && (pos[1] == '/') )
+		{
+			pos += 2;
+			const char* authorityBegin = pos;
+			while ( (pos != uriEnd) && (*pos != '/') && (*pos != '?') && (*pos != '#') )
+				++pos;
+			authority.assign(authorityBegin, pos);
+		}
 
-		int  uriResult = pcre_exec(
-									matchUri,					/* the compiled pattern */
-									0,							/* no extra data - we didn't study the pattern */
-									uriRef.c_str(),				/* the subject string */
-									(int)uriRef.size(),			/* the length of the subject */
-									0,							/* start at offset 0 in the subject */
-									0,							/* default options */
-									uriMatches,				/* output vector for substring information */
-									regExpMatchesVectorLength);		/* number of elements in the output vector */
+		// path: "([^?#]*)"
+		const char* pathBegin = pos;
+		while ( (pos != uriEnd) && (*pos != '?') && (*pos != '#') )
+			++pos;
+		path.assign(pathBegin, pos);
 
+		// query: "(\?([^#]*))?"
+		if ( (pos != uriEnd) && (*pos == '?') )
+		{
+			const char* queryBegin = pos;
+			while ( (pos != uriEnd) && (*pos != '#') )
+				++pos;
+			query.assign(queryBegin, pos);
+		}
 
-		if ( uriResult >= 0 )
+		// fragment: "(#(.*))?"
+		if ( (pos != uriEnd) && (*pos == '#') )
 		{
-			setStringFromMatches(scheme, uriRef, uriMatches, 2);
-			setStringFromMatches(authority, uriRef, uriMatches, 4);
-			setStringFromMatches(path, uriRef, uriMatches, 5);
-			setStringFromMatches(query, uriRef, uriMatches, 6);
-			setStringFromMatches(fragment, uriRef, uriMatches, 9);
-			return true;
+			const char* fragmentBegin = ++pos;
+			while ( (pos != uriEnd) && (*pos != '\n') )
+				++pos;
+			fragment.assign(fragmentBegin, pos);
 		}
 
-		return false;
+		return true;
 	}
 
 	namespace {
@@ -0,0 +1,87 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADABaseUtils.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "performanceTest.h"
+#include "URIUnitTest.h"
+#include "COLLADABUURI.h"
+#include "COLLADABUTimer.h"
+
+#include <iostream>
+
+
+using COLLADABU::String;
+
+namespace
+{
+	/** The number of times each uri is parsed.*/
+	const size_t iterationCount = 200000;
+
+	/** Typical uris of a COLLADA document.*/
+	const char* uris[] =
+	{
+		"#geometry-12",
+		"file:///home/user/scenes/library.dae#geometry-12",
+		"../textures/wood_diffuse.png",
+		"http://www.collada.org/2005/11/COLLADASchema#visual_scene"
+	};
+
+	const size_t uriCount = sizeof(uris) / sizeof(uris[0]);
+
+	typedef bool (*ParseUriRef)( const String&, String&, String&, String&, String&, String& );
+	typedef void (*ParsePath)( const String&, String&, String&, String& );
+
+	double measureParseUriRef( ParseUriRef parseUriRef, const String* uriStrings, size_t& checkSum )
+	{
+		COLLADABU::Timer timer;
+		for ( size_t i = 0; i < iterationCount; ++i )
+		{
+			for ( size_t j = 0; j < uriCount; ++j )
+			{
+				String scheme, authority, path, query, fragment;
+				parseUriRef( uriStrings[j], scheme, authority, path, query, fragment );
+				checkSum += path.length() + fragment.length();
+			}
+		}
+		return timer.getElapsedSeconds();
+	}
+
+	double measureParsePath( ParsePath parsePath, const String* uriStrings, size_t& checkSum )
+	{
+		COLLADABU::Timer timer;
+		for ( size_t i = 0; i < iterationCount; ++i )
+		{
+			for ( size_t j = 0; j < uriCount; ++j )
+			{
+				String dir, baseName, extension;
+				parsePath( uriStrings[j], dir, baseName, extension );
+				checkSum += dir.length() + extension.length();
+			}
+		}
+		return timer.getElapsedSeconds();
+	}
+}
+
+//------------------------------
+void performanceTest()
+{
+	String uriStrings[uriCount];
+	for ( size_t i = 0; i < uriCount; ++i )
+		uriStrings[i] = uris[i];
+
+	size_t checkSum = 0;
+	double pcreUriTime = measureParseUriRef( &pcreParseUriRef, uriStrings, checkSum );
+	double uriTime = measureParseUriRef( &COLLADABU::URI::parseUriRef, uriStrings, checkSum );
+	double pcrePathTime = measureParsePath( &pcreParsePath, uriStrings, checkSum );
+	double pathTime = measureParsePath( &COLLADABU::URI::parsePath, uriStrings, checkSum );
+
+	std::cout << iterationCount * uriCount << " uris (check sum " << checkSum << ")" << std::endl;
+	std::cout << "parseUriRef   pcre: " << pcreUriTime << "s   scanner: " << uriTime << "s" << std::endl;
+	std::cout << "parsePath     pcre: " << pcrePathTime << "s   scanner: " << pathTime << "s" << std::endl;
+}
@@ -0,0 +1,213 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADABaseUtils.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "URIUnitTest.h"
+#include "COLLADABUURI.h"
+
+#include "pcre.h"
+
+#include <iostream>
+
+
+using COLLADABU::String;
+
+namespace
+{
+	const int regExpMatchesVectorLength = 30;    /* should be a multiple of 3 */
+
+	/** The number of random strings compared.*/
+	const size_t randomTestCount = 2000000;
+
+	/** The maximum length of the random strings.*/
+	const size_t randomTestMaxLength = 12;
+
+	/** The characters of the random strings, the ones with a meaning in an uri and some others.*/
+	const char randomTestCharacters[] = "ab:/?#.\n%";
+
+	/** The number of differences printed.*/
+	const size_t maxReportedErrors = 10;
+
+	size_t errorCount = 0;
+
+	/** Compiles @a pattern. The compiled pattern is never freed.*/
+	pcre* compilePattern( const char* pattern )
+	{
+		const char* error = 0;
+		int errorOffset = 0;
+		return pcre_compile( pattern, 0, &error, &errorOffset, 0 );
+	}
+
+	void setStringFromMatches( String& string, const String& subject, const int* matches, int index )
+	{
+		if ( matches[2 * index] >= 0 )
+			string.assign( subject, matches[2 * index], matches[2 * index + 1] - matches[2 * index] );
+	}
+
+	/** Deterministic random numbers, independent of the rand() of the platform.*/
+	unsigned int nextRandom( unsigned int& state )
+	{
+		state = state * 1103515245u + 12345u;
+		return (state >> 16) & 0x7fff;
+	}
+
+	String escape( const String& string )
+	{
+		String escaped;
+		for ( size_t i = 0; i < string.length(); ++i )
+		{
+			if ( string[i] == '\n' )
+				escaped += "\\n";
+			else
+				escaped += string[i];
+		}
+		return escaped;
+	}
+
+	void compare( const String& input, const char* component, const String& expected, const String& actual )
+	{
+		if ( expected == actual )
+			return;
+		if ( errorCount < maxReportedErrors )
+		{
+			std::cout << "      don't match     \"" << escape(input) << "\" " << component << ": \""
+				<< escape(actual) << "\" and \"" << escape(expected) << "\"" << std::endl;
+		}
+		++errorCount;
+	}
+
+	void testUri( const String& uri )
+	{
+		String expected[5];
+		String actual[5];
+		bool expectedResult = pcreParseUriRef( uri, expected[0], expected[1], expected[2], expected[3], expected[4] );
+		bool actualResult = COLLADABU::URI::parseUriRef( uri, actual[0], actual[1], actual[2], actual[3], actual[4] );
+		compare( uri, "result", expectedResult ? "true" : "false", actualResult ? "true" : "false" );
+		compare( uri, "scheme", expected[0], actual[0] );
+		compare( uri, "authority", expected[1], actual[1] );
+		compare( uri, "path", expected[2], actual[2] );
+		compare( uri, "query", expected[3], actual[3] );
+		compare( uri, "fragment", expected[4], actual[4] );
+
+		String expectedDir, expectedBaseName, expectedExtension;
+		String actualDir, actualBaseName, actualExtension;
+		pcreParsePath( uri, expectedDir, expectedBaseName, expectedExtension );
+		COLLADABU::URI::parsePath( uri, actualDir, actualBaseName, actualExtension );
+		compare( uri, "dir", expectedDir, actualDir );
+		compare( uri, "base name", expectedBaseName, actualBaseName );
+		compare( uri, "extension", expectedExtension, actualExtension );
+	}
+}
+
+//------------------------------
+bool pcreParseUriRef( const String& uriRef, String& scheme, String& authority, String& path, String& query, String& fragment )
+{
+	if ( !uriRef.empty() && uriRef[0] == '#' )
+	{
+		fragment.assign( uriRef, 1, uriRef.length() - 1 );
+		return true;
+	}
+
+	static pcre* matchUri = compilePattern( "^(([^:/?#]+):)?(//([^/?#]*))?([^?#]*)(\\?([^#]*))?(#(.*))?" );
+
+	int uriMatches[regExpMatchesVectorLength];
+	int uriResult = pcre_exec( matchUri, 0, uriRef.c_str(), (int)uriRef.size(), 0, 0, uriMatches, regExpMatchesVectorLength );
+	if ( uriResult >= 0 )
+	{
+		setStringFromMatches( scheme, uriRef, uriMatches, 2 );
+		setStringFromMatches( authority, uriRef, uriMatches, 4 );
+		setStringFromMatches( path, uriRef, uriMatches, 5 );
+		setStringFromMatches( query, uriRef, uriMatches, 6 );
+		setStringFromMatches( fragment, uriRef, uriMatches, 9 );
+		return true;
+	}
+	return false;
+}
+
+//------------------------------
+void pcreParsePath( const String& path, String& dir, String& baseName, String& extension )
+{
+	static pcre* findDir = compilePattern( "(.*/)?(.*)?" );
+	static pcre* findExt = compilePattern( "([^.]*)?(\\.(.*))?" );
+
+	String file;
+	dir.clear();
+	baseName.clear();
+	extension.clear();
+
+	int dirMatches[regExpMatchesVectorLength];
+	int dirResult = pcre_exec( findDir, 0, path.c_str(), (int)path.size(), 0, 0, dirMatches, regExpMatchesVectorLength );
+	if ( dirResult >= 0 )
+	{
+		setStringFromMatches( dir, path, dirMatches, 1 );
+		setStringFromMatches( file, path, dirMatches, 2 );
+
+		int extMatches[regExpMatchesVectorLength];
+		int extResult = pcre_exec( findExt, 0, file.c_str(), (int)file.size(), 0, 0, extMatches, regExpMatchesVectorLength );
+		if ( extResult >= 0 )
+		{
+			setStringFromMatches( baseName, file, extMatches, 1 );
+			setStringFromMatches( extension, file, extMatches, 3 );
+		}
+	}
+}
+
+//------------------------------
+size_t uriUnitTest()
+{
+	std::cout << "uriUnitTest()" << std::endl;
+
+	errorCount = 0;
+
+	const char* uris[] =
+	{
+		"",
+		"#",
+		"#geometry-12",
+		"file:///C:/scenes/library.dae#geometry-12",
+		"file://otherComputer/file.dae",
+		"http://user@www.collada.org:80/2005/11/COLLADASchema?x=1&y=2#frag",
+		"https://host",
+		"../folder/file.dae",
+		"/tmp/se.3/file",
+		".emacs",
+		"dir/.emacs",
+		"a.b.c",
+		"scheme:",
+		":path",
+		"//authority",
+		"?query",
+		"path?",
+		"path?#",
+		"a:b:c/d?e?f#g#h",
+		"line\nfeed.dae#frag\nment",
+		"./",
+		"a/b/",
+		"mailto:someone@example.com",
+		"C:\\scenes\\library.dae"
+	};
+
+	for ( size_t i = 0; i < sizeof(uris) / sizeof(uris[0]); ++i )
+		testUri( uris[i] );
+
+	unsigned int randomState = 1;
+	const size_t characterCount = sizeof(randomTestCharacters) - 1;
+	for ( size_t i = 0; i < randomTestCount; ++i )
+	{
+		size_t length = nextRandom( randomState ) % (randomTestMaxLength + 1);
+		String uri;
+		for ( size_t j = 0; j < length; ++j )
+			uri += randomTestCharacters[nextRandom( randomState ) % characterCount];
+		testUri( uri );
+	}
+
+	std::cout << "compared " << sizeof(uris) / sizeof(uris[0]) + randomTestCount << " uris, "
+		<< errorCount << " differences" << std::endl;
+	return errorCount;
+}
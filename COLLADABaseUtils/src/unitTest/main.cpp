@@ -0,0 +1,19 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADABaseUtils.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "URIUnitTest.h"
+
+
+int main()
+{
+	size_t errorCount = uriUnitTest();
+
+	return errorCount == 0 ? 0 : 1;
+}
@@ -44,7 +44,36 @@ namespace COLLADAFW
 
 		typedef ArrayPrimitiveType<InterpolationType> InterpolationTypeArray;
 
+		/** The arrays of values of an animation curve.*/
+		enum ValuesArray
+		{
+			INPUT_VALUES,
+			OUTPUT_VALUES,
+			IN_TANGENT_VALUES,
+			OUT_TANGENT_VALUES,
+
+			VALUES_ARRAY_COUNT
+		};
+
+		/** Values of one of the arrays of an animation curve, that are not decoded before they are accessed
+		the first time. Implementations must allow decode() to be called from any thread.*/
+		class LazyValues
+		{
+		public:
+			virtual ~LazyValues(){}
+
+			/** Returns the number of values, without decoding them.*/
+			virtual size_t getValuesCount() const = 0;
+
+			/** Decodes the values and appends them to @a values.*/
+			virtual void decode( FloatOrDoubleArray& values ) const = 0;
+		};
+
 	private:
+		/** The lazy values of the value arrays, that have not been decoded yet, and the lock that protects 
+		them. Defined in the implementation file.*/
+		struct LazyValuesData;
+
 	
 		/** The physical dimension of the input value. In general this will be time, but can also be any other 
 		physical dimension.*/
@@ -62,11 +91,11 @@ namespace COLLADAFW
 		InterpolationType mInterpolationType;
 
 		/** The input values of the animation. */
-		FloatOrDoubleArray mInputValues;
+		mutable FloatOrDoubleArray mInputValues;
 
 		/** The output values of the animation. mOutDimension specifies how many of these floats represent one 
 		output value. Therefore the size of the array must be the mInputValues.getCount() * mOutDimension. */
-		FloatOrDoubleArray mOutputValues;
+		mutable FloatOrDoubleArray mOutputValues;
 
 		/** If mInterpolationType == INTERPOLATION_MIXED, this array defines how the values between the keys
 		should be interpolated. The first value defines the interpolation between the first and second key, and so 
@@ -75,8 +104,12 @@ namespace COLLADAFW
 		InterpolationTypeArray mInterpolationTypes;
 
 		// TODO think about the storage of tangents
-		FloatOrDoubleArray mInTangentValues;
-		FloatOrDoubleArray mOutTangentValues;
+		mutable FloatOrDoubleArray mInTangentValues;
+		mutable FloatOrDoubleArray mOutTangentValues;
+
+		/** Values not decoded yet. Null, if setLazyValues() has never been called. The value arrays are 
+		mutable, since they are filled when they are accessed the first time.*/
+		LazyValuesData* mLazyValuesData;
 
 	public:
 
@@ -88,10 +121,11 @@ namespace COLLADAFW
 			, mOutDimension(0)
 			, mInterpolationType(INTERPOLATION_UNKNOWN)
 			, mInterpolationTypes(InterpolationTypeArray::OWNER)
+			, mLazyValuesData(0)
 		{}
 
         /** Destructor. */
-		virtual ~AnimationCurve(){}
+		virtual ~AnimationCurve();
 
 		/** Returns the physical dimension of the input value. In general this will be time, but can also be any other 
 		physical dimension.*/
@@ -110,7 +144,7 @@ namespace COLLADAFW
 
 
 		/* Returns the number of keys.*/
-		size_t getKeyCount() const { return mInputValues.getValuesCount(); }
+		size_t getKeyCount() const { return getValuesCount( INPUT_VALUES ); }
 
 		/** Returns the dimension of the output, e.g. 1 for a single float, 3 for a position.*/
 		size_t getOutDimension() const { return mOutDimension; }
@@ -127,16 +161,16 @@ namespace COLLADAFW
 		void setInterpolationType(InterpolationType interpolationType) { mInterpolationType = interpolationType; }
 
 		/** Returns the input values of the animation. */
-		FloatOrDoubleArray& getInputValues() { return mInputValues; }
+		FloatOrDoubleArray& getInputValues() { decodeValues( INPUT_VALUES ); return mInputValues; }
 
 		/** Returns the input values of the animation. */
-		const FloatOrDoubleArray& getInputValues() const { return mInputValues; }
+		const FloatOrDoubleArray& getInputValues() const { decodeValues( INPUT_VALUES ); return mInputValues; }
 
 		/** Returns the output values of the animation. */
-		FloatOrDoubleArray& getOutputValues() { return mOutputValues; }
+		FloatOrDoubleArray& getOutputValues() { decodeValues( OUTPUT_VALUES ); return mOutputValues; }
 
 		/** Returns the output values of the animation. */
-		const FloatOrDoubleArray& getOutputValues() const { return mOutputValues; }
+		const FloatOrDoubleArray& getOutputValues() const { decodeValues( OUTPUT_VALUES ); return mOutputValues; }
 
 		/** Returns the interpolation types of the animation. */
 		InterpolationTypeArray& getInterpolationTypes() { return mInterpolationTypes; }
@@ -145,16 +179,25 @@ namespace COLLADAFW
 		const InterpolationTypeArray& getInterpolationTypes() const { return mInterpolationTypes; }
 
 		/** Returns the in tangent values of the animation. */
-		FloatOrDoubleArray& getInTangentValues() { return mInTangentValues; }
+		FloatOrDoubleArray& getInTangentValues() { decodeValues( IN_TANGENT_VALUES ); return mInTangentValues; }
 
 		/** Returns the in tangent values of the animation. */
-		const FloatOrDoubleArray& getInTangentValues() const { return mInTangentValues; }
+		const FloatOrDoubleArray& getInTangentValues() const { decodeValues( IN_TANGENT_VALUES ); return mInTangentValues; }
 
 		/** Returns the out tangent values of the animation. */
-		FloatOrDoubleArray& getOutTangentValues() { return mOutTangentValues; }
+		FloatOrDoubleArray& getOutTangentValues() { decodeValues( OUT_TANGENT_VALUES ); return mOutTangentValues; }
 
 		/** Returns the out tangent values of the animation. */
-		const FloatOrDoubleArray& getOutTangentValues() const { return mOutTangentValues; }
+		const FloatOrDoubleArray& getOutTangentValues() const { decodeValues( OUT_TANGENT_VALUES ); return mOutTangentValues; }
+
+		/** Sets the values of @a valuesArray to @a lazyValues, that are decoded when the array is accessed the
+		first time. Takes ownership of @a lazyValues. Values set before, that have not been decoded yet, are 
+		discarded. If @a lazyValues is null, only the values not decoded yet are discarded. Once set, the 
+		const getters of the arrays can be called concurrently from several threads.*/
+		void setLazyValues( ValuesArray valuesArray, LazyValues* lazyValues );
+
+		/** Returns the number of values of @a valuesArray, without decoding them.*/
+		size_t getValuesCount( ValuesArray valuesArray ) const;
 
 
 	private:
@@ -165,6 +208,15 @@ namespace COLLADAFW
         /** Disable default assignment operator. */
 		const AnimationCurve& operator= ( const AnimationCurve& pre );
 
+		/** Returns the array @a valuesArray refers to.*/
+		FloatOrDoubleArray& getValuesArray( ValuesArray valuesArray ) const;
+
+		/** Decodes the values of @a valuesArray, if they have not been decoded yet.*/
+		void decodeValues( ValuesArray valuesArray ) const { if ( mLazyValuesData ) decodeLazyValues( valuesArray ); }
+
+		/** Decodes the lazy values of @a valuesArray, if there are any.*/
+		void decodeLazyValues( ValuesArray valuesArray ) const;
+
 	};
 
 } // namespace COLLADAFW
@@ -0,0 +1,185 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADAFramework.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADAFW_ANIMATIONCURVEREDUCER_H__
+#define __COLLADAFW_ANIMATIONCURVEREDUCER_H__
+
+#include "COLLADAFWPrerequisites.h"
+#include "COLLADAFWAnimationSampler.h"
+
+#include <vector>
+
+
+namespace COLLADAFW
+{
+	class AnimationCurve;
+
+	/** Removes keys from animation curves, that can be reproduced within an error tolerance by the remaining
+	keys, e.g. the keys of curves baked with one key per frame.
+
+	The original curve is sampled at its keys and at SAMPLES_PER_SEGMENT - 1 inputs within each segment. The
+	remaining keys are chosen greedily: starting at a kept key, the farthest key is searched, such that the
+	segment between them reproduces all samples in between within the tolerance of each channel. The
+	segments are either linear, or Bezier segments with their control points at a third and two thirds of the
+	segment, whose outputs are fitted to the samples by least squares. The error is only checked at the
+	samples.
+
+	Keys at discontinuities, i.e. two keys with the same input, are always kept. STEP curves keep the keys,
+	whose outputs differ from the last kept key by more than the tolerance. MIXED curves with STEP segments
+	are not reduced.
+
+	The buffers are kept and reused for the next curve. A reducer must not be used by more than one thread
+	at a time. reduceAnimationCurves() uses one reducer per thread.*/
+	class AnimationCurveReducer
+	{
+	public:
+
+		/** The number of samples of each segment of the original curve, including the one at its first key.*/
+		static const size_t SAMPLES_PER_SEGMENT = 4;
+
+		/** The segments of the reduced curves.*/
+		enum Fitting
+		{
+			FITTING_LINEAR,		//!< Linear segments, without tangents
+			FITTING_BEZIER		//!< Bezier segments with 2D tangents
+		};
+
+		/** The result of the reduction of one or more curves.*/
+		struct Statistics
+		{
+			/** The number of keys before and after the reduction.*/
+			size_t keysCount;
+			size_t reducedKeysCount;
+
+			/** The number of input, output and tangent values before and after the reduction.*/
+			size_t valuesCount;
+			size_t reducedValuesCount;
+
+			/** The largest difference between the original and the reduced curve at the samples, over all
+			channels.*/
+			double maxError;
+
+			Statistics() : keysCount(0), reducedKeysCount(0), valuesCount(0), reducedValuesCount(0), maxError(0) {}
+
+			/** Adds the counts of @a statistics and takes the larger error.*/
+			void add( const Statistics& statistics );
+
+			/** Returns valuesCount / reducedValuesCount, 1 if nothing has been reduced.*/
+			double getCompressionRatio() const;
+		};
+
+	private:
+
+		/** The segments of the reduced curves.*/
+		Fitting mFitting;
+
+		/** The tolerance of each channel.*/
+		std::vector<double> mTolerances;
+
+		/** Samples the original curves.*/
+		AnimationSampler mSampler;
+
+		/** The tolerance of each channel of the current curve.*/
+		std::vector<double> mChannelTolerances;
+
+		/** The inputs of the samples of the current curve and the outputs, channel by channel.*/
+		std::vector<double> mSampleInputs;
+		std::vector<double> mSampleOutputs;
+
+		/** The inputs and the outputs of the keys of the current curve.*/
+		std::vector<double> mKeyInputs;
+		std::vector<double> mKeyOutputs;
+
+		/** For each key of the current curve, the first key at or after it, that must be kept.*/
+		std::vector<size_t> mNextFixedKeys;
+
+		/** The kept keys.*/
+		std::vector<size_t> mKeptKeys;
+
+		/** The outputs of the inner control points of each channel of the last fitted segment, and of each
+		kept segment.*/
+		std::vector<double> mFittedOutputs;
+		std::vector<double> mKeptOutputs;
+
+		/** The largest error of the last fitted segment.*/
+		double mFittedError;
+
+	public:
+
+        /** Constructor. */
+		AnimationCurveReducer( Fitting fitting = FITTING_LINEAR );
+
+        /** Destructor. */
+		virtual ~AnimationCurveReducer();
+
+		/** Returns the segments of the reduced curves.*/
+		Fitting getFitting() const { return mFitting; }
+
+		/** Sets the segments of the reduced curves.*/
+		void setFitting( Fitting fitting ) { mFitting = fitting; }
+
+		/** Returns the tolerance of each channel.*/
+		const std::vector<double>& getTolerances() const { return mTolerances; }
+
+		/** Sets the tolerance of each channel, i.e. of each dimension of the output. Curves with more channels
+		than tolerances use the last tolerance for the remaining channels. No key is removed, if no tolerance
+		is set.*/
+		void setTolerances( const std::vector<double>& tolerances ) { mTolerances = tolerances; }
+
+		/** Sets the same tolerance @a tolerance for all channels.*/
+		void setTolerance( double tolerance ) { mTolerances.assign( 1, tolerance ); }
+
+		/** Removes the redundant keys of @a animationCurve. The curve is not changed, if the reduced curve would
+		not have less values, e.g. if only few keys can be removed from a linear curve, whose Bezier segments
+		need tangents.
+		@param statistics If not null, receives the result of the reduction.
+		@return False, if the curve can not be reduced, e.g. if the number of values does not match the
+		number of keys.*/
+		bool reduce( AnimationCurve& animationCurve, Statistics* statistics = 0 );
+
+		/** Removes the redundant keys of @a animationCurves in parallel, see reduce().
+		@param curveStatistics If not null, receives the result of each curve.
+		@param maxThreadCount The maximum number of threads to use. If 0, the number of hardware threads is
+		used.
+		@return The result of all curves.*/
+		static Statistics reduceAnimationCurves( const std::vector<AnimationCurve*>& animationCurves,
+			Fitting fitting,
+			const std::vector<double>& tolerances,
+			std::vector<Statistics>* curveStatistics = 0,
+			size_t maxThreadCount = 0 );
+
+	private:
+
+        /** Disable default copy ctor. */
+		AnimationCurveReducer( const AnimationCurveReducer& pre );
+
+        /** Disable default assignment operator. */
+		const AnimationCurveReducer& operator= ( const AnimationCurveReducer& pre );
+
+		/** Keeps the keys of a STEP curve, that differ from the last kept key.
+		@return The largest difference of a removed key.*/
+		double reduceSteps();
+
+		/** Chooses the kept keys of a curve, that is not a STEP curve.
+		@return The largest error of the kept segments.*/
+		double reduceSegments();
+
+		/** Fits a segment from key @a firstKey to key @a lastKey to the samples in between. Sets
+		mFittedOutputs and mFittedError.
+		@return True, if the segment reproduces all samples within the tolerances.*/
+		bool fitSegment( size_t firstKey, size_t lastKey );
+
+		/** Replaces the keys of @a animationCurve by the kept keys.*/
+		void writeKeptKeys( AnimationCurve& animationCurve, bool steps ) const;
+	};
+
+} // namespace COLLADAFW
+
+#endif // __COLLADAFW_ANIMATIONCURVEREDUCER_H__
@@ -0,0 +1,181 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADAFramework.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADAFW_ANIMATIONSAMPLER_H__
+#define __COLLADAFW_ANIMATIONSAMPLER_H__
+
+#include "COLLADAFWPrerequisites.h"
+#include "COLLADAFWUniqueId.h"
+
+#include <vector>
+#include <map>
+
+
+namespace COLLADAFW
+{
+	class AnimationCurve;
+	class AnimationList;
+
+	/** Evaluates animation curves at many input values, e.g. to bake them to a fixed frame rate.
+
+	Each dimension of the output of a curve is a channel. Every segment between two keys of a channel is
+	converted to a cubic Bezier segment, such that all interpolation types are evaluated by the same code:
+	- BEZIER uses the tangents of the keys as control points.
+	- HERMITE tangents are converted to control points at a third of the tangents.
+	- STEP keeps the value of the first key of the segment.
+	- LINEAR and all other types interpolate linearly.
+	The tangents may either be 2D points per output value, or 1D values, with the control points at a
+	third and two thirds of the segment. The input values of the control points are clamped to the segment,
+	such that the input of each segment is monotonic.
+
+	Input values before the first key give the value of the first key, those after the last key the value
+	of the last key.
+
+	Samples are processed in blocks of BLOCK_SIZE. The segment of each sample is found by stepping a cursor
+	from the segment of the previous sample, which takes constant time for ascending inputs. The parameter of
+	the Bezier segment of each sample is then solved by safeguarded Newton iterations. Each iteration is one
+	loop over all samples of the block, that can be vectorized, until no parameter of the block changes.
+
+	The buffers are kept and reused for the next call. A sampler must not be used by more than one thread
+	at a time. bake() and bakeAnimationList() use one sampler per thread.*/
+	class AnimationSampler
+	{
+	public:
+
+		/** The number of samples processed together.*/
+		static const size_t BLOCK_SIZE = 256;
+
+		/** The curves referenced by the bindings of animation lists, by their unique ids.*/
+		typedef std::map<UniqueId, const AnimationCurve*> UniqueIdAnimationCurveMap;
+
+	private:
+
+		/** The input values of the keys.*/
+		std::vector<double> mKeyInputs;
+
+		/** The number of segments of each channel. The last segment of each channel is constant and starts at
+		the last key.*/
+		size_t mSegmentsCount;
+
+		/** The number of channels.*/
+		size_t mChannelsCount;
+
+		/** The coefficients of the polynomials of the segments, channel by channel. The input relative to the
+		first key of the segment is ((inputC * s + inputB) * s + inputA) * s, the output
+		((outputC * s + outputB) * s + outputA) * s + outputD, for the parameter s in [0, 1].*/
+		std::vector<double> mInputA;
+		std::vector<double> mInputB;
+		std::vector<double> mInputC;
+		std::vector<double> mOutputA;
+		std::vector<double> mOutputB;
+		std::vector<double> mOutputC;
+		std::vector<double> mOutputD;
+
+		/** The segment of the last sample, where the search for the segment of the next sample starts.*/
+		size_t mCursor;
+
+		/** The segment and the input relative to the segment of each sample of the current block.*/
+		std::vector<size_t> mBlockSegments;
+		std::vector<double> mBlockInputs;
+
+		/** The coefficients gathered for the samples of the current block and their solved parameters.*/
+		std::vector<double> mBlockArrays;
+
+		/** The inputs of the frames of the current block of sampleFrames().*/
+		std::vector<double> mFrameInputs;
+
+	public:
+
+        /** Constructor. */
+		AnimationSampler();
+
+        /** Destructor. */
+		virtual ~AnimationSampler();
+
+		/** Prepares the sampling of @a animationCurve. The curve is not referenced afterwards.
+		@return False, if the curve has no keys or the number of output values does not match the number of
+		keys.*/
+		bool setAnimationCurve( const AnimationCurve& animationCurve );
+
+		/** Returns the number of channels of the curve, i.e. its output dimension.*/
+		size_t getChannelsCount() const { return mChannelsCount; }
+
+		/** Returns the input value of the first key.*/
+		double getStartInput() const { return mKeyInputs.empty() ? 0.0 : mKeyInputs.front(); }
+
+		/** Returns the input value of the last key.*/
+		double getEndInput() const { return mKeyInputs.empty() ? 0.0 : mKeyInputs.back(); }
+
+		/** Evaluates all channels at the @a count input values @a inputs. The search for the segment of each
+		input starts at the segment of the previous input, also across calls, such that ascending inputs are
+		found in constant time.
+		@param values Receives value @a i of channel @a c at values[c * valuesStride + i].
+		@param valuesStride The distance between the values of two channels, at least @a count.*/
+		void sample( const double* inputs, size_t count, double* values, size_t valuesStride );
+
+		/** Evaluates all channels at the @a framesCount inputs @a startInput + i / @a frameRate.
+		@param values Receives value @a i of channel @a c at values[c * valuesStride + i].
+		@param valuesStride The distance between the values of two channels, at least @a framesCount.*/
+		void sampleFrames( double startInput, double frameRate, size_t framesCount, double* values, size_t valuesStride );
+
+		/** Evaluates the curves @a animationCurves at the @a framesCount inputs @a startInput + i / @a frameRate,
+		in parallel.
+		@param values For each curve, the array receiving framesCount values per output dimension, see
+		sampleFrames(). Curves with a null array are skipped.
+		@param maxThreadCount The maximum number of threads to use. If 0, the number of hardware threads is
+		used.
+		@return The number of curves evaluated. Curves that can not be sampled are filled with zeros.*/
+		static size_t bake( const std::vector<const AnimationCurve*>& animationCurves,
+			double startInput,
+			double frameRate,
+			size_t framesCount,
+			double* const* values,
+			size_t maxThreadCount = 0 );
+
+		/** Evaluates the curves bound by @a animationList, see bake().
+		@param animationCurves The curves, by their unique ids.
+		@param values For each binding of @a animationList, the array receiving the values of its curve.
+		Bindings with a null array or without a curve in @a animationCurves are skipped.
+		@return The number of bindings evaluated.*/
+		static size_t bakeAnimationList( const AnimationList& animationList,
+			const UniqueIdAnimationCurveMap& animationCurves,
+			double startInput,
+			double frameRate,
+			size_t framesCount,
+			double* const* values,
+			size_t maxThreadCount = 0 );
+
+	private:
+
+        /** Disable default copy ctor. */
+		AnimationSampler( const AnimationSampler& pre );
+
+        /** Disable default assignment operator. */
+		const AnimationSampler& operator= ( const AnimationSampler& pre );
+
+		/** Sets the coefficients of segment @a segment of channel @a channel to the Bezier segment with the
+		control points (input0, output0) to (input3, output3).*/
+		void setSegment( size_t channel, size_t segment,
+			double input0, double output0,
+			double input1, double output1,
+			double input2, double output2,
+			double input3, double output3 );
+
+		/** Evaluates the block of @a count samples, whose segments and relative inputs have been set, and
+		writes the values of each channel to @a values.*/
+		void sampleBlock( size_t count, double* values, size_t valuesStride );
+
+		/** Sets the segments and relative inputs of the block of the @a count inputs @a inputs.*/
+		void findSegments( const double* inputs, size_t count );
+	};
+
+} // namespace COLLADAFW
+
+#endif // __COLLADAFW_ANIMATIONSAMPLER_H__
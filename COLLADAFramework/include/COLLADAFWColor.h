@@ -46,6 +46,9 @@ namespace COLLADAFW
         /** Sets the values of color*/
         void set( double r, double g, double b, double a, String sid="" );
 
+        /** Returns the sid of the color.*/
+        const String& getSid() const { return mSid; }
+
         /** Return true if the color is valid, false otherwise*/
         bool isValid() const;
 
@@ -118,7 +118,7 @@ namespace COLLADAFW
 		const CommonEffectPointerArray& getCommonEffects()const { return mCommonEffects; }
 
 		TextureAttributes* createExtraTextureAttributes();
-		const PointerArray<TextureAttributes>& getExtraTextures();
+		const PointerArray<TextureAttributes>& getExtraTextures() const;
 
 	private:
 		void addExtraTextureAttributes( COLLADAFW::TextureAttributes* textureAttributes );
@@ -56,6 +56,9 @@ namespace COLLADAFW
        
         /** Returns a reference to all the skeletons from this controller */
         std::vector <COLLADABU::URI> &skeletons() { return mSkeletons; }
+
+        /** Returns a reference to all the skeletons from this controller */
+        const std::vector <COLLADABU::URI> &skeletons() const { return mSkeletons; }
         
 	private:
 
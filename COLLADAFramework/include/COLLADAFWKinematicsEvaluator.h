@@ -0,0 +1,228 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADAFramework.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADAFW_KINEMATICSEVALUATOR_H__
+#define __COLLADAFW_KINEMATICSEVALUATOR_H__
+
+#include "COLLADAFWPrerequisites.h"
+#include "COLLADAFWJointPrimitive.h"
+
+#include "Math/COLLADABUMathMatrix4.h"
+
+#include "MathMLString.h"
+
+#include <vector>
+
+
+namespace MathML
+{
+	class CompiledExpression;
+	class SymbolTable;
+	class ErrorHandler;
+
+	namespace AST
+	{
+		class INode;
+	}
+}
+
+
+namespace COLLADAFW
+{
+	class KinematicsModel;
+
+	/** Computes the transformations of all links of a kinematics model for many poses at once.
+
+	The links are numbered in the order of the tree, parents first. The world transformation of a link is
+	the one of its parent, followed by the transformations of the attachment, the motions of the primitives
+	of the joint and the transformations of the link. Base links use the base transformation.
+
+	Each primitive of each joint of the model is an axis, that takes one value per pose: the angle in degrees
+	of a revolute primitive, the distance of a prismatic one. Axes may be driven by formulas of other axes,
+	see addCoupling().
+
+	Each primitive moves along or about the z axis of its own frame, such that a motion changes only two
+	columns of the transformation. The constant rotations into the frames of the primitives are merged into
+	the transformations of the attachments and the links.
+
+	The poses are computed in blocks of BLOCK_SIZE. Within a block, each value is stored in an array over
+	the poses, such that the loops over the poses can be vectorized. The values of the axes and the computed
+	transformations are passed in the same layout.
+
+	evaluate() does not change the evaluator, i.e. one evaluator can be used by several threads to compute
+	different ranges of poses.*/
+	class KinematicsEvaluator
+	{
+	public:
+
+		/** The number of values of a transformation, the upper three rows of the 4x4 matrix, row by row.*/
+		static const size_t TRANSFORMATION_SIZE = 12;
+
+		/** The number of poses computed together.*/
+		static const size_t BLOCK_SIZE = 256;
+
+	private:
+
+		/** A primitive of a joint.*/
+		struct Axis
+		{
+			/** The type of the primitive.*/
+			JointPrimitive::Type type;
+
+			/** The rotation from the frame of the previous primitive of the joint, or of the joint for the
+			first primitive, to the frame of the primitive, whose z axis is the axis of the primitive.*/
+			double frame[TRANSFORMATION_SIZE];
+
+			/** The hard limits of the primitive. -/+ infinity, if not set.*/
+			double limitMin;
+			double limitMax;
+		};
+
+		/** A link of the tree.*/
+		struct Link
+		{
+			/** The number of the link in the kinematics model.*/
+			size_t linkNumber;
+
+			/** The index of the parent link. The index of the link itself for base links.*/
+			size_t parentIndex;
+
+			/** The first axis of the joint connecting the link to its parent and the number of axes.*/
+			size_t firstAxis;
+			size_t axesCount;
+
+			/** The transformation of the attachment, from the parent link to the frame of the first primitive
+			of the joint.*/
+			double attachment[TRANSFORMATION_SIZE];
+
+			/** The transformation from the frame of the last primitive of the joint to the link.*/
+			double link[TRANSFORMATION_SIZE];
+		};
+
+		/** An axis driven by a formula.*/
+		struct Coupling
+		{
+			/** The driven axis.*/
+			size_t axis;
+
+			/** The axes passed as inputs to the formula.*/
+			std::vector<size_t> inputAxes;
+
+			/** The compiled formula.*/
+			MathML::CompiledExpression* expression;
+		};
+
+		typedef std::vector<Link> LinkArray;
+		typedef std::vector<Axis> AxisArray;
+		typedef std::vector<Coupling> CouplingArray;
+
+		/** The links, parents first.*/
+		LinkArray mLinks;
+
+		/** The primitives of all joints of the model.*/
+		AxisArray mAxes;
+
+		/** The first axis of each joint of the model.*/
+		std::vector<size_t> mJointFirstAxes;
+
+		/** The couplings, in the order they are evaluated.*/
+		CouplingArray mCouplings;
+
+		/** The index of the coupling driving each axis plus one, or 0, if the axis is not driven.*/
+		std::vector<size_t> mAxisCouplings;
+
+		/** True for each axis used as input of a coupling.*/
+		std::vector<bool> mCouplingInputAxes;
+
+		/** The transformation of the base links.*/
+		double mBaseTransformation[TRANSFORMATION_SIZE];
+
+		/** True, if the values of the axes are clamped to the hard limits of their primitives.*/
+		bool mClampToLimits;
+
+	public:
+
+        /** Constructor. */
+		KinematicsEvaluator();
+
+        /** Destructor. */
+		virtual ~KinematicsEvaluator();
+
+		/** Builds the tree of the links of @a kinematicsModel and removes all couplings. The model is not
+		referenced afterwards.
+		@return False, if a connection refers to a joint the model does not contain.*/
+		bool setKinematicsModel( const KinematicsModel& kinematicsModel );
+
+		/** Removes the links, the axes and the couplings.*/
+		void clear();
+
+		/** Returns the number of links.*/
+		size_t getLinksCount() const { return mLinks.size(); }
+
+		/** Returns the number in the kinematics model of the link with index @a linkIndex.*/
+		size_t getLinkNumber( size_t linkIndex ) const { return mLinks[linkIndex].linkNumber; }
+
+		/** Returns the index of the parent of the link with index @a linkIndex. Base links return
+		@a linkIndex.*/
+		size_t getParentLinkIndex( size_t linkIndex ) const { return mLinks[linkIndex].parentIndex; }
+
+		/** Returns the number of axes, i.e. of primitives of all joints.*/
+		size_t getAxesCount() const { return mAxes.size(); }
+
+		/** Returns the axis of the primitive @a primitiveIndex of the joint @a jointIndex of the model.*/
+		size_t getAxisIndex( size_t jointIndex, size_t primitiveIndex ) const { return mJointFirstAxes[jointIndex] + primitiveIndex; }
+
+		/** Sets the transformation of the base links.*/
+		void setBaseTransformation( const COLLADABU::Math::Matrix4& baseTransformation );
+
+		/** If @a clampToLimits is true, the values of the axes, including the driven ones, are clamped to the
+		hard limits of their primitives.*/
+		void setClampToLimits( bool clampToLimits ) { mClampToLimits = clampToLimits; }
+
+		/** Drives the axis @a axis by the formula @a formula. The variables @a inputNames of the formula are
+		the values of the axes @a inputAxes. The couplings are evaluated in the order they are added, such
+		that a formula may use axes driven by couplings added before.
+		@param symbolTable The functions and the variables of the formula, that are not axes.
+		@return False, if the formula can not be compiled, if @a axis is already driven or used as input of a
+		coupling, or if @a axis is one of the inputs.*/
+		bool addCoupling( size_t axis,
+			const MathML::AST::INode* formula,
+			const MathML::StringVector& inputNames,
+			const std::vector<size_t>& inputAxes,
+			MathML::SymbolTable& symbolTable,
+			MathML::ErrorHandler* errorHandler = 0 );
+
+		/** Computes the transformations of all links for @a posesCount poses.
+		@param axisValues For each axis, the array of its @a posesCount values. The values of driven axes are
+		not read and may be null.
+		@param transformations Receives the transformations, value by value for each link. Value @a v of link
+		@a l of pose @a p is written to transformations[(l * TRANSFORMATION_SIZE + v) * transformationsStride + p].
+		@param transformationsStride The distance between the arrays of two values, at least @a posesCount.*/
+		void evaluate( const double* const* axisValues, size_t posesCount, double* transformations, size_t transformationsStride ) const;
+
+		/** Computes the transformations with @a transformationsStride @a posesCount.*/
+		void evaluate( const double* const* axisValues, size_t posesCount, double* transformations ) const
+		{ evaluate( axisValues, posesCount, transformations, posesCount ); }
+
+	private:
+
+        /** Disable default copy ctor. */
+		KinematicsEvaluator( const KinematicsEvaluator& pre );
+
+        /** Disable default assignment operator. */
+		const KinematicsEvaluator& operator= ( const KinematicsEvaluator& pre );
+
+		/** Deletes the couplings.*/
+		void clearCouplings();
+	};
+
+} // namespace COLLADAFW
+
+#endif // __COLLADAFW_KINEMATICSEVALUATOR_H__
@@ -0,0 +1,245 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADAFramework.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADAFW_MESHDEDUPLICATOR_H__
+#define __COLLADAFW_MESHDEDUPLICATOR_H__
+
+#include "COLLADAFWPrerequisites.h"
+#include "COLLADAFWUniqueId.h"
+
+#include "Math/COLLADABUMathMatrix4.h"
+
+#include <vector>
+#include <deque>
+#include <map>
+
+
+namespace COLLADAFW
+{
+	class Mesh;
+
+	/** Finds meshes, that are duplicates of previously added meshes, e.g. the geometries of the bolts and
+	screws of CAD exports, which are usually written once per part instead of being instanced.
+
+	Each added mesh is reduced to a 128 bit hash of its primitives, i.e. of the primitive types, face counts,
+	material ids and all index arrays, the number of values of each input and, by default, the bits of the
+	values. The hashed words of the meshes, that are not duplicates, are kept instead of the meshes, and the
+	words of a mesh are compared to those of the previous meshes with the same hash, such that hash collisions
+	are not taken for duplicates. The names of the mesh and its inputs are not hashed.
+
+	With tolerances, the values are not hashed. The values of each added mesh are kept, and the values of a
+	mesh are compared to those of the previous meshes with the same hash. Each value must not differ by more
+	than its tolerance.
+
+	With rigid matching, meshes are also found if they are rotated and translated copies of an added mesh.
+	The positions are transformed into a frame defined by the mesh itself, the normals, tangents and binormals
+	are rotated into it, before they are compared. The frame is placed at the centroid of the positions, its 
+	axes point to the first vertices far enough from the centroid and the first axis. The frames of copies 
+	therefore only match, if the vertices have the same order. Reflected copies are not found.
+
+	A deduplicator must not be used by more than one thread at a time.*/
+	class MeshDeduplicator
+	{
+	public:
+
+		/** The tolerance relative to the largest absolute coordinate of a mesh, used for its positions with
+		rigid matching, if the position tolerance is smaller.*/
+		static const double MIN_RIGID_RELATIVE_POSITION_TOLERANCE;
+
+		/** The tolerance used for the other values with rigid matching, if the value tolerance is smaller.*/
+		static const double MIN_RIGID_VALUE_TOLERANCE;
+
+		/** A mesh found to be a duplicate of an added mesh.*/
+		struct Duplicate
+		{
+			/** The unique id of the added mesh, the duplicate can be replaced with.*/
+			UniqueId originalId;
+
+			/** The transformation from the original mesh to the duplicate, i.e. the positions of the
+			duplicate are the positions of the original transformed by this matrix. The identity, if
+			transformed is false.*/
+			COLLADABU::Math::Matrix4 transformation;
+
+			/** True, if the duplicate is a moved copy of the original, i.e. if instances of the original
+			must be transformed to replace the duplicate.*/
+			bool transformed;
+
+			Duplicate() : transformation(COLLADABU::Math::Matrix4::IDENTITY), transformed(false) {}
+		};
+
+		/** The duplicates, by their unique ids.*/
+		typedef std::map<UniqueId, Duplicate> UniqueIdDuplicateMap;
+
+		/** The result of the deduplication.*/
+		struct Statistics
+		{
+			/** The number of added meshes, including the duplicates.*/
+			size_t meshesCount;
+
+			/** The number of duplicates found and how many of them are transformed copies.*/
+			size_t duplicatesCount;
+			size_t transformedDuplicatesCount;
+
+			/** The size of the vertex and index data of the duplicates, see getMeshSize().*/
+			size_t savedBytes;
+
+			Statistics() : meshesCount(0), duplicatesCount(0), transformedDuplicatesCount(0), savedBytes(0) {}
+		};
+
+	private:
+
+		/** The hash of a mesh.*/
+		typedef std::pair<unsigned long long, unsigned long long> MeshHash;
+
+		/** An added mesh, that is not a duplicate.*/
+		struct Original
+		{
+			/** The unique id of the mesh.*/
+			UniqueId uniqueId;
+
+			/** The rotation of its frame, row by row, and the origin of the frame.*/
+			double rotation[9];
+			double origin[3];
+
+			/** The largest distance of a position from the origin.*/
+			double radius;
+
+			/** The tolerance of the positions of the mesh.*/
+			double positionTolerance;
+
+			/** The values of the mesh in its frame, positions first, if values are compared. Empty
+			otherwise.*/
+			std::vector<double> values;
+
+			/** The words the hash of the mesh has been computed from.*/
+			std::vector<unsigned long long> words;
+		};
+
+		/** The tolerance of the positions and of the other values.*/
+		double mPositionTolerance;
+		double mValueTolerance;
+
+		/** True, if meshes are compared in their own frames.*/
+		bool mRigidMatching;
+
+		/** The added meshes, that are not duplicates. A deque, since the values must not be copied, if it
+		grows.*/
+		std::deque<Original> mOriginals;
+
+		/** The indices of the originals with each hash.*/
+		typedef std::map<MeshHash, std::vector<size_t> > MeshHashOriginalsMap;
+		MeshHashOriginalsMap mMeshHashOriginals;
+
+		/** The duplicates found.*/
+		UniqueIdDuplicateMap mDuplicates;
+
+		/** The result of the deduplication of all added meshes.*/
+		Statistics mStatistics;
+
+		/** The frame of the current mesh, see Original.*/
+		double mRotation[9];
+		double mOrigin[3];
+		double mRadius;
+
+		/** The positions of the current mesh, converted to double.*/
+		std::vector<double> mPositions;
+
+		/** The tolerances used for the current mesh.*/
+		double mMeshPositionTolerance;
+		double mMeshValueTolerance;
+
+		/** The values of the current mesh in its frame, positions first, if values are compared.*/
+		std::vector<double> mValues;
+
+		/** The number of position values in mValues.*/
+		size_t mPositionValuesCount;
+
+		/** The words the hash of the current mesh has been computed from.*/
+		std::vector<unsigned long long> mWords;
+
+	public:
+
+        /** Constructor. */
+		MeshDeduplicator();
+
+        /** Destructor. */
+		virtual ~MeshDeduplicator();
+
+		/** Returns the tolerance of the positions.*/
+		double getPositionTolerance() const { return mPositionTolerance; }
+
+		/** Sets the tolerance of the positions. Values are only compared, if any tolerance is not 0 or 
+		rigid matching is set, otherwise they must be bit identical.*/
+		void setPositionTolerance( double positionTolerance ) { mPositionTolerance = positionTolerance; }
+
+		/** Returns the tolerance of the normals, colors, texture coordinates, tangents and binormals.*/
+		double getValueTolerance() const { return mValueTolerance; }
+
+		/** Sets the tolerance of the normals, colors, texture coordinates, tangents and binormals, see
+		setPositionTolerance().*/
+		void setValueTolerance( double valueTolerance ) { mValueTolerance = valueTolerance; }
+
+		/** Returns true, if rotated and translated copies are found.*/
+		bool getRigidMatching() const { return mRigidMatching; }
+
+		/** Sets if rotated and translated copies are found, see class description. The tolerances are at least
+		MIN_RIGID_RELATIVE_POSITION_TOLERANCE and MIN_RIGID_VALUE_TOLERANCE, since transformed values are
+		not exact.*/
+		void setRigidMatching( bool rigidMatching ) { mRigidMatching = rigidMatching; }
+
+		/** Adds @a mesh. The settings must not be changed between the first addMesh() and clear().
+		@return True, if @a mesh is a duplicate of a previously added mesh. The duplicate is recorded and can
+		be queried with findDuplicate(). False, if @a mesh is the first of its kind.*/
+		bool addMesh( const Mesh& mesh );
+
+		/** Returns the duplicate with unique id @a uniqueId, null if the mesh is not a duplicate.*/
+		const Duplicate* findDuplicate( const UniqueId& uniqueId ) const;
+
+		/** Returns all duplicates found.*/
+		const UniqueIdDuplicateMap& getDuplicates() const { return mDuplicates; }
+
+		/** Returns the result of the deduplication of all added meshes.*/
+		const Statistics& getStatistics() const { return mStatistics; }
+
+		/** Removes all added meshes and duplicates. The settings are kept.*/
+		void clear();
+
+		/** Returns the number of bytes of the vertex data and the index arrays of @a mesh.*/
+		static size_t getMeshSize( const Mesh& mesh );
+
+	private:
+
+        /** Disable default copy ctor. */
+		MeshDeduplicator( const MeshDeduplicator& pre );
+
+        /** Disable default assignment operator. */
+		const MeshDeduplicator& operator= ( const MeshDeduplicator& pre );
+
+		/** Returns true, if the values are compared, instead of being hashed.*/
+		bool compareValues() const { return mRigidMatching || (mPositionTolerance != 0) || (mValueTolerance != 0); }
+
+		/** Sets the frame and the tolerances of @a mesh.*/
+		void computeFrame( const Mesh& mesh );
+
+		/** Returns the transformation from the frame of @a original to the frame of the current mesh.*/
+		COLLADABU::Math::Matrix4 getTransformation( const Original& original ) const;
+
+		/** Returns true, if the current mesh has been hashed from the same words as @a original and its values
+		do not differ from those of @a original by more than the tolerances.*/
+		bool isEqual( const Original& original ) const;
+
+		/** Returns true, if @a transformation moves any position of @a original by more than the position
+		tolerance.*/
+		bool isTransformed( const COLLADABU::Math::Matrix4& transformation, const Original& original ) const;
+	};
+
+} // namespace COLLADAFW
+
+#endif // __COLLADAFW_MESHDEDUPLICATOR_H__
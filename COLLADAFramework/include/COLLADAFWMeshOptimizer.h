@@ -0,0 +1,205 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADAFramework.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADAFW_MESHOPTIMIZER_H__
+#define __COLLADAFW_MESHOPTIMIZER_H__
+
+#include "COLLADAFWPrerequisites.h"
+#include "COLLADAFWTypes.h"
+#include "COLLADAFWMeshVertexWelder.h"
+
+#include <vector>
+
+
+namespace COLLADAFW
+{
+	class Mesh;
+	class Triangles;
+
+	/** Reorders triangle lists for rendering performance.
+	- optimizeVertexCache() reorders the triangles, such that vertices are reused while they are still in
+	  the post transform vertex cache, using the scoring of Tom Forsyth's linear speed vertex cache
+	  optimization.
+	- optimizeOverdraw() splits the cache optimized triangles into clusters, at the points where the cache
+	  is flushed anyway, and sorts the clusters such that outward facing clusters at the outside of the mesh
+	  are drawn first, to reduce overdraw. The clusters are split further, as long as the cache efficiency
+	  does not degrade by more than the given threshold.
+	- optimizeVertexFetch() renumbers the vertices in the order of their first use, such that the vertex data
+	  is read sequentially.
+	- analyzeVertexCache() measures the efficiency of a triangle order, as ACMR and ATVR.
+
+	The functions work on triangle lists with one index per corner, as created by MeshVertexWelder.
+	optimizeTriangles() optimizes a Triangles primitive of a mesh in place, without changing the vertex
+	data of the mesh.
+
+	The buffers are kept and reused for the next call. An optimizer must not be used by more than one thread
+	at a time.*/
+	class MeshOptimizer
+	{
+	public:
+
+		/** The vertex cache efficiency of a triangle list.*/
+		struct VertexCacheStatistics
+		{
+			VertexCacheStatistics()
+				: trianglesCount(0), verticesCount(0), transformedVerticesCount(0) {}
+
+			/** The number of triangles.*/
+			size_t trianglesCount;
+
+			/** The number of distinct vertices referenced by the triangles.*/
+			size_t verticesCount;
+
+			/** The number of vertices, that had to be transformed, i.e. the number of cache misses.*/
+			size_t transformedVerticesCount;
+
+			/** Returns the average cache miss ratio, i.e. the number of transformed vertices per triangle.
+			0.5 is the optimum for large regular meshes, 3 the worst case.*/
+			double getAcmr() const { return trianglesCount ? (double)transformedVerticesCount / (double)trianglesCount : 0.0; }
+
+			/** Returns the average transformed vertex ratio, i.e. the number of transformed vertices per
+			vertex. 1 is the optimum.*/
+			double getAtvr() const { return verticesCount ? (double)transformedVerticesCount / (double)verticesCount : 0.0; }
+
+			/** Adds the counts of @a statistics.*/
+			void add( const VertexCacheStatistics& statistics );
+		};
+
+		/** The size of the FIFO cache simulated by analyzeVertexCache() and optimizeOverdraw() by default.*/
+		static const size_t DEFAULT_CACHE_SIZE = 16;
+
+		/** The default threshold of optimizeOverdraw(), i.e. the ACMR may increase by 5 percent.*/
+		static const float DEFAULT_OVERDRAW_THRESHOLD;
+
+	private:
+
+		/** The number of live triangles, that use a vertex, for each vertex.*/
+		std::vector<unsigned int> mLiveTrianglesCounts;
+
+		/** The position of the triangles of each vertex in mVertexTriangles.*/
+		std::vector<unsigned int> mVertexTrianglesOffsets;
+
+		/** The triangles using each vertex, grouped by vertex. The live triangles of a vertex come first.*/
+		std::vector<unsigned int> mVertexTriangles;
+
+		/** The position of each vertex in the simulated cache, or -1.*/
+		std::vector<int> mCachePositions;
+
+		/** The score of each vertex.*/
+		std::vector<float> mVertexScores;
+
+		/** The score of each triangle, or a negative value, if the triangle has been emitted.*/
+		std::vector<float> mTriangleScores;
+
+		/** The time stamp of the last use of each vertex in the simulated FIFO cache.*/
+		std::vector<unsigned int> mCacheTimeStamps;
+
+		/** A copy of the indices being reordered.*/
+		std::vector<unsigned int> mSourceIndices;
+
+		/** The index of the source triangle for each triangle of the result of the last reordering.*/
+		std::vector<unsigned int> mTriangleOrder;
+
+		/** A temporary triangle order.*/
+		std::vector<unsigned int> mTemporaryOrder;
+
+		/** The first triangle of each cluster, followed by the number of triangles.*/
+		std::vector<unsigned int> mClusters;
+
+		/** The sort key of each cluster.*/
+		std::vector<float> mClusterKeys;
+
+		/** Welder used by optimizeTriangles().*/
+		MeshVertexWelder mWelder;
+
+		/** The welded indices used by optimizeTriangles().*/
+		std::vector<unsigned int> mIndices;
+
+		/** The triangle order of optimizeTriangles(), combined from the orders of the single steps.*/
+		std::vector<unsigned int> mCombinedOrder;
+
+	public:
+
+        /** Constructor. */
+		MeshOptimizer();
+
+        /** Destructor. */
+		virtual ~MeshOptimizer();
+
+		/** Reorders the triangles of the triangle list @a indices for the post transform vertex cache. The
+		order of the corners of each triangle is kept.
+		@param indices The indices of the triangles, three per triangle. Must be less than @a verticesCount.*/
+		void optimizeVertexCache( unsigned int* indices, size_t indicesCount, size_t verticesCount );
+
+		/** Reorders clusters of the triangles of the triangle list @a indices to reduce overdraw. Should be
+		called after optimizeVertexCache().
+		@param positions The position of the first vertex. Each position has three values.
+		@param positionsStride The distance between the positions of two consecutive vertices, in floats.
+		@param threshold The factor by which the ACMR may increase, to allow smaller clusters. 1 keeps the
+		cache efficiency.*/
+		void optimizeOverdraw( unsigned int* indices, size_t indicesCount, const float* positions, size_t positionsStride, size_t verticesCount, float threshold = DEFAULT_OVERDRAW_THRESHOLD );
+
+		/** Returns the index of the source triangle for each triangle, as reordered by the last call of
+		optimizeVertexCache() or optimizeOverdraw().*/
+		const std::vector<unsigned int>& getTriangleOrder() const { return mTriangleOrder; }
+
+		/** Renumbers the vertices referenced by @a indices in the order of their first use.
+		@param vertexRemap Receives the new index of each of the @a verticesCount vertices. Unused vertices
+		are mapped to UINT_MAX.
+		@return The number of used vertices.*/
+		size_t optimizeVertexFetch( unsigned int* indices, size_t indicesCount, size_t verticesCount, std::vector<unsigned int>& vertexRemap );
+
+		/** Simulates a FIFO vertex cache with @a cacheSize entries processing the triangle list @a indices.*/
+		VertexCacheStatistics analyzeVertexCache( const unsigned int* indices, size_t indicesCount, size_t verticesCount, size_t cacheSize = DEFAULT_CACHE_SIZE );
+
+		/** Reorders the triangles of @a triangles, a primitive of @a mesh, for the vertex cache and, if
+		@a overdrawThreshold is greater than 0, to reduce overdraw. All index arrays of the primitive with one
+		index per corner are reordered. The vertex data of the mesh is not changed.
+		@param originalStatistics If not null, receives the statistics of the original triangle order.
+		@param optimizedStatistics If not null, receives the statistics of the optimized triangle order.
+		@return False, if @a triangles has no positions, true otherwise.*/
+		bool optimizeTriangles( const Mesh& mesh,
+			Triangles& triangles,
+			float overdrawThreshold = DEFAULT_OVERDRAW_THRESHOLD,
+			VertexCacheStatistics* originalStatistics = 0,
+			VertexCacheStatistics* optimizedStatistics = 0 );
+
+	private:
+
+        /** Disable default copy ctor. */
+		MeshOptimizer( const MeshOptimizer& pre );
+
+        /** Disable default assignment operator. */
+		const MeshOptimizer& operator= ( const MeshOptimizer& pre );
+
+		/** Fills the triangle adjacency of the vertices and sets the live triangle counts.*/
+		void buildAdjacency( const unsigned int* indices, size_t trianglesCount, size_t verticesCount );
+
+		/** Returns the score of the vertex @a vertex, based on its position in the cache and its number of
+		live triangles.*/
+		float getVertexScore( unsigned int vertex ) const;
+
+		/** Writes the triangles of mSourceIndices in the order mTriangleOrder to @a indices.*/
+		void writeTriangles( unsigned int* indices ) const;
+
+		/** Splits the triangles into clusters, see optimizeOverdraw().*/
+		void buildClusters( const unsigned int* indices, size_t trianglesCount, size_t verticesCount, size_t cacheSize, float threshold );
+
+		/** Returns the number of cache misses of the triangle @a triangle in a FIFO cache with @a cacheSize
+		entries, and updates the cache. mCacheTimeStamps must contain the time stamps of the vertices. */
+		unsigned int simulateTriangle( const unsigned int* indices, size_t triangle, unsigned int& timeStamp, size_t cacheSize );
+
+		/** Reorders the triangles in @a array by mTriangleOrder.*/
+		void reorderIndices( UIntValuesArray& array );
+	};
+
+} // namespace COLLADAFW
+
+#endif // __COLLADAFW_MESHOPTIMIZER_H__
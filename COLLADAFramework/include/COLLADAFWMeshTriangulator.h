@@ -0,0 +1,164 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADAFramework.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADAFW_MESHTRIANGULATOR_H__
+#define __COLLADAFW_MESHTRIANGULATOR_H__
+
+#include "COLLADAFWPrerequisites.h"
+#include "COLLADAFWTypes.h"
+#include "COLLADAFWMeshPrimitive.h"
+
+#include <vector>
+
+
+namespace COLLADAFW
+{
+	class Mesh;
+	class Triangles;
+	class FloatOrDoubleArray;
+
+	/** Converts polygons, polylists, triangle strips and triangle fans into triangles. Convex polygons are
+	split into fans, concave polygons and polygons with holes are split by ear clipping, using the positions
+	of the mesh projected onto the plane of the polygon. The triangles keep the winding of the source faces.
+
+	The triangulator first determines the corners of the triangles, as indices into the index arrays of the
+	source primitive, and then uses this index buffer to gather the position, normal, tangent, binormal,
+	color and uv coordinate indices of the triangles. The buffers are kept and reused for the next primitive,
+	i.e. one triangulator should be used for many primitives. A triangulator must not be used by more than
+	one thread at a time.*/
+	class MeshTriangulator
+	{
+	private:
+		/** The corners of the triangles, as indices into the index arrays of the source primitive. Three
+		consecutive corners form a triangle.*/
+		UIntValuesArray mTriangleCorners;
+
+		/** The positions of the mesh. Null, if the mesh has no positions with three coordinates.*/
+		const FloatOrDoubleArray* mPositions;
+
+		/** The positions of the corners of the polygon being triangulated, including the corners of its
+		holes, projected onto the plane of the polygon. Two values per corner.*/
+		std::vector<double> mProjectedPositions;
+
+		/** The corners of the single boundary the polygon and its holes are linked to, as offsets from the 
+		first corner of the polygon. The corners that link a hole appear twice.*/
+		std::vector<size_t> mBoundary;
+
+		/** The previous and next remaining corner of each corner of mBoundary during ear clipping, as
+		indices into mBoundary.*/
+		std::vector<size_t> mPreviousCorners;
+		std::vector<size_t> mNextCorners;
+
+	public:
+
+        /** Constructor. */
+		MeshTriangulator();
+
+        /** Destructor. */
+		virtual ~MeshTriangulator();
+
+		/** Returns true, if primitives of type @a primitiveType are converted by triangulate().*/
+		static bool isTriangulated( MeshPrimitive::PrimitiveType primitiveType );
+
+		/** Converts the faces of @a primitive into triangles and sets the indices of @a triangles. The
+		material of @a primitive is assigned to @a triangles. Index arrays of @a primitive, that do not have
+		one index per vertex, are not copied.
+		@param mesh The mesh @a primitive belongs to. Its positions are used to split concave polygons.
+		@return False, if the type of @a primitive is not converted, see isTriangulated(), true otherwise.*/
+		bool triangulate( const Mesh& mesh, const MeshPrimitive& primitive, Triangles& triangles );
+
+		/** Returns the corners of the triangles created by the last call of triangulate(), as indices into
+		the index arrays of the source primitive. Can be used to gather additional per vertex data.*/
+		const UIntValuesArray& getTriangleCorners() const { return mTriangleCorners; }
+
+	private:
+
+        /** Disable default copy ctor. */
+		MeshTriangulator( const MeshTriangulator& pre );
+
+        /** Disable default assignment operator. */
+		const MeshTriangulator& operator= ( const MeshTriangulator& pre );
+
+		/** Appends the triangles of the polygons, and their holes, described by @a vertexCounts.*/
+		void addPolygons( const int* vertexCounts, size_t vertexCountsCount, const UIntValuesArray& positionIndices );
+
+		/** Appends the triangles of the triangle strips described by @a vertexCounts. Degenerated triangles,
+		used to join strips, are skipped.*/
+		void addTriangleStrips( const unsigned int* vertexCounts, size_t vertexCountsCount, const UIntValuesArray& positionIndices );
+
+		/** Appends the triangles of the triangle fans described by @a vertexCounts.*/
+		void addTriangleFans( const unsigned int* vertexCounts, size_t vertexCountsCount, size_t cornersCount );
+
+		/** Appends a fan of triangles, that starts at the corner @a firstCorner and has @a cornersCount
+		corners.*/
+		void addFan( size_t firstCorner, size_t cornersCount );
+
+		/** Appends the triangles of the polygon that starts at the corner @a firstCorner. The first 
+		@a outerCornersCount corners are the outer boundary, followed by the holes, whose corners counts 
+		are @a holeCornersCounts.*/
+		void addPolygon( size_t firstCorner, size_t outerCornersCount, const std::vector<size_t>& holeCornersCounts, const UIntValuesArray& positionIndices );
+
+		/** Projects the positions of the @a cornersCount corners starting at @a firstCorner onto the plane 
+		of the outer boundary, such that the outer boundary is counter clockwise.
+		@return False, if the positions are not available or the polygon is degenerated.*/
+		bool projectPolygon( size_t firstCorner, size_t cornersCount, size_t outerCornersCount, const UIntValuesArray& positionIndices );
+
+		/** Returns true, if the first @a cornersCount projected corners form a convex polygon.*/
+		bool isConvex( size_t cornersCount ) const;
+
+		/** Links the holes to the outer boundary, such that mBoundary forms a single boundary.*/
+		void bridgeHoles( size_t outerCornersCount, const std::vector<size_t>& holeCornersCounts );
+
+		/** Returns the position in mBoundary of a corner at the position of a corner of the hole, whose
+		@a holeCornersCount corners start at @a firstHoleCorner. Receives that hole corner in @a holeCorner.
+		Returns mBoundary.size(), if the hole does not touch a corner of mBoundary.*/
+		size_t findTouchingCorner( size_t firstHoleCorner, size_t holeCornersCount, size_t& holeCorner ) const;
+
+		/** Returns the position in mBoundary of the corner the hole corner @a holeCorner should be linked to.
+		Returns mBoundary.size(), if no such corner exists.*/
+		size_t findHoleBridge( size_t holeCorner ) const;
+
+		/** Returns true, if the diagonal from the corner at position @a position of mBoundary to the 
+		corner @a corner lies inside the polygon, in the vicinity of the first corner.*/
+		bool isLocallyInside( size_t position, size_t corner ) const;
+
+		/** Splits the single boundary in mBoundary into triangles by ear clipping.
+		@param firstCorner The first corner of the polygon.*/
+		void clipEars( size_t firstCorner );
+
+		/** Returns true, if the corner at position @a position of mBoundary is an ear, i.e. it is convex
+		and no other remaining corner lies in the triangle formed with its neighbors.*/
+		bool isEar( size_t position ) const;
+
+		/** Returns true, if the projected corners @a corner1 and @a corner2 are at the same position.*/
+		bool isSamePosition( size_t corner1, size_t corner2 ) const;
+
+		/** Returns twice the signed area of the triangle formed by the projected corners @a corner1,
+		@a corner2 and @a corner3. Positive, if the triangle is counter clockwise.*/
+		double cross( size_t corner1, size_t corner2, size_t corner3 ) const;
+
+		/** Reads the position with index @a positionIndex.
+		@return False, if the index is out of range.*/
+		bool getPosition( unsigned int positionIndex, double position[3] ) const;
+
+		/** Appends the triangle with the corners @a corner1, @a corner2 and @a corner3.*/
+		void addTriangle( size_t corner1, size_t corner2, size_t corner3 );
+
+		/** Sets @a target to the elements of @a source at the indices in mTriangleCorners.*/
+		void gatherIndices( const UIntValuesArray& source, UIntValuesArray& target ) const;
+
+		/** Appends a copy of each index list of @a source to @a target, with the indices gathered at
+		mTriangleCorners.*/
+		void gatherIndexLists( const IndexListArray& source, IndexListArray& target, size_t cornersCount ) const;
+	};
+
+} // namespace COLLADAFW
+
+#endif // __COLLADAFW_MESHTRIANGULATOR_H__
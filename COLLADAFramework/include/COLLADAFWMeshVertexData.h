@@ -114,6 +114,23 @@ namespace COLLADAFW
             mInputInfosArray.append ( info );
         }
 
+        /**
+        * Stores the information of an input, whose values are already in the list of values,
+        * e.g. set with setData() of the values array.
+        * @param const String& name The name of the current element.
+        * @param const size_t stride The data stride.
+        * @param const size_t length The number of values of the input.
+        */
+        void appendInputInfos ( const String& name, const size_t stride, const size_t length )
+        {
+            InputInfos* info = new InputInfos();
+            info->mLength = length;
+            info->mName = name;
+            info->mStride = stride;
+
+            mInputInfosArray.append ( info );
+        }
+
         /** The stride at the specified index. */
         String getName ( size_t index ) const
         {
@@ -0,0 +1,222 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADAFramework.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADAFW_MESHVERTEXWELDER_H__
+#define __COLLADAFW_MESHVERTEXWELDER_H__
+
+#include "COLLADAFWPrerequisites.h"
+#include "COLLADAFWTypes.h"
+#include "COLLADAFWMeshPrimitive.h"
+
+#include <vector>
+
+
+namespace COLLADAFW
+{
+	class Mesh;
+	class FloatOrDoubleArray;
+	class MeshOptimizer;
+
+	/** Converts the per input indices of a mesh primitive into vertex buffers with a single index per
+	vertex, as required by graphics hardware. Each distinct combination of position, normal, tangent, binormal,
+	color and uv coordinate indices used by the primitive becomes one vertex. The combinations are found with
+	an open addressing hash table, in the order of their first use.
+
+	The index buffer has one index per index of the source primitive, i.e. it describes the same faces as the
+	source primitive. Use MeshTriangulator first, to get a triangle list. The vertex data is converted to float
+	and stored either interleaved or as one stream per vertex element.
+
+	The buffers are kept and reused for the next primitive. A welder must not be used by more than one thread
+	at a time.*/
+	class MeshVertexWelder
+	{
+	public:
+
+		/** The arrangement of the vertex data.*/
+		enum VertexLayout
+		{
+			INTERLEAVED,		//!< All elements of a vertex are stored consecutively
+			SEPARATE_STREAMS	//!< Each element is stored in its own stream, one after the other
+		};
+
+		/** The semantic of a vertex element.*/
+		enum Semantic
+		{
+			POSITION,
+			NORMAL,
+			TANGENT,
+			BINORMAL,
+			COLOR,
+			UV_COORDINATE
+		};
+
+		/** Describes where the values of one input of the primitive are stored in the vertex data.*/
+		struct VertexElement
+		{
+			/** The semantic of the element.*/
+			Semantic semantic;
+
+			/** The index of the index list in the color or uv coordinate index list array of the primitive.
+			0 for the other semantics.*/
+			size_t setIndex;
+
+			/** The number of floats per vertex.*/
+			size_t componentCount;
+
+			/** The position of the value of the first vertex in the vertex data, in floats.*/
+			size_t offset;
+
+			/** The distance between the values of two consecutive vertices, in floats.*/
+			size_t stride;
+		};
+
+		typedef std::vector<VertexElement> VertexElementList;
+
+		/** The largest number of vertices, for which the indices are also provided as 16 bit values. The
+		index 0xFFFF is never used, so it can be used as primitive restart index.*/
+		static const size_t MAX_SHORT_INDEXED_VERTICES = 0xFFFF;
+
+	private:
+
+		/** The arrangement of the vertex data.*/
+		VertexLayout mVertexLayout;
+
+		/** The elements of the vertices.*/
+		VertexElementList mVertexElements;
+
+		/** The number of floats of one vertex.*/
+		size_t mVertexSize;
+
+		/** The number of distinct vertices.*/
+		size_t mVertexCount;
+
+		/** The vertex data of all vertices.*/
+		FloatArray mVertexData;
+
+		/** One index per index of the source primitive.*/
+		UIntValuesArray mIndices;
+
+		/** The same indices as mIndices, as 16 bit values. Empty, if there are more than
+		MAX_SHORT_INDEXED_VERTICES vertices.*/
+		ArrayPrimitiveType<unsigned short> mShortIndices;
+
+		/** The index arrays of the primitive, each vertex element refers to. */
+		std::vector<const unsigned int*> mElementIndices;
+
+		/** The vertex data of the mesh, each vertex element refers to.*/
+		std::vector<const FloatOrDoubleArray*> mElementValues;
+
+		/** The distinct index arrays in mElementIndices. Only these are hashed and compared.*/
+		std::vector<const unsigned int*> mKeyIndices;
+
+		/** The index of the first corner of the source primitive, that uses a vertex, for each vertex.*/
+		std::vector<unsigned int> mVertexCorners;
+
+		/** The open addressing hash table. Each slot contains the index of a vertex plus one, or 0 if the
+		slot is empty. The size is a power of two.*/
+		std::vector<unsigned int> mHashTable;
+
+	public:
+
+        /** Constructor. */
+		MeshVertexWelder( VertexLayout vertexLayout = INTERLEAVED );
+
+        /** Destructor. */
+		virtual ~MeshVertexWelder();
+
+		/** Sets the arrangement of the vertex data created by the next call of weld().*/
+		void setVertexLayout( VertexLayout vertexLayout ) { mVertexLayout = vertexLayout; }
+
+		/** Returns the arrangement of the vertex data.*/
+		VertexLayout getVertexLayout() const { return mVertexLayout; }
+
+		/** Creates the vertices and the index buffer of @a primitive. Index arrays of @a primitive, that do
+		not have one index per position index or refer to empty vertex data, are ignored. Indices that are out
+		of the range of the vertex data are replaced by zero values.
+		@param mesh The mesh @a primitive belongs to.
+		@return False, if @a primitive has no position indices or @a mesh no positions, true otherwise.*/
+		bool weld( const Mesh& mesh, const MeshPrimitive& primitive );
+
+		/** Welds all primitives of @a mesh in parallel.
+		@param welders One welder per primitive of @a mesh. The welder with index i welds the primitive with
+		index i.
+		@param maxThreadCount The maximum number of threads to use. If 0, the number of hardware threads is
+		used.*/
+		static void weldPrimitives( const Mesh& mesh, const std::vector<MeshVertexWelder*>& welders, size_t maxThreadCount = 0 );
+
+		/** Reorders the triangles for the vertex cache and to reduce overdraw, and then the vertices in the order
+		of their first use, see MeshOptimizer. The last welded primitive must have been a triangle list.
+		@param overdrawThreshold See MeshOptimizer::optimizeOverdraw(). If 0, overdraw is not optimized.
+		@return False, if nothing has been welded or the number of indices is not a multiple of three, true
+		otherwise.*/
+		bool optimize( MeshOptimizer& optimizer, float overdrawThreshold );
+
+		/** Returns the elements of the vertices.*/
+		const VertexElementList& getVertexElements() const { return mVertexElements; }
+
+		/** Returns the number of floats of one vertex.*/
+		size_t getVertexSize() const { return mVertexSize; }
+
+		/** Returns the number of distinct vertices.*/
+		size_t getVertexCount() const { return mVertexCount; }
+
+		/** Returns the vertex data of all vertices. */
+		const FloatArray& getVertexData() const { return mVertexData; }
+
+		/** Returns the values of the first vertex of the element with index @a elementIndex. The values of the
+		next vertex follow after getVertexElements()[elementIndex].stride floats.*/
+		const float* getElementData( size_t elementIndex ) const { return mVertexData.getData() + mVertexElements[elementIndex].offset; }
+
+		/** Returns the index buffer, with one 32 bit index per index of the source primitive.*/
+		const UIntValuesArray& getIndices() const { return mIndices; }
+
+		/** Returns true, if the indices are also available as 16 bit values, see getShortIndices().*/
+		bool hasShortIndices() const { return mIndices.getCount() == mShortIndices.getCount(); }
+
+		/** Returns the index buffer with 16 bit indices. Empty, if hasShortIndices() is false.*/
+		const ArrayPrimitiveType<unsigned short>& getShortIndices() const { return mShortIndices; }
+
+		/** Returns the size of the narrowest available index, in bytes, i.e. 2 or 4.*/
+		size_t getIndexSize() const { return hasShortIndices() ? sizeof(unsigned short) : sizeof(unsigned int); }
+
+		/** Returns the index buffer with the narrowest available indices, see getIndexSize().*/
+		const void* getIndexData() const;
+
+	private:
+
+        /** Disable default copy ctor. */
+		MeshVertexWelder( const MeshVertexWelder& pre );
+
+        /** Disable default assignment operator. */
+		const MeshVertexWelder& operator= ( const MeshVertexWelder& pre );
+
+		/** Adds a vertex element for @a indices, if it has @a cornersCount indices and @a vertexData is not
+		empty.*/
+		void addVertexElement( Semantic semantic, size_t setIndex, size_t componentCount, const UIntValuesArray& indices, size_t cornersCount, const FloatOrDoubleArray& vertexData );
+
+		/** Assigns the corners of the primitive to vertices and fills mIndices and mVertexCorners.*/
+		void assignVertices( size_t cornersCount );
+
+		/** Returns the hash of the key indices of the corner @a corner.*/
+		unsigned int hashCorner( size_t corner ) const;
+
+		/** Returns true, if the corners @a corner1 and @a corner2 have the same key indices.*/
+		bool equalCorners( size_t corner1, size_t corner2 ) const;
+
+		/** Sets the offsets and strides of the vertex elements and fills mVertexData.*/
+		void fillVertexData();
+
+		/** Fills mShortIndices, if the vertices can be addressed with 16 bit indices.*/
+		void fillShortIndices();
+	};
+
+} // namespace COLLADAFW
+
+#endif // __COLLADAFW_MESHVERTEXWELDER_H__
@@ -184,6 +184,11 @@ namespace COLLADAFW
         @return The calculated node transformation matrix. */
         COLLADABU::Math::Matrix4 getTransformationMatrix() const;
 
+        /** Calculates a baked matrix, representing the transformations @a transformations, e.g. of a node
+        or of a link of a kinematics model.
+        @param transformationMatrix Will be set to the calculated transformation matrix.*/
+        static void getTransformationMatrix(const TransformationPointerArray& transformations, COLLADABU::Math::Matrix4& transformationMatrix);
+
 		/** Creates a clone of the node and returns a pointer to it.*/
 		Node* clone() const { return FW_NEW Node(*this); }
 	};
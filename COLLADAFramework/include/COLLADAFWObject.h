@@ -64,8 +64,6 @@ namespace COLLADAFW
 		/** Returns the file id of the object.*/
 		FileId getFileId() const { return mUniqueId.getFileId(); }
 
-	protected:
-
         /** Sets the unique id of the object.*/
 		void setUniqueId ( const UniqueId& uniqueId )
 		{ 
@@ -141,7 +141,7 @@ namespace COLLADAFW
 		virtual ~Sampler();
 
 		/** Returns the sampler type. */
-		SamplerType getSamplerType ( ) { return mSamplerType; }
+		SamplerType getSamplerType ( ) const { return mSamplerType; }
 
 		/** Set the sampler type. */
 		void setSamplerType ( SamplerType samplerType ) { mSamplerType = samplerType; }
@@ -208,7 +208,7 @@ namespace COLLADAFW
 
         void setSid( const std::string &sid) { mSid = sid; }
 
-        const std::string& getSid() { return mSid; }
+        const std::string& getSid() const { return mSid; }
 
 		Sampler* clone() { return FW_NEW Sampler(*this); }
 	};
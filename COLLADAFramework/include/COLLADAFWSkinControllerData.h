@@ -124,6 +124,17 @@ namespace COLLADAFW
 		const IntValuesArray& getJointIndices() const { return mJointIndices; }
 		IntValuesArray& getJointIndices() { return mJointIndices; }
 
+		/** Computes a layout with a fixed number of influences per vertex, as used for skinning on the GPU. 
+		The influences of each vertex are sorted by descending weight and the strongest @a maxInfluences are 
+		kept, with their weights normalized to sum up to one. Vertices with fewer influences are padded with 
+		joint index 0 and weight 0.
+		@param maxInfluences The number of influences per vertex.
+		@param jointIndices Receives getVertexCount() * @a maxInfluences joint indices.
+		@param weights Receives getVertexCount() * @a maxInfluences weights.
+		@return False, if the joint/vertex pairs do not match the joints per vertex or refer to weights that
+		do not exist, true otherwise.*/
+		bool getFixedInfluences( size_t maxInfluences, IntValuesArray& jointIndices, FloatArray& weights ) const;
+
 	private:
 
         /** Disable default copy ctor. */
@@ -0,0 +1,23 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADAFramework.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADAFW_ANIMATIONCURVEREDUCERUNITTEST_H__
+#define __COLLADAFW_ANIMATIONCURVEREDUCERUNITTEST_H__
+
+#include <cstddef>
+
+
+/** Reduces baked linear, smooth and step curves with AnimationCurveReducer and compares the reduced curves
+with the original ones at many inputs between the keys. Checks the number of kept keys and that the error
+reported by the reducer matches the error found by the dense sampling. Returns the number of errors.*/
+size_t animationCurveReducerUnitTest();
+
+
+#endif // __COLLADAFW_ANIMATIONCURVEREDUCERUNITTEST_H__
@@ -0,0 +1,23 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADAFramework.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADAFW_MESHDEDUPLICATORUNITTEST_H__
+#define __COLLADAFW_MESHDEDUPLICATORUNITTEST_H__
+
+#include <cstddef>
+
+
+/** Adds equal, changed, moved and reflected copies of a mesh to MeshDeduplicator, with exact and with rigid
+matching, and checks which of them are found as duplicates and the transformations of the moved copies.
+Returns the number of errors.*/
+size_t meshDeduplicatorUnitTest();
+
+
+#endif // __COLLADAFW_MESHDEDUPLICATORUNITTEST_H__
@@ -0,0 +1,24 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADAFramework.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADAFW_MESHTRIANGULATORUNITTEST_H__
+#define __COLLADAFW_MESHTRIANGULATORUNITTEST_H__
+
+#include <cstddef>
+
+
+/** Triangulates convex and concave polygons, polygons with collinear and duplicate corners, with holes,
+holes touching the outline and clockwise outlines with MeshTriangulator. Checks the number of triangles,
+that no triangle is flipped and that the areas of the triangles sum up to the area of the polygon. Returns
+the number of errors.*/
+size_t meshTriangulatorUnitTest();
+
+
+#endif // __COLLADAFW_MESHTRIANGULATORUNITTEST_H__
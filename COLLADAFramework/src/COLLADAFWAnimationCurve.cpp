@@ -0,0 +1,110 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADAFramework.
+
+    Licensed under the MIT Open Source License, 
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADAFWStableHeaders.h"
+#include "COLLADAFWAnimationCurve.h"
+
+#include <atomic>
+#include <mutex>
+
+
+namespace COLLADAFW
+{
+
+	//------------------------------
+	struct AnimationCurve::LazyValuesData
+	{
+		/** Guards decoding and replacing the lazy values.*/
+		std::mutex mutex;
+
+		/** The values not decoded yet of each array. Null, if the array has been decoded or has no lazy 
+		values. Read without lock to keep the getters cheap, once everything has been decoded.*/
+		std::atomic<LazyValues*> lazyValues[VALUES_ARRAY_COUNT];
+
+		LazyValuesData()
+		{
+			for ( size_t i = 0; i < VALUES_ARRAY_COUNT; ++i )
+				lazyValues[i].store( 0, std::memory_order_relaxed );
+		}
+
+		~LazyValuesData()
+		{
+			for ( size_t i = 0; i < VALUES_ARRAY_COUNT; ++i )
+				delete lazyValues[i].load( std::memory_order_relaxed );
+		}
+	};
+
+	//------------------------------
+	AnimationCurve::~AnimationCurve()
+	{
+		delete mLazyValuesData;
+	}
+
+	//------------------------------
+	void AnimationCurve::setLazyValues( ValuesArray valuesArray, LazyValues* lazyValues )
+	{
+		if ( !mLazyValuesData )
+		{
+			if ( !lazyValues )
+				return;
+			mLazyValuesData = new LazyValuesData();
+		}
+
+		std::lock_guard<std::mutex> lock( mLazyValuesData->mutex );
+		delete mLazyValuesData->lazyValues[valuesArray].exchange( lazyValues, std::memory_order_acq_rel );
+	}
+
+	//------------------------------
+	size_t AnimationCurve::getValuesCount( ValuesArray valuesArray ) const
+	{
+		if ( mLazyValuesData )
+		{
+			std::lock_guard<std::mutex> lock( mLazyValuesData->mutex );
+			const LazyValues* lazyValues = mLazyValuesData->lazyValues[valuesArray].load( std::memory_order_relaxed );
+			if ( lazyValues )
+				return lazyValues->getValuesCount();
+		}
+		return getValuesArray( valuesArray ).getValuesCount();
+	}
+
+	//------------------------------
+	FloatOrDoubleArray& AnimationCurve::getValuesArray( ValuesArray valuesArray ) const
+	{
+		switch ( valuesArray )
+		{
+		case OUTPUT_VALUES:
+			return mOutputValues;
+		case IN_TANGENT_VALUES:
+			return mInTangentValues;
+		case OUT_TANGENT_VALUES:
+			return mOutTangentValues;
+		case INPUT_VALUES:
+		default:
+			return mInputValues;
+		}
+	}
+
+	//------------------------------
+	void AnimationCurve::decodeLazyValues( ValuesArray valuesArray ) const
+	{
+		std::atomic<LazyValues*>& lazyValuesSlot = mLazyValuesData->lazyValues[valuesArray];
+		if ( !lazyValuesSlot.load( std::memory_order_acquire ) )
+			return;
+
+		std::lock_guard<std::mutex> lock( mLazyValuesData->mutex );
+		LazyValues* lazyValues = lazyValuesSlot.load( std::memory_order_relaxed );
+		if ( !lazyValues )
+			return;
+		lazyValues->decode( getValuesArray( valuesArray ) );
+		lazyValuesSlot.store( 0, std::memory_order_release );
+		delete lazyValues;
+	}
+
+} // namespace COLLADAFW
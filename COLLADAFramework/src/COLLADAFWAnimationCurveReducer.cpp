@@ -0,0 +1,517 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADAFramework.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADAFWStableHeaders.h"
+#include "COLLADAFWAnimationCurveReducer.h"
+#include "COLLADAFWAnimationCurve.h"
+
+#include "COLLADABUParallel.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace COLLADAFW
+{
+
+	namespace
+	{
+		/** Curves with less keys in total are reduced on the calling thread.*/
+		const size_t MIN_KEYS_FOR_CONCURRENT_REDUCTION = 16384;
+
+		/** Returns the value @a index of @a values as double.*/
+		double getValue( const FloatOrDoubleArray& values, size_t index )
+		{
+			if ( values.getType() == FloatOrDoubleArray::DATA_TYPE_FLOAT )
+				return values.getFloatValues()->getData()[index];
+			return values.getDoubleValues()->getData()[index];
+		}
+
+		/** Replaces the values of @a array by @a values. Arrays of unknown type become arrays of type @a type.*/
+		void setValues( FloatOrDoubleArray& array, const std::vector<double>& values, FloatOrDoubleArray::DataType type )
+		{
+			if ( array.getType() == FloatOrDoubleArray::DATA_TYPE_UNKNOWN )
+				array.setType( type );
+
+			if ( array.getType() == FloatOrDoubleArray::DATA_TYPE_FLOAT )
+			{
+				FloatArray& floatValues = *array.getFloatValues();
+				floatValues.setCount( 0 );
+				floatValues.reallocMemory( values.size() );
+				for ( size_t i = 0; i < values.size(); ++i )
+					floatValues.append( (float)values[i] );
+			}
+			else
+			{
+				DoubleArray& doubleValues = *array.getDoubleValues();
+				doubleValues.setCount( 0 );
+				if ( !values.empty() )
+					doubleValues.appendValues( &values[0], values.size() );
+			}
+		}
+
+		/** Returns the number of input, output and tangent values of @a animationCurve.*/
+		size_t getValuesCount( const AnimationCurve& animationCurve )
+		{
+			return animationCurve.getInputValues().getValuesCount()
+				+ animationCurve.getOutputValues().getValuesCount()
+				+ animationCurve.getInTangentValues().getValuesCount()
+				+ animationCurve.getOutTangentValues().getValuesCount();
+		}
+
+		/** Reduces the curves in a range on one thread.*/
+		class ReduceTask : public COLLADABU::ParallelTask
+		{
+		private:
+			const std::vector<AnimationCurve*>& mAnimationCurves;
+			AnimationCurveReducer::Fitting mFitting;
+			const std::vector<double>& mTolerances;
+			std::vector<AnimationCurveReducer::Statistics>& mStatistics;
+
+		public:
+			ReduceTask( const std::vector<AnimationCurve*>& animationCurves,
+				AnimationCurveReducer::Fitting fitting,
+				const std::vector<double>& tolerances,
+				std::vector<AnimationCurveReducer::Statistics>& statistics )
+				: mAnimationCurves(animationCurves)
+				, mFitting(fitting)
+				, mTolerances(tolerances)
+				, mStatistics(statistics)
+			{}
+
+			virtual void execute( size_t begin, size_t end, size_t threadIndex )
+			{
+				AnimationCurveReducer reducer( mFitting );
+				reducer.setTolerances( mTolerances );
+				for ( size_t i = begin; i < end; ++i )
+				{
+					if ( mAnimationCurves[i] )
+						reducer.reduce( *mAnimationCurves[i], &mStatistics[i] );
+				}
+			}
+
+		private:
+			/** Disable default assignment operator. */
+			const ReduceTask& operator= ( const ReduceTask& pre );
+		};
+	}
+
+	//------------------------------
+	void AnimationCurveReducer::Statistics::add( const Statistics& statistics )
+	{
+		keysCount += statistics.keysCount;
+		reducedKeysCount += statistics.reducedKeysCount;
+		valuesCount += statistics.valuesCount;
+		reducedValuesCount += statistics.reducedValuesCount;
+		maxError = std::max( maxError, statistics.maxError );
+	}
+
+	//------------------------------
+	double AnimationCurveReducer::Statistics::getCompressionRatio() const
+	{
+		if ( reducedValuesCount == 0 )
+			return 1.0;
+		return (double)valuesCount / (double)reducedValuesCount;
+	}
+
+	//------------------------------
+	AnimationCurveReducer::AnimationCurveReducer( Fitting fitting )
+		: mFitting( fitting )
+		, mFittedError( 0 )
+	{
+	}
+
+	//------------------------------
+	AnimationCurveReducer::~AnimationCurveReducer()
+	{
+	}
+
+	//------------------------------
+	bool AnimationCurveReducer::reduce( AnimationCurve& animationCurve, Statistics* statistics )
+	{
+		Statistics result;
+		if ( !mSampler.setAnimationCurve( animationCurve ) )
+		{
+			if ( statistics )
+				*statistics = result;
+			return false;
+		}
+
+		AnimationCurve::InterpolationType interpolationType = animationCurve.getInterpolationType();
+		if ( interpolationType == AnimationCurve::INTERPOLATION_MIXED )
+		{
+			const AnimationCurve::InterpolationTypeArray& interpolationTypes = animationCurve.getInterpolationTypes();
+			for ( size_t i = 0; i < interpolationTypes.getCount(); ++i )
+			{
+				if ( interpolationTypes[i] == AnimationCurve::INTERPOLATION_STEP )
+				{
+					if ( statistics )
+						*statistics = result;
+					return false;
+				}
+			}
+		}
+
+		size_t keysCount = animationCurve.getKeyCount();
+		size_t channelsCount = animationCurve.getOutDimension();
+		result.keysCount = keysCount;
+		result.reducedKeysCount = keysCount;
+		result.valuesCount = getValuesCount( animationCurve );
+		result.reducedValuesCount = result.valuesCount;
+
+		if ( keysCount < 3 || mTolerances.empty() )
+		{
+			if ( statistics )
+				*statistics = result;
+			return true;
+		}
+
+		mChannelTolerances.resize( channelsCount );
+		for ( size_t channel = 0; channel < channelsCount; ++channel )
+			mChannelTolerances[channel] = mTolerances[std::min( channel, mTolerances.size() - 1 )];
+
+		const FloatOrDoubleArray& inputs = animationCurve.getInputValues();
+		const FloatOrDoubleArray& outputs = animationCurve.getOutputValues();
+		mKeyInputs.resize( keysCount );
+		for ( size_t key = 0; key < keysCount; ++key )
+			mKeyInputs[key] = getValue( inputs, key );
+		mKeyOutputs.resize( keysCount * channelsCount );
+		for ( size_t i = 0; i < mKeyOutputs.size(); ++i )
+			mKeyOutputs[i] = getValue( outputs, i );
+
+		bool steps = interpolationType == AnimationCurve::INTERPOLATION_STEP;
+		double maxError = steps ? reduceSteps() : reduceSegments();
+
+		// Bezier segments store four tangent values per output value
+		size_t keptCount = mKeptKeys.size();
+		size_t keptValuesCount = keptCount + keptCount * channelsCount;
+		if ( !steps && mFitting == FITTING_BEZIER )
+			keptValuesCount += 4 * keptCount * channelsCount;
+
+		if ( keptValuesCount < result.valuesCount )
+		{
+			writeKeptKeys( animationCurve, steps );
+			result.reducedKeysCount = keptCount;
+			result.reducedValuesCount = getValuesCount( animationCurve );
+			result.maxError = maxError;
+		}
+
+		if ( statistics )
+			*statistics = result;
+		return true;
+	}
+
+	//------------------------------
+	double AnimationCurveReducer::reduceSteps()
+	{
+		size_t keysCount = mKeyInputs.size();
+		size_t channelsCount = mChannelTolerances.size();
+		double maxError = 0.0;
+
+		mKeptKeys.assign( 1, 0 );
+		size_t lastKeptKey = 0;
+		for ( size_t key = 1; key + 1 < keysCount; ++key )
+		{
+			bool differs = false;
+			double keyError = 0.0;
+			for ( size_t channel = 0; channel < channelsCount; ++channel )
+			{
+				double difference = std::abs( mKeyOutputs[key * channelsCount + channel] - mKeyOutputs[lastKeptKey * channelsCount + channel] );
+				differs |= difference > mChannelTolerances[channel];
+				keyError = std::max( keyError, difference );
+			}
+
+			if ( differs )
+			{
+				mKeptKeys.push_back( key );
+				lastKeptKey = key;
+			}
+			else
+			{
+				maxError = std::max( maxError, keyError );
+			}
+		}
+		mKeptKeys.push_back( keysCount - 1 );
+
+		return maxError;
+	}
+
+	//------------------------------
+	double AnimationCurveReducer::reduceSegments()
+	{
+		size_t keysCount = mKeyInputs.size();
+		size_t channelsCount = mChannelTolerances.size();
+		size_t lastKey = keysCount - 1;
+
+		// the keys of the segments and the samples within them, the last sample is the last key
+		size_t samplesCount = lastKey * SAMPLES_PER_SEGMENT + 1;
+		mSampleInputs.resize( samplesCount );
+		for ( size_t key = 0; key < lastKey; ++key )
+		{
+			double input = mKeyInputs[key];
+			double step = ( mKeyInputs[key + 1] - input ) / SAMPLES_PER_SEGMENT;
+			for ( size_t i = 0; i < SAMPLES_PER_SEGMENT; ++i )
+				mSampleInputs[key * SAMPLES_PER_SEGMENT + i] = input + (double)i * step;
+		}
+		mSampleInputs[samplesCount - 1] = mKeyInputs[lastKey];
+
+		mSampleOutputs.resize( samplesCount * channelsCount );
+		mSampler.sample( &mSampleInputs[0], samplesCount, &mSampleOutputs[0], samplesCount );
+
+		// the sampler gives the output of the later key at discontinuities
+		for ( size_t channel = 0; channel < channelsCount; ++channel )
+		{
+			for ( size_t key = 0; key < keysCount; ++key )
+				mSampleOutputs[channel * samplesCount + key * SAMPLES_PER_SEGMENT] = mKeyOutputs[key * channelsCount + channel];
+		}
+
+		// keys at discontinuities are never removed
+		mNextFixedKeys.resize( keysCount );
+		mNextFixedKeys[lastKey] = lastKey;
+		for ( size_t key = lastKey; key-- > 0; )
+		{
+			bool fixed = ( key == 0 ) || ( mKeyInputs[key] == mKeyInputs[key - 1] ) || ( mKeyInputs[key] == mKeyInputs[key + 1] );
+			mNextFixedKeys[key] = fixed ? key : mNextFixedKeys[key + 1];
+		}
+
+		mKeptKeys.assign( 1, 0 );
+		mKeptOutputs.clear();
+		mFittedOutputs.resize( 2 * channelsCount );
+		double maxError = 0.0;
+
+		size_t firstKey = 0;
+		while ( firstKey < lastKey )
+		{
+			size_t limit = mNextFixedKeys[firstKey + 1];
+
+			// find a segment, that can not be fitted, by doubling the length, then bisect
+			size_t fittedKey = firstKey + 1;
+			size_t failedKey = limit + 1;
+			for ( size_t length = 2; firstKey + length <= limit; length *= 2 )
+			{
+				if ( !fitSegment( firstKey, firstKey + length ) )
+				{
+					failedKey = firstKey + length;
+					break;
+				}
+				fittedKey = firstKey + length;
+			}
+			if ( failedKey > limit && fittedKey < limit )
+			{
+				if ( fitSegment( firstKey, limit ) )
+					fittedKey = limit;
+				else
+					failedKey = limit;
+			}
+			while ( failedKey - fittedKey > 1 )
+			{
+				size_t key = fittedKey + ( failedKey - fittedKey ) / 2;
+				if ( fitSegment( firstKey, key ) )
+					fittedKey = key;
+				else
+					failedKey = key;
+			}
+
+			// a single segment is kept, even if it exceeds the tolerance
+			fitSegment( firstKey, fittedKey );
+			maxError = std::max( maxError, mFittedError );
+			mKeptOutputs.insert( mKeptOutputs.end(), mFittedOutputs.begin(), mFittedOutputs.end() );
+			mKeptKeys.push_back( fittedKey );
+			firstKey = fittedKey;
+		}
+
+		return maxError;
+	}
+
+	//------------------------------
+	bool AnimationCurveReducer::fitSegment( size_t firstKey, size_t lastKey )
+	{
+		size_t channelsCount = mChannelTolerances.size();
+		size_t samplesCount = mSampleInputs.size();
+		size_t firstSample = firstKey * SAMPLES_PER_SEGMENT + 1;
+		size_t endSample = lastKey * SAMPLES_PER_SEGMENT;
+		double input0 = mKeyInputs[firstKey];
+		double inputLength = mKeyInputs[lastKey] - input0;
+		const double* sampleInputs = &mSampleInputs[0];
+
+		bool fitted = true;
+		mFittedError = 0.0;
+		for ( size_t channel = 0; channel < channelsCount; ++channel )
+		{
+			const double* sampleOutputs = &mSampleOutputs[channel * samplesCount];
+			double output0 = mKeyOutputs[firstKey * channelsCount + channel];
+			double output3 = mKeyOutputs[lastKey * channelsCount + channel];
+			double output1 = output0 + ( output3 - output0 ) / 3.0;
+			double output2 = output3 - ( output3 - output0 ) / 3.0;
+
+			if ( inputLength <= 0.0 )
+			{
+				mFittedOutputs[2 * channel] = output1;
+				mFittedOutputs[2 * channel + 1] = output2;
+				continue;
+			}
+
+			if ( mFitting == FITTING_BEZIER )
+			{
+				// least squares of the outputs of the inner control points
+				double sum11 = 0.0;
+				double sum12 = 0.0;
+				double sum22 = 0.0;
+				double sum1 = 0.0;
+				double sum2 = 0.0;
+				for ( size_t i = firstSample; i < endSample; ++i )
+				{
+					double s = ( sampleInputs[i] - input0 ) / inputLength;
+					double t = 1.0 - s;
+					double basis1 = 3.0 * s * t * t;
+					double basis2 = 3.0 * s * s * t;
+					double residual = sampleOutputs[i] - t * t * t * output0 - s * s * s * output3;
+					sum11 += basis1 * basis1;
+					sum12 += basis1 * basis2;
+					sum22 += basis2 * basis2;
+					sum1 += basis1 * residual;
+					sum2 += basis2 * residual;
+				}
+
+				double determinant = sum11 * sum22 - sum12 * sum12;
+				if ( determinant > 1e-12 * sum11 * sum22 )
+				{
+					output1 = ( sum22 * sum1 - sum12 * sum2 ) / determinant;
+					output2 = ( sum11 * sum2 - sum12 * sum1 ) / determinant;
+				}
+			}
+
+			mFittedOutputs[2 * channel] = output1;
+			mFittedOutputs[2 * channel + 1] = output2;
+
+			double tolerance = mChannelTolerances[channel];
+			for ( size_t i = firstSample; i < endSample; ++i )
+			{
+				double s = ( sampleInputs[i] - input0 ) / inputLength;
+				double output;
+				if ( mFitting == FITTING_BEZIER )
+				{
+					double t = 1.0 - s;
+					output = t * t * t * output0 + 3.0 * s * t * ( t * output1 + s * output2 ) + s * s * s * output3;
+				}
+				else
+				{
+					output = output0 + ( output3 - output0 ) * s;
+				}
+
+				double error = std::abs( output - sampleOutputs[i] );
+				mFittedError = std::max( mFittedError, error );
+				if ( error > tolerance )
+				{
+					fitted = false;
+					break;
+				}
+			}
+
+			if ( !fitted )
+				break;
+		}
+
+		return fitted;
+	}
+
+	//------------------------------
+	void AnimationCurveReducer::writeKeptKeys( AnimationCurve& animationCurve, bool steps ) const
+	{
+		size_t keptCount = mKeptKeys.size();
+		size_t channelsCount = mChannelTolerances.size();
+
+		std::vector<double> inputs( keptCount );
+		std::vector<double> outputs( keptCount * channelsCount );
+		for ( size_t i = 0; i < keptCount; ++i )
+		{
+			size_t key = mKeptKeys[i];
+			inputs[i] = mKeyInputs[key];
+			std::copy( &mKeyOutputs[key * channelsCount], &mKeyOutputs[key * channelsCount] + channelsCount, &outputs[i * channelsCount] );
+		}
+
+		FloatOrDoubleArray& outputValues = animationCurve.getOutputValues();
+		FloatOrDoubleArray::DataType type = outputValues.getType();
+		setValues( animationCurve.getInputValues(), inputs, type );
+		setValues( outputValues, outputs, type );
+
+		std::vector<double> inTangents;
+		std::vector<double> outTangents;
+		if ( !steps )
+		{
+			animationCurve.setInterpolationType( mFitting == FITTING_BEZIER ? AnimationCurve::INTERPOLATION_BEZIER : AnimationCurve::INTERPOLATION_LINEAR );
+			animationCurve.getInterpolationTypes().setCount( 0 );
+		}
+
+		if ( !steps && mFitting == FITTING_BEZIER )
+		{
+			// the control points at the thirds of each segment, mirrored at the first and the last key
+			inTangents.resize( 2 * keptCount * channelsCount );
+			outTangents.resize( 2 * keptCount * channelsCount );
+			for ( size_t i = 0; i + 1 < keptCount; ++i )
+			{
+				double step = ( inputs[i + 1] - inputs[i] ) / 3.0;
+				for ( size_t channel = 0; channel < channelsCount; ++channel )
+				{
+					size_t outIndex = 2 * ( i * channelsCount + channel );
+					size_t inIndex = outIndex + 2 * channelsCount;
+					outTangents[outIndex] = inputs[i] + step;
+					outTangents[outIndex + 1] = mKeptOutputs[2 * ( i * channelsCount + channel )];
+					inTangents[inIndex] = inputs[i + 1] - step;
+					inTangents[inIndex + 1] = mKeptOutputs[2 * ( i * channelsCount + channel ) + 1];
+				}
+			}
+
+			size_t last = keptCount - 1;
+			for ( size_t channel = 0; channel < channelsCount; ++channel )
+			{
+				size_t firstIndex = 2 * channel;
+				size_t lastIndex = 2 * ( last * channelsCount + channel );
+				inTangents[firstIndex] = 2.0 * inputs[0] - outTangents[firstIndex];
+				inTangents[firstIndex + 1] = 2.0 * outputs[channel] - outTangents[firstIndex + 1];
+				outTangents[lastIndex] = 2.0 * inputs[last] - inTangents[lastIndex];
+				outTangents[lastIndex + 1] = 2.0 * outputs[last * channelsCount + channel] - inTangents[lastIndex + 1];
+			}
+		}
+
+		setValues( animationCurve.getInTangentValues(), inTangents, type );
+		setValues( animationCurve.getOutTangentValues(), outTangents, type );
+	}
+
+	//------------------------------
+	AnimationCurveReducer::Statistics AnimationCurveReducer::reduceAnimationCurves( const std::vector<AnimationCurve*>& animationCurves,
+		Fitting fitting,
+		const std::vector<double>& tolerances,
+		std::vector<Statistics>* curveStatistics,
+		size_t maxThreadCount )
+	{
+		size_t curvesCount = animationCurves.size();
+		size_t keysCount = 0;
+		for ( size_t i = 0; i < curvesCount; ++i )
+		{
+			if ( animationCurves[i] )
+				keysCount += animationCurves[i]->getKeyCount();
+		}
+		if ( keysCount < MIN_KEYS_FOR_CONCURRENT_REDUCTION )
+			maxThreadCount = 1;
+
+		std::vector<Statistics> statistics( curvesCount );
+		ReduceTask reduceTask( animationCurves, fitting, tolerances, statistics );
+		COLLADABU::parallelFor( curvesCount, reduceTask, maxThreadCount, 1 );
+
+		Statistics result;
+		for ( size_t i = 0; i < curvesCount; ++i )
+			result.add( statistics[i] );
+		if ( curveStatistics )
+			curveStatistics->swap( statistics );
+		return result;
+	}
+
+} // namespace COLLADAFW
@@ -0,0 +1,499 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADAFramework.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADAFWStableHeaders.h"
+#include "COLLADAFWAnimationSampler.h"
+#include "COLLADAFWAnimationCurve.h"
+#include "COLLADAFWAnimationList.h"
+
+#include "COLLADABUParallel.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace COLLADAFW
+{
+
+	namespace
+	{
+		/** The maximum number of Newton iterations solving the parameter of a sample. The initial guess is exact
+		for linear segments, and few iterations reach full precision for smooth ones. The bisection fallback
+		converges also for segments with flat inputs.*/
+		const size_t SOLVER_ITERATIONS = 12;
+
+		/** The iterations stop, when no parameter of a block changes by more than this.*/
+		const double PARAMETER_TOLERANCE = 1e-14;
+
+		/** The number of arrays of the block, the coefficients of the segments and the parameters of the
+		samples with their brackets and last changes.*/
+		const size_t BLOCK_ARRAYS_COUNT = 11;
+
+		/** Bakes with less samples in total are computed on the calling thread.*/
+		const size_t MIN_SAMPLES_FOR_CONCURRENT_BAKING = 65536;
+
+		/** Returns the value @a index of @a values as double.*/
+		double getValue( const FloatOrDoubleArray& values, size_t index )
+		{
+			if ( values.getType() == FloatOrDoubleArray::DATA_TYPE_FLOAT )
+				return values.getFloatValues()->getData()[index];
+			return values.getDoubleValues()->getData()[index];
+		}
+
+		/** Returns the number of values of each tangent, 2 for 2D points, 1 for values and 0, if @a tangents
+		does not contain a tangent for each of the @a outputsCount output values.*/
+		size_t getTangentDimension( const FloatOrDoubleArray& tangents, size_t outputsCount )
+		{
+			size_t count = tangents.getValuesCount();
+			if ( outputsCount == 0 )
+				return 0;
+			if ( count >= 2 * outputsCount )
+				return 2;
+			if ( count >= outputsCount )
+				return 1;
+			return 0;
+		}
+
+		/** Bakes the curves in a range on one thread.*/
+		class BakeTask : public COLLADABU::ParallelTask
+		{
+		private:
+			const std::vector<const AnimationCurve*>& mAnimationCurves;
+			double mStartInput;
+			double mFrameRate;
+			size_t mFramesCount;
+			double* const* mValues;
+			std::vector<char>& mEvaluated;
+
+		public:
+			BakeTask( const std::vector<const AnimationCurve*>& animationCurves,
+				double startInput,
+				double frameRate,
+				size_t framesCount,
+				double* const* values,
+				std::vector<char>& evaluated )
+				: mAnimationCurves(animationCurves)
+				, mStartInput(startInput)
+				, mFrameRate(frameRate)
+				, mFramesCount(framesCount)
+				, mValues(values)
+				, mEvaluated(evaluated)
+			{}
+
+			virtual void execute( size_t begin, size_t end, size_t threadIndex )
+			{
+				AnimationSampler sampler;
+				for ( size_t i = begin; i < end; ++i )
+				{
+					const AnimationCurve* animationCurve = mAnimationCurves[i];
+					double* values = mValues[i];
+					if ( !animationCurve || !values )
+						continue;
+
+					if ( sampler.setAnimationCurve( *animationCurve ) )
+					{
+						sampler.sampleFrames( mStartInput, mFrameRate, mFramesCount, values, mFramesCount );
+						mEvaluated[i] = 1;
+					}
+					else
+					{
+						std::fill( values, values + animationCurve->getOutDimension() * mFramesCount, 0.0 );
+					}
+				}
+			}
+
+		private:
+			/** Disable default assignment operator. */
+			const BakeTask& operator= ( const BakeTask& pre );
+		};
+	}
+
+	//------------------------------
+	AnimationSampler::AnimationSampler()
+		: mSegmentsCount( 0 )
+		, mChannelsCount( 0 )
+		, mCursor( 0 )
+		, mBlockSegments( BLOCK_SIZE )
+		, mBlockInputs( BLOCK_SIZE )
+		, mBlockArrays( BLOCK_ARRAYS_COUNT * BLOCK_SIZE )
+		, mFrameInputs( BLOCK_SIZE )
+	{
+	}
+
+	//------------------------------
+	AnimationSampler::~AnimationSampler()
+	{
+	}
+
+	//------------------------------
+	bool AnimationSampler::setAnimationCurve( const AnimationCurve& animationCurve )
+	{
+		mKeyInputs.clear();
+		mSegmentsCount = 0;
+		mChannelsCount = 0;
+		mCursor = 0;
+
+		size_t keysCount = animationCurve.getKeyCount();
+		size_t channelsCount = animationCurve.getOutDimension();
+		const FloatOrDoubleArray& inputs = animationCurve.getInputValues();
+		const FloatOrDoubleArray& outputs = animationCurve.getOutputValues();
+		if ( keysCount == 0 || channelsCount == 0
+			|| inputs.getValuesCount() < keysCount
+			|| outputs.getValuesCount() < keysCount * channelsCount )
+			return false;
+
+		mKeyInputs.resize( keysCount );
+		for ( size_t key = 0; key < keysCount; ++key )
+			mKeyInputs[key] = getValue( inputs, key );
+
+		mSegmentsCount = keysCount;
+		mChannelsCount = channelsCount;
+		size_t coefficientsCount = keysCount * channelsCount;
+		mInputA.resize( coefficientsCount );
+		mInputB.resize( coefficientsCount );
+		mInputC.resize( coefficientsCount );
+		mOutputA.resize( coefficientsCount );
+		mOutputB.resize( coefficientsCount );
+		mOutputC.resize( coefficientsCount );
+		mOutputD.resize( coefficientsCount );
+
+		const FloatOrDoubleArray& inTangents = animationCurve.getInTangentValues();
+		const FloatOrDoubleArray& outTangents = animationCurve.getOutTangentValues();
+		size_t inTangentDimension = getTangentDimension( inTangents, coefficientsCount );
+		size_t outTangentDimension = getTangentDimension( outTangents, coefficientsCount );
+
+		AnimationCurve::InterpolationType curveInterpolationType = animationCurve.getInterpolationType();
+		const AnimationCurve::InterpolationTypeArray& interpolationTypes = animationCurve.getInterpolationTypes();
+
+		for ( size_t key = 0; key + 1 < keysCount; ++key )
+		{
+			AnimationCurve::InterpolationType interpolationType = curveInterpolationType;
+			if ( interpolationType == AnimationCurve::INTERPOLATION_MIXED )
+			{
+				interpolationType = key < interpolationTypes.getCount() ? interpolationTypes[key] : AnimationCurve::INTERPOLATION_LINEAR;
+			}
+
+			double input0 = mKeyInputs[key];
+			double input3 = mKeyInputs[key + 1];
+			double inputStep = ( input3 - input0 ) / 3.0;
+
+			for ( size_t channel = 0; channel < channelsCount; ++channel )
+			{
+				size_t outIndex = key * channelsCount + channel;
+				size_t inIndex = outIndex + channelsCount;
+				double output0 = getValue( outputs, outIndex );
+				double output3 = getValue( outputs, inIndex );
+
+				// linear by default
+				double input1 = input0 + inputStep;
+				double input2 = input3 - inputStep;
+				double output1 = output0 + ( output3 - output0 ) / 3.0;
+				double output2 = output3 - ( output3 - output0 ) / 3.0;
+
+				switch ( interpolationType )
+				{
+				case AnimationCurve::INTERPOLATION_STEP:
+					output1 = output0;
+					output2 = output0;
+					output3 = output0;
+					break;
+
+				case AnimationCurve::INTERPOLATION_BEZIER:
+					if ( outTangentDimension == 2 )
+					{
+						input1 = getValue( outTangents, 2 * outIndex );
+						output1 = getValue( outTangents, 2 * outIndex + 1 );
+					}
+					else if ( outTangentDimension == 1 )
+					{
+						output1 = getValue( outTangents, outIndex );
+					}
+					if ( inTangentDimension == 2 )
+					{
+						input2 = getValue( inTangents, 2 * inIndex );
+						output2 = getValue( inTangents, 2 * inIndex + 1 );
+					}
+					else if ( inTangentDimension == 1 )
+					{
+						output2 = getValue( inTangents, inIndex );
+					}
+					break;
+
+				case AnimationCurve::INTERPOLATION_HERMITE:
+					if ( outTangentDimension == 2 )
+					{
+						input1 = input0 + getValue( outTangents, 2 * outIndex ) / 3.0;
+						output1 = output0 + getValue( outTangents, 2 * outIndex + 1 ) / 3.0;
+					}
+					else if ( outTangentDimension == 1 )
+					{
+						output1 = output0 + getValue( outTangents, outIndex ) / 3.0;
+					}
+					if ( inTangentDimension == 2 )
+					{
+						input2 = input3 - getValue( inTangents, 2 * inIndex ) / 3.0;
+						output2 = output3 - getValue( inTangents, 2 * inIndex + 1 ) / 3.0;
+					}
+					else if ( inTangentDimension == 1 )
+					{
+						output2 = output3 - getValue( inTangents, inIndex ) / 3.0;
+					}
+					break;
+
+				default:
+					break;
+				}
+
+				// keep the input of the segment monotonic
+				input1 = std::min( std::max( input1, input0 ), input3 );
+				input2 = std::min( std::max( input2, input0 ), input3 );
+
+				setSegment( channel, key, input0, output0, input1, output1, input2, output2, input3, output3 );
+			}
+		}
+
+		// the constant segment after the last key
+		size_t lastKey = keysCount - 1;
+		for ( size_t channel = 0; channel < channelsCount; ++channel )
+		{
+			size_t index = channel * mSegmentsCount + lastKey;
+			mInputA[index] = 1.0;
+			mInputB[index] = 0.0;
+			mInputC[index] = 0.0;
+			mOutputA[index] = 0.0;
+			mOutputB[index] = 0.0;
+			mOutputC[index] = 0.0;
+			mOutputD[index] = getValue( outputs, lastKey * channelsCount + channel );
+		}
+
+		return true;
+	}
+
+	//------------------------------
+	void AnimationSampler::setSegment( size_t channel, size_t segment,
+		double input0, double output0,
+		double input1, double output1,
+		double input2, double output2,
+		double input3, double output3 )
+	{
+		size_t index = channel * mSegmentsCount + segment;
+
+		// the power basis of the Bezier segment, with the input relative to the first control point
+		double relativeInput1 = input1 - input0;
+		double relativeInput2 = input2 - input0;
+		double relativeInput3 = input3 - input0;
+		mInputA[index] = 3.0 * relativeInput1;
+		mInputB[index] = 3.0 * ( relativeInput2 - 2.0 * relativeInput1 );
+		mInputC[index] = relativeInput3 - 3.0 * relativeInput2 + 3.0 * relativeInput1;
+
+		mOutputA[index] = 3.0 * ( output1 - output0 );
+		mOutputB[index] = 3.0 * ( output2 - 2.0 * output1 + output0 );
+		mOutputC[index] = output3 - 3.0 * output2 + 3.0 * output1 - output0;
+		mOutputD[index] = output0;
+	}
+
+	//------------------------------
+	void AnimationSampler::sample( const double* inputs, size_t count, double* values, size_t valuesStride )
+	{
+		if ( mChannelsCount == 0 )
+			return;
+
+		for ( size_t start = 0; start < count; start += BLOCK_SIZE )
+		{
+			size_t blockCount = std::min( count - start, BLOCK_SIZE );
+			findSegments( inputs + start, blockCount );
+			sampleBlock( blockCount, values + start, valuesStride );
+		}
+	}
+
+	//------------------------------
+	void AnimationSampler::sampleFrames( double startInput, double frameRate, size_t framesCount, double* values, size_t valuesStride )
+	{
+		if ( mChannelsCount == 0 )
+			return;
+
+		double* frameInputs = &mFrameInputs[0];
+		for ( size_t start = 0; start < framesCount; start += BLOCK_SIZE )
+		{
+			size_t blockCount = std::min( framesCount - start, BLOCK_SIZE );
+
+			// divide, such that frames at whole multiples of the key inputs hit the keys exactly
+			for ( size_t i = 0; i < blockCount; ++i )
+				frameInputs[i] = startInput + (double)( start + i ) / frameRate;
+
+			findSegments( frameInputs, blockCount );
+			sampleBlock( blockCount, values + start, valuesStride );
+		}
+	}
+
+	//------------------------------
+	void AnimationSampler::findSegments( const double* inputs, size_t count )
+	{
+		const double* keyInputs = &mKeyInputs[0];
+		size_t lastSegment = mSegmentsCount - 1;
+		size_t segment = mCursor;
+		size_t* blockSegments = &mBlockSegments[0];
+		double* blockInputs = &mBlockInputs[0];
+
+		for ( size_t i = 0; i < count; ++i )
+		{
+			double input = inputs[i];
+			while ( segment < lastSegment && input >= keyInputs[segment + 1] )
+				++segment;
+			while ( segment > 0 && input < keyInputs[segment] )
+				--segment;
+
+			// inputs before the first key are clamped to it
+			double relativeInput = input - keyInputs[segment];
+			blockSegments[i] = segment;
+			blockInputs[i] = relativeInput > 0.0 ? relativeInput : 0.0;
+		}
+
+		mCursor = segment;
+	}
+
+	//------------------------------
+	void AnimationSampler::sampleBlock( size_t count, double* values, size_t valuesStride )
+	{
+		const size_t* blockSegments = &mBlockSegments[0];
+		const double* blockInputs = &mBlockInputs[0];
+		double* inputA = &mBlockArrays[0];
+		double* inputB = inputA + BLOCK_SIZE;
+		double* inputC = inputB + BLOCK_SIZE;
+		double* outputA = inputC + BLOCK_SIZE;
+		double* outputB = outputA + BLOCK_SIZE;
+		double* outputC = outputB + BLOCK_SIZE;
+		double* outputD = outputC + BLOCK_SIZE;
+		double* parameters = outputD + BLOCK_SIZE;
+		double* lows = parameters + BLOCK_SIZE;
+		double* highs = lows + BLOCK_SIZE;
+		double* changes = highs + BLOCK_SIZE;
+
+		for ( size_t channel = 0; channel < mChannelsCount; ++channel )
+		{
+			size_t channelStart = channel * mSegmentsCount;
+			for ( size_t i = 0; i < count; ++i )
+			{
+				size_t index = channelStart + blockSegments[i];
+				inputA[i] = mInputA[index];
+				inputB[i] = mInputB[index];
+				inputC[i] = mInputC[index];
+				outputA[i] = mOutputA[index];
+				outputB[i] = mOutputB[index];
+				outputC[i] = mOutputC[index];
+				outputD[i] = mOutputD[index];
+			}
+
+			// solve input(s) = relative input for s. Each pass over the block runs one iteration for all samples,
+			// without branches, such that the loops are vectorized.
+			for ( size_t i = 0; i < count; ++i )
+			{
+				double length = inputA[i] + inputB[i] + inputC[i];
+				double s = length > 0.0 ? blockInputs[i] / length : 0.0;
+				parameters[i] = s < 1.0 ? s : 1.0;
+				lows[i] = 0.0;
+				highs[i] = 1.0;
+			}
+
+			for ( size_t iteration = 0; iteration < SOLVER_ITERATIONS; ++iteration )
+			{
+				for ( size_t i = 0; i < count; ++i )
+				{
+					double s = parameters[i];
+					double a = inputA[i];
+					double b = inputB[i];
+					double c = inputC[i];
+					double error = ( ( c * s + b ) * s + a ) * s - blockInputs[i];
+					double derivative = ( 3.0 * c * s + 2.0 * b ) * s + a;
+					double low = error < 0.0 ? s : lows[i];
+					double high = error > 0.0 ? s : highs[i];
+
+					// fall back to bisection, if the Newton step leaves the bracket. A zero derivative gives an
+					// infinite step, 0 / 0 only occurs for a solved parameter, which is kept.
+					double middle = 0.5 * ( low + high );
+					double next = s - error / derivative;
+					next = next < low ? middle : next;
+					next = next > high ? middle : next;
+					next = error != 0.0 ? next : s;
+					changes[i] = next - s;
+					parameters[i] = next;
+					lows[i] = low;
+					highs[i] = high;
+				}
+
+				// stop, when the block is solved
+				size_t unsolved = 0;
+				while ( unsolved < count && std::abs( changes[unsolved] ) <= PARAMETER_TOLERANCE )
+					++unsolved;
+				if ( unsolved == count )
+					break;
+			}
+
+			double* channelValues = values + channel * valuesStride;
+			for ( size_t i = 0; i < count; ++i )
+			{
+				double s = parameters[i];
+				channelValues[i] = ( ( outputC[i] * s + outputB[i] ) * s + outputA[i] ) * s + outputD[i];
+			}
+		}
+	}
+
+	//------------------------------
+	size_t AnimationSampler::bake( const std::vector<const AnimationCurve*>& animationCurves,
+		double startInput,
+		double frameRate,
+		size_t framesCount,
+		double* const* values,
+		size_t maxThreadCount )
+	{
+		size_t curvesCount = animationCurves.size();
+		if ( curvesCount == 0 || framesCount == 0 )
+			return 0;
+
+		size_t samplesCount = 0;
+		for ( size_t i = 0; i < curvesCount; ++i )
+		{
+			if ( animationCurves[i] && values[i] )
+				samplesCount += animationCurves[i]->getOutDimension() * framesCount;
+		}
+		if ( samplesCount < MIN_SAMPLES_FOR_CONCURRENT_BAKING )
+			maxThreadCount = 1;
+
+		std::vector<char> evaluated( curvesCount, 0 );
+		BakeTask bakeTask( animationCurves, startInput, frameRate, framesCount, values, evaluated );
+		COLLADABU::parallelFor( curvesCount, bakeTask, maxThreadCount, 1 );
+
+		return (size_t)std::count( evaluated.begin(), evaluated.end(), 1 );
+	}
+
+	//------------------------------
+	size_t AnimationSampler::bakeAnimationList( const AnimationList& animationList,
+		const UniqueIdAnimationCurveMap& animationCurves,
+		double startInput,
+		double frameRate,
+		size_t framesCount,
+		double* const* values,
+		size_t maxThreadCount )
+	{
+		const AnimationList::AnimationBindings& bindings = animationList.getAnimationBindings();
+		size_t bindingsCount = bindings.getCount();
+
+		std::vector<const AnimationCurve*> boundCurves( bindingsCount, (const AnimationCurve*)0 );
+		for ( size_t i = 0; i < bindingsCount; ++i )
+		{
+			UniqueIdAnimationCurveMap::const_iterator it = animationCurves.find( bindings[i].animation );
+			if ( it != animationCurves.end() )
+				boundCurves[i] = it->second;
+		}
+
+		return bake( boundCurves, startInput, frameRate, framesCount, values, maxThreadCount );
+	}
+
+} // namespace COLLADAFW
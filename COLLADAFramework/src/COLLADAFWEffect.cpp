@@ -40,7 +40,7 @@ namespace COLLADAFW
 	}
 
 	//------------------------------
-	const PointerArray<TextureAttributes>& Effect::getExtraTextures()
+	const PointerArray<TextureAttributes>& Effect::getExtraTextures() const
 	{
 		return mExtraTextures;
 	}
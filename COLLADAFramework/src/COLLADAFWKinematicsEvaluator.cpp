@@ -0,0 +1,509 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADAFramework.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADAFWStableHeaders.h"
+#include "COLLADAFWKinematicsEvaluator.h"
+#include "COLLADAFWKinematicsModel.h"
+#include "COLLADAFWJoint.h"
+#include "COLLADAFWNode.h"
+
+#include "Math/COLLADABUMathMatrix4.h"
+
+#include "MathMLCompiledExpression.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+
+
+namespace COLLADAFW
+{
+
+	namespace
+	{
+		/** The factor converting degrees to radians. COLLADABU::Math::Utils::PI is not accurate enough for
+		the polynomials of cosinesSines().*/
+		const double DEGREES_TO_RADIANS = 3.14159265358979323846 / 180.0;
+
+		/** The coefficients of the polynomials approximating sine and cosine on [-pi/4, pi/4], as used by
+		the Cephes math library.*/
+		const double SIN_COEFFICIENTS[] = { 1.58962301576546568060e-10, -2.50507477628578072866e-8, 2.75573136213857245213e-6, -1.98412698295895385996e-4, 8.33333333332211858878e-3, -1.66666666666666307295e-1 };
+		const double COS_COEFFICIENTS[] = { -1.13585365213876817300e-11, 2.08757008419747316778e-9, -2.75573141792967388112e-7, 2.48015872888517045348e-5, -1.38888888888730564116e-3, 4.16666666666665929218e-2 };
+
+		/** Computes the cosines and sines of the @a count angles @a angles, given in degrees. The angles are
+		reduced to the nearest multiple of 90 degrees, which is exact for the angles of joints, and the
+		remainders are evaluated by polynomials. Unlike calls of cos() and sin(), the loop can be vectorized.*/
+		void cosinesSines( const double* angles, double* cosines, double* sines, size_t count )
+		{
+			const double* S = SIN_COEFFICIENTS;
+			const double* C = COS_COEFFICIENTS;
+			for ( size_t i = 0; i < count; ++i )
+			{
+				const double angle = angles[i];
+				const double quarters = angle * ( 1.0 / 90.0 );
+				const int quadrant = static_cast<int>( quarters + ( quarters < 0.0 ? -0.5 : 0.5 ) );
+				const double x = ( angle - quadrant * 90.0 ) * DEGREES_TO_RADIANS;
+				const double x2 = x * x;
+
+				const double sine = x + x * x2 * ( ( ( ( ( S[0] * x2 + S[1] ) * x2 + S[2] ) * x2 + S[3] ) * x2 + S[4] ) * x2 + S[5] );
+				const double cosine = 1.0 - 0.5 * x2 + x2 * x2 * ( ( ( ( ( C[0] * x2 + C[1] ) * x2 + C[2] ) * x2 + C[3] ) * x2 + C[4] ) * x2 + C[5] );
+
+				// rotate the result by the quadrant
+				const bool swap = ( quadrant & 1 ) != 0;
+				const double s = swap ? cosine : sine;
+				const double c = swap ? sine : cosine;
+				sines[i] = ( quadrant & 2 ) ? -s : s;
+				cosines[i] = ( ( quadrant + 1 ) & 2 ) ? -c : c;
+			}
+		}
+
+		/** Returns the product of the transformations @a transformations.*/
+		COLLADABU::Math::Matrix4 getTransformationMatrix( const TransformationPointerArray& transformations )
+		{
+			COLLADABU::Math::Matrix4 transformationMatrix;
+			Node::getTransformationMatrix( transformations, transformationMatrix );
+			return transformationMatrix;
+		}
+
+		/** Copies the upper three rows of @a matrix to @a transformation.*/
+		void setTransformation( double* transformation, const COLLADABU::Math::Matrix4& matrix )
+		{
+			for ( size_t row = 0; row < 3; ++row )
+				for ( size_t column = 0; column < 4; ++column )
+					transformation[row * 4 + column] = matrix[row][column];
+		}
+
+		/** Sets @a transformation to @a transformation1 * @a transformation2.*/
+		void multiplyTransformations( double* transformation, const double* transformation1, const double* transformation2 )
+		{
+			for ( size_t row = 0; row < 3; ++row )
+			{
+				const double* r = transformation1 + row * 4;
+				for ( size_t column = 0; column < 4; ++column )
+				{
+					transformation[row * 4 + column] = r[0] * transformation2[column]
+						+ r[1] * transformation2[4 + column]
+						+ r[2] * transformation2[8 + column]
+						+ ( column == 3 ? r[3] : 0.0 );
+				}
+			}
+		}
+
+		/** Sets @a frame to a rotation, whose z axis is the normalized axis @a axis.*/
+		void setAxisFrame( double* frame, const COLLADABU::Math::Vector3& axis )
+		{
+			COLLADABU::Math::Vector3 z = axis;
+			z.normalise();
+			COLLADABU::Math::Vector3 x = ( fabs( z.x ) < 0.9 ) ? COLLADABU::Math::Vector3::UNIT_X : COLLADABU::Math::Vector3::UNIT_Y;
+			x = x - z * x.dotProduct( z );
+			x.normalise();
+			COLLADABU::Math::Vector3 y = z.crossProduct( x );
+
+			const COLLADABU::Math::Vector3* columns[3] = { &x, &y, &z };
+			for ( size_t column = 0; column < 3; ++column )
+			{
+				frame[column] = columns[column]->x;
+				frame[4 + column] = columns[column]->y;
+				frame[8 + column] = columns[column]->z;
+			}
+			frame[3] = frame[7] = frame[11] = 0.0;
+		}
+
+		/** Sets @a transformation to the inverse of the rotation @a rotation.*/
+		void invertRotation( double* transformation, const double* rotation )
+		{
+			for ( size_t row = 0; row < 3; ++row )
+			{
+				for ( size_t column = 0; column < 3; ++column )
+					transformation[row * 4 + column] = rotation[column * 4 + row];
+				transformation[row * 4 + 3] = 0.0;
+			}
+		}
+
+		/** Multiplies the rotations of the transformations @a transformations of @a count poses by the
+		constant rotation @a rotation. The values of each transformation are @a stride apart.*/
+		void rotateTransformations( double* transformations, size_t stride, const double* rotation, size_t count )
+		{
+			const double m00 = rotation[0], m01 = rotation[1], m02 = rotation[2];
+			const double m10 = rotation[4], m11 = rotation[5], m12 = rotation[6];
+			const double m20 = rotation[8], m21 = rotation[9], m22 = rotation[10];
+
+			for ( size_t row = 0; row < 3; ++row )
+			{
+				double* r0 = transformations + ( row * 4 ) * stride;
+				double* r1 = r0 + stride;
+				double* r2 = r1 + stride;
+				for ( size_t i = 0; i < count; ++i )
+				{
+					const double a0 = r0[i];
+					const double a1 = r1[i];
+					const double a2 = r2[i];
+					r0[i] = a0 * m00 + a1 * m10 + a2 * m20;
+					r1[i] = a0 * m01 + a1 * m11 + a2 * m21;
+					r2[i] = a0 * m02 + a1 * m12 + a2 * m22;
+				}
+			}
+		}
+
+		/** Sets the transformations @a target of @a count poses to the ones of @a source multiplied by the
+		constant transformation @a transformation. The values of each transformation are @a targetStride and
+		@a sourceStride apart.*/
+		void multiplyTransformations( double* target, size_t targetStride, const double* source, size_t sourceStride, const double* transformation, size_t count )
+		{
+			const double m00 = transformation[0], m01 = transformation[1], m02 = transformation[2], m03 = transformation[3];
+			const double m10 = transformation[4], m11 = transformation[5], m12 = transformation[6], m13 = transformation[7];
+			const double m20 = transformation[8], m21 = transformation[9], m22 = transformation[10], m23 = transformation[11];
+
+			for ( size_t row = 0; row < 3; ++row )
+			{
+				const double* s0 = source + ( row * 4 ) * sourceStride;
+				const double* s1 = s0 + sourceStride;
+				const double* s2 = s1 + sourceStride;
+				const double* s3 = s2 + sourceStride;
+				double* t0 = target + ( row * 4 ) * targetStride;
+				double* t1 = t0 + targetStride;
+				double* t2 = t1 + targetStride;
+				double* t3 = t2 + targetStride;
+				for ( size_t i = 0; i < count; ++i )
+				{
+					const double a0 = s0[i];
+					const double a1 = s1[i];
+					const double a2 = s2[i];
+					t0[i] = a0 * m00 + a1 * m10 + a2 * m20;
+					t1[i] = a0 * m01 + a1 * m11 + a2 * m21;
+					t2[i] = a0 * m02 + a1 * m12 + a2 * m22;
+					t3[i] = a0 * m03 + a1 * m13 + a2 * m23 + s3[i];
+				}
+			}
+		}
+	}
+
+	//------------------------------
+	KinematicsEvaluator::KinematicsEvaluator()
+		: mClampToLimits(false)
+	{
+		setBaseTransformation( COLLADABU::Math::Matrix4::IDENTITY );
+	}
+
+	//------------------------------
+	KinematicsEvaluator::~KinematicsEvaluator()
+	{
+		clearCouplings();
+	}
+
+	//------------------------------
+	void KinematicsEvaluator::clearCouplings()
+	{
+		for ( size_t i = 0; i < mCouplings.size(); ++i )
+			delete mCouplings[i].expression;
+		mCouplings.clear();
+		mAxisCouplings.assign( mAxes.size(), 0 );
+		mCouplingInputAxes.assign( mAxes.size(), false );
+	}
+
+	//------------------------------
+	void KinematicsEvaluator::clear()
+	{
+		mLinks.clear();
+		mAxes.clear();
+		mJointFirstAxes.clear();
+		clearCouplings();
+	}
+
+	//------------------------------
+	bool KinematicsEvaluator::setKinematicsModel( const KinematicsModel& kinematicsModel )
+	{
+		clear();
+
+		const JointPointerArray& joints = kinematicsModel.getJoints();
+		for ( size_t i = 0, count = joints.getCount(); i < count; ++i )
+		{
+			mJointFirstAxes.push_back( mAxes.size() );
+
+			const JointPrimitivePointerArray& jointPrimitives = joints[i]->getJointPrimitives();
+			for ( size_t j = 0, primitivesCount = jointPrimitives.getCount(); j < primitivesCount; ++j )
+			{
+				const JointPrimitive* jointPrimitive = jointPrimitives[j];
+
+				Axis axis;
+				axis.type = jointPrimitive->getType();
+				setAxisFrame( axis.frame, jointPrimitive->getAxis() );
+				if ( j > 0 )
+				{
+					// relative to the frame of the previous primitive
+					double frame[TRANSFORMATION_SIZE];
+					double inverseFrame[TRANSFORMATION_SIZE];
+					setAxisFrame( frame, jointPrimitives[j - 1]->getAxis() );
+					invertRotation( inverseFrame, frame );
+					std::copy( axis.frame, axis.frame + TRANSFORMATION_SIZE, frame );
+					multiplyTransformations( axis.frame, inverseFrame, frame );
+				}
+				// unset limits are NaN
+				float limitMin = jointPrimitive->getHardLimitMin();
+				float limitMax = jointPrimitive->getHardLimitMax();
+				axis.limitMin = ( limitMin == limitMin ) ? limitMin : -std::numeric_limits<double>::infinity();
+				axis.limitMax = ( limitMax == limitMax ) ? limitMax : std::numeric_limits<double>::infinity();
+				mAxes.push_back( axis );
+			}
+		}
+		mJointFirstAxes.push_back( mAxes.size() );
+		mAxisCouplings.assign( mAxes.size(), 0 );
+		mCouplingInputAxes.assign( mAxes.size(), false );
+
+		std::map<size_t, size_t> linkIndices;
+
+		Link link;
+		link.firstAxis = 0;
+		link.axesCount = 0;
+		setTransformation( link.attachment, COLLADABU::Math::Matrix4::IDENTITY );
+		setTransformation( link.link, COLLADABU::Math::Matrix4::IDENTITY );
+
+		const SizeTValuesArray& baseLinks = kinematicsModel.getBaseLinks();
+		for ( size_t i = 0, count = baseLinks.getCount(); i < count; ++i )
+		{
+			if ( linkIndices.find( baseLinks[i] ) != linkIndices.end() )
+				continue;
+			link.linkNumber = baseLinks[i];
+			link.parentIndex = mLinks.size();
+			linkIndices[link.linkNumber] = mLinks.size();
+			mLinks.push_back( link );
+		}
+
+		// Each attachment adds the connection of the parent link to the joint, immediately followed by the
+		// connection of the new child link to the same joint, with the inverted transformations of the link.
+		const KinematicsModel::LinkJointConnections& connections = kinematicsModel.getLinkJointConnections();
+		for ( size_t i = 0, count = connections.getCount(); i + 1 < count; ++i )
+		{
+			const KinematicsModel::LinkJointConnection* parentConnection = connections[i];
+			const KinematicsModel::LinkJointConnection* childConnection = connections[i + 1];
+
+			std::map<size_t, size_t>::const_iterator parentIt = linkIndices.find( parentConnection->getLinkNumber() );
+			if ( parentIt == linkIndices.end()
+				|| childConnection->getJointIndex() != parentConnection->getJointIndex()
+				|| linkIndices.find( childConnection->getLinkNumber() ) != linkIndices.end() )
+				continue;
+
+			size_t jointIndex = parentConnection->getJointIndex();
+			if ( jointIndex >= joints.getCount() )
+			{
+				clear();
+				return false;
+			}
+
+			link.linkNumber = childConnection->getLinkNumber();
+			link.parentIndex = parentIt->second;
+			link.firstAxis = mJointFirstAxes[jointIndex];
+			link.axesCount = mJointFirstAxes[jointIndex + 1] - link.firstAxis;
+
+			double attachment[TRANSFORMATION_SIZE];
+			double linkTransformation[TRANSFORMATION_SIZE];
+			setTransformation( attachment, getTransformationMatrix( parentConnection->getTransformations() ) );
+			setTransformation( linkTransformation, getTransformationMatrix( childConnection->getTransformations() ).inverse() );
+
+			const JointPrimitivePointerArray& jointPrimitives = joints[jointIndex]->getJointPrimitives();
+			if ( link.axesCount == 0 )
+			{
+				multiplyTransformations( link.attachment, attachment, linkTransformation );
+				setTransformation( link.link, COLLADABU::Math::Matrix4::IDENTITY );
+			}
+			else
+			{
+				// merge the rotations into the frames of the first and the last primitive
+				double frame[TRANSFORMATION_SIZE];
+				double inverseFrame[TRANSFORMATION_SIZE];
+				multiplyTransformations( link.attachment, attachment, mAxes[link.firstAxis].frame );
+				setAxisFrame( frame, jointPrimitives[link.axesCount - 1]->getAxis() );
+				invertRotation( inverseFrame, frame );
+				multiplyTransformations( link.link, inverseFrame, linkTransformation );
+			}
+
+			linkIndices[link.linkNumber] = mLinks.size();
+			mLinks.push_back( link );
+			++i;
+		}
+		return true;
+	}
+
+	//------------------------------
+	void KinematicsEvaluator::setBaseTransformation( const COLLADABU::Math::Matrix4& baseTransformation )
+	{
+		setTransformation( mBaseTransformation, baseTransformation );
+	}
+
+	//------------------------------
+	bool KinematicsEvaluator::addCoupling( size_t axis,
+		const MathML::AST::INode* formula,
+		const MathML::StringVector& inputNames,
+		const std::vector<size_t>& inputAxes,
+		MathML::SymbolTable& symbolTable,
+		MathML::ErrorHandler* errorHandler )
+	{
+		if ( axis >= mAxes.size() || mAxisCouplings[axis] != 0 || mCouplingInputAxes[axis] || inputNames.size() != inputAxes.size() )
+			return false;
+		for ( size_t i = 0; i < inputAxes.size(); ++i )
+		{
+			if ( inputAxes[i] >= mAxes.size() || inputAxes[i] == axis )
+				return false;
+		}
+
+		MathML::CompiledExpression* expression = new MathML::CompiledExpression();
+		if ( !expression->compile( formula, inputNames, symbolTable, errorHandler ) )
+		{
+			delete expression;
+			return false;
+		}
+
+		Coupling coupling;
+		coupling.axis = axis;
+		coupling.inputAxes = inputAxes;
+		coupling.expression = expression;
+		mCouplings.push_back( coupling );
+
+		mAxisCouplings[axis] = mCouplings.size();
+		for ( size_t i = 0; i < inputAxes.size(); ++i )
+			mCouplingInputAxes[inputAxes[i]] = true;
+		return true;
+	}
+
+	//------------------------------
+	void KinematicsEvaluator::evaluate( const double* const* axisValues, size_t posesCount, double* transformations, size_t transformationsStride ) const
+	{
+		if ( posesCount == 0 || mLinks.empty() )
+			return;
+
+		const size_t axesCount = mAxes.size();
+
+		// the values of the driven axes and, if clamped, of all axes, followed by the joint transformations
+		// and the cosines and sines of the revolute axes
+		std::vector<double> buffer( ( axesCount + TRANSFORMATION_SIZE + 2 ) * BLOCK_SIZE );
+		double* values = buffer.empty() ? 0 : &buffer[0];
+		double* joint = values + axesCount * BLOCK_SIZE;
+		double* cosines = joint + TRANSFORMATION_SIZE * BLOCK_SIZE;
+		double* sines = cosines + BLOCK_SIZE;
+
+		std::vector<const double*> blockValues( axesCount );
+		std::vector<const double*> couplingInputs;
+
+		for ( size_t start = 0; start < posesCount; start += BLOCK_SIZE )
+		{
+			size_t count = posesCount - start;
+			if ( count > BLOCK_SIZE )
+				count = BLOCK_SIZE;
+
+			for ( size_t i = 0; i < axesCount; ++i )
+			{
+				if ( mAxisCouplings[i] != 0 )
+					continue;
+				if ( !mClampToLimits )
+				{
+					blockValues[i] = axisValues[i] + start;
+					continue;
+				}
+				const double* source = axisValues[i] + start;
+				double* clamped = values + i * BLOCK_SIZE;
+				const double limitMin = mAxes[i].limitMin;
+				const double limitMax = mAxes[i].limitMax;
+				for ( size_t j = 0; j < count; ++j )
+				{
+					double value = source[j];
+					value = value < limitMin ? limitMin : value;
+					clamped[j] = value > limitMax ? limitMax : value;
+				}
+				blockValues[i] = clamped;
+			}
+
+			for ( size_t c = 0; c < mCouplings.size(); ++c )
+			{
+				const Coupling& coupling = mCouplings[c];
+				couplingInputs.resize( coupling.inputAxes.size() );
+				for ( size_t i = 0; i < coupling.inputAxes.size(); ++i )
+					couplingInputs[i] = blockValues[coupling.inputAxes[i]];
+
+				double* driven = values + coupling.axis * BLOCK_SIZE;
+				coupling.expression->evaluate( couplingInputs.empty() ? 0 : &couplingInputs[0], count, driven );
+				if ( mClampToLimits )
+				{
+					const double limitMin = mAxes[coupling.axis].limitMin;
+					const double limitMax = mAxes[coupling.axis].limitMax;
+					for ( size_t j = 0; j < count; ++j )
+					{
+						double value = driven[j];
+						value = value < limitMin ? limitMin : value;
+						driven[j] = value > limitMax ? limitMax : value;
+					}
+				}
+				blockValues[coupling.axis] = driven;
+			}
+
+			for ( size_t l = 0; l < mLinks.size(); ++l )
+			{
+				const Link& link = mLinks[l];
+				double* target = transformations + l * TRANSFORMATION_SIZE * transformationsStride + start;
+
+				if ( link.parentIndex == l )
+				{
+					for ( size_t v = 0; v < TRANSFORMATION_SIZE; ++v )
+						std::fill( target + v * transformationsStride, target + v * transformationsStride + count, mBaseTransformation[v] );
+					continue;
+				}
+
+				const double* parent = transformations + link.parentIndex * TRANSFORMATION_SIZE * transformationsStride + start;
+				if ( link.axesCount == 0 )
+				{
+					multiplyTransformations( target, transformationsStride, parent, transformationsStride, link.attachment, count );
+					continue;
+				}
+
+				multiplyTransformations( joint, BLOCK_SIZE, parent, transformationsStride, link.attachment, count );
+
+				for ( size_t a = link.firstAxis; a < link.firstAxis + link.axesCount; ++a )
+				{
+					const Axis& axis = mAxes[a];
+					const double* axisValue = blockValues[a];
+
+					if ( a != link.firstAxis )
+						rotateTransformations( joint, BLOCK_SIZE, axis.frame, count );
+
+					if ( axis.type == JointPrimitive::PRISMATIC )
+					{
+						// translate along the z axis
+						for ( size_t row = 0; row < 3; ++row )
+						{
+							const double* z = joint + ( row * 4 + 2 ) * BLOCK_SIZE;
+							double* translation = joint + ( row * 4 + 3 ) * BLOCK_SIZE;
+							for ( size_t i = 0; i < count; ++i )
+								translation[i] += z[i] * axisValue[i];
+						}
+						continue;
+					}
+
+					// rotate about the z axis
+					cosinesSines( axisValue, cosines, sines, count );
+					for ( size_t row = 0; row < 3; ++row )
+					{
+						double* x = joint + ( row * 4 ) * BLOCK_SIZE;
+						double* y = x + BLOCK_SIZE;
+						for ( size_t i = 0; i < count; ++i )
+						{
+							const double a0 = x[i];
+							const double a1 = y[i];
+							x[i] = a0 * cosines[i] + a1 * sines[i];
+							y[i] = a1 * cosines[i] - a0 * sines[i];
+						}
+					}
+				}
+
+				multiplyTransformations( target, transformationsStride, joint, BLOCK_SIZE, link.link, count );
+			}
+		}
+	}
+
+} // namespace COLLADAFW
@@ -0,0 +1,654 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADAFramework.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADAFWStableHeaders.h"
+#include "COLLADAFWMeshDeduplicator.h"
+#include "COLLADAFWMesh.h"
+#include "COLLADAFWMeshPrimitiveWithFaceVertexCount.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+
+namespace COLLADAFW
+{
+
+	const double MeshDeduplicator::MIN_RIGID_RELATIVE_POSITION_TOLERANCE = 1e-5;
+	const double MeshDeduplicator::MIN_RIGID_VALUE_TOLERANCE = 1e-5;
+
+	namespace
+	{
+		/** The minimum squared distance of the vertex the first axis of a frame points to, relative to the
+		largest squared distance, and the same for the second axis.*/
+		const double FRAME_AXIS_DISTANCE_RATIO = 0.25;
+
+		/** The minimum distance from the first axis relative to the radius, to define a second axis.*/
+		const double MIN_RELATIVE_AXIS_DISTANCE = 1e-6;
+
+		/** The origin of the frame of directions.*/
+		const double NO_TRANSLATION[3] = { 0, 0, 0 };
+
+		/** The kinds of vertex data, hashed in front of the data to separate them.*/
+		enum VertexDataKind
+		{
+			VERTEX_DATA_POSITIONS,
+			VERTEX_DATA_DIRECTIONS,
+			VERTEX_DATA_VALUES
+		};
+
+		/** Computes a 128 bit hash of 64 bit words, with two multiply-rotate lanes. The words are appended to
+		a vector, to compare meshes with the same hash.*/
+		class MeshHasher
+		{
+		private:
+			unsigned long long mLow;
+			unsigned long long mHigh;
+			unsigned long long mCount;
+			std::vector<unsigned long long>& mWords;
+
+		public:
+			MeshHasher( std::vector<unsigned long long>& words ) : mLow(0x9e3779b97f4a7c15ULL), mHigh(0xc2b2ae3d27d4eb4fULL), mCount(0), mWords(words) {}
+
+			void add( unsigned long long value )
+			{
+				mWords.push_back( value );
+				mLow ^= rotate( value * 0x87c37b91114253d5ULL, 31 ) * 0x4cf5ad432745937fULL;
+				mLow = rotate( mLow, 27 ) * 5 + 0x52dce729;
+				mHigh ^= rotate( value * 0x4cf5ad432745937fULL, 33 ) * 0x87c37b91114253d5ULL;
+				mHigh = rotate( mHigh, 31 ) * 5 + 0x38495ab5;
+				++mCount;
+			}
+
+			void addDouble( double value )
+			{
+				unsigned long long bits;
+				memcpy( &bits, &value, sizeof(bits) );
+				add( bits );
+			}
+
+			std::pair<unsigned long long, unsigned long long> finish() const
+			{
+				unsigned long long low = mLow ^ mCount;
+				unsigned long long high = mHigh ^ mCount;
+				low += high;
+				high += low;
+				low = mix( low );
+				high = mix( high );
+				low += high;
+				high += low;
+				return std::make_pair( low, high );
+			}
+
+		private:
+			static unsigned long long rotate( unsigned long long value, int bits )
+			{
+				return (value << bits) | (value >> (64 - bits));
+			}
+
+			static unsigned long long mix( unsigned long long value )
+			{
+				value ^= value >> 33;
+				value *= 0xff51afd7ed558ccdULL;
+				value ^= value >> 33;
+				value *= 0xc4ceb9fe1a85ec53ULL;
+				value ^= value >> 33;
+				return value;
+			}
+		};
+
+		/** Hashes the bits of @a count values.*/
+		void hashBits( MeshHasher& hasher, const float* values, size_t count )
+		{
+			for ( size_t i = 0; i < count; ++i )
+			{
+				unsigned int bits;
+				memcpy( &bits, &values[i], sizeof(bits) );
+				hasher.add( bits );
+			}
+		}
+
+		/** Hashes the bits of @a count values.*/
+		void hashBits( MeshHasher& hasher, const double* values, size_t count )
+		{
+			for ( size_t i = 0; i < count; ++i )
+				hasher.addDouble( values[i] );
+		}
+
+		/** Appends @a count values with stride @a stride to @a transformedValues. If @a rotation is not null
+		and the stride is 3, the tuples are translated by -@a origin and rotated by @a rotation before.*/
+		template<class Type>
+		void appendValues( const Type* values,
+			size_t count,
+			size_t stride,
+			const double* rotation,
+			const double* origin,
+			std::vector<double>& transformedValues )
+		{
+			if ( !rotation || (stride != 3) )
+			{
+				transformedValues.insert( transformedValues.end(), values, values + count );
+				return;
+			}
+
+			size_t tuplesCount = count / 3;
+			for ( size_t i = 0; i < tuplesCount; ++i )
+			{
+				double x = (double)values[3 * i] - origin[0];
+				double y = (double)values[3 * i + 1] - origin[1];
+				double z = (double)values[3 * i + 2] - origin[2];
+				for ( size_t row = 0; row < 3; ++row )
+				{
+					const double* axis = rotation + 3 * row;
+					transformedValues.push_back( axis[0] * x + axis[1] * y + axis[2] * z );
+				}
+			}
+			transformedValues.insert( transformedValues.end(), values + 3 * tuplesCount, values + count );
+		}
+
+		/** Hashes the input infos of @a vertexData. If @a transformedValues is null, the bits of the values
+		are hashed, otherwise the values are appended to it, see appendValues().*/
+		void addVertexData( MeshHasher& hasher,
+			const MeshVertexData& vertexData,
+			VertexDataKind kind,
+			const double* rotation,
+			const double* origin,
+			std::vector<double>* transformedValues )
+		{
+			const FloatArray* floatValues = vertexData.getType() == FloatOrDoubleArray::DATA_TYPE_FLOAT ? vertexData.getFloatValues() : 0;
+			const DoubleArray* doubleValues = vertexData.getType() == FloatOrDoubleArray::DATA_TYPE_DOUBLE ? vertexData.getDoubleValues() : 0;
+			size_t valuesCount = floatValues ? floatValues->getCount() : doubleValues ? doubleValues->getCount() : 0;
+
+			hasher.add( kind );
+			hasher.add( valuesCount );
+			if ( valuesCount == 0 )
+				return;
+			if ( !transformedValues )
+				hasher.add( vertexData.getType() );
+
+			// without input infos, e.g. for the positions, all values are handled as one input, made of 
+			// 3-tuples unless they are colors or texture coordinates
+			const MeshVertexData::InputInfosArray& inputInfos = vertexData.getInputInfosArray();
+			size_t inputInfosCount = inputInfos.getCount();
+			size_t offset = 0;
+			for ( size_t i = 0; i <= inputInfosCount && offset < valuesCount; ++i )
+			{
+				size_t stride = kind == VERTEX_DATA_VALUES ? 1 : 3;
+				size_t length = valuesCount - offset;
+				if ( i < inputInfosCount )
+				{
+					stride = inputInfos[i]->mStride;
+					length = std::min( inputInfos[i]->mLength, valuesCount - offset );
+				}
+				hasher.add( stride );
+				hasher.add( length );
+
+				if ( !transformedValues )
+				{
+					if ( floatValues )
+						hashBits( hasher, floatValues->getData() + offset, length );
+					else
+						hashBits( hasher, doubleValues->getData() + offset, length );
+				}
+				else
+				{
+					if ( floatValues )
+						appendValues( floatValues->getData() + offset, length, stride, rotation, origin, *transformedValues );
+					else
+						appendValues( doubleValues->getData() + offset, length, stride, rotation, origin, *transformedValues );
+				}
+				offset += length;
+			}
+		}
+
+		/** Hashes the values of @a values.*/
+		template<class Type>
+		void hashArray( MeshHasher& hasher, const ArrayPrimitiveType<Type>& values )
+		{
+			size_t count = values.getCount();
+			hasher.add( count );
+			const Type* data = values.getData();
+			for ( size_t i = 0; i < count; ++i )
+				hasher.add( (unsigned int)data[i] );
+		}
+
+		/** Hashes the index lists of @a indexLists.*/
+		void hashIndexLists( MeshHasher& hasher, const IndexListArray& indexLists )
+		{
+			size_t count = indexLists.getCount();
+			hasher.add( count );
+			for ( size_t i = 0; i < count; ++i )
+			{
+				const IndexList* indexList = indexLists[i];
+				hasher.add( indexList->getStride() );
+				hasher.add( indexList->getSetIndex() );
+				hasher.add( indexList->getInitialIndex() );
+				hashArray( hasher, indexList->getIndices() );
+			}
+		}
+
+		/** Returns the face vertex counts of @a meshPrimitive, null if it has none.*/
+		const IntValuesArray* getIntFaceVertexCounts( const MeshPrimitive& meshPrimitive )
+		{
+			switch ( meshPrimitive.getPrimitiveType() )
+			{
+			case MeshPrimitive::POLYGONS:
+			case MeshPrimitive::POLYLIST:
+				return &((const MeshPrimitiveWithFaceVertexCount<int>&)meshPrimitive).getGroupedVerticesVertexCountArray();
+			default:
+				return 0;
+			}
+		}
+
+		/** Returns the face vertex counts of @a meshPrimitive, null if it has none.*/
+		const UIntValuesArray* getUIntFaceVertexCounts( const MeshPrimitive& meshPrimitive )
+		{
+			switch ( meshPrimitive.getPrimitiveType() )
+			{
+			case MeshPrimitive::TRIANGLE_FANS:
+			case MeshPrimitive::TRIANGLE_STRIPS:
+			case MeshPrimitive::LINE_STRIPS:
+				return &((const MeshPrimitiveWithFaceVertexCount<unsigned int>&)meshPrimitive).getGroupedVerticesVertexCountArray();
+			default:
+				return 0;
+			}
+		}
+
+		/** Hashes the type, the face count, the material id and all indices of @a meshPrimitive.*/
+		void hashMeshPrimitive( MeshHasher& hasher, const MeshPrimitive& meshPrimitive )
+		{
+			hasher.add( meshPrimitive.getPrimitiveType() );
+			hasher.add( meshPrimitive.getFaceCount() );
+			hasher.add( meshPrimitive.getMaterialId() );
+			hashArray( hasher, meshPrimitive.getPositionIndices() );
+			hashArray( hasher, meshPrimitive.getNormalIndices() );
+			hashArray( hasher, meshPrimitive.getTangentIndices() );
+			hashArray( hasher, meshPrimitive.getBinormalIndices() );
+			hashIndexLists( hasher, meshPrimitive.getColorIndicesArray() );
+			hashIndexLists( hasher, meshPrimitive.getUVCoordIndicesArray() );
+
+			if ( const IntValuesArray* faceVertexCounts = getIntFaceVertexCounts( meshPrimitive ) )
+				hashArray( hasher, *faceVertexCounts );
+			else if ( const UIntValuesArray* faceVertexCounts = getUIntFaceVertexCounts( meshPrimitive ) )
+				hashArray( hasher, *faceVertexCounts );
+		}
+
+		/** Returns the number of bytes of the values of @a vertexData.*/
+		size_t getVertexDataSize( const MeshVertexData& vertexData )
+		{
+			switch ( vertexData.getType() )
+			{
+			case FloatOrDoubleArray::DATA_TYPE_FLOAT:
+				return vertexData.getFloatValues()->getCount() * sizeof(float);
+			case FloatOrDoubleArray::DATA_TYPE_DOUBLE:
+				return vertexData.getDoubleValues()->getCount() * sizeof(double);
+			default:
+				return 0;
+			}
+		}
+
+		/** Returns the number of bytes of the indices of @a indexLists.*/
+		size_t getIndexListsSize( const IndexListArray& indexLists )
+		{
+			size_t size = 0;
+			for ( size_t i = 0, count = indexLists.getCount(); i < count; ++i )
+				size += indexLists[i]->getIndicesCount() * sizeof(unsigned int);
+			return size;
+		}
+
+		/** Appends the values of @a values to @a positions.*/
+		template<class Type>
+		void appendPositions( const ArrayPrimitiveType<Type>& values, std::vector<double>& positions )
+		{
+			positions.insert( positions.end(), values.getData(), values.getData() + values.getCount() );
+		}
+
+		/** Normalizes @a vector, which must not be the zero vector.*/
+		void normalize( double* vector )
+		{
+			double length = sqrt( vector[0] * vector[0] + vector[1] * vector[1] + vector[2] * vector[2] );
+			vector[0] /= length;
+			vector[1] /= length;
+			vector[2] /= length;
+		}
+	}
+
+    //------------------------------
+	MeshDeduplicator::MeshDeduplicator()
+		: mPositionTolerance(0)
+		, mValueTolerance(0)
+		, mRigidMatching(false)
+		, mRadius(0)
+		, mMeshPositionTolerance(0)
+		, mMeshValueTolerance(0)
+		, mPositionValuesCount(0)
+	{
+	}
+
+    //------------------------------
+	MeshDeduplicator::~MeshDeduplicator()
+	{
+	}
+
+	//------------------------------
+	bool MeshDeduplicator::addMesh( const Mesh& mesh )
+	{
+		++mStatistics.meshesCount;
+
+		computeFrame( mesh );
+		const double* rotation = mRigidMatching ? mRotation : 0;
+		std::vector<double>* values = 0;
+		mValues.clear();
+		if ( compareValues() )
+			values = &mValues;
+
+		mWords.clear();
+		MeshHasher hasher( mWords );
+		addVertexData( hasher, mesh.getPositions(), VERTEX_DATA_POSITIONS, rotation, mOrigin, values );
+		mPositionValuesCount = mValues.size();
+		addVertexData( hasher, mesh.getNormals(), VERTEX_DATA_DIRECTIONS, rotation, NO_TRANSLATION, values );
+		addVertexData( hasher, mesh.getTangents(), VERTEX_DATA_DIRECTIONS, rotation, NO_TRANSLATION, values );
+		addVertexData( hasher, mesh.getBinormals(), VERTEX_DATA_DIRECTIONS, rotation, NO_TRANSLATION, values );
+		addVertexData( hasher, mesh.getColors(), VERTEX_DATA_VALUES, 0, 0, values );
+		addVertexData( hasher, mesh.getUVCoords(), VERTEX_DATA_VALUES, 0, 0, values );
+
+		const MeshPrimitiveArray& meshPrimitives = mesh.getMeshPrimitives();
+		hasher.add( meshPrimitives.getCount() );
+		for ( size_t i = 0, count = meshPrimitives.getCount(); i < count; ++i )
+			hashMeshPrimitive( hasher, *meshPrimitives[i] );
+
+		std::vector<size_t>& originalIndices = mMeshHashOriginals[hasher.finish()];
+		const Original* original = 0;
+		for ( size_t i = 0, count = originalIndices.size(); (i < count) && !original; ++i )
+		{
+			const Original& candidate = mOriginals[originalIndices[i]];
+			if ( isEqual( candidate ) )
+				original = &candidate;
+		}
+
+		if ( !original )
+		{
+			originalIndices.push_back( mOriginals.size() );
+			mOriginals.push_back( Original() );
+			Original& added = mOriginals.back();
+			added.uniqueId = mesh.getUniqueId();
+			memcpy( added.rotation, mRotation, sizeof(mRotation) );
+			memcpy( added.origin, mOrigin, sizeof(mOrigin) );
+			added.radius = mRadius;
+			added.positionTolerance = mMeshPositionTolerance;
+			added.values = mValues;
+			added.words.swap( mWords );
+			return false;
+		}
+
+		if ( original->uniqueId == mesh.getUniqueId() )
+			return false;
+
+		Duplicate& duplicate = mDuplicates[mesh.getUniqueId()];
+		duplicate.originalId = original->uniqueId;
+		if ( mRigidMatching )
+		{
+			COLLADABU::Math::Matrix4 transformation = getTransformation( *original );
+			if ( isTransformed( transformation, *original ) )
+			{
+				duplicate.transformation = transformation;
+				duplicate.transformed = true;
+				++mStatistics.transformedDuplicatesCount;
+			}
+		}
+
+		++mStatistics.duplicatesCount;
+		mStatistics.savedBytes += getMeshSize( mesh );
+		return true;
+	}
+
+	//------------------------------
+	const MeshDeduplicator::Duplicate* MeshDeduplicator::findDuplicate( const UniqueId& uniqueId ) const
+	{
+		UniqueIdDuplicateMap::const_iterator it = mDuplicates.find( uniqueId );
+		return it == mDuplicates.end() ? 0 : &it->second;
+	}
+
+	//------------------------------
+	void MeshDeduplicator::clear()
+	{
+		mOriginals.clear();
+		mMeshHashOriginals.clear();
+		mDuplicates.clear();
+		mStatistics = Statistics();
+	}
+
+	//------------------------------
+	size_t MeshDeduplicator::getMeshSize( const Mesh& mesh )
+	{
+		size_t size = getVertexDataSize( mesh.getPositions() )
+			+ getVertexDataSize( mesh.getNormals() )
+			+ getVertexDataSize( mesh.getColors() )
+			+ getVertexDataSize( mesh.getUVCoords() )
+			+ getVertexDataSize( mesh.getTangents() )
+			+ getVertexDataSize( mesh.getBinormals() );
+
+		const MeshPrimitiveArray& meshPrimitives = mesh.getMeshPrimitives();
+		for ( size_t i = 0, count = meshPrimitives.getCount(); i < count; ++i )
+		{
+			const MeshPrimitive& meshPrimitive = *meshPrimitives[i];
+			size += (meshPrimitive.getPositionIndices().getCount()
+				+ meshPrimitive.getNormalIndices().getCount()
+				+ meshPrimitive.getTangentIndices().getCount()
+				+ meshPrimitive.getBinormalIndices().getCount()) * sizeof(unsigned int);
+			size += getIndexListsSize( meshPrimitive.getColorIndicesArray() );
+			size += getIndexListsSize( meshPrimitive.getUVCoordIndicesArray() );
+
+			if ( const IntValuesArray* faceVertexCounts = getIntFaceVertexCounts( meshPrimitive ) )
+				size += faceVertexCounts->getCount() * sizeof(int);
+			else if ( const UIntValuesArray* faceVertexCounts = getUIntFaceVertexCounts( meshPrimitive ) )
+				size += faceVertexCounts->getCount() * sizeof(unsigned int);
+		}
+		return size;
+	}
+
+	//------------------------------
+	void MeshDeduplicator::computeFrame( const Mesh& mesh )
+	{
+		static const double IDENTITY[9] = { 1, 0, 0, 0, 1, 0, 0, 0, 1 };
+		memcpy( mRotation, IDENTITY, sizeof(mRotation) );
+		mOrigin[0] = mOrigin[1] = mOrigin[2] = 0;
+		mRadius = 0;
+		mMeshPositionTolerance = mPositionTolerance;
+		mMeshValueTolerance = mValueTolerance;
+		if ( !mRigidMatching )
+			return;
+
+		mMeshValueTolerance = std::max( mValueTolerance, MIN_RIGID_VALUE_TOLERANCE );
+
+		// the frame is only defined for positions with stride 3
+		const MeshVertexData& positions = mesh.getPositions();
+		const MeshVertexData::InputInfosArray& inputInfos = positions.getInputInfosArray();
+		for ( size_t i = 0, count = inputInfos.getCount(); i < count; ++i )
+		{
+			if ( inputInfos[i]->mStride != 3 )
+				return;
+		}
+
+		mPositions.clear();
+		if ( positions.getType() == FloatOrDoubleArray::DATA_TYPE_FLOAT )
+			appendPositions( *positions.getFloatValues(), mPositions );
+		else if ( positions.getType() == FloatOrDoubleArray::DATA_TYPE_DOUBLE )
+			appendPositions( *positions.getDoubleValues(), mPositions );
+		size_t positionsCount = mPositions.size() / 3;
+		if ( positionsCount == 0 )
+			return;
+
+		const double* values = &mPositions.front();
+		double origin[3] = { 0, 0, 0 };
+		for ( size_t i = 0; i < positionsCount; ++i )
+		{
+			origin[0] += values[3 * i];
+			origin[1] += values[3 * i + 1];
+			origin[2] += values[3 * i + 2];
+		}
+		for ( size_t j = 0; j < 3; ++j )
+			mOrigin[j] = origin[j] / (double)positionsCount;
+
+		double maxDistance2 = 0;
+		for ( size_t i = 0; i < positionsCount; ++i )
+		{
+			double x = values[3 * i] - mOrigin[0];
+			double y = values[3 * i + 1] - mOrigin[1];
+			double z = values[3 * i + 2] - mOrigin[2];
+			maxDistance2 = std::max( maxDistance2, x * x + y * y + z * z );
+		}
+		mRadius = sqrt( maxDistance2 );
+
+		double maxCoordinate = 0;
+		for ( size_t i = 0, count = mPositions.size(); i < count; ++i )
+			maxCoordinate = std::max( maxCoordinate, fabs( values[i] ) );
+		mMeshPositionTolerance = std::max( mPositionTolerance, MIN_RIGID_RELATIVE_POSITION_TOLERANCE * maxCoordinate );
+		if ( mRadius == 0 )
+			return;
+
+		// the first axis points to the first vertex far enough from the origin
+		double xAxis[3] = { 0, 0, 0 };
+		for ( size_t i = 0; i < positionsCount; ++i )
+		{
+			double x = values[3 * i] - mOrigin[0];
+			double y = values[3 * i + 1] - mOrigin[1];
+			double z = values[3 * i + 2] - mOrigin[2];
+			if ( x * x + y * y + z * z >= FRAME_AXIS_DISTANCE_RATIO * maxDistance2 )
+			{
+				xAxis[0] = x;
+				xAxis[1] = y;
+				xAxis[2] = z;
+				break;
+			}
+		}
+		normalize( xAxis );
+
+		// the second axis points to the first vertex far enough from the first axis
+		double maxAxisDistance2 = 0;
+		for ( size_t i = 0; i < positionsCount; ++i )
+		{
+			double x = values[3 * i] - mOrigin[0];
+			double y = values[3 * i + 1] - mOrigin[1];
+			double z = values[3 * i + 2] - mOrigin[2];
+			double projection = x * xAxis[0] + y * xAxis[1] + z * xAxis[2];
+			x -= projection * xAxis[0];
+			y -= projection * xAxis[1];
+			z -= projection * xAxis[2];
+			maxAxisDistance2 = std::max( maxAxisDistance2, x * x + y * y + z * z );
+		}
+
+		// the rotation of collinear positions around their line is not defined, only the origin is used
+		double minAxisDistance = MIN_RELATIVE_AXIS_DISTANCE * mRadius;
+		if ( maxAxisDistance2 <= minAxisDistance * minAxisDistance )
+			return;
+
+		double yAxis[3] = { 0, 0, 0 };
+		for ( size_t i = 0; i < positionsCount; ++i )
+		{
+			double x = values[3 * i] - mOrigin[0];
+			double y = values[3 * i + 1] - mOrigin[1];
+			double z = values[3 * i + 2] - mOrigin[2];
+			double projection = x * xAxis[0] + y * xAxis[1] + z * xAxis[2];
+			x -= projection * xAxis[0];
+			y -= projection * xAxis[1];
+			z -= projection * xAxis[2];
+			if ( x * x + y * y + z * z >= FRAME_AXIS_DISTANCE_RATIO * maxAxisDistance2 )
+			{
+				yAxis[0] = x;
+				yAxis[1] = y;
+				yAxis[2] = z;
+				break;
+			}
+		}
+		normalize( yAxis );
+
+		mRotation[0] = xAxis[0];
+		mRotation[1] = xAxis[1];
+		mRotation[2] = xAxis[2];
+		mRotation[3] = yAxis[0];
+		mRotation[4] = yAxis[1];
+		mRotation[5] = yAxis[2];
+		mRotation[6] = xAxis[1] * yAxis[2] - xAxis[2] * yAxis[1];
+		mRotation[7] = xAxis[2] * yAxis[0] - xAxis[0] * yAxis[2];
+		mRotation[8] = xAxis[0] * yAxis[1] - xAxis[1] * yAxis[0];
+	}
+
+	//------------------------------
+	COLLADABU::Math::Matrix4 MeshDeduplicator::getTransformation( const Original& original ) const
+	{
+		// frame coordinates are q = R (p - o), i.e. p = R^T q + o. The transformation maps the positions of
+		// the original to those of the current mesh: R^T R_original (p_original - o_original) + o
+		COLLADABU::Math::Matrix4 transformation = COLLADABU::Math::Matrix4::IDENTITY;
+		for ( int row = 0; row < 3; ++row )
+		{
+			double translation = mOrigin[row];
+			for ( int column = 0; column < 3; ++column )
+			{
+				double value = 0;
+				for ( int k = 0; k < 3; ++k )
+					value += mRotation[3 * k + row] * original.rotation[3 * k + column];
+				transformation.setElement( row, column, value );
+				translation -= value * original.origin[column];
+			}
+			transformation.setElement( row, 3, translation );
+		}
+		return transformation;
+	}
+
+	//------------------------------
+	bool MeshDeduplicator::isEqual( const Original& original ) const
+	{
+		if ( original.words != mWords )
+			return false;
+
+		size_t valuesCount = mValues.size();
+		if ( original.values.size() != valuesCount )
+			return false;
+		if ( valuesCount == 0 )
+			return true;
+
+		const double* values = &mValues.front();
+		const double* originalValues = &original.values.front();
+		double positionTolerance = std::max( mMeshPositionTolerance, original.positionTolerance );
+		for ( size_t i = 0; i < mPositionValuesCount; ++i )
+		{
+			if ( fabs( values[i] - originalValues[i] ) > positionTolerance )
+				return false;
+		}
+		for ( size_t i = mPositionValuesCount; i < valuesCount; ++i )
+		{
+			if ( fabs( values[i] - originalValues[i] ) > mMeshValueTolerance )
+				return false;
+		}
+		return true;
+	}
+
+	//------------------------------
+	bool MeshDeduplicator::isTransformed( const COLLADABU::Math::Matrix4& transformation, const Original& original ) const
+	{
+		// a position of the original moves by the movement of its origin plus at most the rotation deviation
+		// times its distance from the origin
+		double originDistance2 = 0;
+		double rotationDeviation2 = 0;
+		for ( int row = 0; row < 3; ++row )
+		{
+			double originDistance = mOrigin[row] - original.origin[row];
+			originDistance2 += originDistance * originDistance;
+			for ( int column = 0; column < 3; ++column )
+			{
+				double deviation = transformation.getElement( row, column ) - (row == column ? 1 : 0);
+				rotationDeviation2 += deviation * deviation;
+			}
+		}
+		return sqrt( originDistance2 ) + sqrt( rotationDeviation2 ) * original.radius > mMeshPositionTolerance;
+	}
+
+} // namespace COLLADAFW
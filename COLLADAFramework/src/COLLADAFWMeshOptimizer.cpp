@@ -0,0 +1,489 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADAFramework.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADAFWStableHeaders.h"
+#include "COLLADAFWMeshOptimizer.h"
+#include "COLLADAFWMesh.h"
+#include "COLLADAFWTriangles.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+
+namespace COLLADAFW
+{
+
+	namespace
+	{
+		/** The size of the cache assumed by the scoring of optimizeVertexCache().*/
+		const int FORSYTH_CACHE_SIZE = 32;
+
+		/** The parameters of the vertex scores, as proposed by Tom Forsyth.*/
+		const float CACHE_DECAY_POWER = 1.5f;
+		const float LAST_TRIANGLE_SCORE = 0.75f;
+		const float VALENCE_BOOST_SCALE = 2.0f;
+		const float VALENCE_BOOST_POWER = 0.5f;
+
+		/** Sorts clusters by descending key.*/
+		class ClusterKeyGreater
+		{
+		private:
+			const std::vector<float>& mKeys;
+
+		public:
+			ClusterKeyGreater( const std::vector<float>& keys ) : mKeys(keys) {}
+
+			bool operator()( unsigned int cluster1, unsigned int cluster2 ) const { return mKeys[cluster1] > mKeys[cluster2]; }
+
+		private:
+			/** Disable default assignment operator. */
+			const ClusterKeyGreater& operator= ( const ClusterKeyGreater& pre );
+		};
+	}
+
+	const float MeshOptimizer::DEFAULT_OVERDRAW_THRESHOLD = 1.05f;
+
+	//------------------------------
+	void MeshOptimizer::VertexCacheStatistics::add( const VertexCacheStatistics& statistics )
+	{
+		trianglesCount += statistics.trianglesCount;
+		verticesCount += statistics.verticesCount;
+		transformedVerticesCount += statistics.transformedVerticesCount;
+	}
+
+	//------------------------------
+	MeshOptimizer::MeshOptimizer()
+	{
+	}
+
+	//------------------------------
+	MeshOptimizer::~MeshOptimizer()
+	{
+	}
+
+	//------------------------------
+	void MeshOptimizer::optimizeVertexCache( unsigned int* indices, size_t indicesCount, size_t verticesCount )
+	{
+		size_t trianglesCount = indicesCount / 3;
+		mTriangleOrder.clear();
+		if ( trianglesCount == 0 )
+			return;
+
+		mSourceIndices.assign( indices, indices + 3 * trianglesCount );
+		const unsigned int* sourceIndices = &mSourceIndices[0];
+		buildAdjacency( sourceIndices, trianglesCount, verticesCount );
+
+		mCachePositions.assign( verticesCount, -1 );
+		mVertexScores.resize( verticesCount );
+		for ( size_t i = 0; i < verticesCount; ++i )
+			mVertexScores[i] = getVertexScore( (unsigned int)i );
+
+		mTriangleScores.resize( trianglesCount );
+		unsigned int bestTriangle = 0;
+		for ( size_t i = 0; i < trianglesCount; ++i )
+		{
+			const unsigned int* triangle = sourceIndices + 3 * i;
+			mTriangleScores[i] = mVertexScores[triangle[0]] + mVertexScores[triangle[1]] + mVertexScores[triangle[2]];
+			if ( mTriangleScores[i] > mTriangleScores[bestTriangle] )
+				bestTriangle = (unsigned int)i;
+		}
+
+		// the cache holds the vertices of the last emitted triangle in front of the old cache entries
+		unsigned int cache[FORSYTH_CACHE_SIZE + 3];
+		unsigned int newCache[FORSYTH_CACHE_SIZE + 3];
+		int cacheCount = 0;
+		size_t nextTriangle = 0;
+		mTriangleOrder.reserve( trianglesCount );
+
+		for ( size_t emitted = 0; emitted < trianglesCount; ++emitted )
+		{
+			if ( bestTriangle == UINT_MAX )
+			{
+				// no triangle uses a cached vertex, continue with the next remaining triangle
+				while ( mTriangleScores[nextTriangle] < 0 )
+					++nextTriangle;
+				bestTriangle = (unsigned int)nextTriangle;
+			}
+
+			mTriangleOrder.push_back( bestTriangle );
+			mTriangleScores[bestTriangle] = -1;
+			const unsigned int* triangle = sourceIndices + 3 * bestTriangle;
+
+			int newCacheCount = 0;
+			for ( int i = 0; i < 3; ++i )
+			{
+				unsigned int vertex = triangle[i];
+
+				// remove the triangle from the live triangles of the vertex
+				unsigned int* vertexTriangles = &mVertexTriangles[mVertexTrianglesOffsets[vertex]];
+				unsigned int& liveTrianglesCount = mLiveTrianglesCounts[vertex];
+				for ( unsigned int j = 0; j < liveTrianglesCount; ++j )
+				{
+					if ( vertexTriangles[j] == bestTriangle )
+					{
+						std::swap( vertexTriangles[j], vertexTriangles[liveTrianglesCount - 1] );
+						--liveTrianglesCount;
+						break;
+					}
+				}
+
+				if ( std::find( newCache, newCache + newCacheCount, vertex ) == newCache + newCacheCount )
+					newCache[newCacheCount++] = vertex;
+			}
+			for ( int i = 0; i < cacheCount; ++i )
+			{
+				unsigned int vertex = cache[i];
+				if ( (vertex != triangle[0]) && (vertex != triangle[1]) && (vertex != triangle[2]) )
+					newCache[newCacheCount++] = vertex;
+			}
+
+			// vertices beyond the cache size are evicted, but their scores have to be updated as well
+			for ( int i = 0; i < newCacheCount; ++i )
+			{
+				unsigned int vertex = newCache[i];
+				mCachePositions[vertex] = i < FORSYTH_CACHE_SIZE ? i : -1;
+				mVertexScores[vertex] = getVertexScore( vertex );
+			}
+
+			bestTriangle = UINT_MAX;
+			float bestScore = -1;
+			for ( int i = 0; i < newCacheCount; ++i )
+			{
+				unsigned int vertex = newCache[i];
+				const unsigned int* vertexTriangles = &mVertexTriangles[mVertexTrianglesOffsets[vertex]];
+				for ( unsigned int j = 0, count = mLiveTrianglesCounts[vertex]; j < count; ++j )
+				{
+					unsigned int liveTriangle = vertexTriangles[j];
+					const unsigned int* corners = sourceIndices + 3 * liveTriangle;
+					float score = mVertexScores[corners[0]] + mVertexScores[corners[1]] + mVertexScores[corners[2]];
+					mTriangleScores[liveTriangle] = score;
+					if ( score > bestScore )
+					{
+						bestScore = score;
+						bestTriangle = liveTriangle;
+					}
+				}
+			}
+
+			cacheCount = std::min( newCacheCount, FORSYTH_CACHE_SIZE );
+			std::copy( newCache, newCache + cacheCount, cache );
+		}
+
+		writeTriangles( indices );
+	}
+
+	//------------------------------
+	void MeshOptimizer::buildAdjacency( const unsigned int* indices, size_t trianglesCount, size_t verticesCount )
+	{
+		size_t indicesCount = 3 * trianglesCount;
+		mLiveTrianglesCounts.assign( verticesCount, 0 );
+		for ( size_t i = 0; i < indicesCount; ++i )
+			++mLiveTrianglesCounts[indices[i]];
+
+		mVertexTrianglesOffsets.resize( verticesCount + 1 );
+		unsigned int offset = 0;
+		for ( size_t i = 0; i < verticesCount; ++i )
+		{
+			mVertexTrianglesOffsets[i] = offset;
+			offset += mLiveTrianglesCounts[i];
+		}
+		mVertexTrianglesOffsets[verticesCount] = offset;
+
+		// the counts are restored while filling the triangles
+		mVertexTriangles.resize( indicesCount );
+		std::fill( mLiveTrianglesCounts.begin(), mLiveTrianglesCounts.end(), 0 );
+		for ( size_t i = 0; i < indicesCount; ++i )
+		{
+			unsigned int vertex = indices[i];
+			mVertexTriangles[mVertexTrianglesOffsets[vertex] + mLiveTrianglesCounts[vertex]++] = (unsigned int)(i / 3);
+		}
+	}
+
+	//------------------------------
+	float MeshOptimizer::getVertexScore( unsigned int vertex ) const
+	{
+		unsigned int liveTrianglesCount = mLiveTrianglesCounts[vertex];
+		if ( liveTrianglesCount == 0 )
+			return -1.0f;
+
+		float score = 0.0f;
+		int cachePosition = mCachePositions[vertex];
+		if ( cachePosition >= 0 )
+		{
+			// the vertices of the last triangle get a fixed score, to avoid using the same edge twice in a row
+			if ( cachePosition < 3 )
+			{
+				score = LAST_TRIANGLE_SCORE;
+			}
+			else
+			{
+				float scaler = 1.0f / (FORSYTH_CACHE_SIZE - 3);
+				score = std::pow( 1.0f - (cachePosition - 3) * scaler, CACHE_DECAY_POWER );
+			}
+		}
+
+		// boost vertices with few remaining triangles, to finish them off and avoid isolated triangles
+		score += VALENCE_BOOST_SCALE * std::pow( (float)liveTrianglesCount, -VALENCE_BOOST_POWER );
+		return score;
+	}
+
+	//------------------------------
+	void MeshOptimizer::writeTriangles( unsigned int* indices ) const
+	{
+		for ( size_t i = 0, count = mTriangleOrder.size(); i < count; ++i )
+		{
+			const unsigned int* triangle = &mSourceIndices[3 * mTriangleOrder[i]];
+			indices[3 * i] = triangle[0];
+			indices[3 * i + 1] = triangle[1];
+			indices[3 * i + 2] = triangle[2];
+		}
+	}
+
+	//------------------------------
+	void MeshOptimizer::optimizeOverdraw( unsigned int* indices, size_t indicesCount, const float* positions, size_t positionsStride, size_t verticesCount, float threshold )
+	{
+		size_t trianglesCount = indicesCount / 3;
+		mTriangleOrder.clear();
+		if ( trianglesCount == 0 )
+			return;
+
+		buildClusters( indices, trianglesCount, verticesCount, DEFAULT_CACHE_SIZE, threshold );
+
+		// the clusters are sorted by how much they face away from the center of the mesh, such that clusters
+		// on the outside, which are likely to occlude others, are drawn first
+		double meshCenter[3] = { 0, 0, 0 };
+		for ( size_t i = 0; i < verticesCount; ++i )
+		{
+			const float* position = positions + i * positionsStride;
+			meshCenter[0] += position[0];
+			meshCenter[1] += position[1];
+			meshCenter[2] += position[2];
+		}
+		if ( verticesCount > 0 )
+		{
+			meshCenter[0] /= verticesCount;
+			meshCenter[1] /= verticesCount;
+			meshCenter[2] /= verticesCount;
+		}
+
+		size_t clustersCount = mClusters.size() / 2;
+		mClusterKeys.resize( clustersCount );
+		for ( size_t i = 0; i < clustersCount; ++i )
+		{
+			double center[3] = { 0, 0, 0 };
+			double normal[3] = { 0, 0, 0 };
+			double area = 0;
+			for ( unsigned int t = mClusters[2 * i], end = t + mClusters[2 * i + 1]; t < end; ++t )
+			{
+				const float* p0 = positions + indices[3 * t] * positionsStride;
+				const float* p1 = positions + indices[3 * t + 1] * positionsStride;
+				const float* p2 = positions + indices[3 * t + 2] * positionsStride;
+				double u[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+				double v[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+				double n[3] = { u[1] * v[2] - u[2] * v[1], u[2] * v[0] - u[0] * v[2], u[0] * v[1] - u[1] * v[0] };
+				double triangleArea = std::sqrt( n[0] * n[0] + n[1] * n[1] + n[2] * n[2] );
+				for ( int k = 0; k < 3; ++k )
+				{
+					center[k] += (p0[k] + p1[k] + p2[k]) * triangleArea / 3.0;
+					normal[k] += n[k];
+				}
+				area += triangleArea;
+			}
+
+			double normalLength = std::sqrt( normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2] );
+			if ( (area <= 0) || (normalLength <= 0) )
+			{
+				mClusterKeys[i] = 0;
+				continue;
+			}
+			double key = 0;
+			for ( int k = 0; k < 3; ++k )
+				key += (center[k] / area - meshCenter[k]) * normal[k] / normalLength;
+			mClusterKeys[i] = (float)key;
+		}
+
+		mTemporaryOrder.resize( clustersCount );
+		for ( size_t i = 0; i < clustersCount; ++i )
+			mTemporaryOrder[i] = (unsigned int)i;
+		std::stable_sort( mTemporaryOrder.begin(), mTemporaryOrder.end(), ClusterKeyGreater( mClusterKeys ) );
+
+		mTriangleOrder.reserve( trianglesCount );
+		for ( size_t i = 0; i < clustersCount; ++i )
+		{
+			unsigned int cluster = mTemporaryOrder[i];
+			for ( unsigned int t = mClusters[2 * cluster], end = t + mClusters[2 * cluster + 1]; t < end; ++t )
+				mTriangleOrder.push_back( t );
+		}
+
+		mSourceIndices.assign( indices, indices + 3 * trianglesCount );
+		writeTriangles( indices );
+	}
+
+	//------------------------------
+	void MeshOptimizer::buildClusters( const unsigned int* indices, size_t trianglesCount, size_t verticesCount, size_t cacheSize, float threshold )
+	{
+		// hard boundaries are the triangles that miss the cache with all vertices, i.e. where the vertex cache
+		// optimization started a new region
+		mTemporaryOrder.clear();
+		mCacheTimeStamps.assign( verticesCount, 0 );
+		unsigned int timeStamp = (unsigned int)cacheSize + 1;
+		for ( size_t i = 0; i < trianglesCount; ++i )
+		{
+			if ( (simulateTriangle( indices, i, timeStamp, cacheSize ) == 3) || (i == 0) )
+				mTemporaryOrder.push_back( (unsigned int)i );
+		}
+		mTemporaryOrder.push_back( (unsigned int)trianglesCount );
+
+		// each hard cluster is split further, where the ACMR of the part is not worse than the one of the whole
+		// hard cluster multiplied by the threshold
+		mClusters.clear();
+		for ( size_t c = 0, count = mTemporaryOrder.size() - 1; c < count; ++c )
+		{
+			unsigned int start = mTemporaryOrder[c];
+			unsigned int end = mTemporaryOrder[c + 1];
+
+			timeStamp += (unsigned int)cacheSize + 1;
+			size_t misses = 0;
+			for ( unsigned int i = start; i < end; ++i )
+				misses += simulateTriangle( indices, i, timeStamp, cacheSize );
+			float clusterThreshold = threshold * (float)misses / (float)(end - start);
+
+			timeStamp += (unsigned int)cacheSize + 1;
+			unsigned int clusterStart = start;
+			misses = 0;
+			for ( unsigned int i = start; i < end; ++i )
+			{
+				misses += simulateTriangle( indices, i, timeStamp, cacheSize );
+				if ( (i + 1 < end) && ((float)misses / (float)(i + 1 - clusterStart) <= clusterThreshold) )
+				{
+					mClusters.push_back( clusterStart );
+					mClusters.push_back( i + 1 - clusterStart );
+					clusterStart = i + 1;
+					misses = 0;
+					timeStamp += (unsigned int)cacheSize + 1;
+				}
+			}
+			mClusters.push_back( clusterStart );
+			mClusters.push_back( end - clusterStart );
+		}
+	}
+
+	//------------------------------
+	unsigned int MeshOptimizer::simulateTriangle( const unsigned int* indices, size_t triangle, unsigned int& timeStamp, size_t cacheSize )
+	{
+		unsigned int misses = 0;
+		for ( size_t k = 0; k < 3; ++k )
+		{
+			unsigned int vertex = indices[3 * triangle + k];
+			if ( timeStamp - mCacheTimeStamps[vertex] > cacheSize )
+			{
+				mCacheTimeStamps[vertex] = timeStamp++;
+				++misses;
+			}
+		}
+		return misses;
+	}
+
+	//------------------------------
+	size_t MeshOptimizer::optimizeVertexFetch( unsigned int* indices, size_t indicesCount, size_t verticesCount, std::vector<unsigned int>& vertexRemap )
+	{
+		vertexRemap.assign( verticesCount, UINT_MAX );
+		unsigned int usedVerticesCount = 0;
+		for ( size_t i = 0; i < indicesCount; ++i )
+		{
+			unsigned int& newIndex = vertexRemap[indices[i]];
+			if ( newIndex == UINT_MAX )
+				newIndex = usedVerticesCount++;
+			indices[i] = newIndex;
+		}
+		return usedVerticesCount;
+	}
+
+	//------------------------------
+	MeshOptimizer::VertexCacheStatistics MeshOptimizer::analyzeVertexCache( const unsigned int* indices, size_t indicesCount, size_t verticesCount, size_t cacheSize )
+	{
+		VertexCacheStatistics statistics;
+		statistics.trianglesCount = indicesCount / 3;
+
+		mCacheTimeStamps.assign( verticesCount, 0 );
+		unsigned int timeStamp = (unsigned int)cacheSize + 1;
+		for ( size_t i = 0, count = 3 * statistics.trianglesCount; i < count; ++i )
+		{
+			unsigned int vertex = indices[i];
+			if ( mCacheTimeStamps[vertex] == 0 )
+				++statistics.verticesCount;
+			if ( timeStamp - mCacheTimeStamps[vertex] > cacheSize )
+			{
+				mCacheTimeStamps[vertex] = timeStamp++;
+				++statistics.transformedVerticesCount;
+			}
+		}
+		return statistics;
+	}
+
+	//------------------------------
+	bool MeshOptimizer::optimizeTriangles( const Mesh& mesh,
+		Triangles& triangles,
+		float overdrawThreshold,
+		VertexCacheStatistics* originalStatistics,
+		VertexCacheStatistics* optimizedStatistics )
+	{
+		if ( !mWelder.weld( mesh, triangles ) )
+			return false;
+
+		// the triangles are reordered by the welded vertices, i.e. by what the vertex cache sees
+		const UIntValuesArray& weldedIndices = mWelder.getIndices();
+		size_t trianglesCount = weldedIndices.getCount() / 3;
+		size_t indicesCount = 3 * trianglesCount;
+		size_t verticesCount = mWelder.getVertexCount();
+		if ( trianglesCount == 0 )
+			return true;
+		mIndices.assign( weldedIndices.getData(), weldedIndices.getData() + indicesCount );
+
+		if ( originalStatistics )
+			*originalStatistics = analyzeVertexCache( &mIndices[0], indicesCount, verticesCount );
+
+		optimizeVertexCache( &mIndices[0], indicesCount, verticesCount );
+		if ( overdrawThreshold > 0 )
+		{
+			mCombinedOrder = mTriangleOrder;
+			optimizeOverdraw( &mIndices[0], indicesCount, mWelder.getElementData( 0 ), mWelder.getVertexElements()[0].stride, verticesCount, overdrawThreshold );
+			for ( size_t i = 0; i < trianglesCount; ++i )
+				mTriangleOrder[i] = mCombinedOrder[mTriangleOrder[i]];
+		}
+
+		if ( optimizedStatistics )
+			*optimizedStatistics = analyzeVertexCache( &mIndices[0], indicesCount, verticesCount );
+
+		reorderIndices( triangles.getPositionIndices() );
+		reorderIndices( triangles.getNormalIndices() );
+		reorderIndices( triangles.getTangentIndices() );
+		reorderIndices( triangles.getBinormalIndices() );
+		IndexListArray& colorIndicesArray = triangles.getColorIndicesArray();
+		for ( size_t i = 0, count = colorIndicesArray.getCount(); i < count; ++i )
+			reorderIndices( colorIndicesArray[i]->getIndices() );
+		IndexListArray& uvIndicesArray = triangles.getUVCoordIndicesArray();
+		for ( size_t i = 0, count = uvIndicesArray.getCount(); i < count; ++i )
+			reorderIndices( uvIndicesArray[i]->getIndices() );
+		return true;
+	}
+
+	//------------------------------
+	void MeshOptimizer::reorderIndices( UIntValuesArray& array )
+	{
+		// only index arrays with one index per corner belong to the triangles
+		if ( array.getCount() != mWelder.getIndices().getCount() )
+			return;
+		mSourceIndices.assign( array.getData(), array.getData() + 3 * mTriangleOrder.size() );
+		writeTriangles( array.getData() );
+	}
+
+} // namespace COLLADAFW
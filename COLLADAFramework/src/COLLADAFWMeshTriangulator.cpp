@@ -0,0 +1,681 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADAFramework.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADAFWStableHeaders.h"
+#include "COLLADAFWMeshTriangulator.h"
+#include "COLLADAFWMesh.h"
+#include "COLLADAFWTriangles.h"
+#include "COLLADAFWPolygons.h"
+#include "COLLADAFWPolylist.h"
+#include "COLLADAFWTristrips.h"
+#include "COLLADAFWTrifans.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace COLLADAFW
+{
+
+	//------------------------------
+	MeshTriangulator::MeshTriangulator()
+		: mTriangleCorners( UIntValuesArray::OWNER )
+		, mPositions( 0 )
+	{
+	}
+
+	//------------------------------
+	MeshTriangulator::~MeshTriangulator()
+	{
+	}
+
+	//------------------------------
+	bool MeshTriangulator::isTriangulated( MeshPrimitive::PrimitiveType primitiveType )
+	{
+		switch ( primitiveType )
+		{
+		case MeshPrimitive::POLYGONS:
+		case MeshPrimitive::POLYLIST:
+		case MeshPrimitive::TRIANGLE_STRIPS:
+		case MeshPrimitive::TRIANGLE_FANS:
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	//------------------------------
+	bool MeshTriangulator::triangulate( const Mesh& mesh, const MeshPrimitive& primitive, Triangles& triangles )
+	{
+		MeshPrimitive::PrimitiveType primitiveType = primitive.getPrimitiveType();
+		if ( !isTriangulated( primitiveType ) )
+			return false;
+
+		const MeshVertexData& positions = mesh.getPositions();
+		mPositions = positions.empty() ? 0 : &positions;
+
+		const UIntValuesArray& positionIndices = primitive.getPositionIndices();
+		size_t cornersCount = positionIndices.getCount();
+		mTriangleCorners.setCount( 0 );
+
+		switch ( primitiveType )
+		{
+		case MeshPrimitive::POLYGONS:
+			{
+				const Polygons::VertexCountArray& vertexCounts = ((const Polygons&)primitive).getGroupedVerticesVertexCountArray();
+				addPolygons( vertexCounts.getData(), vertexCounts.getCount(), positionIndices );
+			}
+			break;
+		case MeshPrimitive::POLYLIST:
+			{
+				const Polylist::VertexCountArray& vertexCounts = ((const Polylist&)primitive).getGroupedVerticesVertexCountArray();
+				addPolygons( vertexCounts.getData(), vertexCounts.getCount(), positionIndices );
+			}
+			break;
+		case MeshPrimitive::TRIANGLE_STRIPS:
+			{
+				const Tristrips::VertexCountArray& vertexCounts = ((const Tristrips&)primitive).getGroupedVerticesVertexCountArray();
+				addTriangleStrips( vertexCounts.getData(), vertexCounts.getCount(), positionIndices );
+			}
+			break;
+		case MeshPrimitive::TRIANGLE_FANS:
+			{
+				const Trifans::VertexCountArray& vertexCounts = ((const Trifans&)primitive).getGroupedVerticesVertexCountArray();
+				addTriangleFans( vertexCounts.getData(), vertexCounts.getCount(), cornersCount );
+			}
+			break;
+		default:
+			break;
+		}
+		mPositions = 0;
+
+		triangles.setMaterial( primitive.getMaterial() );
+		triangles.setMaterialId( primitive.getMaterialId() );
+		triangles.setFaceCount( mTriangleCorners.getCount() / 3 );
+
+		gatherIndices( positionIndices, triangles.getPositionIndices() );
+		if ( primitive.getNormalIndices().getCount() == cornersCount )
+			gatherIndices( primitive.getNormalIndices(), triangles.getNormalIndices() );
+		if ( primitive.getTangentIndices().getCount() == cornersCount )
+			gatherIndices( primitive.getTangentIndices(), triangles.getTangentIndices() );
+		if ( primitive.getBinormalIndices().getCount() == cornersCount )
+			gatherIndices( primitive.getBinormalIndices(), triangles.getBinormalIndices() );
+		gatherIndexLists( primitive.getColorIndicesArray(), triangles.getColorIndicesArray(), cornersCount );
+		gatherIndexLists( primitive.getUVCoordIndicesArray(), triangles.getUVCoordIndicesArray(), cornersCount );
+		return true;
+	}
+
+	//------------------------------
+	void MeshTriangulator::addPolygons( const int* vertexCounts, size_t vertexCountsCount, const UIntValuesArray& positionIndices )
+	{
+		// a polygon with n corners has n - 2 triangles, each hole adds two corners to the boundary
+		size_t trianglesCount = 0;
+		for ( size_t i = 0; i < vertexCountsCount; ++i )
+		{
+			int vertexCount = vertexCounts[i];
+			if ( vertexCount >= 3 )
+				trianglesCount += vertexCount - 2;
+			else if ( vertexCount < 0 )
+				trianglesCount += 2 - vertexCount;
+		}
+		mTriangleCorners.reallocMemory( 3 * trianglesCount );
+
+		size_t cornersCount = positionIndices.getCount();
+		size_t firstCorner = 0;
+		std::vector<size_t> holeCornersCounts;
+		size_t i = 0;
+		while ( i < vertexCountsCount )
+		{
+			int outerCornersCount = vertexCounts[i++];
+			if ( outerCornersCount <= 0 )
+			{
+				// a hole without a polygon
+				firstCorner -= outerCornersCount;
+				continue;
+			}
+
+			size_t polygonCornersCount = outerCornersCount;
+			holeCornersCounts.clear();
+			while ( (i < vertexCountsCount) && (vertexCounts[i] < 0) )
+			{
+				holeCornersCounts.push_back( -vertexCounts[i] );
+				polygonCornersCount -= vertexCounts[i];
+				++i;
+			}
+
+			if ( firstCorner + polygonCornersCount > cornersCount )
+				break;
+
+			if ( outerCornersCount < 3 )
+			{
+				// nothing to triangulate
+			}
+			else if ( (outerCornersCount == 3) && holeCornersCounts.empty() )
+			{
+				addTriangle( firstCorner, firstCorner + 1, firstCorner + 2 );
+			}
+			else
+			{
+				addPolygon( firstCorner, outerCornersCount, holeCornersCounts, positionIndices );
+			}
+			firstCorner += polygonCornersCount;
+		}
+	}
+
+	//------------------------------
+	void MeshTriangulator::addTriangleStrips( const unsigned int* vertexCounts, size_t vertexCountsCount, const UIntValuesArray& positionIndices )
+	{
+		size_t cornersCount = positionIndices.getCount();
+		size_t firstCorner = 0;
+		for ( size_t i = 0; i < vertexCountsCount; ++i )
+		{
+			size_t stripCornersCount = vertexCounts[i];
+			if ( firstCorner + stripCornersCount > cornersCount )
+				break;
+
+			for ( size_t j = 2; j < stripCornersCount; ++j )
+			{
+				size_t corner1 = firstCorner + j - 2;
+				size_t corner2 = firstCorner + j - 1;
+				size_t corner3 = firstCorner + j;
+				unsigned int position1 = positionIndices[corner1];
+				unsigned int position2 = positionIndices[corner2];
+				unsigned int position3 = positionIndices[corner3];
+				if ( (position1 == position2) || (position2 == position3) || (position1 == position3) )
+					continue;
+
+				// every second triangle has the opposite winding
+				if ( (j % 2) == 0 )
+					addTriangle( corner1, corner2, corner3 );
+				else
+					addTriangle( corner2, corner1, corner3 );
+			}
+			firstCorner += stripCornersCount;
+		}
+	}
+
+	//------------------------------
+	void MeshTriangulator::addTriangleFans( const unsigned int* vertexCounts, size_t vertexCountsCount, size_t cornersCount )
+	{
+		size_t firstCorner = 0;
+		for ( size_t i = 0; i < vertexCountsCount; ++i )
+		{
+			size_t fanCornersCount = vertexCounts[i];
+			if ( firstCorner + fanCornersCount > cornersCount )
+				break;
+			if ( fanCornersCount >= 3 )
+				addFan( firstCorner, fanCornersCount );
+			firstCorner += fanCornersCount;
+		}
+	}
+
+	//------------------------------
+	void MeshTriangulator::addFan( size_t firstCorner, size_t cornersCount )
+	{
+		size_t trianglesCount = cornersCount - 2;
+		size_t count = mTriangleCorners.getCount();
+		mTriangleCorners.reallocMemory( count + 3 * trianglesCount );
+
+		// written without dependencies between the iterations, to let the compiler vectorize the loop
+		unsigned int* corners = mTriangleCorners.getData() + count;
+		unsigned int first = (unsigned int)firstCorner;
+		for ( size_t i = 0; i < trianglesCount; ++i )
+		{
+			corners[3 * i] = first;
+			corners[3 * i + 1] = first + (unsigned int)i + 1;
+			corners[3 * i + 2] = first + (unsigned int)i + 2;
+		}
+		mTriangleCorners.setCount( count + 3 * trianglesCount );
+	}
+
+	//------------------------------
+	void MeshTriangulator::addPolygon( size_t firstCorner, size_t outerCornersCount, const std::vector<size_t>& holeCornersCounts, const UIntValuesArray& positionIndices )
+	{
+		size_t cornersCount = outerCornersCount;
+		for ( size_t i = 0, count = holeCornersCounts.size(); i < count; ++i )
+			cornersCount += holeCornersCounts[i];
+
+		if ( !projectPolygon( firstCorner, cornersCount, outerCornersCount, positionIndices ) )
+		{
+			// without positions we can only assume a convex polygon and have to ignore the holes
+			addFan( firstCorner, outerCornersCount );
+			return;
+		}
+
+		if ( holeCornersCounts.empty() && isConvex( outerCornersCount ) )
+		{
+			addFan( firstCorner, outerCornersCount );
+			return;
+		}
+
+		mBoundary.resize( outerCornersCount );
+		for ( size_t i = 0; i < outerCornersCount; ++i )
+			mBoundary[i] = i;
+		if ( !holeCornersCounts.empty() )
+			bridgeHoles( outerCornersCount, holeCornersCounts );
+
+		clipEars( firstCorner );
+	}
+
+	//------------------------------
+	bool MeshTriangulator::projectPolygon( size_t firstCorner, size_t cornersCount, size_t outerCornersCount, const UIntValuesArray& positionIndices )
+	{
+		if ( !mPositions )
+			return false;
+
+		std::vector<double> positions( 3 * cornersCount );
+		for ( size_t i = 0; i < cornersCount; ++i )
+		{
+			if ( !getPosition( positionIndices[firstCorner + i], &positions[3 * i] ) )
+				return false;
+		}
+
+		// the normal of the outer boundary, using Newell's method
+		double normal[3] = { 0, 0, 0 };
+		for ( size_t i = 0; i < outerCornersCount; ++i )
+		{
+			const double* p = &positions[3 * i];
+			const double* q = &positions[3 * ((i + 1) % outerCornersCount)];
+			normal[0] += (p[1] - q[1]) * (p[2] + q[2]);
+			normal[1] += (p[2] - q[2]) * (p[0] + q[0]);
+			normal[2] += (p[0] - q[0]) * (p[1] + q[1]);
+		}
+
+		// drop the dominant axis of the normal. The remaining axes are chosen such that the outer boundary
+		// is counter clockwise, if the normal points along the dropped axis, otherwise u is mirrored
+		size_t dominantAxis = 0;
+		for ( size_t axis = 1; axis < 3; ++axis )
+		{
+			if ( fabs( normal[axis] ) > fabs( normal[dominantAxis] ) )
+				dominantAxis = axis;
+		}
+		if ( normal[dominantAxis] == 0 )
+			return false;
+		size_t uAxis = (dominantAxis + 1) % 3;
+		size_t vAxis = (dominantAxis + 2) % 3;
+		double uSign = normal[dominantAxis] > 0 ? 1 : -1;
+
+		mProjectedPositions.resize( 2 * cornersCount );
+		for ( size_t i = 0; i < cornersCount; ++i )
+		{
+			mProjectedPositions[2 * i] = uSign * positions[3 * i + uAxis];
+			mProjectedPositions[2 * i + 1] = positions[3 * i + vAxis];
+		}
+		return true;
+	}
+
+	//------------------------------
+	bool MeshTriangulator::isConvex( size_t cornersCount ) const
+	{
+		// corners at the position of their predecessor are skipped, since a duplicate corner would hide the
+		// turn at its position. The walk starts at a corner, that differs from its predecessor
+		size_t first = 0;
+		while ( (first < cornersCount) && isSamePosition( first, (first + cornersCount - 1) % cornersCount ) )
+			++first;
+		if ( first == cornersCount )
+			return true;
+
+		// all turns must be left turns and the boundary must not wind around more than once, i.e. the
+		// direction along u changes its sign at most twice
+		size_t uDirectionChanges = 0;
+		double lastUDirection = 0;
+		size_t previous = (first + cornersCount - 1) % cornersCount;
+		size_t current = first;
+		do
+		{
+			size_t next = (current + 1) % cornersCount;
+			while ( isSamePosition( next, current ) )
+				next = (next + 1) % cornersCount;
+			if ( cross( previous, current, next ) < 0 )
+				return false;
+
+			double uDirection = mProjectedPositions[2 * next] - mProjectedPositions[2 * current];
+			if ( uDirection != 0 )
+			{
+				if ( (lastUDirection != 0) && ((uDirection > 0) != (lastUDirection > 0)) )
+					++uDirectionChanges;
+				lastUDirection = uDirection;
+			}
+			previous = current;
+			current = next;
+		}
+		while ( current != first );
+		return uDirectionChanges <= 2;
+	}
+
+	//------------------------------
+	void MeshTriangulator::bridgeHoles( size_t outerCornersCount, const std::vector<size_t>& holeCornersCounts )
+	{
+		// the holes are linked in the order of their leftmost corners, each through its leftmost corner
+		size_t holesCount = holeCornersCounts.size();
+		std::vector<size_t> firstHoleCorners( holesCount );
+		std::vector<size_t> leftmostHoleCorners( holesCount );
+		std::vector< std::pair<double, size_t> > sortedHoles;
+		size_t firstHoleCorner = outerCornersCount;
+		for ( size_t i = 0; i < holesCount; ++i )
+		{
+			size_t holeCornersCount = holeCornersCounts[i];
+			size_t leftmostCorner = firstHoleCorner;
+			for ( size_t j = firstHoleCorner + 1; j < firstHoleCorner + holeCornersCount; ++j )
+			{
+				const double* p = &mProjectedPositions[2 * j];
+				const double* leftmost = &mProjectedPositions[2 * leftmostCorner];
+				if ( (p[0] < leftmost[0]) || ((p[0] == leftmost[0]) && (p[1] < leftmost[1])) )
+					leftmostCorner = j;
+			}
+			firstHoleCorners[i] = firstHoleCorner;
+			leftmostHoleCorners[i] = leftmostCorner;
+			if ( holeCornersCount >= 3 )
+				sortedHoles.push_back( std::make_pair( mProjectedPositions[2 * leftmostCorner], i ) );
+			firstHoleCorner += holeCornersCount;
+		}
+		std::sort( sortedHoles.begin(), sortedHoles.end() );
+
+		std::vector<size_t> holeBoundary;
+		for ( size_t i = 0, count = sortedHoles.size(); i < count; ++i )
+		{
+			size_t hole = sortedHoles[i].second;
+			size_t firstCorner = firstHoleCorners[hole];
+			size_t holeCornersCount = holeCornersCounts[hole];
+			size_t leftmostCorner = leftmostHoleCorners[hole];
+
+			// a hole touching a corner of the boundary is linked through it, since a bridge from another corner
+			// would pass the touching point
+			size_t bridgeCorner = leftmostCorner;
+			size_t bridgePosition = findTouchingCorner( firstCorner, holeCornersCount, bridgeCorner );
+			if ( bridgePosition == mBoundary.size() )
+				bridgePosition = findHoleBridge( leftmostCorner );
+			if ( bridgePosition == mBoundary.size() )
+				continue;
+
+			// holes must be clockwise, starting and ending at their bridge corner
+			double area = 0;
+			for ( size_t j = 0; j < holeCornersCount; ++j )
+			{
+				const double* p = &mProjectedPositions[2 * (firstCorner + j)];
+				const double* q = &mProjectedPositions[2 * (firstCorner + (j + 1) % holeCornersCount)];
+				area += p[0] * q[1] - q[0] * p[1];
+			}
+			holeBoundary.clear();
+			size_t bridgeOffset = bridgeCorner - firstCorner;
+			for ( size_t j = 0; j <= holeCornersCount; ++j )
+			{
+				size_t offset = area > 0 ? (bridgeOffset + holeCornersCount - j) : (bridgeOffset + j);
+				holeBoundary.push_back( firstCorner + offset % holeCornersCount );
+			}
+			holeBoundary.push_back( mBoundary[bridgePosition] );
+			mBoundary.insert( mBoundary.begin() + bridgePosition + 1, holeBoundary.begin(), holeBoundary.end() );
+		}
+	}
+
+	//------------------------------
+	size_t MeshTriangulator::findTouchingCorner( size_t firstHoleCorner, size_t holeCornersCount, size_t& holeCorner ) const
+	{
+		size_t boundarySize = mBoundary.size();
+		for ( size_t i = firstHoleCorner; i < firstHoleCorner + holeCornersCount; ++i )
+		{
+			for ( size_t j = 0; j < boundarySize; ++j )
+			{
+				if ( isSamePosition( mBoundary[j], i ) )
+				{
+					holeCorner = i;
+					return j;
+				}
+			}
+		}
+		return boundarySize;
+	}
+
+	//------------------------------
+	size_t MeshTriangulator::findHoleBridge( size_t holeCorner ) const
+	{
+		size_t boundarySize = mBoundary.size();
+		double hx = mProjectedPositions[2 * holeCorner];
+		double hy = mProjectedPositions[2 * holeCorner + 1];
+
+		// find the edge left of the hole corner, that intersects the ray from the hole corner along -u and
+		// is closest to it
+		double qx = -HUGE_VAL;
+		size_t bridgePosition = boundarySize;
+		for ( size_t i = 0; i < boundarySize; ++i )
+		{
+			size_t next = (i + 1) % boundarySize;
+			const double* p = &mProjectedPositions[2 * mBoundary[i]];
+			const double* n = &mProjectedPositions[2 * mBoundary[next]];
+			if ( (hy <= p[1]) && (hy >= n[1]) && (n[1] != p[1]) )
+			{
+				double x = p[0] + (hy - p[1]) * (n[0] - p[0]) / (n[1] - p[1]);
+				if ( (x <= hx) && (x > qx) )
+				{
+					qx = x;
+					bridgePosition = p[0] < n[0] ? i : next;
+					if ( x == hx )
+						return bridgePosition;
+				}
+			}
+		}
+		if ( bridgePosition == boundarySize )
+			return boundarySize;
+
+		// if corners lie in the triangle formed by the hole corner, the intersection and the chosen corner,
+		// the one with the minimum angle to the ray is taken instead
+		const double* m = &mProjectedPositions[2 * mBoundary[bridgePosition]];
+		double mx = m[0];
+		double my = m[1];
+		double minimumTangent = HUGE_VAL;
+		for ( size_t i = 0; i < boundarySize; ++i )
+		{
+			const double* p = &mProjectedPositions[2 * mBoundary[i]];
+			if ( (hx >= p[0]) && (p[0] >= mx) && (hx != p[0]) )
+			{
+				double ax = hy < my ? hx : qx;
+				double cx = hy < my ? qx : hx;
+				// point in triangle (ax, hy), (mx, my), (cx, hy)
+				bool inside = ((cx - p[0]) * (hy - p[1]) >= (ax - p[0]) * (hy - p[1]))
+					&& ((ax - p[0]) * (my - p[1]) >= (mx - p[0]) * (hy - p[1]))
+					&& ((mx - p[0]) * (hy - p[1]) >= (cx - p[0]) * (my - p[1]));
+				if ( inside && isLocallyInside( i, holeCorner ) )
+				{
+					double tangent = fabs( hy - p[1] ) / (hx - p[0]);
+					const double* bridge = &mProjectedPositions[2 * mBoundary[bridgePosition]];
+					if ( (tangent < minimumTangent) || ((tangent == minimumTangent) && (p[0] > bridge[0])) )
+					{
+						bridgePosition = i;
+						minimumTangent = tangent;
+					}
+				}
+			}
+		}
+		return bridgePosition;
+	}
+
+	//------------------------------
+	bool MeshTriangulator::isLocallyInside( size_t position, size_t corner ) const
+	{
+		size_t boundarySize = mBoundary.size();
+		size_t previous = mBoundary[(position + boundarySize - 1) % boundarySize];
+		size_t current = mBoundary[position];
+		size_t next = mBoundary[(position + 1) % boundarySize];
+		if ( cross( previous, current, next ) > 0 )
+			return (cross( current, corner, next ) <= 0) && (cross( current, previous, corner ) <= 0);
+		else
+			return (cross( current, corner, previous ) > 0) || (cross( current, next, corner ) > 0);
+	}
+
+	//------------------------------
+	void MeshTriangulator::clipEars( size_t firstCorner )
+	{
+		size_t boundarySize = mBoundary.size();
+		mPreviousCorners.resize( boundarySize );
+		mNextCorners.resize( boundarySize );
+		for ( size_t i = 0; i < boundarySize; ++i )
+		{
+			mPreviousCorners[i] = (i + boundarySize - 1) % boundarySize;
+			mNextCorners[i] = (i + 1) % boundarySize;
+		}
+
+		size_t remainingCount = boundarySize;
+		size_t ear = 0;
+		size_t stop = ear;
+		while ( remainingCount > 3 )
+		{
+			size_t previous = mPreviousCorners[ear];
+			size_t next = mNextCorners[ear];
+			if ( isSamePosition( mBoundary[ear], mBoundary[next] ) )
+			{
+				// a corner at the position of the next one, e.g. a duplicate corner, is removed without a
+				// triangle. It would never be an ear and could leave a boundary without ears
+				mNextCorners[previous] = next;
+				mPreviousCorners[next] = previous;
+				--remainingCount;
+				ear = next;
+				stop = ear;
+				continue;
+			}
+
+			if ( isEar( ear ) )
+			{
+				addTriangle( firstCorner + mBoundary[previous], firstCorner + mBoundary[ear], firstCorner + mBoundary[next] );
+				mNextCorners[previous] = next;
+				mPreviousCorners[next] = previous;
+				--remainingCount;
+				ear = mNextCorners[next];
+				stop = ear;
+				continue;
+			}
+
+			ear = next;
+			if ( ear == stop )
+			{
+				// no ear left, the polygon is self intersecting or degenerated. We cut off the current corner
+				// anyway, to make sure all corners are used
+				previous = mPreviousCorners[ear];
+				next = mNextCorners[ear];
+				addTriangle( firstCorner + mBoundary[previous], firstCorner + mBoundary[ear], firstCorner + mBoundary[next] );
+				mNextCorners[previous] = next;
+				mPreviousCorners[next] = previous;
+				--remainingCount;
+				ear = next;
+				stop = ear;
+			}
+		}
+		if ( remainingCount == 3 )
+			addTriangle( firstCorner + mBoundary[mPreviousCorners[ear]], firstCorner + mBoundary[ear], firstCorner + mBoundary[mNextCorners[ear]] );
+	}
+
+	//------------------------------
+	bool MeshTriangulator::isEar( size_t position ) const
+	{
+		size_t a = mBoundary[mPreviousCorners[position]];
+		size_t b = mBoundary[position];
+		size_t c = mBoundary[mNextCorners[position]];
+		if ( cross( a, b, c ) <= 0 )
+			return false;
+
+		const double* pa = &mProjectedPositions[2 * a];
+		const double* pb = &mProjectedPositions[2 * b];
+		const double* pc = &mProjectedPositions[2 * c];
+		size_t last = mPreviousCorners[position];
+		for ( size_t i = mNextCorners[mNextCorners[position]]; i != last; i = mNextCorners[i] )
+		{
+			size_t p = mBoundary[i];
+			const double* pp = &mProjectedPositions[2 * p];
+			// corners at the position of the triangle corners, e.g. those linking holes, do not block the ear
+			if ( ((pp[0] == pa[0]) && (pp[1] == pa[1])) || ((pp[0] == pb[0]) && (pp[1] == pb[1])) || ((pp[0] == pc[0]) && (pp[1] == pc[1])) )
+				continue;
+			if ( (cross( a, b, p ) >= 0) && (cross( b, c, p ) >= 0) && (cross( c, a, p ) >= 0)
+				&& (cross( mBoundary[mPreviousCorners[i]], p, mBoundary[mNextCorners[i]] ) <= 0) )
+				return false;
+		}
+		return true;
+	}
+
+	//------------------------------
+	bool MeshTriangulator::isSamePosition( size_t corner1, size_t corner2 ) const
+	{
+		const double* p1 = &mProjectedPositions[2 * corner1];
+		const double* p2 = &mProjectedPositions[2 * corner2];
+		return (p1[0] == p2[0]) && (p1[1] == p2[1]);
+	}
+
+	//------------------------------
+	double MeshTriangulator::cross( size_t corner1, size_t corner2, size_t corner3 ) const
+	{
+		const double* p1 = &mProjectedPositions[2 * corner1];
+		const double* p2 = &mProjectedPositions[2 * corner2];
+		const double* p3 = &mProjectedPositions[2 * corner3];
+		return (p2[0] - p1[0]) * (p3[1] - p1[1]) - (p2[1] - p1[1]) * (p3[0] - p1[0]);
+	}
+
+	//------------------------------
+	bool MeshTriangulator::getPosition( unsigned int positionIndex, double position[3] ) const
+	{
+		size_t index = 3 * (size_t)positionIndex;
+		if ( index + 2 >= mPositions->getValuesCount() )
+			return false;
+		if ( mPositions->getType() == FloatOrDoubleArray::DATA_TYPE_DOUBLE )
+		{
+			const double* values = mPositions->getDoubleValues()->getData() + index;
+			position[0] = values[0];
+			position[1] = values[1];
+			position[2] = values[2];
+		}
+		else
+		{
+			const float* values = mPositions->getFloatValues()->getData() + index;
+			position[0] = values[0];
+			position[1] = values[1];
+			position[2] = values[2];
+		}
+		return true;
+	}
+
+	//------------------------------
+	void MeshTriangulator::addTriangle( size_t corner1, size_t corner2, size_t corner3 )
+	{
+		mTriangleCorners.append( (unsigned int)corner1 );
+		mTriangleCorners.append( (unsigned int)corner2 );
+		mTriangleCorners.append( (unsigned int)corner3 );
+	}
+
+	//------------------------------
+	void MeshTriangulator::gatherIndices( const UIntValuesArray& source, UIntValuesArray& target ) const
+	{
+		size_t count = mTriangleCorners.getCount();
+		target.setCount( 0 );
+		target.reallocMemory( count );
+		const unsigned int* corners = mTriangleCorners.getData();
+		const unsigned int* sourceIndices = source.getData();
+		unsigned int* targetIndices = target.getData();
+		for ( size_t i = 0; i < count; ++i )
+			targetIndices[i] = sourceIndices[corners[i]];
+		target.setCount( count );
+	}
+
+	//------------------------------
+	void MeshTriangulator::gatherIndexLists( const IndexListArray& source, IndexListArray& target, size_t cornersCount ) const
+	{
+		for ( size_t i = 0, count = source.getCount(); i < count; ++i )
+		{
+			const IndexList* sourceIndexList = source[i];
+			if ( sourceIndexList->getIndicesCount() != cornersCount )
+				continue;
+
+			IndexList* targetIndexList = FW_NEW IndexList();
+			targetIndexList->setName( sourceIndexList->getName() );
+			targetIndexList->setStride( sourceIndexList->getStride() );
+			targetIndexList->setSetIndex( sourceIndexList->getSetIndex() );
+			targetIndexList->setInitialIndex( sourceIndexList->getInitialIndex() );
+			gatherIndices( sourceIndexList->getIndices(), targetIndexList->getIndices() );
+			target.append( targetIndexList );
+		}
+	}
+
+} // namespace COLLADAFW
@@ -0,0 +1,351 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADAFramework.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADAFWStableHeaders.h"
+#include "COLLADAFWMeshVertexWelder.h"
+#include "COLLADAFWMesh.h"
+#include "COLLADAFWMeshOptimizer.h"
+
+#include "COLLADABUParallel.h"
+
+#include <algorithm>
+
+
+namespace COLLADAFW
+{
+
+	namespace
+	{
+		/** Primitives with less corners in total are welded on the calling thread.*/
+		const size_t MIN_CORNERS_FOR_CONCURRENT_WELDING = 65536;
+
+		/** Welds the primitives in a range on one thread.*/
+		class WeldTask : public COLLADABU::ParallelTask
+		{
+		private:
+			const Mesh& mMesh;
+			const MeshPrimitiveArray& mPrimitives;
+			const std::vector<MeshVertexWelder*>& mWelders;
+
+		public:
+			WeldTask( const Mesh& mesh, const std::vector<MeshVertexWelder*>& welders )
+				: mMesh(mesh)
+				, mPrimitives(mesh.getMeshPrimitives())
+				, mWelders(welders)
+			{}
+
+			virtual void execute( size_t begin, size_t end, size_t threadIndex )
+			{
+				for ( size_t i = begin; i < end; ++i )
+				{
+					mWelders[i]->weld( mMesh, *mPrimitives[i] );
+				}
+			}
+
+		private:
+			/** Disable default assignment operator. */
+			const WeldTask& operator= ( const WeldTask& pre );
+		};
+
+		/** Copies @a count values starting at @a sourceIndex to @a target. Values beyond @a sourceCount are
+		set to zero.*/
+		template<class T>
+		void copyValues( const T* source, size_t sourceCount, size_t sourceIndex, float* target, size_t count )
+		{
+			for ( size_t i = 0; i < count; ++i, ++sourceIndex )
+			{
+				target[i] = sourceIndex < sourceCount ? (float)source[sourceIndex] : 0.0f;
+			}
+		}
+	}
+
+	//------------------------------
+	MeshVertexWelder::MeshVertexWelder( VertexLayout vertexLayout )
+		: mVertexLayout( vertexLayout )
+		, mVertexSize( 0 )
+		, mVertexCount( 0 )
+		, mVertexData( FloatArray::OWNER )
+		, mIndices( UIntValuesArray::OWNER )
+		, mShortIndices( ArrayPrimitiveType<unsigned short>::OWNER )
+	{
+	}
+
+	//------------------------------
+	MeshVertexWelder::~MeshVertexWelder()
+	{
+	}
+
+	//------------------------------
+	bool MeshVertexWelder::weld( const Mesh& mesh, const MeshPrimitive& primitive )
+	{
+		mVertexElements.clear();
+		mElementIndices.clear();
+		mElementValues.clear();
+		mKeyIndices.clear();
+		mVertexSize = 0;
+		mVertexCount = 0;
+		mVertexData.setCount( 0 );
+		mIndices.setCount( 0 );
+		mShortIndices.setCount( 0 );
+
+		const UIntValuesArray& positionIndices = primitive.getPositionIndices();
+		size_t cornersCount = positionIndices.getCount();
+		addVertexElement( POSITION, 0, 3, positionIndices, cornersCount, mesh.getPositions() );
+		if ( mVertexElements.empty() )
+			return false;
+
+		addVertexElement( NORMAL, 0, 3, primitive.getNormalIndices(), cornersCount, mesh.getNormals() );
+		addVertexElement( TANGENT, 0, 3, primitive.getTangentIndices(), cornersCount, mesh.getTangents() );
+		addVertexElement( BINORMAL, 0, 3, primitive.getBinormalIndices(), cornersCount, mesh.getBinormals() );
+
+		const IndexListArray& colorIndicesArray = primitive.getColorIndicesArray();
+		for ( size_t i = 0, count = colorIndicesArray.getCount(); i < count; ++i )
+		{
+			const IndexList* indexList = colorIndicesArray[i];
+			addVertexElement( COLOR, i, indexList->getStride(), indexList->getIndices(), cornersCount, mesh.getColors() );
+		}
+
+		const IndexListArray& uvIndicesArray = primitive.getUVCoordIndicesArray();
+		for ( size_t i = 0, count = uvIndicesArray.getCount(); i < count; ++i )
+		{
+			const IndexList* indexList = uvIndicesArray[i];
+			addVertexElement( UV_COORDINATE, i, indexList->getStride(), indexList->getIndices(), cornersCount, mesh.getUVCoords() );
+		}
+
+		// inputs that share their index array with another input, e.g. normals referencing the position
+		// indices, do not need to be hashed and compared twice
+		for ( size_t i = 0, count = mElementIndices.size(); i < count; ++i )
+		{
+			if ( std::find( mKeyIndices.begin(), mKeyIndices.end(), mElementIndices[i] ) == mKeyIndices.end() )
+				mKeyIndices.push_back( mElementIndices[i] );
+		}
+
+		assignVertices( cornersCount );
+		fillVertexData();
+		fillShortIndices();
+		return true;
+	}
+
+	//------------------------------
+	void MeshVertexWelder::weldPrimitives( const Mesh& mesh, const std::vector<MeshVertexWelder*>& welders, size_t maxThreadCount )
+	{
+		const MeshPrimitiveArray& primitives = mesh.getMeshPrimitives();
+		size_t primitivesCount = std::min( primitives.getCount(), welders.size() );
+
+		size_t cornersCount = 0;
+		for ( size_t i = 0; i < primitivesCount; ++i )
+			cornersCount += primitives[i]->getPositionIndices().getCount();
+		if ( cornersCount < MIN_CORNERS_FOR_CONCURRENT_WELDING )
+			maxThreadCount = 1;
+
+		WeldTask weldTask( mesh, welders );
+		COLLADABU::parallelFor( primitivesCount, weldTask, maxThreadCount, 1 );
+	}
+
+	//------------------------------
+	bool MeshVertexWelder::optimize( MeshOptimizer& optimizer, float overdrawThreshold )
+	{
+		size_t indicesCount = mIndices.getCount();
+		if ( mVertexElements.empty() || (indicesCount % 3 != 0) )
+			return false;
+
+		unsigned int* indices = mIndices.getData();
+		optimizer.optimizeVertexCache( indices, indicesCount, mVertexCount );
+		if ( overdrawThreshold > 0 )
+			optimizer.optimizeOverdraw( indices, indicesCount, getElementData( 0 ), mVertexElements[0].stride, mVertexCount, overdrawThreshold );
+
+		// each vertex is used, so the number of vertices does not change
+		std::vector<unsigned int> vertexRemap;
+		optimizer.optimizeVertexFetch( indices, indicesCount, mVertexCount, vertexRemap );
+
+		std::vector<float> oldVertexData( mVertexData.getData(), mVertexData.getData() + mVertexData.getCount() );
+		std::vector<unsigned int> oldVertexCorners( mVertexCorners );
+		for ( size_t vertex = 0; vertex < mVertexCount; ++vertex )
+			mVertexCorners[vertexRemap[vertex]] = oldVertexCorners[vertex];
+
+		float* vertexData = mVertexData.getData();
+		for ( size_t i = 0, count = mVertexElements.size(); i < count; ++i )
+		{
+			const VertexElement& vertexElement = mVertexElements[i];
+			for ( size_t vertex = 0; vertex < mVertexCount; ++vertex )
+			{
+				const float* source = &oldVertexData[vertexElement.offset + vertex * vertexElement.stride];
+				float* target = vertexData + vertexElement.offset + vertexRemap[vertex] * vertexElement.stride;
+				std::copy( source, source + vertexElement.componentCount, target );
+			}
+		}
+
+		mShortIndices.setCount( 0 );
+		fillShortIndices();
+		return true;
+	}
+
+	//------------------------------
+	const void* MeshVertexWelder::getIndexData() const
+	{
+		if ( hasShortIndices() )
+			return mShortIndices.getData();
+		return mIndices.getData();
+	}
+
+	//------------------------------
+	void MeshVertexWelder::addVertexElement( Semantic semantic, size_t setIndex, size_t componentCount, const UIntValuesArray& indices, size_t cornersCount, const FloatOrDoubleArray& vertexData )
+	{
+		if ( (cornersCount == 0) || (indices.getCount() != cornersCount) || (componentCount == 0) || vertexData.empty() )
+			return;
+
+		VertexElement vertexElement;
+		vertexElement.semantic = semantic;
+		vertexElement.setIndex = setIndex;
+		vertexElement.componentCount = componentCount;
+		vertexElement.offset = 0;
+		vertexElement.stride = 0;
+		mVertexElements.push_back( vertexElement );
+		mElementIndices.push_back( indices.getData() );
+		mElementValues.push_back( &vertexData );
+		mVertexSize += componentCount;
+	}
+
+	//------------------------------
+	void MeshVertexWelder::assignVertices( size_t cornersCount )
+	{
+		// keep the load factor at most 0.5, to keep the probe sequences short
+		size_t tableSize = 16;
+		while ( tableSize < 2 * cornersCount )
+			tableSize *= 2;
+		size_t mask = tableSize - 1;
+		mHashTable.assign( tableSize, 0 );
+
+		mVertexCorners.clear();
+		mIndices.setCount( 0 );
+		mIndices.reallocMemory( cornersCount );
+		unsigned int* indices = mIndices.getData();
+
+		for ( size_t corner = 0; corner < cornersCount; ++corner )
+		{
+			size_t slot = hashCorner( corner ) & mask;
+			for ( ;; )
+			{
+				unsigned int entry = mHashTable[slot];
+				if ( entry == 0 )
+				{
+					// first use of this combination of indices
+					unsigned int vertex = (unsigned int)mVertexCorners.size();
+					mVertexCorners.push_back( (unsigned int)corner );
+					mHashTable[slot] = vertex + 1;
+					indices[corner] = vertex;
+					break;
+				}
+				if ( equalCorners( corner, mVertexCorners[entry - 1] ) )
+				{
+					indices[corner] = entry - 1;
+					break;
+				}
+				slot = (slot + 1) & mask;
+			}
+		}
+		mIndices.setCount( cornersCount );
+		mVertexCount = mVertexCorners.size();
+	}
+
+	//------------------------------
+	unsigned int MeshVertexWelder::hashCorner( size_t corner ) const
+	{
+		// combine the indices and mix the bits, such that the lower bits used for the slot depend on all of them
+		unsigned int hash = 2166136261u;
+		for ( size_t i = 0, count = mKeyIndices.size(); i < count; ++i )
+		{
+			hash = (hash ^ mKeyIndices[i][corner]) * 16777619u;
+		}
+		hash ^= hash >> 16;
+		hash *= 0x85ebca6bu;
+		hash ^= hash >> 13;
+		return hash;
+	}
+
+	//------------------------------
+	bool MeshVertexWelder::equalCorners( size_t corner1, size_t corner2 ) const
+	{
+		for ( size_t i = 0, count = mKeyIndices.size(); i < count; ++i )
+		{
+			if ( mKeyIndices[i][corner1] != mKeyIndices[i][corner2] )
+				return false;
+		}
+		return true;
+	}
+
+	//------------------------------
+	void MeshVertexWelder::fillVertexData()
+	{
+		size_t valuesCount = mVertexSize * mVertexCount;
+		mVertexData.setCount( 0 );
+		mVertexData.reallocMemory( valuesCount );
+		mVertexData.setCount( valuesCount );
+		float* vertexData = mVertexData.getData();
+
+		size_t offset = 0;
+		for ( size_t i = 0, count = mVertexElements.size(); i < count; ++i )
+		{
+			VertexElement& vertexElement = mVertexElements[i];
+			size_t componentCount = vertexElement.componentCount;
+			if ( mVertexLayout == INTERLEAVED )
+			{
+				vertexElement.offset = offset;
+				vertexElement.stride = mVertexSize;
+				offset += componentCount;
+			}
+			else
+			{
+				vertexElement.offset = offset;
+				vertexElement.stride = componentCount;
+				offset += componentCount * mVertexCount;
+			}
+
+			// element by element, such that each source array is read in one pass
+			const unsigned int* indices = mElementIndices[i];
+			const FloatOrDoubleArray& values = *mElementValues[i];
+			float* target = vertexData + vertexElement.offset;
+			if ( values.getType() == FloatOrDoubleArray::DATA_TYPE_DOUBLE )
+			{
+				const DoubleArray& doubleValues = *values.getDoubleValues();
+				for ( size_t vertex = 0; vertex < mVertexCount; ++vertex, target += vertexElement.stride )
+				{
+					size_t sourceIndex = (size_t)indices[mVertexCorners[vertex]] * componentCount;
+					copyValues( doubleValues.getData(), doubleValues.getCount(), sourceIndex, target, componentCount );
+				}
+			}
+			else
+			{
+				const FloatArray& floatValues = *values.getFloatValues();
+				for ( size_t vertex = 0; vertex < mVertexCount; ++vertex, target += vertexElement.stride )
+				{
+					size_t sourceIndex = (size_t)indices[mVertexCorners[vertex]] * componentCount;
+					copyValues( floatValues.getData(), floatValues.getCount(), sourceIndex, target, componentCount );
+				}
+			}
+		}
+	}
+
+	//------------------------------
+	void MeshVertexWelder::fillShortIndices()
+	{
+		if ( mVertexCount > MAX_SHORT_INDEXED_VERTICES )
+			return;
+
+		size_t indicesCount = mIndices.getCount();
+		mShortIndices.reallocMemory( indicesCount );
+		const unsigned int* indices = mIndices.getData();
+		unsigned short* shortIndices = mShortIndices.getData();
+		for ( size_t i = 0; i < indicesCount; ++i )
+			shortIndices[i] = (unsigned short)indices[i];
+		mShortIndices.setCount( indicesCount );
+	}
+
+} // namespace COLLADAFW
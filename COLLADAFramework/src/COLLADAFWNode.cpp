@@ -14,9 +14,13 @@
 #include "COLLADAFWTranslate.h"
 #include "COLLADAFWScale.h"
 #include "COLLADAFWMatrix.h"
+#include "COLLADAFWLookat.h"
+#include "COLLADAFWSkew.h"
 
 #include "Math/COLLADABUMathMatrix4.h"
 
+#include <cmath>
+
 
 namespace COLLADAFW
 {
@@ -36,12 +40,18 @@ namespace COLLADAFW
 
 	//--------------------------------------------------------------------
 	void Node::getTransformationMatrix(COLLADABU::Math::Matrix4& transformationMatrix) const
+	{
+		getTransformationMatrix(mTransformations, transformationMatrix);
+	}
+
+	//--------------------------------------------------------------------
+	void Node::getTransformationMatrix(const TransformationPointerArray& transformations, COLLADABU::Math::Matrix4& transformationMatrix)
 	{
 		transformationMatrix = COLLADABU::Math::Matrix4::IDENTITY;
 
-		for ( size_t i = 0, count = mTransformations.getCount(); i < count; ++i )
+		for ( size_t i = 0, count = transformations.getCount(); i < count; ++i )
 		{
-			Transformation* transform = mTransformations[i];
+			Transformation* transform = transformations[i];
 
 			switch ( transform->getTransformationType() )
 			{
@@ -79,9 +89,38 @@ namespace COLLADAFW
 					break;
 				}
 			case Transformation::LOOKAT:
-				break; /** @TODO unhandled case */
+				{
+					// places the object at the eye, looking along its negative z axis at the interest point
+					Lookat* lookat = (Lookat*)transform;
+					const COLLADABU::Math::Vector3& eye = lookat->getEyePosition();
+					COLLADABU::Math::Vector3 forward = lookat->getInterestPointPosition() - eye;
+					forward.normalise();
+					COLLADABU::Math::Vector3 side = forward.crossProduct(lookat->getUpAxisDirection());
+					side.normalise();
+					COLLADABU::Math::Vector3 up = side.crossProduct(forward);
+					COLLADABU::Math::Matrix4 lookatMatrix( side.x, up.x, -forward.x, eye.x,
+						side.y, up.y, -forward.y, eye.y,
+						side.z, up.z, -forward.z, eye.z,
+						0, 0, 0, 1 );
+					transformationMatrix = transformationMatrix * lookatMatrix;
+					break;
+				}
 			case Transformation::SKEW:
-				break; /** @TODO unhandled case */
+				{
+					// shears along the translate axis, such that the rotate axis is rotated by the angle
+					Skew* skew = (Skew*)transform;
+					COLLADABU::Math::Vector3 rotateAxis = skew->getRotateAxis();
+					rotateAxis.normalise();
+					COLLADABU::Math::Vector3 translateAxis = skew->getTranslateAxis();
+					translateAxis.normalise();
+					double s = tan(COLLADABU::Math::Utils::degToRad(skew->getAngle()));
+					COLLADABU::Math::Matrix4 skewMatrix = COLLADABU::Math::Matrix4::IDENTITY;
+					for ( int row = 0; row < 3; ++row )
+						for ( int column = 0; column < 3; ++column )
+							skewMatrix.setElement(row, column, (row == column ? 1.0 : 0.0) + s * translateAxis[row] * rotateAxis[column]);
+					transformationMatrix = transformationMatrix * skewMatrix;
+					break;
+				}
 			}
 
 		}
@@ -11,6 +11,9 @@
 #include "COLLADAFWStableHeaders.h"
 #include "COLLADAFWSkinControllerData.h"
 
+#include <algorithm>
+#include <vector>
+
 
 namespace COLLADAFW
 {
@@ -29,4 +32,86 @@ namespace COLLADAFW
 	{
 	}
 
+	/** A joint influencing a vertex and its weight.*/
+	struct JointInfluence
+	{
+		int jointIndex;
+		double weight;
+	};
+
+	/** Orders influences by descending weight.*/
+	static bool isStrongerInfluence( const JointInfluence& lhs, const JointInfluence& rhs )
+	{
+		return lhs.weight > rhs.weight;
+	}
+
+	//------------------------------
+	bool SkinControllerData::getFixedInfluences( size_t maxInfluences, IntValuesArray& jointIndices, FloatArray& weights ) const
+	{
+		size_t vertexCount = mJointsPerVertex.getCount();
+		size_t valuesCount = vertexCount * maxInfluences;
+		jointIndices.clear();
+		weights.clear();
+		jointIndices.reallocMemory( valuesCount );
+		weights.reallocMemory( valuesCount );
+		jointIndices.setCount( valuesCount );
+		weights.setCount( valuesCount );
+		if ( valuesCount == 0 )
+			return true;
+
+		const FloatArray* floatWeights = mWeights.getFloatValues();
+		const DoubleArray* doubleWeights = mWeights.getDoubleValues();
+		size_t weightsCount = mWeights.getValuesCount();
+		size_t pairCount = std::min( mJointIndices.getCount(), mWeightIndices.getCount() );
+
+		bool success = true;
+		std::vector<JointInfluence> influences;
+		size_t pairIndex = 0;
+		for ( size_t vertex = 0; vertex < vertexCount; ++vertex )
+		{
+			influences.clear();
+			for ( size_t j = 0, jointsCount = mJointsPerVertex[vertex]; j < jointsCount; ++j, ++pairIndex )
+			{
+				if ( pairIndex >= pairCount )
+				{
+					success = false;
+					break;
+				}
+				unsigned int weightIndex = mWeightIndices[pairIndex];
+				if ( weightIndex >= weightsCount )
+				{
+					success = false;
+					continue;
+				}
+				JointInfluence influence;
+				influence.jointIndex = mJointIndices[pairIndex];
+				influence.weight = floatWeights ? (double)(*floatWeights)[weightIndex] : (*doubleWeights)[weightIndex];
+				influences.push_back( influence );
+			}
+
+			size_t keptCount = std::min( influences.size(), maxInfluences );
+			std::stable_sort( influences.begin(), influences.end(), isStrongerInfluence );
+			double weightSum = 0;
+			for ( size_t k = 0; k < keptCount; ++k )
+				weightSum += influences[k].weight;
+
+			int* vertexJointIndices = jointIndices.getData() + vertex * maxInfluences;
+			float* vertexWeights = weights.getData() + vertex * maxInfluences;
+			for ( size_t k = 0; k < maxInfluences; ++k )
+			{
+				if ( k < keptCount )
+				{
+					vertexJointIndices[k] = influences[k].jointIndex;
+					vertexWeights[k] = (float)( (weightSum > 0) ? influences[k].weight / weightSum : influences[k].weight );
+				}
+				else
+				{
+					vertexJointIndices[k] = 0;
+					vertexWeights[k] = 0;
+				}
+			}
+		}
+		return success;
+	}
+
 } // namespace COLLADAFW
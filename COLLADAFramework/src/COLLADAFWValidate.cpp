@@ -52,11 +52,11 @@ namespace COLLADAFW
 			return failure_count;
 
 		// for each key we need an input value
-		if ( animationCurve->getInputValues().getValuesCount() != keyCount ) {
+		if ( animationCurve->getValuesCount( AnimationCurve::INPUT_VALUES ) != keyCount ) {
 			if (verbose)
 				printf("ERROR: [%s] Found %d input values for %d keys\n",
 				animationCurve->getName().c_str(),
-				(int)animationCurve->getInputValues().getValuesCount(),
+				(int)animationCurve->getValuesCount( AnimationCurve::INPUT_VALUES ),
 				(int)keyCount);
 			failure_count +=1;
 		}
@@ -64,7 +64,7 @@ namespace COLLADAFW
 		size_t outValuesCount = dimension * keyCount;
 
 		// Check output values count
-		if ( animationCurve->getOutputValues().getValuesCount() != outValuesCount )
+		if ( animationCurve->getValuesCount( AnimationCurve::OUTPUT_VALUES ) != outValuesCount )
 			failure_count +=1;
 
 		bool needsTangents = ( animationCurve->getInterpolationType() == AnimationCurve::INTERPOLATION_BEZIER ) ||
@@ -116,21 +116,21 @@ namespace COLLADAFW
 		}
 
 		// Check in tangents count
-		if ( animationCurve->getInTangentValues().getValuesCount() != tangentCount ) {
+		if ( animationCurve->getValuesCount( AnimationCurve::IN_TANGENT_VALUES ) != tangentCount ) {
 				if (verbose)
 					printf("ERROR: [%s] Found %d IN tangent values for %d tangents\n",
 					animationCurve->getName().c_str(),
-					(int)animationCurve->getInTangentValues().getValuesCount(),
+					(int)animationCurve->getValuesCount( AnimationCurve::IN_TANGENT_VALUES ),
 					(int)tangentCount);
 			failure_count +=1;
 		}
 
 		// Check out tangents count
-		if ( animationCurve->getOutTangentValues().getValuesCount() != tangentCount ) {
+		if ( animationCurve->getValuesCount( AnimationCurve::OUT_TANGENT_VALUES ) != tangentCount ) {
 				if (verbose)
 					printf("ERROR: [%s] Found %d OUT tangent values for %d tangents\n",
 					animationCurve->getName().c_str(),
-					(int)animationCurve->getOutTangentValues().getValuesCount(),
+					(int)animationCurve->getValuesCount( AnimationCurve::OUT_TANGENT_VALUES ),
 					(int)tangentCount);
 			failure_count +=1;
 		}
@@ -0,0 +1,397 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADAFramework.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADAFWStableHeaders.h"
+#include "COLLADAFWVisualSceneFlattener.h"
+#include "COLLADAFWVisualScene.h"
+#include "COLLADAFWInstanceNode.h"
+
+#include "COLLADABUParallel.h"
+
+#include "Math/COLLADABUMathMatrix4.h"
+
+#include <algorithm>
+
+
+namespace COLLADAFW
+{
+
+	namespace
+	{
+		/** Below these numbers of nodes, the local matrices of all nodes and the world matrices of a level are
+		computed on the calling thread only.*/
+		const size_t MIN_NODES_FOR_CONCURRENT_LOCAL_MATRICES = 1024;
+		const size_t MIN_NODES_FOR_CONCURRENT_WORLD_MATRICES = 16384;
+
+		/** Copies @a matrix to element by element matrices with @a stride values per element.*/
+		void setMatrix( double* matrices, size_t stride, const COLLADABU::Math::Matrix4& matrix )
+		{
+			for ( size_t element = 0; element < VisualSceneFlattener::MATRIX_SIZE; ++element )
+				matrices[element * stride] = matrix.getElement( (int)element );
+		}
+
+		/** Copies element by element matrices with @a stride values per element to @a matrix.*/
+		void getMatrix( const double* matrices, size_t stride, COLLADABU::Math::Matrix4& matrix )
+		{
+			matrix = COLLADABU::Math::Matrix4( matrices[0], matrices[stride], matrices[2 * stride], matrices[3 * stride],
+				matrices[4 * stride], matrices[5 * stride], matrices[6 * stride], matrices[7 * stride],
+				matrices[8 * stride], matrices[9 * stride], matrices[10 * stride], matrices[11 * stride],
+				matrices[12 * stride], matrices[13 * stride], matrices[14 * stride], matrices[15 * stride] );
+		}
+
+		/** Sets the @a count matrices @a target to the products of the matrices @a matrices1 and
+		@a matrices2, all element by element with the given number of values per element. Each element is
+		computed by its own loop over only nine arrays, that can be vectorized.*/
+		void multiplyMatrices( double* target, size_t targetStride,
+			const double* matrices1, size_t stride1,
+			const double* matrices2, size_t stride2,
+			size_t count )
+		{
+			for ( size_t row = 0; row < 4; ++row )
+			{
+				const double* a0 = matrices1 + ( row * 4 ) * stride1;
+				const double* a1 = a0 + stride1;
+				const double* a2 = a1 + stride1;
+				const double* a3 = a2 + stride1;
+				for ( size_t column = 0; column < 4; ++column )
+				{
+					const double* b0 = matrices2 + column * stride2;
+					const double* b1 = b0 + 4 * stride2;
+					const double* b2 = b1 + 4 * stride2;
+					const double* b3 = b2 + 4 * stride2;
+					double* t = target + ( row * 4 + column ) * targetStride;
+					for ( size_t i = 0; i < count; ++i )
+						t[i] = a0[i] * b0[i] + a1[i] * b1[i] + a2[i] * b2[i] + a3[i] * b3[i];
+				}
+			}
+		}
+
+		/** Computes the local matrices of a range of nodes. The matrices of each block are computed to a
+		buffer of the thread first and then copied element by element, such that the matrices are written
+		to contiguous memory.*/
+		class LocalMatricesTask : public COLLADABU::ParallelTask
+		{
+		private:
+			const std::vector<const Node*>& mNodes;
+			double* mLocalMatrices;
+			double* mBlockMatrices;
+
+		public:
+			LocalMatricesTask( const std::vector<const Node*>& nodes, double* localMatrices, double* blockMatrices )
+				: mNodes( nodes )
+				, mLocalMatrices( localMatrices )
+				, mBlockMatrices( blockMatrices )
+			{}
+
+			virtual void execute( size_t begin, size_t end, size_t threadIndex )
+			{
+				const size_t blockSize = VisualSceneFlattener::BLOCK_SIZE;
+				const size_t matrixSize = VisualSceneFlattener::MATRIX_SIZE;
+				double* blockMatrices = mBlockMatrices + threadIndex * matrixSize * blockSize;
+
+				COLLADABU::Math::Matrix4 matrix;
+				for ( size_t blockBegin = begin; blockBegin < end; blockBegin += blockSize )
+				{
+					const size_t count = std::min( blockSize, end - blockBegin );
+					for ( size_t i = 0; i < count; ++i )
+					{
+						mNodes[blockBegin + i]->getTransformationMatrix( matrix );
+						setMatrix( blockMatrices + i, blockSize, matrix );
+					}
+
+					for ( size_t element = 0; element < matrixSize; ++element )
+						std::copy( blockMatrices + element * blockSize, blockMatrices + element * blockSize + count, mLocalMatrices + element * mNodes.size() + blockBegin );
+				}
+			}
+
+		private:
+			/** Disable default assignment operator. */
+			const LocalMatricesTask& operator= ( const LocalMatricesTask& pre );
+		};
+
+		/** Computes the world matrices of a range of the nodes of a level, that is not the first one. The
+		world matrices of the parents of each block are gathered to the buffer of the thread first, such that
+		the products can be computed by a loop over contiguous arrays.*/
+		class WorldMatricesTask : public COLLADABU::ParallelTask
+		{
+		private:
+			const size_t* mParentIndices;
+			const double* mLocalMatrices;
+			double* mWorldMatrices;
+			double* mParentMatrices;
+			size_t mStride;
+			size_t mLevelOffset;
+
+		public:
+			WorldMatricesTask( const size_t* parentIndices,
+				const double* localMatrices,
+				double* worldMatrices,
+				double* parentMatrices,
+				size_t stride,
+				size_t levelOffset )
+				: mParentIndices( parentIndices )
+				, mLocalMatrices( localMatrices )
+				, mWorldMatrices( worldMatrices )
+				, mParentMatrices( parentMatrices )
+				, mStride( stride )
+				, mLevelOffset( levelOffset )
+			{}
+
+			virtual void execute( size_t begin, size_t end, size_t threadIndex )
+			{
+				const size_t blockSize = VisualSceneFlattener::BLOCK_SIZE;
+				double* parentMatrices = mParentMatrices + threadIndex * VisualSceneFlattener::MATRIX_SIZE * blockSize;
+
+				for ( size_t blockBegin = mLevelOffset + begin, levelEnd = mLevelOffset + end; blockBegin < levelEnd; blockBegin += blockSize )
+				{
+					const size_t count = std::min( blockSize, levelEnd - blockBegin );
+					const size_t* parentIndices = mParentIndices + blockBegin;
+
+					for ( size_t element = 0; element < VisualSceneFlattener::MATRIX_SIZE; ++element )
+					{
+						const double* source = mWorldMatrices + element * mStride;
+						double* target = parentMatrices + element * blockSize;
+						for ( size_t i = 0; i < count; ++i )
+							target[i] = source[parentIndices[i]];
+					}
+
+					multiplyMatrices( mWorldMatrices + blockBegin, mStride,
+						parentMatrices, blockSize,
+						mLocalMatrices + blockBegin, mStride,
+						count );
+				}
+			}
+
+		private:
+			/** Disable default assignment operator. */
+			const WorldMatricesTask& operator= ( const WorldMatricesTask& pre );
+		};
+	}
+
+	//------------------------------
+	VisualSceneFlattener::VisualSceneFlattener()
+		: mFirstDirtyLevel( 0 )
+	{
+	}
+
+	//------------------------------
+	VisualSceneFlattener::~VisualSceneFlattener()
+	{
+	}
+
+	//------------------------------
+	void VisualSceneFlattener::addNodes( const NodePointerArray& nodes, UniqueIdNodeMap& uniqueIdNodeMap )
+	{
+		for ( size_t i = 0, count = nodes.getCount(); i < count; ++i )
+		{
+			const Node* node = nodes[i];
+			uniqueIdNodeMap[node->getUniqueId()] = node;
+			addNodes( node->getChildNodes(), uniqueIdNodeMap );
+		}
+	}
+
+	//------------------------------
+	void VisualSceneFlattener::clear()
+	{
+		mNodes.clear();
+		mParentIndices.clear();
+		mLevelOffsets.clear();
+		mNextInstanceIndices.clear();
+		mNodeIndices.clear();
+		mLocalMatrices.clear();
+		mWorldMatrices.clear();
+		mFirstDirtyLevel = 0;
+	}
+
+	//------------------------------
+	void VisualSceneFlattener::addNode( const Node* node, size_t parentIndex )
+	{
+		mNodes.push_back( node );
+		mParentIndices.push_back( parentIndex );
+	}
+
+	//------------------------------
+	bool VisualSceneFlattener::flatten( const VisualScene& visualScene, const UniqueIdNodeMap& instantiableNodes, size_t maxThreadCount )
+	{
+		clear();
+
+		bool allInstancesResolved = true;
+
+		const NodePointerArray& rootNodes = visualScene.getRootNodes();
+		for ( size_t i = 0, count = rootNodes.getCount(); i < count; ++i )
+			addNode( rootNodes[i], NO_NODE );
+
+		// the nodes are appended while they are iterated, each level after the previous one
+		mLevelOffsets.push_back( 0 );
+		size_t levelEnd = mNodes.size();
+		for ( size_t index = 0; index < mNodes.size(); ++index )
+		{
+			if ( index == levelEnd )
+			{
+				mLevelOffsets.push_back( levelEnd );
+				levelEnd = mNodes.size();
+			}
+
+			const Node* node = mNodes[index];
+
+			const NodePointerArray& childNodes = node->getChildNodes();
+			for ( size_t i = 0, count = childNodes.getCount(); i < count; ++i )
+				addNode( childNodes[i], index );
+
+			const InstanceNodePointerArray& instanceNodes = node->getInstanceNodes();
+			for ( size_t i = 0, count = instanceNodes.getCount(); i < count; ++i )
+			{
+				UniqueIdNodeMap::const_iterator it = instantiableNodes.find( instanceNodes[i]->getInstanciatedObjectId() );
+				if ( it == instantiableNodes.end() )
+				{
+					allInstancesResolved = false;
+					continue;
+				}
+
+				// an instance of the node itself or of an ancestor would never end
+				const Node* instantiatedNode = it->second;
+				size_t ancestorIndex = index;
+				while ( ancestorIndex != NO_NODE && mNodes[ancestorIndex] != instantiatedNode )
+					ancestorIndex = mParentIndices[ancestorIndex];
+				if ( ancestorIndex != NO_NODE )
+				{
+					allInstancesResolved = false;
+					continue;
+				}
+
+				addNode( instantiatedNode, index );
+			}
+		}
+		mLevelOffsets.push_back( mNodes.size() );
+		if ( mNodes.empty() )
+			mLevelOffsets.clear();
+
+		// link the instances of each node, in the order of their indices
+		mNodeIndices.resize( mNodes.size() );
+		for ( size_t index = 0; index < mNodes.size(); ++index )
+			mNodeIndices[index] = std::make_pair( mNodes[index], index );
+		std::sort( mNodeIndices.begin(), mNodeIndices.end() );
+
+		mNextInstanceIndices.resize( mNodes.size() );
+		for ( size_t i = 0, count = mNodeIndices.size(); i < count; ++i )
+		{
+			if ( i + 1 < count && mNodeIndices[i + 1].first == mNodeIndices[i].first )
+				mNextInstanceIndices[mNodeIndices[i].second] = mNodeIndices[i + 1].second;
+			else
+				mNextInstanceIndices[mNodeIndices[i].second] = NO_NODE;
+		}
+
+		mLocalMatrices.resize( mNodes.size() * MATRIX_SIZE );
+		mWorldMatrices.resize( mNodes.size() * MATRIX_SIZE );
+		updateLocalMatrices( maxThreadCount );
+		updateWorldMatrices( maxThreadCount );
+
+		return allInstancesResolved;
+	}
+
+	//------------------------------
+	void VisualSceneFlattener::reserveBlockMatrices( size_t threadCount )
+	{
+		const size_t blockMatricesSize = threadCount * MATRIX_SIZE * BLOCK_SIZE;
+		if ( mBlockMatrices.size() < blockMatricesSize )
+			mBlockMatrices.resize( blockMatricesSize );
+	}
+
+	//------------------------------
+	size_t VisualSceneFlattener::getLevel( size_t index ) const
+	{
+		return std::upper_bound( mLevelOffsets.begin(), mLevelOffsets.end(), index ) - mLevelOffsets.begin() - 1;
+	}
+
+	//------------------------------
+	size_t VisualSceneFlattener::findNodeIndex( const Node* node ) const
+	{
+		std::vector<NodeIndex>::const_iterator it = std::lower_bound( mNodeIndices.begin(), mNodeIndices.end(), NodeIndex( node, 0 ) );
+		if ( it == mNodeIndices.end() || it->first != node )
+			return NO_NODE;
+		return it->second;
+	}
+
+	//------------------------------
+	void VisualSceneFlattener::getLocalMatrix( size_t index, COLLADABU::Math::Matrix4& matrix ) const
+	{
+		getMatrix( &mLocalMatrices[index], mNodes.size(), matrix );
+	}
+
+	//------------------------------
+	void VisualSceneFlattener::getWorldMatrix( size_t index, COLLADABU::Math::Matrix4& matrix ) const
+	{
+		getMatrix( &mWorldMatrices[index], mNodes.size(), matrix );
+	}
+
+	//------------------------------
+	void VisualSceneFlattener::setLocalMatrix( size_t index, const COLLADABU::Math::Matrix4& matrix )
+	{
+		setMatrix( &mLocalMatrices[index], mNodes.size(), matrix );
+		mFirstDirtyLevel = std::min( mFirstDirtyLevel, getLevel( index ) );
+	}
+
+	//------------------------------
+	void VisualSceneFlattener::updateLocalMatrices( size_t maxThreadCount )
+	{
+		if ( mNodes.empty() )
+			return;
+
+		const size_t nodesCount = mNodes.size();
+		const size_t threadCount = COLLADABU::getParallelThreadCount( nodesCount,
+			nodesCount < MIN_NODES_FOR_CONCURRENT_LOCAL_MATRICES ? 1 : maxThreadCount,
+			1 );
+		reserveBlockMatrices( threadCount );
+
+		LocalMatricesTask task( mNodes, &mLocalMatrices.front(), &mBlockMatrices.front() );
+		COLLADABU::parallelFor( nodesCount, task, threadCount, 1 );
+
+		mFirstDirtyLevel = 0;
+	}
+
+	//------------------------------
+	void VisualSceneFlattener::updateWorldMatrices( size_t maxThreadCount )
+	{
+		const size_t levelsCount = getLevelsCount();
+		if ( mFirstDirtyLevel >= levelsCount )
+			return;
+
+		const size_t stride = mNodes.size();
+		if ( mFirstDirtyLevel == 0 )
+		{
+			// the world matrices of the root nodes are their local matrices
+			for ( size_t element = 0; element < MATRIX_SIZE; ++element )
+				std::copy( &mLocalMatrices[element * stride], &mLocalMatrices[element * stride] + mLevelOffsets[1], &mWorldMatrices[element * stride] );
+			mFirstDirtyLevel = 1;
+		}
+
+		for ( size_t level = mFirstDirtyLevel; level < levelsCount; ++level )
+		{
+			const size_t levelOffset = mLevelOffsets[level];
+			const size_t levelNodesCount = mLevelOffsets[level + 1] - levelOffset;
+			const size_t threadCount = COLLADABU::getParallelThreadCount( levelNodesCount,
+				levelNodesCount < MIN_NODES_FOR_CONCURRENT_WORLD_MATRICES ? 1 : maxThreadCount,
+				1 );
+
+			reserveBlockMatrices( threadCount );
+
+			WorldMatricesTask task( &mParentIndices.front(),
+				&mLocalMatrices.front(),
+				&mWorldMatrices.front(),
+				&mBlockMatrices.front(),
+				stride,
+				levelOffset );
+			COLLADABU::parallelFor( levelNodesCount, task, threadCount, 1 );
+		}
+
+		mFirstDirtyLevel = levelsCount;
+	}
+
+} // namespace COLLADAFW
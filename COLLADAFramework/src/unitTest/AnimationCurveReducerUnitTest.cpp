@@ -0,0 +1,224 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADAFramework.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADAFWStableHeaders.h"
+#include "AnimationCurveReducerUnitTest.h"
+#include "COLLADAFWAnimationCurveReducer.h"
+#include "COLLADAFWAnimationCurve.h"
+#include "COLLADAFWAnimationSampler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+
+using namespace COLLADAFW;
+
+namespace
+{
+	/** The number of inputs each segment between two keys of the original curve is sampled at, to compare
+	the original and the reduced curve.*/
+	const size_t denseSamplesPerSegment = 64;
+
+	/** The difference allowed between the error reported by the reducer and the error found by the dense
+	sampling, for curves whose error can only be largest at the samples of the reducer.*/
+	const double errorEpsilon = 1e-9;
+
+	const double pi = 3.14159265358979323846;
+
+	size_t errorCount = 0;
+
+	void check( bool condition, const char* test, const char* message )
+	{
+		if ( condition )
+			return;
+		std::cout << "      failed     " << test << ": " << message << std::endl;
+		++errorCount;
+	}
+
+	/** Creates a curve with @a interpolationType, set for the curve and for each key, the keys @a inputs and
+	@a channelsCount outputs per key.*/
+	AnimationCurve* createCurve( AnimationCurve::InterpolationType interpolationType,
+		const std::vector<double>& inputs,
+		const std::vector<double>& outputs,
+		size_t channelsCount )
+	{
+		AnimationCurve* curve = new AnimationCurve( UniqueId( COLLADA_TYPE::ANIMATION, 1, 0 ) );
+		curve->setOutDimension( channelsCount );
+		curve->setInterpolationType( interpolationType );
+		for ( size_t i = 0; i < inputs.size(); ++i )
+			curve->getInterpolationTypes().append( interpolationType );
+
+		FloatOrDoubleArray& inputValues = curve->getInputValues();
+		inputValues.setType( FloatOrDoubleArray::DATA_TYPE_DOUBLE );
+		inputValues.getDoubleValues()->appendValues( &inputs.front(), inputs.size() );
+		FloatOrDoubleArray& outputValues = curve->getOutputValues();
+		outputValues.setType( FloatOrDoubleArray::DATA_TYPE_DOUBLE );
+		outputValues.getDoubleValues()->appendValues( &outputs.front(), outputs.size() );
+		return curve;
+	}
+
+	/** Evaluates @a curve at the inputs @a inputs. Receives the values channel by channel.*/
+	void sampleCurve( const AnimationCurve& curve, const std::vector<double>& inputs, std::vector<double>& values )
+	{
+		AnimationSampler sampler;
+		sampler.setAnimationCurve( curve );
+		values.assign( inputs.size() * sampler.getChannelsCount(), 0.0 );
+		sampler.sample( &inputs.front(), inputs.size(), &values.front(), inputs.size() );
+	}
+
+	/** Reduces the curve with @a interpolationType, @a inputs and @a outputs with @a fitting and
+	@a tolerance, and compares it with the original curve at denseSamplesPerSegment inputs per segment.
+	@param minKeysCount, maxKeysCount The range of the expected number of kept keys.
+	@param errorAtSamples True, if the error of the reduced curve is largest at the samples of the reducer,
+	i.e. if the error found by the dense sampling must equal the reported error. Otherwise the error found by
+	the dense sampling may exceed the reported error by @a maxDenseErrorRatio times the tolerance.*/
+	void testReduction( const char* test,
+		AnimationCurve::InterpolationType interpolationType,
+		AnimationCurveReducer::Fitting fitting,
+		const std::vector<double>& inputs,
+		const std::vector<double>& outputs,
+		size_t channelsCount,
+		double tolerance,
+		size_t minKeysCount,
+		size_t maxKeysCount,
+		bool errorAtSamples,
+		double maxDenseErrorRatio )
+	{
+		AnimationCurve* original = createCurve( interpolationType, inputs, outputs, channelsCount );
+		AnimationCurve* reduced = createCurve( interpolationType, inputs, outputs, channelsCount );
+
+		AnimationCurveReducer reducer( fitting );
+		reducer.setTolerance( tolerance );
+		AnimationCurveReducer::Statistics statistics;
+		check( reducer.reduce( *reduced, &statistics ), test, "the curve could not be reduced" );
+
+		size_t keysCount = reduced->getKeyCount();
+		check( statistics.keysCount == inputs.size(), test, "the original number of keys is wrong" );
+		check( statistics.reducedKeysCount == keysCount, test, "the reported number of kept keys is wrong" );
+		check( (keysCount >= minKeysCount) && (keysCount <= maxKeysCount), test, "unexpected number of kept keys" );
+		check( reduced->getValuesCount( AnimationCurve::OUTPUT_VALUES ) == keysCount * channelsCount, test, "the number of outputs is wrong" );
+		check( statistics.maxError <= tolerance, test, "the reported error exceeds the tolerance" );
+
+		std::vector<double> denseInputs;
+		for ( size_t key = 0; key + 1 < inputs.size(); ++key )
+		{
+			for ( size_t i = 0; i < denseSamplesPerSegment; ++i )
+				denseInputs.push_back( inputs[key] + (inputs[key + 1] - inputs[key]) * i / denseSamplesPerSegment );
+		}
+		denseInputs.push_back( inputs.back() );
+
+		std::vector<double> originalValues;
+		std::vector<double> reducedValues;
+		sampleCurve( *original, denseInputs, originalValues );
+		sampleCurve( *reduced, denseInputs, reducedValues );
+		double denseError = 0.0;
+		for ( size_t i = 0; i < originalValues.size(); ++i )
+			denseError = std::max( denseError, std::abs( originalValues[i] - reducedValues[i] ) );
+
+		if ( errorAtSamples )
+			check( std::abs( denseError - statistics.maxError ) <= errorEpsilon, test, "the reported error differs from the error found by the dense sampling" );
+		else
+			check( denseError <= statistics.maxError + maxDenseErrorRatio * tolerance, test, "the error found by the dense sampling exceeds the reported error" );
+
+		std::cout << "      " << test << ": " << inputs.size() << " -> " << keysCount << " keys, reported error "
+			<< statistics.maxError << ", dense error " << denseError << std::endl;
+
+		delete original;
+		delete reduced;
+	}
+
+	/** A piecewise linear curve with two channels and four corners, baked at 30 keys per unit.*/
+	void testLinear()
+	{
+		std::vector<double> inputs;
+		std::vector<double> outputs;
+		for ( size_t frame = 0; frame <= 90; ++frame )
+		{
+			double input = frame / 30.0;
+			inputs.push_back( input );
+			outputs.push_back( input < 1 ? 2 * input : input < 2 ? 2 - 3 * (input - 1) : -1 + 0.5 * (input - 2) );
+			// a small wiggle below the tolerance, that must not keep keys
+			outputs.push_back( 5.0 + ((frame % 2) ? 0.5e-4 : -0.5e-4) );
+		}
+		testReduction( "linear", AnimationCurve::INTERPOLATION_LINEAR, AnimationCurveReducer::FITTING_LINEAR,
+			inputs, outputs, 2, 1e-4, 4, 4, true, 0 );
+
+		// without tolerance nothing is removed
+		AnimationCurve* curve = createCurve( AnimationCurve::INTERPOLATION_LINEAR, inputs, outputs, 2 );
+		AnimationCurveReducer reducer;
+		AnimationCurveReducer::Statistics statistics;
+		reducer.reduce( *curve, &statistics );
+		check( curve->getKeyCount() == inputs.size(), "linear without tolerance", "keys have been removed" );
+		delete curve;
+	}
+
+	/** A sine baked at 24 keys per period, fitted with Bezier segments. The error between the samples of the
+	reducer is not checked by it, it may exceed the reported error slightly.*/
+	void testBezier()
+	{
+		std::vector<double> inputs;
+		std::vector<double> outputs;
+		for ( size_t frame = 0; frame <= 96; ++frame )
+		{
+			double input = frame / 24.0;
+			inputs.push_back( input );
+			outputs.push_back( sin( 2 * pi * input ) );
+		}
+		testReduction( "bezier", AnimationCurve::INTERPOLATION_LINEAR, AnimationCurveReducer::FITTING_BEZIER,
+			inputs, outputs, 1, 1e-2, 9, 33, false, 0.1 );
+
+		// a spike at a discontinuity, i.e. two keys with the same input, keeps the keys around it
+		std::vector<double> jumpInputs;
+		std::vector<double> jumpOutputs;
+		for ( size_t frame = 0; frame <= 48; ++frame )
+		{
+			jumpInputs.push_back( frame / 24.0 );
+			jumpOutputs.push_back( frame < 24 ? 0.0 : 1.0 );
+			if ( frame == 24 )
+			{
+				jumpInputs.push_back( 1.0 );
+				jumpOutputs.push_back( 3.0 );
+			}
+		}
+		testReduction( "bezier with discontinuity", AnimationCurve::INTERPOLATION_LINEAR, AnimationCurveReducer::FITTING_BEZIER,
+			jumpInputs, jumpOutputs, 1, 1e-3, 6, 6, false, 0.1 );
+	}
+
+	/** A step curve with noise below the tolerance, that changes its value six times, the last time at
+	its last key.*/
+	void testStep()
+	{
+		std::vector<double> inputs;
+		std::vector<double> outputs;
+		for ( size_t frame = 0; frame <= 120; ++frame )
+		{
+			inputs.push_back( frame / 30.0 );
+			outputs.push_back( (double)(frame / 20) + ((frame % 3) * 0.4e-3) );
+		}
+		testReduction( "step", AnimationCurve::INTERPOLATION_STEP, AnimationCurveReducer::FITTING_LINEAR,
+			inputs, outputs, 1, 1e-3, 7, 7, true, 0 );
+	}
+}
+
+//------------------------------
+size_t animationCurveReducerUnitTest()
+{
+	std::cout << "animationCurveReducerUnitTest()" << std::endl;
+
+	errorCount = 0;
+	testLinear();
+	testBezier();
+	testStep();
+
+	std::cout << errorCount << " errors" << std::endl;
+	return errorCount;
+}
@@ -0,0 +1,305 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADAFramework.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADAFWStableHeaders.h"
+#include "MeshDeduplicatorUnitTest.h"
+#include "COLLADAFWMeshDeduplicator.h"
+#include "COLLADAFWMesh.h"
+#include "COLLADAFWTriangles.h"
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+
+using namespace COLLADAFW;
+
+namespace
+{
+	const size_t verticesCount = 40;
+	const size_t trianglesCount = 60;
+
+	/** The largest distance allowed between the positions of a moved copy and the positions of its original,
+	transformed by the transformation found.*/
+	const double maxTransformationError = 1e-4;
+
+	size_t errorCount = 0;
+
+	void check( bool condition, const char* test, const char* message )
+	{
+		if ( condition )
+			return;
+		std::cout << "      failed     " << test << ": " << message << std::endl;
+		++errorCount;
+	}
+
+	/** Returns pseudo random numbers in [-1, 1), the same sequence in each run.*/
+	class RandomNumbers
+	{
+	private:
+		unsigned int mState;
+
+	public:
+		RandomNumbers() : mState(12345) {}
+
+		double next()
+		{
+			mState = mState * 1103515245 + 12345;
+			return (double)((mState >> 8) & 0xffff) / 32768.0 - 1.0;
+		}
+	};
+
+	/** The vertex data and indices of a triangle mesh.*/
+	struct MeshData
+	{
+		std::vector<double> positions;
+		std::vector<double> normals;
+		std::vector<unsigned int> indices;
+	};
+
+	MeshData createMeshData()
+	{
+		RandomNumbers randomNumbers;
+		MeshData meshData;
+		for ( size_t i = 0; i < 3 * verticesCount; ++i )
+			meshData.positions.push_back( randomNumbers.next() );
+		for ( size_t i = 0; i < 3 * verticesCount; ++i )
+			meshData.normals.push_back( randomNumbers.next() );
+		for ( size_t i = 0; i < 3 * trianglesCount; ++i )
+			meshData.indices.push_back( (unsigned int)((randomNumbers.next() + 1) * 0.5 * verticesCount) % verticesCount );
+		return meshData;
+	}
+
+	/** Returns a copy of @a meshData, with the positions rotated by @a rotation (row by row) and translated by
+	@a translation, and the normals rotated.*/
+	MeshData transformMeshData( const MeshData& meshData, const double* rotation, const double* translation )
+	{
+		MeshData transformed = meshData;
+		for ( size_t i = 0; i < verticesCount; ++i )
+		{
+			for ( size_t row = 0; row < 3; ++row )
+			{
+				double position = translation[row];
+				double normal = 0;
+				for ( size_t column = 0; column < 3; ++column )
+				{
+					position += rotation[3 * row + column] * meshData.positions[3 * i + column];
+					normal += rotation[3 * row + column] * meshData.normals[3 * i + column];
+				}
+				transformed.positions[3 * i + row] = position;
+				transformed.normals[3 * i + row] = normal;
+			}
+		}
+		return transformed;
+	}
+
+	/** Returns the rotation by @a angle around the normalized @a axis, row by row.*/
+	void createRotation( const double* axis, double angle, double* rotation )
+	{
+		double c = cos( angle );
+		double s = sin( angle );
+		double t = 1 - c;
+		double x = axis[0], y = axis[1], z = axis[2];
+		double values[9] = { t * x * x + c, t * x * y - s * z, t * x * z + s * y,
+			t * x * y + s * z, t * y * y + c, t * y * z - s * x,
+			t * x * z - s * y, t * y * z + s * x, t * z * z + c };
+		for ( size_t i = 0; i < 9; ++i )
+			rotation[i] = values[i];
+	}
+
+	/** Creates a mesh with unique id @a objectId from @a meshData. The values are stored as floats, like
+	the loader does by default.*/
+	Mesh* createMesh( ObjectId objectId, const MeshData& meshData )
+	{
+		Mesh* mesh = new Mesh( UniqueId( COLLADA_TYPE::GEOMETRY, objectId, 0 ) );
+		std::vector<float> positions( meshData.positions.begin(), meshData.positions.end() );
+		mesh->getPositions().setType( FloatOrDoubleArray::DATA_TYPE_FLOAT );
+		mesh->getPositions().getFloatValues()->appendValues( &positions.front(), positions.size() );
+		std::vector<float> normals( meshData.normals.begin(), meshData.normals.end() );
+		mesh->getNormals().setType( FloatOrDoubleArray::DATA_TYPE_FLOAT );
+		mesh->getNormals().getFloatValues()->appendValues( &normals.front(), normals.size() );
+
+		Triangles* triangles = new Triangles( UniqueId( COLLADA_TYPE::TRIANGLES, objectId, 0 ) );
+		triangles->setFaceCount( meshData.indices.size() / 3 );
+		triangles->getPositionIndices().appendValues( &meshData.indices.front(), meshData.indices.size() );
+		triangles->getNormalIndices().appendValues( &meshData.indices.front(), meshData.indices.size() );
+		mesh->appendPrimitive( triangles );
+		return mesh;
+	}
+
+	/** Adds a mesh created from @a meshData to @a deduplicator and checks, if it is found as a duplicate
+	of the mesh with object id @a originalObjectId, 0 if it must not be a duplicate.
+	@return The duplicate, null if the mesh is not one.*/
+	const MeshDeduplicator::Duplicate* addMesh( MeshDeduplicator& deduplicator,
+		const char* test,
+		ObjectId objectId,
+		const MeshData& meshData,
+		ObjectId originalObjectId )
+	{
+		Mesh* mesh = createMesh( objectId, meshData );
+		bool isDuplicate = deduplicator.addMesh( *mesh );
+		const MeshDeduplicator::Duplicate* duplicate = deduplicator.findDuplicate( mesh->getUniqueId() );
+		delete mesh;
+
+		check( isDuplicate == (duplicate != 0), test, "the result of addMesh does not match findDuplicate" );
+		if ( originalObjectId == 0 )
+		{
+			check( !isDuplicate, test, "the mesh has been found as a duplicate" );
+			return 0;
+		}
+		check( isDuplicate, test, "the mesh has not been found as a duplicate" );
+		if ( !duplicate )
+			return 0;
+		check( duplicate->originalId == UniqueId( COLLADA_TYPE::GEOMETRY, originalObjectId, 0 ), test, "the duplicate refers to the wrong original" );
+		return duplicate;
+	}
+
+	/** Returns the largest distance between the positions of @a transformed and the positions of
+	@a meshData transformed by @a transformation.*/
+	double getTransformationError( const MeshData& meshData, const MeshData& transformed, const COLLADABU::Math::Matrix4& transformation )
+	{
+		double maxError = 0;
+		for ( size_t i = 0; i < verticesCount; ++i )
+		{
+			for ( size_t row = 0; row < 3; ++row )
+			{
+				double position = transformation.getElement( row, 3 );
+				for ( size_t column = 0; column < 3; ++column )
+					position += transformation.getElement( row, column ) * meshData.positions[3 * i + column];
+				maxError = std::max( maxError, fabs( position - transformed.positions[3 * i + row] ) );
+			}
+		}
+		return maxError;
+	}
+
+	void testExact()
+	{
+		MeshDeduplicator deduplicator;
+		MeshData meshData = createMeshData();
+		addMesh( deduplicator, "exact original", 1, meshData, 0 );
+		addMesh( deduplicator, "exact same mesh again", 1, meshData, 0 );
+
+		const MeshDeduplicator::Duplicate* duplicate = addMesh( deduplicator, "exact copy", 2, meshData, 1 );
+		check( duplicate && !duplicate->transformed, "exact copy", "the copy is transformed" );
+
+		MeshData changedPosition = meshData;
+		changedPosition.positions[17] += 1e-6;
+		addMesh( deduplicator, "exact changed position", 3, changedPosition, 0 );
+
+		MeshData changedNormal = meshData;
+		changedNormal.normals[5] = -changedNormal.normals[5];
+		addMesh( deduplicator, "exact changed normal", 4, changedNormal, 0 );
+
+		MeshData changedIndices = meshData;
+		std::swap( changedIndices.indices[0], changedIndices.indices[1] );
+		if ( changedIndices.indices[0] == changedIndices.indices[1] )
+			changedIndices.indices[0] = (changedIndices.indices[0] + 1) % verticesCount;
+		addMesh( deduplicator, "exact changed indices", 5, changedIndices, 0 );
+
+		// a copy of a mesh, that is not the first of its kind, refers to it
+		addMesh( deduplicator, "exact copy of changed position", 6, changedPosition, 3 );
+
+		MeshData moved = meshData;
+		for ( size_t i = 0; i < verticesCount; ++i )
+			moved.positions[3 * i] += 2;
+		addMesh( deduplicator, "exact moved copy", 7, moved, 0 );
+
+		const MeshDeduplicator::Statistics& statistics = deduplicator.getStatistics();
+		check( statistics.meshesCount == 8, "exact statistics", "wrong number of meshes" );
+		check( statistics.duplicatesCount == 2, "exact statistics", "wrong number of duplicates" );
+		check( statistics.transformedDuplicatesCount == 0, "exact statistics", "wrong number of transformed duplicates" );
+		Mesh* mesh = createMesh( 8, meshData );
+		check( statistics.savedBytes == 2 * MeshDeduplicator::getMeshSize( *mesh ), "exact statistics", "wrong number of saved bytes" );
+		delete mesh;
+
+		deduplicator.clear();
+		check( deduplicator.getDuplicates().empty() && (deduplicator.getStatistics().meshesCount == 0), "exact clear", "the duplicates have not been removed" );
+		addMesh( deduplicator, "exact copy after clear", 2, meshData, 0 );
+	}
+
+	void testRigid()
+	{
+		MeshDeduplicator deduplicator;
+		deduplicator.setRigidMatching( true );
+		MeshData meshData = createMeshData();
+		addMesh( deduplicator, "rigid original", 1, meshData, 0 );
+
+		const MeshDeduplicator::Duplicate* duplicate = addMesh( deduplicator, "rigid copy", 2, meshData, 1 );
+		check( duplicate && !duplicate->transformed, "rigid copy", "the copy is transformed" );
+
+		double axis[3] = { 1 / sqrt( 14.0 ), 2 / sqrt( 14.0 ), 3 / sqrt( 14.0 ) };
+		double rotation[9];
+		createRotation( axis, 0.7, rotation );
+		double translation[3] = { 5, -2, 3 };
+		MeshData moved = transformMeshData( meshData, rotation, translation );
+		duplicate = addMesh( deduplicator, "rigid moved copy", 3, moved, 1 );
+		check( duplicate && duplicate->transformed, "rigid moved copy", "the copy is not transformed" );
+		if ( duplicate )
+			check( getTransformationError( meshData, moved, duplicate->transformation ) <= maxTransformationError, "rigid moved copy", "the transformation does not move the original onto the copy" );
+
+		// below the minimum tolerance of rigid matching, the copy is neither changed nor moved
+		MeshData noisy = meshData;
+		for ( size_t i = 0; i < noisy.positions.size(); i += 7 )
+			noisy.positions[i] += 1e-7;
+		duplicate = addMesh( deduplicator, "rigid noisy copy", 4, noisy, 1 );
+		check( duplicate && !duplicate->transformed, "rigid noisy copy", "the copy is transformed" );
+
+		double reflection[9] = { -1, 0, 0, 0, 1, 0, 0, 0, 1 };
+		double noTranslation[3] = { 0, 0, 0 };
+		addMesh( deduplicator, "rigid reflected copy", 5, transformMeshData( meshData, reflection, noTranslation ), 0 );
+
+		double scaling[9] = { 1.5, 0, 0, 0, 1.5, 0, 0, 0, 1.5 };
+		addMesh( deduplicator, "rigid scaled copy", 6, transformMeshData( meshData, scaling, noTranslation ), 0 );
+
+		MeshData unrotatedNormals = moved;
+		unrotatedNormals.normals = meshData.normals;
+		addMesh( deduplicator, "rigid moved copy with unrotated normals", 7, unrotatedNormals, 0 );
+
+		const MeshDeduplicator::Statistics& statistics = deduplicator.getStatistics();
+		check( statistics.duplicatesCount == 3, "rigid statistics", "wrong number of duplicates" );
+		check( statistics.transformedDuplicatesCount == 1, "rigid statistics", "wrong number of transformed duplicates" );
+	}
+
+	void testTolerance()
+	{
+		MeshDeduplicator deduplicator;
+		deduplicator.setPositionTolerance( 1e-3 );
+		MeshData meshData = createMeshData();
+		addMesh( deduplicator, "tolerance original", 1, meshData, 0 );
+
+		MeshData close = meshData;
+		close.positions[10] += 5e-4;
+		const MeshDeduplicator::Duplicate* duplicate = addMesh( deduplicator, "tolerance close copy", 2, close, 1 );
+		check( duplicate && !duplicate->transformed, "tolerance close copy", "the copy is transformed" );
+
+		MeshData far = meshData;
+		far.positions[10] += 5e-3;
+		addMesh( deduplicator, "tolerance far copy", 3, far, 0 );
+
+		// the value tolerance is 0
+		MeshData changedNormal = meshData;
+		changedNormal.normals[10] += 5e-4;
+		addMesh( deduplicator, "tolerance changed normal", 4, changedNormal, 0 );
+	}
+}
+
+//------------------------------
+size_t meshDeduplicatorUnitTest()
+{
+	std::cout << "meshDeduplicatorUnitTest()" << std::endl;
+
+	errorCount = 0;
+	testExact();
+	testRigid();
+	testTolerance();
+
+	std::cout << errorCount << " errors" << std::endl;
+	return errorCount;
+}
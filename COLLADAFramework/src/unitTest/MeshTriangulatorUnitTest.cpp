@@ -0,0 +1,291 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADAFramework.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADAFWStableHeaders.h"
+#include "MeshTriangulatorUnitTest.h"
+#include "COLLADAFWMeshTriangulator.h"
+#include "COLLADAFWMesh.h"
+#include "COLLADAFWPolygons.h"
+#include "COLLADAFWTriangles.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+
+using namespace COLLADAFW;
+
+namespace
+{
+	/** The difference allowed between the summed areas of the triangles and the area of the polygon.*/
+	const double areaEpsilon = 1e-9;
+
+	size_t errorCount = 0;
+
+	void check( bool condition, const char* test, const char* message )
+	{
+		if ( condition )
+			return;
+		std::cout << "      failed     " << test << ": " << message << std::endl;
+		++errorCount;
+	}
+
+	/** A polygon in the xy plane, tilted around the x axis by tiltAngle.*/
+	struct Polygon
+	{
+		/** Two coordinates per position.*/
+		std::vector<double> positions;
+
+		/** The outer boundary followed by the holes, as indices into positions.*/
+		std::vector<unsigned int> positionIndices;
+
+		/** The number of corners of the outer boundary, followed by the negated number of corners of each
+		hole.*/
+		std::vector<int> vertexCounts;
+
+		double tiltAngle;
+
+		Polygon() : tiltAngle(0) {}
+
+		/** Appends a position and returns its index.*/
+		unsigned int addPosition( double x, double y )
+		{
+			positions.push_back( x );
+			positions.push_back( y );
+			return (unsigned int)(positions.size() / 2 - 1);
+		}
+
+		/** Appends a boundary with the corners @a corners, an outer boundary, if it is the first.*/
+		void addBoundary( const unsigned int* corners, size_t cornersCount )
+		{
+			positionIndices.insert( positionIndices.end(), corners, corners + cornersCount );
+			vertexCounts.push_back( vertexCounts.empty() ? (int)cornersCount : -(int)cornersCount );
+		}
+
+		/** Appends a boundary with new positions at @a coordinates, two per corner.*/
+		void addBoundary( const double* coordinates, size_t cornersCount )
+		{
+			std::vector<unsigned int> corners;
+			for ( size_t i = 0; i < cornersCount; ++i )
+				corners.push_back( addPosition( coordinates[2 * i], coordinates[2 * i + 1] ) );
+			addBoundary( &corners.front(), cornersCount );
+		}
+	};
+
+	/** Returns the position with index @a index of @a polygon, tilted.*/
+	void getPosition( const Polygon& polygon, unsigned int index, double* position )
+	{
+		double y = polygon.positions[2 * index + 1];
+		position[0] = polygon.positions[2 * index];
+		position[1] = y * cos( polygon.tiltAngle );
+		position[2] = y * sin( polygon.tiltAngle );
+	}
+
+	/** Returns the normal of the tilted xy plane.*/
+	void getPlaneNormal( const Polygon& polygon, double* normal )
+	{
+		normal[0] = 0;
+		normal[1] = -sin( polygon.tiltAngle );
+		normal[2] = cos( polygon.tiltAngle );
+	}
+
+	/** Returns the area of the triangle with the positions @a index1, @a index2 and @a index3 of
+	@a polygon. Positive, if the triangle is counter clockwise in the tilted xy plane.*/
+	double getSignedArea( const Polygon& polygon, unsigned int index1, unsigned int index2, unsigned int index3 )
+	{
+		double p1[3], p2[3], p3[3];
+		getPosition( polygon, index1, p1 );
+		getPosition( polygon, index2, p2 );
+		getPosition( polygon, index3, p3 );
+		double u[3] = { p2[0] - p1[0], p2[1] - p1[1], p2[2] - p1[2] };
+		double v[3] = { p3[0] - p1[0], p3[1] - p1[1], p3[2] - p1[2] };
+		double cross[3] = { u[1] * v[2] - u[2] * v[1], u[2] * v[0] - u[0] * v[2], u[0] * v[1] - u[1] * v[0] };
+		double normal[3];
+		getPlaneNormal( polygon, normal );
+		return 0.5 * (cross[0] * normal[0] + cross[1] * normal[1] + cross[2] * normal[2]);
+	}
+
+	/** Returns the area enclosed by the boundaries of @a polygon, i.e. the area of the outer boundary minus
+	the areas of the holes. Positive, if the outer boundary is counter clockwise.*/
+	double getPolygonArea( const Polygon& polygon )
+	{
+		// the holes are oriented opposite to the outer boundary, their signed areas are subtracted
+		double area = 0;
+		size_t firstCorner = 0;
+		for ( size_t i = 0; i < polygon.vertexCounts.size(); ++i )
+		{
+			size_t cornersCount = abs( polygon.vertexCounts[i] );
+			const unsigned int* corners = &polygon.positionIndices[firstCorner];
+			for ( size_t j = 1; j + 1 < cornersCount; ++j )
+				area += getSignedArea( polygon, corners[0], corners[j], corners[j + 1] );
+			firstCorner += cornersCount;
+		}
+		return area;
+	}
+
+	/** Triangulates @a polygon and checks, that it is split into @a expectedTrianglesCount triangles, that
+	have the orientation of the outer boundary and whose areas sum up to the area of the polygon.*/
+	void testPolygon( const char* test, const Polygon& polygon, size_t expectedTrianglesCount )
+	{
+		Mesh mesh( UniqueId( COLLADA_TYPE::GEOMETRY, 1, 0 ) );
+		MeshVertexData& positions = mesh.getPositions();
+		positions.setType( FloatOrDoubleArray::DATA_TYPE_DOUBLE );
+		for ( unsigned int i = 0, count = (unsigned int)(polygon.positions.size() / 2); i < count; ++i )
+		{
+			double position[3];
+			getPosition( polygon, i, position );
+			positions.getDoubleValues()->appendValues( position, 3 );
+		}
+
+		Polygons polygons( UniqueId( COLLADA_TYPE::POLYGONS, 1, 0 ) );
+		polygons.setFaceCount( 1 );
+		polygons.getPositionIndices().appendValues( &polygon.positionIndices.front(), polygon.positionIndices.size() );
+		polygons.getGroupedVerticesVertexCountArray().appendValues( &polygon.vertexCounts.front(), polygon.vertexCounts.size() );
+
+		MeshTriangulator triangulator;
+		Triangles triangles( UniqueId( COLLADA_TYPE::TRIANGLES, 1, 0 ) );
+		check( triangulator.triangulate( mesh, polygons, triangles ), test, "polygons are not triangulated" );
+
+		const UIntValuesArray& positionIndices = triangles.getPositionIndices();
+		size_t trianglesCount = positionIndices.getCount() / 3;
+		check( positionIndices.getCount() % 3 == 0, test, "the number of indices is not a multiple of 3" );
+		check( trianglesCount == expectedTrianglesCount, test, "wrong number of triangles" );
+		check( triangles.getFaceCount() == trianglesCount, test, "the face count does not match the indices" );
+
+		double polygonArea = getPolygonArea( polygon );
+		double orientation = polygonArea < 0 ? -1 : 1;
+		double trianglesArea = 0;
+		bool flipped = false;
+		for ( size_t i = 0; i < trianglesCount; ++i )
+		{
+			double area = orientation * getSignedArea( polygon, positionIndices[3 * i], positionIndices[3 * i + 1], positionIndices[3 * i + 2] );
+			flipped |= area < -areaEpsilon;
+			trianglesArea += fabs( area );
+		}
+		check( !flipped, test, "a triangle is flipped" );
+		check( fabs( trianglesArea - fabs( polygonArea ) ) <= areaEpsilon, test, "the areas of the triangles do not sum up to the area of the polygon" );
+	}
+
+	/** Returns @a polygon with all boundaries reversed.*/
+	Polygon reverse( const Polygon& polygon )
+	{
+		Polygon reversed = polygon;
+		size_t firstCorner = 0;
+		for ( size_t i = 0; i < polygon.vertexCounts.size(); ++i )
+		{
+			size_t cornersCount = abs( polygon.vertexCounts[i] );
+			std::reverse( reversed.positionIndices.begin() + firstCorner, reversed.positionIndices.begin() + firstCorner + cornersCount );
+			firstCorner += cornersCount;
+		}
+		return reversed;
+	}
+
+	void testSimplePolygons()
+	{
+		Polygon square;
+		const double squareCoordinates[] = { 0, 0, 2, 0, 2, 2, 0, 2 };
+		square.addBoundary( squareCoordinates, 4 );
+		testPolygon( "convex square", square, 2 );
+
+		Polygon l;
+		const double lCoordinates[] = { 0, 0, 2, 0, 2, 1, 1, 1, 1, 2, 0, 2 };
+		l.addBoundary( lCoordinates, 6 );
+		testPolygon( "concave", l, 4 );
+		testPolygon( "clockwise concave", reverse( l ), 4 );
+
+		Polygon tilted = l;
+		tilted.tiltAngle = 1.2;
+		testPolygon( "tilted concave", tilted, 4 );
+
+		// a comb with three teeth
+		Polygon comb;
+		const double combCoordinates[] = { 0, 0, 5, 0, 5, 3, 4, 3, 4, 1, 3, 1, 3, 3, 2, 3, 2, 1, 1, 1, 1, 3, 0, 3 };
+		comb.addBoundary( combCoordinates, 12 );
+		testPolygon( "comb", comb, 10 );
+		testPolygon( "clockwise comb", reverse( comb ), 10 );
+	}
+
+	void testCollinearAndDuplicateCorners()
+	{
+		// concave, with corners in the middle of the edges and three collinear corners at the notch
+		Polygon collinear;
+		const double collinearCoordinates[] = { 0, 0, 1, 0, 2, 0, 2, 1, 1.5, 1, 1, 1, 1, 2, 0, 2, 0, 1 };
+		collinear.addBoundary( collinearCoordinates, 9 );
+		testPolygon( "collinear corners", collinear, 7 );
+		testPolygon( "clockwise collinear corners", reverse( collinear ), 7 );
+
+		// a corner repeated with the same position index and with a different index at the same position. The
+		// repeated corners are dropped without a triangle, leaving the six corners of the L
+		Polygon duplicate;
+		unsigned int p0 = duplicate.addPosition( 0, 0 );
+		unsigned int p1 = duplicate.addPosition( 2, 0 );
+		unsigned int p2 = duplicate.addPosition( 2, 1 );
+		unsigned int p3 = duplicate.addPosition( 1, 1 );
+		unsigned int p3Copy = duplicate.addPosition( 1, 1 );
+		unsigned int p4 = duplicate.addPosition( 1, 2 );
+		unsigned int p5 = duplicate.addPosition( 0, 2 );
+		const unsigned int duplicateCorners[] = { p0, p1, p1, p2, p3, p3Copy, p4, p5 };
+		duplicate.addBoundary( duplicateCorners, 8 );
+		testPolygon( "duplicate corners", duplicate, 4 );
+		testPolygon( "clockwise duplicate corners", reverse( duplicate ), 4 );
+	}
+
+	void testHoles()
+	{
+		const double outerCoordinates[] = { 0, 0, 4, 0, 4, 4, 0, 4 };
+		const double holeCoordinates[] = { 1, 1, 1, 3, 3, 3, 3, 1 };
+		Polygon hole;
+		hole.addBoundary( outerCoordinates, 4 );
+		hole.addBoundary( holeCoordinates, 4 );
+		testPolygon( "hole", hole, 8 );
+		testPolygon( "clockwise with hole", reverse( hole ), 8 );
+
+		const double secondHoleCoordinates[] = { 3.5, 0.5, 3.2, 0.5, 3.5, 0.8 };
+		Polygon holes = hole;
+		holes.addBoundary( secondHoleCoordinates, 3 );
+		testPolygon( "two holes", holes, 13 );
+
+		// a hole with a corner on an edge of the outer boundary
+		Polygon touchingEdge;
+		touchingEdge.addBoundary( outerCoordinates, 4 );
+		const double touchingEdgeCoordinates[] = { 0, 2, 1, 3, 1, 1 };
+		touchingEdge.addBoundary( touchingEdgeCoordinates, 3 );
+		testPolygon( "hole touching an edge", touchingEdge, 7 );
+		testPolygon( "clockwise with hole touching an edge", reverse( touchingEdge ), 7 );
+
+		// a hole sharing a corner with the outer boundary. It is linked through the shared corner, which then
+		// occurs twice on the linked boundary of seven corners
+		Polygon touchingCorner;
+		touchingCorner.addBoundary( outerCoordinates, 4 );
+		unsigned int holeCorners[] = { 0, touchingCorner.addPosition( 1, 2 ), touchingCorner.addPosition( 2, 1 ) };
+		touchingCorner.addBoundary( holeCorners, 3 );
+		testPolygon( "hole touching a corner", touchingCorner, 5 );
+		testPolygon( "clockwise with hole touching a corner", reverse( touchingCorner ), 5 );
+
+		Polygon tilted = holes;
+		tilted.tiltAngle = -2.5;
+		testPolygon( "tilted with holes", tilted, 13 );
+	}
+}
+
+//------------------------------
+size_t meshTriangulatorUnitTest()
+{
+	std::cout << "meshTriangulatorUnitTest()" << std::endl;
+
+	errorCount = 0;
+	testSimplePolygons();
+	testCollinearAndDuplicateCorners();
+	testHoles();
+
+	std::cout << errorCount << " errors" << std::endl;
+	return errorCount;
+}
@@ -0,0 +1,23 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADAFramework.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "AnimationCurveReducerUnitTest.h"
+#include "MeshDeduplicatorUnitTest.h"
+#include "MeshTriangulatorUnitTest.h"
+
+
+int main()
+{
+	size_t errorCount = animationCurveReducerUnitTest();
+	errorCount += meshDeduplicatorUnitTest();
+	errorCount += meshTriangulatorUnitTest();
+
+	return errorCount == 0 ? 0 : 1;
+}
@@ -0,0 +1,105 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADASAXFWL_ANIMATIONSIDADDRESSBINDINGSPILLFILE_H__
+#define __COLLADASAXFWL_ANIMATIONSIDADDRESSBINDINGSPILLFILE_H__
+
+#include "COLLADASaxFWLPrerequisites.h"
+#include "COLLADASaxFWLLoader.h"
+
+#include <cstdio>
+
+
+namespace COLLADASaxFWL
+{
+
+    /** Temporary file, animation sid address bindings are moved to, if the loader exceeds its memory budget.
+	The bindings are read back in the order they have been written, when the animation lists are created. The
+	file is deleted, when the object is destroyed.*/
+	class AnimationSidAddressBindingSpillFile
+	{
+	private:
+		/** The temporary file. Null, if nothing has been written yet or the file could not be created.*/
+		FILE* mFile;
+
+		/** The number of bindings written to the file.*/
+		size_t mBindingsCount;
+
+		/** The number of bindings read from the file since the last call of startReading().*/
+		size_t mReadBindingsCount;
+
+		/** The number of bytes of the bindings written to the file. Bytes of bindings that could not be written
+		completely are not counted.*/
+		size_t mBytesCount;
+
+		/** True, if a call of write() failed. All further calls fail as well.*/
+		bool mWriteFailed;
+
+	public:
+
+        /** Constructor. */
+		AnimationSidAddressBindingSpillFile();
+
+        /** Destructor. Deletes the file.*/
+		virtual ~AnimationSidAddressBindingSpillFile();
+
+		/** Appends @a bindings to the file. Either all or none of the bindings are appended. Must not be called
+		after startReading().
+		@return True on success, false if the file could not be created or written or a previous call of 
+		write() failed.*/
+		bool write( const Loader::AnimationSidAddressBindingList& bindings );
+
+		/** Prepares reading the bindings, starting with the first one written.
+		@return True on success, false otherwise.*/
+		bool startReading();
+
+		/** Reads up to @a maxCount bindings and appends them to @a bindings.
+		@return True on success, false if the file could not be read.*/
+		bool read( size_t maxCount, Loader::AnimationSidAddressBindingList& bindings );
+
+		/** Returns the number of bindings written to the file.*/
+		size_t getBindingsCount() const { return mBindingsCount; }
+
+		/** Returns the number of bytes written to the file.*/
+		size_t getBytesCount() const { return mBytesCount; }
+
+	private:
+
+        /** Disable default copy ctor. */
+		AnimationSidAddressBindingSpillFile( const AnimationSidAddressBindingSpillFile& pre );
+
+        /** Disable default assignment operator. */
+		const AnimationSidAddressBindingSpillFile& operator= ( const AnimationSidAddressBindingSpillFile& pre );
+
+		/** Writes the @a size bytes at @a data.*/
+		bool writeBytes( const void* data, size_t size );
+
+		/** Writes @a value.*/
+		bool writeNumber( unsigned long long value ) { return writeBytes( &value, sizeof(value) ); }
+
+		/** Writes the length of @a string followed by its characters.*/
+		bool writeString( const String& string );
+
+		/** Reads @a size bytes to @a data.*/
+		bool readBytes( void* data, size_t size );
+
+		/** Reads a value written by writeNumber().*/
+		bool readNumber( unsigned long long& value );
+
+		/** Reads a value written by writeNumber() and converts it to size_t.*/
+		bool readSize( size_t& value );
+
+		/** Reads a string written by writeString().*/
+		bool readString( String& string );
+	};
+
+} // namespace COLLADASAXFWL
+
+#endif // __COLLADASAXFWL_ANIMATIONSIDADDRESSBINDINGSPILLFILE_H__
@@ -0,0 +1,133 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADASAXFWL_ASYNCWRITER_H__
+#define __COLLADASAXFWL_ASYNCWRITER_H__
+
+#include "COLLADASaxFWLPrerequisites.h"
+#include "COLLADASaxFWLBinaryCacheFormat.h"
+
+#include "COLLADAFWIWriter.h"
+
+
+namespace COLLADASaxFWL
+{
+	class WriterQueue;
+
+    /** Writer that passes the objects it receives to another writer on worker threads, so a slow writer
+	and the parsing of the document overlap instead of waiting for each other.
+
+	Since the loader deletes each object after the write call, the object is stored with
+	BinaryCacheWriter::storeObject() and the stored object is queued. A worker thread restores it and
+	passes it to the writer. The queue is bounded by the bytes of the stored objects. If it is full, the
+	loader waits until the workers have caught up, so the memory used stays bounded however slow the
+	writer is.
+
+	With one worker thread, the writer receives the objects in the order of the load. With more threads,
+	the writer is called concurrently and the objects may be written out of order, so the writer must be
+	thread safe.
+
+	Assets, images and materials are written synchronously, since the loader aborts if the writer fails to
+	write them. Objects that can not be stored, see BinaryCacheWriter, are written synchronously as well.
+	Before a synchronous write, the queue is drained and the writer is called on the thread of the loader.
+	The results of the other objects are not returned to the loader, getSuccess() tells if the writer failed
+	to write any of them. The queue is a WriterQueue.
+
+	start(), finish() and cancel() are passed to the writer on the thread of the loader, while no worker
+	calls the writer. finish() waits until all queued objects have been written. cancel() drops the queued
+	objects and waits for the objects being written.*/
+	class AsyncWriter : public COLLADAFW::IWriter
+	{
+	public:
+		/** The default maximum number of bytes of the queued objects.*/
+		static const size_t DEFAULT_MAX_QUEUED_BYTES = 64 * 1024 * 1024;
+
+	private:
+		/** The queue of the objects and the worker threads.*/
+		WriterQueue* mQueue;
+
+	public:
+
+        /** Constructor. Starts the worker threads.
+		@param writer The writer the objects are passed to.
+		@param threadCount The number of worker threads. If greater than 1, the writer must be thread safe.
+		@param maxQueuedBytes The maximum number of bytes of the queued objects. A single object larger than
+		this is queued nevertheless.*/
+		AsyncWriter( COLLADAFW::IWriter* writer, size_t threadCount = 1, size_t maxQueuedBytes = DEFAULT_MAX_QUEUED_BYTES );
+
+        /** Destructor. Drops the queued objects and stops the worker threads.*/
+		virtual ~AsyncWriter();
+
+		/** Returns the number of objects queued or being written.*/
+		size_t getPendingCount() const;
+
+		/** Returns false, if the writer failed to write an object written asynchronously since start().
+		Valid after finish().*/
+		bool getSuccess() const;
+
+		/** Returns the type of the first object the writer failed to write asynchronously since start().
+		Valid only, if getSuccess() returns false.*/
+		BinaryCacheFormat::RecordType getFirstFailedRecordType() const;
+
+		/** Drops the queued objects, waits for the objects being written and cancels the writer.*/
+		virtual void cancel( const String& errorMessage );
+
+		/** Starts the writer.*/
+		virtual void start();
+
+		/** Waits until all queued objects have been written and finishes the writer.*/
+		virtual void finish();
+
+		virtual bool writeGlobalAsset( const COLLADAFW::FileInfo* asset );
+
+		virtual bool writeScene( const COLLADAFW::Scene* scene );
+
+		virtual bool writeVisualScene( const COLLADAFW::VisualScene* visualScene );
+
+		virtual bool writeLibraryNodes( const COLLADAFW::LibraryNodes* libraryNodes );
+
+		virtual bool writeGeometry( const COLLADAFW::Geometry* geometry );
+
+		virtual bool writeMaterial( const COLLADAFW::Material* material );
+
+		virtual bool writeEffect( const COLLADAFW::Effect* effect );
+
+		virtual bool writeCamera( const COLLADAFW::Camera* camera );
+
+		virtual bool writeImage( const COLLADAFW::Image* image );
+
+		virtual bool writeLight( const COLLADAFW::Light* light );
+
+		virtual bool writeAnimation( const COLLADAFW::Animation* animation );
+
+		virtual bool writeAnimationList( const COLLADAFW::AnimationList* animationList );
+
+		virtual bool writeAnimationClip( const COLLADAFW::AnimationClip* animationClip );
+
+		virtual bool writeSkinControllerData( const COLLADAFW::SkinControllerData* skinControllerData );
+
+		virtual bool writeController( const COLLADAFW::Controller* controller );
+
+		virtual bool writeFormulas( const COLLADAFW::Formulas* formulas );
+
+		virtual bool writeKinematicsScene( const COLLADAFW::KinematicsScene* kinematicsScene );
+
+	private:
+
+        /** Disable default copy ctor. */
+		AsyncWriter( const AsyncWriter& pre );
+
+        /** Disable default assignment operator. */
+		const AsyncWriter& operator= ( const AsyncWriter& pre );
+	};
+
+} // namespace COLLADASAXFWL
+
+#endif // __COLLADASAXFWL_ASYNCWRITER_H__
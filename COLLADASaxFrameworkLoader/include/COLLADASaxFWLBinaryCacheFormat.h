@@ -0,0 +1,100 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADASAXFWL_BINARYCACHEFORMAT_H__
+#define __COLLADASAXFWL_BINARYCACHEFORMAT_H__
+
+#include "COLLADASaxFWLPrerequisites.h"
+
+
+namespace COLLADASaxFWL
+{
+
+    /** The layout of the binary cache files written by BinaryCacheWriter and read by BinaryCacheLoader.
+
+	A cache file starts with a header:
+	- the 8 characters of MAGIC
+	- VERSION, BYTE_ORDER_MARK and ALIGNMENT as 32 bit unsigned integers, followed by 4 reserved bytes
+	- the source key, see BinaryCacheWriter::setSourceKey(), as string
+
+	The header is followed by the records, one for each object passed to the writer, in the order of the
+	write calls, and an END record. Each record starts with its RecordType and 4 reserved bytes, both 32 bit,
+	and the 64 bit size of its payload. Records start at offsets that are multiples of ALIGNMENT.
+
+	Numbers are stored in the byte order of the machine that wrote the file, as 32 bit unsigned integers for
+	enums, flags and 32 bit values, and as 64 bit values for counts, ids and doubles. Strings are stored as
+	their 64 bit length followed by their characters. Arrays of numbers are stored as their 64 bit element
+	count, followed by the elements, starting at the next offset that is a multiple of ALIGNMENT. The values
+	of meshes, splines, animation curves and skin controller data can therefore be used in place, if the file
+	is mapped into memory.
+
+	MathML nodes of formulas are stored as a flag telling whether the node exists, followed by its NodeType
+	and its contents. Fragment expressions, that refer to the ast of a formula without owning it, store the
+	indices of the formula and of the ast. Joint primitives referenced by axis infos are stored as their
+	index among the joint primitives of all kinematics models of the kinematics scene.
+
+	Files written by other versions or on machines of another byte order are not read.*/
+	class BinaryCacheFormat
+	{
+	public:
+		/** The first bytes of a cache file.*/
+		static const char MAGIC[8];
+
+		/** The version of the format. Incremented on each change of the layout of any record.*/
+		static const unsigned int VERSION;
+
+		/** Written as 32 bit unsigned integer, to detect files of another byte order.*/
+		static const unsigned int BYTE_ORDER_MARK;
+
+		/** The alignment of records and arrays, in bytes, relative to the start of the file.*/
+		static const unsigned int ALIGNMENT;
+
+		/** The number of bytes of the header preceding the source key.*/
+		static const size_t HEADER_SIZE;
+
+		/** The number of bytes preceding the payload of a record.*/
+		static const size_t RECORD_HEADER_SIZE;
+
+		/** The types of the records, one for each write method of COLLADAFW::IWriter.*/
+		enum RecordType
+		{
+			RECORD_END = 0,
+			RECORD_GLOBAL_ASSET,
+			RECORD_SCENE,
+			RECORD_VISUAL_SCENE,
+			RECORD_LIBRARY_NODES,
+			RECORD_GEOMETRY,
+			RECORD_MATERIAL,
+			RECORD_EFFECT,
+			RECORD_CAMERA,
+			RECORD_IMAGE,
+			RECORD_LIGHT,
+			RECORD_ANIMATION,
+			RECORD_ANIMATION_LIST,
+			RECORD_ANIMATION_CLIP,
+			RECORD_SKIN_CONTROLLER_DATA,
+			RECORD_CONTROLLER,
+			RECORD_FORMULAS,
+			RECORD_KINEMATICS_SCENE,
+			RECORD_TYPE_COUNT
+		};
+
+		/** Returns the number of padding bytes required after @a offset, to reach a multiple of ALIGNMENT.*/
+		static size_t getPadding( size_t offset ) { return (ALIGNMENT - offset % ALIGNMENT) % ALIGNMENT; }
+
+	private:
+
+        /** Disable default ctor. */
+		BinaryCacheFormat();
+	};
+
+} // namespace COLLADASAXFWL
+
+#endif // __COLLADASAXFWL_BINARYCACHEFORMAT_H__
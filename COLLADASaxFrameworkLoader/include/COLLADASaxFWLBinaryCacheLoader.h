@@ -0,0 +1,157 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADASAXFWL_BINARYCACHELOADER_H__
+#define __COLLADASAXFWL_BINARYCACHELOADER_H__
+
+#include "COLLADASaxFWLPrerequisites.h"
+#include "COLLADASaxFWLBinaryCacheFormat.h"
+
+#include "COLLADAFWILoader.h"
+
+#include <vector>
+
+
+namespace COLLADAFW
+{
+	class VisualScene;
+	class LibraryNodes;
+	class Effect;
+	class Camera;
+	class Light;
+}
+
+namespace COLLADASaxFWL
+{
+
+    /** Loader that replays a binary cache file written by BinaryCacheWriter to a writer. The writer receives
+	the same objects in the same order as from the load that wrote the file, without the document being
+	parsed.
+
+	The header of the file is checked before the writer is called. If the file does not exist, has been
+	written by another version or on a machine of another byte order, or does not match the required source
+	key, loadDocument() returns false without calling the writer, so the document can be loaded with Loader
+	instead. If the file turns out to be corrupt while it is replayed, the writer is cancelled.
+
+	The objects can be replayed in another order than they have been written, or only some of them, see
+	setRecordTypes().*/
+	class BinaryCacheLoader : public COLLADAFW::ILoader
+	{
+	public:
+		typedef std::vector<BinaryCacheFormat::RecordType> RecordTypeList;
+
+	private:
+		/** The source key the file must have been written with. Empty, if any key is accepted.*/
+		String mRequiredSourceKey;
+
+		/** The reason why the last load failed. Empty, if it succeeded.*/
+		String mErrorMessage;
+
+		/** The types of the records to replay, in the order to replay them. Empty, to replay all records in
+		the order of the file.*/
+		RecordTypeList mRecordTypes;
+
+	public:
+
+        /** Constructor. */
+		BinaryCacheLoader();
+
+        /** Destructor. */
+		virtual ~BinaryCacheLoader();
+
+		/** Sets the source key the file must have been written with, see BinaryCacheWriter::setSourceKey().
+		Empty, if any key is accepted.*/
+		void setRequiredSourceKey( const String& requiredSourceKey ) { mRequiredSourceKey = requiredSourceKey; }
+
+		/** Returns the source key the file must have been written with.*/
+		const String& getRequiredSourceKey() const { return mRequiredSourceKey; }
+
+		/** Returns the reason why the last load failed. Empty, if it succeeded.*/
+		const String& getErrorMessage() const { return mErrorMessage; }
+
+		/** Sets the types of the records to replay. The records of a type are replayed after all records of
+		the types preceding it in @a recordTypes, in the order they have been written. Records of types not
+		in @a recordTypes are skipped. Each type should be listed once. If @a recordTypes is empty, all
+		records are replayed in the order they have been written, which is the default.
+
+		E.g. to pass the scene graph and the materials to a writer before the geometries, list
+		RECORD_VISUAL_SCENE, RECORD_LIBRARY_NODES, RECORD_MATERIAL and RECORD_EFFECT before RECORD_GEOMETRY.*/
+		void setRecordTypes( const RecordTypeList& recordTypes ) { mRecordTypes = recordTypes; }
+
+		/** Returns the types of the records to replay.*/
+		const RecordTypeList& getRecordTypes() const { return mRecordTypes; }
+
+		/** Replays the cache file @a fileName to @a writer, starting and finishing it. The file is mapped into
+		memory, if possible, otherwise it is read.
+		@return True, if the file has been replayed, false otherwise.*/
+		virtual bool loadDocument( const String& fileName, COLLADAFW::IWriter* writer );
+
+		/** Replays the contents of a cache file in @a buffer to @a writer. Like Loader::loadDocument() for
+		buffers, the writer is finished but not started. @a uri is not used.
+		@return True, if the buffer has been replayed, false otherwise.*/
+		virtual bool loadDocument( const String& uri, const char* buffer, int length, COLLADAFW::IWriter* writer );
+
+		/** Replays the contents of a cache file of @a size bytes at @a content to @a writer, starting and
+		finishing it.
+		@return True, if the contents have been replayed, false otherwise.*/
+		bool loadContent( const char* content, size_t size, COLLADAFW::IWriter* writer );
+
+		/** Restores the object stored in @a payload by BinaryCacheWriter::storeObject(), as the @a size bytes
+		payload of a record of type @a recordType, passes it to the write method of @a writer for its type and
+		deletes it.
+		@param writerSuccess Set to the result of the write method.
+		@return False, if the payload is corrupt.*/
+		static bool loadPayload( BinaryCacheFormat::RecordType recordType, const char* payload, size_t size,
+			COLLADAFW::IWriter* writer, bool& writerSuccess );
+
+		/** Restores the visual scene stored in @a payload by BinaryCacheWriter::storeObject(), as the @a size 
+		bytes payload of a record. Unlike the objects passed to the writer by loadPayload(), the restored 
+		object does not refer to @a payload and is owned by the caller.
+		@param visualScene Set to the restored object, or null if the payload is corrupt.
+		@return False, if the payload is corrupt.*/
+		static bool restoreObject( const char* payload, size_t size, COLLADAFW::VisualScene*& visualScene );
+
+		/** Restores library nodes, like restoreObject( const char*, size_t, COLLADAFW::VisualScene*& ).*/
+		static bool restoreObject( const char* payload, size_t size, COLLADAFW::LibraryNodes*& libraryNodes );
+
+		/** Restores an effect, like restoreObject( const char*, size_t, COLLADAFW::VisualScene*& ).*/
+		static bool restoreObject( const char* payload, size_t size, COLLADAFW::Effect*& effect );
+
+		/** Restores a camera, like restoreObject( const char*, size_t, COLLADAFW::VisualScene*& ).*/
+		static bool restoreObject( const char* payload, size_t size, COLLADAFW::Camera*& camera );
+
+		/** Restores a light, like restoreObject( const char*, size_t, COLLADAFW::VisualScene*& ).*/
+		static bool restoreObject( const char* payload, size_t size, COLLADAFW::Light*& light );
+
+	private:
+
+        /** Disable default copy ctor. */
+		BinaryCacheLoader( const BinaryCacheLoader& pre );
+
+        /** Disable default assignment operator. */
+		const BinaryCacheLoader& operator= ( const BinaryCacheLoader& pre );
+
+		/** Checks the header of the @a size bytes at @a data and returns the offset of the first record.
+		Returns 0 and sets the error message, if the header does not match.*/
+		size_t checkHeader( const char* data, size_t size );
+
+		/** Replays the records starting at @a offset of the @a size bytes at @a data to @a writer and
+		finishes it.*/
+		bool replayRecords( const char* data, size_t size, size_t offset, COLLADAFW::IWriter* writer );
+
+		/** Replays the record at @a offset of @a data to @a writer. Sets @a abortLoading, if the writer
+		failed to write an object that aborts the load.
+		@return False, if the record is corrupt.*/
+		bool replayRecord( const char* data, size_t offset, COLLADAFW::IWriter* writer, bool& abortLoading );
+	};
+
+} // namespace COLLADASAXFWL
+
+#endif // __COLLADASAXFWL_BINARYCACHELOADER_H__
@@ -0,0 +1,210 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADASAXFWL_BINARYCACHEWRITER_H__
+#define __COLLADASAXFWL_BINARYCACHEWRITER_H__
+
+#include "COLLADASaxFWLPrerequisites.h"
+
+#include "COLLADAFWIWriter.h"
+
+#include <vector>
+#include <cstdio>
+
+
+namespace COLLADASaxFWL
+{
+
+    /** Writer that stores all objects it receives in a binary cache file, see BinaryCacheFormat, and passes
+	them on to another writer. A BinaryCacheLoader replays the file to any writer, as if the document had
+	been loaded again with the same loader and options, without parsing it.
+
+	The file is written to a temporary file next to it, that replaces the cache file in finish(). If the
+	load is cancelled or an object can not be stored, the temporary file is removed and an existing cache
+	file is kept. If the file name is empty, the file is kept in memory instead, see getContent(). Objects that
+	can not be stored are convex meshes, animations other than curves, formulas with user defined MathML nodes
+	or fragments that can not be restored, and kinematics scenes with axis infos of joint primitives not in
+	their kinematics models. The loader creates no convex meshes and no formula animations. The calls of the
+	extra data callback handlers of the loader are not stored.*/
+	class BinaryCacheWriter : public COLLADAFW::IWriter
+	{
+	private:
+		/** The path of the cache file. Empty, if the file is kept in memory.*/
+		String mFileName;
+
+		/** The path of the temporary file written until finish().*/
+		String mTemporaryFileName;
+
+		/** The key of the source stored in the file.*/
+		String mSourceKey;
+
+		/** The writer all objects are passed to. Might be null.*/
+		COLLADAFW::IWriter* mWriter;
+
+		/** The temporary file. Null, if the file is not written or kept in memory.*/
+		FILE* mFile;
+
+		/** The contents of the file, if it is kept in memory.*/
+		std::vector<char> mContent;
+
+		/** True, while the file is written.*/
+		bool mWriting;
+
+		/** The number of bytes written to the file.*/
+		size_t mFileSize;
+
+		/** The payload of the record being written.*/
+		std::vector<char> mRecord;
+
+		/** The reason why the file has not been written. Empty, if no error occurred.*/
+		String mErrorMessage;
+
+		/** True, if the cache file has been written by the last finish().*/
+		bool mCacheWritten;
+
+	public:
+
+        /** Constructor.
+		@param fileName The path of the cache file to write. Empty, to keep the file in memory.
+		@param writer The writer all objects are passed to. Might be null, if the objects are only
+		stored.*/
+		BinaryCacheWriter( const String& fileName, COLLADAFW::IWriter* writer = 0 );
+
+        /** Destructor. Removes the temporary file, if finish() has not been called.*/
+		virtual ~BinaryCacheWriter();
+
+		/** Returns the path of the cache file.*/
+		const String& getFileName() const { return mFileName; }
+
+		/** Sets the key of the source of the objects, stored in the file. A BinaryCacheLoader only replays
+		files with the key it requires. The key should identify the document and everything that changes the
+		objects written by the loader, e.g. as created by DocumentCache::createKey() from the uri, the
+		modification time and size of the document and the options of the loader.*/
+		void setSourceKey( const String& sourceKey ) { mSourceKey = sourceKey; }
+
+		/** Returns the key of the source of the objects.*/
+		const String& getSourceKey() const { return mSourceKey; }
+
+		/** Returns true, if the cache file has been written by the last load.*/
+		bool isCacheWritten() const { return mCacheWritten; }
+
+		/** Returns the contents of the file, if it is kept in memory and has been written by the last load.
+		Empty otherwise.*/
+		const std::vector<char>& getContent() const { return mContent; }
+
+		/** Returns the reason why the cache file has not been written. Empty, if it has been written or the
+		load has not finished yet.*/
+		const String& getErrorMessage() const { return mErrorMessage; }
+
+		/** Stores @a asset in @a payload, as the payload of its record in a cache file. The other overloads
+		store the objects passed to the other write methods. BinaryCacheLoader::loadPayload() restores the
+		object, e.g. to pass a copy of an object to another thread without copying it member by member.
+		@return False, if the object can not be stored.*/
+		static bool storeObject( const COLLADAFW::FileInfo& asset, std::vector<char>& payload );
+
+		static bool storeObject( const COLLADAFW::Scene& scene, std::vector<char>& payload );
+
+		static bool storeObject( const COLLADAFW::VisualScene& visualScene, std::vector<char>& payload );
+
+		static bool storeObject( const COLLADAFW::LibraryNodes& libraryNodes, std::vector<char>& payload );
+
+		static bool storeObject( const COLLADAFW::Geometry& geometry, std::vector<char>& payload );
+
+		static bool storeObject( const COLLADAFW::Material& material, std::vector<char>& payload );
+
+		static bool storeObject( const COLLADAFW::Effect& effect, std::vector<char>& payload );
+
+		static bool storeObject( const COLLADAFW::Camera& camera, std::vector<char>& payload );
+
+		static bool storeObject( const COLLADAFW::Image& image, std::vector<char>& payload );
+
+		static bool storeObject( const COLLADAFW::Light& light, std::vector<char>& payload );
+
+		static bool storeObject( const COLLADAFW::Animation& animation, std::vector<char>& payload );
+
+		static bool storeObject( const COLLADAFW::AnimationList& animationList, std::vector<char>& payload );
+
+		static bool storeObject( const COLLADAFW::AnimationClip& animationClip, std::vector<char>& payload );
+
+		static bool storeObject( const COLLADAFW::SkinControllerData& skinControllerData, std::vector<char>& payload );
+
+		static bool storeObject( const COLLADAFW::Controller& controller, std::vector<char>& payload );
+
+		static bool storeObject( const COLLADAFW::Formulas& formulas, std::vector<char>& payload );
+
+		static bool storeObject( const COLLADAFW::KinematicsScene& kinematicsScene, std::vector<char>& payload );
+
+		/** Discards the file and passes the error to the writer.*/
+		virtual void cancel( const String& errorMessage );
+
+		/** Starts the file and the writer.*/
+		virtual void start();
+
+		/** Finishes the file and the writer.*/
+		virtual void finish();
+
+		/** The write methods store the object in the file and pass it to the writer. They return the result
+		of the writer, true if there is none.*/
+		virtual bool writeGlobalAsset( const COLLADAFW::FileInfo* asset );
+
+		virtual bool writeScene( const COLLADAFW::Scene* scene );
+
+		virtual bool writeVisualScene( const COLLADAFW::VisualScene* visualScene );
+
+		virtual bool writeLibraryNodes( const COLLADAFW::LibraryNodes* libraryNodes );
+
+		virtual bool writeGeometry( const COLLADAFW::Geometry* geometry );
+
+		virtual bool writeMaterial( const COLLADAFW::Material* material );
+
+		virtual bool writeEffect( const COLLADAFW::Effect* effect );
+
+		virtual bool writeCamera( const COLLADAFW::Camera* camera );
+
+		virtual bool writeImage( const COLLADAFW::Image* image );
+
+		virtual bool writeLight( const COLLADAFW::Light* light );
+
+		virtual bool writeAnimation( const COLLADAFW::Animation* animation );
+
+		virtual bool writeAnimationList( const COLLADAFW::AnimationList* animationList );
+
+		virtual bool writeAnimationClip( const COLLADAFW::AnimationClip* animationClip );
+
+		virtual bool writeSkinControllerData( const COLLADAFW::SkinControllerData* skinControllerData );
+
+		virtual bool writeController( const COLLADAFW::Controller* controller );
+
+		virtual bool writeFormulas( const COLLADAFW::Formulas* formulas );
+
+		virtual bool writeKinematicsScene( const COLLADAFW::KinematicsScene* kinematicsScene );
+
+	private:
+
+        /** Disable default copy ctor. */
+		BinaryCacheWriter( const BinaryCacheWriter& pre );
+
+        /** Disable default assignment operator. */
+		const BinaryCacheWriter& operator= ( const BinaryCacheWriter& pre );
+
+		/** Appends mRecord as record of type @a recordType to the file, if @a success is true. Otherwise
+		the file is discarded with error message @a errorMessage.*/
+		void writeRecord( unsigned int recordType, bool success, const char* errorMessage );
+
+		/** Writes @a count bytes at @a data to the file.*/
+		bool writeBytes( const void* data, size_t count );
+
+		/** Closes and removes the temporary file and sets the error message, if no error occurred before.*/
+		void discardFile( const String& errorMessage );
+	};
+
+} // namespace COLLADASAXFWL
+
+#endif // __COLLADASAXFWL_BINARYCACHEWRITER_H__
@@ -0,0 +1,140 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADASAXFWL_CACHEDDOCUMENT_H__
+#define __COLLADASAXFWL_CACHEDDOCUMENT_H__
+
+#include "COLLADASaxFWLPrerequisites.h"
+
+#include "COLLADAFWTypes.h"
+#include "COLLADAFWUniqueId.h"
+#include "COLLADAFWMeshOptimizer.h"
+
+#include <vector>
+#include <utility>
+
+
+namespace COLLADAFW
+{
+	class FileInfo;
+	class Image;
+	class Material;
+	class Mesh;
+	class Effect;
+}
+
+
+namespace COLLADASaxFWL
+{
+	class Loader;
+
+    /** The framework objects created from an external document, kept by the DocumentCache. A cached
+	document only contains assets, images, materials, meshes and effects, that do not reference objects
+	of other documents. The unique ids of the objects refer to the file id the document had in the load
+	that created or replayed it last, replay() assigns the ids of the next load.*/
+	class CachedDocument
+	{
+	private:
+		typedef std::pair<String, COLLADAFW::UniqueId> FragmentUniqueIdPair;
+		typedef std::vector<FragmentUniqueIdPair> FragmentUniqueIdList;
+
+		/** The file id the unique ids of the objects refer to.*/
+		COLLADAFW::FileId mFileId;
+
+		/** The asset of the document. Might be null.*/
+		COLLADAFW::FileInfo* mAsset;
+
+		/** The images of the document.*/
+		std::vector<COLLADAFW::Image*> mImages;
+
+		/** The materials of the document.*/
+		std::vector<COLLADAFW::Material*> mMaterials;
+
+		/** The meshes of the document.*/
+		std::vector<COLLADAFW::Mesh*> mMeshes;
+
+		/** The effects of the document.*/
+		std::vector<COLLADAFW::Effect*> mEffects;
+
+		/** The fragments of the uris the unique ids of the elements of the document have been created
+		for, i.e. the ids of the elements, with their unique ids.*/
+		FragmentUniqueIdList mFragmentUniqueIds;
+
+		/** The estimated number of bytes used by the objects.*/
+		size_t mMemorySize;
+
+		/** The vertex cache statistics of the meshes optimized while the document was parsed, before the
+		optimization.*/
+		COLLADAFW::MeshOptimizer::VertexCacheStatistics mOriginalStatistics;
+
+		/** The vertex cache statistics of the meshes optimized while the document was parsed.*/
+		COLLADAFW::MeshOptimizer::VertexCacheStatistics mOptimizedStatistics;
+
+	public:
+
+        /** Constructor.
+		@param fileId The file id the unique ids of the objects added to the document refer to.*/
+		CachedDocument( COLLADAFW::FileId fileId );
+
+        /** Destructor. Deletes the objects.*/
+		virtual ~CachedDocument();
+
+		/** Sets the asset of the document. Takes ownership of @a asset.*/
+		void setAsset( COLLADAFW::FileInfo* asset );
+
+		/** Adds an image. Takes ownership of @a image.*/
+		void addImage( COLLADAFW::Image* image );
+
+		/** Adds a material. Takes ownership of @a material.*/
+		void addMaterial( COLLADAFW::Material* material );
+
+		/** Adds a mesh. Takes ownership of @a mesh.*/
+		void addMesh( COLLADAFW::Mesh* mesh );
+
+		/** Adds an effect. Takes ownership of @a effect.*/
+		void addEffect( COLLADAFW::Effect* effect );
+
+		/** Adds the id @a fragment of an element of the document, that got the unique id @a uniqueId.*/
+		void addFragment( const String& fragment, const COLLADAFW::UniqueId& uniqueId );
+
+		/** Returns the estimated number of bytes used by the objects.*/
+		size_t getMemorySize() const { return mMemorySize; }
+
+		/** Sets the vertex cache statistics of the meshes optimized while the document was parsed, before and
+		after the optimization.*/
+		void setMeshOptimizationStatistics( const COLLADAFW::MeshOptimizer::VertexCacheStatistics& original, const COLLADAFW::MeshOptimizer::VertexCacheStatistics& optimized )
+		{ mOriginalStatistics = original; mOptimizedStatistics = optimized; }
+
+		/** Returns the vertex cache statistics of the meshes optimized while the document was parsed, before
+		the optimization.*/
+		const COLLADAFW::MeshOptimizer::VertexCacheStatistics& getOriginalStatistics() const { return mOriginalStatistics; }
+
+		/** Returns the vertex cache statistics of the meshes optimized while the document was parsed.*/
+		const COLLADAFW::MeshOptimizer::VertexCacheStatistics& getOptimizedStatistics() const { return mOptimizedStatistics; }
+
+		/** Assigns the unique ids, material ids and texture map ids of the current file of @a loader to
+		the objects and passes them to the writer of @a loader, as if the document had been parsed. Must
+		only be called while the document is the current file of @a loader and not concurrently with any
+		other member of this document.
+		@return False, if the writer failed to write an object.*/
+		bool replay( Loader& loader );
+
+	private:
+
+        /** Disable default copy ctor. */
+		CachedDocument( const CachedDocument& pre );
+
+        /** Disable default assignment operator. */
+		const CachedDocument& operator= ( const CachedDocument& pre );
+	};
+
+} // namespace COLLADASAXFWL
+
+#endif // __COLLADASAXFWL_CACHEDDOCUMENT_H__
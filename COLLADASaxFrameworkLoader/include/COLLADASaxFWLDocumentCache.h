@@ -0,0 +1,110 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADASAXFWL_DOCUMENTCACHE_H__
+#define __COLLADASAXFWL_DOCUMENTCACHE_H__
+
+#include "COLLADASaxFWLPrerequisites.h"
+
+#include "COLLADABUURI.h"
+
+
+namespace COLLADASaxFWL
+{
+	class Loader;
+	class CachedDocument;
+
+    /** Keeps the framework objects created from external documents, such as shared material and geometry
+	libraries, for later loads. Loaders using the cache, see Loader::setDocumentCache(), pass the cached
+	objects of an external document to their writer instead of parsing the document again.
+
+	Documents are identified by their uri, the modification time and size of the file and the options of
+	the loader that affect the created objects. Only documents that contain nothing but assets, images,
+	materials, effects and geometries, and do not reference other documents, are cached.
+
+	The cache is bounded by an estimate of the memory used by the objects, the least recently used
+	documents are removed first. A single cache can be shared by all loaders of the process, also by loaders
+	running concurrently on different threads. A document replayed by one loader is locked for other loaders
+	until its objects have been written.*/
+	class DocumentCache
+	{
+	public:
+		/** The default memory limit of the cache, in bytes.*/
+		static const size_t DEFAULT_MEMORY_LIMIT = 256 * 1024 * 1024;
+
+	private:
+		/** The documents and the statistics, guarded by a mutex.*/
+		struct SharedData;
+
+		/** The documents and the statistics, guarded by a mutex.*/
+		SharedData* mSharedData;
+
+	public:
+
+        /** Constructor.
+		@param memoryLimit The maximum number of bytes the cached objects should use.*/
+		DocumentCache( size_t memoryLimit = DEFAULT_MEMORY_LIMIT );
+
+        /** Destructor. Must not be called while a loader uses the cache.*/
+		virtual ~DocumentCache();
+
+		/** Sets the maximum number of bytes the cached objects should use and removes documents, until the
+		cache fits into the new limit.*/
+		void setMemoryLimit( size_t memoryLimit );
+
+		/** Returns the maximum number of bytes the cached objects should use.*/
+		size_t getMemoryLimit() const;
+
+		/** Returns the estimated number of bytes used by the cached objects.*/
+		size_t getMemoryUsage() const;
+
+		/** Returns the number of cached documents.*/
+		size_t getDocumentCount() const;
+
+		/** Returns the number of external documents that have been replayed from the cache.*/
+		size_t getHitCount() const;
+
+		/** Returns the number of external documents that have been looked up, but were not cached.*/
+		size_t getMissCount() const;
+
+		/** Removes all documents.*/
+		void clear();
+
+		/** Creates the key of the document @a uri, loaded with @a loadOptions, from the normalized path, the
+		modification time and the size of the file. The path is normalized, such that e.g. "a/./b.dae" and
+		"a/c/../b.dae", on Windows also "A/B.DAE", give the same key.
+		@return False, if the status of the file could not be read.*/
+		static bool createKey( const COLLADABU::URI& uri, const String& loadOptions, String& key );
+
+		/** Returns true, if the document with key @a key is cached.*/
+		bool contains( const String& key ) const;
+
+		/** Adds the document @a document with key @a key and removes the least recently used documents, if
+		the memory limit is exceeded. Takes ownership of @a document. A document using more memory than the
+		limit is deleted immediately.*/
+		void insert( const String& key, CachedDocument* document );
+
+		/** Replays the document with key @a key to @a loader, see CachedDocument::replay().
+		@param success Set to the result of CachedDocument::replay(), if the document is cached.
+		@return False, if the document is not cached.*/
+		bool replay( const String& key, Loader& loader, bool& success );
+
+	private:
+
+        /** Disable default copy ctor. */
+		DocumentCache( const DocumentCache& pre );
+
+        /** Disable default assignment operator. */
+		const DocumentCache& operator= ( const DocumentCache& pre );
+	};
+
+} // namespace COLLADASAXFWL
+
+#endif // __COLLADASAXFWL_DOCUMENTCACHE_H__
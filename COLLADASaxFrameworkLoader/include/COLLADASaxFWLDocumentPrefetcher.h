@@ -0,0 +1,85 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADASAXFWL_DOCUMENTPREFETCHER_H__
+#define __COLLADASAXFWL_DOCUMENTPREFETCHER_H__
+
+#include "COLLADASaxFWLPrerequisites.h"
+
+#include "COLLADAFWTypes.h"
+
+#include "COLLADABUURI.h"
+
+#include <vector>
+
+
+namespace COLLADASaxFWL
+{
+	class CachedDocument;
+	class Loader;
+
+    /** Reads the content of external documents on worker threads, while the loader parses the documents
+	discovered before them. If a parse function is set, the documents are also parsed on the worker threads,
+	each with its own loader, to objects the loader replays like cached documents. The replay, which creates
+	the unique ids and calls the writer, stays on the thread that called Loader::loadDocument(), in the order 
+	of the file ids. Documents are read in the order they have been passed to prefetch(). The documents being
+	read or read and not yet taken are limited by their size, a document exceeding the limit on its own is 
+	only read, when all documents before it have been taken.*/
+	class DocumentPrefetcher
+	{
+	public:
+		/** Parses the @a content of the document @a uri with the options of @a loader. Returns the objects
+		of the document, if they can be replayed by @a loader, null otherwise. Called on a worker thread.*/
+		typedef CachedDocument* (*ParseFunction)( const Loader& loader, const COLLADABU::URI& uri, const std::vector<char>& content );
+
+	private:
+		/** The state shared with the worker threads.*/
+		struct SharedData;
+
+		/** The state shared with the worker threads.*/
+		SharedData* mSharedData;
+
+	public:
+
+        /** Constructor. Starts @a threadCount worker threads.
+		@param maxBytes The maximum number of bytes of the documents read and not yet taken.
+		@param parseFunction The function the documents are parsed with after reading. Null, if the documents
+		are only read.
+		@param loader The loader passed to @a parseFunction. Must outlive the prefetcher.*/
+		DocumentPrefetcher( size_t threadCount, size_t maxBytes, ParseFunction parseFunction = 0, const Loader* loader = 0 );
+
+        /** Destructor. Waits for the documents being read and stops the worker threads. Deletes the objects
+		of the parsed documents not taken.*/
+		virtual ~DocumentPrefetcher();
+
+		/** Starts reading the document @a uri, that has been assigned the file id @a fileId.*/
+		void prefetch( COLLADAFW::FileId fileId, const COLLADABU::URI& uri );
+
+		/** Waits until the document with file id @a fileId has been read and, if a parse function is set,
+		parsed. Passes the ownership of the objects created by the parse function to the caller. If the 
+		document has not been parsed to objects, its content is moved to @a content instead.
+		@param parsedDocument Receives the objects of the document, null if the document has not been parsed.
+		@return False, if the document has not been passed to prefetch(), could not be read or has to be read
+		by the xml parser itself, e.g. because it is compressed. The document should be loaded from its uri
+		then, to get the usual error handling.*/
+		bool takeDocument( COLLADAFW::FileId fileId, std::vector<char>& content, CachedDocument*& parsedDocument );
+
+	private:
+
+        /** Disable default copy ctor. */
+		DocumentPrefetcher( const DocumentPrefetcher& pre );
+
+        /** Disable default assignment operator. */
+		const DocumentPrefetcher& operator= ( const DocumentPrefetcher& pre );
+	};
+
+} // namespace COLLADASAXFWL
+
+#endif // __COLLADASAXFWL_DOCUMENTPREFETCHER_H__
@@ -62,6 +62,9 @@ namespace COLLADASaxFWL
 		/** Maps the id of a collada element to the corresponding sit tree node.*/
 		Loader::IdStringSidTreeNodeMap& mIdStringSidTreeNodeMap;
 
+		/** Memoizes resolved sid addresses and their prefixes. Cleared whenever the sid tree changes.*/
+		Loader::SidPathSidTreeNodeMap& mResolvedSidPathMap;
+
 		/** List of all visual scenes in the file. They are send to the writer and deleted, when the file has 
 		completely been parsed.*/
 		Loader::VisualSceneList& mVisualScenes;
@@ -119,6 +122,9 @@ namespace COLLADASaxFWL
 		/** Set of all SkinController already created and written.*/
 		Loader::SkinControllerSet& mSkinControllerSet;
 
+		/** The memory used by the objects kept alive until the post processing.*/
+		MemoryUsage& mMemoryUsage;
+
 		/** Error handler to be used. */
 		SaxParserErrorHandler* mSaxParserErrorHandler;
 
@@ -153,25 +159,39 @@ namespace COLLADASaxFWL
 		parse process.*/
 		int getObjectFlags() const { return mObjectFlags; }
 
+		/** Returns the filter of the ids of the geometries that should be loaded.*/
+		const IdFilter& getGeometryIdFilter() const { return mColladaLoader->getGeometryIdFilter(); }
+
+		/** Returns the filter of the ids of the top level animations that should be loaded.*/
+		const IdFilter& getAnimationIdFilter() const { return mColladaLoader->getAnimationIdFilter(); }
+
+		/** Returns the filter of the ids of the root nodes that should be loaded.*/
+		const IdFilter& getNodeIdFilter() const { return mColladaLoader->getNodeIdFilter(); }
+
 		/** Adds @a visualScene to the list of visual scenes. It will be sent to the writer and delete by the
-		file loader.*/
-		void addVisualScene( COLLADAFW::VisualScene* visualScene ) { mVisualScenes.push_back(visualScene); }
+		file loader. Must be called, before moveUpInSidTree() is called for
+		the element @a visualScene has been created from.*/
+		void addVisualScene( COLLADAFW::VisualScene* visualScene );
 
 		/** Adds @a libraryNodes to the list of library nodes. It will be sent to the writer and delete by the
-		file loader.*/
-		void addLibraryNodes( COLLADAFW::LibraryNodes* libraryNodes ) { mLibraryNodes.push_back(libraryNodes); }
+		file loader. Must be called, before moveUpInSidTree() is called for
+		the element @a libraryNodes has been created from.*/
+		void addLibraryNodes( COLLADAFW::LibraryNodes* libraryNodes );
 
 		/** Adds @a effect to the list of effects. It will be sent to the writer and delete by the
-		file loader.*/
-		void addEffect( COLLADAFW::Effect* effect ) { mEffects.push_back(effect); }
+		file loader. Must be called, before moveUpInSidTree() is called for
+		the element @a effect has been created from.*/
+		void addEffect( COLLADAFW::Effect* effect );
 
 		/** Adds @a light to the list of lights. It will be sent to the writer and delete by the
-		file loader.*/
-		void addLight( COLLADAFW::Light* light ) { mLights.push_back(light); }
+		file loader. Must be called, before moveUpInSidTree() is called for
+		the element @a light has been created from.*/
+		void addLight( COLLADAFW::Light* light );
 
 		/** Adds @a camera to the list of cameras. It will be sent to the writer and delete by the
-		file loader.*/
-		void addCamera( COLLADAFW::Camera* camera ) { mCameras.push_back(camera); }
+		file loader. Must be called, before moveUpInSidTree() is called for
+		the element @a camera has been created from.*/
+		void addCamera( COLLADAFW::Camera* camera );
 
 		/** Adds @a formula to the list of formulas. It will be sent to the writer and delete by the
 		file loader.*/
@@ -244,12 +264,18 @@ namespace COLLADASaxFWL
 		/** Tries to resolve the a sidaddress. If resolving failed, null is returned.*/
 		const SidTreeNode* resolveSid( const SidAddress& sidAddress);
 
+		/** Tries to resolve the a sidaddress. If resolving failed, null is returned. Uses and fills 
+		@a resolvedSidPathMap instead of the loaders map of resolved sid addresses. Does not modify the 
+		document processor, i.e. might be called concurrently, as long as each thread uses its own 
+		@a resolvedSidPathMap and the sid tree is not modified.*/
+		const SidTreeNode* resolveSid( const SidAddress& sidAddress, Loader::SidPathSidTreeNodeMap& resolvedSidPathMap);
+
 		/** Tries to resolve the a sidaddress. If resolving failed, null is returned.*/
 		const SidTreeNode* resolveSid( const COLLADABU::URI& id, const String& sid);
 
 		/** Resolves an sid in the element referenced by @a instancingElement. It uses the sids ins @a sidAddress, 
 		starting with sid with index @a firstSidIndex. */
-		const SidTreeNode* resolveSidInInstance( const SidTreeNode* instancingElement, const SidAddress& sidAddress,  size_t firstSidIndex);
+		const SidTreeNode* resolveSidInInstance( const SidTreeNode* instancingElement, const SidAddress& sidAddress,  size_t firstSidIndex, Loader::SidPathSidTreeNodeMap& resolvedSidPathMap);
 
 		/** Tries to find element in sid tree with @a id. If not found, null is returned.*/ 
 		SidTreeNode* findSidTreeNodeByStringId( const String& id); 
@@ -257,6 +283,13 @@ namespace COLLADASaxFWL
 		/** The pair @a animationUniqueId, @a targetSidAddress to mUniqueIdSidAddressPairs.*/
 		void addToAnimationSidAddressBindings( const AnimationInfo& animationInfo, const SidAddress& targetSidAddress );
 
+		/** Returns true, if the memory budget of the loader is set and exceeded.*/
+		bool isMemoryBudgetExceeded() const;
+
+		/** Moves the animation sid address bindings kept in memory to the spill file of the loader. If the file 
+		could not be written, the bindings are kept in memory.*/
+		void spillAnimationSidAddressBindings();
+
 		/** Returns the animation list with Unique id @a animationListUniqueId. If it could not be found, a new map 
 		entry is created.*/
 		COLLADAFW::AnimationList*& getAnimationListByUniqueId( const COLLADAFW::UniqueId& animationListUniqueId);
@@ -274,6 +307,23 @@ namespace COLLADASaxFWL
 		/** Returns the skin source string of the skin controller, @a skinDataUniqueId was created from.*/
 		const COLLADABU::URI* getSkinSourceBySkinDataUniqueId(const COLLADAFW::UniqueId& skinDataUniqueId) const;
 
+		/** Keeps @a mesh, a moved copy of a previous mesh, until the post processing, in case a controller 
+		uses it.*/
+		void addTransformedDuplicateGeometry( const COLLADAFW::Mesh& mesh );
+
+		/** Records, that the bind shape matrix of the skin data with unique id @a skinDataUniqueId includes
+		the transformation of its source, a moved copy of the geometry with unique id @a originalUniqueId.*/
+		void addSkinDataOriginalSourcePair( const COLLADAFW::UniqueId& skinDataUniqueId, const COLLADAFW::UniqueId& originalUniqueId );
+
+		/** Returns the unique id of the geometry a controller should use as source or morph target instead of
+		the geometry with unique id @a geometryUniqueId, i.e. of the mesh it is a duplicate of, see 
+		Loader::setInstanceDuplicateGeometries(). If the geometry is a moved copy, the kept copy is written,
+		unless it has been written before, and its own unique id is returned.*/
+		const COLLADAFW::UniqueId& getControllerGeometryUniqueId( const COLLADAFW::UniqueId& geometryUniqueId );
+
+		/** Releases the moved copies kept for the controllers.*/
+		void releaseTransformedDuplicateGeometries();
+
 		/** Returns the mapping of the Unique generated from the id of the COLLADA controller element to the 
 		InstanceControllerDataList containing all instance controllers that reference the same controller.*/
 		const Loader::InstanceControllerDataListMap& getInstanceControllerDataListMap() const { return mInstanceControllerDataListMap;}
@@ -304,8 +354,32 @@ namespace COLLADASaxFWL
 			const StringList& sidsOrIds,
 			bool resolveIds);
 
+		/** Resolves the joints of a skin controller which instantiation is described by @a InstanceControllerData.
+		Like resolveSid( const SidAddress&, Loader::SidPathSidTreeNodeMap& ), this might be called concurrently.
+		@param sidsOrIds The sids or ids used to resolve joints.
+		@param resolveIds If true, the strings in @a sidsOrIds are resolved as Ids, otherwise as Sids
+		@param joints Receives the joints that could be resolved.
+		@param unresolvedSidsOrIds Receives the sids or ids that could not be resolved.*/
+		void resolveJoints( const Loader::InstanceControllerData& instanceControllerData, 
+			const StringList& sidsOrIds,
+			bool resolveIds,
+			Loader::SidPathSidTreeNodeMap& resolvedSidPathMap,
+			NodeList& joints,
+			StringList& unresolvedSidsOrIds);
 
-		/** Creates all skin controllers instantiated in the visual scene.*/
+		/** Creates a controller which instantiation is described by @a InstanceControllerData and that uses 
+		the controller with id @a controllerDataUniqueId and the joints resolved by resolveJoints().
+		@param resolveIds Must be the same as passed to resolveJoints().*/
+		bool writeSkinController( const Loader::InstanceControllerData& instanceControllerData, 
+			const COLLADAFW::UniqueId& controllerDataUniqueId,
+			const COLLADAFW::UniqueId& sourceUniqueId,
+			const NodeList& joints,
+			const StringList& unresolvedSidsOrIds,
+			bool resolveIds);
+
+
+		/** Creates all skin controllers instantiated in the visual scene. The joints are resolved concurrently, 
+		the controllers are written in the order of the instance controllers.*/
 		bool createAndWriteSkinControllers();
 
 
@@ -329,6 +403,10 @@ namespace COLLADASaxFWL
 		/** The version of the collada document.*/
 		void setCOLLADAVersion(COLLADAVersion cOLLADAVersion);
 
+		/** Remembers the current sid tree node as the one of the element @a object has been created from, if 
+		the loader has a memory budget.*/
+		void addToObjectSidTreeNodeMap( const void* object );
+
 		/** add joint for skin controller */
 		bool addValidatedJoint(const SidTreeNode &joint, NodeList &joints);
 	};
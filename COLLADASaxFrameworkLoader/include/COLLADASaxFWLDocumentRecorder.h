@@ -0,0 +1,198 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADASAXFWL_DOCUMENTRECORDER_H__
+#define __COLLADASAXFWL_DOCUMENTRECORDER_H__
+
+#include "COLLADASaxFWLPrerequisites.h"
+#include "COLLADASaxFWLLoader.h"
+
+#include "COLLADAFWIWriter.h"
+#include "COLLADAFWTypes.h"
+
+#include <map>
+#include <set>
+
+
+namespace COLLADAFW
+{
+	class Object;
+}
+
+
+namespace COLLADASaxFWL
+{
+	class CachedDocument;
+	class DocumentCache;
+
+    /** Writer used by the loader while a DocumentCache is set. Passes all objects to the writer of the
+	load and collects the objects of the external documents being recorded, to add them to the cache after
+	the load. The loader passes the ownership of written objects to the recorder with retain().
+
+	A recording is dropped, if an object of the document is written that can not be cached, or if the
+	document references another document, see invalidateDocument().*/
+	class DocumentRecorder : public COLLADAFW::IWriter
+	{
+	private:
+		/** The objects of a document being recorded.*/
+		struct Recording
+		{
+			Recording() : document(0), pendingObjectsCount(0) {}
+
+			/** The key of the document in the cache.*/
+			String key;
+
+			/** The retained objects. Null, if the document can not be cached.*/
+			CachedDocument* document;
+
+			/** The number of objects written, but not yet retained.*/
+			size_t pendingObjectsCount;
+		};
+
+		typedef std::map<COLLADAFW::FileId, Recording> FileIdRecordingMap;
+
+		/** The objects written but not yet retained, with the file id of their document.*/
+		typedef std::map<const void*, COLLADAFW::FileId> ObjectFileIdMap;
+
+		/** The writer all objects are passed to.*/
+		COLLADAFW::IWriter* mWriter;
+
+		/** The recordings of the external documents parsed by the load.*/
+		FileIdRecordingMap mRecordings;
+
+		/** The recording of the document being parsed. Null, if the document is not recorded.*/
+		Recording* mCurrentRecording;
+
+		/** The file id of the document being parsed.*/
+		COLLADAFW::FileId mCurrentFileId;
+
+		ObjectFileIdMap mPendingObjects;
+
+	public:
+
+        /** Constructor.
+		@param writer The writer all objects are passed to.*/
+		DocumentRecorder( COLLADAFW::IWriter* writer );
+
+        /** Destructor. Deletes the objects of the recordings not committed.*/
+		virtual ~DocumentRecorder();
+
+		/** Starts recording the document with file id @a fileId, that is about to be parsed, to be cached
+		with key @a key.*/
+		void startDocument( COLLADAFW::FileId fileId, const String& key );
+
+		/** Called after the document passed to startDocument() has been parsed.*/
+		void endDocument();
+
+		/** Drops the recording of the document with file id @a fileId, if any.*/
+		void invalidateDocument( COLLADAFW::FileId fileId );
+
+		/** Takes ownership of the asset @a asset, if it has been written while a recorded document was
+		parsed.
+		@return True, if the recorder took ownership. Otherwise the caller has to delete @a asset.*/
+		bool retain( COLLADAFW::FileInfo* asset );
+
+		/** Takes ownership of the image, material, mesh or effect @a object, if it has been written and
+		belongs to a document being recorded.
+		@return True, if the recorder took ownership. Otherwise the caller has to delete @a object.*/
+		bool retain( COLLADAFW::Object* object );
+
+		/** Adds the recorded documents to @a cache. @a uriUniqueIdMap is the map of the loader, used to find
+		the ids of the elements of the documents. Documents with written objects that have not been retained
+		are not added.*/
+		void commit( DocumentCache& cache, const Loader::URIUniqueIdMap& uriUniqueIdMap );
+
+		/** Removes the recording of the document with file id @a fileId and returns its objects, like 
+		commit() for a single document, without adding them to a cache. The caller takes ownership.
+		@return Null, if the document has not been recorded, can not be cached or has written objects that
+		have not been retained.*/
+		CachedDocument* takeDocument( COLLADAFW::FileId fileId, const Loader::URIUniqueIdMap& uriUniqueIdMap );
+
+		/** Passes the error to the writer.*/
+		virtual void cancel( const String& errorMessage );
+
+		/** Starts the writer.*/
+		virtual void start();
+
+		/** Finishes the writer.*/
+		virtual void finish();
+
+		/** Writes the asset, which is recorded, if the current document is recorded.*/
+		virtual bool writeGlobalAsset( const COLLADAFW::FileInfo* asset );
+
+		/** Writes the scene and drops the recording of the current document.*/
+		virtual bool writeScene( const COLLADAFW::Scene* scene );
+
+		/** Writes the visual scene and drops the recording of its document.*/
+		virtual bool writeVisualScene( const COLLADAFW::VisualScene* visualScene );
+
+		/** Writes the library nodes and drops the recordings of the documents of the nodes.*/
+		virtual bool writeLibraryNodes( const COLLADAFW::LibraryNodes* libraryNodes );
+
+		/** Writes the geometry, which is recorded if it is a mesh. Other geometries drop the recording of
+		their document.*/
+		virtual bool writeGeometry( const COLLADAFW::Geometry* geometry );
+
+		/** Writes the material, which is recorded.*/
+		virtual bool writeMaterial( const COLLADAFW::Material* material );
+
+		/** Writes the effect, which is recorded.*/
+		virtual bool writeEffect( const COLLADAFW::Effect* effect );
+
+		/** Writes the camera and drops the recording of its document.*/
+		virtual bool writeCamera( const COLLADAFW::Camera* camera );
+
+		/** Writes the image, which is recorded.*/
+		virtual bool writeImage( const COLLADAFW::Image* image );
+
+		/** Writes the light and drops the recording of its document.*/
+		virtual bool writeLight( const COLLADAFW::Light* light );
+
+		/** Writes the animation and drops the recording of its document.*/
+		virtual bool writeAnimation( const COLLADAFW::Animation* animation );
+
+		/** Writes the animation list and drops the recording of its document.*/
+		virtual bool writeAnimationList( const COLLADAFW::AnimationList* animationList );
+
+		/** Writes the animation clip and drops the recording of its document.*/
+		virtual bool writeAnimationClip( const COLLADAFW::AnimationClip* animationClip );
+
+		/** Writes the skin controller data and drops the recording of its document.*/
+		virtual bool writeSkinControllerData( const COLLADAFW::SkinControllerData* skinControllerData );
+
+		/** Writes the controller and drops the recording of its document.*/
+		virtual bool writeController( const COLLADAFW::Controller* controller );
+
+		/** Writes the formulas and drops all recordings, if there are any formulas, since the formulas of
+		all documents are written together.*/
+		virtual bool writeFormulas( const COLLADAFW::Formulas* formulas );
+
+		/** Writes the kinematics scene and drops all recordings, if it is not empty, since the kinematics
+		of all documents are written together.*/
+		virtual bool writeKinematicsScene( const COLLADAFW::KinematicsScene* kinematicsScene );
+
+	private:
+
+        /** Disable default copy ctor. */
+		DocumentRecorder( const DocumentRecorder& pre );
+
+        /** Disable default assignment operator. */
+		const DocumentRecorder& operator= ( const DocumentRecorder& pre );
+
+		/** Marks @a object as written, if the document with file id @a fileId is recorded.*/
+		void addPendingObject( const void* object, COLLADAFW::FileId fileId );
+
+		/** Drops all recordings.*/
+		void invalidateAllDocuments();
+	};
+
+} // namespace COLLADASAXFWL
+
+#endif // __COLLADASAXFWL_DOCUMENTRECORDER_H__
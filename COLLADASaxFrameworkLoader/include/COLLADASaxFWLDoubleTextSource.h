@@ -0,0 +1,58 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADASAXFWL_DOUBLETEXTSOURCE_H__
+#define __COLLADASAXFWL_DOUBLETEXTSOURCE_H__
+
+#include "COLLADASaxFWLPrerequisites.h"
+#include "COLLADASaxFWLSource.h"
+
+#include "GeneratedSaxParserITextDataHandler.h"
+
+
+namespace COLLADASaxFWL
+{
+
+    /** Double source that receives the character data of a float array and converts it to doubles, 
+	instead of receiving the values the parser has already converted to float.*/
+	class DoubleTextSource : public DoubleSource, public GeneratedSaxParser::ITextDataHandler
+	{
+	private:
+		/** The character data of the array, that has not been converted yet.*/
+		String mText;
+
+	public:
+
+        /** Constructor. */
+		DoubleTextSource() {}
+
+        /** Destructor. */
+		virtual ~DoubleTextSource() {}
+
+		/** Appends the character data of the array.*/
+		virtual bool textData( const ParserChar* text, size_t textLength );
+
+		/** Converts the character data received so far and appends the values to the array element. 
+		@return False, if the character data contains anything but doubles, true otherwise.*/
+		bool convertText();
+
+	private:
+
+        /** Disable default copy ctor. */
+		DoubleTextSource( const DoubleTextSource& pre );
+
+        /** Disable default assignment operator. */
+		const DoubleTextSource& operator= ( const DoubleTextSource& pre );
+
+	};
+
+} // namespace COLLADASAXFWL
+
+#endif // __COLLADASAXFWL_DOUBLETEXTSOURCE_H__
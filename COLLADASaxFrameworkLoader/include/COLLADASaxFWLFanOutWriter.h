@@ -0,0 +1,133 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADASAXFWL_FANOUTWRITER_H__
+#define __COLLADASAXFWL_FANOUTWRITER_H__
+
+#include "COLLADASaxFWLPrerequisites.h"
+#include "COLLADASaxFWLBinaryCacheFormat.h"
+
+#include "COLLADAFWIWriter.h"
+
+
+namespace COLLADASaxFWL
+{
+
+    /** Writer that passes all objects it receives to several writers, each running on its own thread, so
+	a single load feeds several exporters in parallel.
+
+	Each object is stored once with BinaryCacheWriter::storeObject() and queued for all writers. The stored
+	object is shared by the queues and released, when the last writer has written it. Each writer receives
+	its own copy of the object, restored on its thread, so writers can not interfere with each other. The
+	queues are bounded by the bytes of the stored objects. If a queue is full, the loader waits until the
+	writer has caught up.
+
+	Assets, images and materials are written synchronously, since the loader aborts if a writer fails to
+	write them: the write method waits until all writers have written the object and returns false, if any
+	of them failed. Objects that can not be stored, see BinaryCacheWriter, are written synchronously as
+	well, without being copied, and passed to one writer after the other, such that no two writers read
+	the same object at once. The results of the other objects are not returned to the loader, getSuccess()
+	tells if a writer failed to write any object. The queues are WriterQueues.
+
+	The writers are started, finished and cancelled on their threads, in the order of the objects. finish()
+	returns after all writers have been finished. cancel() drops the objects not yet written.*/
+	class FanOutWriter : public COLLADAFW::IWriter
+	{
+	public:
+		/** The default maximum number of bytes of the objects queued for a writer.*/
+		static const size_t DEFAULT_MAX_QUEUED_BYTES = 64 * 1024 * 1024;
+
+	private:
+		/** The queues of the writers.*/
+		struct SharedData;
+
+		/** The queues of the writers.*/
+		SharedData* mSharedData;
+
+	public:
+
+        /** Constructor.
+		@param maxQueuedBytes The maximum number of bytes of the objects queued for a writer. A single object
+		larger than this is queued nevertheless.*/
+		FanOutWriter( size_t maxQueuedBytes = DEFAULT_MAX_QUEUED_BYTES );
+
+        /** Destructor. Drops the objects not yet written and stops the threads, if finish() has not been
+		called.*/
+		virtual ~FanOutWriter();
+
+		/** Adds @a writer to the writers the objects are passed to. Must not be called during a load.*/
+		void addWriter( COLLADAFW::IWriter* writer );
+
+		/** Returns the number of writers the objects are passed to.*/
+		size_t getWriterCount() const;
+
+		/** Returns false, if writer @a writerIndex, in the order of addWriter(), failed to write an object
+		since start(). Valid after finish().*/
+		bool getSuccess( size_t writerIndex ) const;
+
+		/** Returns the type of the first object writer @a writerIndex failed to write since start(). Valid
+		only, if getSuccess() returns false.*/
+		BinaryCacheFormat::RecordType getFirstFailedRecordType( size_t writerIndex ) const;
+
+		/** Drops the objects not yet written and cancels the writers.*/
+		virtual void cancel( const String& errorMessage );
+
+		/** Starts a thread for each writer and starts the writers.*/
+		virtual void start();
+
+		/** Finishes the writers, after they have written all objects, and stops the threads.*/
+		virtual void finish();
+
+		virtual bool writeGlobalAsset( const COLLADAFW::FileInfo* asset );
+
+		virtual bool writeScene( const COLLADAFW::Scene* scene );
+
+		virtual bool writeVisualScene( const COLLADAFW::VisualScene* visualScene );
+
+		virtual bool writeLibraryNodes( const COLLADAFW::LibraryNodes* libraryNodes );
+
+		virtual bool writeGeometry( const COLLADAFW::Geometry* geometry );
+
+		virtual bool writeMaterial( const COLLADAFW::Material* material );
+
+		virtual bool writeEffect( const COLLADAFW::Effect* effect );
+
+		virtual bool writeCamera( const COLLADAFW::Camera* camera );
+
+		virtual bool writeImage( const COLLADAFW::Image* image );
+
+		virtual bool writeLight( const COLLADAFW::Light* light );
+
+		virtual bool writeAnimation( const COLLADAFW::Animation* animation );
+
+		virtual bool writeAnimationList( const COLLADAFW::AnimationList* animationList );
+
+		virtual bool writeAnimationClip( const COLLADAFW::AnimationClip* animationClip );
+
+		virtual bool writeSkinControllerData( const COLLADAFW::SkinControllerData* skinControllerData );
+
+		virtual bool writeController( const COLLADAFW::Controller* controller );
+
+		virtual bool writeFormulas( const COLLADAFW::Formulas* formulas );
+
+		virtual bool writeKinematicsScene( const COLLADAFW::KinematicsScene* kinematicsScene );
+
+	private:
+
+        /** Disable default copy ctor. */
+		FanOutWriter( const FanOutWriter& pre );
+
+        /** Disable default assignment operator. */
+		const FanOutWriter& operator= ( const FanOutWriter& pre );
+	};
+
+} // namespace COLLADASAXFWL
+
+#endif // __COLLADASAXFWL_FANOUTWRITER_H__
@@ -14,6 +14,8 @@
 #include "COLLADASaxFWLPrerequisites.h"
 #include "COLLADASaxFWLDocumentProcessor.h"
 
+#include "GeneratedSaxParserITextDataHandler.h"
+
 namespace COLLADASaxFWL14
 {
     class ColladaParserAutoGen14Private;
@@ -113,6 +115,16 @@ namespace COLLADASaxFWL
 		If level is invalid or it is called, while no version parser is aktive, 0 is returned.*/
 		StringHash getElementHash( size_t level = 0 ) const ;
 
+		/** Skips the element currently opened, including its children. Must only be called from within a 
+		begin function. Neither the end function of the element nor any of the callbacks of its children 
+		are called.*/
+		void skipCurrentElement();
+
+		/** Passes the raw character data of the element currently opened to @a handler, instead of 
+		converting it and passing it to the data function of the element. Must only be called from within 
+		a begin function. The end function of the element is called as usual.*/
+		void redirectCurrentElementTextData( GeneratedSaxParser::ITextDataHandler* handler );
+
 	protected:
         void setSaxParser( GeneratedSaxParser::SaxParser* parserToBeSet ) { mXmlSaxParser = parserToBeSet; }
         /** Sets the private parser to @a parserToBeSet.*/
@@ -14,13 +14,27 @@
 #include "COLLADASaxFWLPrerequisites.h"
 #include "COLLADASaxFWLXmlTypes.h"
 
+#include <set>
+
 
 namespace COLLADASaxFWL
 {
 
-    /** The callback handler to handle the reading of extra data. */
+    /** The callback handler to handle the reading of extra data. 
+    The techniques offered to a handler can be restricted to certain profiles and parent elements, see
+    addProfile() and addParentElement(). The loader compares the hashes of the technique before asking
+    the handlers. Techniques no handler wants to read are skipped, including all their children. */
 	class IExtraDataCallbackHandler 	
     {
+	private:
+		typedef std::set<StringHash> StringHashSet;
+
+        /** The hashes of the profiles of the techniques offered to the handler. Empty for all profiles. */
+		StringHashSet mProfileHashes;
+
+        /** The hashes of the elements, the extra elements of which are offered to the handler. Empty 
+        for all elements. */
+		StringHashSet mParentElementHashes;
 	
 	public:
 
@@ -42,6 +56,19 @@ namespace COLLADASaxFWL
             const COLLADAFW::UniqueId& uniqueId,
 			COLLADAFW::Object* object ) = 0;
 
+        /** Offers the techniques with profile @a profileName to the handler, e.g. "MAX3D". If no profile
+        has been added, the techniques of all profiles are offered. */
+        void addProfile( const String& profileName );
+
+        /** Offers the techniques of the extra elements of the elements named @a elementName to the 
+        handler, e.g. "node". If no parent element has been added, the techniques of all elements are 
+        offered. */
+        void addParentElement( const String& elementName );
+
+        /** Returns true, if parseElement() should be called for a technique with the profile hash 
+        @a profileHash in an extra element of the element with hash @a parentElementHash. */
+        bool isTechniqueOffered( StringHash profileHash, StringHash parentElementHash ) const;
+
 	private:
 
         /** Disable default copy constructor. */
@@ -39,6 +39,7 @@ namespace COLLADAFW
 {
 	class IWriter;
 	class Object;
+	class FileInfo;
 	class Animatable;
 	class AnimationList;
 	class MorphController;
@@ -177,9 +178,22 @@ namespace COLLADASaxFWL
 		/** Returns the GeometryMaterialIdInfo to map symbols to ids*/
 		GeometryMaterialIdInfo& getMeshMaterialIdInfo( );
 
+		/** Adds the vertex cache statistics of an optimized mesh to the statistics of the loader.*/
+		void addMeshOptimizationStatistics( const COLLADAFW::MeshOptimizer::VertexCacheStatistics& original, const COLLADAFW::MeshOptimizer::VertexCacheStatistics& optimized );
+
 		/** Returns TextureMapId for @a semantic. Successive call with same semantic return the same TextureMapId.*/
 		COLLADAFW::TextureMapId getTextureMapIdBySematic( const String& semantic );
 
+		/** Passes the ownership of the written asset @a asset to the document cache, if its document is
+		recorded, see Loader::setDocumentCache().
+		@return True, if the cache took ownership, false, if the caller has to delete @a asset.*/
+		bool retainForDocumentCache( COLLADAFW::FileInfo* asset );
+
+		/** Passes the ownership of the written object @a object to the document cache, if its document is
+		recorded, see Loader::setDocumentCache().
+		@return True, if the cache took ownership, false, if the caller has to delete @a object.*/
+		bool retainForDocumentCache( COLLADAFW::Object* object );
+
 		/** Creates a new in the sid tree. Call this method for every collada element that has an sid or that has an id 
 		and can have children with sids. For every call of this method you have to call addToSidTree() when the element
 		is closed.
@@ -235,6 +249,14 @@ namespace COLLADASaxFWL
 		/** Adds the pair @a skinDataUniqueId, @a skinSource to mSkinDataSkinSourceMap.*/
 		void addSkinDataSkinSourcePair( const COLLADAFW::UniqueId& skinDataUniqueId, const COLLADABU::URI& skinSource );
 
+		/** Keeps @a mesh, a moved copy of a previous mesh, until the post processing, in case a controller 
+		uses it.*/
+		void addTransformedDuplicateGeometry( const COLLADAFW::Mesh& mesh );
+
+		/** Records, that the bind shape matrix of the skin data with unique id @a skinDataUniqueId includes
+		the transformation of its source, a moved copy of the geometry with unique id @a originalUniqueId.*/
+		void addSkinDataOriginalSourcePair( const COLLADAFW::UniqueId& skinDataUniqueId, const COLLADAFW::UniqueId& originalUniqueId );
+
 		/** Adds @a morphController to the list of morph controllers. The morph controller will be deleted after
 		if has been written through the IWriter interface.*/
 		void addMorphController( COLLADAFW::MorphController* morphController);
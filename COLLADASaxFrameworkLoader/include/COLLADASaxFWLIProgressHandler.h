@@ -0,0 +1,56 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License, 
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADASAXFWL_IPROGRESSHANDLER_H__
+#define __COLLADASAXFWL_IPROGRESSHANDLER_H__
+
+#include "COLLADASaxFWLPrerequisites.h"
+
+#include "COLLADAFWTypes.h"
+
+
+namespace COLLADASaxFWL
+{
+
+    /** Interface to report the progress of loading a collada document and to cancel loading.*/
+	class IProgressHandler 	
+	{
+	public:
+
+        /** Constructor. */
+		IProgressHandler();
+
+        /** Destructor. */
+		virtual ~IProgressHandler();
+
+		/** Called while a file is parsed, each time the number of bytes passed to Loader::setProgressHandler()
+		has been parsed, and once, when the file has been parsed completely.
+		@param bytesConsumed The number of bytes of the file parsed so far.
+		@param totalBytes The size of the file in bytes. 0, if the size is unknown.
+		@param fileId The file id of the file parsed. The document passed to Loader::loadDocument() has file id 0.
+		@param currentLibrary The name of the child element of the COLLADA element currently parsed, e.g. 
+		"library_geometries". Null, if no such element is open.
+		@return True to continue loading. If false is returned, the loader stops parsing immediately, calls 
+		IWriter::cancel() and loadDocument() returns false.*/
+		virtual bool handleProgress( size_t bytesConsumed, size_t totalBytes, COLLADAFW::FileId fileId, const char* currentLibrary ) = 0;
+
+	private:
+
+        /** Disable default copy ctor. */
+		IProgressHandler( const IProgressHandler& pre );
+
+        /** Disable default assignment operator. */
+		const IProgressHandler& operator= ( const IProgressHandler& pre );
+
+	};
+
+} // namespace COLLADASAXFWL
+
+#endif // __COLLADASAXFWL_IPROGRESSHANDLER_H__
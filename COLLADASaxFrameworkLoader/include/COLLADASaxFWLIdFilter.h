@@ -0,0 +1,74 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADASAXFWL_IDFILTER_H__
+#define __COLLADASAXFWL_IDFILTER_H__
+
+#include "COLLADASaxFWLPrerequisites.h"
+
+#include "COLLADABUhash_map.h"
+
+#include <vector>
+
+
+namespace COLLADASaxFWL
+{
+
+    /** Allow-list of COLLADA ids. A pattern may contain the wildcards '*', matching any sequence of
+	characters, and '?', matching exactly one character. A filter without patterns accepts every id.*/
+	class IdFilter
+	{
+	private:
+		typedef COLLADABU::hash_set<String> StringSet;
+		typedef std::vector<String> StringList;
+
+		/** The patterns without wildcards.*/
+		StringSet mIds;
+
+		/** The patterns that contain wildcards.*/
+		StringList mWildcardPatterns;
+
+	public:
+
+        /** Constructor. */
+		IdFilter();
+
+        /** Destructor. */
+		virtual ~IdFilter();
+
+		/** Adds @a pattern to the patterns ids are accepted by.*/
+		void addPattern( const String& pattern );
+
+		/** Removes all patterns. Afterwards, every id is accepted.*/
+		void clear();
+
+		/** Returns true, if no pattern has been added.*/
+		bool isEmpty() const { return mIds.empty() && mWildcardPatterns.empty(); }
+
+		/** Returns true, if the filter is empty or @a id matches one of its patterns. An element without
+		id (@a id is null or empty) is only accepted by an empty filter.*/
+		bool accepts( const char* id ) const;
+
+		/** Returns true, if @a string matches @a pattern, which may contain the wildcards '*' and '?'.*/
+		static bool matches( const char* pattern, const char* string );
+
+	private:
+
+        /** Disable default copy ctor. */
+		IdFilter( const IdFilter& pre );
+
+        /** Disable default assignment operator. */
+		const IdFilter& operator= ( const IdFilter& pre );
+
+	};
+
+} // namespace COLLADASAXFWL
+
+#endif // __COLLADASAXFWL_IDFILTER_H__
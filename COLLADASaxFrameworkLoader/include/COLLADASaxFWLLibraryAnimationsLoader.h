@@ -65,6 +65,9 @@ namespace COLLADASaxFWL
 
         /* internal count of animation processed, used to build up a default id */
         size_t mProcessedCount;
+
+		/** The number of currently opened animation elements. Animations can be nested.*/
+		size_t mAnimationDepth;
 	public:
 
         /** Constructor. */
@@ -116,8 +119,22 @@ namespace COLLADASaxFWL
 		virtual bool end__Name_array();
 		virtual bool data__Name_array( const ParserString* data, size_t length );
 
+		/** If the animation curves are decoded lazily, keeps the character data of the array instead of 
+		decoding it.*/
+		virtual bool begin__float_array( const float_array__AttributeData& attributeData );
+
+	protected:
+
+		/** Returns the precision set in the loader for animation data.*/
+		virtual Loader::RealPrecision getRealPrecision() const;
+
 	private:
 
+		/** Sets the values of @a valuesArray of the current animation curve to those of @a realSource, if
+		it has no values yet. If the animation curves are decoded lazily, the values are decoded on first 
+		access.*/
+		void setAnimationCurveValues( COLLADAFW::AnimationCurve::ValuesArray valuesArray, const SourceBase* realSource );
+
         /**
         * The original object id, if it in the original file format exist. 
         */
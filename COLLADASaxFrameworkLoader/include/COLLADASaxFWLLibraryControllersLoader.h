@@ -122,6 +122,9 @@ namespace COLLADASaxFWL
 		/** Write the indices of the v element into the framework.*/
 		bool writeVIndices ( const sint64* data, size_t length );
 
+		/** Writes a single index of the v element at the current offset into the framework.*/
+		void writeVIndex ( unsigned int index, COLLADAFW::IntValuesArray& jointIndices, COLLADAFW::UIntValuesArray& weightIndices );
+
 		/** Sets the String list, the values of an id_ref or name_array should be stored in.
 		@param isIdArray If true, values are stored in idMap otherwise in in sid map*/
 		bool beginJointsArray(bool isIdArray);
@@ -186,6 +189,10 @@ namespace COLLADASaxFWL
 		virtual bool data__bind_shape_matrix( const float* data, size_t length );
 
 
+	protected:
+
+		/** Returns the precision set in the loader for controller data.*/
+		virtual Loader::RealPrecision getRealPrecision() const;
 
 	private:
 
@@ -16,6 +16,8 @@
 #include "COLLADASaxFWLSidTreeNode.h"
 #include "COLLADASaxFWLKinematicsIntermediateData.h"
 #include "COLLADASaxFWLTypes.h"
+#include "COLLADASaxFWLMemoryUsage.h"
+#include "COLLADASaxFWLIdFilter.h"
 
 #include "COLLADAFWILoader.h"
 #include "COLLADAFWLoaderUtils.h"
@@ -23,6 +25,8 @@
 #include "COLLADAFWTypes.h"
 #include "COLLADAFWSkinController.h"
 #include "COLLADAFWInstanceController.h"
+#include "COLLADAFWMeshOptimizer.h"
+#include "COLLADAFWMeshDeduplicator.h"
 
 #include "COLLADABUHashFunctions.h"
 #include "COLLADABUURI.h"
@@ -51,6 +55,12 @@ namespace COLLADASaxFWL
 	class DocumentProcessor;
 	class PostProcessor;
     class FileLoader;
+	class AnimationSidAddressBindingSpillFile;
+	class ObjectSpillFile;
+	class IProgressHandler;
+	class DocumentCache;
+	class DocumentRecorder;
+	class CachedDocument;
 
 
 	typedef std::list<String> StringList;
@@ -93,6 +103,23 @@ namespace COLLADASaxFWL
 			ALL_OBJECTS_MASK           = (1<<17) - 1,
 		};
 
+		/** The kinds of data, the precision of the values of float arrays can be chosen for.*/
+		enum RealDataKind
+		{
+			GEOMETRY_DATA,			//!< Vertex data of meshes and splines
+			ANIMATION_DATA,			//!< Input, output and tangent values of animation curves
+			CONTROLLER_DATA,		//!< Skin weights, inverse bind matrices and morph weights
+
+			REAL_DATA_KIND_COUNT
+		};
+
+		/** The precisions the values of float arrays can be stored with.*/
+		enum RealPrecision
+		{
+			SINGLE_PRECISION,		//!< Converted to float while the text is parsed
+			DOUBLE_PRECISION		//!< Converted to double, after the text of the array has been read
+		};
+
 	public:
 		typedef COLLADABU::hash_map<COLLADABU::URI, COLLADAFW::UniqueId> URIUniqueIdMap;
 
@@ -102,7 +129,15 @@ namespace COLLADASaxFWL
 		typedef std::map<COLLADAFW::FileId, COLLADABU::URI> FileIdURIMap;
 
 		/** Maps the id of a collada element to the corresponding sit tree node.*/
-		typedef std::map<String /*id*/, SidTreeNode*> IdStringSidTreeNodeMap;
+		typedef COLLADABU::hash_map<String /*id*/, SidTreeNode*> IdStringSidTreeNodeMap;
+
+		/** Maps already resolved sid addresses and their prefixes to the sid tree node they resolve to. The key 
+		is the id followed by the sids, each preceded by a "/".*/
+		typedef COLLADABU::hash_map<String /*sid path*/, const SidTreeNode*> SidPathSidTreeNodeMap;
+
+		/** Maps the effects, lights, cameras, visual scenes and library nodes to the sid tree nodes of the 
+		elements they have been created from.*/
+		typedef std::map<const void* /*object*/, SidTreeNode*> ObjectSidTreeNodeMap;
 
 		/** Maps unique ids of animation list to the corresponding animation list.*/
 		typedef std::map< COLLADAFW::UniqueId , COLLADAFW::AnimationList* > UniqueIdAnimationListMap;
@@ -141,6 +176,13 @@ namespace COLLADASaxFWL
 		/** Maps unique ids of skin data to the source uri string.*/
 		typedef std::map< COLLADAFW::UniqueId/*skin controller data*/, COLLADABU::URI/*source uri string*/> SkinDataSkinSourceMap;
 
+		/** Maps unique ids of skin data to the unique id of the geometry used as source instead of the moved 
+		copy it refers to.*/
+		typedef std::map< COLLADAFW::UniqueId/*skin controller data*/, COLLADAFW::UniqueId/*original geometry*/> SkinDataOriginalSourceMap;
+
+		/** Maps unique ids of geometries to the geometries stored with BinaryCacheWriter::storeObject().*/
+		typedef std::map< COLLADAFW::UniqueId, std::vector<char> > UniqueIdStoredGeometryMap;
+
 		/** Set of SkinControllers.*/
 		typedef std::set< COLLADAFW::SkinController, bool(*)(const COLLADAFW::SkinController& lhs, const COLLADAFW::SkinController& rhs)> SkinControllerSet;
 
@@ -182,10 +224,41 @@ namespace COLLADASaxFWL
 		/** Function pointer to functions provided to registerExternalReferenceDeciderCallbackFunction.*/
 		typedef bool (*ExternalReferenceDeciderCallbackFunction)( const COLLADABU::URI&, COLLADAFW::FileId );
 
+		/** The wall clock time spent in one phase of the post processing, that is performed after all files 
+		have been parsed.*/
+		struct PhaseTiming
+		{
+			PhaseTiming( const String& _phaseName, double _seconds)
+				: phaseName(_phaseName), seconds(_seconds) {}
+
+			/** The name of the phase, e.g. the name of the PostProcessor member performing it.*/
+			String phaseName;
+
+			/** The time spent in the phase, in seconds.*/
+			double seconds;
+		};
+
+		/** List of PhaseTimings, in the order the phases have been performed.*/
+		typedef std::vector<PhaseTiming> PhaseTimingList;
+
+		/** The vertex cache efficiency of the triangles of all meshes optimized during one load, before and
+		after the optimization.*/
+		struct MeshOptimizationStatistics
+		{
+			/** The statistics of the triangles in the order of the document.*/
+			COLLADAFW::MeshOptimizer::VertexCacheStatistics original;
+
+			/** The statistics of the optimized triangles.*/
+			COLLADAFW::MeshOptimizer::VertexCacheStatistics optimized;
+		};
+
 	public:
 		const static InstanceControllerDataList EMPTY_INSTANCE_CONTROLLER_DATALIST;
 		static const JointSidsOrIds EMPTY_JOINTSIDSORIDS;
 
+		/** The default number of bytes parsed between two notifications of the progress handler.*/
+		static const size_t DEFAULT_PROGRESS_INTERVAL = 1024 * 1024;
+
 	private:
 		/** The version of the collada document.*/
 		COLLADAVersion mCOLLADAVersion;
@@ -241,6 +314,9 @@ namespace COLLADASaxFWL
 		/** Maps the id of a collada element to the corresponding sit tree node.*/
 		IdStringSidTreeNodeMap mIdStringSidTreeNodeMap;
 
+		/** Memoizes resolved sid addresses for the lifetime of the load. Cleared whenever the sid tree changes.*/
+		SidPathSidTreeNodeMap mResolvedSidPathMap;
+
 		/** List of all visual scenes in the file. They are send to the writer and deleted, when the file has 
 		completely been parsed.*/
 		VisualSceneList mVisualScenes;
@@ -299,6 +375,91 @@ namespace COLLADASaxFWL
 		/** The call back function used to decide which filed should be leaded.*/
 		ExternalReferenceDeciderCallbackFunction mExternalReferenceDeciderCallbackFunction;
 
+		/** The maximum number of threads used for work that can be done concurrently. 0 means, the number of 
+		hardware threads is used.*/
+		size_t mThreadCount;
+
+		/** The time spent in each phase of the post processing of the last load.*/
+		PhaseTimingList mPostProcessingTimings;
+
+		/** The maximum number of bytes the objects kept alive until the post processing should use. 0 means
+		unlimited.*/
+		size_t mMemoryBudget;
+
+		/** The memory used by the objects kept alive until the post processing.*/
+		MemoryUsage mMemoryUsage;
+
+		/** The file animation sid address bindings are moved to, if the memory budget is exceeded. Null, if no
+		bindings have been moved.*/
+		AnimationSidAddressBindingSpillFile* mAnimationSidAddressBindingSpillFile;
+
+		/** The files the effects, lights, cameras, visual scenes and library nodes are moved to, if the memory
+		budget is exceeded, indexed by their memory usage category. Null, if no objects of a category have been
+		moved.*/
+		ObjectSpillFile* mObjectSpillFiles[MemoryUsage::CATEGORY_COUNT];
+
+		/** Maps the effects, lights, cameras, visual scenes and library nodes kept in memory to the sid tree 
+		nodes of their elements, to release the sid tree nodes, when the objects are moved to the spill files. 
+		Only filled, if a memory budget is set.*/
+		ObjectSidTreeNodeMap mObjectSidTreeNodeMap;
+
+		/** The handler the loading progress is reported to. Might be null.*/
+		IProgressHandler* mProgressHandler;
+
+		/** The number of bytes parsed between two notifications of the progress handler.*/
+		size_t mProgressInterval;
+
+		/** True, if the progress handler cancelled the last load.*/
+		bool mLoadingCancelled;
+
+		/** The ids of the geometries that should be loaded.*/
+		IdFilter mGeometryIdFilter;
+
+		/** The ids of the top level animations that should be loaded.*/
+		IdFilter mAnimationIdFilter;
+
+		/** The ids of the root nodes of visual scenes and node libraries that should be loaded.*/
+		IdFilter mNodeIdFilter;
+
+		/** True, if the values of animation curves should not be decoded before they are accessed.*/
+		bool mLazyAnimationCurveDecoding;
+
+		/** The precision the values of float arrays are stored with, for each kind of data.*/
+		RealPrecision mRealPrecisions[REAL_DATA_KIND_COUNT];
+
+		/** True, if polygons, polylists, triangle strips and triangle fans of meshes should be converted 
+		into triangles.*/
+		bool mTriangulateMeshes;
+
+		/** True, if the triangles of meshes should be reordered for the vertex cache and to reduce overdraw.*/
+		bool mOptimizeMeshes;
+
+		/** The vertex cache statistics of the meshes optimized during the last load.*/
+		MeshOptimizationStatistics mMeshOptimizationStatistics;
+
+		/** True, if geometries, that are duplicates of previous geometries, should be replaced by instances of
+		the previous geometries.*/
+		bool mInstanceDuplicateGeometries;
+
+		/** Finds the duplicate geometries of the current load.*/
+		COLLADAFW::MeshDeduplicator mMeshDeduplicator;
+
+		/** The duplicate geometries of the current load, that are moved copies. They are written, if a 
+		controller uses them, see DocumentProcessor::getControllerGeometryUniqueId(). The stored geometry of
+		a written copy is emptied.*/
+		UniqueIdStoredGeometryMap mTransformedDuplicateGeometries;
+
+		/** Maps unique ids of skin data, whose bind shape matrix includes the transformation of its source, a
+		moved copy, to the geometry the skin controllers use instead.*/
+		SkinDataOriginalSourceMap mSkinDataOriginalSourceMap;
+
+		/** The cache of external documents. Might be null.*/
+		DocumentCache* mDocumentCache;
+
+		/** The writer recording the external documents for the document cache during a load. Null, if
+		documents are not recorded.*/
+		DocumentRecorder* mDocumentRecorder;
+
 	public:
 
         /** Constructor. */
@@ -341,6 +502,10 @@ namespace COLLADASaxFWL
 		function is called, before an external file should be loaded. If the function returns true, the 
 		external is loaded, otherwise the file is omitted. If no function is registered, all external files
 		will be loaded.
+		The function is called on the thread that called loadDocument(), in the order of the file ids, before
+		the file is read. If external documents are read ahead, see setThreadCount(), the function is called
+		when the file has been discovered, which may be before the files with smaller file ids have been
+		parsed.
 		To unregister call with externalReferenceDeciderCallbackFunction = 0
 		The parameters of the callback function are the uri of the external file and its FileId used in 
 		corresponding UniqueIds.
@@ -348,6 +513,169 @@ namespace COLLADASaxFWL
 		*/
 		void registerExternalReferenceDeciderCallbackFunction( ExternalReferenceDeciderCallbackFunction externalReferenceDeciderCallbackFunction );
 
+		/** Sets the maximum number of threads used for work that can be done concurrently, e.g. the resolving
+		of sid addresses after all files have been parsed or the reading of external documents, while the
+		documents referencing them are parsed. At most 64 MB of external documents are read ahead, or the 
+		memory budget, if it is smaller. The calls of the IWriter are always made from the thread that
+		called loadDocument() and the file ids do not depend on the number of threads.
+		External documents read ahead are also parsed on the worker threads, each with its own loader, unless
+		extra data callback handlers, an id filter or a progress handler are set or duplicate geometries are
+		instanced. Documents only containing an asset, images, materials, meshes and effects, that do not 
+		reference other documents, are passed to the writer in the order of the file ids, like documents 
+		replayed from the document cache: their effects are written with the document instead of in the post
+		processing, the unique ids of objects without id may differ from a single threaded load, and they 
+		add no elements to the sid tree, i.e. their effects can not be animated. Other documents are parsed 
+		again on the loading thread.
+		@param threadCount The maximum number of threads. If 0, the number of hardware threads is used, 
+		1 disables multi threading.*/
+		void setThreadCount( size_t threadCount ) { mThreadCount = threadCount; }
+
+		/** Returns the maximum number of threads used for work that can be done concurrently.*/
+		size_t getThreadCount() const { return mThreadCount; }
+
+		/** Returns the time spent in each phase of the post processing of the last call of loadDocument(), in 
+		the order the phases have been performed.*/
+		const PhaseTimingList& getPostProcessingTimings() const { return mPostProcessingTimings; }
+
+		/** Sets the maximum number of bytes the objects, that are kept alive until all files have been parsed,
+		should use. If a budget is set, the objects are released as soon as they have been written and are no
+		longer referenced, instead of being kept until the loader is destroyed, and animation sid address 
+		bindings are moved to a temporary file, whenever the budget is exceeded.
+		After each document, that is followed by another one, the animation lists of the bindings that can be 
+		resolved are created, with the file id of that document. If the budget is still exceeded and no 
+		formulas are used, the effects, lights and cameras and, unless controllers are instantiated, kinematics
+		are used or duplicate geometries are instanced, the visual scenes and library nodes are moved to 
+		temporary files. They are read back one by one, when they are written in the post processing. Objects 
+		moved to a file can not be referenced by the documents parsed after they have been moved, e.g. their 
+		elements can not be animated or used as joints by them.
+		The budget is only enforced between documents, the objects of a document are kept in memory, until it 
+		has been parsed completely. The sid tree, the animation lists, controllers, formulas and kinematics 
+		are never moved, the memory used exceeds the budget by their size. getMemoryUsage() reports the peak
+		bytes of each category and the bytes moved to the files.
+		@param memoryBudget The budget in bytes. 0 means unlimited.*/
+		void setMemoryBudget( size_t memoryBudget ) { mMemoryBudget = memoryBudget; }
+
+		/** Returns the maximum number of bytes the objects kept alive until the post processing should use.*/
+		size_t getMemoryBudget() const { return mMemoryBudget; }
+
+		/** Returns the estimated memory used by the objects kept alive until the post processing, including
+		the peaks reached during the last call of loadDocument().*/
+		const MemoryUsage& getMemoryUsage() const { return mMemoryUsage; }
+
+		/** Sets the handler the loading progress is reported to. The handler can cancel loading, by returning
+		false. In that case IWriter::cancel() is called and loadDocument() returns false.
+		@param progressHandler The progress handler. Null disables the reporting.
+		@param progressInterval The number of bytes parsed between two notifications of the progress handler.*/
+		void setProgressHandler( IProgressHandler* progressHandler, size_t progressInterval = DEFAULT_PROGRESS_INTERVAL ) 
+		{ mProgressHandler = progressHandler; mProgressInterval = progressInterval; }
+
+		/** Returns the handler the loading progress is reported to.*/
+		IProgressHandler* getProgressHandler() const { return mProgressHandler; }
+
+		/** Returns the number of bytes parsed between two notifications of the progress handler.*/
+		size_t getProgressInterval() const { return mProgressInterval; }
+
+		/** Returns true, if the progress handler cancelled the last call of loadDocument().*/
+		bool isLoadingCancelled() const { return mLoadingCancelled; }
+
+		/** Returns the filter of the ids of the geometries that should be loaded. Geometries not accepted by
+		the filter are skipped by the parser, without being processed. The filter is empty by default, i.e.
+		all geometries are loaded.*/
+		IdFilter& getGeometryIdFilter() { return mGeometryIdFilter; }
+
+		/** Returns the filter of the ids of the geometries that should be loaded.*/
+		const IdFilter& getGeometryIdFilter() const { return mGeometryIdFilter; }
+
+		/** Returns the filter of the ids of the animations that should be loaded. Only the ids of animations
+		that are direct children of a library are checked, nested animations are loaded with their parent.
+		The filter is empty by default, i.e. all animations are loaded.*/
+		IdFilter& getAnimationIdFilter() { return mAnimationIdFilter; }
+
+		/** Returns the filter of the ids of the animations that should be loaded.*/
+		const IdFilter& getAnimationIdFilter() const { return mAnimationIdFilter; }
+
+		/** Returns the filter of the ids of the nodes that should be loaded. Only the ids of root nodes of
+		visual scenes and node libraries are checked, child nodes are loaded with their parent. The filter 
+		is empty by default, i.e. all nodes are loaded.*/
+		IdFilter& getNodeIdFilter() { return mNodeIdFilter; }
+
+		/** Returns the filter of the ids of the nodes that should be loaded.*/
+		const IdFilter& getNodeIdFilter() const { return mNodeIdFilter; }
+
+		/** Sets if the input, output and tangent values of animation curves should be decoded not before 
+		they are accessed the first time. If enabled, the animation curves passed to the writer only keep the
+		character data of their arrays. Writers that only need the number of keys, e.g. to list the 
+		animations, should use AnimationCurve::getValuesCount() to avoid decoding.*/
+		void setLazyAnimationCurveDecoding( bool lazyAnimationCurveDecoding ) { mLazyAnimationCurveDecoding = lazyAnimationCurveDecoding; }
+
+		/** Returns true, if the values of animation curves are decoded not before they are accessed.*/
+		bool getLazyAnimationCurveDecoding() const { return mLazyAnimationCurveDecoding; }
+
+		/** Sets the precision the values of float arrays used for @a dataKind are stored with. The default
+		is single precision for all kinds of data, i.e. the values are converted straight to float and
+		the framework arrays passed to the writer only contain floats. With double precision the 
+		framework arrays contain doubles, that have not been rounded to float.*/
+		void setRealPrecision( RealDataKind dataKind, RealPrecision precision ) { mRealPrecisions[dataKind] = precision; }
+
+		/** Returns the precision the values of float arrays used for @a dataKind are stored with.*/
+		RealPrecision getRealPrecision( RealDataKind dataKind ) const { return mRealPrecisions[dataKind]; }
+
+		/** Sets if polygons, polylists, triangle strips and triangle fans of meshes should be converted into
+		triangles, before the meshes are passed to the writer. Concave polygons and polygons with holes are
+		supported. The primitives of a mesh are triangulated concurrently, see setThreadCount().
+		@see COLLADAFW::MeshTriangulator*/
+		void setTriangulateMeshes( bool triangulateMeshes ) { mTriangulateMeshes = triangulateMeshes; }
+
+		/** Returns true, if the primitives of meshes are converted into triangles.*/
+		bool getTriangulateMeshes() const { return mTriangulateMeshes; }
+
+		/** Sets if the triangles of meshes should be reordered for the post transform vertex cache and to 
+		reduce overdraw, before the meshes are passed to the writer. Only triangle primitives are reordered,
+		so this is usually combined with setTriangulateMeshes(). The vertex data of the meshes is not changed,
+		vertex fetch can be optimized after welding, see COLLADAFW::MeshVertexWelder::optimize().
+		@see COLLADAFW::MeshOptimizer*/
+		void setOptimizeMeshes( bool optimizeMeshes ) { mOptimizeMeshes = optimizeMeshes; }
+
+		/** Returns true, if the triangles of meshes are reordered.*/
+		bool getOptimizeMeshes() const { return mOptimizeMeshes; }
+
+		/** Returns the vertex cache efficiency of the triangles reordered during the last call of 
+		loadDocument(), see setOptimizeMeshes(), before and after the optimization.*/
+		const MeshOptimizationStatistics& getMeshOptimizationStatistics() const { return mMeshOptimizationStatistics; }
+
+		/** Sets if meshes, that are duplicates of previously loaded meshes, should be replaced by instances of
+		the previous meshes. Duplicates are not passed to the writer, the instance geometries, skin controllers
+		and morph controllers referring to them refer to the previous mesh instead. Instance geometries of
+		moved copies, found with rigid matching, are placed in a new child node, that contains the
+		transformation of the copy. Skin controllers, whose source is a moved copy parsed before the skin, use
+		the previous mesh and a bind shape matrix, that includes the transformation of the copy. Other 
+		controllers referring to moved copies use the copies, which are kept until the post processing and 
+		written with the controllers. The document cache is not used, if this is set. The tolerances and the
+		result of the last load are available from getMeshDeduplicator().
+		@see COLLADAFW::MeshDeduplicator*/
+		void setInstanceDuplicateGeometries( bool instanceDuplicateGeometries ) { mInstanceDuplicateGeometries = instanceDuplicateGeometries; }
+
+		/** Returns true, if duplicate meshes are replaced by instances.*/
+		bool getInstanceDuplicateGeometries() const { return mInstanceDuplicateGeometries; }
+
+		/** Returns the deduplicator used to find duplicate meshes, to set its tolerances.*/
+		COLLADAFW::MeshDeduplicator& getMeshDeduplicator() { return mMeshDeduplicator; }
+
+		/** Returns the deduplicator used to find duplicate meshes, e.g. to query the duplicates and the bytes
+		saved during the last call of loadDocument(), see COLLADAFW::MeshDeduplicator::getStatistics().*/
+		const COLLADAFW::MeshDeduplicator& getMeshDeduplicator() const { return mMeshDeduplicator; }
+
+		/** Sets the cache external documents are taken from and added to. The objects of a cached external
+		document are passed to the writer instead of parsing the document again. A cache can be shared by
+		loaders running concurrently and must outlive them. The cache is only used by 
+		loadDocument(const String&, COLLADAFW::IWriter*) and is not used, if extra data callback handlers are
+		registered or an id filter is set. Might be null, which is the default.
+		@see DocumentCache*/
+		void setDocumentCache( DocumentCache* documentCache ) { mDocumentCache = documentCache; }
+
+		/** Returns the cache of external documents. Might be null.*/
+		DocumentCache* getDocumentCache() const { return mDocumentCache; }
+
 
 		/** Returns the Uri the file id @a fileId was assigned to by getFileId(). If @a fileId has not been 
 		assigned to any Uri, an invalid uri is returned.*/
@@ -389,6 +717,7 @@ namespace COLLADASaxFWL
 		friend class FileLoader;
 		friend class PostProcessor;
 		friend class DocumentProcessor;
+		friend class CachedDocument;
 
 		/** The version of the collada document.*/
 		void setCOLLADAVersion(COLLADAVersion cOLLADAVersion) { mCOLLADAVersion = cOLLADAVersion; }
@@ -408,6 +737,21 @@ namespace COLLADASaxFWL
 		/** Returns the GeometryMaterialIdInfo to map symbols to ids*/
 		GeometryMaterialIdInfo& getMeshMaterialIdInfo( );
 
+		/** Returns the options of the loader that affect the objects created from a document, as part of the
+		key of the document in the document cache.*/
+		String getDocumentCacheLoadOptions() const;
+
+		/** Parses the @a content of the external document @a uri with a new loader, that has the options of 
+		@a loader, and records the objects created. Called on the worker threads of the DocumentPrefetcher, 
+		@a loader is only read.
+		@return The objects of the document, if they can be replayed like a cached document. Null, if the 
+		document references other documents, contains objects that can not be cached or an error occurred. 
+		The document is parsed by the loading thread then, to pass the errors to the error handler.*/
+		static CachedDocument* parseExternalDocument( const Loader& loader, const COLLADABU::URI& uri, const std::vector<char>& content );
+
+		/** Adds the statistics of an optimized mesh to mMeshOptimizationStatistics.*/
+		void addMeshOptimizationStatistics( const COLLADAFW::MeshOptimizer::VertexCacheStatistics& original, const COLLADAFW::MeshOptimizer::VertexCacheStatistics& optimized );
+
 		/** Returns TextureMapId for @a semantic. Successive call with same semantic return the same TextureMapId.*/
 		COLLADAFW::TextureMapId getTextureMapIdBySematic( const String& semantic );
 
@@ -417,6 +761,13 @@ namespace COLLADASaxFWL
 		/** Maps the id of a collada element to the corresponding sit tree node.*/
 		IdStringSidTreeNodeMap& getIdStringSidTreeNodeMap() { return mIdStringSidTreeNodeMap; }
 
+		/** Memoizes resolved sid addresses for the lifetime of the load.*/
+		SidPathSidTreeNodeMap& getResolvedSidPathMap() { return mResolvedSidPathMap; }
+
+		/** Deletes the sid tree and all maps referencing its nodes. Called after the post processing, if a 
+		memory budget is set.*/
+		void releaseSidTree();
+
 		/** List of all visual scenes in the file. They are send to the writer and deleted, when the file has 
 		completely been parsed.*/
 		VisualSceneList& getVisualScenes() { return mVisualScenes; }
@@ -463,6 +814,13 @@ namespace COLLADASaxFWL
 			return mSkinDataSkinSourceMap; 
 		}
 
+		/** Maps unique ids of skin data to the geometry used as source instead of the moved copy it refers
+		to.*/
+		SkinDataOriginalSourceMap& getSkinDataOriginalSourceMap() { return mSkinDataOriginalSourceMap; }
+
+		/** The stored duplicate geometries, that are moved copies.*/
+		UniqueIdStoredGeometryMap& getTransformedDuplicateGeometries() { return mTransformedDuplicateGeometries; }
+
 		/** Set of all SkinController already created and written.*/
 		SkinControllerSet& getSkinControllerSet() { return mSkinControllerSet; }
 
@@ -0,0 +1,159 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADASAXFWL_MEMORYUSAGE_H__
+#define __COLLADASAXFWL_MEMORYUSAGE_H__
+
+#include "COLLADASaxFWLPrerequisites.h"
+
+
+namespace COLLADAFW
+{
+	class VisualScene;
+	class LibraryNodes;
+	class Node;
+	class Effect;
+	class Light;
+	class Camera;
+	class AnimationList;
+}
+
+namespace COLLADASaxFWL
+{
+
+	class SidAddress;
+
+    /** Keeps track of the memory used by the objects the loader keeps alive, until they have been written in
+	the post processing. The sizes are estimates, based on the sizes of the objects and the arrays and strings
+	they own. The peak memory of the entire process, as measured by the operating system, is available through
+	getPeakResidentBytes().*/
+	class MemoryUsage
+	{
+	public:
+		/** The categories of objects the memory usage is tracked for.*/
+		enum Category
+		{
+			VISUAL_SCENES,
+			LIBRARY_NODES,
+			EFFECTS,
+			LIGHTS,
+			CAMERAS,
+			ANIMATION_LISTS,
+			ANIMATION_BINDINGS,		//!< The bindings of animations to sid addresses of their targets
+			SID_TREE,				//!< The sid tree and the map of ids to sid tree nodes
+			DUPLICATE_GEOMETRIES,	//!< The stored moved copies of geometries, see Loader::setInstanceDuplicateGeometries()
+
+			CATEGORY_COUNT
+		};
+
+	private:
+		/** The bytes currently used by each category.*/
+		size_t mCurrentBytes[CATEGORY_COUNT];
+
+		/** The maximum of the bytes used by each category, since the last call of resetPeaks().*/
+		size_t mPeakBytes[CATEGORY_COUNT];
+
+		/** The bytes currently used by all categories.*/
+		size_t mCurrentTotalBytes;
+
+		/** The maximum of the bytes used by all categories, since the last call of resetPeaks().*/
+		size_t mPeakTotalBytes;
+
+		/** The bytes of each category moved to temporary files, since the last call of resetPeaks().*/
+		size_t mSpilledBytes[CATEGORY_COUNT];
+
+		/** The bytes of all categories moved to temporary files, since the last call of resetPeaks().*/
+		size_t mSpilledTotalBytes;
+
+	public:
+
+        /** Constructor. */
+		MemoryUsage();
+
+		/** Adds @a bytes to the memory used by @a category.*/
+		void add( Category category, size_t bytes );
+
+		/** Removes @a bytes from the memory used by @a category.*/
+		void remove( Category category, size_t bytes );
+
+		/** Sets the memory used by @a category to zero.*/
+		void release( Category category ) { remove( category, mCurrentBytes[category] ); }
+
+		/** Adds @a bytes to the bytes of @a category moved to temporary files.*/
+		void addSpilledBytes( Category category, size_t bytes );
+
+		/** Sets the peaks to the current memory usage and the spilled bytes to zero. Called when a load 
+		starts.*/
+		void resetPeaks();
+
+		/** Returns the bytes currently used by @a category.*/
+		size_t getCurrentBytes( Category category ) const { return mCurrentBytes[category]; }
+
+		/** Returns the maximum of the bytes used by @a category, since the last load started.*/
+		size_t getPeakBytes( Category category ) const { return mPeakBytes[category]; }
+
+		/** Returns the bytes currently used by all categories.*/
+		size_t getCurrentTotalBytes() const { return mCurrentTotalBytes; }
+
+		/** Returns the maximum of the bytes used by all categories at the same time, since the last load
+		started.*/
+		size_t getPeakTotalBytes() const { return mPeakTotalBytes; }
+
+		/** Returns the bytes of @a category moved to temporary files, since the last load started.*/
+		size_t getSpilledBytes( Category category ) const { return mSpilledBytes[category]; }
+
+		/** Returns the bytes of all categories moved to temporary files, since the last load started.*/
+		size_t getSpilledBytes() const { return mSpilledTotalBytes; }
+
+		/** Returns the name of @a category.*/
+		static const char* getCategoryName( Category category );
+
+		/** Returns the maximum of the physical memory used by the process since it has been started, as 
+		reported by the operating system, or 0 if it is not available. Unlike the bytes of the categories, 
+		this includes the memory used by the writer and the memory not yet returned by the allocator.*/
+		static size_t getPeakResidentBytes();
+
+		/** Returns the estimated memory used by @a visualScene.*/
+		static size_t estimateBytes( const COLLADAFW::VisualScene& visualScene );
+
+		/** Returns the estimated memory used by @a libraryNodes.*/
+		static size_t estimateBytes( const COLLADAFW::LibraryNodes& libraryNodes );
+
+		/** Returns the estimated memory used by @a node, including its child nodes.*/
+		static size_t estimateBytes( const COLLADAFW::Node& node );
+
+		/** Returns the estimated memory used by @a effect.*/
+		static size_t estimateBytes( const COLLADAFW::Effect& effect );
+
+		/** Returns the estimated memory used by @a light.*/
+		static size_t estimateBytes( const COLLADAFW::Light& light );
+
+		/** Returns the estimated memory used by @a camera.*/
+		static size_t estimateBytes( const COLLADAFW::Camera& camera );
+
+		/** Returns the estimated memory used by the strings owned by @a sidAddress.*/
+		static size_t estimateBytes( const SidAddress& sidAddress );
+
+		/** Returns the estimated memory used by the characters of @a string.*/
+		static size_t estimateBytes( const String& string );
+
+	private:
+
+        /** Disable default copy ctor. */
+		MemoryUsage( const MemoryUsage& pre );
+
+        /** Disable default assignment operator. */
+		const MemoryUsage& operator= ( const MemoryUsage& pre );
+
+	};
+
+} // namespace COLLADASAXFWL
+
+#endif // __COLLADASAXFWL_MEMORYUSAGE_H__
@@ -181,6 +181,9 @@ namespace COLLADASaxFWL
         /** Returns the mesh that has just been loaded.*/
 		COLLADAFW::Mesh* getMesh() { return mMesh; }
 
+		/** Releases the ownership of the mesh that has just been loaded. The caller has to delete it.*/
+		COLLADAFW::Mesh* releaseMesh() { COLLADAFW::Mesh* mesh = mMesh; mMesh = 0; return mesh; }
+
 		/** Sax callback function for the beginning of a source element.*/
 		virtual bool begin__source(const source__AttributeData& attributes);
 
@@ -305,11 +308,22 @@ namespace COLLADASaxFWL
 		bool beginInput(const input____InputLocalOffset__AttributeData& attributeData);
 
 
+	protected:
+
+		/** Returns the precision set in the loader for geometry data.*/
+		virtual Loader::RealPrecision getRealPrecision() const;
+
 	private:
 
 		/** Initializes all the current values, i.e. values used while parsing a mesh primitive.*/
 		void initCurrentValues();
 
+		/** Replaces the polygons, polylists, triangle strips and triangle fans of the mesh by triangles.*/
+		void triangulateMesh();
+
+		/** Reorders the triangles of the mesh for the vertex cache and to reduce overdraw.*/
+		void optimizeMesh();
+
         /**
         * Returns the vertex input element with the given semantic or 0 if it not exist.
         * @param semantic The semantic of the searched input element.
@@ -0,0 +1,84 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADASAXFWL_OBJECTSPILLFILE_H__
+#define __COLLADASAXFWL_OBJECTSPILLFILE_H__
+
+#include "COLLADASaxFWLPrerequisites.h"
+
+#include <cstdio>
+#include <vector>
+
+
+namespace COLLADASaxFWL
+{
+
+    /** Temporary file, objects of one type are moved to, if the loader exceeds its memory budget. Each object
+	is stored as the payload BinaryCacheWriter::storeObject() creates for it. The payloads are read back in the
+	order they have been written, when the objects are written in the post processing. The file is deleted,
+	when the object is destroyed.*/
+	class ObjectSpillFile
+	{
+	private:
+		/** The temporary file. Null, if nothing has been written yet or the file could not be created.*/
+		FILE* mFile;
+
+		/** The number of payloads written to the file.*/
+		size_t mPayloadsCount;
+
+		/** The number of payloads read from the file since the last call of startReading().*/
+		size_t mReadPayloadsCount;
+
+		/** The number of bytes of the payloads written to the file. Bytes of payloads that could not be
+		written completely are not counted.*/
+		size_t mBytesCount;
+
+		/** True, if a call of write() failed. All further calls fail as well.*/
+		bool mWriteFailed;
+
+	public:
+
+        /** Constructor. */
+		ObjectSpillFile();
+
+        /** Destructor. Deletes the file.*/
+		virtual ~ObjectSpillFile();
+
+		/** Appends @a payload to the file. Must not be called after startReading().
+		@return True on success, false if the file could not be created or written or a previous call of
+		write() failed.*/
+		bool write( const std::vector<char>& payload );
+
+		/** Prepares reading the payloads, starting with the first one written.
+		@return True on success, false otherwise.*/
+		bool startReading();
+
+		/** Reads the next payload to @a payload.
+		@return True on success, false if all payloads have been read or the file could not be read.*/
+		bool read( std::vector<char>& payload );
+
+		/** Returns the number of payloads written to the file.*/
+		size_t getPayloadsCount() const { return mPayloadsCount; }
+
+		/** Returns the number of bytes written to the file.*/
+		size_t getBytesCount() const { return mBytesCount; }
+
+	private:
+
+        /** Disable default copy ctor. */
+		ObjectSpillFile( const ObjectSpillFile& pre );
+
+        /** Disable default assignment operator. */
+		const ObjectSpillFile& operator= ( const ObjectSpillFile& pre );
+	};
+
+} // namespace COLLADASAXFWL
+
+#endif // __COLLADASAXFWL_OBJECTSPILLFILE_H__
@@ -14,6 +14,14 @@
 #include "COLLADASaxFWLPrerequisites.h"
 #include "COLLADASaxFWLDocumentProcessor.h"
 
+#include <vector>
+
+
+namespace COLLADABU
+{
+	class Timer;
+}
+
 
 namespace COLLADASaxFWL
 {
@@ -22,6 +30,8 @@ namespace COLLADASaxFWL
 	class PostProcessor : public DocumentProcessor 
 	{
 	private:
+		/** List of sid tree nodes, sid addresses have been resolved to.*/
+		typedef std::vector<const SidTreeNode*> SidTreeNodePointerList;
 	
 	public:
 		/** Constructor.
@@ -42,9 +52,17 @@ namespace COLLADASaxFWL
         /** Destructor. */
 		virtual ~PostProcessor();
 
-		/** Performs all the required post processing.:*/
+		/** Performs all the required post processing. The time spent in each phase is stored in the loaders
+		post processing timings.*/
 		void postProcess();
 
+		/** Called at the end of each document followed by another one, if the loader has a memory budget, see
+		Loader::setMemoryBudget(). Creates the animation lists of all bindings that can be resolved and keeps
+		the other ones for the next document. If the memory budget is still exceeded and no formulas are used,
+		moves effects, lights and cameras and, if nothing but the writer references them, visual scenes and 
+		library nodes to the spill files of the loader, until the budget is met.*/
+		void finishDocument();
+
 		/**************   should be removed after a redesign of IFileLoader **********/
 
 		/** Sets the parser to @a parserToBeSet.*/
@@ -59,6 +77,15 @@ namespace COLLADASaxFWL
 
 	private:
 
+		/** Replaces the geometries of the instance geometries of all visual scenes and library nodes, that are
+		duplicates of other geometries, by these geometries, see Loader::setInstanceDuplicateGeometries().*/
+		void instanceDuplicateGeometries();
+
+		/** Replaces the duplicate geometries of the instance geometries of @a nodes and all their 
+		descendants. Instances of moved copies are moved into new child nodes with the transformation of the 
+		copy.*/
+		void instanceDuplicateGeometries( COLLADAFW::NodePointerArray& nodes );
+
 		/** Writes all the visual scenes.*/
 		void writeVisualScenes();
 
@@ -74,11 +101,72 @@ namespace COLLADASaxFWL
 		/** Writes all the cameras.*/
 		void writeCameras();
 
-		/** Creates all the animation lists.*/
+		/** Creates all the animation lists. The bindings moved to the spill file of the loader are processed 
+		first, since they have been added before the bindings kept in memory.*/
 		void createMissingAnimationLists();
 
-		/** Stores the binding stored in @a binding in the appropriate animation list*/
-		void createMissingAnimationList( const Loader::AnimationSidAddressBinding& binding );
+		/** Creates the animation lists for the bindings moved to the spill file of the loader and the bindings
+		kept in memory, in the order they have been added.
+		@param unresolvedBindings Receives the bindings whose sid addresses could not be resolved. Might be null.*/
+		void createMissingAnimationListsOfAllBindings( Loader::AnimationSidAddressBindingList* unresolvedBindings );
+
+		/** Creates the animation lists for all bindings in @a bindings.
+		@param unresolvedBindings Receives the bindings whose sid addresses could not be resolved. Might be null.*/
+		void createMissingAnimationLists( const Loader::AnimationSidAddressBindingList& bindings, Loader::AnimationSidAddressBindingList* unresolvedBindings );
+
+		/** Stores the binding stored in @a binding in the appropriate animation list
+		@param sidTreeNode The sid tree node the sid address of @a binding resolves to.*/
+		void createMissingAnimationList( const Loader::AnimationSidAddressBinding& binding, const SidTreeNode* sidTreeNode );
+
+		/** Resolves all the sid addresses in @a sidAddresses concurrently. All resolved sid addresses are 
+		added to the map of resolved sid addresses.
+		@param sidTreeNodes Receives the sid tree node each sid address resolves to, or null if it could not
+		be resolved. Might be null, if only the map of resolved sid addresses should be filled.*/
+		void resolveSids( const SidAddressPointerList& sidAddresses, SidTreeNodePointerList* sidTreeNodes );
+
+		/** Appends the time passed since @a timer has been started to the loaders post processing timings and 
+		restarts @a timer.*/
+		void addPhaseTiming( const char* phaseName, COLLADABU::Timer& timer );
+
+		/** Returns true, if objects should be deleted as soon as they have been written and are no longer 
+		referenced, i.e. if the loader has a memory budget.*/
+		bool releaseWrittenObjects() const { return mColladaLoader->getMemoryBudget() != 0; }
+
+		/** Deletes the visual scenes and library nodes. Called at the end of the post processing, if 
+		releaseWrittenObjects() returns true.*/
+		void releaseNodes();
+
+		/** Returns true, if the nodes of the visual scenes and library nodes are referenced by the kinematics
+		or the formulas, after they have been written.*/
+		bool areNodesReferencedAfterWriting() const;
+
+		/** Returns true, if the visual scenes and library nodes can be moved to the spill files, i.e. if 
+		nothing but the writer references them.*/
+		bool canSpillNodes() const;
+
+		/** Moves the objects at the beginning of @a objects to the spill file of @a category, until the memory
+		budget is met, and releases the sid tree nodes of the moved objects, see SidTreeNode::release().
+		Objects without a recorded sid tree node are not moved.
+		@return The number of objects moved.*/
+		template<class ObjectType>
+		size_t spillObjects( std::vector<ObjectType*>& objects, MemoryUsage::Category category );
+
+		/** Removes the ids of released sid tree nodes from the id map and forgets the resolved sid addresses.
+		Called after objects have been moved to the spill files.*/
+		void removeReleasedSidTreeNodes();
+
+		/** Restores the objects in the spill file of @a category, passes them to @a writeFunction of the 
+		writer and deletes them. The spill file is deleted afterwards.*/
+		template<class ObjectType>
+		void writeSpilledObjects( MemoryUsage::Category category, bool (COLLADAFW::IWriter::*writeFunction)( const ObjectType* ) );
+
+		/** Deletes @a object restored from a spill file, after it has been written.*/
+		template<class ObjectType>
+		void deleteRestoredObject( ObjectType* object ) { FW_DELETE object; }
+
+		/** Passes @a effect restored from a spill file to the document cache or deletes it, after it has been
+		written.*/
+		void deleteRestoredObject( COLLADAFW::Effect* effect );
 
 
 		/** Writes all the morph controllers, stored in the loaders morph controller list.*/
@@ -0,0 +1,65 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADASAXFWL_REALTEXTSOURCE_H__
+#define __COLLADASAXFWL_REALTEXTSOURCE_H__
+
+#include "COLLADASaxFWLPrerequisites.h"
+#include "COLLADASaxFWLSource.h"
+
+#include "COLLADAFWAnimationCurve.h"
+
+#include "GeneratedSaxParserITextDataHandler.h"
+
+
+namespace COLLADASaxFWL
+{
+
+    /** Real source that keeps the character data of its array, instead of the decoded values. The array 
+	element of the source stays empty. Used to decode the values of animation curves not before they are 
+	accessed.*/
+	class RealTextSource : public RealSource, public GeneratedSaxParser::ITextDataHandler
+	{
+	private:
+		/** The character data of the array.*/
+		String mText;
+
+	public:
+
+        /** Constructor. */
+		RealTextSource() {}
+
+        /** Destructor. */
+		virtual ~RealTextSource() {}
+
+		/** Appends the character data of the array.*/
+		virtual bool textData( const ParserChar* text, size_t textLength );
+
+		/** Returns the character data of the array.*/
+		const String& getText() const { return mText; }
+
+		/** Creates lazy values of an animation curve, that decode a copy of the character data of the array
+		to doubles, if @a doublePrecision is true, or to floats otherwise. The caller takes ownership of the 
+		returned object.*/
+		COLLADAFW::AnimationCurve::LazyValues* createLazyValues( bool doublePrecision ) const;
+
+	private:
+
+        /** Disable default copy ctor. */
+		RealTextSource( const RealTextSource& pre );
+
+        /** Disable default assignment operator. */
+		const RealTextSource& operator= ( const RealTextSource& pre );
+
+	};
+
+} // namespace COLLADASAXFWL
+
+#endif // __COLLADASAXFWL_REALTEXTSOURCE_H__
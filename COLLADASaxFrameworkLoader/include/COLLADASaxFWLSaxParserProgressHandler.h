@@ -0,0 +1,60 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License, 
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADASAXFWL_SAXPARSERPROGRESSHANDLER_H__
+#define __COLLADASAXFWL_SAXPARSERPROGRESSHANDLER_H__
+
+#include "COLLADASaxFWLPrerequisites.h"
+
+#include "GeneratedSaxParserIProgressHandler.h"
+
+#include "COLLADAFWTypes.h"
+
+
+namespace COLLADASaxFWL
+{
+
+	class IProgressHandler;
+
+    /** Passes the progress reported by the sax parser of one file to the progress handler of the loader.*/
+	class SaxParserProgressHandler : public GeneratedSaxParser::IProgressHandler
+	{
+	private:
+		/** The progress handler to pass the progress to.*/
+		COLLADASaxFWL::IProgressHandler* mProgressHandler;
+
+		/** The file id of the file parsed.*/
+		COLLADAFW::FileId mFileId;
+
+	public:
+
+        /** Constructor. */
+		SaxParserProgressHandler( COLLADASaxFWL::IProgressHandler* progressHandler, COLLADAFW::FileId fileId );
+
+        /** Destructor. */
+		virtual ~SaxParserProgressHandler();
+
+		/** Passes the progress to the progress handler of the loader.
+		@return False, if the loading should be cancelled.*/
+		bool handleProgress( size_t bytesConsumed, size_t totalBytes, const GeneratedSaxParser::ParserChar* topLevelElementName );
+
+	private:
+
+        /** Disable default copy ctor. */
+		SaxParserProgressHandler( const SaxParserProgressHandler& pre );
+
+        /** Disable default assignment operator. */
+		const SaxParserProgressHandler& operator= ( const SaxParserProgressHandler& pre );
+
+	};
+
+} // namespace COLLADASAXFWL
+
+#endif // __COLLADASAXFWL_SAXPARSERPROGRESSHANDLER_H__
@@ -74,6 +74,9 @@ namespace COLLADASaxFWL
 		/** The id of the starting point. Empty, if address is relative.*/
 		const String& getId() const { return mId; }
 
+		/** The id of the starting point. Empty, if address is relative.*/
+		void setId( const String& id ) { mId = id; }
+
 		/** List of all the sid in the address, starting with the first.*/
 		const SidList& getSids() const { return mSids; }
 
@@ -107,6 +110,9 @@ namespace COLLADASaxFWL
 		/** True, if the address is a valid sid address, false otherwise.*/
 		bool isValid() const { return mIsValid; }
 
+		/** True, if the address is a valid sid address, false otherwise.*/
+		void setIsValid( bool isValid ) { mIsValid = isValid; }
+
 		/** Returns the sid address as a string.*/
 		String getSidAddressString() const;
 
@@ -115,8 +121,23 @@ namespace COLLADASaxFWL
 
 		void parseAddress( const String& sidAddress);
 
+		/** Assigns the range [@a begin, @a end) to the id, if @a hasId is false, otherwise appends it to 
+		the list of sids. @a hasId is set to true.*/
+		void addIdOrSid( const char* begin, const char* end, bool& hasId );
+
+		/** Searches [@a begin, @a end) for a name accessor of the form "sid.name". Returns true if found and sets
+		@a idOrSidBegin and @a idOrSidEnd to the range of the id or sid. @a idOrSidEnd points to the '.'.*/
+		static bool findNameAccessor( const char* begin, const char* end, const char*& idOrSidBegin, const char*& idOrSidEnd );
+
+		/** Checks if [@a begin, @a end) starts with an index accessor of the form "(<number>)". Returns true if
+		so and sets @a indexBegin and @a indexEnd to the range of the number. @a indexEnd points to the ')'.*/
+		static bool findIndexAccessor( const char* begin, const char* end, const char*& indexBegin, const char*& indexEnd );
+
 	};
 
+	/** List of pointers to sid addresses.*/
+	typedef std::vector<const SidAddress*> SidAddressPointerList;
+
 } // namespace COLLADASAXFWL
 
 #endif // __COLLADASAXFWL_SIDADDRESS_H__
@@ -15,7 +15,8 @@
 #include "COLLADAFWAnimatable.h"
 #include "COLLADAFWObject.h"
 
-#include <map>
+#include "COLLADABUhash_map.h"
+
 #include <vector>
 
 namespace COLLADASaxFWL
@@ -31,30 +32,65 @@ namespace COLLADASaxFWL
 	class SidTreeNode 	
 	{
 	public:
-		struct SidIdentifier
+		/** A node in the sub hierarchy of a node together with the hierarchy level it is placed on, relative to 
+		that node. For the determination of the hierarchy level only elements with an sid are considered.*/
+		struct SidTreeNodeAndLevel
 		{
-			SidIdentifier( const String& _sid, size_t _hierarchyLevel)
-				: sid(_sid), hierarchyLevel(_hierarchyLevel){}
+			SidTreeNodeAndLevel( SidTreeNode* _sidTreeNode, size_t _hierarchyLevel)
+				: sidTreeNode(_sidTreeNode), hierarchyLevel(_hierarchyLevel){}
 
-			const String& sid;
+			SidTreeNode* sidTreeNode;
 
-			/** Defines how deep in the hierarchy the node is placed. For the determination of the hierarchy level
-			only elements with an sid are considered.*/
 			size_t hierarchyLevel;
-
-			bool operator<(const SidIdentifier& rhs)const;
 		};
 
-		typedef std::map< SidIdentifier, SidTreeNode*> SidIdentifierSidTreeNodeMap;
+		/** Maps sids to the node with that sid and the lowest hierarchy level.*/
+		typedef COLLADABU::hash_map< String, SidTreeNodeAndLevel > SidStringSidTreeNodeMap;
+
+		/** Allocates the nodes of one sid tree in blocks. The arena is owned by the root node and destroys all
+		the other nodes of the tree, when the root node is deleted.*/
+		class NodeArena
+		{
+		private:
+			/** Number of nodes allocated at once.*/
+			static const size_t NODES_PER_BLOCK = 256;
+
+			typedef std::vector< SidTreeNode* > BlockList;
+
+			/** The allocated blocks. Each block has space for NODES_PER_BLOCK nodes.*/
+			BlockList mBlocks;
+
+			/** The number of nodes already created in the last block.*/
+			size_t mNodesInLastBlock;
+
+		public:
+			/** Constructor. */
+			NodeArena();
+
+			/** Destructor. Destroys all nodes created by createNode.*/
+			~NodeArena();
 
-		typedef std::vector< SidTreeNode*> SidTreeNodeList;
+			/** Creates a new node with @a sid and @a parent.*/
+			SidTreeNode* createNode( const String& sid, SidTreeNode* parent );
+
+			/** Releases all nodes whose parent has been released, see SidTreeNode::releaseSubHierarchies().*/
+			void releaseChildrenOfReleasedNodes();
+
+		private:
+			/** Disable default copy ctor. */
+			NodeArena( const NodeArena& pre );
+
+			/** Disable default assignment operator. */
+			const NodeArena& operator= ( const NodeArena& pre );
+		};
 
 		enum TargetTypeClass
 		{
 			TARGETTYPECLASS_UNKNOWN,
 			TARGETTYPECLASS_OBJECT,
 			TARGETTYPECLASS_ANIMATABLE,
-			TARGETTYPECLASS_INTERMEDIATETARGETABLE
+			TARGETTYPECLASS_INTERMEDIATETARGETABLE,
+			TARGETTYPECLASS_RELEASED		//!< The target has been deleted, see release()
 		};
 
 	private:
@@ -69,12 +105,13 @@ namespace COLLADASaxFWL
 		/** The parent node.*/
 		SidTreeNode *mParent;
 
-		/** Maps sids to the children. One sid can appear more than once, since COLLADA allows sids to appear more than once
-		in different technique elements of the same parent.*/
-		SidIdentifierSidTreeNodeMap mChildren;
+		/** Maps sids to the node with this sid in the entire sub hierarchy, that has the lowest hierarchy level. 
+		One sid can appear more than once, since COLLADA allows sids to appear more than once in different technique
+		elements of the same parent.*/
+		SidStringSidTreeNodeMap mChildren;
 
-		/** List of all direct children. Is used to delete all of them.*/
-		SidTreeNodeList mDirectChildren;
+		/** The arena all nodes of the tree are allocated in. Owned by the root node.*/
+		NodeArena* mArena;
 
 		/** The target the sid points to. Different types of targets are supported. @see mTargetType*/
 		Target mTarget;
@@ -86,10 +123,11 @@ namespace COLLADASaxFWL
 		String mSid;
 	public:
 
-        /** Constructor. */
-		SidTreeNode( const String& sid, SidTreeNode *mParent);
+        /** Constructor. If @a parent is null, the node is the root of a new sid tree and owns the arena all
+		the other nodes of that tree are created in. Create all other nodes using createAndAddChild().*/
+		SidTreeNode( const String& sid, SidTreeNode *parent);
 
-        /** Destructor. */
+        /** Destructor. Deleting the root node destroys the entire tree.*/
 		virtual ~SidTreeNode();
 
 		/** Returns the parent.*/
@@ -125,9 +163,21 @@ namespace COLLADASaxFWL
 		/** Returns the sid.*/
 		const String& getSid() const { return mSid; };
 
+		/** Marks the node as released, since its target has been deleted. The node stays in the tree, but has
+		no target anymore. Call releaseSubHierarchies() on the root node, to release the sub hierarchies of
+		the released nodes.*/
+		void release() { mTarget.object = 0; mTargetType = TARGETTYPECLASS_RELEASED; }
+
+		/** Returns true, if the node has been released.*/
+		bool isReleased() const { return mTargetType == TARGETTYPECLASS_RELEASED; }
+
+		/** Releases all nodes in the sub hierarchies of the released nodes of the tree. Must be called on the
+		root node.*/
+		void releaseSubHierarchies();
+
 		/** Searches for a child with @a sid in the entire sub hierarchy. If there exist more then one child with @a sid, 
 		the one with the lowest hierarchy level is returned. If no child could be found, null is returned.*/
-		SidTreeNode* findChildBySid( const String& sid);
+		SidTreeNode* findChildBySid( const String& sid) const;
 
 
 	private:
@@ -138,8 +188,11 @@ namespace COLLADASaxFWL
         /** Disable default assignment operator. */
 		const SidTreeNode& operator= ( const SidTreeNode& pre );
 
+		/** Adds @a sidTreeNode to the children map, if there is no node with the same sid on a lower hierarchy level.*/
+		void addChild( SidTreeNode *sidTreeNode, size_t hierarchyLevel);
+
 		/** Adds @a sidTreeNode to the children map of all the parent nodes. For each level in the hierarchy */
-		void addChildToParents( SidTreeNode *sidTreeNode, const SidIdentifier& sidIdentifier);
+		void addChildToParents( SidTreeNode *sidTreeNode, size_t hierarchyLevel);
 
 	};
 
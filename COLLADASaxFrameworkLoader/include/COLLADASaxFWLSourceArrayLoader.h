@@ -14,6 +14,7 @@
 #include "COLLADASaxFWLPrerequisites.h"
 #include "COLLADASaxFWLSource.h"
 #include "COLLADASaxFWLFilePartLoader.h"
+#include "COLLADASaxFWLLoader.h"
 #include "COLLADASaxFWLXmlTypes.h"
 #include "COLLADAFWFloatOrDoubleArray.h"
 
@@ -53,8 +54,12 @@ namespace COLLADASaxFWL
 		COLLADA XSD and returns the id it points to.*/
 		static String getIdFromURIFragmentType( const char* uriFragment );
 
-		/** Copies the values contained in @a realSource into @a realsArray .*/
-		static void setRealValues( COLLADAFW::FloatOrDoubleArray& realsArray, const RealSource* realSource );
+		/** Copies the values contained in @a realSource into @a realsArray . @a realSource must be a float or a
+		double source.*/
+		static void setRealValues( COLLADAFW::FloatOrDoubleArray& realsArray, const SourceBase* realSource );
+
+		/** Returns true, if @a dataType is the type of float or double sources.*/
+		static bool isRealDataType( SourceBase::DataType dataType ) { return (dataType == SourceBase::DATA_TYPE_FLOAT) || (dataType == SourceBase::DATA_TYPE_DOUBLE); }
 
 	protected:
 
@@ -72,6 +77,10 @@ namespace COLLADASaxFWL
 		/** Returns the id of the source being parsed.*/
 		const String& getCurrentSourceId() const { return mCurrentSourceId; }
 
+		/** Returns the precision the values of float arrays are stored in. Derived classes return the 
+		precision set in the loader for the kind of data they load.*/
+		virtual Loader::RealPrecision getRealPrecision() const { return Loader::SINGLE_PRECISION; }
+
 		/** Clears all the source loaded by the source array loader.*/
 		void clearSources();
 
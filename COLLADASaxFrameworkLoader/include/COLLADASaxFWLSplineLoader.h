@@ -102,6 +102,11 @@ namespace COLLADASaxFWL
         bool beginInterpolationArray( bool isIdArray );
         bool dataInterpolationArray( const ParserString* data, size_t length );
 
+	protected:
+
+		/** Returns the precision set in the loader for geometry data.*/
+		virtual Loader::RealPrecision getRealPrecision() const;
+
 	private:
 
     };
@@ -17,6 +17,8 @@
 #include "COLLADASaxFWLColladaParserAutoGen15FunctionMapFactory.h"
 
 #include "GeneratedSaxParserParser.h"
+#include "GeneratedSaxParserIProgressHandler.h"
+#include "GeneratedSaxParserITextDataHandler.h"
 
 namespace COLLADASaxFWL14
 {
@@ -55,6 +57,15 @@ namespace COLLADASaxFWL
         /** Indicates which parts of the file have already been parsed. */
         int& mParsedFlags;
 
+        /** The handler the parsing progress is reported to. Might be null. */
+        GeneratedSaxParser::IProgressHandler* mProgressHandler;
+
+        /** The number of bytes parsed between two notifications of the progress handler. */
+        size_t mProgressInterval;
+
+        /** True, if the progress handler cancelled the last parse. */
+        bool mCancelled;
+
     public:
         VersionParser(GeneratedSaxParser::IErrorHandler* errorHandler, 
             FileLoader* fileLoader,
@@ -72,6 +83,14 @@ namespace COLLADASaxFWL
 		If level is invalid, 0 is returned.*/
 		StringHash getElementHash( size_t level = 0 )const;
 
+		/** Skips the element currently opened, including its children. Must only be called from within a 
+		begin function.*/
+		void skipCurrentElement();
+
+		/** Passes the raw character data of the element currently opened to @a handler. Must only be 
+		called from within a begin function.*/
+		void redirectCurrentElementTextData( GeneratedSaxParser::ITextDataHandler* handler );
+
         /**
         * Creates generated parser objects and starts parsing the input file. 
         * Will determine COLLADA version of input file and use appropriate parser.
@@ -79,6 +98,12 @@ namespace COLLADASaxFWL
         bool createAndLaunchParser();
         bool createAndLaunchParser(const char* buffer, int length);
 
+        /** Sets the handler the parsing progress is reported to, every @a progressInterval bytes. */
+        void setProgressHandler( GeneratedSaxParser::IProgressHandler* progressHandler, size_t progressInterval );
+
+        /** Returns true, if the progress handler cancelled the last parse. */
+        bool isCancelled() const { return mCancelled; }
+
     protected:
         void createFunctionMap14();
         void createFunctionMap15();
@@ -0,0 +1,222 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADASAXFWL_WRITERQUEUE_H__
+#define __COLLADASAXFWL_WRITERQUEUE_H__
+
+#include "COLLADASaxFWLPrerequisites.h"
+#include "COLLADASaxFWLBinaryCacheFormat.h"
+#include "COLLADASaxFWLBinaryCacheWriter.h"
+
+#include "COLLADAFWIWriter.h"
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace COLLADASaxFWL
+{
+
+    /** A bounded queue of the calls of a writer, executed by one or more threads. Used by AsyncWriter and
+	FanOutWriter to pass the objects of a load to writers running on other threads.
+
+	Since the loader deletes each object after the write call, objects are stored with
+	BinaryCacheWriter::storeObject() and the stored object is queued. The executing thread restores it and
+	passes it to the writer. A stored object may be shared by several queues. The queue is bounded by the
+	bytes of the stored objects: push() waits until the threads have made room.
+
+	The writer is called without holding the lock of the queue. With several threads, the calls are
+	executed concurrently and may complete out of order.
+
+	All methods except the ones of the threads must be called by the same thread, the loader.*/
+	class WriterQueue
+	{
+	public:
+		/** An object stored with BinaryCacheWriter::storeObject(), shared by the queues it is pushed to.*/
+		typedef std::shared_ptr<const std::vector<char> > PayloadPtr;
+
+		/** Passes @a object to the write method of @a writer for its type.*/
+		typedef bool (*WriteFunction)( COLLADAFW::IWriter* writer, const void* object );
+
+		enum TaskType
+		{
+			TASK_START,
+			TASK_RECORD,
+			TASK_OBJECT,
+			TASK_CANCEL,
+			TASK_FINISH
+		};
+
+		/** A call queued for the writer.*/
+		struct Task
+		{
+			Task( TaskType _type ) : type(_type), recordType(BinaryCacheFormat::RECORD_END), writeFunction(0), object(0), synchronous(false) {}
+
+			TaskType type;
+
+			/** The type of the object to write, for TASK_RECORD and TASK_OBJECT.*/
+			BinaryCacheFormat::RecordType recordType;
+
+			/** The object to restore and write, for TASK_RECORD.*/
+			PayloadPtr payload;
+
+			/** The object to write without copying it, for TASK_OBJECT. It is owned by the loader, that waits
+			until the writer has written it.*/
+			WriteFunction writeFunction;
+			const void* object;
+
+			/** True, if the loader waits until the task has been executed, see getSynchronousSuccess().*/
+			bool synchronous;
+
+			/** The error message, for TASK_CANCEL.*/
+			String errorMessage;
+
+			/** Returns the number of bytes the task counts against the bound of the queue.*/
+			size_t getSize() const { return payload ? payload->size() : 0; }
+		};
+
+	private:
+
+		COLLADAFW::IWriter* mWriter;
+
+		mutable std::mutex mMutex;
+
+		/** Signaled, if a task has been queued or the threads should stop.*/
+		std::condition_variable mTaskQueued;
+
+		/** Signaled, if a task has been executed.*/
+		std::condition_variable mTaskExecuted;
+
+		/** The tasks not yet taken by a thread, in the order of the load.*/
+		std::deque<Task> mTasks;
+
+		size_t mMaxQueuedBytes;
+
+		/** The bytes of the queued tasks and of the tasks being executed.*/
+		size_t mQueuedBytes;
+
+		/** The number of tasks being executed.*/
+		size_t mExecutingCount;
+
+		/** True, if the threads should stop, once the queue is empty.*/
+		bool mStopping;
+
+		/** The result of the last synchronous task.*/
+		bool mSynchronousSuccess;
+
+		/** False, if the writer failed to write an object since the last resetSuccess().*/
+		bool mSuccess;
+
+		/** The type of the first object the writer failed to write.*/
+		BinaryCacheFormat::RecordType mFirstFailedRecordType;
+
+		std::vector<std::thread> mThreads;
+
+	public:
+
+        /** Constructor.
+		@param writer The writer the tasks are executed with.
+		@param maxQueuedBytes The maximum number of bytes of the queued tasks. A single task larger than this
+		is queued nevertheless.*/
+		WriterQueue( COLLADAFW::IWriter* writer, size_t maxQueuedBytes );
+
+        /** Destructor. Drops the queued objects and stops the threads.*/
+		virtual ~WriterQueue();
+
+		/** Returns the writer the tasks are executed with.*/
+		COLLADAFW::IWriter* getWriter() const { return mWriter; }
+
+		/** Starts @a threadCount threads executing the tasks, at least one.*/
+		void startThreads( size_t threadCount );
+
+		/** Stops the threads, after they have executed the queued tasks.*/
+		void stopThreads();
+
+		/** Returns true, while the threads are running.*/
+		bool isRunning() const { return !mThreads.empty(); }
+
+		/** Queues @a task. Waits until the queue has room for it, unless @a bounded is false.*/
+		void push( const Task& task, bool bounded );
+
+		/** Waits until all queued tasks have been executed.*/
+		void waitUntilIdle();
+
+		/** Removes the objects not yet taken by a thread from the queue. Starts, cancels and finishes of the
+		writer are kept.*/
+		void dropObjects();
+
+		/** Returns the number of tasks queued or being executed.*/
+		size_t getPendingCount() const;
+
+		/** Returns the result of the last synchronous task. Valid after waitUntilIdle().*/
+		bool getSynchronousSuccess() const;
+
+		/** Returns false, if the writer failed to write an object since the last resetSuccess(), including
+		the objects, whose result has not been returned to the loader.*/
+		bool getSuccess() const;
+
+		/** Returns the type of the first object the writer failed to write since the last resetSuccess().
+		Valid only, if getSuccess() returns false.*/
+		BinaryCacheFormat::RecordType getFirstFailedRecordType() const;
+
+		/** Forgets the failures of the writer, e.g. at the start of a load.*/
+		void resetSuccess();
+
+		/** Creates a task writing @a object with @a writeMethod. The object is stored in a TASK_RECORD, if
+		possible, see BinaryCacheWriter, such that the task does not refer to the object. Otherwise a
+		TASK_OBJECT referring to the object is created.*/
+		template<class Object, bool (COLLADAFW::IWriter::*writeMethod)(const Object*)>
+		static Task createWriteTask( BinaryCacheFormat::RecordType recordType, const Object* object )
+		{
+			std::shared_ptr<std::vector<char> > payload( new std::vector<char>() );
+			if ( BinaryCacheWriter::storeObject( *object, *payload ) )
+			{
+				Task task( TASK_RECORD );
+				task.recordType = recordType;
+				task.payload = payload;
+				return task;
+			}
+			Task task( TASK_OBJECT );
+			task.recordType = recordType;
+			task.writeFunction = &writeObject<Object, writeMethod>;
+			task.object = object;
+			return task;
+		}
+
+		/** Passes @a object to the write method @a writeMethod of @a writer. Used as WriteFunction.*/
+		template<class Object, bool (COLLADAFW::IWriter::*writeMethod)(const Object*)>
+		static bool writeObject( COLLADAFW::IWriter* writer, const void* object )
+		{
+			return (writer->*writeMethod)( (const Object*)object );
+		}
+
+	private:
+
+        /** Disable default copy ctor. */
+		WriterQueue( const WriterQueue& pre );
+
+        /** Disable default assignment operator. */
+		const WriterQueue& operator= ( const WriterQueue& pre );
+
+		/** The main loop of the threads.*/
+		void work();
+
+		/** Executes @a task.
+		@return False, if the writer failed.*/
+		bool execute( const Task& task );
+	};
+
+} // namespace COLLADASAXFWL
+
+#endif // __COLLADASAXFWL_WRITERQUEUE_H__
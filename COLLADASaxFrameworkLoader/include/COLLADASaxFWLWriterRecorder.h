@@ -0,0 +1,71 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADASAXFWL_WRITERRECORDER_H__
+#define __COLLADASAXFWL_WRITERRECORDER_H__
+
+#include "COLLADASaxFWLPrerequisites.h"
+#include "COLLADASaxFWLBinaryCacheWriter.h"
+#include "COLLADASaxFWLBinaryCacheLoader.h"
+
+
+namespace COLLADASaxFWL
+{
+
+    /** Writer that records all objects of one load, so they can be replayed to other writers afterwards,
+	as often as required and in any order, without the document being parsed again. This replaces loading
+	the same document several times, e.g. to write the scene graph before the geometries.
+
+	The objects are recorded in the format of BinaryCacheWriter, in memory or, for documents too large to
+	keep their objects in memory, in a spill file that is removed by the destructor. During the load, the
+	objects are passed on to the writer given to the constructor, if any.
+
+	If the load contains objects that can not be recorded, see BinaryCacheWriter, isRecorded() returns
+	false after the load and the document has to be loaded again instead of being replayed.*/
+	class WriterRecorder : public BinaryCacheWriter
+	{
+	private:
+		/** The path of the spill file. Empty, if the objects are recorded in memory.*/
+		String mSpillFileName;
+
+	public:
+
+        /** Constructor.
+		@param writer The writer all objects are passed to during the load. Might be null.
+		@param spillFileName The path of the file to record the objects in. Empty, to record them in
+		memory.*/
+		WriterRecorder( COLLADAFW::IWriter* writer = 0, const String& spillFileName = "" );
+
+        /** Destructor. Removes the spill file.*/
+		virtual ~WriterRecorder();
+
+		/** Returns true, if all objects of the last load have been recorded.*/
+		bool isRecorded() const { return isCacheWritten(); }
+
+		/** Replays the recorded objects to @a writer, starting and finishing it. The objects of the types in
+		@a recordTypes are replayed in the order described in BinaryCacheLoader::setRecordTypes(). If
+		@a recordTypes is empty, all objects are replayed in the order they have been recorded.
+		@return True, if the objects have been replayed, false if nothing has been recorded or the writer
+		aborted.*/
+		bool replay( COLLADAFW::IWriter* writer,
+			const BinaryCacheLoader::RecordTypeList& recordTypes = BinaryCacheLoader::RecordTypeList() );
+
+	private:
+
+        /** Disable default copy ctor. */
+		WriterRecorder( const WriterRecorder& pre );
+
+        /** Disable default assignment operator. */
+		const WriterRecorder& operator= ( const WriterRecorder& pre );
+	};
+
+} // namespace COLLADASAXFWL
+
+#endif // __COLLADASAXFWL_WRITERRECORDER_H__
@@ -0,0 +1,18 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADASAXFWL_PERFORMANCETEST_H__
+#define __COLLADASAXFWL_PERFORMANCETEST_H__
+
+/** Measures the parsing of sid addresses against the PCRE implementation it replaces.*/
+void performanceTest();
+
+
+#endif // __COLLADASAXFWL_PERFORMANCETEST_H__
@@ -0,0 +1,28 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __COLLADASAXFWL_SIDADDRESSUNITTEST_H__
+#define __COLLADASAXFWL_SIDADDRESSUNITTEST_H__
+
+#include "COLLADASaxFWLSidAddress.h"
+
+
+/** Parses @a sidAddress into @a result, which must be default constructed, like the constructor of
+SidAddress does, using the regular expressions "(.+)\.(.+)" for the name accessor and
+"([^(]+)(?:\(([0-9]+)\))?(?:\(([0-9]+)\))?" for the index accessors, evaluated by PCRE. This is the
+implementation SidAddress replaces.*/
+void pcreParseSidAddress( const COLLADASaxFWL::String& sidAddress, COLLADASaxFWL::SidAddress& result );
+
+/** Compares the SidAddress parser with pcreParseSidAddress() on hand picked and on random input.
+Returns the number of differences.*/
+size_t sidAddressUnitTest();
+
+
+#endif // __COLLADASAXFWL_SIDADDRESSUNITTEST_H__
@@ -0,0 +1,198 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADASaxFWLStableHeaders.h"
+#include "COLLADASaxFWLAnimationSidAddressBindingSpillFile.h"
+
+
+namespace COLLADASaxFWL
+{
+
+	//------------------------------
+	AnimationSidAddressBindingSpillFile::AnimationSidAddressBindingSpillFile()
+		: mFile(0)
+		, mBindingsCount(0)
+		, mReadBindingsCount(0)
+		, mBytesCount(0)
+		, mWriteFailed(false)
+	{
+	}
+
+	//------------------------------
+	AnimationSidAddressBindingSpillFile::~AnimationSidAddressBindingSpillFile()
+	{
+		// files created by tmpfile() are removed, when they are closed
+		if ( mFile )
+			fclose( mFile );
+	}
+
+	//------------------------------
+	bool AnimationSidAddressBindingSpillFile::write( const Loader::AnimationSidAddressBindingList& bindings )
+	{
+		if ( mWriteFailed )
+			return false;
+
+		if ( !mFile )
+		{
+			mFile = tmpfile();
+			if ( !mFile )
+			{
+				mWriteFailed = true;
+				return false;
+			}
+		}
+
+		// the bindings are appended at the current position, which is never moved while writing, so the file
+		// can grow beyond the range of the offsets fseek() takes
+		size_t bytesCount = mBytesCount;
+		bool success = true;
+		for ( size_t i = 0, count = bindings.size(); success && (i < count); ++i )
+		{
+			const Loader::AnimationSidAddressBinding& binding = bindings[i];
+
+			const COLLADAFW::UniqueId& uniqueId = binding.animationInfo.uniqueId;
+			success = writeNumber( uniqueId.getClassId() )
+				&& writeNumber( uniqueId.getObjectId() )
+				&& writeNumber( uniqueId.getFileId() )
+				&& writeNumber( binding.animationInfo.animationClass );
+
+			const SidAddress& sidAddress = binding.sidAddress;
+			const SidAddress::SidList& sids = sidAddress.getSids();
+			success = success
+				&& writeNumber( sidAddress.isValid() ? 1 : 0 )
+				&& writeString( sidAddress.getId() )
+				&& writeNumber( sids.size() );
+			for ( size_t j = 0, sidsCount = sids.size(); success && (j < sidsCount); ++j )
+			{
+				success = writeString( sids[j] );
+			}
+			success = success
+				&& writeNumber( sidAddress.getMemberSelection() )
+				&& writeString( sidAddress.getMemberSelectionName() )
+				&& writeNumber( sidAddress.getFirstIndex() )
+				&& writeNumber( sidAddress.getSecondIndex() );
+		}
+
+		if ( !success || (fflush( mFile ) != 0) )
+		{
+			// the bindings written before are still read, the incomplete ones behind them are ignored
+			mBytesCount = bytesCount;
+			mWriteFailed = true;
+			return false;
+		}
+		mBindingsCount += bindings.size();
+		return true;
+	}
+
+	//------------------------------
+	bool AnimationSidAddressBindingSpillFile::startReading()
+	{
+		mReadBindingsCount = 0;
+		if ( !mFile )
+			return mBindingsCount == 0;
+		rewind( mFile );
+		return ferror( mFile ) == 0;
+	}
+
+	//------------------------------
+	bool AnimationSidAddressBindingSpillFile::read( size_t maxCount, Loader::AnimationSidAddressBindingList& bindings )
+	{
+		for ( size_t i = 0; (i < maxCount) && (mReadBindingsCount < mBindingsCount); ++i )
+		{
+			size_t classId = 0;
+			unsigned long long objectId = 0;
+			size_t fileId = 0;
+			size_t animationClass = 0;
+			if ( !readSize( classId ) || !readNumber( objectId ) || !readSize( fileId ) || !readSize( animationClass ) )
+				return false;
+
+			AnimationInfo animationInfo;
+			animationInfo.uniqueId = COLLADAFW::UniqueId( (COLLADAFW::ClassId)classId, (COLLADAFW::ObjectId)objectId, (COLLADAFW::FileId)fileId );
+			animationInfo.animationClass = (COLLADAFW::AnimationList::AnimationClass)animationClass;
+
+			SidAddress sidAddress;
+			size_t isValid = 0;
+			String string;
+			size_t sidsCount = 0;
+			if ( !readSize( isValid ) || !readString( string ) || !readSize( sidsCount ) )
+				return false;
+			sidAddress.setIsValid( isValid != 0 );
+			sidAddress.setId( string );
+			for ( size_t j = 0; j < sidsCount; ++j )
+			{
+				if ( !readString( string ) )
+					return false;
+				sidAddress.appendSid( string );
+			}
+
+			size_t memberSelection = 0;
+			size_t firstIndex = 0;
+			size_t secondIndex = 0;
+			if ( !readSize( memberSelection ) || !readString( string ) || !readSize( firstIndex ) || !readSize( secondIndex ) )
+				return false;
+			sidAddress.setMemberSelection( (SidAddress::MemberSelection)memberSelection );
+			sidAddress.setMemberSelectionName( string );
+			sidAddress.setFirstIndex( firstIndex );
+			sidAddress.setSecondIndex( secondIndex );
+
+			bindings.push_back( Loader::AnimationSidAddressBinding( animationInfo, sidAddress ) );
+			++mReadBindingsCount;
+		}
+		return true;
+	}
+
+	//------------------------------
+	bool AnimationSidAddressBindingSpillFile::writeBytes( const void* data, size_t size )
+	{
+		if ( fwrite( data, 1, size, mFile ) != size )
+			return false;
+		mBytesCount += size;
+		return true;
+	}
+
+	//------------------------------
+	bool AnimationSidAddressBindingSpillFile::writeString( const String& string )
+	{
+		return writeNumber( string.size() ) && writeBytes( string.data(), string.size() );
+	}
+
+	//------------------------------
+	bool AnimationSidAddressBindingSpillFile::readBytes( void* data, size_t size )
+	{
+		return fread( data, 1, size, mFile ) == size;
+	}
+
+	//------------------------------
+	bool AnimationSidAddressBindingSpillFile::readNumber( unsigned long long& value )
+	{
+		return readBytes( &value, sizeof(value) );
+	}
+
+	//------------------------------
+	bool AnimationSidAddressBindingSpillFile::readSize( size_t& value )
+	{
+		unsigned long long v = 0;
+		if ( !readNumber( v ) )
+			return false;
+		value = (size_t)v;
+		return true;
+	}
+
+	//------------------------------
+	bool AnimationSidAddressBindingSpillFile::readString( String& string )
+	{
+		size_t length = 0;
+		if ( !readSize( length ) )
+			return false;
+		string.resize( length );
+		return (length == 0) || readBytes( &string[0], length );
+	}
+
+} // namespace COLLADASaxFWL
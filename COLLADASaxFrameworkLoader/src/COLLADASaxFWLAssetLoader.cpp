@@ -39,7 +39,8 @@ namespace COLLADASaxFWL
 		{
 			success = writer()->writeGlobalAsset ( mAsset );
 		}
-		delete mAsset;
+		if ( !retainForDocumentCache( mAsset ) )
+			delete mAsset;
 		finish();
 		return success;
 	}
@@ -0,0 +1,196 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADASaxFWLStableHeaders.h"
+#include "COLLADASaxFWLAsyncWriter.h"
+#include "COLLADASaxFWLWriterQueue.h"
+
+
+namespace COLLADASaxFWL
+{
+
+	namespace
+	{
+		/** Passes @a object to the writer of @a queue. The object is stored and written asynchronously,
+		unless @a synchronous is true or it can not be stored.*/
+		template<class Object, bool (COLLADAFW::IWriter::*writeMethod)(const Object*)>
+		bool write( WriterQueue& queue, BinaryCacheFormat::RecordType recordType, const Object* object, bool synchronous )
+		{
+			if ( !synchronous )
+			{
+				WriterQueue::Task task = WriterQueue::createWriteTask<Object, writeMethod>( recordType, object );
+				if ( task.type == WriterQueue::TASK_RECORD )
+				{
+					queue.push( task, true );
+					return true;
+				}
+			}
+			queue.waitUntilIdle();
+			return (queue.getWriter()->*writeMethod)( object );
+		}
+	}
+
+	//------------------------------
+	AsyncWriter::AsyncWriter( COLLADAFW::IWriter* writer, size_t threadCount, size_t maxQueuedBytes )
+		: mQueue( new WriterQueue( writer, maxQueuedBytes ) )
+	{
+		mQueue->startThreads( threadCount );
+	}
+
+	//------------------------------
+	AsyncWriter::~AsyncWriter()
+	{
+		delete mQueue;
+	}
+
+	//------------------------------
+	size_t AsyncWriter::getPendingCount() const
+	{
+		return mQueue->getPendingCount();
+	}
+
+	//------------------------------
+	bool AsyncWriter::getSuccess() const
+	{
+		return mQueue->getSuccess();
+	}
+
+	//------------------------------
+	BinaryCacheFormat::RecordType AsyncWriter::getFirstFailedRecordType() const
+	{
+		return mQueue->getFirstFailedRecordType();
+	}
+
+	//------------------------------
+	void AsyncWriter::cancel( const String& errorMessage )
+	{
+		mQueue->dropObjects();
+		mQueue->waitUntilIdle();
+		mQueue->getWriter()->cancel( errorMessage );
+	}
+
+	//------------------------------
+	void AsyncWriter::start()
+	{
+		mQueue->waitUntilIdle();
+		mQueue->resetSuccess();
+		mQueue->getWriter()->start();
+	}
+
+	//------------------------------
+	void AsyncWriter::finish()
+	{
+		mQueue->waitUntilIdle();
+		mQueue->getWriter()->finish();
+	}
+
+	//------------------------------
+	bool AsyncWriter::writeGlobalAsset( const COLLADAFW::FileInfo* asset )
+	{
+		return write<COLLADAFW::FileInfo, &COLLADAFW::IWriter::writeGlobalAsset>( *mQueue, BinaryCacheFormat::RECORD_GLOBAL_ASSET, asset, true );
+	}
+
+	//------------------------------
+	bool AsyncWriter::writeScene( const COLLADAFW::Scene* scene )
+	{
+		return write<COLLADAFW::Scene, &COLLADAFW::IWriter::writeScene>( *mQueue, BinaryCacheFormat::RECORD_SCENE, scene, false );
+	}
+
+	//------------------------------
+	bool AsyncWriter::writeVisualScene( const COLLADAFW::VisualScene* visualScene )
+	{
+		return write<COLLADAFW::VisualScene, &COLLADAFW::IWriter::writeVisualScene>( *mQueue, BinaryCacheFormat::RECORD_VISUAL_SCENE, visualScene, false );
+	}
+
+	//------------------------------
+	bool AsyncWriter::writeLibraryNodes( const COLLADAFW::LibraryNodes* libraryNodes )
+	{
+		return write<COLLADAFW::LibraryNodes, &COLLADAFW::IWriter::writeLibraryNodes>( *mQueue, BinaryCacheFormat::RECORD_LIBRARY_NODES, libraryNodes, false );
+	}
+
+	//------------------------------
+	bool AsyncWriter::writeGeometry( const COLLADAFW::Geometry* geometry )
+	{
+		return write<COLLADAFW::Geometry, &COLLADAFW::IWriter::writeGeometry>( *mQueue, BinaryCacheFormat::RECORD_GEOMETRY, geometry, false );
+	}
+
+	//------------------------------
+	bool AsyncWriter::writeMaterial( const COLLADAFW::Material* material )
+	{
+		return write<COLLADAFW::Material, &COLLADAFW::IWriter::writeMaterial>( *mQueue, BinaryCacheFormat::RECORD_MATERIAL, material, true );
+	}
+
+	//------------------------------
+	bool AsyncWriter::writeEffect( const COLLADAFW::Effect* effect )
+	{
+		return write<COLLADAFW::Effect, &COLLADAFW::IWriter::writeEffect>( *mQueue, BinaryCacheFormat::RECORD_EFFECT, effect, false );
+	}
+
+	//------------------------------
+	bool AsyncWriter::writeCamera( const COLLADAFW::Camera* camera )
+	{
+		return write<COLLADAFW::Camera, &COLLADAFW::IWriter::writeCamera>( *mQueue, BinaryCacheFormat::RECORD_CAMERA, camera, false );
+	}
+
+	//------------------------------
+	bool AsyncWriter::writeImage( const COLLADAFW::Image* image )
+	{
+		return write<COLLADAFW::Image, &COLLADAFW::IWriter::writeImage>( *mQueue, BinaryCacheFormat::RECORD_IMAGE, image, true );
+	}
+
+	//------------------------------
+	bool AsyncWriter::writeLight( const COLLADAFW::Light* light )
+	{
+		return write<COLLADAFW::Light, &COLLADAFW::IWriter::writeLight>( *mQueue, BinaryCacheFormat::RECORD_LIGHT, light, false );
+	}
+
+	//------------------------------
+	bool AsyncWriter::writeAnimation( const COLLADAFW::Animation* animation )
+	{
+		return write<COLLADAFW::Animation, &COLLADAFW::IWriter::writeAnimation>( *mQueue, BinaryCacheFormat::RECORD_ANIMATION, animation, false );
+	}
+
+	//------------------------------
+	bool AsyncWriter::writeAnimationList( const COLLADAFW::AnimationList* animationList )
+	{
+		return write<COLLADAFW::AnimationList, &COLLADAFW::IWriter::writeAnimationList>( *mQueue, BinaryCacheFormat::RECORD_ANIMATION_LIST, animationList, false );
+	}
+
+	//------------------------------
+	bool AsyncWriter::writeAnimationClip( const COLLADAFW::AnimationClip* animationClip )
+	{
+		return write<COLLADAFW::AnimationClip, &COLLADAFW::IWriter::writeAnimationClip>( *mQueue, BinaryCacheFormat::RECORD_ANIMATION_CLIP, animationClip, false );
+	}
+
+	//------------------------------
+	bool AsyncWriter::writeSkinControllerData( const COLLADAFW::SkinControllerData* skinControllerData )
+	{
+		return write<COLLADAFW::SkinControllerData, &COLLADAFW::IWriter::writeSkinControllerData>( *mQueue, BinaryCacheFormat::RECORD_SKIN_CONTROLLER_DATA, skinControllerData, false );
+	}
+
+	//------------------------------
+	bool AsyncWriter::writeController( const COLLADAFW::Controller* controller )
+	{
+		return write<COLLADAFW::Controller, &COLLADAFW::IWriter::writeController>( *mQueue, BinaryCacheFormat::RECORD_CONTROLLER, controller, false );
+	}
+
+	//------------------------------
+	bool AsyncWriter::writeFormulas( const COLLADAFW::Formulas* formulas )
+	{
+		return write<COLLADAFW::Formulas, &COLLADAFW::IWriter::writeFormulas>( *mQueue, BinaryCacheFormat::RECORD_FORMULAS, formulas, false );
+	}
+
+	//------------------------------
+	bool AsyncWriter::writeKinematicsScene( const COLLADAFW::KinematicsScene* kinematicsScene )
+	{
+		return write<COLLADAFW::KinematicsScene, &COLLADAFW::IWriter::writeKinematicsScene>( *mQueue, BinaryCacheFormat::RECORD_KINEMATICS_SCENE, kinematicsScene, false );
+	}
+
+} // namespace COLLADASaxFWL
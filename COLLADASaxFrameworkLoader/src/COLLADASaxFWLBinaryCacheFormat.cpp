@@ -0,0 +1,30 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADASaxFWLStableHeaders.h"
+#include "COLLADASaxFWLBinaryCacheFormat.h"
+
+
+namespace COLLADASaxFWL
+{
+
+	const char BinaryCacheFormat::MAGIC[8] = { 'D', 'A', 'E', 'C', 'A', 'C', 'H', 'E' };
+
+	const unsigned int BinaryCacheFormat::VERSION = 2;
+
+	const unsigned int BinaryCacheFormat::BYTE_ORDER_MARK = 0x01020304;
+
+	const unsigned int BinaryCacheFormat::ALIGNMENT = 16;
+
+	const size_t BinaryCacheFormat::HEADER_SIZE = 24;
+
+	const size_t BinaryCacheFormat::RECORD_HEADER_SIZE = 16;
+
+} // namespace COLLADASAXFWL
@@ -0,0 +1,1743 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADASaxFWLStableHeaders.h"
+#include "COLLADASaxFWLBinaryCacheLoader.h"
+#include "COLLADASaxFWLBinaryCacheFormat.h"
+
+#include "COLLADAFWIWriter.h"
+#include "COLLADAFWFileInfo.h"
+#include "COLLADAFWScene.h"
+#include "COLLADAFWVisualScene.h"
+#include "COLLADAFWLibraryNodes.h"
+#include "COLLADAFWNode.h"
+#include "COLLADAFWTranslate.h"
+#include "COLLADAFWRotate.h"
+#include "COLLADAFWScale.h"
+#include "COLLADAFWMatrix.h"
+#include "COLLADAFWLookat.h"
+#include "COLLADAFWSkew.h"
+#include "COLLADAFWInstanceGeometry.h"
+#include "COLLADAFWInstanceNode.h"
+#include "COLLADAFWInstanceCamera.h"
+#include "COLLADAFWInstanceLight.h"
+#include "COLLADAFWInstanceController.h"
+#include "COLLADAFWMesh.h"
+#include "COLLADAFWSpline.h"
+#include "COLLADAFWTriangles.h"
+#include "COLLADAFWLines.h"
+#include "COLLADAFWPolygons.h"
+#include "COLLADAFWPolylist.h"
+#include "COLLADAFWTrifans.h"
+#include "COLLADAFWTristrips.h"
+#include "COLLADAFWLinestrips.h"
+#include "COLLADAFWMaterial.h"
+#include "COLLADAFWEffect.h"
+#include "COLLADAFWEffectCommon.h"
+#include "COLLADAFWCamera.h"
+#include "COLLADAFWImage.h"
+#include "COLLADAFWLight.h"
+#include "COLLADAFWAnimationCurve.h"
+#include "COLLADAFWAnimationList.h"
+#include "COLLADAFWAnimationClip.h"
+#include "COLLADAFWSkinControllerData.h"
+#include "COLLADAFWSkinController.h"
+#include "COLLADAFWMorphController.h"
+#include "COLLADAFWFormulas.h"
+#include "COLLADAFWFormula.h"
+#include "COLLADAFWFormulaNewParam.h"
+#include "COLLADAFWKinematicsScene.h"
+#include "COLLADAFWKinematicsModel.h"
+#include "COLLADAFWKinematicsController.h"
+#include "COLLADAFWInstanceKinematicsScene.h"
+#include "COLLADAFWJoint.h"
+#include "COLLADAFWJointPrimitive.h"
+#include "COLLADAFWAxisInfo.h"
+#include "COLLADAFWMotionProfile.h"
+
+#include "MathMLASTNode.h"
+#include "MathMLASTArithmeticExpression.h"
+#include "MathMLASTBinaryComparisionExpression.h"
+#include "MathMLASTConstantExpression.h"
+#include "MathMLASTFragmentExpression.h"
+#include "MathMLASTFunctionExpression.h"
+#include "MathMLASTLogicExpression.h"
+#include "MathMLASTUnaryArithmeticExpression.h"
+#include "MathMLASTVariableExpression.h"
+
+#if defined(COLLADABU_OS_WIN)
+#	include <windows.h>
+#else
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+
+namespace COLLADASaxFWL
+{
+
+	namespace
+	{
+		/** Reads framework objects from the payload of a record, the counterpart of the serializer of
+		BinaryCacheWriter. Reads beyond the end of the payload make the record invalid and return zeros.
+		Counts larger than the remaining payload are invalid, so corrupt files can not cause huge
+		allocations or endless loops.*/
+		class RecordDeserializer
+		{
+		private:
+			/** The start of the payload, to which arrays are aligned.*/
+			const char* mBegin;
+
+			/** The next byte to read.*/
+			const char* mPosition;
+
+			/** The end of the payload.*/
+			const char* mEnd;
+
+			/** False, if the payload is corrupt or contains an object that can not be restored.*/
+			bool mValid;
+
+		public:
+			RecordDeserializer( const char* payload, size_t size )
+				: mBegin(payload), mPosition(payload), mEnd(payload + size), mValid(true) {}
+
+			bool isValid() const { return mValid; }
+
+			void invalidate() { mValid = false; }
+
+			size_t getRemaining() const { return (size_t)(mEnd - mPosition); }
+
+			/** Returns @a count bytes at the current position and advances it. Returns null, if fewer bytes
+			remain.*/
+			const char* readBytes( size_t count )
+			{
+				if ( !mValid || (count > getRemaining()) )
+				{
+					mValid = false;
+					return 0;
+				}
+				const char* bytes = mPosition;
+				mPosition += count;
+				return bytes;
+			}
+
+			template<class Type>
+			Type readValue()
+			{
+				Type value = Type();
+				const char* bytes = readBytes( sizeof(Type) );
+				if ( bytes )
+					memcpy( &value, bytes, sizeof(Type) );
+				return value;
+			}
+
+			unsigned int readUInt32() { return readValue<unsigned int>(); }
+
+			unsigned long long readUInt64() { return readValue<unsigned long long>(); }
+
+			float readFloat() { return readValue<float>(); }
+
+			double readDouble() { return readValue<double>(); }
+
+			bool readBool() { return readUInt32() != 0; }
+
+			template<class Enum>
+			Enum readEnum() { return (Enum)readUInt32(); }
+
+			/** Reads a count of elements, each stored in at least @a elementSize bytes.*/
+			size_t readCount( size_t elementSize = 1 )
+			{
+				unsigned long long count = readUInt64();
+				if ( count > getRemaining() / elementSize )
+				{
+					mValid = false;
+					return 0;
+				}
+				return (size_t)count;
+			}
+
+			String readString()
+			{
+				size_t length = readCount();
+				const char* characters = readBytes( length );
+				return characters ? String( characters, length ) : String();
+			}
+
+			COLLADAFW::UniqueId readUniqueId()
+			{
+				COLLADAFW::ClassId classId = readEnum<COLLADAFW::ClassId>();
+				COLLADAFW::ObjectId objectId = readUInt64();
+				COLLADAFW::FileId fileId = (COLLADAFW::FileId)readUInt64();
+				return COLLADAFW::UniqueId( classId, objectId, fileId );
+			}
+
+			COLLADABU::URI readURI() { return COLLADABU::URI( readString() ); }
+
+			COLLADABU::Math::Vector3 readVector3()
+			{
+				double x = readDouble();
+				double y = readDouble();
+				double z = readDouble();
+				return COLLADABU::Math::Vector3( x, y, z );
+			}
+
+			void readMatrix4( COLLADABU::Math::Matrix4& matrix )
+			{
+				for ( int i = 0; i < 16; ++i )
+					matrix.setElement( i, readDouble() );
+			}
+
+			/** Skips the padding to the next multiple of the alignment.*/
+			void align() { readBytes( BinaryCacheFormat::getPadding( (size_t)(mPosition - mBegin) ) ); }
+
+			/** Returns the elements of an array in the payload and their count.*/
+			template<class Type>
+			const Type* readArrayData( size_t& count )
+			{
+				count = readCount( sizeof(Type) );
+				align();
+				const char* bytes = readBytes( count * sizeof(Type) );
+				if ( !bytes )
+					count = 0;
+				return (const Type*)bytes;
+			}
+
+			/** Sets the @a count elements @a data of the payload as the elements of the empty array @a array.
+			The array refers to the payload, if the elements are aligned for their type, since the payload
+			outlives the objects restored from it, that are deleted after the write call. Otherwise the
+			elements are copied to memory owned by the array.*/
+			template<class Type>
+			void setArrayData( COLLADAFW::ArrayPrimitiveType<Type>& array, const Type* data, size_t count )
+			{
+				if ( count == 0 )
+					return;
+				if ( ((size_t)data % sizeof(Type)) == 0 )
+				{
+					array.yieldOwnerShip();
+					array.setData( const_cast<Type*>(data), count );
+					return;
+				}
+				array.allocMemory( count );
+				memcpy( array.getData(), data, count * sizeof(Type) );
+				array.setCount( count );
+			}
+
+			/** Reads an array into the empty array @a array, see setArrayData().*/
+			template<class Type>
+			void readArray( COLLADAFW::ArrayPrimitiveType<Type>& array )
+			{
+				size_t count = 0;
+				const Type* data = readArrayData<Type>( count );
+				setArrayData( array, data, count );
+			}
+
+			template<class Type>
+			void readEnumArray( COLLADAFW::ArrayPrimitiveType<Type>& array )
+			{
+				size_t count = readCount( sizeof(unsigned int) );
+				if ( count == 0 )
+					return;
+				array.allocMemory( count );
+				for ( size_t i = 0; i < count; ++i )
+					array.append( readEnum<Type>() );
+			}
+
+			void readUniqueIdArray( COLLADAFW::UniqueIdArray& uniqueIds )
+			{
+				size_t count = readCount();
+				if ( count == 0 )
+					return;
+				uniqueIds.allocMemory( count );
+				uniqueIds.setCount( count );
+				for ( size_t i = 0; i < count; ++i )
+					uniqueIds[i] = readUniqueId();
+			}
+
+			void readAnimatable( COLLADAFW::Animatable& animatable ) { animatable.setAnimationList( readUniqueId() ); }
+
+			void readAnimatableFloat( COLLADAFW::AnimatableFloat& value )
+			{
+				value.setValue( readDouble() );
+				readAnimatable( value );
+			}
+
+			void readFloatOrDoubleArray( COLLADAFW::FloatOrDoubleArray& array )
+			{
+				array.setType( readEnum<COLLADAFW::FloatOrDoubleArray::DataType>() );
+				readAnimatable( array );
+				if ( array.getType() == COLLADAFW::FloatOrDoubleArray::DATA_TYPE_FLOAT )
+					readArray( *array.getFloatValues() );
+				else if ( array.getType() == COLLADAFW::FloatOrDoubleArray::DATA_TYPE_DOUBLE )
+					readArray( *array.getDoubleValues() );
+			}
+
+			void readColor( COLLADAFW::Color& color )
+			{
+				double red = readDouble();
+				double green = readDouble();
+				double blue = readDouble();
+				double alpha = readDouble();
+				String sid = readString();
+				color.set( red, green, blue, alpha, sid );
+				readAnimatable( color );
+			}
+
+			COLLADAFW::FileInfo* readFileInfo();
+			COLLADAFW::Scene* readScene();
+			void readNodes( COLLADAFW::NodePointerArray& nodes );
+			COLLADAFW::Geometry* readGeometry();
+			COLLADAFW::Material* readMaterial();
+			COLLADAFW::Effect* readEffect();
+			COLLADAFW::Camera* readCamera();
+			COLLADAFW::Image* readImage();
+			COLLADAFW::Light* readLight();
+			COLLADAFW::Animation* readAnimation();
+			COLLADAFW::AnimationList* readAnimationList();
+			COLLADAFW::AnimationClip* readAnimationClip();
+			COLLADAFW::SkinControllerData* readSkinControllerData();
+			COLLADAFW::Controller* readController();
+			COLLADAFW::Formulas* readFormulas();
+			COLLADAFW::KinematicsScene* readKinematicsScene();
+
+		private:
+			template<class Instance>
+			Instance* readInstance()
+			{
+				COLLADAFW::UniqueId uniqueId = readUniqueId();
+				String name = readString();
+				COLLADAFW::UniqueId instanciatedObjectId = readUniqueId();
+				Instance* instance = FW_NEW Instance( uniqueId, instanciatedObjectId );
+				instance->setName( name );
+				return instance;
+			}
+
+			template<class Instance>
+			void readInstances( COLLADAFW::PointerArray<Instance>& instances )
+			{
+				size_t count = readCount();
+				instances.allocMemory( count );
+				for ( size_t i = 0; (i < count) && mValid; ++i )
+					instances.append( readInstance<Instance>() );
+			}
+
+			template<class Instance>
+			void readBindingInstances( COLLADAFW::PointerArray<Instance>& instances );
+
+			COLLADAFW::Transformation* readTransformation();
+			void readMeshVertexData( COLLADAFW::MeshVertexData& vertexData );
+			void readIndexLists( COLLADAFW::IndexListArray& indexLists );
+			COLLADAFW::MeshPrimitive* readMeshPrimitive();
+			void readColorOrTexture( COLLADAFW::ColorOrTexture& colorOrTexture );
+			void readFloatOrParam( COLLADAFW::FloatOrParam& floatOrParam );
+			COLLADAFW::EffectCommon* readEffectCommon();
+			COLLADAFW::InstanceKinematicsScene* readInstanceKinematicsScene();
+			void readMotionProfile( COLLADAFW::MotionProfile& motionProfile );
+			void readMathmlConstant( MathML::AST::ConstantExpression& constant );
+			void readMathmlNodes( MathML::AST::NodeList& nodes );
+			MathML::AST::INode* readMathmlNode();
+			MathML::AST::FragmentExpression* readFragmentExpression();
+
+			/** A fragment expression referring to the ast of a formula, that is resolved once all formulas
+			have been read.*/
+			struct FragmentReference
+			{
+				MathML::AST::FragmentExpression* fragment;
+				size_t formulaIndex;
+				size_t astIndex;
+			};
+
+			/** The fragment expressions of the formulas being read, that refer to the ast of a formula.*/
+			std::vector<FragmentReference> mFragmentReferences;
+		};
+
+		//------------------------------
+		COLLADAFW::FileInfo* RecordDeserializer::readFileInfo()
+		{
+			COLLADAFW::FileInfo* asset = FW_NEW COLLADAFW::FileInfo();
+			COLLADAFW::FileInfo::Unit& unit = asset->getUnit();
+			COLLADAFW::FileInfo::Unit::LinearUnit linearUnit = readEnum<COLLADAFW::FileInfo::Unit::LinearUnit>();
+			unit.setLinearUnitName( readString() );
+			unit.setLinearUnitMeter( readDouble() );
+			unit.setLinearUnitUnit( linearUnit );
+			COLLADAFW::FileInfo::Unit::AngularUnit angularUnit = readEnum<COLLADAFW::FileInfo::Unit::AngularUnit>();
+			unit.setAngularUnitName( readString() );
+			unit.setAngularUnit( angularUnit );
+			unit.setTimeUnitName( readString() );
+			asset->setUpAxisType( readEnum<COLLADAFW::FileInfo::UpAxisType>() );
+
+			size_t valuePairsCount = readCount();
+			for ( size_t i = 0; (i < valuePairsCount) && mValid; ++i )
+			{
+				String value1 = readString();
+				String value2 = readString();
+				asset->appendValuePair( value1, value2 );
+			}
+			asset->setAbsoluteFileUri( readURI() );
+			return asset;
+		}
+
+		//------------------------------
+		COLLADAFW::Scene* RecordDeserializer::readScene()
+		{
+			COLLADAFW::Scene* scene = FW_NEW COLLADAFW::Scene( readUniqueId() );
+			if ( readBool() )
+				scene->setInstanceVisualScene( readInstance<COLLADAFW::InstanceVisualScene>() );
+			if ( readBool() )
+				scene->setInstanceKinematicsScene( readInstanceKinematicsScene() );
+			return scene;
+		}
+
+		//------------------------------
+		COLLADAFW::InstanceKinematicsScene* RecordDeserializer::readInstanceKinematicsScene()
+		{
+			COLLADAFW::InstanceKinematicsScene* instanceKinematicsScene = readInstance<COLLADAFW::InstanceKinematicsScene>();
+			readUniqueIdArray( instanceKinematicsScene->getBoundNodes() );
+
+			COLLADAFW::InstanceKinematicsScene::NodeLinkBindingArray& bindings = instanceKinematicsScene->getNodeLinkBindings();
+			size_t bindingsCount = readCount();
+			if ( bindingsCount != 0 )
+			{
+				bindings.allocMemory( bindingsCount );
+				bindings.setCount( bindingsCount );
+				for ( size_t i = 0; i < bindingsCount; ++i )
+				{
+					bindings[i].nodeUniqueId = readUniqueId();
+					bindings[i].kinematicsModelId = (size_t)readUInt64();
+					bindings[i].linkNumber = (size_t)readUInt64();
+				}
+			}
+			instanceKinematicsScene->setFileId( (COLLADAFW::FileId)readUInt64() );
+			return instanceKinematicsScene;
+		}
+
+		//------------------------------
+		COLLADAFW::Transformation* RecordDeserializer::readTransformation()
+		{
+			COLLADAFW::Transformation::TransformationType transformationType = readEnum<COLLADAFW::Transformation::TransformationType>();
+			COLLADAFW::UniqueId animationList = readUniqueId();
+			COLLADAFW::Transformation* transformation = 0;
+			switch ( transformationType )
+			{
+			case COLLADAFW::Transformation::MATRIX:
+				{
+					COLLADAFW::Matrix* matrix = FW_NEW COLLADAFW::Matrix();
+					readMatrix4( matrix->getMatrix() );
+					transformation = matrix;
+				}
+				break;
+			case COLLADAFW::Transformation::TRANSLATE:
+				transformation = FW_NEW COLLADAFW::Translate( readVector3() );
+				break;
+			case COLLADAFW::Transformation::ROTATE:
+				{
+					COLLADABU::Math::Vector3 rotationAxis = readVector3();
+					transformation = FW_NEW COLLADAFW::Rotate( rotationAxis, readDouble() );
+				}
+				break;
+			case COLLADAFW::Transformation::SCALE:
+				transformation = FW_NEW COLLADAFW::Scale( readVector3() );
+				break;
+			case COLLADAFW::Transformation::LOOKAT:
+				{
+					COLLADAFW::Lookat* lookat = FW_NEW COLLADAFW::Lookat();
+					COLLADABU::Math::Vector3 eyePosition = readVector3();
+					COLLADABU::Math::Vector3 interestPointPosition = readVector3();
+					COLLADABU::Math::Vector3 upAxisDirection = readVector3();
+					lookat->setEyePosition( eyePosition );
+					lookat->setInterestPointPosition( interestPointPosition );
+					lookat->setUpAxisDirection( upAxisDirection );
+					transformation = lookat;
+				}
+				break;
+			case COLLADAFW::Transformation::SKEW:
+				{
+					COLLADAFW::Skew* skew = FW_NEW COLLADAFW::Skew();
+					skew->setRotateAxis( readVector3() );
+					skew->setTranslateAxis( readVector3() );
+					skew->setAngle( readFloat() );
+					transformation = skew;
+				}
+				break;
+			default:
+				invalidate();
+				return 0;
+			}
+			transformation->setAnimationList( animationList );
+			return transformation;
+		}
+
+		//------------------------------
+		template<class Instance>
+		void RecordDeserializer::readBindingInstances( COLLADAFW::PointerArray<Instance>& instances )
+		{
+			size_t count = readCount();
+			instances.allocMemory( count );
+			for ( size_t i = 0; (i < count) && mValid; ++i )
+			{
+				Instance* instance = readInstance<Instance>();
+				instances.append( instance );
+
+				COLLADAFW::MaterialBindingArray& materialBindings = instance->getMaterialBindings();
+				size_t bindingsCount = readCount();
+				if ( bindingsCount != 0 )
+				{
+					materialBindings.allocMemory( bindingsCount );
+					materialBindings.setCount( bindingsCount );
+				}
+				for ( size_t j = 0; (j < bindingsCount) && mValid; ++j )
+				{
+					COLLADAFW::MaterialBinding& materialBinding = materialBindings[j];
+					materialBinding.setMaterialId( (COLLADAFW::MaterialId)readUInt64() );
+					materialBinding.setReferencedMaterial( readUniqueId() );
+					materialBinding.setName( readString() );
+
+					COLLADAFW::TextureCoordinateBindingArray& textureCoordinateBindings = materialBinding.getTextureCoordinateBindingArray();
+					size_t textureCount = readCount();
+					if ( textureCount != 0 )
+					{
+						textureCoordinateBindings.allocMemory( textureCount );
+						textureCoordinateBindings.setCount( textureCount );
+					}
+					for ( size_t k = 0; (k < textureCount) && mValid; ++k )
+					{
+						COLLADAFW::TextureCoordinateBinding& textureCoordinateBinding = textureCoordinateBindings[k];
+						textureCoordinateBinding.setTextureMapId( (COLLADAFW::TextureMapId)readUInt64() );
+						textureCoordinateBinding.setSetIndex( (size_t)readUInt64() );
+						textureCoordinateBinding.setSemantic( readString() );
+					}
+				}
+
+				std::vector<COLLADABU::URI>& skeletons = instance->skeletons();
+				size_t skeletonsCount = readCount();
+				for ( size_t j = 0; (j < skeletonsCount) && mValid; ++j )
+					skeletons.push_back( readURI() );
+			}
+		}
+
+		//------------------------------
+		void RecordDeserializer::readNodes( COLLADAFW::NodePointerArray& nodes )
+		{
+			size_t count = readCount();
+			nodes.allocMemory( count );
+			for ( size_t i = 0; (i < count) && mValid; ++i )
+			{
+				COLLADAFW::Node* node = FW_NEW COLLADAFW::Node( readUniqueId() );
+				nodes.append( node );
+				node->setOriginalId( readString() );
+				node->setName( readString() );
+				node->setSid( readString() );
+				node->setType( readEnum<COLLADAFW::Node::NodeType>() );
+
+				COLLADAFW::TransformationPointerArray& transformations = node->getTransformations();
+				size_t transformationsCount = readCount();
+				transformations.allocMemory( transformationsCount );
+				for ( size_t j = 0; (j < transformationsCount) && mValid; ++j )
+				{
+					COLLADAFW::Transformation* transformation = readTransformation();
+					if ( transformation )
+						transformations.append( transformation );
+				}
+
+				readBindingInstances( node->getInstanceGeometries() );
+				readInstances( node->getInstanceNodes() );
+				readInstances( node->getInstanceCameras() );
+				readInstances( node->getInstanceLights() );
+				readBindingInstances( node->getInstanceControllers() );
+				readNodes( node->getChildNodes() );
+			}
+		}
+
+		//------------------------------
+		void RecordDeserializer::readMeshVertexData( COLLADAFW::MeshVertexData& vertexData )
+		{
+			COLLADAFW::FloatOrDoubleArray::DataType type = readEnum<COLLADAFW::FloatOrDoubleArray::DataType>();
+			vertexData.setType( type );
+			readAnimatable( vertexData );
+			size_t valuesCount = 0;
+			if ( type == COLLADAFW::FloatOrDoubleArray::DATA_TYPE_FLOAT )
+			{
+				const float* floatValues = readArrayData<float>( valuesCount );
+				setArrayData( *vertexData.getFloatValues(), floatValues, valuesCount );
+			}
+			else if ( type == COLLADAFW::FloatOrDoubleArray::DATA_TYPE_DOUBLE )
+			{
+				const double* doubleValues = readArrayData<double>( valuesCount );
+				setArrayData( *vertexData.getDoubleValues(), doubleValues, valuesCount );
+			}
+
+			// the inputs refer to consecutive ranges of the values, values after the last one have no input
+			// info, e.g. the positions
+			size_t offset = 0;
+			size_t inputInfosCount = readCount();
+			for ( size_t i = 0; (i < inputInfosCount) && mValid; ++i )
+			{
+				String name = readString();
+				size_t stride = (size_t)readUInt64();
+				size_t length = (size_t)readUInt64();
+				if ( (length > valuesCount - offset) || !mValid )
+				{
+					invalidate();
+					return;
+				}
+				vertexData.appendInputInfos( name, stride, length );
+				offset += length;
+			}
+		}
+
+		//------------------------------
+		void RecordDeserializer::readIndexLists( COLLADAFW::IndexListArray& indexLists )
+		{
+			size_t count = readCount();
+			indexLists.allocMemory( count );
+			for ( size_t i = 0; (i < count) && mValid; ++i )
+			{
+				COLLADAFW::IndexList* indexList = FW_NEW COLLADAFW::IndexList();
+				indexLists.append( indexList );
+				indexList->setName( readString() );
+				indexList->setStride( (size_t)readUInt64() );
+				indexList->setSetIndex( (size_t)readUInt64() );
+				indexList->setInitialIndex( (size_t)readUInt64() );
+				readArray( indexList->getIndices() );
+			}
+		}
+
+		//------------------------------
+		COLLADAFW::MeshPrimitive* RecordDeserializer::readMeshPrimitive()
+		{
+			COLLADAFW::MeshPrimitive::PrimitiveType primitiveType = readEnum<COLLADAFW::MeshPrimitive::PrimitiveType>();
+			COLLADAFW::UniqueId uniqueId = readUniqueId();
+			COLLADAFW::MeshPrimitive* primitive = 0;
+			switch ( primitiveType )
+			{
+			case COLLADAFW::MeshPrimitive::LINES:
+				primitive = FW_NEW COLLADAFW::Lines( uniqueId );
+				break;
+			case COLLADAFW::MeshPrimitive::LINE_STRIPS:
+				primitive = FW_NEW COLLADAFW::Linestrips( uniqueId );
+				break;
+			case COLLADAFW::MeshPrimitive::POLYGONS:
+				primitive = FW_NEW COLLADAFW::Polygons( uniqueId );
+				break;
+			case COLLADAFW::MeshPrimitive::POLYLIST:
+				primitive = FW_NEW COLLADAFW::Polylist( uniqueId );
+				break;
+			case COLLADAFW::MeshPrimitive::TRIANGLES:
+				primitive = FW_NEW COLLADAFW::Triangles( uniqueId );
+				break;
+			case COLLADAFW::MeshPrimitive::TRIANGLE_FANS:
+				primitive = FW_NEW COLLADAFW::Trifans( uniqueId );
+				break;
+			case COLLADAFW::MeshPrimitive::TRIANGLE_STRIPS:
+				primitive = FW_NEW COLLADAFW::Tristrips( uniqueId );
+				break;
+			default:
+				primitive = FW_NEW COLLADAFW::MeshPrimitive( uniqueId, primitiveType );
+				break;
+			}
+
+			primitive->setFaceCount( (size_t)readUInt64() );
+			primitive->setMaterial( readString() );
+			primitive->setMaterialId( (COLLADAFW::MaterialId)readUInt64() );
+			readArray( primitive->getPositionIndices() );
+			readArray( primitive->getNormalIndices() );
+			readArray( primitive->getTangentIndices() );
+			readArray( primitive->getBinormalIndices() );
+			readIndexLists( primitive->getColorIndicesArray() );
+			readIndexLists( primitive->getUVCoordIndicesArray() );
+
+			switch ( primitiveType )
+			{
+			case COLLADAFW::MeshPrimitive::POLYGONS:
+			case COLLADAFW::MeshPrimitive::POLYLIST:
+				readArray( static_cast<COLLADAFW::MeshPrimitiveWithFaceVertexCount<int>*>(primitive)->getGroupedVerticesVertexCountArray() );
+				break;
+			case COLLADAFW::MeshPrimitive::TRIANGLE_FANS:
+				readArray( static_cast<COLLADAFW::Trifans*>(primitive)->getGroupedVerticesVertexCountArray() );
+				static_cast<COLLADAFW::Trifans*>(primitive)->setTrifanCount( (size_t)readUInt64() );
+				break;
+			case COLLADAFW::MeshPrimitive::TRIANGLE_STRIPS:
+				readArray( static_cast<COLLADAFW::Tristrips*>(primitive)->getGroupedVerticesVertexCountArray() );
+				static_cast<COLLADAFW::Tristrips*>(primitive)->setTristripCount( (size_t)readUInt64() );
+				break;
+			case COLLADAFW::MeshPrimitive::LINE_STRIPS:
+				readArray( static_cast<COLLADAFW::Linestrips*>(primitive)->getGroupedVerticesVertexCountArray() );
+				static_cast<COLLADAFW::Linestrips*>(primitive)->setLinestripCount( (size_t)readUInt64() );
+				break;
+			default:
+				break;
+			}
+			return primitive;
+		}
+
+		//------------------------------
+		COLLADAFW::Geometry* RecordDeserializer::readGeometry()
+		{
+			COLLADAFW::UniqueId uniqueId = readUniqueId();
+			String originalId = readString();
+			String name = readString();
+			COLLADAFW::Geometry::GeometryType geometryType = readEnum<COLLADAFW::Geometry::GeometryType>();
+			if ( geometryType == COLLADAFW::Geometry::GEO_TYPE_SPLINE )
+			{
+				COLLADAFW::Spline* spline = FW_NEW COLLADAFW::Spline( uniqueId );
+				spline->setOriginalId( originalId );
+				spline->setName( name );
+				readMeshVertexData( spline->getPositions() );
+				readMeshVertexData( spline->getInTangents() );
+				readMeshVertexData( spline->getOutTangents() );
+				readEnumArray( spline->getInterpolations() );
+				return spline;
+			}
+			if ( geometryType != COLLADAFW::Geometry::GEO_TYPE_MESH )
+			{
+				invalidate();
+				return 0;
+			}
+
+			COLLADAFW::Mesh* mesh = FW_NEW COLLADAFW::Mesh( uniqueId );
+			mesh->setOriginalId( originalId );
+			mesh->setName( name );
+			readMeshVertexData( mesh->getPositions() );
+			readMeshVertexData( mesh->getNormals() );
+			readMeshVertexData( mesh->getColors() );
+			readMeshVertexData( mesh->getUVCoords() );
+			readMeshVertexData( mesh->getTangents() );
+			readMeshVertexData( mesh->getBinormals() );
+
+			COLLADAFW::MeshPrimitiveArray& primitives = mesh->getMeshPrimitives();
+			size_t primitivesCount = readCount();
+			primitives.allocMemory( primitivesCount );
+			for ( size_t i = 0; (i < primitivesCount) && mValid; ++i )
+				primitives.append( readMeshPrimitive() );
+			return mesh;
+		}
+
+		//------------------------------
+		COLLADAFW::Material* RecordDeserializer::readMaterial()
+		{
+			COLLADAFW::Material* material = FW_NEW COLLADAFW::Material( readUniqueId() );
+			material->setOriginalId( readString() );
+			material->setName( readString() );
+			material->setInstantiatedEffect( readUniqueId() );
+			return material;
+		}
+
+		//------------------------------
+		void RecordDeserializer::readColorOrTexture( COLLADAFW::ColorOrTexture& colorOrTexture )
+		{
+			colorOrTexture.setType( readEnum<COLLADAFW::ColorOrTexture::Type>() );
+			readColor( colorOrTexture.getColor() );
+			COLLADAFW::Texture& texture = colorOrTexture.getTexture();
+			texture.setUniqueId( readUniqueId() );
+			texture.setSamplerId( (COLLADAFW::SamplerID)readUInt64() );
+			texture.setTextureMapId( (COLLADAFW::TextureMapId)readUInt64() );
+			texture.setTexcoord( readString() );
+		}
+
+		//------------------------------
+		void RecordDeserializer::readFloatOrParam( COLLADAFW::FloatOrParam& floatOrParam )
+		{
+			floatOrParam.setType( readEnum<COLLADAFW::FloatOrParam::Type>() );
+			floatOrParam.setFloatValue( readFloat() );
+			COLLADAFW::Param param;
+			param.setName( readString() );
+			param.setSid( readString() );
+			param.setType( readEnum<COLLADAFW::ValueType::ColladaType>() );
+			param.setSemantic( readString() );
+			floatOrParam.setParam( param );
+			readAnimatable( floatOrParam );
+		}
+
+		//------------------------------
+		COLLADAFW::EffectCommon* RecordDeserializer::readEffectCommon()
+		{
+			COLLADAFW::EffectCommon* commonEffect = FW_NEW COLLADAFW::EffectCommon();
+			commonEffect->setOriginalId( readString() );
+			commonEffect->setShaderType( readEnum<COLLADAFW::EffectCommon::ShaderType>() );
+			readColorOrTexture( commonEffect->getEmission() );
+			readColorOrTexture( commonEffect->getAmbient() );
+			readColorOrTexture( commonEffect->getDiffuse() );
+			readColorOrTexture( commonEffect->getSpecular() );
+			readFloatOrParam( commonEffect->getShininess() );
+			readColorOrTexture( commonEffect->getReflective() );
+			readFloatOrParam( commonEffect->getReflectivity() );
+			readColorOrTexture( commonEffect->getOpacity() );
+			readColorOrTexture( commonEffect->getTransparent() );
+			readFloatOrParam( commonEffect->getTransparency() );
+			readFloatOrParam( commonEffect->getIndexOfRefraction() );
+			commonEffect->setOpaqueMode( readEnum<COLLADAFW::EffectCommon::OpaqueMode>() );
+
+			COLLADAFW::SamplerPointerArray& samplers = commonEffect->getSamplerPointerArray();
+			size_t samplersCount = readCount();
+			samplers.allocMemory( samplersCount );
+			for ( size_t i = 0; (i < samplersCount) && mValid; ++i )
+			{
+				COLLADAFW::Sampler* sampler = FW_NEW COLLADAFW::Sampler( readUniqueId() );
+				samplers.append( sampler );
+				sampler->setSamplerType( readEnum<COLLADAFW::Sampler::SamplerType>() );
+				sampler->setSource( readUniqueId() );
+				sampler->setMinFilter( readEnum<COLLADAFW::Sampler::SamplerFilter>() );
+				sampler->setMagFilter( readEnum<COLLADAFW::Sampler::SamplerFilter>() );
+				sampler->setMipFilter( readEnum<COLLADAFW::Sampler::SamplerFilter>() );
+				sampler->setWrapS( readEnum<COLLADAFW::Sampler::WrapMode>() );
+				sampler->setWrapT( readEnum<COLLADAFW::Sampler::WrapMode>() );
+				sampler->setWrapP( readEnum<COLLADAFW::Sampler::WrapMode>() );
+				COLLADAFW::Color borderColor;
+				readColor( borderColor );
+				sampler->setBorderColor( borderColor );
+				sampler->setMipmapMaxlevel( (unsigned char)readUInt32() );
+				sampler->setMipmapBias( readFloat() );
+				sampler->setSid( readString() );
+			}
+			return commonEffect;
+		}
+
+		//------------------------------
+		COLLADAFW::Effect* RecordDeserializer::readEffect()
+		{
+			COLLADAFW::Effect* effect = FW_NEW COLLADAFW::Effect( readUniqueId() );
+			effect->setOriginalId( readString() );
+			effect->setName( readString() );
+			COLLADAFW::Color standardColor;
+			readColor( standardColor );
+			effect->setStandardColor( standardColor );
+
+			COLLADAFW::CommonEffectPointerArray& commonEffects = effect->getCommonEffects();
+			size_t commonEffectsCount = readCount();
+			commonEffects.allocMemory( commonEffectsCount );
+			for ( size_t i = 0; (i < commonEffectsCount) && mValid; ++i )
+				commonEffects.append( readEffectCommon() );
+
+			size_t extraTexturesCount = readCount();
+			for ( size_t i = 0; (i < extraTexturesCount) && mValid; ++i )
+			{
+				COLLADAFW::TextureAttributes* textureAttributes = effect->createExtraTextureAttributes();
+				textureAttributes->samplerId = (COLLADAFW::SamplerID)readUInt64();
+				textureAttributes->textureMapId = (COLLADAFW::TextureMapId)readUInt64();
+				textureAttributes->textureSampler = readString();
+				textureAttributes->texCoord = readString();
+			}
+			return effect;
+		}
+
+		//------------------------------
+		COLLADAFW::Camera* RecordDeserializer::readCamera()
+		{
+			COLLADAFW::Camera* camera = FW_NEW COLLADAFW::Camera( readUniqueId() );
+			camera->setOriginalId( readString() );
+			camera->setName( readString() );
+			camera->setCameraType( readEnum<COLLADAFW::Camera::CameraType>() );
+			camera->setDescriptionType( readEnum<COLLADAFW::Camera::DescriptionType>() );
+			readAnimatableFloat( camera->getXFov() );
+			readAnimatableFloat( camera->getYFov() );
+			readAnimatableFloat( camera->getAspectRatio() );
+			readAnimatableFloat( camera->getNearClippingPlane() );
+			readAnimatableFloat( camera->getFarClippingPlane() );
+			return camera;
+		}
+
+		//------------------------------
+		COLLADAFW::Image* RecordDeserializer::readImage()
+		{
+			COLLADAFW::Image* image = FW_NEW COLLADAFW::Image( readUniqueId() );
+			image->setOriginalId( readString() );
+			image->setSourceType( readEnum<COLLADAFW::Image::SourceType>() );
+			image->setName( readString() );
+			image->setFormat( readString() );
+			image->setHeight( readUInt32() );
+			image->setWidth( readUInt32() );
+			image->setDepth( readUInt32() );
+			image->setImageURI( readURI() );
+			return image;
+		}
+
+		//------------------------------
+		COLLADAFW::Light* RecordDeserializer::readLight()
+		{
+			COLLADAFW::Light* light = FW_NEW COLLADAFW::Light( readUniqueId() );
+			light->setOriginalId( readString() );
+			light->setName( readString() );
+			light->setLightType( readEnum<COLLADAFW::Light::LightType>() );
+			readColor( light->getColor() );
+			readAnimatableFloat( light->getConstantAttenuation() );
+			readAnimatableFloat( light->getLinearAttenuation() );
+			readAnimatableFloat( light->getQuadraticAttenuation() );
+			readAnimatableFloat( light->getFallOffAngle() );
+			readAnimatableFloat( light->getFallOffExponent() );
+			return light;
+		}
+
+		//------------------------------
+		COLLADAFW::Animation* RecordDeserializer::readAnimation()
+		{
+			COLLADAFW::UniqueId uniqueId = readUniqueId();
+			String originalId = readString();
+			String name = readString();
+			if ( readEnum<COLLADAFW::Animation::AnimationType>() != COLLADAFW::Animation::ANIMATION_CURVE )
+			{
+				invalidate();
+				return 0;
+			}
+
+			COLLADAFW::AnimationCurve* curve = FW_NEW COLLADAFW::AnimationCurve( uniqueId );
+			curve->setOriginalId( originalId );
+			curve->setName( name );
+			curve->setInPhysicalDimension( readEnum<COLLADAFW::PhysicalDimension>() );
+			readEnumArray( curve->getOutPhysicalDimensions() );
+			curve->setOutDimension( (size_t)readUInt64() );
+			curve->setInterpolationType( readEnum<COLLADAFW::AnimationCurve::InterpolationType>() );
+			readEnumArray( curve->getInterpolationTypes() );
+			readFloatOrDoubleArray( curve->getInputValues() );
+			readFloatOrDoubleArray( curve->getOutputValues() );
+			readFloatOrDoubleArray( curve->getInTangentValues() );
+			readFloatOrDoubleArray( curve->getOutTangentValues() );
+			return curve;
+		}
+
+		//------------------------------
+		COLLADAFW::AnimationList* RecordDeserializer::readAnimationList()
+		{
+			COLLADAFW::AnimationList* animationList = FW_NEW COLLADAFW::AnimationList( readUniqueId() );
+			COLLADAFW::AnimationList::AnimationBindings& bindings = animationList->getAnimationBindings();
+			size_t bindingsCount = readCount();
+			bindings.allocMemory( bindingsCount );
+			for ( size_t i = 0; (i < bindingsCount) && mValid; ++i )
+			{
+				COLLADAFW::AnimationList::AnimationBinding binding;
+				binding.animation = readUniqueId();
+				binding.animationClass = readEnum<COLLADAFW::AnimationList::AnimationClass>();
+				binding.firstIndex = (size_t)readUInt64();
+				binding.secondIndex = (size_t)readUInt64();
+				bindings.append( binding );
+			}
+			return animationList;
+		}
+
+		//------------------------------
+		COLLADAFW::AnimationClip* RecordDeserializer::readAnimationClip()
+		{
+			COLLADAFW::AnimationClip* animationClip = FW_NEW COLLADAFW::AnimationClip( readUniqueId() );
+			animationClip->setOriginalId( readString() );
+			animationClip->setName( readString() );
+			readUniqueIdArray( animationClip->getInstanceAnimationUniqueIds() );
+			return animationClip;
+		}
+
+		//------------------------------
+		COLLADAFW::SkinControllerData* RecordDeserializer::readSkinControllerData()
+		{
+			COLLADAFW::SkinControllerData* skinControllerData = FW_NEW COLLADAFW::SkinControllerData( readUniqueId() );
+			skinControllerData->setOriginalId( readString() );
+			skinControllerData->setName( readString() );
+			skinControllerData->setJointsCount( (size_t)readUInt64() );
+			COLLADABU::Math::Matrix4 bindShapeMatrix;
+			readMatrix4( bindShapeMatrix );
+			skinControllerData->setBindShapeMatrix( bindShapeMatrix );
+
+			COLLADAFW::Matrix4Array& inverseBindMatrices = skinControllerData->getInverseBindMatrices();
+			size_t matricesCount = readCount( 16 * sizeof(double) );
+			if ( matricesCount != 0 )
+			{
+				inverseBindMatrices.allocMemory( matricesCount );
+				inverseBindMatrices.setCount( matricesCount );
+				for ( size_t i = 0; i < matricesCount; ++i )
+					readMatrix4( inverseBindMatrices[i] );
+			}
+
+			readFloatOrDoubleArray( skinControllerData->getWeights() );
+			readArray( skinControllerData->getJointsPerVertex() );
+			readArray( skinControllerData->getWeightIndices() );
+			readArray( skinControllerData->getJointIndices() );
+			return skinControllerData;
+		}
+
+		//------------------------------
+		COLLADAFW::Controller* RecordDeserializer::readController()
+		{
+			COLLADAFW::UniqueId uniqueId = readUniqueId();
+			COLLADAFW::Controller::ControllerType controllerType = readEnum<COLLADAFW::Controller::ControllerType>();
+			COLLADAFW::UniqueId source = readUniqueId();
+			switch ( controllerType )
+			{
+			case COLLADAFW::Controller::CONTROLLER_TYPE_SKIN:
+				{
+					COLLADAFW::SkinController* skinController = FW_NEW COLLADAFW::SkinController( uniqueId );
+					skinController->setSource( source );
+					skinController->setSkinControllerData( readUniqueId() );
+					readUniqueIdArray( skinController->getJoints() );
+					return skinController;
+				}
+			case COLLADAFW::Controller::CONTROLLER_TYPE_MORPH:
+				{
+					COLLADAFW::MorphController* morphController = FW_NEW COLLADAFW::MorphController( uniqueId );
+					morphController->setSource( source );
+					morphController->setOriginalId( readString() );
+					morphController->setName( readString() );
+					readUniqueIdArray( morphController->getMorphTargets() );
+					readFloatOrDoubleArray( morphController->getMorphWeights() );
+					return morphController;
+				}
+			default:
+				invalidate();
+				return 0;
+			}
+		}
+
+		//------------------------------
+		void RecordDeserializer::readMathmlConstant( MathML::AST::ConstantExpression& constant )
+		{
+			MathML::AST::ConstantExpression::Type type = readEnum<MathML::AST::ConstantExpression::Type>();
+			double value = readDouble();
+			switch ( type )
+			{
+			case MathML::AST::ConstantExpression::SCALAR_BOOL:
+				constant.setValue( value != 0.0 );
+				break;
+			case MathML::AST::ConstantExpression::SCALAR_LONG:
+				constant.setValue( (long)value );
+				break;
+			case MathML::AST::ConstantExpression::SCALAR_DOUBLE:
+				constant.setValue( value );
+				break;
+			default:
+				break;
+			}
+			constant.setStringValue( readString() );
+		}
+
+		//------------------------------
+		void RecordDeserializer::readMathmlNodes( MathML::AST::NodeList& nodes )
+		{
+			size_t count = readCount();
+			nodes.reserve( count );
+			for ( size_t i = 0; (i < count) && mValid; ++i )
+				nodes.push_back( readMathmlNode() );
+		}
+
+		//------------------------------
+		MathML::AST::INode* RecordDeserializer::readMathmlNode()
+		{
+			if ( !readBool() || !mValid )
+				return 0;
+
+			switch ( readEnum<MathML::AST::INode::NodeType>() )
+			{
+			case MathML::AST::INode::CONSTANT:
+				{
+					MathML::AST::ConstantExpression* constant = new MathML::AST::ConstantExpression();
+					readMathmlConstant( *constant );
+					return constant;
+				}
+			case MathML::AST::INode::VARIABLE:
+				{
+					MathML::AST::VariableExpression* variable = new MathML::AST::VariableExpression( readString() );
+					if ( readBool() )
+					{
+						MathML::AST::ConstantExpression* value = new MathML::AST::ConstantExpression();
+						readMathmlConstant( *value );
+						variable->setValue( value );
+					}
+					return variable;
+				}
+			case MathML::AST::INode::UNARY:
+				{
+					MathML::AST::UnaryExpression* unary = new MathML::AST::UnaryExpression();
+					unary->setOperator( readEnum<MathML::AST::UnaryExpression::Operator>() );
+					unary->setOperand( readMathmlNode() );
+					return unary;
+				}
+			case MathML::AST::INode::LOGICAL:
+				{
+					MathML::AST::LogicExpression* logic = new MathML::AST::LogicExpression();
+					logic->setOperator( readEnum<MathML::AST::LogicExpression::Operator>() );
+					readMathmlNodes( logic->getOperands() );
+					return logic;
+				}
+			case MathML::AST::INode::COMPARISON:
+				{
+					MathML::AST::BinaryComparisonExpression* comparison = new MathML::AST::BinaryComparisonExpression();
+					comparison->setOperator( readEnum<MathML::AST::BinaryComparisonExpression::Operator>() );
+					comparison->setLeftOperand( readMathmlNode() );
+					comparison->setRightOperand( readMathmlNode() );
+					return comparison;
+				}
+			case MathML::AST::INode::ARITHMETIC:
+				{
+					MathML::AST::ArithmeticExpression* arithmetic = new MathML::AST::ArithmeticExpression();
+					arithmetic->setOperator( readEnum<MathML::AST::ArithmeticExpression::Operator>() );
+					readMathmlNodes( arithmetic->getOperands() );
+					return arithmetic;
+				}
+			case MathML::AST::INode::FUNCTION:
+				{
+					MathML::AST::FunctionExpression* function = new MathML::AST::FunctionExpression( readString() );
+					readMathmlNodes( function->getParameterList() );
+					return function;
+				}
+			case MathML::AST::INode::FRAGMENT:
+				return readFragmentExpression();
+			default:
+				invalidate();
+				return 0;
+			}
+		}
+
+		//------------------------------
+		MathML::AST::FragmentExpression* RecordDeserializer::readFragmentExpression()
+		{
+			String name = readString();
+			MathML::AST::INode::CloneFlags cloneFlags = readEnum<MathML::AST::INode::CloneFlags>();
+			MathML::AST::FragmentExpression* fragment = new MathML::AST::FragmentExpression( name, cloneFlags );
+			if ( cloneFlags & MathML::AST::INode::CLONEFLAG_DEEPCOPY_FRAGMENT )
+			{
+				fragment->setFragment( readMathmlNode() );
+			}
+			else if ( readBool() )
+			{
+				FragmentReference fragmentReference;
+				fragmentReference.fragment = fragment;
+				fragmentReference.formulaIndex = (size_t)readUInt64();
+				fragmentReference.astIndex = (size_t)readUInt64();
+				mFragmentReferences.push_back( fragmentReference );
+			}
+
+			size_t parametersCount = readCount();
+			for ( size_t i = 0; (i < parametersCount) && mValid; ++i )
+			{
+				String parameterName = readString();
+				fragment->addParameter( parameterName, readMathmlNode() );
+			}
+			return fragment;
+		}
+
+		//------------------------------
+		COLLADAFW::Formulas* RecordDeserializer::readFormulas()
+		{
+			COLLADAFW::Formulas* formulas = FW_NEW COLLADAFW::Formulas();
+			COLLADAFW::FormulaArray& formulaArray = formulas->getFormulas();
+			size_t formulasCount = readCount();
+			formulaArray.allocMemory( formulasCount );
+			for ( size_t i = 0; (i < formulasCount) && mValid; ++i )
+			{
+				COLLADAFW::Formula* formula = FW_NEW COLLADAFW::Formula( readUniqueId() );
+				formulaArray.append( formula );
+				formula->setOriginalId( readString() );
+				formula->setName( readString() );
+
+				COLLADAFW::FormulaNewParamPointerArray& newParams = formula->getNewParams();
+				size_t newParamsCount = readCount();
+				newParams.allocMemory( newParamsCount );
+				for ( size_t j = 0; (j < newParamsCount) && mValid; ++j )
+				{
+					COLLADAFW::FormulaNewParam* newParam = FW_NEW COLLADAFW::FormulaNewParam( readEnum<COLLADAFW::FormulaNewParam::ValueType>() );
+					newParams.append( newParam );
+					newParam->setName( readString() );
+					switch ( newParam->getValueType() )
+					{
+					case COLLADAFW::FormulaNewParam::VALUETYPE_FLOAT:
+						newParam->setDoubleValue( readDouble() );
+						break;
+					case COLLADAFW::FormulaNewParam::VALUETYPE_INT:
+						newParam->setIntValue( (int)readUInt32() );
+						break;
+					case COLLADAFW::FormulaNewParam::VALUETYPE_BOOL:
+						newParam->setBoolValue( readBool() );
+						break;
+					default:
+						break;
+					}
+				}
+
+				COLLADAFW::MathmlAstArray& asts = formula->getMathmlAsts();
+				size_t astsCount = readCount();
+				asts.allocMemory( astsCount );
+				for ( size_t j = 0; (j < astsCount) && mValid; ++j )
+					asts.append( readMathmlNode() );
+			}
+
+			for ( size_t i = 0, count = mFragmentReferences.size(); (i < count) && mValid; ++i )
+			{
+				const FragmentReference& fragmentReference = mFragmentReferences[i];
+				if ( (fragmentReference.formulaIndex >= formulaArray.getCount())
+					|| (fragmentReference.astIndex >= formulaArray[fragmentReference.formulaIndex]->getMathmlAsts().getCount()) )
+				{
+					invalidate();
+					break;
+				}
+				fragmentReference.fragment->setFragment( formulaArray[fragmentReference.formulaIndex]->getMathmlAsts()[fragmentReference.astIndex] );
+			}
+			mFragmentReferences.clear();
+			return formulas;
+		}
+
+		//------------------------------
+		void RecordDeserializer::readMotionProfile( COLLADAFW::MotionProfile& motionProfile )
+		{
+			motionProfile.setReferenceSpeed( readFloat() );
+			motionProfile.setReferenceAcceleration( readFloat() );
+			motionProfile.setReferenceDeceleration( readFloat() );
+			motionProfile.setReferenceJerk( readFloat() );
+		}
+
+		//------------------------------
+		COLLADAFW::KinematicsScene* RecordDeserializer::readKinematicsScene()
+		{
+			COLLADAFW::KinematicsScene* kinematicsScene = FW_NEW COLLADAFW::KinematicsScene();
+			std::vector<COLLADAFW::JointPrimitive*> jointPrimitives;
+
+			COLLADAFW::KinematicsModelArray& kinematicsModels = kinematicsScene->getKinematicsModels();
+			size_t kinematicsModelsCount = readCount();
+			kinematicsModels.allocMemory( kinematicsModelsCount );
+			for ( size_t i = 0; (i < kinematicsModelsCount) && mValid; ++i )
+			{
+				COLLADAFW::KinematicsModel* kinematicsModel = FW_NEW COLLADAFW::KinematicsModel( readUniqueId() );
+				kinematicsModels.append( kinematicsModel );
+
+				COLLADAFW::JointPointerArray& joints = kinematicsModel->getJoints();
+				size_t jointsCount = readCount();
+				joints.allocMemory( jointsCount );
+				for ( size_t j = 0; (j < jointsCount) && mValid; ++j )
+				{
+					COLLADAFW::Joint* joint = FW_NEW COLLADAFW::Joint( readUniqueId() );
+					joints.append( joint );
+					joint->setOriginalId( readString() );
+					joint->setName( readString() );
+
+					COLLADAFW::JointPrimitivePointerArray& primitives = joint->getJointPrimitives();
+					size_t primitivesCount = readCount();
+					primitives.allocMemory( primitivesCount );
+					for ( size_t k = 0; (k < primitivesCount) && mValid; ++k )
+					{
+						COLLADAFW::UniqueId primitiveUniqueId = readUniqueId();
+						COLLADAFW::JointPrimitive::Type primitiveType = readEnum<COLLADAFW::JointPrimitive::Type>();
+						COLLADAFW::JointPrimitive* primitive = FW_NEW COLLADAFW::JointPrimitive( primitiveUniqueId, primitiveType );
+						primitives.append( primitive );
+						jointPrimitives.push_back( primitive );
+						primitive->setAxis( readVector3() );
+						primitive->setHardLimitMin( readFloat() );
+						primitive->setHardLimitMax( readFloat() );
+						primitive->setSoftLimitMin( readFloat() );
+						primitive->setSoftLimitMax( readFloat() );
+						COLLADAFW::MotionProfile motionProfile;
+						readMotionProfile( motionProfile );
+						primitive->setMotionProfile( motionProfile );
+					}
+				}
+
+				COLLADAFW::KinematicsModel::LinkJointConnections& linkJointConnections = kinematicsModel->getLinkJointConnections();
+				size_t connectionsCount = readCount();
+				linkJointConnections.allocMemory( connectionsCount );
+				for ( size_t j = 0; (j < connectionsCount) && mValid; ++j )
+				{
+					size_t linkNumber = (size_t)readUInt64();
+					size_t jointIndex = (size_t)readUInt64();
+					COLLADAFW::KinematicsModel::LinkJointConnection* linkJointConnection = FW_NEW COLLADAFW::KinematicsModel::LinkJointConnection( linkNumber, jointIndex );
+					linkJointConnections.append( linkJointConnection );
+					COLLADAFW::TransformationPointerArray& transformations = linkJointConnection->getTransformations();
+					size_t transformationsCount = readCount();
+					transformations.allocMemory( transformationsCount );
+					for ( size_t k = 0; (k < transformationsCount) && mValid; ++k )
+					{
+						COLLADAFW::Transformation* transformation = readTransformation();
+						if ( transformation )
+							transformations.append( transformation );
+					}
+				}
+
+				COLLADAFW::SizeTValuesArray& baseLinks = kinematicsModel->getBaseLinks();
+				size_t baseLinksCount = readCount( sizeof(unsigned long long) );
+				baseLinks.allocMemory( baseLinksCount );
+				for ( size_t j = 0; (j < baseLinksCount) && mValid; ++j )
+					baseLinks.append( (size_t)readUInt64() );
+			}
+
+			COLLADAFW::KinematicsControllerArray& kinematicsControllers = kinematicsScene->getKinematicsControllers();
+			size_t kinematicsControllersCount = readCount();
+			kinematicsControllers.allocMemory( kinematicsControllersCount );
+			for ( size_t i = 0; (i < kinematicsControllersCount) && mValid; ++i )
+			{
+				COLLADAFW::KinematicsController* kinematicsController = FW_NEW COLLADAFW::KinematicsController( readUniqueId() );
+				kinematicsControllers.append( kinematicsController );
+				readUniqueIdArray( kinematicsController->getKinematicsModelUniqueIds() );
+
+				COLLADAFW::AxisInfoArray& axisInfos = kinematicsController->getAxisInfos();
+				size_t axisInfosCount = readCount();
+				if ( axisInfosCount != 0 )
+				{
+					axisInfos.allocMemory( axisInfosCount );
+					axisInfos.setCount( axisInfosCount );
+				}
+				for ( size_t j = 0; (j < axisInfosCount) && mValid; ++j )
+				{
+					COLLADAFW::AxisInfo& axisInfo = axisInfos[j];
+					if ( readBool() )
+					{
+						size_t jointPrimitiveIndex = (size_t)readUInt64();
+						if ( jointPrimitiveIndex >= jointPrimitives.size() )
+						{
+							invalidate();
+							break;
+						}
+						axisInfo.setJointPrimitive( jointPrimitives[jointPrimitiveIndex] );
+					}
+					axisInfo.setIsActive( readBool() );
+					axisInfo.setIsLocked( readBool() );
+					axisInfo.setIndex( (int)readUInt32() );
+				}
+
+				COLLADAFW::MotionProfile linearMotionProfile;
+				readMotionProfile( linearMotionProfile );
+				kinematicsController->setLinearMotionProfile( linearMotionProfile );
+				COLLADAFW::MotionProfile angularMotionProfile;
+				readMotionProfile( angularMotionProfile );
+				kinematicsController->setAngularMotionProfile( angularMotionProfile );
+			}
+
+			COLLADAFW::InstanceKinematicsSceneArray& instanceKinematicsScenes = kinematicsScene->getInstanceKinematicsScenes();
+			size_t instanceKinematicsScenesCount = readCount();
+			instanceKinematicsScenes.allocMemory( instanceKinematicsScenesCount );
+			for ( size_t i = 0; (i < instanceKinematicsScenesCount) && mValid; ++i )
+				instanceKinematicsScenes.append( readInstanceKinematicsScene() );
+			return kinematicsScene;
+		}
+
+		/** A cache file mapped into memory. The arrays of the restored objects refer to the mapping, which is
+		copy on write, so the file is not changed by writers modifying them. The mapping is released by the
+		destructor.*/
+		class MappedFile
+		{
+		private:
+			const char* mData;
+			size_t mSize;
+#if defined(COLLADABU_OS_WIN)
+			HANDLE mFile;
+			HANDLE mMapping;
+#endif
+
+		public:
+			/** Maps the file @a fileName. Check getData(), which is null if the file could not be mapped.*/
+			MappedFile( const String& fileName )
+				: mData(0)
+				, mSize(0)
+#if defined(COLLADABU_OS_WIN)
+				, mFile(INVALID_HANDLE_VALUE)
+				, mMapping(0)
+#endif
+			{
+#if defined(COLLADABU_OS_WIN)
+				mFile = CreateFileA( fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0 );
+				if ( mFile == INVALID_HANDLE_VALUE )
+					return;
+				LARGE_INTEGER fileSize;
+				if ( !GetFileSizeEx( mFile, &fileSize ) || (fileSize.QuadPart <= 0) || ((unsigned long long)fileSize.QuadPart > (size_t)-1) )
+					return;
+				mMapping = CreateFileMappingA( mFile, 0, PAGE_WRITECOPY, 0, 0, 0 );
+				if ( !mMapping )
+					return;
+				mData = (const char*)MapViewOfFile( mMapping, FILE_MAP_COPY, 0, 0, 0 );
+				if ( mData )
+					mSize = (size_t)fileSize.QuadPart;
+#else
+				int file = open( fileName.c_str(), O_RDONLY );
+				if ( file < 0 )
+					return;
+				struct stat fileStatus;
+				if ( (fstat( file, &fileStatus ) == 0) && (fileStatus.st_size > 0) )
+				{
+					void* data = mmap( 0, (size_t)fileStatus.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0 );
+					if ( data != MAP_FAILED )
+					{
+						mData = (const char*)data;
+						mSize = (size_t)fileStatus.st_size;
+					}
+				}
+				// the mapping stays valid after the file has been closed
+				close( file );
+#endif
+			}
+
+			~MappedFile()
+			{
+#if defined(COLLADABU_OS_WIN)
+				if ( mData )
+					UnmapViewOfFile( mData );
+				if ( mMapping )
+					CloseHandle( mMapping );
+				if ( mFile != INVALID_HANDLE_VALUE )
+					CloseHandle( mFile );
+#else
+				if ( mData )
+					munmap( const_cast<char*>(mData), mSize );
+#endif
+			}
+
+			const char* getData() const { return mData; }
+
+			size_t getSize() const { return mSize; }
+
+		private:
+			/** Disable default copy ctor. */
+			MappedFile( const MappedFile& pre );
+
+			/** Disable default assignment operator. */
+			const MappedFile& operator= ( const MappedFile& pre );
+		};
+
+		/** Passes @a object to @a writer, if @a deserializer is valid, and deletes it. Returns false, if the
+		record is invalid, otherwise @a writerSuccess is set to the result of the writer.*/
+		template<class Object>
+		bool writeObject( const RecordDeserializer& deserializer,
+			Object* object,
+			bool (COLLADAFW::IWriter::*writeFunction)(const Object*),
+			COLLADAFW::IWriter* writer,
+			bool& writerSuccess )
+		{
+			bool valid = deserializer.isValid() && object;
+			if ( valid )
+				writerSuccess = (writer->*writeFunction)( object );
+			FW_DELETE object;
+			return valid;
+		}
+
+		/** Deletes @a object and sets it to null, if @a deserializer is invalid. None of the objects restored
+		to be kept contains arrays, so they never refer to the payload.
+		@return True, if @a object is kept.*/
+		template<class Object>
+		bool keepRestoredObject( const RecordDeserializer& deserializer, Object*& object )
+		{
+			if ( deserializer.isValid() && object )
+				return true;
+			FW_DELETE object;
+			object = 0;
+			return false;
+		}
+	}
+
+	//------------------------------
+	BinaryCacheLoader::BinaryCacheLoader()
+	{
+	}
+
+	//------------------------------
+	BinaryCacheLoader::~BinaryCacheLoader()
+	{
+	}
+
+	//------------------------------
+	size_t BinaryCacheLoader::checkHeader( const char* data, size_t size )
+	{
+		RecordDeserializer header( data, size );
+		const char* magic = header.readBytes( sizeof(BinaryCacheFormat::MAGIC) );
+		if ( !magic || (memcmp( magic, BinaryCacheFormat::MAGIC, sizeof(BinaryCacheFormat::MAGIC) ) != 0) )
+		{
+			mErrorMessage = "Not a binary cache file";
+			return 0;
+		}
+		unsigned int version = header.readUInt32();
+		unsigned int byteOrderMark = header.readUInt32();
+		unsigned int alignment = header.readUInt32();
+		header.readUInt32();
+		if ( (version != BinaryCacheFormat::VERSION)
+			|| (byteOrderMark != BinaryCacheFormat::BYTE_ORDER_MARK)
+			|| (alignment != BinaryCacheFormat::ALIGNMENT) )
+		{
+			mErrorMessage = "Binary cache file of another version or byte order";
+			return 0;
+		}
+		String sourceKey = header.readString();
+		header.align();
+		if ( !header.isValid() )
+		{
+			mErrorMessage = "Corrupt binary cache file header";
+			return 0;
+		}
+		if ( !mRequiredSourceKey.empty() && (sourceKey != mRequiredSourceKey) )
+		{
+			mErrorMessage = "Binary cache file of another source";
+			return 0;
+		}
+		return size - header.getRemaining();
+	}
+
+	//------------------------------
+	bool BinaryCacheLoader::replayRecord( const char* data, size_t offset, COLLADAFW::IWriter* writer, bool& abortLoading )
+	{
+		RecordDeserializer recordHeader( data + offset, BinaryCacheFormat::RECORD_HEADER_SIZE );
+		unsigned int recordType = recordHeader.readUInt32();
+		recordHeader.readUInt32();
+		size_t payloadSize = (size_t)recordHeader.readUInt64();
+
+		bool writerSuccess = true;
+		bool valid = loadPayload( (BinaryCacheFormat::RecordType)recordType, data + offset + BinaryCacheFormat::RECORD_HEADER_SIZE, payloadSize, writer, writerSuccess );
+		if ( (recordType == BinaryCacheFormat::RECORD_GLOBAL_ASSET)
+			|| (recordType == BinaryCacheFormat::RECORD_IMAGE)
+			|| (recordType == BinaryCacheFormat::RECORD_MATERIAL) )
+		{
+			abortLoading = !writerSuccess;
+		}
+		return valid;
+	}
+
+	//------------------------------
+	bool BinaryCacheLoader::loadPayload( BinaryCacheFormat::RecordType recordType, const char* payload, size_t size, COLLADAFW::IWriter* writer, bool& writerSuccess )
+	{
+		RecordDeserializer deserializer( payload, size );
+		writerSuccess = true;
+		bool valid = true;
+		switch ( recordType )
+		{
+		case BinaryCacheFormat::RECORD_GLOBAL_ASSET:
+			valid = writeObject( deserializer, deserializer.readFileInfo(), &COLLADAFW::IWriter::writeGlobalAsset, writer, writerSuccess );
+			break;
+		case BinaryCacheFormat::RECORD_SCENE:
+			valid = writeObject( deserializer, deserializer.readScene(), &COLLADAFW::IWriter::writeScene, writer, writerSuccess );
+			break;
+		case BinaryCacheFormat::RECORD_VISUAL_SCENE:
+			{
+				COLLADAFW::VisualScene* visualScene = FW_NEW COLLADAFW::VisualScene( deserializer.readUniqueId() );
+				visualScene->setName( deserializer.readString() );
+				deserializer.readNodes( visualScene->getRootNodes() );
+				valid = writeObject( deserializer, visualScene, &COLLADAFW::IWriter::writeVisualScene, writer, writerSuccess );
+			}
+			break;
+		case BinaryCacheFormat::RECORD_LIBRARY_NODES:
+			{
+				COLLADAFW::LibraryNodes* libraryNodes = FW_NEW COLLADAFW::LibraryNodes();
+				deserializer.readNodes( libraryNodes->getNodes() );
+				valid = writeObject( deserializer, libraryNodes, &COLLADAFW::IWriter::writeLibraryNodes, writer, writerSuccess );
+			}
+			break;
+		case BinaryCacheFormat::RECORD_GEOMETRY:
+			valid = writeObject( deserializer, deserializer.readGeometry(), &COLLADAFW::IWriter::writeGeometry, writer, writerSuccess );
+			break;
+		case BinaryCacheFormat::RECORD_MATERIAL:
+			valid = writeObject( deserializer, deserializer.readMaterial(), &COLLADAFW::IWriter::writeMaterial, writer, writerSuccess );
+			break;
+		case BinaryCacheFormat::RECORD_EFFECT:
+			valid = writeObject( deserializer, deserializer.readEffect(), &COLLADAFW::IWriter::writeEffect, writer, writerSuccess );
+			break;
+		case BinaryCacheFormat::RECORD_CAMERA:
+			valid = writeObject( deserializer, deserializer.readCamera(), &COLLADAFW::IWriter::writeCamera, writer, writerSuccess );
+			break;
+		case BinaryCacheFormat::RECORD_IMAGE:
+			valid = writeObject( deserializer, deserializer.readImage(), &COLLADAFW::IWriter::writeImage, writer, writerSuccess );
+			break;
+		case BinaryCacheFormat::RECORD_LIGHT:
+			valid = writeObject( deserializer, deserializer.readLight(), &COLLADAFW::IWriter::writeLight, writer, writerSuccess );
+			break;
+		case BinaryCacheFormat::RECORD_ANIMATION:
+			valid = writeObject( deserializer, deserializer.readAnimation(), &COLLADAFW::IWriter::writeAnimation, writer, writerSuccess );
+			break;
+		case BinaryCacheFormat::RECORD_ANIMATION_LIST:
+			valid = writeObject( deserializer, deserializer.readAnimationList(), &COLLADAFW::IWriter::writeAnimationList, writer, writerSuccess );
+			break;
+		case BinaryCacheFormat::RECORD_ANIMATION_CLIP:
+			valid = writeObject( deserializer, deserializer.readAnimationClip(), &COLLADAFW::IWriter::writeAnimationClip, writer, writerSuccess );
+			break;
+		case BinaryCacheFormat::RECORD_SKIN_CONTROLLER_DATA:
+			valid = writeObject( deserializer, deserializer.readSkinControllerData(), &COLLADAFW::IWriter::writeSkinControllerData, writer, writerSuccess );
+			break;
+		case BinaryCacheFormat::RECORD_CONTROLLER:
+			valid = writeObject( deserializer, deserializer.readController(), &COLLADAFW::IWriter::writeController, writer, writerSuccess );
+			break;
+		case BinaryCacheFormat::RECORD_FORMULAS:
+			valid = writeObject( deserializer, deserializer.readFormulas(), &COLLADAFW::IWriter::writeFormulas, writer, writerSuccess );
+			break;
+		case BinaryCacheFormat::RECORD_KINEMATICS_SCENE:
+			valid = writeObject( deserializer, deserializer.readKinematicsScene(), &COLLADAFW::IWriter::writeKinematicsScene, writer, writerSuccess );
+			break;
+		default:
+			valid = false;
+			break;
+		}
+		return valid;
+	}
+
+	//------------------------------
+	bool BinaryCacheLoader::restoreObject( const char* payload, size_t size, COLLADAFW::VisualScene*& visualScene )
+	{
+		RecordDeserializer deserializer( payload, size );
+		visualScene = FW_NEW COLLADAFW::VisualScene( deserializer.readUniqueId() );
+		visualScene->setName( deserializer.readString() );
+		deserializer.readNodes( visualScene->getRootNodes() );
+		return keepRestoredObject( deserializer, visualScene );
+	}
+
+	//------------------------------
+	bool BinaryCacheLoader::restoreObject( const char* payload, size_t size, COLLADAFW::LibraryNodes*& libraryNodes )
+	{
+		RecordDeserializer deserializer( payload, size );
+		libraryNodes = FW_NEW COLLADAFW::LibraryNodes();
+		deserializer.readNodes( libraryNodes->getNodes() );
+		return keepRestoredObject( deserializer, libraryNodes );
+	}
+
+	//------------------------------
+	bool BinaryCacheLoader::restoreObject( const char* payload, size_t size, COLLADAFW::Effect*& effect )
+	{
+		RecordDeserializer deserializer( payload, size );
+		effect = deserializer.readEffect();
+		return keepRestoredObject( deserializer, effect );
+	}
+
+	//------------------------------
+	bool BinaryCacheLoader::restoreObject( const char* payload, size_t size, COLLADAFW::Camera*& camera )
+	{
+		RecordDeserializer deserializer( payload, size );
+		camera = deserializer.readCamera();
+		return keepRestoredObject( deserializer, camera );
+	}
+
+	//------------------------------
+	bool BinaryCacheLoader::restoreObject( const char* payload, size_t size, COLLADAFW::Light*& light )
+	{
+		RecordDeserializer deserializer( payload, size );
+		light = deserializer.readLight();
+		return keepRestoredObject( deserializer, light );
+	}
+
+	//------------------------------
+	bool BinaryCacheLoader::replayRecords( const char* data, size_t size, size_t offset, COLLADAFW::IWriter* writer )
+	{
+		// the records are indexed first, so they can be replayed in any order and corrupt record headers
+		// are found before the writer gets any object
+		std::vector<size_t> recordOffsets[BinaryCacheFormat::RECORD_TYPE_COUNT];
+		std::vector<size_t> allRecordOffsets;
+		bool corrupt = false;
+		bool finished = false;
+		while ( !finished && !corrupt )
+		{
+			RecordDeserializer recordHeader( data + offset, size - offset );
+			unsigned int recordType = recordHeader.readUInt32();
+			recordHeader.readUInt32();
+			size_t payloadSize = recordHeader.readCount();
+			if ( !recordHeader.isValid() || (recordType >= BinaryCacheFormat::RECORD_TYPE_COUNT) )
+			{
+				corrupt = true;
+			}
+			else if ( recordType == BinaryCacheFormat::RECORD_END )
+			{
+				finished = true;
+			}
+			else
+			{
+				recordOffsets[recordType].push_back( offset );
+				allRecordOffsets.push_back( offset );
+				offset += BinaryCacheFormat::RECORD_HEADER_SIZE + payloadSize + BinaryCacheFormat::getPadding( payloadSize );
+				corrupt = offset > size;
+			}
+		}
+
+		bool abortLoading = false;
+		if ( mRecordTypes.empty() )
+		{
+			for ( size_t i = 0, count = allRecordOffsets.size(); (i < count) && !corrupt && !abortLoading; ++i )
+				corrupt = !replayRecord( data, allRecordOffsets[i], writer, abortLoading );
+		}
+		else
+		{
+			for ( size_t i = 0, typesCount = mRecordTypes.size(); (i < typesCount) && !corrupt && !abortLoading; ++i )
+			{
+				BinaryCacheFormat::RecordType recordType = mRecordTypes[i];
+				if ( (recordType == BinaryCacheFormat::RECORD_END) || (recordType >= BinaryCacheFormat::RECORD_TYPE_COUNT) )
+					continue;
+				const std::vector<size_t>& offsets = recordOffsets[recordType];
+				for ( size_t j = 0, count = offsets.size(); (j < count) && !corrupt && !abortLoading; ++j )
+					corrupt = !replayRecord( data, offsets[j], writer, abortLoading );
+			}
+		}
+
+		if ( corrupt )
+		{
+			mErrorMessage = "Corrupt binary cache file";
+			writer->cancel( mErrorMessage );
+		}
+		else if ( abortLoading )
+		{
+			mErrorMessage = "Loading aborted by the writer";
+			writer->cancel( "Generic error" );
+		}
+		writer->finish();
+		return !corrupt && !abortLoading;
+	}
+
+	//------------------------------
+	bool BinaryCacheLoader::loadDocument( const String& fileName, COLLADAFW::IWriter* writer )
+	{
+		mErrorMessage.clear();
+		if ( !writer )
+			return false;
+
+		// the records are restored directly from the mapped file, reading it is the fallback for files that
+		// can not be mapped
+		MappedFile mappedFile( fileName );
+		if ( mappedFile.getData() )
+			return loadContent( mappedFile.getData(), mappedFile.getSize(), writer );
+
+		std::vector<char> content;
+		FILE* file = fopen( fileName.c_str(), "rb" );
+		if ( !file )
+		{
+			mErrorMessage = "Could not open \"" + fileName + "\"";
+			return false;
+		}
+		bool readSuccess = (fseek( file, 0, SEEK_END ) == 0);
+		long fileSize = readSuccess ? ftell( file ) : -1;
+		readSuccess = (fileSize > 0) && (fseek( file, 0, SEEK_SET ) == 0);
+		if ( readSuccess )
+		{
+			content.resize( (size_t)fileSize );
+			readSuccess = (fread( &content[0], 1, content.size(), file ) == content.size());
+		}
+		fclose( file );
+		if ( !readSuccess )
+		{
+			mErrorMessage = "Could not read \"" + fileName + "\"";
+			return false;
+		}
+
+		return loadContent( &content[0], content.size(), writer );
+	}
+
+	//------------------------------
+	bool BinaryCacheLoader::loadDocument( const String& uri, const char* buffer, int length, COLLADAFW::IWriter* writer )
+	{
+		mErrorMessage.clear();
+		if ( !writer || !buffer || (length <= 0) )
+			return false;
+
+		size_t offset = checkHeader( buffer, (size_t)length );
+		if ( offset == 0 )
+			return false;
+
+		return replayRecords( buffer, (size_t)length, offset, writer );
+	}
+
+	//------------------------------
+	bool BinaryCacheLoader::loadContent( const char* content, size_t size, COLLADAFW::IWriter* writer )
+	{
+		mErrorMessage.clear();
+		if ( !writer || !content || (size == 0) )
+			return false;
+
+		size_t offset = checkHeader( content, size );
+		if ( offset == 0 )
+			return false;
+
+		writer->start();
+		return replayRecords( content, size, offset, writer );
+	}
+
+} // namespace COLLADASAXFWL
@@ -0,0 +1,1477 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADASaxFWLStableHeaders.h"
+#include "COLLADASaxFWLBinaryCacheWriter.h"
+#include "COLLADASaxFWLBinaryCacheFormat.h"
+
+#include "COLLADAFWFileInfo.h"
+#include "COLLADAFWScene.h"
+#include "COLLADAFWVisualScene.h"
+#include "COLLADAFWLibraryNodes.h"
+#include "COLLADAFWNode.h"
+#include "COLLADAFWTranslate.h"
+#include "COLLADAFWRotate.h"
+#include "COLLADAFWScale.h"
+#include "COLLADAFWMatrix.h"
+#include "COLLADAFWLookat.h"
+#include "COLLADAFWSkew.h"
+#include "COLLADAFWInstanceGeometry.h"
+#include "COLLADAFWInstanceNode.h"
+#include "COLLADAFWInstanceCamera.h"
+#include "COLLADAFWInstanceLight.h"
+#include "COLLADAFWInstanceController.h"
+#include "COLLADAFWGeometry.h"
+#include "COLLADAFWMesh.h"
+#include "COLLADAFWMeshPrimitiveWithFaceVertexCount.h"
+#include "COLLADAFWSpline.h"
+#include "COLLADAFWTrifans.h"
+#include "COLLADAFWTristrips.h"
+#include "COLLADAFWLinestrips.h"
+#include "COLLADAFWMaterial.h"
+#include "COLLADAFWEffect.h"
+#include "COLLADAFWEffectCommon.h"
+#include "COLLADAFWCamera.h"
+#include "COLLADAFWImage.h"
+#include "COLLADAFWLight.h"
+#include "COLLADAFWAnimationCurve.h"
+#include "COLLADAFWAnimationList.h"
+#include "COLLADAFWAnimationClip.h"
+#include "COLLADAFWSkinControllerData.h"
+#include "COLLADAFWSkinController.h"
+#include "COLLADAFWMorphController.h"
+#include "COLLADAFWFormulas.h"
+#include "COLLADAFWFormula.h"
+#include "COLLADAFWFormulaNewParam.h"
+#include "COLLADAFWKinematicsScene.h"
+#include "COLLADAFWKinematicsModel.h"
+#include "COLLADAFWKinematicsController.h"
+#include "COLLADAFWInstanceKinematicsScene.h"
+#include "COLLADAFWJoint.h"
+#include "COLLADAFWJointPrimitive.h"
+#include "COLLADAFWAxisInfo.h"
+#include "COLLADAFWMotionProfile.h"
+
+#include "MathMLASTNode.h"
+#include "MathMLASTArithmeticExpression.h"
+#include "MathMLASTBinaryComparisionExpression.h"
+#include "MathMLASTConstantExpression.h"
+#include "MathMLASTFragmentExpression.h"
+#include "MathMLASTFunctionExpression.h"
+#include "MathMLASTLogicExpression.h"
+#include "MathMLASTUnaryArithmeticExpression.h"
+#include "MathMLASTVariableExpression.h"
+
+#include <algorithm>
+#include <cstring>
+
+
+namespace COLLADASaxFWL
+{
+
+	namespace
+	{
+		/** Serializes framework objects into the payload of a record, see BinaryCacheFormat. The payload starts
+		at an aligned offset of the file, arrays are aligned relative to the start of the payload. Objects
+		that can not be stored make the record invalid.*/
+		class RecordSerializer
+		{
+		private:
+			std::vector<char>& mRecord;
+
+			/** False, if an object can not be stored.*/
+			bool mValid;
+
+		public:
+			RecordSerializer( std::vector<char>& record ) : mRecord(record), mValid(true) { mRecord.clear(); }
+
+			bool isValid() const { return mValid; }
+
+			void invalidate() { mValid = false; }
+
+			void writeBytes( const void* data, size_t count )
+			{
+				if ( count == 0 )
+					return;
+				size_t size = mRecord.size();
+				mRecord.resize( size + count );
+				memcpy( &mRecord[size], data, count );
+			}
+
+			void writeUInt32( unsigned int value ) { writeBytes( &value, sizeof(value) ); }
+
+			void writeUInt64( unsigned long long value ) { writeBytes( &value, sizeof(value) ); }
+
+			void writeFloat( float value ) { writeBytes( &value, sizeof(value) ); }
+
+			void writeDouble( double value ) { writeBytes( &value, sizeof(value) ); }
+
+			void writeBool( bool value ) { writeUInt32( value ? 1 : 0 ); }
+
+			void writeString( const String& value )
+			{
+				writeUInt64( value.size() );
+				writeBytes( value.data(), value.size() );
+			}
+
+			void writeUniqueId( const COLLADAFW::UniqueId& uniqueId )
+			{
+				writeUInt32( (unsigned int)uniqueId.getClassId() );
+				writeUInt64( uniqueId.getObjectId() );
+				writeUInt64( uniqueId.getFileId() );
+			}
+
+			void writeURI( const COLLADABU::URI& uri ) { writeString( uri.getURIString() ); }
+
+			void writeVector3( const COLLADABU::Math::Vector3& vector )
+			{
+				writeDouble( vector.x );
+				writeDouble( vector.y );
+				writeDouble( vector.z );
+			}
+
+			void writeMatrix4( const COLLADABU::Math::Matrix4& matrix )
+			{
+				for ( int i = 0; i < 16; ++i )
+					writeDouble( matrix.getElement( i ) );
+			}
+
+			/** Pads the payload with zeros to the next multiple of the alignment.*/
+			void align() { mRecord.resize( mRecord.size() + BinaryCacheFormat::getPadding( mRecord.size() ) ); }
+
+			template<class Type>
+			void writeArray( const COLLADAFW::ArrayPrimitiveType<Type>& array )
+			{
+				writeUInt64( array.getCount() );
+				align();
+				writeBytes( array.getData(), array.getCount() * sizeof(Type) );
+			}
+
+			/** Writes the enums in @a array as 32 bit values.*/
+			template<class Type>
+			void writeEnumArray( const COLLADAFW::ArrayPrimitiveType<Type>& array )
+			{
+				writeUInt64( array.getCount() );
+				for ( size_t i = 0, count = array.getCount(); i < count; ++i )
+					writeUInt32( (unsigned int)array[i] );
+			}
+
+			void writeUniqueIdArray( const COLLADAFW::UniqueIdArray& uniqueIds )
+			{
+				writeUInt64( uniqueIds.getCount() );
+				for ( size_t i = 0, count = uniqueIds.getCount(); i < count; ++i )
+					writeUniqueId( uniqueIds[i] );
+			}
+
+			void writeAnimatable( const COLLADAFW::Animatable& animatable ) { writeUniqueId( animatable.getAnimationList() ); }
+
+			void writeAnimatableFloat( const COLLADAFW::AnimatableFloat& value )
+			{
+				writeDouble( value.getValue() );
+				writeAnimatable( value );
+			}
+
+			void writeFloatOrDoubleArray( const COLLADAFW::FloatOrDoubleArray& array )
+			{
+				writeUInt32( array.getType() );
+				writeAnimatable( array );
+				if ( array.getType() == COLLADAFW::FloatOrDoubleArray::DATA_TYPE_FLOAT )
+					writeArray( *array.getFloatValues() );
+				else if ( array.getType() == COLLADAFW::FloatOrDoubleArray::DATA_TYPE_DOUBLE )
+					writeArray( *array.getDoubleValues() );
+			}
+
+			void writeColor( const COLLADAFW::Color& color )
+			{
+				writeDouble( color.getRed() );
+				writeDouble( color.getGreen() );
+				writeDouble( color.getBlue() );
+				writeDouble( color.getAlpha() );
+				writeString( color.getSid() );
+				writeAnimatable( color );
+			}
+
+			void writeFileInfo( const COLLADAFW::FileInfo& asset );
+			void writeScene( const COLLADAFW::Scene& scene );
+			void writeNodes( const COLLADAFW::NodePointerArray& nodes );
+			void writeGeometry( const COLLADAFW::Geometry& geometry );
+			void writeMaterial( const COLLADAFW::Material& material );
+			void writeEffect( const COLLADAFW::Effect& effect );
+			void writeCamera( const COLLADAFW::Camera& camera );
+			void writeImage( const COLLADAFW::Image& image );
+			void writeLight( const COLLADAFW::Light& light );
+			void writeAnimation( const COLLADAFW::Animation& animation );
+			void writeAnimationList( const COLLADAFW::AnimationList& animationList );
+			void writeAnimationClip( const COLLADAFW::AnimationClip& animationClip );
+			void writeSkinControllerData( const COLLADAFW::SkinControllerData& skinControllerData );
+			void writeController( const COLLADAFW::Controller& controller );
+			void writeFormulas( const COLLADAFW::Formulas& formulas );
+			void writeKinematicsScene( const COLLADAFW::KinematicsScene& kinematicsScene );
+
+		private:
+			template<COLLADAFW::ClassId classId>
+			void writeInstance( const COLLADAFW::InstanceBase<classId>& instance )
+			{
+				writeUniqueId( instance.getUniqueId() );
+				writeString( instance.getName() );
+				writeUniqueId( instance.getInstanciatedObjectId() );
+			}
+
+			template<COLLADAFW::ClassId classId>
+			void writeInstances( const COLLADAFW::PointerArray<COLLADAFW::InstanceBase<classId> >& instances )
+			{
+				writeUInt64( instances.getCount() );
+				for ( size_t i = 0, count = instances.getCount(); i < count; ++i )
+					writeInstance( *instances[i] );
+			}
+
+			template<COLLADAFW::ClassId classId>
+			void writeBindingInstances( const COLLADAFW::PointerArray<COLLADAFW::InstanceBindingBase<classId> >& instances );
+
+			void writeTransformation( const COLLADAFW::Transformation& transformation );
+			void writeMeshVertexData( const COLLADAFW::MeshVertexData& vertexData );
+			void writeIndexLists( const COLLADAFW::IndexListArray& indexLists );
+			void writeMeshPrimitive( const COLLADAFW::MeshPrimitive& primitive );
+			void writeColorOrTexture( const COLLADAFW::ColorOrTexture& colorOrTexture );
+			void writeFloatOrParam( const COLLADAFW::FloatOrParam& floatOrParam );
+			void writeEffectCommon( const COLLADAFW::EffectCommon& commonEffect );
+			void writeInstanceKinematicsScene( const COLLADAFW::InstanceKinematicsScene& instanceKinematicsScene );
+			void writeMotionProfile( const COLLADAFW::MotionProfile& motionProfile );
+			void writeMathmlConstant( const MathML::AST::ConstantExpression& constant );
+			void writeMathmlNodes( const MathML::AST::NodeList& nodes, const COLLADAFW::FormulaArray& formulas );
+			void writeMathmlNode( const MathML::AST::INode* node, const COLLADAFW::FormulaArray& formulas );
+			void writeFragmentExpression( const MathML::AST::FragmentExpression& fragment, const COLLADAFW::FormulaArray& formulas );
+		};
+
+		//------------------------------
+		void RecordSerializer::writeFileInfo( const COLLADAFW::FileInfo& asset )
+		{
+			const COLLADAFW::FileInfo::Unit& unit = asset.getUnit();
+			writeUInt32( unit.getLinearUnitUnit() );
+			writeString( unit.getLinearUnitName() );
+			writeDouble( unit.getLinearUnitMeter() );
+			writeUInt32( unit.getAngularUnit() );
+			writeString( unit.getAngularUnitName() );
+			writeString( unit.getTimeUnitName() );
+			writeUInt32( asset.getUpAxisType() );
+
+			const COLLADAFW::FileInfo::ValuePairPointerArray& valuePairs = asset.getValuePairArray();
+			writeUInt64( valuePairs.getCount() );
+			for ( size_t i = 0, count = valuePairs.getCount(); i < count; ++i )
+			{
+				writeString( valuePairs[i]->first );
+				writeString( valuePairs[i]->second );
+			}
+			writeURI( asset.getAbsoluteFileUri() );
+		}
+
+		//------------------------------
+		void RecordSerializer::writeScene( const COLLADAFW::Scene& scene )
+		{
+			writeUniqueId( scene.getUniqueId() );
+
+			const COLLADAFW::InstanceVisualScene* instanceVisualScene = scene.getInstanceVisualScene();
+			writeBool( instanceVisualScene != 0 );
+			if ( instanceVisualScene )
+				writeInstance( *instanceVisualScene );
+
+			const COLLADAFW::InstanceKinematicsScene* instanceKinematicsScene = scene.getInstanceKinematicsScene();
+			writeBool( instanceKinematicsScene != 0 );
+			if ( instanceKinematicsScene )
+				writeInstanceKinematicsScene( *instanceKinematicsScene );
+		}
+
+		//------------------------------
+		void RecordSerializer::writeInstanceKinematicsScene( const COLLADAFW::InstanceKinematicsScene& instanceKinematicsScene )
+		{
+			writeInstance( instanceKinematicsScene );
+			writeUniqueIdArray( instanceKinematicsScene.getBoundNodes() );
+			const COLLADAFW::InstanceKinematicsScene::NodeLinkBindingArray& bindings = instanceKinematicsScene.getNodeLinkBindings();
+			writeUInt64( bindings.getCount() );
+			for ( size_t i = 0, count = bindings.getCount(); i < count; ++i )
+			{
+				writeUniqueId( bindings[i].nodeUniqueId );
+				writeUInt64( bindings[i].kinematicsModelId );
+				writeUInt64( bindings[i].linkNumber );
+			}
+			writeUInt64( instanceKinematicsScene.getFileId() );
+		}
+
+		//------------------------------
+		void RecordSerializer::writeTransformation( const COLLADAFW::Transformation& transformation )
+		{
+			writeUInt32( transformation.getTransformationType() );
+			writeAnimatable( transformation );
+			switch ( transformation.getTransformationType() )
+			{
+			case COLLADAFW::Transformation::MATRIX:
+				writeMatrix4( static_cast<const COLLADAFW::Matrix&>(transformation).getMatrix() );
+				break;
+			case COLLADAFW::Transformation::TRANSLATE:
+				writeVector3( static_cast<const COLLADAFW::Translate&>(transformation).getTranslation() );
+				break;
+			case COLLADAFW::Transformation::ROTATE:
+				{
+					const COLLADAFW::Rotate& rotate = static_cast<const COLLADAFW::Rotate&>(transformation);
+					writeVector3( rotate.getRotationAxis() );
+					writeDouble( rotate.getRotationAngle() );
+				}
+				break;
+			case COLLADAFW::Transformation::SCALE:
+				writeVector3( static_cast<const COLLADAFW::Scale&>(transformation).getScale() );
+				break;
+			case COLLADAFW::Transformation::LOOKAT:
+				{
+					const COLLADAFW::Lookat& lookat = static_cast<const COLLADAFW::Lookat&>(transformation);
+					writeVector3( lookat.getEyePosition() );
+					writeVector3( lookat.getInterestPointPosition() );
+					writeVector3( lookat.getUpAxisDirection() );
+				}
+				break;
+			case COLLADAFW::Transformation::SKEW:
+				{
+					const COLLADAFW::Skew& skew = static_cast<const COLLADAFW::Skew&>(transformation);
+					writeVector3( skew.getRotateAxis() );
+					writeVector3( skew.getTranslateAxis() );
+					writeFloat( skew.getAngle() );
+				}
+				break;
+			default:
+				invalidate();
+			}
+		}
+
+		//------------------------------
+		template<COLLADAFW::ClassId classId>
+		void RecordSerializer::writeBindingInstances( const COLLADAFW::PointerArray<COLLADAFW::InstanceBindingBase<classId> >& instances )
+		{
+			writeUInt64( instances.getCount() );
+			for ( size_t i = 0, count = instances.getCount(); i < count; ++i )
+			{
+				const COLLADAFW::InstanceBindingBase<classId>& instance = *instances[i];
+				writeInstance( instance );
+
+				const COLLADAFW::MaterialBindingArray& materialBindings = instance.getMaterialBindings();
+				writeUInt64( materialBindings.getCount() );
+				for ( size_t j = 0, bindingsCount = materialBindings.getCount(); j < bindingsCount; ++j )
+				{
+					const COLLADAFW::MaterialBinding& materialBinding = materialBindings[j];
+					writeUInt64( materialBinding.getMaterialId() );
+					writeUniqueId( materialBinding.getReferencedMaterial() );
+					writeString( materialBinding.getName() );
+
+					const COLLADAFW::TextureCoordinateBindingArray& textureCoordinateBindings = materialBinding.getTextureCoordinateBindingArray();
+					writeUInt64( textureCoordinateBindings.getCount() );
+					for ( size_t k = 0, textureCount = textureCoordinateBindings.getCount(); k < textureCount; ++k )
+					{
+						const COLLADAFW::TextureCoordinateBinding& textureCoordinateBinding = textureCoordinateBindings[k];
+						writeUInt64( textureCoordinateBinding.getTextureMapId() );
+						writeUInt64( textureCoordinateBinding.getSetIndex() );
+						writeString( textureCoordinateBinding.getSemantic() );
+					}
+				}
+
+				const std::vector<COLLADABU::URI>& skeletons = instance.skeletons();
+				writeUInt64( skeletons.size() );
+				for ( size_t j = 0, skeletonsCount = skeletons.size(); j < skeletonsCount; ++j )
+					writeURI( skeletons[j] );
+			}
+		}
+
+		//------------------------------
+		void RecordSerializer::writeNodes( const COLLADAFW::NodePointerArray& nodes )
+		{
+			writeUInt64( nodes.getCount() );
+			for ( size_t i = 0, count = nodes.getCount(); i < count; ++i )
+			{
+				const COLLADAFW::Node& node = *nodes[i];
+				writeUniqueId( node.getUniqueId() );
+				writeString( node.getOriginalId() );
+				writeString( node.getName() );
+				writeString( node.getSid() );
+				writeUInt32( node.getType() );
+
+				const COLLADAFW::TransformationPointerArray& transformations = node.getTransformations();
+				writeUInt64( transformations.getCount() );
+				for ( size_t j = 0, transformationsCount = transformations.getCount(); j < transformationsCount; ++j )
+					writeTransformation( *transformations[j] );
+
+				writeBindingInstances( node.getInstanceGeometries() );
+				writeInstances( node.getInstanceNodes() );
+				writeInstances( node.getInstanceCameras() );
+				writeInstances( node.getInstanceLights() );
+				writeBindingInstances( node.getInstanceControllers() );
+				writeNodes( node.getChildNodes() );
+			}
+		}
+
+		//------------------------------
+		void RecordSerializer::writeMeshVertexData( const COLLADAFW::MeshVertexData& vertexData )
+		{
+			writeFloatOrDoubleArray( vertexData );
+			const COLLADAFW::MeshVertexData::InputInfosArray& inputInfos = vertexData.getInputInfosArray();
+			writeUInt64( inputInfos.getCount() );
+			for ( size_t i = 0, count = inputInfos.getCount(); i < count; ++i )
+			{
+				writeString( inputInfos[i]->mName );
+				writeUInt64( inputInfos[i]->mStride );
+				writeUInt64( inputInfos[i]->mLength );
+			}
+		}
+
+		//------------------------------
+		void RecordSerializer::writeIndexLists( const COLLADAFW::IndexListArray& indexLists )
+		{
+			writeUInt64( indexLists.getCount() );
+			for ( size_t i = 0, count = indexLists.getCount(); i < count; ++i )
+			{
+				const COLLADAFW::IndexList& indexList = *indexLists[i];
+				writeString( indexList.getName() );
+				writeUInt64( indexList.getStride() );
+				writeUInt64( indexList.getSetIndex() );
+				writeUInt64( indexList.getInitialIndex() );
+				writeArray( indexList.getIndices() );
+			}
+		}
+
+		//------------------------------
+		void RecordSerializer::writeMeshPrimitive( const COLLADAFW::MeshPrimitive& primitive )
+		{
+			COLLADAFW::MeshPrimitive::PrimitiveType primitiveType = primitive.getPrimitiveType();
+			writeUInt32( primitiveType );
+			writeUniqueId( primitive.getUniqueId() );
+			writeUInt64( primitive.getFaceCount() );
+			writeString( primitive.getMaterial() );
+			writeUInt64( primitive.getMaterialId() );
+			writeArray( primitive.getPositionIndices() );
+			writeArray( primitive.getNormalIndices() );
+			writeArray( primitive.getTangentIndices() );
+			writeArray( primitive.getBinormalIndices() );
+			writeIndexLists( primitive.getColorIndicesArray() );
+			writeIndexLists( primitive.getUVCoordIndicesArray() );
+
+			switch ( primitiveType )
+			{
+			case COLLADAFW::MeshPrimitive::POLYGONS:
+			case COLLADAFW::MeshPrimitive::POLYLIST:
+				writeArray( static_cast<const COLLADAFW::MeshPrimitiveWithFaceVertexCount<int>&>(primitive).getGroupedVerticesVertexCountArray() );
+				break;
+			case COLLADAFW::MeshPrimitive::TRIANGLE_FANS:
+				writeArray( static_cast<const COLLADAFW::Trifans&>(primitive).getGroupedVerticesVertexCountArray() );
+				writeUInt64( static_cast<const COLLADAFW::Trifans&>(primitive).getTrifanCount() );
+				break;
+			case COLLADAFW::MeshPrimitive::TRIANGLE_STRIPS:
+				writeArray( static_cast<const COLLADAFW::Tristrips&>(primitive).getGroupedVerticesVertexCountArray() );
+				writeUInt64( static_cast<const COLLADAFW::Tristrips&>(primitive).getTristripCount() );
+				break;
+			case COLLADAFW::MeshPrimitive::LINE_STRIPS:
+				writeArray( static_cast<const COLLADAFW::Linestrips&>(primitive).getGroupedVerticesVertexCountArray() );
+				writeUInt64( static_cast<const COLLADAFW::Linestrips&>(primitive).getLinestripCount() );
+				break;
+			default:
+				break;
+			}
+		}
+
+		//------------------------------
+		void RecordSerializer::writeGeometry( const COLLADAFW::Geometry& geometry )
+		{
+			writeUniqueId( geometry.getUniqueId() );
+			writeString( geometry.getOriginalId() );
+			writeString( geometry.getName() );
+			writeUInt32( geometry.getType() );
+			if ( geometry.getType() == COLLADAFW::Geometry::GEO_TYPE_SPLINE )
+			{
+				const COLLADAFW::Spline& spline = static_cast<const COLLADAFW::Spline&>(geometry);
+				writeMeshVertexData( spline.getPositions() );
+				writeMeshVertexData( spline.getInTangents() );
+				writeMeshVertexData( spline.getOutTangents() );
+				writeEnumArray( spline.getInterpolations() );
+				return;
+			}
+			if ( geometry.getType() != COLLADAFW::Geometry::GEO_TYPE_MESH )
+			{
+				invalidate();
+				return;
+			}
+
+			const COLLADAFW::Mesh& mesh = static_cast<const COLLADAFW::Mesh&>(geometry);
+			writeMeshVertexData( mesh.getPositions() );
+			writeMeshVertexData( mesh.getNormals() );
+			writeMeshVertexData( mesh.getColors() );
+			writeMeshVertexData( mesh.getUVCoords() );
+			writeMeshVertexData( mesh.getTangents() );
+			writeMeshVertexData( mesh.getBinormals() );
+
+			const COLLADAFW::MeshPrimitiveArray& primitives = mesh.getMeshPrimitives();
+			writeUInt64( primitives.getCount() );
+			for ( size_t i = 0, count = primitives.getCount(); i < count; ++i )
+				writeMeshPrimitive( *primitives[i] );
+		}
+
+		//------------------------------
+		void RecordSerializer::writeMaterial( const COLLADAFW::Material& material )
+		{
+			writeUniqueId( material.getUniqueId() );
+			writeString( material.getOriginalId() );
+			writeString( material.getName() );
+			writeUniqueId( material.getInstantiatedEffect() );
+		}
+
+		//------------------------------
+		void RecordSerializer::writeColorOrTexture( const COLLADAFW::ColorOrTexture& colorOrTexture )
+		{
+			writeUInt32( colorOrTexture.getType() );
+			writeColor( colorOrTexture.getColor() );
+			const COLLADAFW::Texture& texture = colorOrTexture.getTexture();
+			writeUniqueId( texture.getUniqueId() );
+			writeUInt64( texture.getSamplerId() );
+			writeUInt64( texture.getTextureMapId() );
+			writeString( texture.getTexcoord() );
+		}
+
+		//------------------------------
+		void RecordSerializer::writeFloatOrParam( const COLLADAFW::FloatOrParam& floatOrParam )
+		{
+			writeUInt32( floatOrParam.getType() );
+			writeFloat( floatOrParam.getFloatValue() );
+			const COLLADAFW::Param& param = floatOrParam.getParam();
+			writeString( param.getName() );
+			writeString( param.getSid() );
+			writeUInt32( param.getType() );
+			writeString( param.getSemantic() );
+			writeAnimatable( floatOrParam );
+		}
+
+		//------------------------------
+		void RecordSerializer::writeEffectCommon( const COLLADAFW::EffectCommon& commonEffect )
+		{
+			writeString( commonEffect.getOriginalId() );
+			writeUInt32( commonEffect.getShaderType() );
+			writeColorOrTexture( commonEffect.getEmission() );
+			writeColorOrTexture( commonEffect.getAmbient() );
+			writeColorOrTexture( commonEffect.getDiffuse() );
+			writeColorOrTexture( commonEffect.getSpecular() );
+			writeFloatOrParam( commonEffect.getShininess() );
+			writeColorOrTexture( commonEffect.getReflective() );
+			writeFloatOrParam( commonEffect.getReflectivity() );
+			writeColorOrTexture( commonEffect.getOpacity() );
+			writeColorOrTexture( commonEffect.getTransparent() );
+			writeFloatOrParam( commonEffect.getTransparency() );
+			writeFloatOrParam( commonEffect.getIndexOfRefraction() );
+			writeUInt32( commonEffect.getOpaqueMode() );
+
+			const COLLADAFW::SamplerPointerArray& samplers = commonEffect.getSamplerPointerArray();
+			writeUInt64( samplers.getCount() );
+			for ( size_t i = 0, count = samplers.getCount(); i < count; ++i )
+			{
+				const COLLADAFW::Sampler& sampler = *samplers[i];
+				writeUniqueId( sampler.getUniqueId() );
+				writeUInt32( sampler.getSamplerType() );
+				writeUniqueId( sampler.getSourceImage() );
+				writeUInt32( sampler.getMinFilter() );
+				writeUInt32( sampler.getMagFilter() );
+				writeUInt32( sampler.getMipFilter() );
+				writeUInt32( sampler.getWrapS() );
+				writeUInt32( sampler.getWrapT() );
+				writeUInt32( sampler.getWrapP() );
+				writeColor( sampler.getBorderColor() );
+				writeUInt32( sampler.getMipmapMaxlevel() );
+				writeFloat( sampler.getMipmapBias() );
+				writeString( sampler.getSid() );
+			}
+		}
+
+		//------------------------------
+		void RecordSerializer::writeEffect( const COLLADAFW::Effect& effect )
+		{
+			writeUniqueId( effect.getUniqueId() );
+			writeString( effect.getOriginalId() );
+			writeString( effect.getName() );
+			writeColor( effect.getStandardColor() );
+
+			const COLLADAFW::CommonEffectPointerArray& commonEffects = effect.getCommonEffects();
+			writeUInt64( commonEffects.getCount() );
+			for ( size_t i = 0, count = commonEffects.getCount(); i < count; ++i )
+				writeEffectCommon( *commonEffects[i] );
+
+			const COLLADAFW::PointerArray<COLLADAFW::TextureAttributes>& extraTextures = effect.getExtraTextures();
+			writeUInt64( extraTextures.getCount() );
+			for ( size_t i = 0, count = extraTextures.getCount(); i < count; ++i )
+			{
+				const COLLADAFW::TextureAttributes& textureAttributes = *extraTextures[i];
+				writeUInt64( textureAttributes.samplerId );
+				writeUInt64( textureAttributes.textureMapId );
+				writeString( textureAttributes.textureSampler );
+				writeString( textureAttributes.texCoord );
+			}
+		}
+
+		//------------------------------
+		void RecordSerializer::writeCamera( const COLLADAFW::Camera& camera )
+		{
+			writeUniqueId( camera.getUniqueId() );
+			writeString( camera.getOriginalId() );
+			writeString( camera.getName() );
+			writeUInt32( camera.getCameraType() );
+			writeUInt32( camera.getDescriptionType() );
+			writeAnimatableFloat( camera.getXFov() );
+			writeAnimatableFloat( camera.getYFov() );
+			writeAnimatableFloat( camera.getAspectRatio() );
+			writeAnimatableFloat( camera.getNearClippingPlane() );
+			writeAnimatableFloat( camera.getFarClippingPlane() );
+		}
+
+		//------------------------------
+		void RecordSerializer::writeImage( const COLLADAFW::Image& image )
+		{
+			writeUniqueId( image.getUniqueId() );
+			writeString( image.getOriginalId() );
+			writeUInt32( image.getSourceType() );
+			writeString( image.getName() );
+			writeString( image.getFormat() );
+			writeUInt32( image.getHeight() );
+			writeUInt32( image.getWidth() );
+			writeUInt32( image.getDepth() );
+			writeURI( image.getImageURI() );
+		}
+
+		//------------------------------
+		void RecordSerializer::writeLight( const COLLADAFW::Light& light )
+		{
+			writeUniqueId( light.getUniqueId() );
+			writeString( light.getOriginalId() );
+			writeString( light.getName() );
+			writeUInt32( light.getLightType() );
+			writeColor( light.getColor() );
+			writeAnimatableFloat( light.getConstantAttenuation() );
+			writeAnimatableFloat( light.getLinearAttenuation() );
+			writeAnimatableFloat( light.getQuadraticAttenuation() );
+			writeAnimatableFloat( light.getFallOffAngle() );
+			writeAnimatableFloat( light.getFallOffExponent() );
+		}
+
+		//------------------------------
+		void RecordSerializer::writeAnimation( const COLLADAFW::Animation& animation )
+		{
+			writeUniqueId( animation.getUniqueId() );
+			writeString( animation.getOriginalId() );
+			writeString( animation.getName() );
+			writeUInt32( animation.getAnimationType() );
+			if ( animation.getAnimationType() != COLLADAFW::Animation::ANIMATION_CURVE )
+			{
+				invalidate();
+				return;
+			}
+
+			// lazily decoded values are decoded by the getters
+			const COLLADAFW::AnimationCurve& curve = static_cast<const COLLADAFW::AnimationCurve&>(animation);
+			writeUInt32( curve.getInPhysicalDimension() );
+			writeEnumArray( curve.getOutPhysicalDimensions() );
+			writeUInt64( curve.getOutDimension() );
+			writeUInt32( curve.getInterpolationType() );
+			writeEnumArray( curve.getInterpolationTypes() );
+			writeFloatOrDoubleArray( curve.getInputValues() );
+			writeFloatOrDoubleArray( curve.getOutputValues() );
+			writeFloatOrDoubleArray( curve.getInTangentValues() );
+			writeFloatOrDoubleArray( curve.getOutTangentValues() );
+		}
+
+		//------------------------------
+		void RecordSerializer::writeAnimationList( const COLLADAFW::AnimationList& animationList )
+		{
+			writeUniqueId( animationList.getUniqueId() );
+			const COLLADAFW::AnimationList::AnimationBindings& bindings = animationList.getAnimationBindings();
+			writeUInt64( bindings.getCount() );
+			for ( size_t i = 0, count = bindings.getCount(); i < count; ++i )
+			{
+				writeUniqueId( bindings[i].animation );
+				writeUInt32( bindings[i].animationClass );
+				writeUInt64( bindings[i].firstIndex );
+				writeUInt64( bindings[i].secondIndex );
+			}
+		}
+
+		//------------------------------
+		void RecordSerializer::writeAnimationClip( const COLLADAFW::AnimationClip& animationClip )
+		{
+			writeUniqueId( animationClip.getUniqueId() );
+			writeString( animationClip.getOriginalId() );
+			writeString( animationClip.getName() );
+			writeUniqueIdArray( animationClip.getInstanceAnimationUniqueIds() );
+		}
+
+		//------------------------------
+		void RecordSerializer::writeSkinControllerData( const COLLADAFW::SkinControllerData& skinControllerData )
+		{
+			writeUniqueId( skinControllerData.getUniqueId() );
+			writeString( skinControllerData.getOriginalId() );
+			writeString( skinControllerData.getName() );
+			writeUInt64( skinControllerData.getJointsCount() );
+			writeMatrix4( skinControllerData.getBindShapeMatrix() );
+
+			const COLLADAFW::Matrix4Array& inverseBindMatrices = skinControllerData.getInverseBindMatrices();
+			writeUInt64( inverseBindMatrices.getCount() );
+			for ( size_t i = 0, count = inverseBindMatrices.getCount(); i < count; ++i )
+				writeMatrix4( inverseBindMatrices[i] );
+
+			writeFloatOrDoubleArray( skinControllerData.getWeights() );
+			writeArray( skinControllerData.getJointsPerVertex() );
+			writeArray( skinControllerData.getWeightIndices() );
+			writeArray( skinControllerData.getJointIndices() );
+		}
+
+		//------------------------------
+		void RecordSerializer::writeController( const COLLADAFW::Controller& controller )
+		{
+			writeUniqueId( controller.getUniqueId() );
+			writeUInt32( controller.getControllerType() );
+			writeUniqueId( controller.getSource() );
+			switch ( controller.getControllerType() )
+			{
+			case COLLADAFW::Controller::CONTROLLER_TYPE_SKIN:
+				{
+					const COLLADAFW::SkinController& skinController = static_cast<const COLLADAFW::SkinController&>(controller);
+					writeUniqueId( skinController.getSkinControllerData() );
+					writeUniqueIdArray( skinController.getJoints() );
+				}
+				break;
+			case COLLADAFW::Controller::CONTROLLER_TYPE_MORPH:
+				{
+					const COLLADAFW::MorphController& morphController = static_cast<const COLLADAFW::MorphController&>(controller);
+					writeString( morphController.getOriginalId() );
+					writeString( morphController.getName() );
+					writeUniqueIdArray( morphController.getMorphTargets() );
+					writeFloatOrDoubleArray( morphController.getMorphWeights() );
+				}
+				break;
+			default:
+				invalidate();
+			}
+		}
+
+		//------------------------------
+		void RecordSerializer::writeMathmlConstant( const MathML::AST::ConstantExpression& constant )
+		{
+			// the value of an invalid constant is not initialized
+			writeUInt32( constant.getType() );
+			writeDouble( constant.getType() == MathML::AST::ConstantExpression::SCALAR_INVALID ? 0.0 : constant.getDoubleValue() );
+			writeString( constant.getStringValue() );
+		}
+
+		//------------------------------
+		void RecordSerializer::writeMathmlNodes( const MathML::AST::NodeList& nodes, const COLLADAFW::FormulaArray& formulas )
+		{
+			writeUInt64( nodes.size() );
+			for ( size_t i = 0, count = nodes.size(); i < count; ++i )
+				writeMathmlNode( nodes[i], formulas );
+		}
+
+		//------------------------------
+		void RecordSerializer::writeMathmlNode( const MathML::AST::INode* node, const COLLADAFW::FormulaArray& formulas )
+		{
+			writeBool( node != 0 );
+			if ( !node || !mValid )
+				return;
+
+			writeUInt32( node->getNodeType() );
+			switch ( node->getNodeType() )
+			{
+			case MathML::AST::INode::CONSTANT:
+				writeMathmlConstant( *static_cast<const MathML::AST::ConstantExpression*>(node) );
+				break;
+			case MathML::AST::INode::VARIABLE:
+				{
+					const MathML::AST::VariableExpression* variable = static_cast<const MathML::AST::VariableExpression*>(node);
+					writeString( variable->getName() );
+					writeBool( variable->getValue() != 0 );
+					if ( variable->getValue() )
+						writeMathmlConstant( *variable->getValue() );
+				}
+				break;
+			case MathML::AST::INode::UNARY:
+				{
+					const MathML::AST::UnaryExpression* unary = static_cast<const MathML::AST::UnaryExpression*>(node);
+					writeUInt32( unary->getOperator() );
+					writeMathmlNode( unary->getOperand(), formulas );
+				}
+				break;
+			case MathML::AST::INode::LOGICAL:
+				{
+					const MathML::AST::LogicExpression* logic = static_cast<const MathML::AST::LogicExpression*>(node);
+					writeUInt32( logic->getOperator() );
+					writeMathmlNodes( logic->getOperands(), formulas );
+				}
+				break;
+			case MathML::AST::INode::COMPARISON:
+				{
+					const MathML::AST::BinaryComparisonExpression* comparison = static_cast<const MathML::AST::BinaryComparisonExpression*>(node);
+					writeUInt32( comparison->getOperator() );
+					writeMathmlNode( comparison->getLeftOperand(), formulas );
+					writeMathmlNode( comparison->getRightOperand(), formulas );
+				}
+				break;
+			case MathML::AST::INode::ARITHMETIC:
+				{
+					const MathML::AST::ArithmeticExpression* arithmetic = static_cast<const MathML::AST::ArithmeticExpression*>(node);
+					writeUInt32( arithmetic->getOperator() );
+					writeMathmlNodes( arithmetic->getOperands(), formulas );
+				}
+				break;
+			case MathML::AST::INode::FUNCTION:
+				{
+					const MathML::AST::FunctionExpression* function = static_cast<const MathML::AST::FunctionExpression*>(node);
+					writeString( function->getName() );
+					writeMathmlNodes( function->getParameterList(), formulas );
+				}
+				break;
+			case MathML::AST::INode::FRAGMENT:
+				writeFragmentExpression( *static_cast<const MathML::AST::FragmentExpression*>(node), formulas );
+				break;
+			default:
+				invalidate();
+			}
+		}
+
+		//------------------------------
+		void RecordSerializer::writeFragmentExpression( const MathML::AST::FragmentExpression& fragment, const COLLADAFW::FormulaArray& formulas )
+		{
+			writeString( fragment.getName() );
+			MathML::AST::INode::CloneFlags cloneFlags = fragment.getCloneFlags();
+			writeUInt32( cloneFlags );
+
+			// an owned fragment is stored with the expression. A shared one is the ast of a formula, set by the
+			// FormulasLinker, and stored as the index of the formula and of the ast
+			const MathML::AST::INode* fragmentNode = fragment.getFragment();
+			if ( cloneFlags & MathML::AST::INode::CLONEFLAG_DEEPCOPY_FRAGMENT )
+			{
+				writeMathmlNode( fragmentNode, formulas );
+			}
+			else
+			{
+				writeBool( fragmentNode != 0 );
+				bool found = (fragmentNode == 0);
+				for ( size_t i = 0, count = formulas.getCount(); (i < count) && !found; ++i )
+				{
+					const COLLADAFW::MathmlAstArray& asts = formulas[i]->getMathmlAsts();
+					for ( size_t j = 0, astsCount = asts.getCount(); (j < astsCount) && !found; ++j )
+					{
+						if ( asts[j] == fragmentNode )
+						{
+							writeUInt64( i );
+							writeUInt64( j );
+							found = true;
+						}
+					}
+				}
+				if ( !found )
+					invalidate();
+			}
+
+			// the parameters are restored with addParameter(), that appends their names to the parameter
+			// symbols and maps the names to the parameters. Parameters shared with other nodes, symbols added
+			// without parameter and parameters replaced in the map by another one of the same name can not
+			// be restored
+			const MathML::AST::FragmentExpression::ParameterList& parameters = fragment.getParameterList();
+			const MathML::AST::FragmentExpression::ParameterSymbolList& parameterSymbols = fragment.getParameterSymbolList();
+			const MathML::AST::FragmentExpression::ParameterMap& parameterMap = fragment.getParameterMap();
+			if ( (parameterSymbols.size() != parameters.size())
+				|| (!parameters.empty() && !(cloneFlags & MathML::AST::INode::CLONEFLAG_DEEPCOPY_FRAGMENT_PARAMS)) )
+			{
+				invalidate();
+				return;
+			}
+			writeUInt64( parameters.size() );
+			for ( size_t i = 0, count = parameters.size(); (i < count) && mValid; ++i )
+			{
+				MathML::AST::FragmentExpression::ParameterMap::const_iterator it = parameterMap.find( parameterSymbols[i] );
+				if ( (it == parameterMap.end()) || (it->second != parameters[i]) )
+				{
+					invalidate();
+					return;
+				}
+				writeString( parameterSymbols[i] );
+				writeMathmlNode( parameters[i], formulas );
+			}
+		}
+
+		//------------------------------
+		void RecordSerializer::writeFormulas( const COLLADAFW::Formulas& formulas )
+		{
+			const COLLADAFW::FormulaArray& formulaArray = formulas.getFormulas();
+			writeUInt64( formulaArray.getCount() );
+			for ( size_t i = 0, count = formulaArray.getCount(); i < count; ++i )
+			{
+				const COLLADAFW::Formula& formula = *formulaArray[i];
+				writeUniqueId( formula.getUniqueId() );
+				writeString( formula.getOriginalId() );
+				writeString( formula.getName() );
+
+				const COLLADAFW::FormulaNewParamPointerArray& newParams = formula.getNewParams();
+				writeUInt64( newParams.getCount() );
+				for ( size_t j = 0, newParamsCount = newParams.getCount(); j < newParamsCount; ++j )
+				{
+					const COLLADAFW::FormulaNewParam& newParam = *newParams[j];
+					writeUInt32( newParam.getValueType() );
+					writeString( newParam.getName() );
+					switch ( newParam.getValueType() )
+					{
+					case COLLADAFW::FormulaNewParam::VALUETYPE_FLOAT:
+						writeDouble( newParam.getDoubleValue() );
+						break;
+					case COLLADAFW::FormulaNewParam::VALUETYPE_INT:
+						writeUInt32( (unsigned int)newParam.getIntValue() );
+						break;
+					case COLLADAFW::FormulaNewParam::VALUETYPE_BOOL:
+						writeBool( newParam.getBoolValue() );
+						break;
+					default:
+						break;
+					}
+				}
+
+				const COLLADAFW::MathmlAstArray& asts = formula.getMathmlAsts();
+				writeUInt64( asts.getCount() );
+				for ( size_t j = 0, astsCount = asts.getCount(); j < astsCount; ++j )
+					writeMathmlNode( asts[j], formulaArray );
+			}
+		}
+
+		//------------------------------
+		void RecordSerializer::writeMotionProfile( const COLLADAFW::MotionProfile& motionProfile )
+		{
+			writeFloat( motionProfile.getReferenceSpeed() );
+			writeFloat( motionProfile.getReferenceAcceleration() );
+			writeFloat( motionProfile.getReferenceDeceleration() );
+			writeFloat( motionProfile.getReferenceJerk() );
+		}
+
+		//------------------------------
+		void RecordSerializer::writeKinematicsScene( const COLLADAFW::KinematicsScene& kinematicsScene )
+		{
+			// the joint primitives referenced by the axis infos are stored as their index among the joint
+			// primitives of all kinematics models
+			std::vector<const COLLADAFW::JointPrimitive*> jointPrimitives;
+
+			const COLLADAFW::KinematicsModelArray& kinematicsModels = kinematicsScene.getKinematicsModels();
+			writeUInt64( kinematicsModels.getCount() );
+			for ( size_t i = 0, count = kinematicsModels.getCount(); i < count; ++i )
+			{
+				const COLLADAFW::KinematicsModel& kinematicsModel = *kinematicsModels[i];
+				writeUniqueId( kinematicsModel.getUniqueId() );
+
+				const COLLADAFW::JointPointerArray& joints = kinematicsModel.getJoints();
+				writeUInt64( joints.getCount() );
+				for ( size_t j = 0, jointsCount = joints.getCount(); j < jointsCount; ++j )
+				{
+					const COLLADAFW::Joint& joint = *joints[j];
+					writeUniqueId( joint.getUniqueId() );
+					writeString( joint.getOriginalId() );
+					writeString( joint.getName() );
+
+					const COLLADAFW::JointPrimitivePointerArray& primitives = joint.getJointPrimitives();
+					writeUInt64( primitives.getCount() );
+					for ( size_t k = 0, primitivesCount = primitives.getCount(); k < primitivesCount; ++k )
+					{
+						const COLLADAFW::JointPrimitive& primitive = *primitives[k];
+						jointPrimitives.push_back( &primitive );
+						writeUniqueId( primitive.getUniqueId() );
+						writeUInt32( primitive.getType() );
+						writeVector3( primitive.getAxis() );
+						writeFloat( primitive.getHardLimitMin() );
+						writeFloat( primitive.getHardLimitMax() );
+						writeFloat( primitive.getSoftLimitMin() );
+						writeFloat( primitive.getSoftLimitMax() );
+						writeMotionProfile( primitive.getMotionProfile() );
+					}
+				}
+
+				const COLLADAFW::KinematicsModel::LinkJointConnections& linkJointConnections = kinematicsModel.getLinkJointConnections();
+				writeUInt64( linkJointConnections.getCount() );
+				for ( size_t j = 0, connectionsCount = linkJointConnections.getCount(); j < connectionsCount; ++j )
+				{
+					const COLLADAFW::KinematicsModel::LinkJointConnection& linkJointConnection = *linkJointConnections[j];
+					writeUInt64( linkJointConnection.getLinkNumber() );
+					writeUInt64( linkJointConnection.getJointIndex() );
+					const COLLADAFW::TransformationPointerArray& transformations = linkJointConnection.getTransformations();
+					writeUInt64( transformations.getCount() );
+					for ( size_t k = 0, transformationsCount = transformations.getCount(); k < transformationsCount; ++k )
+						writeTransformation( *transformations[k] );
+				}
+
+				const COLLADAFW::SizeTValuesArray& baseLinks = kinematicsModel.getBaseLinks();
+				writeUInt64( baseLinks.getCount() );
+				for ( size_t j = 0, baseLinksCount = baseLinks.getCount(); j < baseLinksCount; ++j )
+					writeUInt64( baseLinks[j] );
+			}
+
+			const COLLADAFW::KinematicsControllerArray& kinematicsControllers = kinematicsScene.getKinematicsControllers();
+			writeUInt64( kinematicsControllers.getCount() );
+			for ( size_t i = 0, count = kinematicsControllers.getCount(); i < count; ++i )
+			{
+				const COLLADAFW::KinematicsController& kinematicsController = *kinematicsControllers[i];
+				writeUniqueId( kinematicsController.getUniqueId() );
+				writeUniqueIdArray( kinematicsController.getKinematicsModelUniqueIds() );
+
+				const COLLADAFW::AxisInfoArray& axisInfos = kinematicsController.getAxisInfos();
+				writeUInt64( axisInfos.getCount() );
+				for ( size_t j = 0, axisInfosCount = axisInfos.getCount(); j < axisInfosCount; ++j )
+				{
+					const COLLADAFW::AxisInfo& axisInfo = axisInfos[j];
+					const COLLADAFW::JointPrimitive* jointPrimitive = axisInfo.getJointPrimitive();
+					writeBool( jointPrimitive != 0 );
+					if ( jointPrimitive )
+					{
+						std::vector<const COLLADAFW::JointPrimitive*>::const_iterator it = std::find( jointPrimitives.begin(), jointPrimitives.end(), jointPrimitive );
+						if ( it == jointPrimitives.end() )
+							invalidate();
+						writeUInt64( it - jointPrimitives.begin() );
+					}
+					writeBool( axisInfo.getIsActive() );
+					writeBool( axisInfo.getIsLocked() );
+					writeUInt32( (unsigned int)axisInfo.getIndex() );
+				}
+				writeMotionProfile( kinematicsController.getLinearMotionProfile() );
+				writeMotionProfile( kinematicsController.getAngularMotionProfile() );
+			}
+
+			const COLLADAFW::InstanceKinematicsSceneArray& instanceKinematicsScenes = kinematicsScene.getInstanceKinematicsScenes();
+			writeUInt64( instanceKinematicsScenes.getCount() );
+			for ( size_t i = 0, count = instanceKinematicsScenes.getCount(); i < count; ++i )
+				writeInstanceKinematicsScene( *instanceKinematicsScenes[i] );
+		}
+	}
+
+	//------------------------------
+	BinaryCacheWriter::BinaryCacheWriter( const String& fileName, COLLADAFW::IWriter* writer )
+		: mFileName(fileName)
+		, mTemporaryFileName(fileName.empty() ? fileName : fileName + ".tmp")
+		, mWriter(writer)
+		, mFile(0)
+		, mWriting(false)
+		, mFileSize(0)
+		, mCacheWritten(false)
+	{
+	}
+
+	//------------------------------
+	BinaryCacheWriter::~BinaryCacheWriter()
+	{
+		if ( mFile )
+		{
+			fclose( mFile );
+			remove( mTemporaryFileName.c_str() );
+		}
+	}
+
+	//------------------------------
+	bool BinaryCacheWriter::writeBytes( const void* data, size_t count )
+	{
+		if ( !mFile )
+			mContent.insert( mContent.end(), (const char*)data, (const char*)data + count );
+		else if ( (count != 0) && (fwrite( data, 1, count, mFile ) != count) )
+			return false;
+		mFileSize += count;
+		return true;
+	}
+
+	//------------------------------
+	void BinaryCacheWriter::discardFile( const String& errorMessage )
+	{
+		if ( mFile )
+		{
+			fclose( mFile );
+			mFile = 0;
+			remove( mTemporaryFileName.c_str() );
+		}
+		std::vector<char>().swap( mContent );
+		mWriting = false;
+		if ( mErrorMessage.empty() )
+			mErrorMessage = errorMessage;
+	}
+
+	//------------------------------
+	void BinaryCacheWriter::writeRecord( unsigned int recordType, bool success, const char* errorMessage )
+	{
+		if ( !mWriting )
+			return;
+		if ( !success )
+		{
+			discardFile( errorMessage );
+			return;
+		}
+
+		static const char PADDING[16] = { 0 };
+		unsigned int recordHeader[2] = { recordType, 0 };
+		unsigned long long payloadSize = mRecord.size();
+		size_t padding = BinaryCacheFormat::getPadding( mRecord.size() );
+		if ( !writeBytes( recordHeader, sizeof(recordHeader) )
+			|| !writeBytes( &payloadSize, sizeof(payloadSize) )
+			|| !writeBytes( mRecord.empty() ? 0 : &mRecord[0], mRecord.size() )
+			|| !writeBytes( PADDING, padding ) )
+		{
+			discardFile( "Could not write to \"" + mTemporaryFileName + "\"" );
+		}
+	}
+
+	//------------------------------
+	void BinaryCacheWriter::cancel( const String& errorMessage )
+	{
+		discardFile( "Loading cancelled: " + errorMessage );
+		if ( mWriter )
+			mWriter->cancel( errorMessage );
+	}
+
+	//------------------------------
+	void BinaryCacheWriter::start()
+	{
+		discardFile( "" );
+		mErrorMessage.clear();
+		mCacheWritten = false;
+		mFileSize = 0;
+
+		if ( !mFileName.empty() )
+			mFile = fopen( mTemporaryFileName.c_str(), "wb" );
+		if ( !mFile && !mFileName.empty() )
+		{
+			mErrorMessage = "Could not open \"" + mTemporaryFileName + "\"";
+		}
+		else
+		{
+			mWriting = true;
+			RecordSerializer header( mRecord );
+			header.writeBytes( BinaryCacheFormat::MAGIC, sizeof(BinaryCacheFormat::MAGIC) );
+			header.writeUInt32( BinaryCacheFormat::VERSION );
+			header.writeUInt32( BinaryCacheFormat::BYTE_ORDER_MARK );
+			header.writeUInt32( BinaryCacheFormat::ALIGNMENT );
+			header.writeUInt32( 0 );
+			header.writeString( mSourceKey );
+			header.align();
+			if ( !writeBytes( &mRecord[0], mRecord.size() ) )
+				discardFile( "Could not write to \"" + mTemporaryFileName + "\"" );
+		}
+
+		if ( mWriter )
+			mWriter->start();
+	}
+
+	//------------------------------
+	void BinaryCacheWriter::finish()
+	{
+		if ( mWriting )
+		{
+			mRecord.clear();
+			writeRecord( BinaryCacheFormat::RECORD_END, true, "" );
+		}
+		std::vector<char>().swap( mRecord );
+
+		if ( mWriting && !mFile )
+		{
+			mWriting = false;
+			mCacheWritten = true;
+		}
+		else if ( mWriting )
+		{
+			mWriting = false;
+			bool success = (fclose( mFile ) == 0);
+			mFile = 0;
+
+			// rename does not replace existing files on all platforms
+			remove( mFileName.c_str() );
+			if ( success && (rename( mTemporaryFileName.c_str(), mFileName.c_str() ) == 0) )
+			{
+				mCacheWritten = true;
+			}
+			else
+			{
+				remove( mTemporaryFileName.c_str() );
+				mErrorMessage = "Could not write \"" + mFileName + "\"";
+			}
+		}
+
+		if ( mWriter )
+			mWriter->finish();
+	}
+
+	//------------------------------
+	bool BinaryCacheWriter::storeObject( const COLLADAFW::FileInfo& asset, std::vector<char>& payload )
+	{
+		RecordSerializer serializer( payload );
+		serializer.writeFileInfo( asset );
+		return serializer.isValid();
+	}
+
+	//------------------------------
+	bool BinaryCacheWriter::storeObject( const COLLADAFW::Scene& scene, std::vector<char>& payload )
+	{
+		RecordSerializer serializer( payload );
+		serializer.writeScene( scene );
+		return serializer.isValid();
+	}
+
+	//------------------------------
+	bool BinaryCacheWriter::storeObject( const COLLADAFW::VisualScene& visualScene, std::vector<char>& payload )
+	{
+		RecordSerializer serializer( payload );
+		serializer.writeUniqueId( visualScene.getUniqueId() );
+		serializer.writeString( visualScene.getName() );
+		serializer.writeNodes( visualScene.getRootNodes() );
+		return serializer.isValid();
+	}
+
+	//------------------------------
+	bool BinaryCacheWriter::storeObject( const COLLADAFW::LibraryNodes& libraryNodes, std::vector<char>& payload )
+	{
+		RecordSerializer serializer( payload );
+		serializer.writeNodes( libraryNodes.getNodes() );
+		return serializer.isValid();
+	}
+
+	//------------------------------
+	bool BinaryCacheWriter::storeObject( const COLLADAFW::Geometry& geometry, std::vector<char>& payload )
+	{
+		RecordSerializer serializer( payload );
+		serializer.writeGeometry( geometry );
+		return serializer.isValid();
+	}
+
+	//------------------------------
+	bool BinaryCacheWriter::storeObject( const COLLADAFW::Material& material, std::vector<char>& payload )
+	{
+		RecordSerializer serializer( payload );
+		serializer.writeMaterial( material );
+		return serializer.isValid();
+	}
+
+	//------------------------------
+	bool BinaryCacheWriter::storeObject( const COLLADAFW::Effect& effect, std::vector<char>& payload )
+	{
+		RecordSerializer serializer( payload );
+		serializer.writeEffect( effect );
+		return serializer.isValid();
+	}
+
+	//------------------------------
+	bool BinaryCacheWriter::storeObject( const COLLADAFW::Camera& camera, std::vector<char>& payload )
+	{
+		RecordSerializer serializer( payload );
+		serializer.writeCamera( camera );
+		return serializer.isValid();
+	}
+
+	//------------------------------
+	bool BinaryCacheWriter::storeObject( const COLLADAFW::Image& image, std::vector<char>& payload )
+	{
+		RecordSerializer serializer( payload );
+		serializer.writeImage( image );
+		return serializer.isValid();
+	}
+
+	//------------------------------
+	bool BinaryCacheWriter::storeObject( const COLLADAFW::Light& light, std::vector<char>& payload )
+	{
+		RecordSerializer serializer( payload );
+		serializer.writeLight( light );
+		return serializer.isValid();
+	}
+
+	//------------------------------
+	bool BinaryCacheWriter::storeObject( const COLLADAFW::Animation& animation, std::vector<char>& payload )
+	{
+		RecordSerializer serializer( payload );
+		serializer.writeAnimation( animation );
+		return serializer.isValid();
+	}
+
+	//------------------------------
+	bool BinaryCacheWriter::storeObject( const COLLADAFW::AnimationList& animationList, std::vector<char>& payload )
+	{
+		RecordSerializer serializer( payload );
+		serializer.writeAnimationList( animationList );
+		return serializer.isValid();
+	}
+
+	//------------------------------
+	bool BinaryCacheWriter::storeObject( const COLLADAFW::AnimationClip& animationClip, std::vector<char>& payload )
+	{
+		RecordSerializer serializer( payload );
+		serializer.writeAnimationClip( animationClip );
+		return serializer.isValid();
+	}
+
+	//------------------------------
+	bool BinaryCacheWriter::storeObject( const COLLADAFW::SkinControllerData& skinControllerData, std::vector<char>& payload )
+	{
+		RecordSerializer serializer( payload );
+		serializer.writeSkinControllerData( skinControllerData );
+		return serializer.isValid();
+	}
+
+	//------------------------------
+	bool BinaryCacheWriter::storeObject( const COLLADAFW::Controller& controller, std::vector<char>& payload )
+	{
+		RecordSerializer serializer( payload );
+		serializer.writeController( controller );
+		return serializer.isValid();
+	}
+
+	//------------------------------
+	bool BinaryCacheWriter::storeObject( const COLLADAFW::Formulas& formulas, std::vector<char>& payload )
+	{
+		RecordSerializer serializer( payload );
+		serializer.writeFormulas( formulas );
+		return serializer.isValid();
+	}
+
+	//------------------------------
+	bool BinaryCacheWriter::storeObject( const COLLADAFW::KinematicsScene& kinematicsScene, std::vector<char>& payload )
+	{
+		RecordSerializer serializer( payload );
+		serializer.writeKinematicsScene( kinematicsScene );
+		return serializer.isValid();
+	}
+
+	//------------------------------
+	bool BinaryCacheWriter::writeGlobalAsset( const COLLADAFW::FileInfo* asset )
+	{
+		if ( mWriting )
+			writeRecord( BinaryCacheFormat::RECORD_GLOBAL_ASSET, storeObject( *asset, mRecord ), "" );
+		return mWriter ? mWriter->writeGlobalAsset( asset ) : true;
+	}
+
+	//------------------------------
+	bool BinaryCacheWriter::writeScene( const COLLADAFW::Scene* scene )
+	{
+		if ( mWriting )
+			writeRecord( BinaryCacheFormat::RECORD_SCENE, storeObject( *scene, mRecord ), "" );
+		return mWriter ? mWriter->writeScene( scene ) : true;
+	}
+
+	//------------------------------
+	bool BinaryCacheWriter::writeVisualScene( const COLLADAFW::VisualScene* visualScene )
+	{
+		if ( mWriting )
+			writeRecord( BinaryCacheFormat::RECORD_VISUAL_SCENE, storeObject( *visualScene, mRecord ), "Unknown transformation" );
+		return mWriter ? mWriter->writeVisualScene( visualScene ) : true;
+	}
+
+	//------------------------------
+	bool BinaryCacheWriter::writeLibraryNodes( const COLLADAFW::LibraryNodes* libraryNodes )
+	{
+		if ( mWriting )
+			writeRecord( BinaryCacheFormat::RECORD_LIBRARY_NODES, storeObject( *libraryNodes, mRecord ), "Unknown transformation" );
+		return mWriter ? mWriter->writeLibraryNodes( libraryNodes ) : true;
+	}
+
+	//------------------------------
+	bool BinaryCacheWriter::writeGeometry( const COLLADAFW::Geometry* geometry )
+	{
+		if ( mWriting )
+			writeRecord( BinaryCacheFormat::RECORD_GEOMETRY, storeObject( *geometry, mRecord ), "Convex meshes are not cached" );
+		return mWriter ? mWriter->writeGeometry( geometry ) : true;
+	}
+
+	//------------------------------
+	bool BinaryCacheWriter::writeMaterial( const COLLADAFW::Material* material )
+	{
+		if ( mWriting )
+			writeRecord( BinaryCacheFormat::RECORD_MATERIAL, storeObject( *material, mRecord ), "" );
+		return mWriter ? mWriter->writeMaterial( material ) : true;
+	}
+
+	//------------------------------
+	bool BinaryCacheWriter::writeEffect( const COLLADAFW::Effect* effect )
+	{
+		if ( mWriting )
+			writeRecord( BinaryCacheFormat::RECORD_EFFECT, storeObject( *effect, mRecord ), "" );
+		return mWriter ? mWriter->writeEffect( effect ) : true;
+	}
+
+	//------------------------------
+	bool BinaryCacheWriter::writeCamera( const COLLADAFW::Camera* camera )
+	{
+		if ( mWriting )
+			writeRecord( BinaryCacheFormat::RECORD_CAMERA, storeObject( *camera, mRecord ), "" );
+		return mWriter ? mWriter->writeCamera( camera ) : true;
+	}
+
+	//------------------------------
+	bool BinaryCacheWriter::writeImage( const COLLADAFW::Image* image )
+	{
+		if ( mWriting )
+			writeRecord( BinaryCacheFormat::RECORD_IMAGE, storeObject( *image, mRecord ), "" );
+		return mWriter ? mWriter->writeImage( image ) : true;
+	}
+
+	//------------------------------
+	bool BinaryCacheWriter::writeLight( const COLLADAFW::Light* light )
+	{
+		if ( mWriting )
+			writeRecord( BinaryCacheFormat::RECORD_LIGHT, storeObject( *light, mRecord ), "" );
+		return mWriter ? mWriter->writeLight( light ) : true;
+	}
+
+	//------------------------------
+	bool BinaryCacheWriter::writeAnimation( const COLLADAFW::Animation* animation )
+	{
+		if ( mWriting )
+			writeRecord( BinaryCacheFormat::RECORD_ANIMATION, storeObject( *animation, mRecord ), "Formula animations are not cached" );
+		return mWriter ? mWriter->writeAnimation( animation ) : true;
+	}
+
+	//------------------------------
+	bool BinaryCacheWriter::writeAnimationList( const COLLADAFW::AnimationList* animationList )
+	{
+		if ( mWriting )
+			writeRecord( BinaryCacheFormat::RECORD_ANIMATION_LIST, storeObject( *animationList, mRecord ), "" );
+		return mWriter ? mWriter->writeAnimationList( animationList ) : true;
+	}
+
+	//------------------------------
+	bool BinaryCacheWriter::writeAnimationClip( const COLLADAFW::AnimationClip* animationClip )
+	{
+		if ( mWriting )
+			writeRecord( BinaryCacheFormat::RECORD_ANIMATION_CLIP, storeObject( *animationClip, mRecord ), "" );
+		return mWriter ? mWriter->writeAnimationClip( animationClip ) : true;
+	}
+
+	//------------------------------
+	bool BinaryCacheWriter::writeSkinControllerData( const COLLADAFW::SkinControllerData* skinControllerData )
+	{
+		if ( mWriting )
+			writeRecord( BinaryCacheFormat::RECORD_SKIN_CONTROLLER_DATA, storeObject( *skinControllerData, mRecord ), "" );
+		return mWriter ? mWriter->writeSkinControllerData( skinControllerData ) : true;
+	}
+
+	//------------------------------
+	bool BinaryCacheWriter::writeController( const COLLADAFW::Controller* controller )
+	{
+		if ( mWriting )
+			writeRecord( BinaryCacheFormat::RECORD_CONTROLLER, storeObject( *controller, mRecord ), "Unknown controller type" );
+		return mWriter ? mWriter->writeController( controller ) : true;
+	}
+
+	//------------------------------
+	bool BinaryCacheWriter::writeFormulas( const COLLADAFW::Formulas* formulas )
+	{
+		if ( mWriting )
+			writeRecord( BinaryCacheFormat::RECORD_FORMULAS, storeObject( *formulas, mRecord ), "Formula with a user defined or unlinked node" );
+		return mWriter ? mWriter->writeFormulas( formulas ) : true;
+	}
+
+	//------------------------------
+	bool BinaryCacheWriter::writeKinematicsScene( const COLLADAFW::KinematicsScene* kinematicsScene )
+	{
+		if ( mWriting )
+			writeRecord( BinaryCacheFormat::RECORD_KINEMATICS_SCENE, storeObject( *kinematicsScene, mRecord ), "Axis info of an unknown joint primitive" );
+		return mWriter ? mWriter->writeKinematicsScene( kinematicsScene ) : true;
+	}
+
+} // namespace COLLADASaxFWL
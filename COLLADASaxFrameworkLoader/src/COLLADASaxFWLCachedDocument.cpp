@@ -0,0 +1,292 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADASaxFWLStableHeaders.h"
+#include "COLLADASaxFWLCachedDocument.h"
+#include "COLLADASaxFWLLoader.h"
+
+#include "COLLADAFWIWriter.h"
+#include "COLLADAFWFileInfo.h"
+#include "COLLADAFWImage.h"
+#include "COLLADAFWMaterial.h"
+#include "COLLADAFWMesh.h"
+#include "COLLADAFWEffect.h"
+#include "COLLADAFWEffectCommon.h"
+
+#include <map>
+
+
+namespace COLLADASaxFWL
+{
+
+	namespace
+	{
+		/** The number of bytes charged for an object, in addition to its arrays.*/
+		const size_t OBJECT_MEMORY_SIZE = 256;
+
+		/** Returns the number of bytes used by the values of @a vertexData.*/
+		size_t estimateMemorySize( const COLLADAFW::MeshVertexData& vertexData )
+		{
+			size_t valueSize = vertexData.getType() == COLLADAFW::FloatOrDoubleArray::DATA_TYPE_DOUBLE ? sizeof(double) : sizeof(float);
+			return vertexData.getValuesCount() * valueSize;
+		}
+
+		/** Returns the number of bytes used by the index lists in @a indexLists.*/
+		size_t estimateMemorySize( const COLLADAFW::IndexListArray& indexLists )
+		{
+			size_t memorySize = 0;
+			for ( size_t i = 0, count = indexLists.getCount(); i < count; ++i )
+				memorySize += OBJECT_MEMORY_SIZE + indexLists[i]->getIndices().getCount() * sizeof(unsigned int);
+			return memorySize;
+		}
+
+		/** Returns the estimated number of bytes used by @a mesh.*/
+		size_t estimateMemorySize( const COLLADAFW::Mesh& mesh )
+		{
+			size_t memorySize = OBJECT_MEMORY_SIZE
+				+ estimateMemorySize( mesh.getPositions() )
+				+ estimateMemorySize( mesh.getNormals() )
+				+ estimateMemorySize( mesh.getColors() )
+				+ estimateMemorySize( mesh.getUVCoords() )
+				+ estimateMemorySize( mesh.getTangents() )
+				+ estimateMemorySize( mesh.getBinormals() );
+
+			const COLLADAFW::MeshPrimitiveArray& primitives = mesh.getMeshPrimitives();
+			for ( size_t i = 0, count = primitives.getCount(); i < count; ++i )
+			{
+				const COLLADAFW::MeshPrimitive* primitive = primitives[i];
+				size_t indicesCount = primitive->getPositionIndices().getCount()
+					+ primitive->getNormalIndices().getCount()
+					+ primitive->getTangentIndices().getCount()
+					+ primitive->getBinormalIndices().getCount();
+				memorySize += OBJECT_MEMORY_SIZE + indicesCount * sizeof(unsigned int)
+					+ estimateMemorySize( primitive->getColorIndicesArray() )
+					+ estimateMemorySize( primitive->getUVCoordIndicesArray() );
+			}
+			return memorySize;
+		}
+
+		/** Maps the unique ids of the objects of a cached document to the unique ids of the current load.*/
+		class UniqueIdRemapper
+		{
+		private:
+			typedef std::map<COLLADAFW::UniqueId, COLLADAFW::UniqueId> UniqueIdUniqueIdMap;
+
+			Loader& mLoader;
+
+			/** The file id the unique ids to map refer to.*/
+			COLLADAFW::FileId mFileId;
+
+			UniqueIdUniqueIdMap mUniqueIds;
+
+		public:
+			UniqueIdRemapper( Loader& loader, COLLADAFW::FileId fileId ) : mLoader(loader), mFileId(fileId) {}
+
+			/** Sets the unique id @a uniqueId is mapped to.*/
+			void add( const COLLADAFW::UniqueId& uniqueId, const COLLADAFW::UniqueId& newUniqueId )
+			{
+				mUniqueIds[uniqueId] = newUniqueId;
+			}
+
+			/** Returns the unique id @a uniqueId is mapped to. Unique ids of other files and invalid ones
+			are not changed. Unique ids not mapped yet get a new unique id of the current file.*/
+			COLLADAFW::UniqueId map( const COLLADAFW::UniqueId& uniqueId )
+			{
+				if ( !uniqueId.isValid() || (uniqueId.getFileId() != mFileId) )
+					return uniqueId;
+
+				UniqueIdUniqueIdMap::const_iterator it = mUniqueIds.find( uniqueId );
+				if ( it != mUniqueIds.end() )
+					return it->second;
+
+				COLLADAFW::UniqueId newUniqueId = mLoader.getUniqueId( uniqueId.getClassId() );
+				mUniqueIds[uniqueId] = newUniqueId;
+				return newUniqueId;
+			}
+		};
+	}
+
+	//------------------------------
+	CachedDocument::CachedDocument( COLLADAFW::FileId fileId )
+		: mFileId(fileId)
+		, mAsset(0)
+		, mMemorySize(OBJECT_MEMORY_SIZE)
+	{
+	}
+
+	//------------------------------
+	CachedDocument::~CachedDocument()
+	{
+		FW_DELETE mAsset;
+		for ( size_t i = 0; i < mImages.size(); ++i )
+			FW_DELETE mImages[i];
+		for ( size_t i = 0; i < mMaterials.size(); ++i )
+			FW_DELETE mMaterials[i];
+		for ( size_t i = 0; i < mMeshes.size(); ++i )
+			FW_DELETE mMeshes[i];
+		for ( size_t i = 0; i < mEffects.size(); ++i )
+			FW_DELETE mEffects[i];
+	}
+
+	//------------------------------
+	void CachedDocument::setAsset( COLLADAFW::FileInfo* asset )
+	{
+		FW_DELETE mAsset;
+		mAsset = asset;
+		mMemorySize += OBJECT_MEMORY_SIZE;
+	}
+
+	//------------------------------
+	void CachedDocument::addImage( COLLADAFW::Image* image )
+	{
+		mImages.push_back( image );
+		mMemorySize += OBJECT_MEMORY_SIZE;
+	}
+
+	//------------------------------
+	void CachedDocument::addMaterial( COLLADAFW::Material* material )
+	{
+		mMaterials.push_back( material );
+		mMemorySize += OBJECT_MEMORY_SIZE;
+	}
+
+	//------------------------------
+	void CachedDocument::addMesh( COLLADAFW::Mesh* mesh )
+	{
+		mMeshes.push_back( mesh );
+		mMemorySize += estimateMemorySize( *mesh );
+	}
+
+	//------------------------------
+	void CachedDocument::addEffect( COLLADAFW::Effect* effect )
+	{
+		mEffects.push_back( effect );
+		mMemorySize += OBJECT_MEMORY_SIZE;
+	}
+
+	//------------------------------
+	void CachedDocument::addFragment( const String& fragment, const COLLADAFW::UniqueId& uniqueId )
+	{
+		mFragmentUniqueIds.push_back( FragmentUniqueIdPair( fragment, uniqueId ) );
+		mMemorySize += fragment.size() + sizeof(FragmentUniqueIdPair);
+	}
+
+	//------------------------------
+	bool CachedDocument::replay( Loader& loader )
+	{
+		COLLADAFW::FileId fileId = loader.mCurrentFileId;
+		UniqueIdRemapper remapper( loader, mFileId );
+
+		// the elements referenced by other documents get the unique ids already assigned to their uris
+		const COLLADABU::URI& fileUri = loader.getFileUri( fileId );
+		for ( size_t i = 0, count = mFragmentUniqueIds.size(); i < count; ++i )
+		{
+			FragmentUniqueIdPair& fragmentUniqueId = mFragmentUniqueIds[i];
+			COLLADABU::URI uri( fileUri, String("#") + fragmentUniqueId.first );
+			const COLLADAFW::UniqueId& newUniqueId = loader.getUniqueId( uri, fragmentUniqueId.second.getClassId() );
+			remapper.add( fragmentUniqueId.second, newUniqueId );
+			fragmentUniqueId.second = newUniqueId;
+		}
+
+		for ( size_t i = 0, count = mImages.size(); i < count; ++i )
+		{
+			COLLADAFW::Image* image = mImages[i];
+			image->setUniqueId( remapper.map( image->getUniqueId() ) );
+		}
+
+		for ( size_t i = 0, count = mMaterials.size(); i < count; ++i )
+		{
+			COLLADAFW::Material* material = mMaterials[i];
+			material->setUniqueId( remapper.map( material->getUniqueId() ) );
+			material->setInstantiatedEffect( remapper.map( material->getInstantiatedEffect() ) );
+		}
+
+		GeometryMaterialIdInfo& materialIdInfo = loader.getMeshMaterialIdInfo();
+		for ( size_t i = 0, count = mMeshes.size(); i < count; ++i )
+		{
+			COLLADAFW::Mesh* mesh = mMeshes[i];
+			mesh->setUniqueId( remapper.map( mesh->getUniqueId() ) );
+
+			// material ids are assigned to the symbols by the load, in the order they are found
+			COLLADAFW::MeshPrimitiveArray& primitives = mesh->getMeshPrimitives();
+			for ( size_t j = 0, primitivesCount = primitives.getCount(); j < primitivesCount; ++j )
+			{
+				COLLADAFW::MeshPrimitive* primitive = primitives[j];
+				primitive->setUniqueId( remapper.map( primitive->getUniqueId() ) );
+				primitive->setMaterialId( materialIdInfo.getMaterialId( primitive->getMaterial() ) );
+			}
+		}
+
+		for ( size_t i = 0, count = mEffects.size(); i < count; ++i )
+		{
+			COLLADAFW::Effect* effect = mEffects[i];
+			effect->setUniqueId( remapper.map( effect->getUniqueId() ) );
+
+			COLLADAFW::CommonEffectPointerArray& commonEffects = effect->getCommonEffects();
+			for ( size_t j = 0, commonEffectsCount = commonEffects.getCount(); j < commonEffectsCount; ++j )
+			{
+				COLLADAFW::EffectCommon* commonEffect = commonEffects[j];
+				// textures get the texture map ids of the current load
+				COLLADAFW::ColorOrTexture* colorOrTextures[] = 
+				{
+					&commonEffect->getEmission(),
+					&commonEffect->getAmbient(),
+					&commonEffect->getDiffuse(),
+					&commonEffect->getSpecular(),
+					&commonEffect->getReflective(),
+					&commonEffect->getTransparent(),
+					&commonEffect->getOpacity()
+				};
+				for ( size_t k = 0; k < sizeof(colorOrTextures) / sizeof(colorOrTextures[0]); ++k )
+				{
+					if ( !colorOrTextures[k]->isTexture() )
+						continue;
+					COLLADAFW::Texture& texture = colorOrTextures[k]->getTexture();
+					texture.setUniqueId( remapper.map( texture.getUniqueId() ) );
+					if ( !texture.getTexcoord().empty() )
+						texture.setTextureMapId( loader.getTextureMapIdBySematic( texture.getTexcoord() ) );
+				}
+
+				COLLADAFW::SamplerPointerArray& samplers = commonEffect->getSamplerPointerArray();
+				for ( size_t k = 0, samplersCount = samplers.getCount(); k < samplersCount; ++k )
+				{
+					COLLADAFW::Sampler* sampler = samplers[k];
+					sampler->setUniqueId( remapper.map( sampler->getUniqueId() ) );
+					sampler->setSource( remapper.map( sampler->getSourceImage() ) );
+				}
+			}
+
+			const COLLADAFW::PointerArray<COLLADAFW::TextureAttributes>& extraTextures = effect->getExtraTextures();
+			for ( size_t j = 0, extraTexturesCount = extraTextures.getCount(); j < extraTexturesCount; ++j )
+			{
+				COLLADAFW::TextureAttributes* textureAttributes = extraTextures[j];
+				textureAttributes->textureMapId = loader.getTextureMapIdBySematic( textureAttributes->texCoord );
+			}
+		}
+		mFileId = fileId;
+
+		// the objects are written in the order of the parser, effects are written by the post processing.
+		// As while parsing, only failures to write assets, images and materials abort the load.
+		COLLADAFW::IWriter* writer = loader.writer();
+		bool success = true;
+		if ( mAsset )
+			success = writer->writeGlobalAsset( mAsset ) && success;
+		for ( size_t i = 0, count = mImages.size(); i < count; ++i )
+			success = writer->writeImage( mImages[i] ) && success;
+		for ( size_t i = 0, count = mMaterials.size(); i < count; ++i )
+			success = writer->writeMaterial( mMaterials[i] ) && success;
+		for ( size_t i = 0, count = mMeshes.size(); i < count; ++i )
+			writer->writeGeometry( mMeshes[i] );
+		for ( size_t i = 0, count = mEffects.size(); i < count; ++i )
+			writer->writeEffect( mEffects[i] );
+		return success;
+	}
+
+} // namespace COLLADASaxFWL
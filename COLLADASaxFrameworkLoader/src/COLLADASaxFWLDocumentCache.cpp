@@ -0,0 +1,229 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADASaxFWLStableHeaders.h"
+#include "COLLADASaxFWLDocumentCache.h"
+#include "COLLADASaxFWLCachedDocument.h"
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+
+
+namespace COLLADASaxFWL
+{
+
+	namespace
+	{
+		/** A cached document. The mutex is locked while the document is replayed.*/
+		struct Entry
+		{
+			Entry( const String& key_, CachedDocument* document_ ) : key(key_), document(document_) {}
+			~Entry() { delete document; }
+
+			String key;
+			std::mutex mutex;
+			CachedDocument* document;
+		};
+
+		/** Entries are shared, such that a document can be replayed while it is removed from the cache.*/
+		typedef std::shared_ptr<Entry> EntryPtr;
+
+		/** The entries, the most recently used first.*/
+		typedef std::list<EntryPtr> EntryList;
+
+		typedef std::map<String, EntryList::iterator> KeyEntryMap;
+
+		/** Returns @a nativePath with forward slashes, without "." segments and with ".." segments resolved,
+		and, on Windows, where file names are not case sensitive, in lower case. Different spellings of the
+		path of a file therefore give the same result.*/
+		String normalizePath( const String& nativePath )
+		{
+			String path = nativePath;
+			for ( size_t i = 0; i < path.size(); ++i )
+			{
+				if ( path[i] == '\\' )
+					path[i] = '/';
+#ifdef COLLADABU_OS_WIN
+				else if ( (path[i] >= 'A') && (path[i] <= 'Z') )
+					path[i] = path[i] - 'A' + 'a';
+#endif
+			}
+			COLLADABU::URI::normalizeURIPath( &path[0] );
+			return String( path.c_str() );
+		}
+	}
+
+	struct DocumentCache::SharedData
+	{
+		SharedData( size_t memoryLimit_ ) : memoryLimit(memoryLimit_), memoryUsage(0), hitCount(0), missCount(0) {}
+
+		mutable std::mutex mutex;
+
+		EntryList entries;
+
+		KeyEntryMap keyEntryMap;
+
+		size_t memoryLimit;
+
+		size_t memoryUsage;
+
+		size_t hitCount;
+
+		size_t missCount;
+
+		/** Removes @a it from the cache. The mutex must be locked.*/
+		void remove( EntryList::iterator it )
+		{
+			memoryUsage -= (*it)->document->getMemorySize();
+			keyEntryMap.erase( (*it)->key );
+			entries.erase( it );
+		}
+
+		/** Removes the least recently used entries, until the memory usage does not exceed @a limit. The
+		mutex must be locked.*/
+		void shrink( size_t limit )
+		{
+			while ( !entries.empty() && (memoryUsage > limit) )
+				remove( --entries.end() );
+		}
+	};
+
+	//------------------------------
+	DocumentCache::DocumentCache( size_t memoryLimit )
+		: mSharedData( new SharedData(memoryLimit) )
+	{
+	}
+
+	//------------------------------
+	DocumentCache::~DocumentCache()
+	{
+		delete mSharedData;
+	}
+
+	//------------------------------
+	void DocumentCache::setMemoryLimit( size_t memoryLimit )
+	{
+		std::lock_guard<std::mutex> lock( mSharedData->mutex );
+		mSharedData->memoryLimit = memoryLimit;
+		mSharedData->shrink( memoryLimit );
+	}
+
+	//------------------------------
+	size_t DocumentCache::getMemoryLimit() const
+	{
+		std::lock_guard<std::mutex> lock( mSharedData->mutex );
+		return mSharedData->memoryLimit;
+	}
+
+	//------------------------------
+	size_t DocumentCache::getMemoryUsage() const
+	{
+		std::lock_guard<std::mutex> lock( mSharedData->mutex );
+		return mSharedData->memoryUsage;
+	}
+
+	//------------------------------
+	size_t DocumentCache::getDocumentCount() const
+	{
+		std::lock_guard<std::mutex> lock( mSharedData->mutex );
+		return mSharedData->entries.size();
+	}
+
+	//------------------------------
+	size_t DocumentCache::getHitCount() const
+	{
+		std::lock_guard<std::mutex> lock( mSharedData->mutex );
+		return mSharedData->hitCount;
+	}
+
+	//------------------------------
+	size_t DocumentCache::getMissCount() const
+	{
+		std::lock_guard<std::mutex> lock( mSharedData->mutex );
+		return mSharedData->missCount;
+	}
+
+	//------------------------------
+	void DocumentCache::clear()
+	{
+		std::lock_guard<std::mutex> lock( mSharedData->mutex );
+		mSharedData->shrink( 0 );
+	}
+
+	//------------------------------
+	bool DocumentCache::createKey( const COLLADABU::URI& uri, const String& loadOptions, String& key )
+	{
+		String nativePath = uri.toNativePath();
+		struct stat fileStatus;
+		if ( stat( nativePath.c_str(), &fileStatus ) != 0 )
+			return false;
+
+		std::ostringstream stream;
+		stream << normalizePath( nativePath ) << '\n' << (long long)fileStatus.st_mtime << '\n' << (long long)fileStatus.st_size << '\n' << loadOptions;
+		key = stream.str();
+		return true;
+	}
+
+	//------------------------------
+	bool DocumentCache::contains( const String& key ) const
+	{
+		std::lock_guard<std::mutex> lock( mSharedData->mutex );
+		return mSharedData->keyEntryMap.find( key ) != mSharedData->keyEntryMap.end();
+	}
+
+	//------------------------------
+	void DocumentCache::insert( const String& key, CachedDocument* document )
+	{
+		EntryPtr entry( new Entry(key, document) );
+
+		std::lock_guard<std::mutex> lock( mSharedData->mutex );
+		KeyEntryMap::iterator it = mSharedData->keyEntryMap.find( key );
+		if ( it != mSharedData->keyEntryMap.end() )
+			mSharedData->remove( it->second );
+
+		size_t memorySize = document->getMemorySize();
+		if ( memorySize > mSharedData->memoryLimit )
+			return;
+
+		mSharedData->shrink( mSharedData->memoryLimit - memorySize );
+		mSharedData->entries.push_front( entry );
+		mSharedData->keyEntryMap[key] = mSharedData->entries.begin();
+		mSharedData->memoryUsage += memorySize;
+	}
+
+	//------------------------------
+	bool DocumentCache::replay( const String& key, Loader& loader, bool& success )
+	{
+		EntryPtr entry;
+		{
+			std::lock_guard<std::mutex> lock( mSharedData->mutex );
+			KeyEntryMap::iterator it = mSharedData->keyEntryMap.find( key );
+			if ( it == mSharedData->keyEntryMap.end() )
+			{
+				mSharedData->missCount++;
+				return false;
+			}
+			mSharedData->hitCount++;
+			entry = *it->second;
+			mSharedData->entries.splice( mSharedData->entries.begin(), mSharedData->entries, it->second );
+		}
+
+		std::lock_guard<std::mutex> lock( entry->mutex );
+		success = entry->document->replay( loader );
+		return true;
+	}
+
+} // namespace COLLADASaxFWL
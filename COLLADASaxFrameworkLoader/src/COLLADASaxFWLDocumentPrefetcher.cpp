@@ -0,0 +1,263 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADASaxFWLStableHeaders.h"
+#include "COLLADASaxFWLDocumentPrefetcher.h"
+#include "COLLADASaxFWLCachedDocument.h"
+
+#include <climits>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+
+
+namespace COLLADASaxFWL
+{
+
+	namespace
+	{
+		/** A document passed to DocumentPrefetcher::prefetch().*/
+		struct Document
+		{
+			Document() : read(false), success(false), reservedBytes(0), parsedDocument(0) {}
+
+			/** The uri of the document.*/
+			COLLADABU::URI uri;
+
+			/** True, if a worker thread has finished reading and parsing the document.*/
+			bool read;
+
+			/** True, if the content has been read successfully and can be passed to the xml parser.*/
+			bool success;
+
+			/** The content of the document.*/
+			std::vector<char> content;
+
+			/** The number of bytes counted for the document in DocumentPrefetcher::SharedData::reservedBytes.*/
+			size_t reservedBytes;
+
+			/** The objects created by the parse function. Null, if the document has not been parsed.*/
+			CachedDocument* parsedDocument;
+		};
+
+		/** Opens the file @a path and determines its @a size.
+		@return The opened file, null if the file could not be opened or is too large to be passed to the xml 
+		parser.*/
+		FILE* openFile( const String& path, size_t& size )
+		{
+			FILE* file = fopen( path.c_str(), "rb" );
+			if ( !file )
+				return 0;
+
+			bool success = (fseek( file, 0, SEEK_END ) == 0);
+			long fileSize = success ? ftell( file ) : -1;
+			if ( !success || (fileSize < 0) || (fileSize > INT_MAX) || (fseek( file, 0, SEEK_SET ) != 0) )
+			{
+				fclose( file );
+				return 0;
+			}
+			size = (size_t)fileSize;
+			return file;
+		}
+
+		/** Reads the @a size bytes of the file @a file, opened by openFile(), to @a content and closes it.
+		@return False, if the file could not be read or is compressed.*/
+		bool readFile( FILE* file, size_t size, std::vector<char>& content )
+		{
+			content.resize( size );
+			bool success = (size == 0) || (fread( &content[0], 1, size, file ) == size);
+			fclose( file );
+
+			// gzip compressed documents are decompressed by the xml parser, when it opens the file itself
+			if ( success && (content.size() >= 2) && ((unsigned char)content[0] == 0x1f) && ((unsigned char)content[1] == 0x8b) )
+				success = false;
+			if ( !success )
+				std::vector<char>().swap( content );
+			return success;
+		}
+	}
+
+	/** The queue of documents to read and the documents read, guarded by a mutex.*/
+	struct DocumentPrefetcher::SharedData
+	{
+		SharedData( size_t maxBytes_, ParseFunction parseFunction_, const Loader* loader_ ) 
+			: maxBytes(maxBytes_), reservedBytes(0), stopping(false), parseFunction(parseFunction_), loader(loader_) {}
+
+		std::mutex mutex;
+
+		/** Signaled, if a document has been queued or the workers should stop.*/
+		std::condition_variable documentQueued;
+
+		/** Signaled, if a document has been read.*/
+		std::condition_variable documentRead;
+
+		/** Signaled, if a document has been taken and its bytes are no longer reserved.*/
+		std::condition_variable documentTaken;
+
+		/** The maximum number of bytes of the documents being read or read and not yet taken.*/
+		size_t maxBytes;
+
+		/** The number of bytes of the documents being read or read and not yet taken.*/
+		size_t reservedBytes;
+
+		/** The file ids of the documents not yet taken by a worker thread, in the order they should be read.*/
+		std::deque<COLLADAFW::FileId> queue;
+
+		/** The documents passed to prefetch() and not yet taken by takeDocument().*/
+		std::map<COLLADAFW::FileId, Document> documents;
+
+		/** True, if the worker threads should stop.*/
+		bool stopping;
+
+		/** The function the documents are parsed with. Null, if the documents are only read.*/
+		ParseFunction parseFunction;
+
+		/** The loader passed to the parse function.*/
+		const Loader* loader;
+
+		std::vector<std::thread> threads;
+
+		/** The main loop of the worker threads.*/
+		void work()
+		{
+			std::unique_lock<std::mutex> lock( mutex );
+			for ( ;; )
+			{
+				while ( queue.empty() && !stopping )
+					documentQueued.wait( lock );
+				if ( stopping )
+					return;
+
+				COLLADAFW::FileId fileId = queue.front();
+				queue.pop_front();
+				COLLADABU::URI uri = documents[fileId].uri;
+
+				// the file is read without holding the lock, the document is not removed before it is read
+				lock.unlock();
+				size_t size = 0;
+				FILE* file = openFile( uri.toNativePath(), size );
+				lock.lock();
+
+				// the document with the smallest file id is taken next, it is read, even if it exceeds the
+				// limit, so takeDocument() never waits for documents that wait for it
+				while ( file && !stopping && (reservedBytes != 0) && (reservedBytes + size > maxBytes) 
+					&& (documents.begin()->first != fileId) )
+				{
+					documentTaken.wait( lock );
+				}
+				if ( stopping )
+				{
+					if ( file )
+						fclose( file );
+					return;
+				}
+
+				std::vector<char> content;
+				bool success = false;
+				CachedDocument* parsedDocument = 0;
+				if ( file )
+				{
+					// the reserved bytes also stand for the objects of a parsed document
+					reservedBytes += size;
+					documents[fileId].reservedBytes = size;
+					lock.unlock();
+					success = readFile( file, size, content );
+					if ( success && parseFunction )
+						parsedDocument = parseFunction( *loader, uri, content );
+					if ( parsedDocument )
+						std::vector<char>().swap( content );
+					lock.lock();
+				}
+
+				Document& document = documents[fileId];
+				document.content.swap( content );
+				document.success = success;
+				document.parsedDocument = parsedDocument;
+				document.read = true;
+				if ( !success )
+					releaseBytes( document );
+				documentRead.notify_all();
+			}
+		}
+
+		/** Removes the bytes of @a document from the reserved bytes. Must be called with the mutex locked.*/
+		void releaseBytes( Document& document )
+		{
+			reservedBytes -= document.reservedBytes;
+			document.reservedBytes = 0;
+			documentTaken.notify_all();
+		}
+	};
+
+	//------------------------------
+	DocumentPrefetcher::DocumentPrefetcher( size_t threadCount, size_t maxBytes, ParseFunction parseFunction, const Loader* loader )
+		: mSharedData( new SharedData( maxBytes, parseFunction, loader ) )
+	{
+		if ( threadCount == 0 )
+			threadCount = 1;
+		mSharedData->threads.reserve( threadCount );
+		for ( size_t i = 0; i < threadCount; ++i )
+			mSharedData->threads.push_back( std::thread( &SharedData::work, mSharedData ) );
+	}
+
+	//------------------------------
+	DocumentPrefetcher::~DocumentPrefetcher()
+	{
+		{
+			std::lock_guard<std::mutex> lock( mSharedData->mutex );
+			mSharedData->stopping = true;
+		}
+		mSharedData->documentQueued.notify_all();
+		mSharedData->documentTaken.notify_all();
+		for ( size_t i = 0; i < mSharedData->threads.size(); ++i )
+			mSharedData->threads[i].join();
+
+		std::map<COLLADAFW::FileId, Document>::iterator it = mSharedData->documents.begin();
+		for ( ; it != mSharedData->documents.end(); ++it )
+			delete it->second.parsedDocument;
+		delete mSharedData;
+	}
+
+	//------------------------------
+	void DocumentPrefetcher::prefetch( COLLADAFW::FileId fileId, const COLLADABU::URI& uri )
+	{
+		{
+			std::lock_guard<std::mutex> lock( mSharedData->mutex );
+			if ( mSharedData->documents.find( fileId ) != mSharedData->documents.end() )
+				return;
+			mSharedData->documents[fileId].uri = uri;
+			mSharedData->queue.push_back( fileId );
+		}
+		mSharedData->documentQueued.notify_one();
+	}
+
+	//------------------------------
+	bool DocumentPrefetcher::takeDocument( COLLADAFW::FileId fileId, std::vector<char>& content, CachedDocument*& parsedDocument )
+	{
+		parsedDocument = 0;
+		std::unique_lock<std::mutex> lock( mSharedData->mutex );
+		std::map<COLLADAFW::FileId, Document>::iterator it = mSharedData->documents.find( fileId );
+		if ( it == mSharedData->documents.end() )
+			return false;
+		while ( !it->second.read )
+			mSharedData->documentRead.wait( lock );
+
+		bool success = it->second.success;
+		content.swap( it->second.content );
+		parsedDocument = it->second.parsedDocument;
+		mSharedData->releaseBytes( it->second );
+		mSharedData->documents.erase( it );
+		return success;
+	}
+
+} // namespace COLLADASaxFWL
@@ -10,14 +10,93 @@
 
 #include "COLLADASaxFWLStableHeaders.h"
 #include "COLLADASaxFWLDocumentProcessor.h"
+#include "COLLADASaxFWLAnimationSidAddressBindingSpillFile.h"
+#include "COLLADASaxFWLBinaryCacheLoader.h"
+#include "COLLADASaxFWLBinaryCacheWriter.h"
 
 #include "COLLADAFWNode.h"
 #include "COLLADAFWIWriter.h"
+#include "COLLADAFWVisualScene.h"
+#include "COLLADAFWLibraryNodes.h"
+#include "COLLADAFWEffect.h"
+#include "COLLADAFWLight.h"
+#include "COLLADAFWCamera.h"
+#include "COLLADAFWMesh.h"
+
+#include "COLLADABUParallel.h"
+
+#include <algorithm>
 
 
 namespace COLLADASaxFWL
 {
 
+	namespace
+	{
+		/** The minimum number of skin controllers, whose joints are resolved by one thread.*/
+		const size_t MIN_SKIN_CONTROLLERS_PER_THREAD = 16;
+
+		/** The number of bytes animation sid address bindings need to use, before they are moved to the spill
+		file, if the memory budget is exceeded. Avoids writing each binding on its own. Budgets smaller 
+		than four times this size use a quarter of the budget instead.*/
+		const size_t MIN_SPILLED_BINDINGS_BYTES = 64 * 1024;
+
+		/** A skin controller that needs to be created. The joints are resolved first, for all skin controllers,
+		afterwards the controllers are written.*/
+		struct SkinControllerJob
+		{
+			/** The instance controller data describing the instantiation of the skin controller.*/
+			const Loader::InstanceControllerData* instanceControllerData;
+
+			/** The unique id of the skin data used by the skin controller.*/
+			COLLADAFW::UniqueId skinDataUniqueId;
+
+			/** The unique id of the source of the skin controller.*/
+			COLLADAFW::UniqueId sourceUniqueId;
+
+			/** The joints that could be resolved.*/
+			NodeList joints;
+
+			/** The sids or ids of the joints that could not be resolved.*/
+			StringList unresolvedSidsOrIds;
+		};
+
+		typedef std::vector<SkinControllerJob> SkinControllerJobList;
+
+		/** Resolves the joints of a range of SkinControllerJobs.*/
+		class ResolveJointsTask : public COLLADABU::ParallelTask
+		{
+		private:
+			DocumentProcessor* mDocumentProcessor;
+			SkinControllerJobList& mJobs;
+			std::vector<Loader::SidPathSidTreeNodeMap>& mResolvedSidPathMaps;
+
+		public:
+			ResolveJointsTask( DocumentProcessor* documentProcessor, SkinControllerJobList& jobs, std::vector<Loader::SidPathSidTreeNodeMap>& resolvedSidPathMaps )
+				: mDocumentProcessor(documentProcessor)
+				, mJobs(jobs)
+				, mResolvedSidPathMaps(resolvedSidPathMaps)
+			{}
+
+			virtual void execute( size_t begin, size_t end, size_t threadIndex )
+			{
+				for ( size_t i = begin; i < end; ++i )
+				{
+					SkinControllerJob& job = mJobs[i];
+					if ( !job.skinDataUniqueId.isValid() )
+						continue;
+					const Loader::JointSidsOrIds& sidsOrIds = mDocumentProcessor->getJointSidsOrIdsBySkinDataUniqueId( job.skinDataUniqueId );
+					mDocumentProcessor->resolveJoints( *job.instanceControllerData, sidsOrIds.sidsOrIds, sidsOrIds.areIds, mResolvedSidPathMaps[threadIndex], job.joints, job.unresolvedSidsOrIds );
+				}
+			}
+
+		private:
+			/** Disable default assignment operator. */
+			const ResolveJointsTask& operator= ( const ResolveJointsTask& pre );
+		};
+	}
+
+
 	//-----------------------------
 	DocumentProcessor::DocumentProcessor ( Loader* colladaLoader, 
 		SaxParserErrorHandler* saxParserErrorHandler, 
@@ -26,6 +105,7 @@ namespace COLLADASaxFWL
 		: mColladaLoader( colladaLoader )
 		, mCurrentSidTreeNode( colladaLoader->getSidTreeRoot() )
 		, mIdStringSidTreeNodeMap( colladaLoader->getIdStringSidTreeNodeMap() )
+		, mResolvedSidPathMap( colladaLoader->getResolvedSidPathMap() )
 		, mVisualScenes( colladaLoader->getVisualScenes() )
 		, mLibraryNodes( colladaLoader->getLibraryNodes() )
 		, mEffects( colladaLoader->getEffects() )
@@ -41,6 +121,7 @@ namespace COLLADASaxFWL
 		, mInstanceControllerDataListMap( colladaLoader->getInstanceControllerDataListMap() )
 		, mSkinDataSkinSourceMap( colladaLoader->getSkinDataSkinSourceMap() )
 		, mSkinControllerSet( colladaLoader->getSkinControllerSet() )
+		, mMemoryUsage( colladaLoader->mMemoryUsage )
 		, mSaxParserErrorHandler( saxParserErrorHandler )
 	{
 
@@ -53,12 +134,24 @@ namespace COLLADASaxFWL
 	//---------------------------------
 	SidTreeNode* DocumentProcessor::addToSidTree( const char* colladaId, const char* colladaSid )
 	{
+		// the tree changes, previously resolved sid addresses might resolve differently
+		if ( !mResolvedSidPathMap.empty() )
+			mResolvedSidPathMap.clear();
+
 		mCurrentSidTreeNode = mCurrentSidTreeNode->createAndAddChild( colladaSid ? colladaSid : "");
+		size_t bytes = sizeof(SidTreeNode);
+		if ( colladaSid && *colladaSid )
+		{
+			// the child map entry of the parent
+			bytes += strlen( colladaSid ) + sizeof(String) + 2 * sizeof(SidTreeNode*);
+		}
 
 		if ( colladaId && *colladaId )
 		{
 			mIdStringSidTreeNodeMap[colladaId] = mCurrentSidTreeNode;
+			bytes += strlen( colladaId ) + sizeof(String) + 2 * sizeof(SidTreeNode*);
 		}
+		mMemoryUsage.add( MemoryUsage::SID_TREE, bytes );
 		return mCurrentSidTreeNode;
 	}
 
@@ -77,33 +170,72 @@ namespace COLLADASaxFWL
 
 	//---------------------------------
 	const SidTreeNode* DocumentProcessor::resolveSid( const SidAddress& sidAddress )
+	{
+		return resolveSid( sidAddress, mResolvedSidPathMap );
+	}
+
+	//---------------------------------
+	const SidTreeNode* DocumentProcessor::resolveSid( const SidAddress& sidAddress, Loader::SidPathSidTreeNodeMap& resolvedSidPathMap )
 	{
 		if ( !sidAddress.isValid() )
 			return 0;
 
-		SidTreeNode* startingPoint = 0;
 		const String& id = sidAddress.getId();
-		if ( !id.empty() )
-		{
-			// search for element with id 
-			startingPoint = findSidTreeNodeByStringId( id );
-		}
-
-		if ( !startingPoint )
+		if ( id.empty() )
 			return 0;
 
-		SidTreeNode* currentNode = startingPoint;
 		const SidAddress::SidList& sids = sidAddress.getSids();
+		size_t sidsCount = sids.size();
 
-		size_t i = 0;
+		// the sid path is the id followed by the sids, each preceded by a "/"
+		String sidPath( id );
+		for ( size_t i = 0; i < sidsCount; ++i)
+		{
+			sidPath += '/';
+			sidPath += sids[i];
+		}
+
+		Loader::SidPathSidTreeNodeMap::const_iterator resolvedIt = resolvedSidPathMap.find( sidPath );
+		if ( resolvedIt != resolvedSidPathMap.end() )
+			return resolvedIt->second;
 
-		if ( !sids.empty() && (sids.front() == startingPoint->getSid()) )
+		// search for the longest prefix of the sid path that has already been resolved
+		const SidTreeNode* currentNode = 0;
+		size_t i = sidsCount;
+		while ( i > 1 )
 		{
-			// the first one is the start element it self exclude it from recursive search
-			i = 1;
+			--i;
+			sidPath.resize( sidPath.length() - sids[i].length() - 1 );
+			resolvedIt = resolvedSidPathMap.find( sidPath );
+			if ( resolvedIt != resolvedSidPathMap.end() )
+			{
+				currentNode = resolvedIt->second;
+				break;
+			}
+		}
+
+		if ( !currentNode )
+		{
+			// search for element with id 
+			const SidTreeNode* startingPoint = findSidTreeNodeByStringId( id );
+			if ( !startingPoint )
+				return 0;
+
+			currentNode = startingPoint;
+			sidPath.assign( id );
+			i = 0;
+
+			if ( !sids.empty() && (sids.front() == startingPoint->getSid()) )
+			{
+				// the first one is the start element it self exclude it from recursive search
+				sidPath += '/';
+				sidPath += sids.front();
+				resolvedSidPathMap[sidPath] = startingPoint;
+				i = 1;
+			}
 		}
 
-		for ( size_t count = sids.size(); i < count; ++i)
+		for ( ; i < sidsCount; ++i)
 		{
 			const String& currentSid = sids[i];
 			SidTreeNode* childNode = currentNode->findChildBySid( currentSid );
@@ -112,11 +244,24 @@ namespace COLLADASaxFWL
 			{
 				// we could not find the sid as a child of currentNode
 				// lets try if the sid is in an instantiated element
-				return resolveSidInInstance( currentNode, sidAddress, i);
+				const SidTreeNode* instanceNode = resolveSidInInstance( currentNode, sidAddress, i, resolvedSidPathMap );
+				if ( instanceNode )
+				{
+					for ( ; i < sidsCount; ++i)
+					{
+						sidPath += '/';
+						sidPath += sids[i];
+					}
+					resolvedSidPathMap[sidPath] = instanceNode;
+				}
+				return instanceNode;
 			}
 			else
 			{
 				currentNode = childNode;
+				sidPath += '/';
+				sidPath += currentSid;
+				resolvedSidPathMap[sidPath] = currentNode;
 			}
 		}
 		return currentNode;
@@ -130,7 +275,7 @@ namespace COLLADASaxFWL
 	}
 
 	//---------------------------------
-	const SidTreeNode* DocumentProcessor::resolveSidInInstance( const SidTreeNode* instancingElement, const SidAddress& sidAddress,  size_t firstSidIndex)
+	const SidTreeNode* DocumentProcessor::resolveSidInInstance( const SidTreeNode* instancingElement, const SidAddress& sidAddress,  size_t firstSidIndex, Loader::SidPathSidTreeNodeMap& resolvedSidPathMap )
 	{
 		// the sid address we use to resolve the sid in the instantiated element
 		const COLLADABU::URI* uri = 0;
@@ -185,7 +330,7 @@ namespace COLLADASaxFWL
 		newSidAddress.setSecondIndex( sidAddress.getSecondIndex() );
 		newSidAddress.setMemberSelection( sidAddress.getMemberSelection() );
 		newSidAddress.setMemberSelectionName( sidAddress.getMemberSelectionName() );
-		return resolveSid( newSidAddress );
+		return resolveSid( newSidAddress, resolvedSidPathMap );
 	}
 
 
@@ -208,6 +353,42 @@ namespace COLLADASaxFWL
 	{
 		Loader::AnimationSidAddressBinding binding( animationInfo, targetSidAddress);
 		mAnimationSidAddressBindings.push_back(binding);
+		mMemoryUsage.add( MemoryUsage::ANIMATION_BINDINGS, sizeof(Loader::AnimationSidAddressBinding) + MemoryUsage::estimateBytes( targetSidAddress ) );
+
+		if ( isMemoryBudgetExceeded() )
+		{
+			size_t minSpilledBytes = std::min( mColladaLoader->getMemoryBudget() / 4, MIN_SPILLED_BINDINGS_BYTES );
+			if ( mMemoryUsage.getCurrentBytes( MemoryUsage::ANIMATION_BINDINGS ) >= minSpilledBytes )
+				spillAnimationSidAddressBindings();
+		}
+	}
+
+	//-----------------------------
+	bool DocumentProcessor::isMemoryBudgetExceeded() const
+	{
+		size_t memoryBudget = mColladaLoader->getMemoryBudget();
+		return (memoryBudget != 0) && (mMemoryUsage.getCurrentTotalBytes() > memoryBudget);
+	}
+
+	//-----------------------------
+	void DocumentProcessor::spillAnimationSidAddressBindings()
+	{
+		if ( mAnimationSidAddressBindings.empty() )
+			return;
+
+		AnimationSidAddressBindingSpillFile*& spillFile = mColladaLoader->mAnimationSidAddressBindingSpillFile;
+		if ( !spillFile )
+			spillFile = new AnimationSidAddressBindingSpillFile();
+
+		size_t bytesCount = spillFile->getBytesCount();
+		if ( !spillFile->write( mAnimationSidAddressBindings ) )
+			return;
+
+		mMemoryUsage.addSpilledBytes( MemoryUsage::ANIMATION_BINDINGS, spillFile->getBytesCount() - bytesCount );
+		mMemoryUsage.release( MemoryUsage::ANIMATION_BINDINGS );
+
+		// swap to actually release the memory of the list
+		Loader::AnimationSidAddressBindingList().swap( mAnimationSidAddressBindings );
 	}
 
 	COLLADAFW::AnimationList*& DocumentProcessor::getAnimationListByUniqueId( const COLLADAFW::UniqueId& animationListUniqueId )
@@ -215,6 +396,54 @@ namespace COLLADASaxFWL
 		return mUniqueIdAnimationListMap[animationListUniqueId];
 	}
 
+	//-----------------------------
+	void DocumentProcessor::addToObjectSidTreeNodeMap( const void* object )
+	{
+		// the sid tree nodes are only needed to release them, when the object is moved to a spill file
+		if ( mColladaLoader->getMemoryBudget() != 0 )
+			mColladaLoader->mObjectSidTreeNodeMap[object] = mCurrentSidTreeNode;
+	}
+
+	//-----------------------------
+	void DocumentProcessor::addVisualScene( COLLADAFW::VisualScene* visualScene )
+	{
+		mVisualScenes.push_back( visualScene );
+		mMemoryUsage.add( MemoryUsage::VISUAL_SCENES, MemoryUsage::estimateBytes( *visualScene ) );
+		addToObjectSidTreeNodeMap( visualScene );
+	}
+
+	//-----------------------------
+	void DocumentProcessor::addLibraryNodes( COLLADAFW::LibraryNodes* libraryNodes )
+	{
+		mLibraryNodes.push_back( libraryNodes );
+		mMemoryUsage.add( MemoryUsage::LIBRARY_NODES, MemoryUsage::estimateBytes( *libraryNodes ) );
+		addToObjectSidTreeNodeMap( libraryNodes );
+	}
+
+	//-----------------------------
+	void DocumentProcessor::addEffect( COLLADAFW::Effect* effect )
+	{
+		mEffects.push_back( effect );
+		mMemoryUsage.add( MemoryUsage::EFFECTS, MemoryUsage::estimateBytes( *effect ) );
+		addToObjectSidTreeNodeMap( effect );
+	}
+
+	//-----------------------------
+	void DocumentProcessor::addLight( COLLADAFW::Light* light )
+	{
+		mLights.push_back( light );
+		mMemoryUsage.add( MemoryUsage::LIGHTS, MemoryUsage::estimateBytes( *light ) );
+		addToObjectSidTreeNodeMap( light );
+	}
+
+	//-----------------------------
+	void DocumentProcessor::addCamera( COLLADAFW::Camera* camera )
+	{
+		mCameras.push_back( camera );
+		mMemoryUsage.add( MemoryUsage::CAMERAS, MemoryUsage::estimateBytes( *camera ) );
+		addToObjectSidTreeNodeMap( camera );
+	}
+
 	//-----------------------------
 	void DocumentProcessor::addSkinDataJointSidsPair( const COLLADAFW::UniqueId& skinDataUniqueId, const StringList& sidsOrIds, bool areIds )
 	{
@@ -258,6 +487,63 @@ namespace COLLADASaxFWL
 		}
 	}
 
+	//-----------------------------
+	void DocumentProcessor::addTransformedDuplicateGeometry( const COLLADAFW::Mesh& mesh )
+	{
+		std::vector<char>& storedGeometry = mColladaLoader->getTransformedDuplicateGeometries()[mesh.getUniqueId()];
+		if ( BinaryCacheWriter::storeObject( mesh, storedGeometry ) )
+			mMemoryUsage.add( MemoryUsage::DUPLICATE_GEOMETRIES, storedGeometry.size() );
+		else
+			mColladaLoader->getTransformedDuplicateGeometries().erase( mesh.getUniqueId() );
+	}
+
+	//-----------------------------
+	void DocumentProcessor::addSkinDataOriginalSourcePair( const COLLADAFW::UniqueId& skinDataUniqueId, const COLLADAFW::UniqueId& originalUniqueId )
+	{
+		mColladaLoader->getSkinDataOriginalSourceMap()[skinDataUniqueId] = originalUniqueId;
+	}
+
+	//-----------------------------
+	const COLLADAFW::UniqueId& DocumentProcessor::getControllerGeometryUniqueId( const COLLADAFW::UniqueId& geometryUniqueId )
+	{
+		if ( !mColladaLoader->getInstanceDuplicateGeometries() )
+			return geometryUniqueId;
+
+		const COLLADAFW::MeshDeduplicator::Duplicate* duplicate = mColladaLoader->getMeshDeduplicator().findDuplicate( geometryUniqueId );
+		if ( !duplicate )
+			return geometryUniqueId;
+		if ( !duplicate->transformed )
+			return duplicate->originalId;
+
+		// the transformation can not be applied to the controller, the copy is written instead
+		Loader::UniqueIdStoredGeometryMap& storedGeometries = mColladaLoader->getTransformedDuplicateGeometries();
+		Loader::UniqueIdStoredGeometryMap::iterator it = storedGeometries.find( geometryUniqueId );
+		if ( it == storedGeometries.end() )
+		{
+			String msg("Geometry \"" + geometryUniqueId.toAscii() + "\" used by a controller is a moved copy of geometry \""
+				+ duplicate->originalId.toAscii() + "\", that could not be kept. The controller uses it untransformed.");
+			handleFWLError( SaxFWLError::ERROR_DATA_NOT_SUPPORTED, msg );
+			return duplicate->originalId;
+		}
+
+		std::vector<char>& storedGeometry = it->second;
+		if ( !storedGeometry.empty() )
+		{
+			bool writerSuccess = true;
+			BinaryCacheLoader::loadPayload( BinaryCacheFormat::RECORD_GEOMETRY, &storedGeometry[0], storedGeometry.size(), writer(), writerSuccess );
+			mMemoryUsage.remove( MemoryUsage::DUPLICATE_GEOMETRIES, storedGeometry.size() );
+			std::vector<char>().swap( storedGeometry );
+		}
+		return geometryUniqueId;
+	}
+
+	//-----------------------------
+	void DocumentProcessor::releaseTransformedDuplicateGeometries()
+	{
+		mColladaLoader->getTransformedDuplicateGeometries().clear();
+		mMemoryUsage.release( MemoryUsage::DUPLICATE_GEOMETRIES );
+	}
+
 	//-----------------------------
 	const Loader::InstanceControllerDataList& DocumentProcessor::getInstanceControllerDataListByControllerUniqueId( const COLLADAFW::UniqueId& controllerUniqueId ) const
 	{
@@ -309,13 +595,25 @@ namespace COLLADASaxFWL
 		if ( !controllerDataUniqueId.isValid() )
 			return false;
 
-		const URIList& skeletonRoots = instanceControllerData.skeletonRoots;
-
 		NodeList joints;
+		StringList unresolvedSidsOrIds;
+		resolveJoints( instanceControllerData, sidsOrIds, resolveIds, mResolvedSidPathMap, joints, unresolvedSidsOrIds );
+		return writeSkinController( instanceControllerData, controllerDataUniqueId, sourceUniqueId, joints, unresolvedSidsOrIds, resolveIds );
+	}
+
+	//-----------------------------
+	void DocumentProcessor::resolveJoints( const Loader::InstanceControllerData& instanceControllerData, 
+		const StringList& sidsOrIds,
+		bool resolveIds,
+		Loader::SidPathSidTreeNodeMap& resolvedSidPathMap,
+		NodeList& joints,
+		StringList& unresolvedSidsOrIds)
+	{
+		const URIList& skeletonRoots = instanceControllerData.skeletonRoots;
 
 		for ( StringList::const_iterator it = sidsOrIds.begin(); it != sidsOrIds.end(); ++it)
 		{
-			const String sidOrId = *it;
+			const String& sidOrId = *it;
 
 			bool jointFound = false;
 			if ( resolveIds )
@@ -330,7 +628,7 @@ namespace COLLADASaxFWL
 			else if ( skeletonRoots.size() == 0 )
 			{
 				// Joints are referenced by Sid and no <skeleton> entries are defined
-				const SidTreeNode* joint = resolveSid( sidOrId );
+				const SidTreeNode* joint = resolveSid( SidAddress( sidOrId ), resolvedSidPathMap );
 				if ( joint )
 				{
 					jointFound = addValidatedJoint(*joint, joints);
@@ -344,7 +642,7 @@ namespace COLLADASaxFWL
 					const COLLADABU::URI& skeletonUri = *skeletonIt;
 
 					SidAddress sidAddress( skeletonUri, sidOrId );
-					const SidTreeNode* joint = resolveSid( sidAddress );
+					const SidTreeNode* joint = resolveSid( sidAddress, resolvedSidPathMap );
 					if ( joint )
 					{
                         jointFound = addValidatedJoint(*joint, joints);
@@ -357,16 +655,29 @@ namespace COLLADASaxFWL
 				}
 			}
 
-
 			if ( !jointFound )
 			{
-				std::stringstream msg;
-				msg << "Could not resolve " << (resolveIds ? "id" : "sid") << " \"";
-				msg << sidOrId << "\" referenced in skin controller.";
-				if ( handleFWLError( SaxFWLError::ERROR_UNRESOLVED_REFERENCE, msg.str() ))
-				{
-					return false;
-				}
+				unresolvedSidsOrIds.push_back( sidOrId );
+			}
+		}
+	}
+
+	//-----------------------------
+	bool DocumentProcessor::writeSkinController( const Loader::InstanceControllerData& instanceControllerData, 
+		const COLLADAFW::UniqueId& controllerDataUniqueId, 
+		const COLLADAFW::UniqueId& sourceUniqueId,
+		const NodeList& joints,
+		const StringList& unresolvedSidsOrIds,
+		bool resolveIds)
+	{
+		for ( StringList::const_iterator it = unresolvedSidsOrIds.begin(); it != unresolvedSidsOrIds.end(); ++it)
+		{
+			std::stringstream msg;
+			msg << "Could not resolve " << (resolveIds ? "id" : "sid") << " \"";
+			msg << *it << "\" referenced in skin controller.";
+			if ( handleFWLError( SaxFWLError::ERROR_UNRESOLVED_REFERENCE, msg.str() ))
+			{
+				return false;
 			}
 		}
 
@@ -413,6 +724,8 @@ namespace COLLADASaxFWL
 	//-----------------------------
 	bool DocumentProcessor::createAndWriteSkinControllers()
 	{
+		SkinControllerJobList jobs;
+
 		Loader::InstanceControllerDataListMap::const_iterator mapIt = mInstanceControllerDataListMap.begin();
 
 		for ( ; mapIt != mInstanceControllerDataListMap.end(); ++mapIt )
@@ -439,10 +752,43 @@ namespace COLLADASaxFWL
 					// TODO handle error
 					continue;
 				}
-				if ( !createAndWriteSkinController( instanceControllerData, skinDataUniqueId, sourceUniqueId ) )
-					return false;
+
+				SkinControllerJob job;
+				job.instanceControllerData = &instanceControllerData;
+				job.skinDataUniqueId = skinDataUniqueId;
+				// the bind shape matrix includes the transformation of a moved copy, see 
+				// LibraryControllersLoader::end__skin()
+				Loader::SkinDataOriginalSourceMap::const_iterator originalIt = mColladaLoader->getSkinDataOriginalSourceMap().find( skinDataUniqueId );
+				if ( originalIt != mColladaLoader->getSkinDataOriginalSourceMap().end() )
+					job.sourceUniqueId = originalIt->second;
+				else
+					job.sourceUniqueId = getControllerGeometryUniqueId( sourceUniqueId );
+				jobs.push_back( job );
 			}
 		}
+
+		// resolve the joints of all skin controllers concurrently. Each thread uses its own map of resolved sid
+		// addresses, since the maps are modified while resolving
+		size_t threadCount = COLLADABU::getParallelThreadCount( jobs.size(), mColladaLoader->getThreadCount(), MIN_SKIN_CONTROLLERS_PER_THREAD );
+		std::vector<Loader::SidPathSidTreeNodeMap> resolvedSidPathMaps( threadCount );
+		ResolveJointsTask resolveJointsTask( this, jobs, resolvedSidPathMaps );
+		COLLADABU::parallelFor( jobs.size(), resolveJointsTask, threadCount, MIN_SKIN_CONTROLLERS_PER_THREAD );
+
+		for ( size_t i = 0; i < threadCount; ++i )
+		{
+			mResolvedSidPathMap.insert( resolvedSidPathMaps[i].begin(), resolvedSidPathMaps[i].end() );
+		}
+
+		// write the skin controllers in the same order they would have been written without threads
+		for ( size_t i = 0, count = jobs.size(); i < count; ++i )
+		{
+			const SkinControllerJob& job = jobs[i];
+			if ( !job.skinDataUniqueId.isValid() )
+				return false;
+			const Loader::JointSidsOrIds& sidsOrIds = getJointSidsOrIdsBySkinDataUniqueId( job.skinDataUniqueId );
+			if ( !writeSkinController( *job.instanceControllerData, job.skinDataUniqueId, job.sourceUniqueId, job.joints, job.unresolvedSidsOrIds, sidsOrIds.areIds ) )
+				return false;
+		}
 		return true;
 	}
 
@@ -0,0 +1,348 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADASaxFWLStableHeaders.h"
+#include "COLLADASaxFWLDocumentRecorder.h"
+#include "COLLADASaxFWLDocumentCache.h"
+#include "COLLADASaxFWLCachedDocument.h"
+
+#include "COLLADAFWFileInfo.h"
+#include "COLLADAFWScene.h"
+#include "COLLADAFWVisualScene.h"
+#include "COLLADAFWLibraryNodes.h"
+#include "COLLADAFWNode.h"
+#include "COLLADAFWGeometry.h"
+#include "COLLADAFWMesh.h"
+#include "COLLADAFWMaterial.h"
+#include "COLLADAFWEffect.h"
+#include "COLLADAFWCamera.h"
+#include "COLLADAFWImage.h"
+#include "COLLADAFWLight.h"
+#include "COLLADAFWAnimation.h"
+#include "COLLADAFWAnimationList.h"
+#include "COLLADAFWAnimationClip.h"
+#include "COLLADAFWSkinControllerData.h"
+#include "COLLADAFWController.h"
+#include "COLLADAFWFormulas.h"
+#include "COLLADAFWKinematicsScene.h"
+
+
+namespace COLLADASaxFWL
+{
+
+	//------------------------------
+	DocumentRecorder::DocumentRecorder( COLLADAFW::IWriter* writer )
+		: mWriter(writer)
+		, mCurrentRecording(0)
+		, mCurrentFileId(0)
+	{
+	}
+
+	//------------------------------
+	DocumentRecorder::~DocumentRecorder()
+	{
+		invalidateAllDocuments();
+	}
+
+	//------------------------------
+	void DocumentRecorder::startDocument( COLLADAFW::FileId fileId, const String& key )
+	{
+		Recording& recording = mRecordings[fileId];
+		recording.key = key;
+		recording.document = new CachedDocument( fileId );
+		mCurrentRecording = &recording;
+		mCurrentFileId = fileId;
+	}
+
+	//------------------------------
+	void DocumentRecorder::endDocument()
+	{
+		mCurrentRecording = 0;
+	}
+
+	//------------------------------
+	void DocumentRecorder::invalidateDocument( COLLADAFW::FileId fileId )
+	{
+		FileIdRecordingMap::iterator it = mRecordings.find( fileId );
+		if ( it == mRecordings.end() )
+			return;
+		delete it->second.document;
+		it->second.document = 0;
+	}
+
+	//------------------------------
+	void DocumentRecorder::invalidateAllDocuments()
+	{
+		for ( FileIdRecordingMap::iterator it = mRecordings.begin(); it != mRecordings.end(); ++it )
+		{
+			delete it->second.document;
+			it->second.document = 0;
+		}
+	}
+
+	//------------------------------
+	void DocumentRecorder::addPendingObject( const void* object, COLLADAFW::FileId fileId )
+	{
+		FileIdRecordingMap::iterator it = mRecordings.find( fileId );
+		if ( (it == mRecordings.end()) || !it->second.document )
+			return;
+		mPendingObjects[object] = fileId;
+		it->second.pendingObjectsCount++;
+	}
+
+	//------------------------------
+	bool DocumentRecorder::retain( COLLADAFW::FileInfo* asset )
+	{
+		ObjectFileIdMap::iterator pendingIt = mPendingObjects.find( asset );
+		if ( pendingIt == mPendingObjects.end() )
+			return false;
+		Recording& recording = mRecordings[pendingIt->second];
+		mPendingObjects.erase( pendingIt );
+		recording.pendingObjectsCount--;
+		if ( !recording.document )
+			return false;
+
+		recording.document->setAsset( asset );
+		return true;
+	}
+
+	//------------------------------
+	bool DocumentRecorder::retain( COLLADAFW::Object* object )
+	{
+		ObjectFileIdMap::iterator pendingIt = mPendingObjects.find( object );
+		if ( pendingIt == mPendingObjects.end() )
+			return false;
+		Recording& recording = mRecordings[pendingIt->second];
+		mPendingObjects.erase( pendingIt );
+		recording.pendingObjectsCount--;
+		if ( !recording.document )
+			return false;
+
+		// only the objects accepted by the write methods are pending
+		switch ( object->getClassId() )
+		{
+		case COLLADAFW::COLLADA_TYPE::IMAGE:
+			recording.document->addImage( static_cast<COLLADAFW::Image*>(object) );
+			break;
+		case COLLADAFW::COLLADA_TYPE::MATERIAL:
+			recording.document->addMaterial( static_cast<COLLADAFW::Material*>(object) );
+			break;
+		case COLLADAFW::COLLADA_TYPE::GEOMETRY:
+			recording.document->addMesh( static_cast<COLLADAFW::Mesh*>(object) );
+			break;
+		case COLLADAFW::COLLADA_TYPE::EFFECT:
+			recording.document->addEffect( static_cast<COLLADAFW::Effect*>(object) );
+			break;
+		default:
+			return false;
+		}
+		return true;
+	}
+
+	//------------------------------
+	void DocumentRecorder::commit( DocumentCache& cache, const Loader::URIUniqueIdMap& uriUniqueIdMap )
+	{
+		for ( FileIdRecordingMap::iterator it = mRecordings.begin(); it != mRecordings.end(); ++it )
+		{
+			if ( it->second.document && (it->second.pendingObjectsCount != 0) )
+				invalidateDocument( it->first );
+		}
+
+		// the elements of the documents are referenced by the uris their unique ids have been created for
+		for ( Loader::URIUniqueIdMap::const_iterator it = uriUniqueIdMap.begin(); it != uriUniqueIdMap.end(); ++it )
+		{
+			FileIdRecordingMap::iterator recordingIt = mRecordings.find( it->second.getFileId() );
+			if ( (recordingIt != mRecordings.end()) && recordingIt->second.document && !it->first.getFragment().empty() )
+				recordingIt->second.document->addFragment( it->first.getFragment(), it->second );
+		}
+
+		for ( FileIdRecordingMap::iterator it = mRecordings.begin(); it != mRecordings.end(); ++it )
+		{
+			if ( it->second.document )
+			{
+				cache.insert( it->second.key, it->second.document );
+				it->second.document = 0;
+			}
+		}
+	}
+
+	//------------------------------
+	CachedDocument* DocumentRecorder::takeDocument( COLLADAFW::FileId fileId, const Loader::URIUniqueIdMap& uriUniqueIdMap )
+	{
+		FileIdRecordingMap::iterator recordingIt = mRecordings.find( fileId );
+		if ( recordingIt == mRecordings.end() )
+			return 0;
+		if ( recordingIt->second.pendingObjectsCount != 0 )
+			invalidateDocument( fileId );
+
+		CachedDocument* document = recordingIt->second.document;
+		if ( document )
+		{
+			for ( Loader::URIUniqueIdMap::const_iterator it = uriUniqueIdMap.begin(); it != uriUniqueIdMap.end(); ++it )
+			{
+				if ( (it->second.getFileId() == fileId) && !it->first.getFragment().empty() )
+					document->addFragment( it->first.getFragment(), it->second );
+			}
+		}
+		if ( mCurrentRecording == &recordingIt->second )
+			mCurrentRecording = 0;
+		mRecordings.erase( recordingIt );
+		return document;
+	}
+
+	//------------------------------
+	void DocumentRecorder::cancel( const String& errorMessage )
+	{
+		mWriter->cancel( errorMessage );
+	}
+
+	//------------------------------
+	void DocumentRecorder::start()
+	{
+		mWriter->start();
+	}
+
+	//------------------------------
+	void DocumentRecorder::finish()
+	{
+		mWriter->finish();
+	}
+
+	//------------------------------
+	bool DocumentRecorder::writeGlobalAsset( const COLLADAFW::FileInfo* asset )
+	{
+		if ( mCurrentRecording )
+			addPendingObject( asset, mCurrentFileId );
+		return mWriter->writeGlobalAsset( asset );
+	}
+
+	//------------------------------
+	bool DocumentRecorder::writeScene( const COLLADAFW::Scene* scene )
+	{
+		if ( mCurrentRecording )
+			invalidateDocument( mCurrentFileId );
+		return mWriter->writeScene( scene );
+	}
+
+	//------------------------------
+	bool DocumentRecorder::writeVisualScene( const COLLADAFW::VisualScene* visualScene )
+	{
+		invalidateDocument( visualScene->getFileId() );
+		return mWriter->writeVisualScene( visualScene );
+	}
+
+	//------------------------------
+	bool DocumentRecorder::writeLibraryNodes( const COLLADAFW::LibraryNodes* libraryNodes )
+	{
+		const COLLADAFW::NodePointerArray& nodes = libraryNodes->getNodes();
+		for ( size_t i = 0, count = nodes.getCount(); i < count; ++i )
+			invalidateDocument( nodes[i]->getFileId() );
+		return mWriter->writeLibraryNodes( libraryNodes );
+	}
+
+	//------------------------------
+	bool DocumentRecorder::writeGeometry( const COLLADAFW::Geometry* geometry )
+	{
+		if ( geometry->getType() == COLLADAFW::Geometry::GEO_TYPE_MESH )
+			addPendingObject( geometry, geometry->getFileId() );
+		else
+			invalidateDocument( geometry->getFileId() );
+		return mWriter->writeGeometry( geometry );
+	}
+
+	//------------------------------
+	bool DocumentRecorder::writeMaterial( const COLLADAFW::Material* material )
+	{
+		addPendingObject( material, material->getFileId() );
+		return mWriter->writeMaterial( material );
+	}
+
+	//------------------------------
+	bool DocumentRecorder::writeEffect( const COLLADAFW::Effect* effect )
+	{
+		addPendingObject( effect, effect->getFileId() );
+		return mWriter->writeEffect( effect );
+	}
+
+	//------------------------------
+	bool DocumentRecorder::writeCamera( const COLLADAFW::Camera* camera )
+	{
+		invalidateDocument( camera->getFileId() );
+		return mWriter->writeCamera( camera );
+	}
+
+	//------------------------------
+	bool DocumentRecorder::writeImage( const COLLADAFW::Image* image )
+	{
+		addPendingObject( image, image->getFileId() );
+		return mWriter->writeImage( image );
+	}
+
+	//------------------------------
+	bool DocumentRecorder::writeLight( const COLLADAFW::Light* light )
+	{
+		invalidateDocument( light->getFileId() );
+		return mWriter->writeLight( light );
+	}
+
+	//------------------------------
+	bool DocumentRecorder::writeAnimation( const COLLADAFW::Animation* animation )
+	{
+		invalidateDocument( animation->getFileId() );
+		return mWriter->writeAnimation( animation );
+	}
+
+	//------------------------------
+	bool DocumentRecorder::writeAnimationList( const COLLADAFW::AnimationList* animationList )
+	{
+		invalidateDocument( animationList->getFileId() );
+		return mWriter->writeAnimationList( animationList );
+	}
+
+	//------------------------------
+	bool DocumentRecorder::writeAnimationClip( const COLLADAFW::AnimationClip* animationClip )
+	{
+		invalidateDocument( animationClip->getFileId() );
+		return mWriter->writeAnimationClip( animationClip );
+	}
+
+	//------------------------------
+	bool DocumentRecorder::writeSkinControllerData( const COLLADAFW::SkinControllerData* skinControllerData )
+	{
+		invalidateDocument( skinControllerData->getFileId() );
+		return mWriter->writeSkinControllerData( skinControllerData );
+	}
+
+	//------------------------------
+	bool DocumentRecorder::writeController( const COLLADAFW::Controller* controller )
+	{
+		invalidateDocument( controller->getFileId() );
+		return mWriter->writeController( controller );
+	}
+
+	//------------------------------
+	bool DocumentRecorder::writeFormulas( const COLLADAFW::Formulas* formulas )
+	{
+		if ( !formulas->getFormulas().empty() )
+			invalidateAllDocuments();
+		return mWriter->writeFormulas( formulas );
+	}
+
+	//------------------------------
+	bool DocumentRecorder::writeKinematicsScene( const COLLADAFW::KinematicsScene* kinematicsScene )
+	{
+		if ( !kinematicsScene->getKinematicsModels().empty() 
+			|| !kinematicsScene->getKinematicsControllers().empty() 
+			|| !kinematicsScene->getInstanceKinematicsScenes().empty() )
+			invalidateAllDocuments();
+		return mWriter->writeKinematicsScene( kinematicsScene );
+	}
+
+} // namespace COLLADASaxFWL
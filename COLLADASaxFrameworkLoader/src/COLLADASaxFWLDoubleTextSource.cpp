@@ -0,0 +1,47 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADASaxFWLStableHeaders.h"
+#include "COLLADASaxFWLDoubleTextSource.h"
+
+#include "GeneratedSaxParserUtils.h"
+
+
+namespace COLLADASaxFWL
+{
+
+	//------------------------------
+	bool DoubleTextSource::textData( const ParserChar* text, size_t textLength )
+	{
+		mText.append( text, textLength );
+		return true;
+	}
+
+	//------------------------------
+	bool DoubleTextSource::convertText()
+	{
+		COLLADAFW::DoubleArray& values = getArrayElement().getValues();
+		const ParserChar* buffer = mText.c_str();
+		bool failed = false;
+		while ( true )
+		{
+			double value = GeneratedSaxParser::Utils::toDouble( &buffer, failed );
+			if ( failed )
+				break;
+			values.append( value );
+		}
+
+		// the conversion stops at the terminating zero, unless the text contains something else
+		bool success = (*buffer == 0);
+		String().swap( mText );
+		return success;
+	}
+
+} // namespace COLLADASaxFWL
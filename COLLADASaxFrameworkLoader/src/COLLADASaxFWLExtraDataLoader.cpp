@@ -14,6 +14,8 @@
 #include "COLLADASaxFWLFileLoader.h"
 #include "COLLADASaxFWLIExtraDataCallbackHandler.h"
 
+#include "GeneratedSaxParserUtils.h"
+
 
 namespace COLLADASaxFWL
 {
@@ -37,27 +39,36 @@ namespace COLLADASaxFWL
         // Get the extra data element handler.
         ExtraDataElementHandler& extraDataElementHandler = getFileLoader ()->getExtraDataElementHandler ();
 
-        // Ask all handlers, if they want to have the data of the current extra tag.
-        // (profile name, element name ("optics"), id (cameraId)) 
+        // Get the hash value of the current element.
+        size_t level = 1;
+        StringHash elementHash = getFileLoader ()->getElementHash ( level );
+
+        // Get the profile name.
+        const ParserChar* profileName = attributeData.profile;
+        StringHash profileHash = profileName ? GeneratedSaxParser::Utils::calculateStringHash ( profileName ) : 0;
+
+        // Ask all handlers, the technique is offered to, if they want to have the data of the current
+        // extra tag. (profile name, element name ("optics"), id (cameraId)) 
         const ExtraDataCallbackHandlerList& extraDataCallbackHandlerList = extraDataElementHandler.getExtraDataCallbackHandlerList ();
         size_t numHandlers = extraDataCallbackHandlerList.size ();
+        bool parseTechnique = false;
         for ( size_t i=0; i<numHandlers; ++i )
         {
             IExtraDataCallbackHandler* extraDataCallbackHandler = extraDataCallbackHandlerList[i];
 
-            // Get the hash value of the current element.
-            size_t level = 1;
-            StringHash elementHash = getFileLoader ()->getElementHash ( level );
-
-            // Get the profile name.
-            const ParserChar* profileName = attributeData.profile;
-
             // Ask, if the current handler should parse the extra tags of the current element.
-            bool parseElement = extraDataCallbackHandler->parseElement ( profileName, elementHash, uniqueId, object );
+            bool parseElement = extraDataCallbackHandler->isTechniqueOffered ( profileHash, elementHash )
+                && extraDataCallbackHandler->parseElement ( profileName, elementHash, uniqueId, object );
 
             // Store the flag in the list.
             extraDataElementHandler.setExtraDataCallbackHandlerCalling ( i, parseElement );
+            parseTechnique |= parseElement;
         }
+
+        // The children of the technique are only passed to the handlers. 
+        if ( !parseTechnique )
+            getFileLoader ()->skipCurrentElement ();
+
         return true;
     }
 
@@ -0,0 +1,288 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADASaxFWLStableHeaders.h"
+#include "COLLADASaxFWLFanOutWriter.h"
+#include "COLLADASaxFWLWriterQueue.h"
+
+#include <vector>
+
+
+namespace COLLADASaxFWL
+{
+
+	/** The queues of the writers.*/
+	struct FanOutWriter::SharedData
+	{
+		SharedData( size_t _maxQueuedBytes )
+			: maxQueuedBytes(_maxQueuedBytes)
+			, running(false)
+		{}
+
+		~SharedData()
+		{
+			for ( size_t i = 0; i < queues.size(); ++i )
+				delete queues[i];
+		}
+
+		/** The queue of each writer, executed by one thread.*/
+		std::vector<WriterQueue*> queues;
+
+		size_t maxQueuedBytes;
+
+		/** True, while the threads are running.*/
+		bool running;
+
+		/** Queues @a task for all writers. Waits until the queues have room for it, unless @a bounded is
+		false.*/
+		void push( const WriterQueue::Task& task, bool bounded )
+		{
+			for ( size_t i = 0; i < queues.size(); ++i )
+				queues[i]->push( task, bounded );
+		}
+
+		/** Passes @a object to all writers. The object is stored and written asynchronously, unless
+		@a synchronous is true or it can not be stored. A synchronous object is stored as well, if possible,
+		such that each writer restores its own copy.*/
+		template<class Object, bool (COLLADAFW::IWriter::*writeMethod)(const Object*)>
+		bool write( BinaryCacheFormat::RecordType recordType, const Object* object, bool synchronous )
+		{
+			if ( !running || queues.empty() )
+				return true;
+
+			WriterQueue::Task task = WriterQueue::createWriteTask<Object, writeMethod>( recordType, object );
+			if ( (task.type == WriterQueue::TASK_RECORD) && !synchronous )
+			{
+				push( task, true );
+				return true;
+			}
+
+			task.synchronous = true;
+			bool success = true;
+			if ( task.type == WriterQueue::TASK_RECORD )
+			{
+				push( task, false );
+				for ( size_t i = 0; i < queues.size(); ++i )
+				{
+					queues[i]->waitUntilIdle();
+					success = queues[i]->getSynchronousSuccess() && success;
+				}
+				return success;
+			}
+
+			// the object is not copied, i.e. it is passed to one writer after the other, since the writers
+			// would otherwise read it on several threads at once
+			for ( size_t i = 0; i < queues.size(); ++i )
+			{
+				queues[i]->push( task, false );
+				queues[i]->waitUntilIdle();
+				success = queues[i]->getSynchronousSuccess() && success;
+			}
+			return success;
+		}
+
+		/** Stops the threads, after they have executed the queued tasks.*/
+		void join()
+		{
+			for ( size_t i = 0; i < queues.size(); ++i )
+				queues[i]->stopThreads();
+			running = false;
+		}
+
+		/** Removes the objects not yet written from the queues. Starts, cancels and finishes of the writers
+		are kept.*/
+		void dropObjects()
+		{
+			for ( size_t i = 0; i < queues.size(); ++i )
+				queues[i]->dropObjects();
+		}
+	};
+
+	//------------------------------
+	FanOutWriter::FanOutWriter( size_t maxQueuedBytes )
+		: mSharedData( new SharedData( maxQueuedBytes ) )
+	{
+	}
+
+	//------------------------------
+	FanOutWriter::~FanOutWriter()
+	{
+		if ( mSharedData->running )
+		{
+			mSharedData->dropObjects();
+			mSharedData->join();
+		}
+		delete mSharedData;
+	}
+
+	//------------------------------
+	void FanOutWriter::addWriter( COLLADAFW::IWriter* writer )
+	{
+		if ( writer && !mSharedData->running )
+			mSharedData->queues.push_back( new WriterQueue( writer, mSharedData->maxQueuedBytes ) );
+	}
+
+	//------------------------------
+	size_t FanOutWriter::getWriterCount() const
+	{
+		return mSharedData->queues.size();
+	}
+
+	//------------------------------
+	bool FanOutWriter::getSuccess( size_t writerIndex ) const
+	{
+		return mSharedData->queues[writerIndex]->getSuccess();
+	}
+
+	//------------------------------
+	BinaryCacheFormat::RecordType FanOutWriter::getFirstFailedRecordType( size_t writerIndex ) const
+	{
+		return mSharedData->queues[writerIndex]->getFirstFailedRecordType();
+	}
+
+	//------------------------------
+	void FanOutWriter::cancel( const String& errorMessage )
+	{
+		if ( !mSharedData->running )
+			return;
+		mSharedData->dropObjects();
+		WriterQueue::Task task( WriterQueue::TASK_CANCEL );
+		task.errorMessage = errorMessage;
+		mSharedData->push( task, false );
+	}
+
+	//------------------------------
+	void FanOutWriter::start()
+	{
+		if ( mSharedData->running )
+			finish();
+
+		mSharedData->running = true;
+		for ( size_t i = 0; i < mSharedData->queues.size(); ++i )
+		{
+			WriterQueue* queue = mSharedData->queues[i];
+			queue->resetSuccess();
+			queue->startThreads( 1 );
+		}
+		mSharedData->push( WriterQueue::Task( WriterQueue::TASK_START ), false );
+	}
+
+	//------------------------------
+	void FanOutWriter::finish()
+	{
+		if ( !mSharedData->running )
+			return;
+		mSharedData->push( WriterQueue::Task( WriterQueue::TASK_FINISH ), false );
+		mSharedData->join();
+	}
+
+	//------------------------------
+	bool FanOutWriter::writeGlobalAsset( const COLLADAFW::FileInfo* asset )
+	{
+		return mSharedData->write<COLLADAFW::FileInfo, &COLLADAFW::IWriter::writeGlobalAsset>( BinaryCacheFormat::RECORD_GLOBAL_ASSET, asset, true );
+	}
+
+	//------------------------------
+	bool FanOutWriter::writeScene( const COLLADAFW::Scene* scene )
+	{
+		return mSharedData->write<COLLADAFW::Scene, &COLLADAFW::IWriter::writeScene>( BinaryCacheFormat::RECORD_SCENE, scene, false );
+	}
+
+	//------------------------------
+	bool FanOutWriter::writeVisualScene( const COLLADAFW::VisualScene* visualScene )
+	{
+		return mSharedData->write<COLLADAFW::VisualScene, &COLLADAFW::IWriter::writeVisualScene>( BinaryCacheFormat::RECORD_VISUAL_SCENE, visualScene, false );
+	}
+
+	//------------------------------
+	bool FanOutWriter::writeLibraryNodes( const COLLADAFW::LibraryNodes* libraryNodes )
+	{
+		return mSharedData->write<COLLADAFW::LibraryNodes, &COLLADAFW::IWriter::writeLibraryNodes>( BinaryCacheFormat::RECORD_LIBRARY_NODES, libraryNodes, false );
+	}
+
+	//------------------------------
+	bool FanOutWriter::writeGeometry( const COLLADAFW::Geometry* geometry )
+	{
+		return mSharedData->write<COLLADAFW::Geometry, &COLLADAFW::IWriter::writeGeometry>( BinaryCacheFormat::RECORD_GEOMETRY, geometry, false );
+	}
+
+	//------------------------------
+	bool FanOutWriter::writeMaterial( const COLLADAFW::Material* material )
+	{
+		return mSharedData->write<COLLADAFW::Material, &COLLADAFW::IWriter::writeMaterial>( BinaryCacheFormat::RECORD_MATERIAL, material, true );
+	}
+
+	//------------------------------
+	bool FanOutWriter::writeEffect( const COLLADAFW::Effect* effect )
+	{
+		return mSharedData->write<COLLADAFW::Effect, &COLLADAFW::IWriter::writeEffect>( BinaryCacheFormat::RECORD_EFFECT, effect, false );
+	}
+
+	//------------------------------
+	bool FanOutWriter::writeCamera( const COLLADAFW::Camera* camera )
+	{
+		return mSharedData->write<COLLADAFW::Camera, &COLLADAFW::IWriter::writeCamera>( BinaryCacheFormat::RECORD_CAMERA, camera, false );
+	}
+
+	//------------------------------
+	bool FanOutWriter::writeImage( const COLLADAFW::Image* image )
+	{
+		return mSharedData->write<COLLADAFW::Image, &COLLADAFW::IWriter::writeImage>( BinaryCacheFormat::RECORD_IMAGE, image, true );
+	}
+
+	//------------------------------
+	bool FanOutWriter::writeLight( const COLLADAFW::Light* light )
+	{
+		return mSharedData->write<COLLADAFW::Light, &COLLADAFW::IWriter::writeLight>( BinaryCacheFormat::RECORD_LIGHT, light, false );
+	}
+
+	//------------------------------
+	bool FanOutWriter::writeAnimation( const COLLADAFW::Animation* animation )
+	{
+		return mSharedData->write<COLLADAFW::Animation, &COLLADAFW::IWriter::writeAnimation>( BinaryCacheFormat::RECORD_ANIMATION, animation, false );
+	}
+
+	//------------------------------
+	bool FanOutWriter::writeAnimationList( const COLLADAFW::AnimationList* animationList )
+	{
+		return mSharedData->write<COLLADAFW::AnimationList, &COLLADAFW::IWriter::writeAnimationList>( BinaryCacheFormat::RECORD_ANIMATION_LIST, animationList, false );
+	}
+
+	//------------------------------
+	bool FanOutWriter::writeAnimationClip( const COLLADAFW::AnimationClip* animationClip )
+	{
+		return mSharedData->write<COLLADAFW::AnimationClip, &COLLADAFW::IWriter::writeAnimationClip>( BinaryCacheFormat::RECORD_ANIMATION_CLIP, animationClip, false );
+	}
+
+	//------------------------------
+	bool FanOutWriter::writeSkinControllerData( const COLLADAFW::SkinControllerData* skinControllerData )
+	{
+		return mSharedData->write<COLLADAFW::SkinControllerData, &COLLADAFW::IWriter::writeSkinControllerData>( BinaryCacheFormat::RECORD_SKIN_CONTROLLER_DATA, skinControllerData, false );
+	}
+
+	//------------------------------
+	bool FanOutWriter::writeController( const COLLADAFW::Controller* controller )
+	{
+		return mSharedData->write<COLLADAFW::Controller, &COLLADAFW::IWriter::writeController>( BinaryCacheFormat::RECORD_CONTROLLER, controller, false );
+	}
+
+	//------------------------------
+	bool FanOutWriter::writeFormulas( const COLLADAFW::Formulas* formulas )
+	{
+		return mSharedData->write<COLLADAFW::Formulas, &COLLADAFW::IWriter::writeFormulas>( BinaryCacheFormat::RECORD_FORMULAS, formulas, false );
+	}
+
+	//------------------------------
+	bool FanOutWriter::writeKinematicsScene( const COLLADAFW::KinematicsScene* kinematicsScene )
+	{
+		return mSharedData->write<COLLADAFW::KinematicsScene, &COLLADAFW::IWriter::writeKinematicsScene>( BinaryCacheFormat::RECORD_KINEMATICS_SCENE, kinematicsScene, false );
+	}
+
+} // namespace COLLADASaxFWL
@@ -12,6 +12,7 @@
 #include "COLLADASaxFWLFileLoader.h"
 #include "COLLADASaxFWLLoader.h"
 #include "COLLADASaxFWLSaxParserErrorHandler.h"
+#include "COLLADASaxFWLSaxParserProgressHandler.h"
 #include "COLLADASaxFWLSidAddress.h"
 #include "COLLADASaxFWLVersionParser.h"
 #include "COLLADASaxFWLKinematicsSceneCreator.h"
@@ -74,11 +75,16 @@ namespace COLLADASaxFWL
 	bool FileLoader::load()
 	{
         VersionParser parser( mSaxParserErrorHandler, this, mObjectFlags, mParsedObjectFlags );
+		SaxParserProgressHandler progressHandler( mColladaLoader->getProgressHandler(), mColladaLoader->getFileId( mFileURI ) );
+		if ( mColladaLoader->getProgressHandler() )
+			parser.setProgressHandler( &progressHandler, mColladaLoader->getProgressInterval() );
 		mVersionParser = &parser;
         mParsingStatus = PARSING_PARSING;
         bool success = parser.createAndLaunchParser();
         mParsingStatus = PARSING_FINISHED;
 		mVersionParser = 0;
+		if ( parser.isCancelled() )
+			mColladaLoader->mLoadingCancelled = true;
         return success;
 	}
 
@@ -86,11 +92,16 @@ namespace COLLADASaxFWL
 	bool FileLoader::load( const char* buffer, int length )
 	{
         VersionParser parser( mSaxParserErrorHandler, this, mObjectFlags, mParsedObjectFlags );
+		SaxParserProgressHandler progressHandler( mColladaLoader->getProgressHandler(), mColladaLoader->getFileId( mFileURI ) );
+		if ( mColladaLoader->getProgressHandler() )
+			parser.setProgressHandler( &progressHandler, mColladaLoader->getProgressInterval() );
 		mVersionParser = &parser;
         mParsingStatus = PARSING_PARSING;
         bool success = parser.createAndLaunchParser( buffer, length );
         mParsingStatus = PARSING_FINISHED;
 		mVersionParser = 0;
+		if ( parser.isCancelled() )
+			mColladaLoader->mLoadingCancelled = true;
         return success;
 	}    
 
@@ -123,4 +134,22 @@ namespace COLLADASaxFWL
 		}
 		return 0;
 	}
+
+	//-----------------------------
+	void FileLoader::skipCurrentElement()
+	{
+		if ( mVersionParser )
+		{
+			mVersionParser->skipCurrentElement();
+		}
+	}
+
+	//-----------------------------
+	void FileLoader::redirectCurrentElementTextData( GeneratedSaxParser::ITextDataHandler* handler )
+	{
+		if ( mVersionParser )
+		{
+			mVersionParser->redirectCurrentElementTextData( handler );
+		}
+	}
 } // namespace COLLADASaxFWL
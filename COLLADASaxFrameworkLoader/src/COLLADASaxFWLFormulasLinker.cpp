@@ -61,6 +61,81 @@ namespace COLLADASaxFWL
 		return true;
 	}
 
+	//------------------------------
+	void FormulasLinker::collectParameterSidAddresses( SidAddressPointerList& sidAddresses ) const
+	{
+		for ( size_t i = 0, formulasCount = mFormulas.getCount(); i < formulasCount; ++i)
+		{
+			const COLLADAFW::MathmlAstArray& asts = mFormulas[i]->getMathmlAsts();
+			for ( size_t j = 0, astsCount = asts.getCount(); j < astsCount; ++j)
+			{
+				collectParameterSidAddresses( asts[j], sidAddresses );
+			}
+		}
+	}
+
+	//------------------------------
+	void FormulasLinker::collectParameterSidAddresses( const MathML::AST::INode* astNode, SidAddressPointerList& sidAddresses )
+	{
+		if ( !astNode )
+			return;
+
+		switch ( astNode->getNodeType() )
+		{
+		case MathML::AST::INode::ARITHMETIC:
+			{
+				const MathML::AST::NodeList& operands = ((const MathML::AST::ArithmeticExpression*)astNode)->getOperands();
+				for ( size_t i = 0, count = operands.size(); i < count; ++i )
+					collectParameterSidAddresses( operands[i], sidAddresses );
+			}
+			break;
+		case MathML::AST::INode::COMPARISON:
+			{
+				const MathML::AST::BinaryComparisonExpression* comparison = (const MathML::AST::BinaryComparisonExpression*)astNode;
+				collectParameterSidAddresses( comparison->getLeftOperand(), sidAddresses );
+				collectParameterSidAddresses( comparison->getRightOperand(), sidAddresses );
+			}
+			break;
+		case MathML::AST::INode::FRAGMENT:
+			collectParameterSidAddresses( ((const MathML::AST::FragmentExpression*)astNode)->getFragment(), sidAddresses );
+			break;
+		case MathML::AST::INode::LOGICAL:
+			{
+				const MathML::AST::NodeList& operands = ((const MathML::AST::LogicExpression*)astNode)->getOperands();
+				for ( size_t i = 0, count = operands.size(); i < count; ++i )
+					collectParameterSidAddresses( operands[i], sidAddresses );
+			}
+			break;
+		case MathML::AST::INode::UNARY:
+			collectParameterSidAddresses( ((const MathML::AST::UnaryExpression*)astNode)->getOperand(), sidAddresses );
+			break;
+		case MathML::AST::INode::FUNCTION:
+			{
+				const MathML::AST::NodeList& operands = ((const MathML::AST::FunctionExpression*)astNode)->getParameterList();
+				for ( size_t i = 0, count = operands.size(); i < count; ++i )
+					collectParameterSidAddresses( operands[i], sidAddresses );
+			}
+			break;
+		case MathML::AST::INode::USERDEFINED:
+			{
+				const COLLADACsymbol* csymbol = (const COLLADACsymbol*)astNode;
+				if ( csymbol->getCSymbolType() == COLLADACsymbol::PARAMETER )
+				{
+					sidAddresses.push_back( &csymbol->getSidAddress() );
+				}
+				else
+				{
+					const COLLADACsymbol::ParameterList& parameters = csymbol->getParameterList();
+					for ( size_t i = 0, count = parameters.size(); i < count; ++i )
+						collectParameterSidAddresses( parameters[i], sidAddresses );
+				}
+			}
+			break;
+		default:
+			break;
+		}
+	}
+
 	//------------------------------
 	MathML::AST::INode* FormulasLinker::link( COLLADAFW::Formula* formula, MathML::AST::INode* astNode, bool& success)
 	{
@@ -99,7 +99,20 @@ namespace COLLADASaxFWL
 		COLLADAFW::Mesh * mesh = mMeshLoader ? mMeshLoader->getMesh() : 0;
 		if ( ((getObjectFlags() & Loader::GEOMETRY_FLAG) != 0) && mesh )
 		{
-			success |= writer()->writeGeometry(mesh);
+			// duplicates are replaced by instances of the first mesh during post processing
+			bool duplicate = getColladaLoader()->getInstanceDuplicateGeometries() 
+				&& getColladaLoader()->getMeshDeduplicator().addMesh( *mesh );
+			if ( !duplicate )
+			{
+				success |= writer()->writeGeometry(mesh);
+				if ( retainForDocumentCache(mesh) )
+					mMeshLoader->releaseMesh();
+			}
+			else if ( getColladaLoader()->getMeshDeduplicator().findDuplicate( mesh->getUniqueId() )->transformed )
+			{
+				// moved copies are kept for the controllers using them
+				addTransformedDuplicateGeometry( *mesh );
+			}
 		}
 
         COLLADAFW::Spline * spline = mSplineLoader ? mSplineLoader->getSpline() : 0;
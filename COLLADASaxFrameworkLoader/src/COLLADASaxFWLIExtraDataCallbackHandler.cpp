@@ -11,6 +11,8 @@
 #include "COLLADASaxFWLStableHeaders.h"
 #include "COLLADASaxFWLIExtraDataCallbackHandler.h"
 
+#include "GeneratedSaxParserUtils.h"
+
 
 namespace COLLADASaxFWL
 {
@@ -25,4 +27,26 @@ namespace COLLADASaxFWL
     {
     }
 
+    //------------------------------
+    void IExtraDataCallbackHandler::addProfile( const String& profileName )
+    {
+        mProfileHashes.insert( GeneratedSaxParser::Utils::calculateStringHash( profileName.c_str() ) );
+    }
+
+    //------------------------------
+    void IExtraDataCallbackHandler::addParentElement( const String& elementName )
+    {
+        mParentElementHashes.insert( GeneratedSaxParser::Utils::calculateStringHash( elementName.c_str() ) );
+    }
+
+    //------------------------------
+    bool IExtraDataCallbackHandler::isTechniqueOffered( StringHash profileHash, StringHash parentElementHash ) const
+    {
+        if ( !mProfileHashes.empty() && (mProfileHashes.find( profileHash ) == mProfileHashes.end()) )
+            return false;
+        if ( !mParentElementHashes.empty() && (mParentElementHashes.find( parentElementHash ) == mParentElementHashes.end()) )
+            return false;
+        return true;
+    }
+
 } // namespace COLLADASaxFWL
@@ -12,6 +12,7 @@
 #include "COLLADASaxFWLIFilePartLoader.h"
 #include "COLLADASaxFWLLoader.h"
 #include "COLLADASaxFWLFileLoader.h"
+#include "COLLADASaxFWLDocumentRecorder.h"
 #include "COLLADASaxFWLIErrorHandler.h"
 #include "COLLADASaxFWLIParserImpl.h"
 #include "COLLADASaxFWLIParserImpl14.h"
@@ -188,6 +189,13 @@ namespace COLLADASaxFWL
 		return getColladaLoader()->getMeshMaterialIdInfo();
 	}
 
+	//------------------------------
+	void IFilePartLoader::addMeshOptimizationStatistics( const COLLADAFW::MeshOptimizer::VertexCacheStatistics& original, const COLLADAFW::MeshOptimizer::VertexCacheStatistics& optimized )
+	{
+		COLLADABU_ASSERT( getColladaLoader() );
+		getColladaLoader()->addMeshOptimizationStatistics( original, optimized );
+	}
+
 	//------------------------------
 	COLLADAFW::TextureMapId IFilePartLoader::getTextureMapIdBySematic( const String& semantic )
 	{
@@ -195,6 +203,22 @@ namespace COLLADASaxFWL
 		return getColladaLoader()->getTextureMapIdBySematic(semantic);
 	}
 
+	//------------------------------
+	bool IFilePartLoader::retainForDocumentCache( COLLADAFW::FileInfo* asset )
+	{
+		COLLADABU_ASSERT( getColladaLoader() );
+		DocumentRecorder* documentRecorder = getColladaLoader()->mDocumentRecorder;
+		return documentRecorder && documentRecorder->retain( asset );
+	}
+
+	//------------------------------
+	bool IFilePartLoader::retainForDocumentCache( COLLADAFW::Object* object )
+	{
+		COLLADABU_ASSERT( getColladaLoader() );
+		DocumentRecorder* documentRecorder = getColladaLoader()->mDocumentRecorder;
+		return documentRecorder && documentRecorder->retain( object );
+	}
+
 	//------------------------------
 	SidTreeNode* IFilePartLoader::addToSidTree( const char* colladaId, const char* colladaSid )
 	{
@@ -255,6 +279,18 @@ namespace COLLADASaxFWL
 		getFileLoader()->addSkinDataSkinSourcePair( skinDataUniqueId, skinSource );
 	}
 
+	//-----------------------------
+	void IFilePartLoader::addTransformedDuplicateGeometry( const COLLADAFW::Mesh& mesh )
+	{
+		getFileLoader()->addTransformedDuplicateGeometry( mesh );
+	}
+
+	//-----------------------------
+	void IFilePartLoader::addSkinDataOriginalSourcePair( const COLLADAFW::UniqueId& skinDataUniqueId, const COLLADAFW::UniqueId& originalUniqueId )
+	{
+		getFileLoader()->addSkinDataOriginalSourcePair( skinDataUniqueId, originalUniqueId );
+	}
+
 	//-----------------------------
 	void IFilePartLoader::addMorphController( COLLADAFW::MorphController* morphController )
 	{
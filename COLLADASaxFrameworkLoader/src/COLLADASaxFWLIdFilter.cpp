@@ -0,0 +1,97 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADASaxFWLStableHeaders.h"
+#include "COLLADASaxFWLIdFilter.h"
+
+
+namespace COLLADASaxFWL
+{
+
+	//------------------------------
+	IdFilter::IdFilter()
+	{
+	}
+
+	//------------------------------
+	IdFilter::~IdFilter()
+	{
+	}
+
+	//------------------------------
+	void IdFilter::addPattern( const String& pattern )
+	{
+		if ( pattern.find_first_of( "*?" ) == String::npos )
+			mIds.insert( pattern );
+		else
+			mWildcardPatterns.push_back( pattern );
+	}
+
+	//------------------------------
+	void IdFilter::clear()
+	{
+		mIds.clear();
+		mWildcardPatterns.clear();
+	}
+
+	//------------------------------
+	bool IdFilter::accepts( const char* id ) const
+	{
+		if ( isEmpty() )
+			return true;
+		if ( !id || !(*id) )
+			return false;
+
+		if ( !mIds.empty() && (mIds.find( id ) != mIds.end()) )
+			return true;
+
+		for ( size_t i = 0, count = mWildcardPatterns.size(); i < count; ++i )
+		{
+			if ( matches( mWildcardPatterns[i].c_str(), id ) )
+				return true;
+		}
+		return false;
+	}
+
+	//------------------------------
+	bool IdFilter::matches( const char* pattern, const char* string )
+	{
+		// position after the last '*' and the position in string it has been matched up to, used to
+		// backtrack if the remainder of the pattern does not match
+		const char* starPattern = 0;
+		const char* starString = 0;
+		while ( *string )
+		{
+			if ( *pattern == '*' )
+			{
+				starPattern = ++pattern;
+				starString = string;
+			}
+			else if ( (*pattern == '?') || (*pattern == *string) )
+			{
+				++pattern;
+				++string;
+			}
+			else if ( starPattern )
+			{
+				pattern = starPattern;
+				string = ++starString;
+			}
+			else
+			{
+				return false;
+			}
+		}
+		while ( *pattern == '*' )
+			++pattern;
+		return *pattern == 0;
+	}
+
+} // namespace COLLADASaxFWL
@@ -14,6 +14,8 @@
 #include "COLLADASaxFWLSidTreeNode.h"
 #include "COLLADASaxFWLInterpolationTypeSource.h"
 #include "COLLADASaxFWLLoader.h"
+#include "COLLADASaxFWLFileLoader.h"
+#include "COLLADASaxFWLRealTextSource.h"
 
 #include "COLLADAFWValidate.h"
 #include "COLLADAFWAnimationCurve.h"
@@ -285,6 +287,7 @@ namespace COLLADASaxFWL
 		, mCurrentAnimationCurveRequiresTangents(true)
 		, mVerboseValidate(true)
         , mProcessedCount(0)
+		, mAnimationDepth(0)
 	{}
 
     //------------------------------
@@ -339,6 +342,14 @@ namespace COLLADASaxFWL
 	//------------------------------
 	bool LibraryAnimationsLoader::begin__animation( const animation__AttributeData& attributeData )
 	{
+		// nested animations are loaded, if their top level animation is
+		if ( (mAnimationDepth == 0) && !getFileLoader()->getAnimationIdFilter().accepts( attributeData.id ) )
+		{
+			getFileLoader()->skipCurrentElement();
+			return true;
+		}
+		++mAnimationDepth;
+
         if ( attributeData.name ) 
             mName = (const char*)attributeData.name;
         else if ( attributeData.id) 
@@ -360,6 +371,7 @@ namespace COLLADASaxFWL
 	//------------------------------
 	bool LibraryAnimationsLoader::end__animation()
 	{
+		--mAnimationDepth;
         mOriginalId = COLLADABU::Utils::EMPTY_STRING;
 
 		return true;
@@ -389,6 +401,8 @@ namespace COLLADASaxFWL
 		bool success = true;
 		if ( !mCurrentAnimationCurveRequiresTangents )
 		{
+			mCurrentAnimationCurve->setLazyValues( COLLADAFW::AnimationCurve::IN_TANGENT_VALUES, 0 );
+			mCurrentAnimationCurve->setLazyValues( COLLADAFW::AnimationCurve::OUT_TANGENT_VALUES, 0 );
 			mCurrentAnimationCurve->getInTangentValues().clear();
 			mCurrentAnimationCurve->getOutTangentValues().clear();
 		}
@@ -510,7 +524,7 @@ namespace COLLADASaxFWL
 		{
 		case SEMANTIC_INPUT:
 			{
-				if ( sourceDataType != SourceBase::DATA_TYPE_REAL )
+				if ( !isRealDataType( sourceDataType ) )
 				{
 					// The source array has wrong type. Only reals are allowed for semantic INPUT
 					break;
@@ -527,12 +541,12 @@ namespace COLLADASaxFWL
 					mCurrentAnimationCurve->setInPhysicalDimension( COLLADAFW::PHYSICAL_DIMENSION_UNKNOWN );
 				}
 
-				setRealValues( mCurrentAnimationCurve->getInputValues(), (const RealSource*)sourceBase);
+				setAnimationCurveValues( COLLADAFW::AnimationCurve::INPUT_VALUES, sourceBase);
 			}
 			break;
 		case SEMANTIC_OUTPUT:
 			{
-				if ( sourceDataType != SourceBase::DATA_TYPE_REAL )
+				if ( !isRealDataType( sourceDataType ) )
 				{
 					// The source array has wrong type. Only reals are allowed for semantic OUTPUT
 					break;
@@ -616,10 +630,9 @@ namespace COLLADASaxFWL
 					}
 				}
 
-				const RealSource* realSource = (const RealSource*)sourceBase;
-				setRealValues( mCurrentAnimationCurve->getOutputValues(), realSource);
+				setAnimationCurveValues( COLLADAFW::AnimationCurve::OUTPUT_VALUES, sourceBase);
 
-				size_t stride = (size_t)realSource->getStride();
+				size_t stride = (size_t)sourceBase->getStride();
 				size_t physicalDimensionsCount = physicalDimensions.getCount();
 				// if stride is larger that physicalDimensionsCount, we need to append dimensions to physicalDimensions
 				for ( size_t i =  physicalDimensionsCount; i < stride; ++i)
@@ -631,7 +644,7 @@ namespace COLLADASaxFWL
 			break;
 		case SEMANTIC_OUT_TANGENT:
 			{
-				if ( sourceDataType != SourceBase::DATA_TYPE_REAL )
+				if ( !isRealDataType( sourceDataType ) )
 				{
 					// The source array has wrong type. Only reals are allowed for semantic OUTPUT
 					break;
@@ -642,12 +655,12 @@ namespace COLLADASaxFWL
 					// This animation does not require tangents
 					break;
 				}
-				setRealValues( mCurrentAnimationCurve->getOutTangentValues(), (const RealSource*)sourceBase);
+				setAnimationCurveValues( COLLADAFW::AnimationCurve::OUT_TANGENT_VALUES, sourceBase);
 			}
 			break;
 		case SEMANTIC_IN_TANGENT:
 			{
-				if ( sourceDataType != SourceBase::DATA_TYPE_REAL )
+				if ( !isRealDataType( sourceDataType ) )
 				{
 					// The source array has wrong type. Only reals are allowed for semantic OUTPUT
 					break;
@@ -657,7 +670,7 @@ namespace COLLADASaxFWL
 					// This animation does not require tangents
 					break;
 				}
-				setRealValues( mCurrentAnimationCurve->getInTangentValues(), (const RealSource*)sourceBase);
+				setAnimationCurveValues( COLLADAFW::AnimationCurve::IN_TANGENT_VALUES, sourceBase);
 			}
 			break;
 		case SEMANTIC_INTERPOLATION:
@@ -738,4 +751,59 @@ namespace COLLADASaxFWL
 		return true;
 	}
 
+	//------------------------------
+	bool LibraryAnimationsLoader::begin__float_array( const float_array__AttributeData& attributeData )
+	{
+		if ( !getColladaLoader()->getLazyAnimationCurveDecoding() )
+			return SourceArrayLoader::begin__float_array( attributeData );
+
+		RealTextSource* source = beginArray<RealTextSource>( attributeData.count, attributeData.id );
+		if ( !source )
+			return false;
+		getFileLoader()->redirectCurrentElementTextData( source );
+		return true;
+	}
+
+	//------------------------------
+	void LibraryAnimationsLoader::setAnimationCurveValues( COLLADAFW::AnimationCurve::ValuesArray valuesArray, const SourceBase* realSource )
+	{
+		if ( !getColladaLoader()->getLazyAnimationCurveDecoding() )
+		{
+			switch ( valuesArray )
+			{
+			case COLLADAFW::AnimationCurve::INPUT_VALUES:
+				setRealValues( mCurrentAnimationCurve->getInputValues(), realSource );
+				break;
+			case COLLADAFW::AnimationCurve::OUTPUT_VALUES:
+				setRealValues( mCurrentAnimationCurve->getOutputValues(), realSource );
+				break;
+			case COLLADAFW::AnimationCurve::IN_TANGENT_VALUES:
+				setRealValues( mCurrentAnimationCurve->getInTangentValues(), realSource );
+				break;
+			case COLLADAFW::AnimationCurve::OUT_TANGENT_VALUES:
+				setRealValues( mCurrentAnimationCurve->getOutTangentValues(), realSource );
+				break;
+			default:
+				break;
+			}
+			return;
+		}
+
+		if ( mCurrentAnimationCurve->getValuesCount( valuesArray ) != 0 )
+		{
+			// There already must have been an input with the same semantic. We ignore all following.
+			return;
+		}
+		// all real sources of this loader are text sources, if the curves are decoded lazily
+		const RealTextSource* realTextSource = (const RealTextSource*)realSource;
+		bool doublePrecision = (getRealPrecision() == Loader::DOUBLE_PRECISION);
+		mCurrentAnimationCurve->setLazyValues( valuesArray, realTextSource->createLazyValues( doublePrecision ) );
+	}
+
+	//------------------------------
+	Loader::RealPrecision LibraryAnimationsLoader::getRealPrecision() const
+	{
+		return getColladaLoader()->getRealPrecision( Loader::ANIMATION_DATA );
+	}
+
 } // namespace COLLADASaxFWL
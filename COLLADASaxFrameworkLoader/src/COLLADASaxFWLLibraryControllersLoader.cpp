@@ -32,6 +32,28 @@ namespace COLLADASaxFWL
 		SEMANTIC_MORPH_WEIGHT
 	};
 
+	//------------------------------
+	/** Fills @a inverseBindMatrices with the matrices stored in @a values, 16 values per matrix.*/
+	template<class ValueType>
+	static void setInverseBindMatrices( COLLADAFW::Matrix4Array& inverseBindMatrices, const COLLADAFW::ArrayPrimitiveType<ValueType>& values )
+	{
+		size_t matrixCount = values.getCount() / 16;
+		inverseBindMatrices.allocMemory( matrixCount );
+		inverseBindMatrices.setCount( matrixCount );
+
+		size_t index = 0;
+		for ( size_t i = 0; i < matrixCount; ++i)
+		{
+			// fill the matrix
+			COLLADABU::Math::Matrix4 matrix;
+			for ( size_t j = 0; j < 16; ++j,++index)
+			{
+				matrix.setElement( j, values[index]);
+			}
+			inverseBindMatrices[i] = matrix;
+		}
+	}
+
     //------------------------------
     const COLLADAFW::UniqueId& LibraryControllersLoader::getUniqueId ()
     {
@@ -104,40 +126,88 @@ namespace COLLADASaxFWL
 		if ( !mCurrentSkinControllerData )
 			return true;
 
-		// Write the index values in the index lists.
-		for ( size_t i=0; i<length; ++i )
-		{
-			// Get the current index value.
-			unsigned int index = (unsigned int)data [i];
-
-			// Write the indices
-			if (  mCurrentOffset == mJointOffset )
-			{
-				COLLADAFW::IntValuesArray& jointIndices = mCurrentSkinControllerData->getJointIndices();
-				jointIndices.append ( index );
-			}
+		COLLADAFW::IntValuesArray& jointIndices = mCurrentSkinControllerData->getJointIndices();
+		COLLADAFW::UIntValuesArray& weightIndices = mCurrentSkinControllerData->getWeightIndices();
 
-			if ( mCurrentOffset == mWeightsOffset )
-			{
-				COLLADAFW::UIntValuesArray& weightIndices = mCurrentSkinControllerData->getWeightIndices();
-				weightIndices.append ( index );
-			}
+		// Complete the joint/weight tuple that has been started by the previous data chunk.
+		size_t i = 0;
+		for ( ; (i < length) && (mCurrentOffset != 0); ++i )
+		{
+			writeVIndex( (unsigned int)data[i], jointIndices, weightIndices );
+		}
 
-			// Reset the offset if we went through all offset values
-			if ( mCurrentOffset == mCurrentMaxOffset )
+		// De-interleave all complete tuples at once, directly into the presized index arrays.
+		size_t stride = (size_t)mCurrentMaxOffset + 1;
+		size_t tupleCount = (length - i) / stride;
+		if ( tupleCount > 0 )
+		{
+			size_t jointIndicesCount = jointIndices.getCount();
+			size_t weightIndicesCount = weightIndices.getCount();
+			jointIndices.reallocMemory( jointIndicesCount + tupleCount );
+			weightIndices.reallocMemory( weightIndicesCount + tupleCount );
+
+			int* joints = jointIndices.getData() + jointIndicesCount;
+			unsigned int* weights = weightIndices.getData() + weightIndicesCount;
+			const sint64* tuples = data + i;
+			if ( (stride == 2) && (mJointOffset == 0) && (mWeightsOffset == 1) )
 			{
-				// Reset the current offset value
-				mCurrentOffset = 0;
+				// the usual layout, kept separate to let the compiler vectorize it
+				for ( size_t t = 0; t < tupleCount; ++t )
+				{
+					joints[t] = (int)(unsigned int)tuples[2 * t];
+					weights[t] = (unsigned int)tuples[2 * t + 1];
+				}
 			}
 			else
 			{
-				// Increment the current offset value
-				++mCurrentOffset;
+				size_t jointOffset = (size_t)mJointOffset;
+				size_t weightsOffset = (size_t)mWeightsOffset;
+				for ( size_t t = 0; t < tupleCount; ++t, tuples += stride )
+				{
+					joints[t] = (int)(unsigned int)tuples[jointOffset];
+					weights[t] = (unsigned int)tuples[weightsOffset];
+				}
 			}
+			jointIndices.setCount( jointIndicesCount + tupleCount );
+			weightIndices.setCount( weightIndicesCount + tupleCount );
+			i += tupleCount * stride;
+		}
+
+		// Start the tuple that is completed by the next data chunk.
+		for ( ; i < length; ++i )
+		{
+			writeVIndex( (unsigned int)data[i], jointIndices, weightIndices );
 		}
 		return true;
 	}
 
+	//------------------------------
+	void LibraryControllersLoader::writeVIndex( unsigned int index, COLLADAFW::IntValuesArray& jointIndices, COLLADAFW::UIntValuesArray& weightIndices )
+	{
+		// Write the indices
+		if (  mCurrentOffset == mJointOffset )
+		{
+			jointIndices.append ( index );
+		}
+
+		if ( mCurrentOffset == mWeightsOffset )
+		{
+			weightIndices.append ( index );
+		}
+
+		// Reset the offset if we went through all offset values
+		if ( mCurrentOffset == mCurrentMaxOffset )
+		{
+			// Reset the current offset value
+			mCurrentOffset = 0;
+		}
+		else
+		{
+			// Increment the current offset value
+			++mCurrentOffset;
+		}
+	}
+
 	//------------------------------
 	bool LibraryControllersLoader::beginJointsArray( bool isIdArray )
 	{
@@ -227,6 +297,17 @@ namespace COLLADASaxFWL
 	bool LibraryControllersLoader::end__skin()
 	{
 		bool success = true;
+
+		// a moved copy as source is replaced by the mesh it is a copy of, with its transformation included 
+		// in the bind shape matrix. Copies parsed after the skin are written for the skin controller instead
+		const COLLADAFW::MeshDeduplicator::Duplicate* duplicate = getColladaLoader()->getInstanceDuplicateGeometries() ?
+			getColladaLoader()->getMeshDeduplicator().findDuplicate( mCurrentControllerSourceUniqueId ) : 0;
+		if ( duplicate && duplicate->transformed )
+		{
+			mCurrentSkinControllerData->setBindShapeMatrix( mCurrentSkinControllerData->getBindShapeMatrix() * duplicate->transformation );
+			addSkinDataOriginalSourcePair( mCurrentSkinControllerData->getUniqueId(), duplicate->originalId );
+		}
+
 		if ( validate( mCurrentSkinControllerData, mVerboseValidate ) == 0 )
 		{
 			success = writer()->writeSkinControllerData( mCurrentSkinControllerData );
@@ -393,7 +474,7 @@ namespace COLLADASaxFWL
 						String sourceId = getIdFromURIFragmentType(attributeData.source);
 						SourceBase* sourceBase = getSourceById ( sourceId );
 
-						if ( !sourceBase || (sourceBase->getDataType() != SourceBase::DATA_TYPE_REAL) )
+						if ( !sourceBase || !isRealDataType( sourceBase->getDataType() ) )
 						{
                             handleFWLError ( SaxFWLError::ERROR_DATA_NOT_VALID, "SourceBase of skin controller with semantic SEMANTIC_INV_BIND_MATRIX not valid!" );
 							break;
@@ -405,30 +486,16 @@ namespace COLLADASaxFWL
 							break;
 						}
 
-						const RealSource *inverseBindMatricesSource = (const RealSource *)sourceBase;
-						const RealArrayElement& inverseBindMatricesElement = inverseBindMatricesSource->getArrayElement();
-
-						const RealArray& inverseBindMatricesArray = inverseBindMatricesElement.getValues();
-
-						size_t matrixElementsCount = inverseBindMatricesArray.getCount();
-
-						size_t matrixCount = matrixElementsCount / 16;
-
-
 						COLLADAFW::Matrix4Array& inverseBindMatrices = mCurrentSkinControllerData->getInverseBindMatrices();
-						inverseBindMatrices.allocMemory( matrixCount );
-						inverseBindMatrices.setCount( matrixCount );
-
-						size_t index = 0;
-						for ( size_t i = 0; i < matrixCount; ++i)
+						if ( sourceBase->getDataType() == SourceBase::DATA_TYPE_DOUBLE )
 						{
-							// fill the matrix
-							COLLADABU::Math::Matrix4 matrix;
-							for ( size_t j = 0; j < 16; ++j,++index)
-							{
-								matrix.setElement( j, inverseBindMatricesArray[index]);
-							}
-							inverseBindMatrices[i] = matrix;
+							const DoubleSource *inverseBindMatricesSource = (const DoubleSource *)sourceBase;
+							setInverseBindMatrices( inverseBindMatrices, inverseBindMatricesSource->getArrayElement().getValues() );
+						}
+						else
+						{
+							const FloatSource *inverseBindMatricesSource = (const FloatSource *)sourceBase;
+							setInverseBindMatrices( inverseBindMatrices, inverseBindMatricesSource->getArrayElement().getValues() );
 						}
 					}
 					break;
@@ -486,7 +553,7 @@ namespace COLLADASaxFWL
 						String sourceId = getIdFromURIFragmentType(attributeData.source);
 						SourceBase* sourceBase = getSourceById( sourceId );
 
-						if ( !sourceBase || (sourceBase->getDataType() != SourceBase::DATA_TYPE_REAL) )
+						if ( !sourceBase || !isRealDataType( sourceBase->getDataType() ) )
 						{
                             handleFWLError ( SaxFWLError::ERROR_DATA_NOT_VALID, "SourceBase of skin controller with semantic SEMANTIC_MORPH_WEIGHT not valid!" );
 							break;
@@ -504,12 +571,11 @@ namespace COLLADASaxFWL
                             handleFWLError ( SaxFWLError::ERROR_DATA_NOT_VALID, "Stride of sourceBase of skin controller with semantic SEMANTIC_MORPH_WEIGHT not valid!" );
 							break;
 						}
-						const RealSource *weightSource = (const RealSource *)sourceBase;
 						COLLADAFW::FloatOrDoubleArray& morphWeights = mCurrentMorphController->getMorphWeights();
 						addToSidTree( sourceId.c_str(), 0, &morphWeights );
 						moveUpInSidTree();
 
-						setRealValues( morphWeights, weightSource );
+						setRealValues( morphWeights, sourceBase );
 					}
 					break;
                     //Prevent warnings for semantics used by SKIN_CONTROLLER
@@ -530,6 +596,12 @@ namespace COLLADASaxFWL
 	bool LibraryControllersLoader::begin__vertex_weights( const vertex_weights__AttributeData& attributeData )
 	{
 		mCurrentInputParent = INPUT_PARENT_VERTEX_WEIGHTS;
+		mCurrentJointsVertexPairCount = 0;
+		if ( mCurrentSkinControllerData && ((attributeData.present_attributes & vertex_weights__AttributeData::ATTRIBUTE_COUNT_PRESENT) != 0) )
+		{
+			// the count is the number of vertices, i.e. the length of the vcount element
+			mCurrentSkinControllerData->getJointsPerVertex().reallocMemory( (size_t)attributeData.count );
+		}
 		return true;
 	}
 
@@ -573,7 +645,7 @@ namespace COLLADASaxFWL
 			{
 				mWeightsOffset = attributeData.offset;
 
-				if ( !mCurrentSkinControllerData ||  !sourceBase || (sourceBase->getDataType() != SourceBase::DATA_TYPE_REAL) )
+				if ( !mCurrentSkinControllerData ||  !sourceBase || !isRealDataType( sourceBase->getDataType() ) )
 					break;
 
 				COLLADAFW::FloatOrDoubleArray& weights = mCurrentSkinControllerData->getWeights();
@@ -616,18 +688,28 @@ namespace COLLADASaxFWL
 		COLLADAFW::UIntValuesArray& jointsPerVertex = mCurrentSkinControllerData->getJointsPerVertex();
 		size_t count = jointsPerVertex.getCount();
 		jointsPerVertex.reallocMemory( count + length);
+		unsigned int* jointsCounts = jointsPerVertex.getData() + count;
+		size_t jointsVertexPairCount = 0;
 		for ( size_t i = 0; i < length; ++i)
 		{
-			unsigned long long vcount = data[i];
-			jointsPerVertex.append((unsigned int)vcount);
-			mCurrentJointsVertexPairCount += (size_t)vcount;
+			unsigned int vcount = (unsigned int)data[i];
+			jointsCounts[i] = vcount;
+			jointsVertexPairCount += vcount;
 		}
+		jointsPerVertex.setCount( count + length );
+		mCurrentJointsVertexPairCount += jointsVertexPairCount;
 		return true;
 	}
 
 	//------------------------------
 	bool LibraryControllersLoader::begin__v()
 	{
+		if ( mCurrentSkinControllerData )
+		{
+			// vcount precedes v, so we know the number of joint/vertex pairs
+			mCurrentSkinControllerData->getJointIndices().reallocMemory( mCurrentJointsVertexPairCount );
+			mCurrentSkinControllerData->getWeightIndices().reallocMemory( mCurrentJointsVertexPairCount );
+		}
 		return true;
 	}
 
@@ -705,4 +787,10 @@ namespace COLLADASaxFWL
 		return true;
 	}
 
+	//------------------------------
+	Loader::RealPrecision LibraryControllersLoader::getRealPrecision() const
+	{
+		return getColladaLoader()->getRealPrecision( Loader::CONTROLLER_DATA );
+	}
+
 } // namespace COLLADASaxFWL
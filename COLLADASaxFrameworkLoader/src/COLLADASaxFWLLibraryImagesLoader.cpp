@@ -79,7 +79,8 @@ namespace COLLADASaxFWL
 		{
 		    success = writer()->writeImage(mCurrentImage);
 		}
-		FW_DELETE mCurrentImage;
+		if ( !retainForDocumentCache( mCurrentImage ) )
+			FW_DELETE mCurrentImage;
 		mCurrentImage = 0;
 		return success;
 	}
@@ -70,12 +70,12 @@ namespace COLLADASaxFWL
 	//------------------------------
 	bool LibraryLightsLoader::end__light()
 	{
-		moveUpInSidTree();
 		if ( (getObjectFlags() & Loader::LIGHT_FLAG) != 0 )
 		{
 			getFileLoader()->addLight( mCurrentLight );
 		}
 		mCurrentLight = 0;
+		moveUpInSidTree();
 		return true;
 	}
 
@@ -59,7 +59,8 @@ namespace COLLADASaxFWL
 			success = writer()->writeMaterial(mCurrentMaterial);
 		}
 
-		FW_DELETE mCurrentMaterial;
+		if ( !retainForDocumentCache( mCurrentMaterial ) )
+			FW_DELETE mCurrentMaterial;
 		mCurrentMaterial = 0;
 		return success;
 	}
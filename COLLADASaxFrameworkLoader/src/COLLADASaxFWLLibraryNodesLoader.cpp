@@ -61,8 +61,8 @@ namespace COLLADASaxFWL
 	//------------------------------
 	bool LibraryNodesLoader::end__library_nodes()
 	{
-		moveUpInSidTree();
 		getFileLoader()->addLibraryNodes(mLibraryNodes);
+		moveUpInSidTree();
 		finish();
 		return true;
 	}
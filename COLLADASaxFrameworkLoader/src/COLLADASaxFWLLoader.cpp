@@ -14,6 +14,13 @@ http://www.opensource.org/licenses/mit-license.php
 #include "COLLADASaxFWLPostProcessor.h"
 #include "COLLADASaxFWLSaxParserErrorHandler.h"
 #include "COLLADASaxFWLUtils.h"
+#include "COLLADASaxFWLAnimationSidAddressBindingSpillFile.h"
+#include "COLLADASaxFWLObjectSpillFile.h"
+#include "COLLADASaxFWLDocumentPrefetcher.h"
+#include "COLLADASaxFWLDocumentCache.h"
+#include "COLLADASaxFWLDocumentRecorder.h"
+#include "COLLADASaxFWLCachedDocument.h"
+#include "COLLADASaxFWLIErrorHandler.h"
 
 #include "COLLADABUURI.h"
 
@@ -26,13 +33,71 @@ http://www.opensource.org/licenses/mit-license.php
 #include "COLLADAFWAnimationList.h"
 #include "COLLADAFWConstants.h"
 
+#include "COLLADABUParallel.h"
+
 #include <sys/types.h>
 #include <sys/timeb.h>
+#include <algorithm>
 #include <fstream>
+#include <map>
+#include <sstream>
+#include <vector>
 
 namespace COLLADASaxFWL
 {
 
+	namespace
+	{
+		/** The number of external documents read ahead per prefetching thread.*/
+		const size_t PREFETCHED_DOCUMENTS_PER_THREAD = 2;
+
+		/** The maximum number of bytes of the external documents read ahead, if no memory budget is set.*/
+		const size_t MAX_PREFETCHED_BYTES = 64 * 1024 * 1024;
+
+		/** Error handler of the loaders parsing external documents on worker threads. Only notes that an
+		error occurred, the document is parsed again by the loading thread to report it.*/
+		class ErrorFlagHandler : public IErrorHandler
+		{
+		private:
+			bool mErrorOccurred;
+
+		public:
+			ErrorFlagHandler() : mErrorOccurred(false) {}
+
+			/** Returns true, if an error has been handled.*/
+			bool errorOccurred() const { return mErrorOccurred; }
+
+			virtual bool handleError( const IError* ) { mErrorOccurred = true; return true; }
+		};
+
+		/** Writer of the loaders parsing external documents on worker threads. The objects are only 
+		recorded, by the DocumentRecorder wrapping this writer.*/
+		class DiscardingWriter : public COLLADAFW::IWriter
+		{
+		public:
+			virtual void cancel( const String& ) {}
+			virtual void start() {}
+			virtual void finish() {}
+			virtual bool writeGlobalAsset( const COLLADAFW::FileInfo* ) { return true; }
+			virtual bool writeScene( const COLLADAFW::Scene* ) { return true; }
+			virtual bool writeVisualScene( const COLLADAFW::VisualScene* ) { return true; }
+			virtual bool writeLibraryNodes( const COLLADAFW::LibraryNodes* ) { return true; }
+			virtual bool writeGeometry( const COLLADAFW::Geometry* ) { return true; }
+			virtual bool writeMaterial( const COLLADAFW::Material* ) { return true; }
+			virtual bool writeEffect( const COLLADAFW::Effect* ) { return true; }
+			virtual bool writeCamera( const COLLADAFW::Camera* ) { return true; }
+			virtual bool writeImage( const COLLADAFW::Image* ) { return true; }
+			virtual bool writeLight( const COLLADAFW::Light* ) { return true; }
+			virtual bool writeAnimation( const COLLADAFW::Animation* ) { return true; }
+			virtual bool writeAnimationList( const COLLADAFW::AnimationList* ) { return true; }
+			virtual bool writeAnimationClip( const COLLADAFW::AnimationClip* ) { return true; }
+			virtual bool writeSkinControllerData( const COLLADAFW::SkinControllerData* ) { return true; }
+			virtual bool writeController( const COLLADAFW::Controller* ) { return true; }
+			virtual bool writeFormulas( const COLLADAFW::Formulas* ) { return true; }
+			virtual bool writeKinematicsScene( const COLLADAFW::KinematicsScene* ) { return true; }
+		};
+	}
+
 	const Loader::InstanceControllerDataList Loader::EMPTY_INSTANCE_CONTROLLER_DATALIST = Loader::InstanceControllerDataList();
 
 	const Loader::JointSidsOrIds Loader::EMPTY_JOINTSIDSORIDS;
@@ -49,8 +114,29 @@ namespace COLLADASaxFWL
 		, mSidTreeRoot( new SidTreeNode("", 0) )
 		, mSkinControllerSet( compare )
 		, mExternalReferenceDeciderCallbackFunction()
+		, mThreadCount(0)
+		, mMemoryBudget(0)
+		, mAnimationSidAddressBindingSpillFile(0)
+		, mProgressHandler(0)
+		, mProgressInterval(DEFAULT_PROGRESS_INTERVAL)
+		, mLoadingCancelled(false)
+		, mLazyAnimationCurveDecoding(false)
+		, mTriangulateMeshes(false)
+		, mOptimizeMeshes(false)
+		, mInstanceDuplicateGeometries(false)
+		, mDocumentCache(0)
+		, mDocumentRecorder(0)
 
 	{
+		for ( size_t i = 0; i < REAL_DATA_KIND_COUNT; ++i )
+		{
+			mRealPrecisions[i] = SINGLE_PRECISION;
+		}
+
+		for ( size_t i = 0; i < MemoryUsage::CATEGORY_COUNT; ++i )
+		{
+			mObjectSpillFiles[i] = 0;
+		}
 	}
 
 
@@ -59,6 +145,13 @@ namespace COLLADASaxFWL
 	{
 		delete mSidTreeRoot;
 
+		delete mAnimationSidAddressBindingSpillFile;
+
+		for ( size_t i = 0; i < MemoryUsage::CATEGORY_COUNT; ++i )
+		{
+			delete mObjectSpillFiles[i];
+		}
+
 		// delete visual scenes
 		deleteVectorFW(mVisualScenes);
 
@@ -157,16 +250,22 @@ namespace COLLADASaxFWL
 
 		URIFileIdMap::iterator it = mURIFileIdMap.find( *usedUri );
 
+		COLLADAFW::FileId fileId;
 		if ( it == mURIFileIdMap.end() )
 		{
-			COLLADAFW::FileId fileId = mNextFileId++;
+			fileId = mNextFileId++;
 			addFileIdUriPair( fileId, *usedUri );
-			return fileId;
 		}
 		else
 		{
-			return it->second;
+			fileId = it->second;
 		}
+
+		// the objects of a document referencing other documents can not be replayed to other loads
+		if ( mDocumentRecorder && (fileId != mCurrentFileId) )
+			mDocumentRecorder->invalidateDocument( mCurrentFileId );
+
+		return fileId;
 	}
 
 	//---------------------------------
@@ -197,6 +296,30 @@ namespace COLLADASaxFWL
 		if ( !writer )
 			return false;
 		mWriter = writer;
+		mMemoryUsage.resetPeaks();
+		mLoadingCancelled = false;
+		mMeshOptimizationStatistics = MeshOptimizationStatistics();
+		mMeshDeduplicator.clear();
+		mTransformedDuplicateGeometries.clear();
+		mSkinDataOriginalSourceMap.clear();
+
+		// External documents are replayed from the document cache, if possible. Otherwise the objects
+		// created from them are recorded and added to the cache after the load. The writer of the load
+		// gets the objects through the recorder.
+		bool useDocumentCache = mDocumentCache
+			&& mExtraDataCallbackHandlerList.empty()
+			&& mGeometryIdFilter.isEmpty() 
+			&& mAnimationIdFilter.isEmpty() 
+			&& mNodeIdFilter.isEmpty()
+			&& !mInstanceDuplicateGeometries;
+		String documentCacheLoadOptions;
+		std::map<COLLADAFW::FileId, String> documentCacheKeys;
+		if ( useDocumentCache )
+		{
+			documentCacheLoadOptions = getDocumentCacheLoadOptions();
+			mDocumentRecorder = new DocumentRecorder( writer );
+			mWriter = mDocumentRecorder;
+		}
 
 		mWriter->start();
 
@@ -209,27 +332,122 @@ namespace COLLADASaxFWL
 
 		bool abortLoading = false;
 
+		// External documents are read and parsed on worker threads, each with its own loader, while the 
+		// documents discovered before them are parsed. The objects of a document parsed ahead are replayed 
+		// on this thread, in the order of the file ids, since the replay creates the unique ids and calls the
+		// writer. Documents that can not be replayed are parsed on this thread. If a decider is registered, it
+		// is called on this thread in the order of the file ids, before the file is read.
+		size_t prefetchThreadCount = 0;
+		if ( mThreadCount != 1 )
+		{
+			size_t threadCount = mThreadCount == 0 ? COLLADABU::getHardwareThreadCount() : mThreadCount;
+			prefetchThreadCount = threadCount > 2 ? threadCount - 1 : 1;
+		}
+		bool parseAhead = mExtraDataCallbackHandlerList.empty()
+			&& mGeometryIdFilter.isEmpty() 
+			&& mAnimationIdFilter.isEmpty() 
+			&& mNodeIdFilter.isEmpty()
+			&& !mInstanceDuplicateGeometries
+			&& !mProgressHandler;
+		COLLADAFW::FileId maxPrefetchedCount = (COLLADAFW::FileId)(prefetchThreadCount * PREFETCHED_DOCUMENTS_PER_THREAD);
+		size_t maxPrefetchedBytes = (mMemoryBudget != 0) ? std::min( mMemoryBudget, MAX_PREFETCHED_BYTES ) : MAX_PREFETCHED_BYTES;
+		DocumentPrefetcher* prefetcher = 0;
+		std::map<COLLADAFW::FileId, bool> loadFileDecisions;
+		COLLADAFW::FileId nextUndecidedFileId = mCurrentFileId;
+		std::vector<char> documentContent;
+
 		while ( (mCurrentFileId < mNextFileId) && !abortLoading )
 		{
-			const COLLADABU::URI& fileUri = getFileUri( mCurrentFileId );
+			for ( ; (nextUndecidedFileId < mNextFileId) && (nextUndecidedFileId <= mCurrentFileId + maxPrefetchedCount); ++nextUndecidedFileId )
+			{
+				const COLLADABU::URI& fileUri = getFileUri( nextUndecidedFileId );
+				bool loadFile = (nextUndecidedFileId == 0) 
+					|| !mExternalReferenceDeciderCallbackFunction 
+					|| mExternalReferenceDeciderCallbackFunction(fileUri, nextUndecidedFileId);
+				loadFileDecisions[nextUndecidedFileId] = loadFile;
+
+				bool cached = false;
+				String documentCacheKey;
+				if ( loadFile 
+					&& useDocumentCache
+					&& (nextUndecidedFileId != 0)
+					&& DocumentCache::createKey( fileUri, documentCacheLoadOptions, documentCacheKey ) )
+				{
+					documentCacheKeys[nextUndecidedFileId] = documentCacheKey;
+					cached = mDocumentCache->contains( documentCacheKey );
+				}
+
+				if ( loadFile && !cached && (nextUndecidedFileId != mCurrentFileId) )
+				{
+					if ( !prefetcher )
+					{
+						prefetcher = new DocumentPrefetcher( prefetchThreadCount, maxPrefetchedBytes, 
+							parseAhead ? &Loader::parseExternalDocument : 0, this );
+					}
+					prefetcher->prefetch( nextUndecidedFileId, fileUri );
+				}
+			}
 
-			if ( (mCurrentFileId == 0) 
-				|| !mExternalReferenceDeciderCallbackFunction 
-				|| mExternalReferenceDeciderCallbackFunction(fileUri, mCurrentFileId) )
+			std::map<COLLADAFW::FileId, String>::const_iterator keyIt = documentCacheKeys.find( mCurrentFileId );
+			bool replayed = false;
+			if ( loadFileDecisions[mCurrentFileId] && (keyIt != documentCacheKeys.end()) )
+			{
+				bool success = false;
+				replayed = mDocumentCache->replay( keyIt->second, *this, success );
+				abortLoading = replayed && !success;
+			}
+
+			CachedDocument* parsedDocument = 0;
+			bool prefetched = loadFileDecisions[mCurrentFileId] && !replayed 
+				&& prefetcher && prefetcher->takeDocument( mCurrentFileId, documentContent, parsedDocument );
+			if ( parsedDocument )
+			{
+				abortLoading = !parsedDocument->replay( *this );
+				addMeshOptimizationStatistics( parsedDocument->getOriginalStatistics(), parsedDocument->getOptimizedStatistics() );
+				if ( keyIt != documentCacheKeys.end() )
+					mDocumentCache->insert( keyIt->second, parsedDocument );
+				else
+					delete parsedDocument;
+			}
+			else if ( loadFileDecisions[mCurrentFileId] && !replayed )
 			{
+				if ( keyIt != documentCacheKeys.end() )
+					mDocumentRecorder->startDocument( mCurrentFileId, keyIt->second );
+
 				mFileLoader = new FileLoader(this, 
-					fileUri,
+					getFileUri( mCurrentFileId ),
 					&saxParserErrorHandler, 
 					mObjectFlags,
 					mParsedObjectFlags, 
 					mExtraDataCallbackHandlerList );
-				bool success = mFileLoader->load();
+				bool success = false;
+				if ( prefetched )
+					success = mFileLoader->load( documentContent.empty() ? "" : &documentContent[0], (int)documentContent.size() );
+				else
+					success = mFileLoader->load();
+				std::vector<char>().swap( documentContent );
 				delete mFileLoader;
 				abortLoading = !success;
+
+				if ( mDocumentRecorder )
+					mDocumentRecorder->endDocument();
+			}
+			loadFileDecisions.erase( mCurrentFileId );
+			documentCacheKeys.erase( mCurrentFileId );
+
+			// the animation lists created get the file id of the finished document
+			if ( !abortLoading && (mMemoryBudget != 0) && (mCurrentFileId + 1 < mNextFileId) )
+			{
+				PostProcessor postProcessor(this, 
+					&saxParserErrorHandler, 
+					mObjectFlags,
+					mParsedObjectFlags);
+				postProcessor.finishDocument();
 			}
 
 			mCurrentFileId++;
 		}
+		delete prefetcher;
 
 		if ( !abortLoading )
 		{
@@ -238,14 +456,25 @@ namespace COLLADASaxFWL
 				mObjectFlags,
 				mParsedObjectFlags);
 			postProcessor.postProcess();
+			if ( mMemoryBudget != 0 )
+				releaseSidTree();
 		}
 		else
 		{
-			mWriter->cancel("Generic error");
+			mWriter->cancel( mLoadingCancelled ? "Loading cancelled" : "Generic error" );
 		}
 
 		mWriter->finish();
 
+		if ( mDocumentRecorder )
+		{
+			if ( !abortLoading )
+				mDocumentRecorder->commit( *mDocumentCache, mURIUniqueIdMap );
+			delete mDocumentRecorder;
+			mDocumentRecorder = 0;
+			mWriter = writer;
+		}
+
 		mParsedObjectFlags |= mObjectFlags;
 
 		return !abortLoading;
@@ -257,6 +486,12 @@ namespace COLLADASaxFWL
 		if ( !writer )
 			return false;
 		mWriter = writer;
+		mMemoryUsage.resetPeaks();
+		mLoadingCancelled = false;
+		mMeshOptimizationStatistics = MeshOptimizationStatistics();
+		mMeshDeduplicator.clear();
+		mTransformedDuplicateGeometries.clear();
+		mSkinDataOriginalSourceMap.clear();
         
 		SaxParserErrorHandler saxParserErrorHandler(mErrorHandler);
         
@@ -285,6 +520,16 @@ namespace COLLADASaxFWL
 				abortLoading = !success;
 			}
             
+			// the animation lists created get the file id of the finished document
+			if ( !abortLoading && (mMemoryBudget != 0) && (mCurrentFileId + 1 < mNextFileId) )
+			{
+				PostProcessor postProcessor(this, 
+					&saxParserErrorHandler, 
+					mObjectFlags,
+					mParsedObjectFlags);
+				postProcessor.finishDocument();
+			}
+
 			mCurrentFileId++;
 		}
         
@@ -295,10 +540,12 @@ namespace COLLADASaxFWL
 				mObjectFlags,
 				mParsedObjectFlags);
 			postProcessor.postProcess();
+			if ( mMemoryBudget != 0 )
+				releaseSidTree();
 		}
 		else
 		{
-			mWriter->cancel("Generic error");
+			mWriter->cancel( mLoadingCancelled ? "Loading cancelled" : "Generic error" );
 		}
         
 		mWriter->finish();
@@ -308,6 +555,17 @@ namespace COLLADASaxFWL
 		return !abortLoading;
 	}
 
+	//---------------------------------
+	void Loader::releaseSidTree()
+	{
+		delete mSidTreeRoot;
+		mSidTreeRoot = new SidTreeNode("", 0);
+		mIdStringSidTreeNodeMap.clear();
+		mResolvedSidPathMap.clear();
+		mObjectSidTreeNodeMap.clear();
+		mMemoryUsage.release( MemoryUsage::SID_TREE );
+	}
+
     //---------------------------------
     bool Loader::registerExtraDataCallbackHandler ( IExtraDataCallbackHandler* extraDataCallbackHandler )
     {
@@ -323,6 +581,78 @@ namespace COLLADASaxFWL
 		return mGeometryMaterialIdInfo;
 	}
 
+	//---------------------------------
+	String Loader::getDocumentCacheLoadOptions() const
+	{
+		std::ostringstream loadOptions;
+		loadOptions << mObjectFlags << ' ' << mParsedObjectFlags << ' ' << mTriangulateMeshes << ' ' << mOptimizeMeshes;
+		for ( size_t i = 0; i < REAL_DATA_KIND_COUNT; ++i )
+			loadOptions << ' ' << mRealPrecisions[i];
+		return loadOptions.str();
+	}
+
+	//---------------------------------
+	CachedDocument* Loader::parseExternalDocument( const Loader& loader, const COLLADABU::URI& uri, const std::vector<char>& content )
+	{
+		ErrorFlagHandler errorHandler;
+		Loader documentLoader( &errorHandler );
+		documentLoader.mObjectFlags = loader.mObjectFlags;
+		documentLoader.mParsedObjectFlags = loader.mParsedObjectFlags;
+		documentLoader.mThreadCount = 1;
+		documentLoader.mTriangulateMeshes = loader.mTriangulateMeshes;
+		documentLoader.mOptimizeMeshes = loader.mOptimizeMeshes;
+		for ( size_t i = 0; i < REAL_DATA_KIND_COUNT; ++i )
+			documentLoader.mRealPrecisions[i] = loader.mRealPrecisions[i];
+
+		// the document is the root file of its loader, referencing any other document drops the recording
+		DiscardingWriter writer;
+		DocumentRecorder recorder( &writer );
+		documentLoader.mWriter = &recorder;
+		documentLoader.mDocumentRecorder = &recorder;
+		documentLoader.addFileIdUriPair( documentLoader.mNextFileId++, uri );
+		recorder.startDocument( documentLoader.mCurrentFileId, String() );
+
+		SaxParserErrorHandler saxParserErrorHandler( &errorHandler );
+		bool success = false;
+		{
+			FileLoader fileLoader( &documentLoader, 
+				uri,
+				&saxParserErrorHandler, 
+				documentLoader.mObjectFlags,
+				documentLoader.mParsedObjectFlags, 
+				documentLoader.mExtraDataCallbackHandlerList );
+			success = fileLoader.load( content.empty() ? "" : &content[0], (int)content.size() );
+		}
+		recorder.endDocument();
+
+		// the post processing writes the effects
+		CachedDocument* document = 0;
+		if ( success && !errorHandler.errorOccurred() )
+		{
+			PostProcessor postProcessor( &documentLoader, 
+				&saxParserErrorHandler, 
+				documentLoader.mObjectFlags,
+				documentLoader.mParsedObjectFlags );
+			postProcessor.postProcess();
+			if ( !errorHandler.errorOccurred() )
+				document = recorder.takeDocument( documentLoader.mCurrentFileId, documentLoader.mURIUniqueIdMap );
+		}
+		if ( document )
+		{
+			const MeshOptimizationStatistics& statistics = documentLoader.mMeshOptimizationStatistics;
+			document->setMeshOptimizationStatistics( statistics.original, statistics.optimized );
+		}
+		documentLoader.mDocumentRecorder = 0;
+		return document;
+	}
+
+	//---------------------------------
+	void Loader::addMeshOptimizationStatistics( const COLLADAFW::MeshOptimizer::VertexCacheStatistics& original, const COLLADAFW::MeshOptimizer::VertexCacheStatistics& optimized )
+	{
+		mMeshOptimizationStatistics.original.add( original );
+		mMeshOptimizationStatistics.optimized.add( optimized );
+	}
+
 	//---------------------------------
 	COLLADAFW::TextureMapId Loader::getTextureMapIdBySematic( const String& semantic )
 	{
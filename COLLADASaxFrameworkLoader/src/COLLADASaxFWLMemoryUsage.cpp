@@ -0,0 +1,235 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADASaxFWLStableHeaders.h"
+#include "COLLADASaxFWLMemoryUsage.h"
+#include "COLLADASaxFWLSidAddress.h"
+
+#include "COLLADAFWVisualScene.h"
+#include "COLLADAFWLibraryNodes.h"
+#include "COLLADAFWNode.h"
+#include "COLLADAFWEffect.h"
+#include "COLLADAFWEffectCommon.h"
+#include "COLLADAFWLight.h"
+#include "COLLADAFWCamera.h"
+#include "COLLADAFWMatrix.h"
+#include "COLLADAFWInstanceGeometry.h"
+#include "COLLADAFWInstanceController.h"
+#include "COLLADAFWInstanceNode.h"
+#include "COLLADAFWInstanceCamera.h"
+#include "COLLADAFWInstanceLight.h"
+
+#ifdef COLLADABU_OS_WIN
+#	include <windows.h>
+#	include <psapi.h>
+#	ifdef _MSC_VER
+#		pragma comment( lib, "psapi.lib" )
+#	endif
+#else
+#	include <sys/resource.h>
+#endif
+
+
+namespace COLLADASaxFWL
+{
+
+	//------------------------------
+	MemoryUsage::MemoryUsage()
+		: mCurrentTotalBytes(0)
+		, mPeakTotalBytes(0)
+		, mSpilledTotalBytes(0)
+	{
+		for ( size_t i = 0; i < CATEGORY_COUNT; ++i )
+		{
+			mCurrentBytes[i] = 0;
+			mPeakBytes[i] = 0;
+			mSpilledBytes[i] = 0;
+		}
+	}
+
+	//------------------------------
+	void MemoryUsage::add( Category category, size_t bytes )
+	{
+		size_t& currentBytes = mCurrentBytes[category];
+		currentBytes += bytes;
+		if ( currentBytes > mPeakBytes[category] )
+			mPeakBytes[category] = currentBytes;
+
+		mCurrentTotalBytes += bytes;
+		if ( mCurrentTotalBytes > mPeakTotalBytes )
+			mPeakTotalBytes = mCurrentTotalBytes;
+	}
+
+	//------------------------------
+	void MemoryUsage::remove( Category category, size_t bytes )
+	{
+		size_t& currentBytes = mCurrentBytes[category];
+		if ( bytes > currentBytes )
+			bytes = currentBytes;
+		currentBytes -= bytes;
+		mCurrentTotalBytes -= bytes;
+	}
+
+	//------------------------------
+	void MemoryUsage::addSpilledBytes( Category category, size_t bytes )
+	{
+		mSpilledBytes[category] += bytes;
+		mSpilledTotalBytes += bytes;
+	}
+
+	//------------------------------
+	void MemoryUsage::resetPeaks()
+	{
+		for ( size_t i = 0; i < CATEGORY_COUNT; ++i )
+		{
+			mPeakBytes[i] = mCurrentBytes[i];
+			mSpilledBytes[i] = 0;
+		}
+		mPeakTotalBytes = mCurrentTotalBytes;
+		mSpilledTotalBytes = 0;
+	}
+
+	//------------------------------
+	const char* MemoryUsage::getCategoryName( Category category )
+	{
+		switch ( category )
+		{
+		case VISUAL_SCENES:
+			return "visual scenes";
+		case LIBRARY_NODES:
+			return "library nodes";
+		case EFFECTS:
+			return "effects";
+		case LIGHTS:
+			return "lights";
+		case CAMERAS:
+			return "cameras";
+		case ANIMATION_LISTS:
+			return "animation lists";
+		case ANIMATION_BINDINGS:
+			return "animation bindings";
+		case SID_TREE:
+			return "sid tree";
+		case DUPLICATE_GEOMETRIES:
+			return "duplicate geometries";
+		default:
+			return "";
+		}
+	}
+
+	//------------------------------
+	size_t MemoryUsage::getPeakResidentBytes()
+	{
+#ifdef COLLADABU_OS_WIN
+		PROCESS_MEMORY_COUNTERS counters;
+		if ( !GetProcessMemoryInfo( GetCurrentProcess(), &counters, sizeof(counters) ) )
+			return 0;
+		return counters.PeakWorkingSetSize;
+#else
+		struct rusage usage;
+		if ( getrusage( RUSAGE_SELF, &usage ) != 0 )
+			return 0;
+#	ifdef __APPLE__
+		// bytes on Mac OS X, kilobytes elsewhere
+		return (size_t)usage.ru_maxrss;
+#	else
+		return (size_t)usage.ru_maxrss * 1024;
+#	endif
+#endif
+	}
+
+	//------------------------------
+	size_t MemoryUsage::estimateBytes( const COLLADAFW::VisualScene& visualScene )
+	{
+		size_t bytes = sizeof(COLLADAFW::VisualScene) + estimateBytes( visualScene.getName() );
+		const COLLADAFW::NodePointerArray& rootNodes = visualScene.getRootNodes();
+		for ( size_t i = 0, count = rootNodes.getCount(); i < count; ++i )
+		{
+			bytes += estimateBytes( *rootNodes[i] ) + sizeof(COLLADAFW::Node*);
+		}
+		return bytes;
+	}
+
+	//------------------------------
+	size_t MemoryUsage::estimateBytes( const COLLADAFW::LibraryNodes& libraryNodes )
+	{
+		size_t bytes = sizeof(COLLADAFW::LibraryNodes);
+		const COLLADAFW::NodePointerArray& nodes = libraryNodes.getNodes();
+		for ( size_t i = 0, count = nodes.getCount(); i < count; ++i )
+		{
+			bytes += estimateBytes( *nodes[i] ) + sizeof(COLLADAFW::Node*);
+		}
+		return bytes;
+	}
+
+	//------------------------------
+	size_t MemoryUsage::estimateBytes( const COLLADAFW::Node& node )
+	{
+		size_t bytes = sizeof(COLLADAFW::Node)
+			+ estimateBytes( node.getName() )
+			+ estimateBytes( node.getSid() )
+			+ estimateBytes( node.getOriginalId() );
+
+		// the matrix is the largest transformation
+		bytes += node.getTransformations().getCount() * (sizeof(COLLADAFW::Matrix) + sizeof(COLLADAFW::Transformation*));
+		bytes += node.getInstanceGeometries().getCount() * (sizeof(COLLADAFW::InstanceGeometry) + sizeof(COLLADAFW::InstanceGeometry*));
+		bytes += node.getInstanceControllers().getCount() * (sizeof(COLLADAFW::InstanceController) + sizeof(COLLADAFW::InstanceController*));
+		bytes += node.getInstanceNodes().getCount() * (sizeof(COLLADAFW::InstanceNode) + sizeof(COLLADAFW::InstanceNode*));
+		bytes += node.getInstanceCameras().getCount() * (sizeof(COLLADAFW::InstanceCamera) + sizeof(COLLADAFW::InstanceCamera*));
+		bytes += node.getInstanceLights().getCount() * (sizeof(COLLADAFW::InstanceLight) + sizeof(COLLADAFW::InstanceLight*));
+
+		const COLLADAFW::NodePointerArray& childNodes = node.getChildNodes();
+		for ( size_t i = 0, count = childNodes.getCount(); i < count; ++i )
+		{
+			bytes += estimateBytes( *childNodes[i] ) + sizeof(COLLADAFW::Node*);
+		}
+		return bytes;
+	}
+
+	//------------------------------
+	size_t MemoryUsage::estimateBytes( const COLLADAFW::Effect& effect )
+	{
+		return sizeof(COLLADAFW::Effect)
+			+ estimateBytes( effect.getName() )
+			+ estimateBytes( effect.getOriginalId() )
+			+ effect.getCommonEffects().getCount() * (sizeof(COLLADAFW::EffectCommon) + sizeof(COLLADAFW::EffectCommon*));
+	}
+
+	//------------------------------
+	size_t MemoryUsage::estimateBytes( const COLLADAFW::Light& light )
+	{
+		return sizeof(COLLADAFW::Light) + estimateBytes( light.getName() ) + estimateBytes( light.getOriginalId() );
+	}
+
+	//------------------------------
+	size_t MemoryUsage::estimateBytes( const COLLADAFW::Camera& camera )
+	{
+		return sizeof(COLLADAFW::Camera) + estimateBytes( camera.getName() ) + estimateBytes( camera.getOriginalId() );
+	}
+
+	//------------------------------
+	size_t MemoryUsage::estimateBytes( const SidAddress& sidAddress )
+	{
+		size_t bytes = estimateBytes( sidAddress.getId() ) + estimateBytes( sidAddress.getMemberSelectionName() );
+		const SidAddress::SidList& sids = sidAddress.getSids();
+		for ( size_t i = 0, count = sids.size(); i < count; ++i )
+		{
+			bytes += sizeof(String) + estimateBytes( sids[i] );
+		}
+		return bytes;
+	}
+
+	//------------------------------
+	size_t MemoryUsage::estimateBytes( const String& string )
+	{
+		return string.capacity();
+	}
+
+} // namespace COLLADASaxFWL
@@ -22,13 +22,98 @@
 #include "COLLADAFWPolylist.h"
 #include "COLLADAFWLinestrips.h"
 #include "COLLADAFWIWriter.h"
+#include "COLLADAFWMeshTriangulator.h"
+#include "COLLADAFWMeshOptimizer.h"
+
+#include "COLLADABUParallel.h"
 
 #include <fstream>
+#include <vector>
 
 
 namespace COLLADASaxFWL
 {
 
+	namespace
+	{
+		/** The minimum number of vertices of the primitives of a mesh, to triangulate them concurrently.*/
+		const size_t MIN_VERTICES_FOR_CONCURRENT_TRIANGULATION = 65536;
+
+		/** Triangulates a range of mesh primitives.*/
+		class TriangulateTask : public COLLADABU::ParallelTask
+		{
+		private:
+			const COLLADAFW::Mesh& mMesh;
+			const std::vector<COLLADAFW::MeshPrimitive*>& mPrimitives;
+			std::vector<COLLADAFW::Triangles*>& mTriangles;
+			std::vector<COLLADAFW::MeshTriangulator*>& mTriangulators;
+
+		public:
+			TriangulateTask( const COLLADAFW::Mesh& mesh, 
+				const std::vector<COLLADAFW::MeshPrimitive*>& primitives,
+				std::vector<COLLADAFW::Triangles*>& triangles,
+				std::vector<COLLADAFW::MeshTriangulator*>& triangulators )
+				: mMesh(mesh)
+				, mPrimitives(primitives)
+				, mTriangles(triangles)
+				, mTriangulators(triangulators)
+			{}
+
+			virtual void execute( size_t begin, size_t end, size_t threadIndex )
+			{
+				COLLADAFW::MeshTriangulator& triangulator = *mTriangulators[threadIndex];
+				for ( size_t i = begin; i < end; ++i )
+				{
+					triangulator.triangulate( mMesh, *mPrimitives[i], *mTriangles[i] );
+				}
+			}
+
+		private:
+			/** Disable default assignment operator. */
+			const TriangulateTask& operator= ( const TriangulateTask& pre );
+		};
+
+		/** The minimum number of vertices of the triangles of a mesh, to optimize them concurrently.*/
+		const size_t MIN_VERTICES_FOR_CONCURRENT_OPTIMIZATION = 16384;
+
+		/** Optimizes the triangles in a range, using one optimizer per thread.*/
+		class OptimizeTask : public COLLADABU::ParallelTask
+		{
+		private:
+			const COLLADAFW::Mesh& mMesh;
+			const std::vector<COLLADAFW::Triangles*>& mTriangles;
+			std::vector<COLLADAFW::MeshOptimizer::VertexCacheStatistics>& mOriginalStatistics;
+			std::vector<COLLADAFW::MeshOptimizer::VertexCacheStatistics>& mOptimizedStatistics;
+			std::vector<COLLADAFW::MeshOptimizer*>& mOptimizers;
+
+		public:
+			OptimizeTask( const COLLADAFW::Mesh& mesh, 
+				const std::vector<COLLADAFW::Triangles*>& triangles,
+				std::vector<COLLADAFW::MeshOptimizer::VertexCacheStatistics>& originalStatistics,
+				std::vector<COLLADAFW::MeshOptimizer::VertexCacheStatistics>& optimizedStatistics,
+				std::vector<COLLADAFW::MeshOptimizer*>& optimizers )
+				: mMesh(mesh)
+				, mTriangles(triangles)
+				, mOriginalStatistics(originalStatistics)
+				, mOptimizedStatistics(optimizedStatistics)
+				, mOptimizers(optimizers)
+			{}
+
+			virtual void execute( size_t begin, size_t end, size_t threadIndex )
+			{
+				COLLADAFW::MeshOptimizer& optimizer = *mOptimizers[threadIndex];
+				for ( size_t i = begin; i < end; ++i )
+				{
+					optimizer.optimizeTriangles( mMesh, *mTriangles[i], COLLADAFW::MeshOptimizer::DEFAULT_OVERDRAW_THRESHOLD, &mOriginalStatistics[i], &mOptimizedStatistics[i] );
+				}
+			}
+
+		private:
+			/** Disable default assignment operator. */
+			const OptimizeTask& operator= ( const OptimizeTask& pre );
+		};
+	}
+
 	MeshLoader::MeshLoader( IFilePartLoader* callingFilePartLoader, const String& geometryId, const String& geometryName )
 		: SourceArrayLoader (callingFilePartLoader )
 		, mMeshUniqueId(createUniqueIdFromId((ParserChar*)geometryId.c_str(), COLLADAFW::Geometry::ID()))
@@ -981,6 +1066,12 @@ namespace COLLADASaxFWL
 	{
         mInMesh = false;
 
+		if ( getColladaLoader()->getTriangulateMeshes() )
+			triangulateMesh();
+
+		if ( getColladaLoader()->getOptimizeMeshes() )
+			optimizeMesh();
+
 		// The mesh will be written by the GeometyLoader. Therefore nothing to with the mesh here
 		finish();
 		return true;
@@ -1637,5 +1728,89 @@ namespace COLLADASaxFWL
 		return writePrimitiveIndices(data, length);
 	}
 
+	//------------------------------
+	void MeshLoader::triangulateMesh()
+	{
+		COLLADAFW::MeshPrimitiveArray& meshPrimitives = mMesh->getMeshPrimitives();
+
+		// the unique ids are created up front, since creating them is not thread safe
+		std::vector<size_t> primitiveIndices;
+		std::vector<COLLADAFW::MeshPrimitive*> primitives;
+		std::vector<COLLADAFW::Triangles*> triangles;
+		size_t verticesCount = 0;
+		for ( size_t i = 0, count = meshPrimitives.getCount(); i < count; ++i )
+		{
+			COLLADAFW::MeshPrimitive* meshPrimitive = meshPrimitives[i];
+			if ( !COLLADAFW::MeshTriangulator::isTriangulated( meshPrimitive->getPrimitiveType() ) )
+				continue;
+			primitiveIndices.push_back( i );
+			primitives.push_back( meshPrimitive );
+			triangles.push_back( new COLLADAFW::Triangles( createUniqueId( COLLADAFW::Triangles::ID() ) ) );
+			verticesCount += meshPrimitive->getPositionIndices().getCount();
+		}
+		if ( primitives.empty() )
+			return;
+
+		size_t maxThreadCount = verticesCount < MIN_VERTICES_FOR_CONCURRENT_TRIANGULATION ? 1 : getColladaLoader()->getThreadCount();
+		size_t threadCount = COLLADABU::getParallelThreadCount( primitives.size(), maxThreadCount, 1 );
+		std::vector<COLLADAFW::MeshTriangulator*> triangulators( threadCount );
+		for ( size_t i = 0; i < threadCount; ++i )
+			triangulators[i] = new COLLADAFW::MeshTriangulator();
+
+		TriangulateTask triangulateTask( *mMesh, primitives, triangles, triangulators );
+		COLLADABU::parallelFor( primitives.size(), triangulateTask, threadCount, 1 );
+
+		for ( size_t i = 0; i < threadCount; ++i )
+			delete triangulators[i];
+
+		for ( size_t i = 0, count = primitives.size(); i < count; ++i )
+		{
+			meshPrimitives[primitiveIndices[i]] = triangles[i];
+			delete primitives[i];
+		}
+	}
+
+	//------------------------------
+	void MeshLoader::optimizeMesh()
+	{
+		COLLADAFW::MeshPrimitiveArray& meshPrimitives = mMesh->getMeshPrimitives();
+
+		std::vector<COLLADAFW::Triangles*> triangles;
+		size_t verticesCount = 0;
+		for ( size_t i = 0, count = meshPrimitives.getCount(); i < count; ++i )
+		{
+			COLLADAFW::MeshPrimitive* meshPrimitive = meshPrimitives[i];
+			if ( meshPrimitive->getPrimitiveType() != COLLADAFW::MeshPrimitive::TRIANGLES )
+				continue;
+			triangles.push_back( (COLLADAFW::Triangles*)meshPrimitive );
+			verticesCount += meshPrimitive->getPositionIndices().getCount();
+		}
+		if ( triangles.empty() )
+			return;
+
+		size_t maxThreadCount = verticesCount < MIN_VERTICES_FOR_CONCURRENT_OPTIMIZATION ? 1 : getColladaLoader()->getThreadCount();
+		size_t threadCount = COLLADABU::getParallelThreadCount( triangles.size(), maxThreadCount, 1 );
+		std::vector<COLLADAFW::MeshOptimizer*> optimizers( threadCount );
+		for ( size_t i = 0; i < threadCount; ++i )
+			optimizers[i] = new COLLADAFW::MeshOptimizer();
+
+		std::vector<COLLADAFW::MeshOptimizer::VertexCacheStatistics> originalStatistics( triangles.size() );
+		std::vector<COLLADAFW::MeshOptimizer::VertexCacheStatistics> optimizedStatistics( triangles.size() );
+		OptimizeTask optimizeTask( *mMesh, triangles, originalStatistics, optimizedStatistics, optimizers );
+		COLLADABU::parallelFor( triangles.size(), optimizeTask, threadCount, 1 );
+
+		for ( size_t i = 0; i < threadCount; ++i )
+			delete optimizers[i];
+
+		for ( size_t i = 0, count = triangles.size(); i < count; ++i )
+			addMeshOptimizationStatistics( originalStatistics[i], optimizedStatistics[i] );
+	}
+
+	//------------------------------
+	Loader::RealPrecision MeshLoader::getRealPrecision() const
+	{
+		return getColladaLoader()->getRealPrecision( Loader::GEOMETRY_DATA );
+	}
+
 
 } // namespace COLLADASaxFWL
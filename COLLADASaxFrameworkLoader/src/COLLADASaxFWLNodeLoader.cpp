@@ -11,6 +11,7 @@
 #include "COLLADASaxFWLStableHeaders.h"
 #include "COLLADASaxFWLNodeLoader.h"
 #include "COLLADASaxFWLFilePartLoader.h"
+#include "COLLADASaxFWLFileLoader.h"
 #include "COLLADASaxFWLGeometryMaterialIdInfo.h"
 
 #include "COLLADAFWVisualScene.h"
@@ -50,6 +51,13 @@ namespace COLLADASaxFWL
 	//------------------------------
 	bool NodeLoader::beginNode( const node__AttributeData& attributeData )
 	{
+		// child nodes are loaded, if their root node is
+		if ( mNodeStack.empty() && !getHandlingFilePartLoader()->getFileLoader()->getNodeIdFilter().accepts( attributeData.id ) )
+		{
+			getHandlingFilePartLoader()->getFileLoader()->skipCurrentElement();
+			return true;
+		}
+
 		COLLADAFW::Node* newNode = new COLLADAFW::Node( getHandlingFilePartLoader()->createUniqueIdFromId(attributeData.id, COLLADAFW::Node::ID()));
 
 		if ( attributeData.name )
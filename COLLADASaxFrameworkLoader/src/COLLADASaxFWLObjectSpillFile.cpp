@@ -0,0 +1,95 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADASaxFWLStableHeaders.h"
+#include "COLLADASaxFWLObjectSpillFile.h"
+
+
+namespace COLLADASaxFWL
+{
+
+	//------------------------------
+	ObjectSpillFile::ObjectSpillFile()
+		: mFile(0)
+		, mPayloadsCount(0)
+		, mReadPayloadsCount(0)
+		, mBytesCount(0)
+		, mWriteFailed(false)
+	{
+	}
+
+	//------------------------------
+	ObjectSpillFile::~ObjectSpillFile()
+	{
+		// files created by tmpfile() are removed, when they are closed
+		if ( mFile )
+			fclose( mFile );
+	}
+
+	//------------------------------
+	bool ObjectSpillFile::write( const std::vector<char>& payload )
+	{
+		if ( mWriteFailed )
+			return false;
+
+		if ( !mFile )
+		{
+			mFile = tmpfile();
+			if ( !mFile )
+			{
+				mWriteFailed = true;
+				return false;
+			}
+		}
+
+		// like the animation sid address binding spill file, the file is only appended to, an incomplete
+		// payload behind the complete ones is never read, since it is not counted
+		unsigned long long size = payload.size();
+		bool success = (fwrite( &size, sizeof(size), 1, mFile ) == 1)
+			&& (payload.empty() || (fwrite( &payload[0], 1, payload.size(), mFile ) == payload.size()))
+			&& (fflush( mFile ) == 0);
+		if ( !success )
+		{
+			mWriteFailed = true;
+			return false;
+		}
+		mBytesCount += sizeof(size) + payload.size();
+		++mPayloadsCount;
+		return true;
+	}
+
+	//------------------------------
+	bool ObjectSpillFile::startReading()
+	{
+		mReadPayloadsCount = 0;
+		if ( !mFile )
+			return mPayloadsCount == 0;
+		rewind( mFile );
+		return ferror( mFile ) == 0;
+	}
+
+	//------------------------------
+	bool ObjectSpillFile::read( std::vector<char>& payload )
+	{
+		if ( mReadPayloadsCount >= mPayloadsCount )
+			return false;
+
+		unsigned long long size = 0;
+		if ( fread( &size, sizeof(size), 1, mFile ) != 1 )
+			return false;
+		payload.resize( (size_t)size );
+		if ( !payload.empty() && (fread( &payload[0], 1, payload.size(), mFile ) != payload.size()) )
+			return false;
+
+		++mReadPayloadsCount;
+		return true;
+	}
+
+} // namespace COLLADASaxFWL
@@ -13,16 +13,78 @@
 
 #include "COLLADASaxFWLFormulasLinker.h"
 #include "COLLADASaxFWLKinematicsSceneCreator.h"
+#include "COLLADASaxFWLAnimationSidAddressBindingSpillFile.h"
+#include "COLLADASaxFWLObjectSpillFile.h"
+#include "COLLADASaxFWLBinaryCacheWriter.h"
+#include "COLLADASaxFWLBinaryCacheLoader.h"
+#include "COLLADASaxFWLSidTreeNode.h"
+#include "COLLADASaxFWLUtils.h"
 
 #include "COLLADAFWIWriter.h"
 #include "COLLADAFWMorphController.h"
 #include "COLLADAFWFormulas.h"
 #include "COLLADAFWKinematicsScene.h"
+#include "COLLADAFWVisualScene.h"
+#include "COLLADAFWLibraryNodes.h"
+#include "COLLADAFWEffect.h"
+#include "COLLADAFWLight.h"
+#include "COLLADAFWCamera.h"
+#include "COLLADAFWNode.h"
+#include "COLLADAFWMatrix.h"
+#include "COLLADAFWInstanceGeometry.h"
+
+#include "COLLADABUParallel.h"
+#include "COLLADABUTimer.h"
 
 
 namespace COLLADASaxFWL
 {
 
+	namespace
+	{
+		/** The minimum number of sid addresses resolved by one thread.*/
+		const size_t MIN_SID_ADDRESSES_PER_THREAD = 256;
+
+		/** The number of bindings read from the spill file at once.*/
+		const size_t SPILLED_BINDINGS_PER_CHUNK = 4096;
+
+		/** Resolves a range of sid addresses.*/
+		class ResolveSidsTask : public COLLADABU::ParallelTask
+		{
+		private:
+			DocumentProcessor* mDocumentProcessor;
+			const SidAddressPointerList& mSidAddresses;
+			std::vector<const SidTreeNode*>* mSidTreeNodes;
+			std::vector<Loader::SidPathSidTreeNodeMap>& mResolvedSidPathMaps;
+
+		public:
+			ResolveSidsTask( DocumentProcessor* documentProcessor, 
+				const SidAddressPointerList& sidAddresses, 
+				std::vector<const SidTreeNode*>* sidTreeNodes, 
+				std::vector<Loader::SidPathSidTreeNodeMap>& resolvedSidPathMaps )
+				: mDocumentProcessor(documentProcessor)
+				, mSidAddresses(sidAddresses)
+				, mSidTreeNodes(sidTreeNodes)
+				, mResolvedSidPathMaps(resolvedSidPathMaps)
+			{}
+
+			virtual void execute( size_t begin, size_t end, size_t threadIndex )
+			{
+				Loader::SidPathSidTreeNodeMap& resolvedSidPathMap = mResolvedSidPathMaps[threadIndex];
+				for ( size_t i = begin; i < end; ++i )
+				{
+					const SidTreeNode* sidTreeNode = mDocumentProcessor->resolveSid( *mSidAddresses[i], resolvedSidPathMap );
+					if ( mSidTreeNodes )
+						(*mSidTreeNodes)[i] = sidTreeNode;
+				}
+			}
+
+		private:
+			/** Disable default assignment operator. */
+			const ResolveSidsTask& operator= ( const ResolveSidsTask& pre );
+		};
+	}
+
     //------------------------------
 	PostProcessor::PostProcessor( Loader* colladaLoader, SaxParserErrorHandler* saxParserErrorHandler, int objectFlags, int& /*[in,out]*/ parsedObjectFlags )
 		: DocumentProcessor( colladaLoader, saxParserErrorHandler, objectFlags, parsedObjectFlags)
@@ -36,123 +98,525 @@ namespace COLLADASaxFWL
 	//---------------------------------
 	void PostProcessor::postProcess()
 	{
+		mColladaLoader->mPostProcessingTimings.clear();
+		COLLADABU::Timer timer;
+
 		if ( (getObjectFlags() & Loader::ANIMATION_LIST_FLAG) != 0 )
 		{
 			createMissingAnimationLists();
+			addPhaseTiming( "createMissingAnimationLists", timer );
 		}
 
 		if ( (getObjectFlags() & Loader::EFFECT_FLAG) != 0 )
 		{
 			writeEffects();
+			addPhaseTiming( "writeEffects", timer );
 		}
 
 		if ( (getObjectFlags() & Loader::LIGHT_FLAG) != 0 )
 		{
 			writeLights();
+			addPhaseTiming( "writeLights", timer );
 		}
 
 		if ( (getObjectFlags() & Loader::CAMERA_FLAG) != 0 )
 		{
 			writeCameras();
+			addPhaseTiming( "writeCameras", timer );
 		}
 
 		if ( (getObjectFlags() & Loader::CONTROLLER_FLAG) != 0 )
 		{
 			createAndWriteSkinControllers();
+			addPhaseTiming( "createAndWriteSkinControllers", timer );
 			writeMorphControllers();
+			addPhaseTiming( "writeMorphControllers", timer );
+		}
+		releaseTransformedDuplicateGeometries();
+
+		if ( mColladaLoader->getInstanceDuplicateGeometries() && !mColladaLoader->getMeshDeduplicator().getDuplicates().empty() )
+		{
+			instanceDuplicateGeometries();
+			addPhaseTiming( "instanceDuplicateGeometries", timer );
 		}
 
 		if ( (getObjectFlags() & Loader::VISUAL_SCENES_FLAG) != 0 )
 		{
 			writeVisualScenes();
+			addPhaseTiming( "writeVisualScenes", timer );
 		}
 
 		if ( (getObjectFlags() & Loader::LIBRARY_NODES_FLAG) != 0 )
 		{
 			writeLibraryNodes();
+			addPhaseTiming( "writeLibraryNodes", timer );
 		}
 
 		if ( (getObjectFlags() & Loader::ANIMATION_LIST_FLAG) != 0 )
 		{
 			writeAnimationLists();
+			addPhaseTiming( "writeAnimationLists", timer );
 		}
 
 		if ( (getObjectFlags() & Loader::FORMULA_FLAG) != 0 )
 		{
 			linkAndWriteFormulas();
+			addPhaseTiming( "linkAndWriteFormulas", timer );
 		}
 
 		if ( (getObjectFlags() & Loader::KINEMATICS_FLAG) != 0 )
 		{
 			createAndWriteKinematicsScene();
+			addPhaseTiming( "createAndWriteKinematicsScene", timer );
+		}
+
+		if ( releaseWrittenObjects() )
+		{
+			releaseNodes();
+			addPhaseTiming( "releaseNodes", timer );
+		}
+	}
+
+	//-----------------------------
+	void PostProcessor::finishDocument()
+	{
+		if ( (getObjectFlags() & Loader::ANIMATION_LIST_FLAG) != 0 )
+		{
+			// the targets of the resolved bindings might be moved to the spill files below. The bindings that
+			// can not be resolved yet might target objects of the following documents
+			Loader::AnimationSidAddressBindingList unresolvedBindings;
+			createMissingAnimationListsOfAllBindings( &unresolvedBindings );
+
+			delete mColladaLoader->mAnimationSidAddressBindingSpillFile;
+			mColladaLoader->mAnimationSidAddressBindingSpillFile = 0;
+			mAnimationSidAddressBindings.swap( unresolvedBindings );
+
+			mMemoryUsage.release( MemoryUsage::ANIMATION_BINDINGS );
+			for ( size_t i = 0, count = mAnimationSidAddressBindings.size(); i < count; ++i )
+			{
+				const Loader::AnimationSidAddressBinding& binding = mAnimationSidAddressBindings[i];
+				mMemoryUsage.add( MemoryUsage::ANIMATION_BINDINGS, sizeof(binding) + MemoryUsage::estimateBytes( binding.sidAddress ) );
+			}
+		}
+
+		// the parameters of the formulas are resolved in the post processing, they might be any animatable
+		if ( !isMemoryBudgetExceeded() || !mFormulasMap.empty() )
+			return;
+
+		size_t spilledCount = spillObjects( mEffects, MemoryUsage::EFFECTS );
+		spilledCount += spillObjects( mLights, MemoryUsage::LIGHTS );
+		spilledCount += spillObjects( mCameras, MemoryUsage::CAMERAS );
+		if ( canSpillNodes() )
+		{
+			spilledCount += spillObjects( mVisualScenes, MemoryUsage::VISUAL_SCENES );
+			spilledCount += spillObjects( mLibraryNodes, MemoryUsage::LIBRARY_NODES );
+		}
+
+		if ( spilledCount != 0 )
+			removeReleasedSidTreeNodes();
+	}
+
+	//-----------------------------
+	bool PostProcessor::areNodesReferencedAfterWriting() const
+	{
+		const KinematicsIntermediateData& kinematicsIntermediateData = getKinematicsIntermediateData();
+		return !mFormulasMap.empty()
+			|| !kinematicsIntermediateData.getJoints().empty()
+			|| !kinematicsIntermediateData.getInstanceJoints().empty()
+			|| !kinematicsIntermediateData.getKinematicsModels().empty()
+			|| !kinematicsIntermediateData.getKinematicsControllers().empty()
+			|| !kinematicsIntermediateData.getKinematicsScenes().empty()
+			|| !kinematicsIntermediateData.getInstanceKinematicsScenes().empty();
+	}
+
+	//-----------------------------
+	bool PostProcessor::canSpillNodes() const
+	{
+		// the instance controllers and the instances of duplicate geometries are modified before the nodes
+		// are written
+		return mInstanceControllerDataListMap.empty() 
+			&& !mColladaLoader->getInstanceDuplicateGeometries()
+			&& !areNodesReferencedAfterWriting();
+	}
+
+	//-----------------------------
+	template<class ObjectType>
+	size_t PostProcessor::spillObjects( std::vector<ObjectType*>& objects, MemoryUsage::Category category )
+	{
+		ObjectSpillFile*& spillFile = mColladaLoader->mObjectSpillFiles[category];
+		Loader::ObjectSidTreeNodeMap& objectSidTreeNodeMap = mColladaLoader->mObjectSidTreeNodeMap;
+		std::vector<char> payload;
+
+		// the objects are written in the order they have been added, the objects kept in memory follow the
+		// ones in the spill file
+		size_t spilledCount = 0;
+		for ( size_t count = objects.size(); (spilledCount < count) && isMemoryBudgetExceeded(); ++spilledCount )
+		{
+			// objects without a recorded sid tree node might still be targeted by the sid tree
+			ObjectType* object = objects[spilledCount];
+			Loader::ObjectSidTreeNodeMap::iterator it = objectSidTreeNodeMap.find( object );
+			if ( (it == objectSidTreeNodeMap.end()) || !BinaryCacheWriter::storeObject( *object, payload ) )
+				break;
+
+			if ( !spillFile )
+				spillFile = new ObjectSpillFile();
+			if ( !spillFile->write( payload ) )
+				break;
+
+			// the nodes of the elements of the object are released with the whole sub hierarchy afterwards
+			it->second->release();
+			objectSidTreeNodeMap.erase( it );
+
+			mMemoryUsage.remove( category, MemoryUsage::estimateBytes( *object ) );
+			mMemoryUsage.addSpilledBytes( category, sizeof(unsigned long long) + payload.size() );
+			FW_DELETE object;
+		}
+
+		objects.erase( objects.begin(), objects.begin() + spilledCount );
+		return spilledCount;
+	}
+
+	//-----------------------------
+	void PostProcessor::removeReleasedSidTreeNodes()
+	{
+		mColladaLoader->getSidTreeRoot()->releaseSubHierarchies();
+
+		Loader::IdStringSidTreeNodeMap::iterator it = mIdStringSidTreeNodeMap.begin();
+		while ( it != mIdStringSidTreeNodeMap.end() )
+		{
+			if ( it->second->isReleased() )
+			{
+				mMemoryUsage.remove( MemoryUsage::SID_TREE, it->first.size() + sizeof(String) + 2 * sizeof(SidTreeNode*) );
+				mIdStringSidTreeNodeMap.erase( it++ );
+			}
+			else
+			{
+				++it;
+			}
+		}
+
+		// resolved addresses might point to released nodes
+		mResolvedSidPathMap.clear();
+	}
+
+	//-----------------------------
+	template<class ObjectType>
+	void PostProcessor::writeSpilledObjects( MemoryUsage::Category category, bool (COLLADAFW::IWriter::*writeFunction)( const ObjectType* ) )
+	{
+		ObjectSpillFile*& spillFile = mColladaLoader->mObjectSpillFiles[category];
+		if ( !spillFile )
+			return;
+
+		bool success = spillFile->startReading();
+		std::vector<char> payload;
+		for ( size_t i = 0, count = spillFile->getPayloadsCount(); success && (i < count); ++i )
+		{
+			ObjectType* object = 0;
+			success = spillFile->read( payload ) 
+				&& BinaryCacheLoader::restoreObject( payload.empty() ? 0 : &payload[0], payload.size(), object );
+			if ( !success )
+				break;
+
+			size_t bytes = MemoryUsage::estimateBytes( *object );
+			mMemoryUsage.add( category, bytes );
+			(writer()->*writeFunction)( object );
+			deleteRestoredObject( object );
+			mMemoryUsage.remove( category, bytes );
+		}
+
+		if ( !success )
+		{
+			handleFWLError( SaxFWLError::ERROR_DATA_NOT_VALID, "Could not read objects from temporary file." );
+		}
+
+		delete spillFile;
+		spillFile = 0;
+	}
+
+	//-----------------------------
+	void PostProcessor::deleteRestoredObject( COLLADAFW::Effect* effect )
+	{
+		if ( !retainForDocumentCache( effect ) )
+			FW_DELETE effect;
+	}
+
+	//-----------------------------
+	void PostProcessor::releaseNodes()
+	{
+		deleteVectorFW( mVisualScenes );
+		mVisualScenes.clear();
+		mMemoryUsage.release( MemoryUsage::VISUAL_SCENES );
+
+		deleteVectorFW( mLibraryNodes );
+		mLibraryNodes.clear();
+		mMemoryUsage.release( MemoryUsage::LIBRARY_NODES );
+	}
+
+	//-----------------------------
+	void PostProcessor::addPhaseTiming( const char* phaseName, COLLADABU::Timer& timer )
+	{
+		mColladaLoader->mPostProcessingTimings.push_back( Loader::PhaseTiming( phaseName, timer.getElapsedSeconds() ) );
+		timer.restart();
+	}
+
+	//-----------------------------
+	void PostProcessor::resolveSids( const SidAddressPointerList& sidAddresses, SidTreeNodePointerList* sidTreeNodes )
+	{
+		size_t sidAddressesCount = sidAddresses.size();
+		if ( sidTreeNodes )
+			sidTreeNodes->assign( sidAddressesCount, (const SidTreeNode*)0 );
+
+		// each thread uses its own map of resolved sid addresses, since the maps are modified while resolving
+		size_t threadCount = COLLADABU::getParallelThreadCount( sidAddressesCount, mColladaLoader->getThreadCount(), MIN_SID_ADDRESSES_PER_THREAD );
+		std::vector<Loader::SidPathSidTreeNodeMap> resolvedSidPathMaps( threadCount );
+		ResolveSidsTask resolveSidsTask( this, sidAddresses, sidTreeNodes, resolvedSidPathMaps );
+		COLLADABU::parallelFor( sidAddressesCount, resolveSidsTask, threadCount, MIN_SID_ADDRESSES_PER_THREAD );
+
+		for ( size_t i = 0; i < threadCount; ++i )
+		{
+			mResolvedSidPathMap.insert( resolvedSidPathMaps[i].begin(), resolvedSidPathMaps[i].end() );
+		}
+	}
+
+	//-----------------------------
+	void PostProcessor::instanceDuplicateGeometries()
+	{
+		for ( size_t i = 0, count = mVisualScenes.size(); i < count; ++i)
+		{
+			instanceDuplicateGeometries( mVisualScenes[i]->getRootNodes() );
+		}
+
+		for ( size_t i = 0, count = mLibraryNodes.size(); i < count; ++i)
+		{
+			instanceDuplicateGeometries( mLibraryNodes[i]->getNodes() );
+		}
+	}
+
+	//-----------------------------
+	void PostProcessor::instanceDuplicateGeometries( COLLADAFW::NodePointerArray& nodes )
+	{
+		const COLLADAFW::MeshDeduplicator& meshDeduplicator = mColladaLoader->getMeshDeduplicator();
+
+		std::vector<COLLADAFW::NodePointerArray*> nodeArrays( 1, &nodes );
+		while ( !nodeArrays.empty() )
+		{
+			COLLADAFW::NodePointerArray& currentNodes = *nodeArrays.back();
+			nodeArrays.pop_back();
+
+			for ( size_t i = 0, count = currentNodes.getCount(); i < count; ++i )
+			{
+				COLLADAFW::Node* node = currentNodes[i];
+				COLLADAFW::NodePointerArray& childNodes = node->getChildNodes();
+				nodeArrays.push_back( &childNodes );
+
+				COLLADAFW::InstanceGeometryPointerArray& instanceGeometries = node->getInstanceGeometries();
+				size_t keptCount = 0;
+				for ( size_t j = 0, instancesCount = instanceGeometries.getCount(); j < instancesCount; ++j )
+				{
+					COLLADAFW::InstanceGeometry* instanceGeometry = instanceGeometries[j];
+					const COLLADAFW::MeshDeduplicator::Duplicate* duplicate = meshDeduplicator.findDuplicate( instanceGeometry->getInstanciatedObjectId() );
+					if ( duplicate )
+						instanceGeometry->setInstanciatedObjectId( duplicate->originalId );
+
+					if ( !duplicate || !duplicate->transformed )
+					{
+						instanceGeometries[keptCount++] = instanceGeometry;
+						continue;
+					}
+
+					// the new child node is visited with the other child nodes, its instance is kept
+					COLLADAFW::Node* transformationNode = FW_NEW COLLADAFW::Node( createUniqueId( COLLADAFW::Node::ID() ) );
+					transformationNode->setName( node->getName() );
+					transformationNode->getTransformations().append( FW_NEW COLLADAFW::Matrix( duplicate->transformation ) );
+					transformationNode->getInstanceGeometries().append( instanceGeometry );
+					childNodes.append( transformationNode );
+				}
+				instanceGeometries.setCount( keptCount );
+			}
 		}
 	}
 
 	//-----------------------------
 	void PostProcessor::writeVisualScenes()
 	{
+		writeSpilledObjects( MemoryUsage::VISUAL_SCENES, &COLLADAFW::IWriter::writeVisualScene );
+
+		// without kinematics and formulas nothing references the nodes after they have been written
+		bool releaseVisualScenes = releaseWrittenObjects() && !areNodesReferencedAfterWriting();
 		for ( size_t i = 0, count = mVisualScenes.size(); i < count; ++i)
 		{
 			COLLADAFW::VisualScene *visualScene = mVisualScenes[i];
 			writer()->writeVisualScene(visualScene);
+			if ( releaseVisualScenes )
+			{
+				mMemoryUsage.remove( MemoryUsage::VISUAL_SCENES, MemoryUsage::estimateBytes( *visualScene ) );
+				FW_DELETE visualScene;
+				mVisualScenes[i] = 0;
+			}
+		}
+
+		if ( releaseVisualScenes )
+		{
+			mVisualScenes.clear();
+			mMemoryUsage.release( MemoryUsage::VISUAL_SCENES );
 		}
 	}
 
 	//-----------------------------
 	void PostProcessor::writeLibraryNodes()
 	{
+		writeSpilledObjects( MemoryUsage::LIBRARY_NODES, &COLLADAFW::IWriter::writeLibraryNodes );
+
+		bool releaseLibraryNodes = releaseWrittenObjects() && !areNodesReferencedAfterWriting();
 		for ( size_t i = 0, count = mLibraryNodes.size(); i < count; ++i)
 		{
 			COLLADAFW::LibraryNodes *libraryNodes = mLibraryNodes[i];
 			writer()->writeLibraryNodes(libraryNodes);
+			if ( releaseLibraryNodes )
+			{
+				mMemoryUsage.remove( MemoryUsage::LIBRARY_NODES, MemoryUsage::estimateBytes( *libraryNodes ) );
+				FW_DELETE libraryNodes;
+				mLibraryNodes[i] = 0;
+			}
+		}
+
+		if ( releaseLibraryNodes )
+		{
+			mLibraryNodes.clear();
+			mMemoryUsage.release( MemoryUsage::LIBRARY_NODES );
 		}
 	}
 
 	//-----------------------------
 	void PostProcessor::writeEffects()
 	{
+		writeSpilledObjects( MemoryUsage::EFFECTS, &COLLADAFW::IWriter::writeEffect );
+
+		// the effects of documents recorded for the document cache are owned by the cache after writing
+		size_t keptEffectsCount = 0;
 		for ( size_t i = 0, count = mEffects.size(); i < count; ++i)
 		{
 			COLLADAFW::Effect *effect = mEffects[i];
 			writer()->writeEffect(effect);
+			if ( !retainForDocumentCache(effect) )
+				mEffects[keptEffectsCount++] = effect;
+		}
+		mEffects.resize( keptEffectsCount );
+
+		// animation lists have already been assigned, nothing references the effects anymore
+		if ( releaseWrittenObjects() )
+		{
+			deleteVectorFW( mEffects );
+			mEffects.clear();
+			mMemoryUsage.release( MemoryUsage::EFFECTS );
 		}
 	}
 
 	//-----------------------------
 	void PostProcessor::writeLights()
 	{
+		writeSpilledObjects( MemoryUsage::LIGHTS, &COLLADAFW::IWriter::writeLight );
+
 		for ( size_t i = 0, count = mLights.size(); i < count; ++i)
 		{
 			COLLADAFW::Light *light = mLights[i];
 			writer()->writeLight(light);
 		}
+
+		if ( releaseWrittenObjects() )
+		{
+			deleteVectorFW( mLights );
+			mLights.clear();
+			mMemoryUsage.release( MemoryUsage::LIGHTS );
+		}
 	}
 
 	//-----------------------------
 	void PostProcessor::writeCameras()
 	{
+		writeSpilledObjects( MemoryUsage::CAMERAS, &COLLADAFW::IWriter::writeCamera );
+
 		for ( size_t i = 0, count = mCameras.size(); i < count; ++i)
 		{
 			COLLADAFW::Camera *camera = mCameras[i];
 			writer()->writeCamera(camera);
 		}
+
+		if ( releaseWrittenObjects() )
+		{
+			deleteVectorFW( mCameras );
+			mCameras.clear();
+			mMemoryUsage.release( MemoryUsage::CAMERAS );
+		}
 	}
 
 	//-----------------------------
 	void PostProcessor::createMissingAnimationLists()
 	{
-		Loader::AnimationSidAddressBindingList::const_iterator it = mAnimationSidAddressBindings.begin();
-		for ( ; it != mAnimationSidAddressBindings.end(); ++it )
+		createMissingAnimationListsOfAllBindings( 0 );
+
+		if ( releaseWrittenObjects() )
+		{
+			delete mColladaLoader->mAnimationSidAddressBindingSpillFile;
+			mColladaLoader->mAnimationSidAddressBindingSpillFile = 0;
+			Loader::AnimationSidAddressBindingList().swap( mAnimationSidAddressBindings );
+			mMemoryUsage.release( MemoryUsage::ANIMATION_BINDINGS );
+		}
+	}
+
+	//-----------------------------
+	void PostProcessor::createMissingAnimationListsOfAllBindings( Loader::AnimationSidAddressBindingList* unresolvedBindings )
+	{
+		AnimationSidAddressBindingSpillFile* spillFile = mColladaLoader->mAnimationSidAddressBindingSpillFile;
+		if ( spillFile )
+		{
+			bool success = spillFile->startReading();
+			Loader::AnimationSidAddressBindingList spilledBindings;
+			while ( success )
+			{
+				spilledBindings.clear();
+				success = spillFile->read( SPILLED_BINDINGS_PER_CHUNK, spilledBindings );
+				if ( spilledBindings.empty() )
+					break;
+				createMissingAnimationLists( spilledBindings, unresolvedBindings );
+			}
+
+			if ( !success )
+			{
+				handleFWLError( SaxFWLError::ERROR_DATA_NOT_VALID, "Could not read animation bindings from temporary file." );
+			}
+		}
+
+		createMissingAnimationLists( mAnimationSidAddressBindings, unresolvedBindings );
+	}
+
+	//-----------------------------
+	void PostProcessor::createMissingAnimationLists( const Loader::AnimationSidAddressBindingList& bindings, Loader::AnimationSidAddressBindingList* unresolvedBindings )
+	{
+		size_t bindingsCount = bindings.size();
+
+		// resolve the targets concurrently, create the animation lists in the order of the bindings, so
+		// the unique ids of the animation lists do not depend on the number of threads
+		SidAddressPointerList sidAddresses( bindingsCount );
+		for ( size_t i = 0; i < bindingsCount; ++i )
+		{
+			sidAddresses[i] = &bindings[i].sidAddress;
+		}
+
+		SidTreeNodePointerList sidTreeNodes;
+		resolveSids( sidAddresses, &sidTreeNodes );
+
+		for ( size_t i = 0; i < bindingsCount; ++i )
 		{
-			const Loader::AnimationSidAddressBinding& binding = *it;
-			createMissingAnimationList( binding );
+			createMissingAnimationList( bindings[i], sidTreeNodes[i] );
+			if ( unresolvedBindings && !sidTreeNodes[i] )
+				unresolvedBindings->push_back( bindings[i] );
 		}
 	}
 
 	//-----------------------------
-	void PostProcessor::createMissingAnimationList( const Loader::AnimationSidAddressBinding& binding )
+	void PostProcessor::createMissingAnimationList( const Loader::AnimationSidAddressBinding& binding, const SidTreeNode* sidTreeNode )
 	{
-		const SidTreeNode* sidTreeNode = resolveSid( binding.sidAddress);
 		if ( sidTreeNode )
 		{
 			if ( sidTreeNode->getTargetType() == SidTreeNode::TARGETTYPECLASS_ANIMATABLE )
@@ -169,6 +633,7 @@ namespace COLLADASaxFWL
 				if ( !animationList )
 				{
 					animationList = new COLLADAFW::AnimationList( animationListUniqueId );
+					mMemoryUsage.add( MemoryUsage::ANIMATION_LISTS, sizeof(COLLADAFW::AnimationList) );
 				}
 
 				// TODO handle this for arrays
@@ -194,6 +659,7 @@ namespace COLLADASaxFWL
 				}
 
 				animationList->getAnimationBindings().append( animationBinding );
+				mMemoryUsage.add( MemoryUsage::ANIMATION_LISTS, sizeof(COLLADAFW::AnimationList::AnimationBinding) );
 			}
 		}
 
@@ -206,8 +672,15 @@ namespace COLLADASaxFWL
 		Loader::MorphControllerList::const_iterator it = morphControllerList.begin();
 		for ( ; it != morphControllerList.end(); ++it)
 		{
-			const COLLADAFW::MorphController* morphController = *it;
+			COLLADAFW::MorphController* morphController = *it;
 			const COLLADAFW::UniqueId& morphControllerUniqueId = morphController->getUniqueId();
+
+			morphController->setSource( getControllerGeometryUniqueId( morphController->getSource() ) );
+			COLLADAFW::UniqueIdArray& morphTargets = morphController->getMorphTargets();
+			for ( size_t i = 0, count = morphTargets.getCount(); i < count; ++i )
+			{
+				morphTargets[i] = getControllerGeometryUniqueId( morphTargets[i] );
+			}
 			const Loader::InstanceControllerDataList& instanceControllerDataList = getInstanceControllerDataListByControllerUniqueId(morphControllerUniqueId);
 
 			// Set the InstanciatedObjectId of the instance controller
@@ -233,6 +706,16 @@ namespace COLLADASaxFWL
 			COLLADAFW::AnimationList* animationList = it->second;
 			writer()->writeAnimationList( animationList );
 		}
+
+		if ( releaseWrittenObjects() )
+		{
+			for ( it = mUniqueIdAnimationListMap.begin(); it != mUniqueIdAnimationListMap.end(); ++it )
+			{
+				FW_DELETE it->second;
+			}
+			mUniqueIdAnimationListMap.clear();
+			mMemoryUsage.release( MemoryUsage::ANIMATION_LISTS );
+		}
 	}
 
 	//-----------------------------
@@ -248,6 +731,12 @@ namespace COLLADASaxFWL
 		}
 
 		FormulasLinker formulasLinker(this, formulaList);
+
+		// resolve the parameters referenced in the formulas concurrently. Linking uses the resolved addresses
+		SidAddressPointerList parameterSidAddresses;
+		formulasLinker.collectParameterSidAddresses( parameterSidAddresses );
+		resolveSids( parameterSidAddresses, 0 );
+
 		formulasLinker.link();
 
 		writer()->writeFormulas(formulas);
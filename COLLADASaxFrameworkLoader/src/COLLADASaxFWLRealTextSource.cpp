@@ -0,0 +1,116 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADASaxFWLStableHeaders.h"
+#include "COLLADASaxFWLRealTextSource.h"
+
+#include "GeneratedSaxParserUtils.h"
+
+
+namespace COLLADASaxFWL
+{
+
+	/** Lazy values that decode a copy of the character data of a real array.*/
+	class RealTextLazyValues : public COLLADAFW::AnimationCurve::LazyValues
+	{
+	private:
+		/** The character data of the array.*/
+		String mText;
+
+		/** The number of values in mText.*/
+		size_t mValuesCount;
+
+		/** True, if the values are decoded to doubles, false if to floats.*/
+		bool mDoublePrecision;
+
+	public:
+		RealTextLazyValues( const String& text, bool doublePrecision )
+			: mText( text )
+			, mValuesCount( 0 )
+			, mDoublePrecision( doublePrecision )
+		{
+			bool inValue = false;
+			for ( size_t i = 0, length = mText.length(); i < length; ++i )
+			{
+				bool isWhiteSpace = GeneratedSaxParser::Utils::isWhiteSpace( mText[i] );
+				if ( !isWhiteSpace && !inValue )
+					++mValuesCount;
+				inValue = !isWhiteSpace;
+			}
+		}
+
+		virtual size_t getValuesCount() const { return mValuesCount; }
+
+		virtual void decode( COLLADAFW::FloatOrDoubleArray& values ) const
+		{
+			if ( mDoublePrecision )
+			{
+				values.setType( COLLADAFW::FloatOrDoubleArray::DATA_TYPE_DOUBLE );
+				decodeValues<double>( values );
+			}
+			else
+			{
+				values.setType( COLLADAFW::FloatOrDoubleArray::DATA_TYPE_FLOAT );
+				decodeValues<float>( values );
+			}
+		}
+
+	private:
+		/** Converts the character data to values of type @a T and appends them to @a values.*/
+		template<class T>
+		void decodeValues( COLLADAFW::FloatOrDoubleArray& values ) const
+		{
+			COLLADAFW::ArrayPrimitiveType<T> realValues( COLLADAFW::ArrayPrimitiveType<T>::OWNER );
+			realValues.reallocMemory( mValuesCount );
+
+			const ParserChar* buffer = mText.c_str();
+			bool failed = false;
+			while ( realValues.getCount() < mValuesCount )
+			{
+				T value = toValue<T>( &buffer, failed );
+				if ( failed )
+					break;
+				realValues.append( value );
+			}
+			values.appendValues( realValues );
+		}
+
+		template<class T>
+		static T toValue( const ParserChar** buffer, bool& failed );
+	};
+
+	//------------------------------
+	template<>
+	float RealTextLazyValues::toValue<float>( const ParserChar** buffer, bool& failed )
+	{
+		return GeneratedSaxParser::Utils::toFloat( buffer, failed );
+	}
+
+	//------------------------------
+	template<>
+	double RealTextLazyValues::toValue<double>( const ParserChar** buffer, bool& failed )
+	{
+		return GeneratedSaxParser::Utils::toDouble( buffer, failed );
+	}
+
+	//------------------------------
+	bool RealTextSource::textData( const ParserChar* text, size_t textLength )
+	{
+		mText.append( text, textLength );
+		return true;
+	}
+
+	//------------------------------
+	COLLADAFW::AnimationCurve::LazyValues* RealTextSource::createLazyValues( bool doublePrecision ) const
+	{
+		return new RealTextLazyValues( mText, doublePrecision );
+	}
+
+} // namespace COLLADASaxFWL
@@ -104,6 +104,11 @@ namespace COLLADASaxFWL
     bool RootParser14::begin__geometry( const COLLADASaxFWL14::geometry__AttributeData& attributeData )
     {
         SaxVirtualFunctionTest14(begin__geometry(attributeData));
+		if ( !mFileLoader->getGeometryIdFilter().accepts( attributeData.id ) )
+		{
+			mFileLoader->skipCurrentElement();
+			return true;
+		}
 		GeometryLoader* geometryLoader = beginCommonWithId<GeometryLoader, GeometryLoader14>(attributeData.id);
         if ( attributeData.name )
             geometryLoader->setGeometryName (attributeData.name);
@@ -110,6 +110,11 @@ namespace COLLADASaxFWL
     bool RootParser15::begin__geometry( const COLLADASaxFWL15::geometry__AttributeData& attributeData )
     {
         SaxVirtualFunctionTest15(begin__geometry(attributeData));
+		if ( !mFileLoader->getGeometryIdFilter().accepts( attributeData.id ) )
+		{
+			mFileLoader->skipCurrentElement();
+			return true;
+		}
 		GeometryLoader* geometryLoader = beginCommonWithId<GeometryLoader, GeometryLoader15>(attributeData.id);
 		if ( attributeData.name )
 			geometryLoader->setGeometryName (attributeData.name);
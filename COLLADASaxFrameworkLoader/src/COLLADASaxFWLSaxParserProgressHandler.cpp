@@ -0,0 +1,40 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License, 
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADASaxFWLStableHeaders.h"
+#include "COLLADASaxFWLSaxParserProgressHandler.h"
+#include "COLLADASaxFWLIProgressHandler.h"
+
+
+namespace COLLADASaxFWL
+{
+
+    //------------------------------
+	SaxParserProgressHandler::SaxParserProgressHandler( COLLADASaxFWL::IProgressHandler* progressHandler, COLLADAFW::FileId fileId )
+		: mProgressHandler(progressHandler)
+		, mFileId(fileId)
+	{
+	}
+
+    //------------------------------
+	SaxParserProgressHandler::~SaxParserProgressHandler()
+	{
+	}
+
+    //------------------------------
+	bool SaxParserProgressHandler::handleProgress( size_t bytesConsumed, size_t totalBytes, const GeneratedSaxParser::ParserChar* topLevelElementName )
+	{
+		if ( mProgressHandler )
+			return mProgressHandler->handleProgress( bytesConsumed, totalBytes, mFileId, topLevelElementName );
+		else
+			return true;
+	}
+
+} // namespace COLLADASaxFWL
@@ -10,15 +10,11 @@ http://www.opensource.org/licenses/mit-license.php
 
 #include "COLLADASaxFWLStableHeaders.h"
 #include "COLLADASaxFWLSidAddress.h"
-#include "COLLADABUPcreCompiledPattern.h"
-
-#include "pcre.h"
 
 
 namespace COLLADASaxFWL
 {
 
-	const int regExpMatchesVectorLength = 30;    /* should be a multiple of 3 */
 	const char* sidSeparator = "/";
 
 	//------------------------------
@@ -108,143 +104,149 @@ namespace COLLADASaxFWL
 		}
 
 		const char * secondPart = sidAddress.c_str() + lastSidSeparator + 1;
-		int secondPartLength = (int)sidAddress.length() - (int)lastSidSeparator - 1;
+		const char * secondPartEnd = sidAddress.c_str() + sidAddress.length();
 
+		// first try the name accessor
+		// hand written equivalent of the regular expression "(.+)\.(.+)"
+		const char* idOrSidBegin = 0;
+		const char* idOrSidEnd = 0;
+		if ( findNameAccessor( secondPart, secondPartEnd, idOrSidBegin, idOrSidEnd ) )
+		{
+			// idOrSidEnd points to the '.', the name ends at the end of the line
+			const char* nameBegin = idOrSidEnd + 1;
+			const char* nameEnd = nameBegin;
+			while ( (nameEnd != secondPartEnd) && (*nameEnd != '\n') )
+				++nameEnd;
+
+			addIdOrSid( idOrSidBegin, idOrSidEnd, hasId );
+			mMemberSelectionName.assign( nameBegin, nameEnd );
+			mMemberSelection = MEMBER_SELECTION_NAME;
 
-		// regular expression: "(.+)\.(.+)"
-		static const COLLADABU::PcreCompiledPattern accessorNameRegexCompiledPattern("(.+)\\.(.+)");
-		pcre* accessorNameRegex = accessorNameRegexCompiledPattern.getCompiledPattern();
+			mIsValid = true;
+			return;
+		}
 
-		int accessorNameMatches[regExpMatchesVectorLength];
+		// check all other cases
+		// hand written equivalent of the regular expression "([^(]+)(?:\(([0-9]+)\))?(?:\(([0-9]+)\))?"
+		// the first match is id or sid. It starts at the first character that is not a '('.
+		idOrSidBegin = secondPart;
+		while ( (idOrSidBegin != secondPartEnd) && (*idOrSidBegin == '(') )
+			++idOrSidBegin;
 
+		if ( idOrSidBegin == secondPartEnd )
+		{
+			mIsValid = false;
+			return;
+		}
 
-		int  accessorNameResult = pcre_exec(
-											accessorNameRegex,			/* the compiled pattern */
-											0,							/* no extra data - we didn't study the pattern */
-											secondPart,					/* the subject string */
-											secondPartLength,			/* the length of the subject */
-											0,							/* start at offset 0 in the subject */
-											0,							/* default options */
-											accessorNameMatches,		/* output vector for substring information */
-											regExpMatchesVectorLength);	/* number of elements in the output vector */
+		idOrSidEnd = idOrSidBegin;
+		while ( (idOrSidEnd != secondPartEnd) && (*idOrSidEnd != '(') )
+			++idOrSidEnd;
 
+		addIdOrSid( idOrSidBegin, idOrSidEnd, hasId );
+		mMemberSelection = MEMBER_SELECTION_NONE;
 
-		if ( accessorNameResult >= 0 )
+		// the optional first and second index
+		const char* indexBegin = 0;
+		const char* indexEnd = 0;
+		const char* pos = idOrSidEnd;
+		if ( findIndexAccessor( pos, secondPartEnd, indexBegin, indexEnd ) )
 		{
-			// first try the name accessor
-			// this matches only, if the name accessor is present. Therefor there are exactly two matches 
-			int idOrSidStart = accessorNameMatches[2*1];
-			int idOrSidEnd = accessorNameMatches[2*1+1];
-			COLLADABU_ASSERT( idOrSidStart >= 0 );
-			if ( idOrSidStart >= 0 )
+			mMemberSelection = MEMBER_SELECTION_ONE_INDEX;
+			bool failed = false;
+			const char* bufferBegin = indexBegin;
+			mFirstIndex = (size_t)GeneratedSaxParser::Utils::toUint32(&bufferBegin, indexEnd, failed);
+			if ( failed )
 			{
-				if ( hasId )
-				{
-					mSids.push_back(String( secondPart + idOrSidStart, idOrSidEnd - idOrSidStart));
-				}
-				else
-				{
-					if ( secondPart[idOrSidStart] != '.' )
-						mId.assign(secondPart + idOrSidStart, idOrSidEnd - idOrSidStart);
-					hasId = true;
-				}
+				mIsValid = false;
+				return;
 			}
 
-			int& nameStart = accessorNameMatches[2*2];
-			int& nameEnd = accessorNameMatches[2*2+1];
-			COLLADABU_ASSERT(nameStart>=0);
-			if ( nameStart>=0 )
+			pos = indexEnd + 1;
+			if ( findIndexAccessor( pos, secondPartEnd, indexBegin, indexEnd ) )
 			{
-				mMemberSelectionName.assign(secondPart + nameStart, nameEnd - nameStart);
+				bool failed = false;
+				const char* bufferBegin = indexBegin;
+				size_t index = (size_t)GeneratedSaxParser::Utils::toUint32(&bufferBegin, indexEnd, failed);
+
+				mMemberSelection = MEMBER_SELECTION_TWO_INDICES;
+				mSecondIndex = index;
+				if ( failed )
+				{
+					mIsValid = false;
+					return;
+				}
 			}
+		}
 
-			mMemberSelection = MEMBER_SELECTION_NAME;
+		mIsValid = true;
+	}
 
-			mIsValid = true;
+	//------------------------------
+	void SidAddress::addIdOrSid( const char* begin, const char* end, bool& hasId )
+	{
+		if ( hasId )
+		{
+			mSids.push_back(String( begin, end ));
 		}
-		else 
+		else
 		{
-			// regular expression: "([^(]+)(?:\(([0-9]+)\))?(?:\(([0-9]+)\))?"
-			static const COLLADABU::PcreCompiledPattern accessorIndexRegexCompiledPattern("([^(]+)(?:\\(([0-9]+)\\))?(?:\\(([0-9]+)\\))?");
-			pcre* accessorIndexRegex = accessorIndexRegexCompiledPattern.getCompiledPattern();
-
-			int accessorIndexMatches[regExpMatchesVectorLength];
-
-			int  accessorIndexResult = pcre_exec(
-				accessorIndexRegex,			/* the compiled pattern */
-				0,							/* no extra data - we didn't study the pattern */
-				secondPart,					/* the subject string */
-				secondPartLength,			/* the length of the subject */
-				0,							/* start at offset 0 in the subject */
-				0,							/* default options */
-				accessorIndexMatches,		/* output vector for substring information */
-				regExpMatchesVectorLength);
-
-			if ( accessorIndexResult >= 0 )
-			{
-				//check all other cases
-				// the first match is id or sid
-				int& idOrSidStart = accessorIndexMatches[2*1];
-				int& idOrSidEnd = accessorIndexMatches[2*1+1];
-				COLLADABU_ASSERT( idOrSidStart >= 0 );
-
-				if ( idOrSidStart >= 0 )
-				{
-					if ( hasId )
-					{
-						mSids.push_back(String( secondPart + idOrSidStart, idOrSidEnd - idOrSidStart));
-					}
-					else
-					{
-						if ( secondPart[idOrSidStart] != '.' )
-							mId.assign(secondPart + idOrSidStart, idOrSidEnd - idOrSidStart);
-						hasId = true;
-					}
-				}
-				mMemberSelection = MEMBER_SELECTION_NONE;
+			if ( *begin != '.' )
+				mId.assign( begin, end );
+			hasId = true;
+		}
+	}
 
-				// this one matches only if two indices are specified. In case of one index, only the next matches
-				int& firstIndexStart = accessorIndexMatches[2*2];
-				int& firstIndexEnd = accessorIndexMatches[2*2+1];
-				if ( firstIndexStart >= 0)
-				{
-					mMemberSelection = MEMBER_SELECTION_ONE_INDEX;
-					bool failed = false;
-					const char* bufferBegin = secondPart + firstIndexStart;
-					mFirstIndex = (size_t)GeneratedSaxParser::Utils::toUint32(&bufferBegin, secondPart + firstIndexEnd, failed);
-					if ( failed )
-					{
-						mIsValid = false;
-						return;
-					}
-				}
+	//------------------------------
+	bool SidAddress::findNameAccessor( const char* begin, const char* end, const char*& idOrSidBegin, const char*& idOrSidEnd )
+	{
+		// As in the regular expression "(.+)\.(.+)", '.' does not match a line feed. The leftmost line that
+		// contains a '.' with at least one character in front of and behind it matches. Within that
+		// line, the last such '.' separates the id or sid from the name.
+		const char* lineBegin = begin;
+		while ( lineBegin != end )
+		{
+			const char* lineEnd = lineBegin;
+			while ( (lineEnd != end) && (*lineEnd != '\n') )
+				++lineEnd;
 
-				// this one matches if two indices or only index are specified. 
-				int& secondIndexStart = accessorIndexMatches[2*3];
-				int& secondIndexEnd = accessorIndexMatches[2*3+1];
-				if ( secondIndexStart >= 0)
+			if ( lineEnd - lineBegin >= 3 )
+			{
+				for ( const char* dot = lineEnd - 2; dot != lineBegin; --dot )
 				{
-					bool failed = false;
-					const char* bufferBegin = secondPart + secondIndexStart;
-					size_t index = (size_t)GeneratedSaxParser::Utils::toUint32(&bufferBegin, secondPart + secondIndexEnd, failed);
-					
-					mMemberSelection = MEMBER_SELECTION_TWO_INDICES;
-					mSecondIndex = index;
-					if ( failed )
+					if ( *dot == '.' )
 					{
-						mIsValid = false;
-						return;
+						idOrSidBegin = lineBegin;
+						idOrSidEnd = dot;
+						return true;
 					}
 				}
-
-				mIsValid = true;
-			}
-			else
-			{
-				mIsValid = false;
 			}
+
+			if ( lineEnd == end )
+				break;
+			lineBegin = lineEnd + 1;
 		}
+		return false;
+	}
+
+	//------------------------------
+	bool SidAddress::findIndexAccessor( const char* begin, const char* end, const char*& indexBegin, const char*& indexEnd )
+	{
+		// hand written equivalent of the regular expression "\(([0-9]+)\)" anchored at begin
+		if ( (begin == end) || (*begin != '(') )
+			return false;
+
+		const char* pos = begin + 1;
+		while ( (pos != end) && (*pos >= '0') && (*pos <= '9') )
+			++pos;
+
+		if ( (pos == begin + 1) || (pos == end) || (*pos != ')') )
+			return false;
 
+		indexBegin = begin + 1;
+		indexEnd = pos;
+		return true;
 	}
 
 	//------------------------------
@@ -12,32 +12,67 @@
 #include "COLLADASaxFWLSidTreeNode.h"
 
 #include <iostream>
+#include <new>
 
 namespace COLLADASaxFWL
 {
 
 
 	//------------------------------
-	bool SidTreeNode::SidIdentifier::operator<( const SidIdentifier& rhs ) const
+	SidTreeNode::NodeArena::NodeArena()
+		: mNodesInLastBlock(NODES_PER_BLOCK)
 	{
-		if ( sid < rhs.sid)
-			return true;
-
-		if ( sid > rhs.sid)
-			return false;
+	}
 
-		if ( hierarchyLevel < rhs.hierarchyLevel)
-			return true;
+	//------------------------------
+	SidTreeNode::NodeArena::~NodeArena()
+	{
+		for ( size_t i = 0, count = mBlocks.size(); i < count; ++i)
+		{
+			SidTreeNode* block = mBlocks[i];
+			size_t nodesInBlock = (i == count - 1) ? mNodesInLastBlock : NODES_PER_BLOCK;
+			for ( size_t j = 0; j < nodesInBlock; ++j)
+			{
+				block[j].~SidTreeNode();
+			}
+			::operator delete(block);
+		}
+	}
 
-		if ( hierarchyLevel > rhs.hierarchyLevel)
-			return false;
+	//------------------------------
+	SidTreeNode* SidTreeNode::NodeArena::createNode( const String& sid, SidTreeNode* parent )
+	{
+		if ( mNodesInLastBlock == NODES_PER_BLOCK )
+		{
+			mBlocks.push_back( static_cast<SidTreeNode*>(::operator new(NODES_PER_BLOCK * sizeof(SidTreeNode))) );
+			mNodesInLastBlock = 0;
+		}
+		SidTreeNode* newNode = new (mBlocks.back() + mNodesInLastBlock) SidTreeNode(sid, parent);
+		mNodesInLastBlock++;
+		return newNode;
+	}
 
-		return false;
+	//------------------------------
+	void SidTreeNode::NodeArena::releaseChildrenOfReleasedNodes()
+	{
+		// each node is created after its parent, i.e. the parent has been visited before its children
+		for ( size_t i = 0, count = mBlocks.size(); i < count; ++i)
+		{
+			SidTreeNode* block = mBlocks[i];
+			size_t nodesInBlock = (i == count - 1) ? mNodesInLastBlock : NODES_PER_BLOCK;
+			for ( size_t j = 0; j < nodesInBlock; ++j)
+			{
+				SidTreeNode& node = block[j];
+				if ( node.mParent && node.mParent->isReleased() )
+					node.release();
+			}
+		}
 	}
 
 	//------------------------------
 	SidTreeNode::SidTreeNode(const String& sid, SidTreeNode *parent)
 		: mParent(parent)
+		, mArena( parent ? parent->mArena : new NodeArena() )
 		, mTargetType(TARGETTYPECLASS_UNKNOWN)
 		, mSid(sid)
 	{
@@ -47,65 +82,72 @@ namespace COLLADASaxFWL
 	//------------------------------
 	SidTreeNode::~SidTreeNode()
 	{
-		for ( size_t i = 0, count = mDirectChildren.size(); i < count; ++i)
+		// all the other nodes are owned by the arena of the root node
+		if ( !mParent )
 		{
-			const SidTreeNode*const& sidTreeNode = mDirectChildren[i];
-			delete sidTreeNode;
+			delete mArena;
 		}
 	}
 
 	//------------------------------
 	SidTreeNode* SidTreeNode::createAndAddChild( const String& sid )
 	{
-		SidTreeNode* newChild = new SidTreeNode(sid, this);
-		mDirectChildren.push_back(newChild);
+		SidTreeNode* newChild = mArena->createNode(sid, this);
 		if ( !sid.empty() )
 		{
-			SidIdentifier newIdentifier(newChild->getSid(), 0);
-			mChildren.insert(std::make_pair(newIdentifier, newChild));
-			addChildToParents( newChild, newIdentifier );
+			addChild( newChild, 0 );
+			addChildToParents( newChild, 0 );
 		}
 		return newChild;
 	}
 
 	//------------------------------
-	void SidTreeNode::addChildToParents( SidTreeNode *sidTreeNode, const SidIdentifier& sidIdentifier )
+	void SidTreeNode::addChild( SidTreeNode *sidTreeNode, size_t hierarchyLevel )
+	{
+		std::pair<SidStringSidTreeNodeMap::iterator, bool> inserted = 
+			mChildren.insert(std::make_pair(sidTreeNode->getSid(), SidTreeNodeAndLevel(sidTreeNode, hierarchyLevel)));
+		if ( !inserted.second && (hierarchyLevel < inserted.first->second.hierarchyLevel) )
+		{
+			inserted.first->second = SidTreeNodeAndLevel(sidTreeNode, hierarchyLevel);
+		}
+	}
+
+	//------------------------------
+	void SidTreeNode::addChildToParents( SidTreeNode *sidTreeNode, size_t hierarchyLevel )
 	{
 		if ( sidTreeNode )
 		{
 			SidTreeNode *parent = getParent();
 			if ( parent )
 			{
-				SidIdentifier parentSidIdentifier = sidIdentifier;
+				size_t parentHierarchyLevel = hierarchyLevel;
 				// if the parent has no sid, i.e. it has an id, we don't increase the hierarchy level.*/
 				if ( !parent->getSid().empty() )
 				{
-					parentSidIdentifier.hierarchyLevel++;
+					parentHierarchyLevel++;
 				}
-				parent->mChildren.insert(std::make_pair(parentSidIdentifier, sidTreeNode));
-				parent->addChildToParents( sidTreeNode, parentSidIdentifier );
+				parent->addChild( sidTreeNode, parentHierarchyLevel );
+				parent->addChildToParents( sidTreeNode, parentHierarchyLevel );
 			}
 		}
 	}
 
 	//------------------------------
-	SidTreeNode* SidTreeNode::findChildBySid( const String& sid )
+	void SidTreeNode::releaseSubHierarchies()
 	{
-		SidIdentifier lowerBound( sid, 0);
-		SidIdentifierSidTreeNodeMap::iterator it = mChildren.lower_bound( lowerBound );
+		COLLADABU_ASSERT( !mParent );
+		mArena->releaseChildrenOfReleasedNodes();
+	}
+
+	//------------------------------
+	SidTreeNode* SidTreeNode::findChildBySid( const String& sid ) const
+	{
+		SidStringSidTreeNodeMap::const_iterator it = mChildren.find( sid );
 
 		if ( it == mChildren.end() )
 			return 0;
 
-		SidIdentifier canidate = it->first;
-		if ( canidate.sid == sid )
-		{
-			return it->second;
-		}
-		else
-		{
-			return 0;
-		}
+		return it->second.sidTreeNode;
 	}
 
 } // namespace COLLADASaxFWL
@@ -10,6 +10,8 @@
 
 #include "COLLADASaxFWLStableHeaders.h"
 #include "COLLADASaxFWLSourceArrayLoader.h"
+#include "COLLADASaxFWLDoubleTextSource.h"
+#include "COLLADASaxFWLFileLoader.h"
 #include "COLLADAFWTypes.h"
 
 namespace COLLADASaxFWL
@@ -38,16 +40,25 @@ namespace COLLADASaxFWL
 
 	/** Copies the values contained in @a realSource into @a realsArray .*/
 	//------------------------------
-	void SourceArrayLoader::setRealValues( COLLADAFW::FloatOrDoubleArray& realsArray, const RealSource* realSource )
+	void SourceArrayLoader::setRealValues( COLLADAFW::FloatOrDoubleArray& realsArray, const SourceBase* realSource )
 	{
 		if ( !realsArray.empty() )
 		{
 			// There already must have been an input with semantic INPUT. We ignore all following.
 			return;
 		}
-		realsArray.setType( SourceArrayLoader::DATA_TYPE_REAL );
-		const RealArrayElement& realArrayElement = realSource->getArrayElement();
-		realsArray.appendValues(realArrayElement.getValues());
+		if ( realSource->getDataType() == SourceBase::DATA_TYPE_DOUBLE )
+		{
+			realsArray.setType( COLLADAFW::FloatOrDoubleArray::DATA_TYPE_DOUBLE );
+			const DoubleArrayElement& doubleArrayElement = ((const DoubleSource*)realSource)->getArrayElement();
+			realsArray.appendValues(doubleArrayElement.getValues());
+		}
+		else
+		{
+			realsArray.setType( COLLADAFW::FloatOrDoubleArray::DATA_TYPE_FLOAT );
+			const FloatArrayElement& floatArrayElement = ((const FloatSource*)realSource)->getArrayElement();
+			realsArray.appendValues(floatArrayElement.getValues());
+		}
 	}
 
 
@@ -172,13 +183,31 @@ namespace COLLADASaxFWL
 	//------------------------------
 	bool SourceArrayLoader::begin__float_array( const float_array__AttributeData& attributeData )
 	{
+		if ( getRealPrecision() == Loader::DOUBLE_PRECISION )
+		{
+			// the parser converts float arrays to floats. To not lose precision, we convert the 
+			// character data ourselves
+			DoubleTextSource* source = beginArray<DoubleTextSource>( attributeData.count, attributeData.id );
+			if ( !source )
+				return false;
+			getFileLoader()->redirectCurrentElementTextData( source );
+			return true;
+		}
 		return beginArray<FloatSource>( attributeData.count, attributeData.id ) != 0;
 	}
 
 	//------------------------------
 	bool SourceArrayLoader::end__float_array()
 	{
-		// we don't need to do anything here
+		if ( mCurrentSoure && (mCurrentSoure->getDataType() == SourceBase::DATA_TYPE_DOUBLE) )
+		{
+			DoubleTextSource* source = (DoubleTextSource*)mCurrentSoure;
+			if ( !source->convertText() )
+			{
+				String msg = "Float array \"" + mCurrentArrayId + "\" contains invalid values.";
+				return !handleFWLError( SaxFWLError::ERROR_DATA_NOT_VALID, msg );
+			}
+		}
 		return true;
 	}
 
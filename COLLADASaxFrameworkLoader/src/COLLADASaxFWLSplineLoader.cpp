@@ -462,4 +462,10 @@ namespace COLLADASaxFWL
         }
     }
 
+    //------------------------------
+    Loader::RealPrecision SplineLoader::getRealPrecision() const
+    {
+        return getColladaLoader()->getRealPrecision( Loader::GEOMETRY_DATA );
+    }
+
 } // namespace COLLADASaxFWL
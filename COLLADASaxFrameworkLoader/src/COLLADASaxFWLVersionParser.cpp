@@ -305,6 +305,9 @@ namespace COLLADASaxFWL
         , mFileLoader( fileLoader )
         , mFlags( flags )
         , mParsedFlags( parsedFlags )
+        , mProgressHandler( 0 )
+        , mProgressInterval( 0 )
+        , mCancelled( false )
     {
 
     }
@@ -326,7 +329,10 @@ namespace COLLADASaxFWL
 #elif defined(GENERATEDSAXPARSER_XMLPARSER_EXPAT)
         GeneratedSaxParser::ExpatSaxParser versionSaxParser( this, XMLPARSER_BUFFERSIZE );
 #endif
+        if ( mProgressHandler )
+            versionSaxParser.setProgressHandler( mProgressHandler, mProgressInterval );
         bool success = versionSaxParser.parseFile( fileName );
+        mCancelled = versionSaxParser.isCancelled();
 
  //       mFileLoader->postProcess();
 
@@ -350,7 +356,10 @@ namespace COLLADASaxFWL
 #elif defined(GENERATEDSAXPARSER_XMLPARSER_EXPAT)
         GeneratedSaxParser::ExpatSaxParser versionSaxParser( this, XMLPARSER_BUFFERSIZE );
 #endif
+        if ( mProgressHandler )
+            versionSaxParser.setProgressHandler( mProgressHandler, mProgressInterval );
         bool success = versionSaxParser.parseBuffer( uriString, buffer, length );
+        mCancelled = versionSaxParser.isCancelled();
         
         //       mFileLoader->postProcess();
         
@@ -363,6 +372,13 @@ namespace COLLADASaxFWL
         return success;
     }
     
+    //------------------------------
+    void VersionParser::setProgressHandler( GeneratedSaxParser::IProgressHandler* progressHandler, size_t progressInterval )
+    {
+        mProgressHandler = progressHandler;
+        mProgressInterval = progressInterval;
+    }
+
     //------------------------------
     bool VersionParser::elementBegin( const ParserChar* elementName, const ParserAttributes& attributes )
     {
@@ -482,4 +498,30 @@ namespace COLLADASaxFWL
 		}
 		return 0;
 	}
+
+	//------------------------------
+	void VersionParser::skipCurrentElement()
+	{
+		if ( mPrivateParser14 )
+		{
+			mPrivateParser14->skipCurrentElement();
+		}
+		if ( mPrivateParser15 )
+		{
+			mPrivateParser15->skipCurrentElement();
+		}
+	}
+
+	//------------------------------
+	void VersionParser::redirectCurrentElementTextData( GeneratedSaxParser::ITextDataHandler* handler )
+	{
+		if ( mPrivateParser14 )
+		{
+			mPrivateParser14->redirectCurrentElementTextData( handler );
+		}
+		if ( mPrivateParser15 )
+		{
+			mPrivateParser15->redirectCurrentElementTextData( handler );
+		}
+	}
 }
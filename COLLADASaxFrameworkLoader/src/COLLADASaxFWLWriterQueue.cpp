@@ -0,0 +1,198 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADASaxFWLStableHeaders.h"
+#include "COLLADASaxFWLWriterQueue.h"
+#include "COLLADASaxFWLBinaryCacheLoader.h"
+
+
+namespace COLLADASaxFWL
+{
+
+	//------------------------------
+	WriterQueue::WriterQueue( COLLADAFW::IWriter* writer, size_t maxQueuedBytes )
+		: mWriter(writer)
+		, mMaxQueuedBytes(maxQueuedBytes)
+		, mQueuedBytes(0)
+		, mExecutingCount(0)
+		, mStopping(false)
+		, mSynchronousSuccess(true)
+		, mSuccess(true)
+		, mFirstFailedRecordType(BinaryCacheFormat::RECORD_END)
+	{
+	}
+
+	//------------------------------
+	WriterQueue::~WriterQueue()
+	{
+		dropObjects();
+		stopThreads();
+	}
+
+	//------------------------------
+	void WriterQueue::startThreads( size_t threadCount )
+	{
+		if ( threadCount == 0 )
+			threadCount = 1;
+		mStopping = false;
+		mThreads.reserve( threadCount );
+		for ( size_t i = 0; i < threadCount; ++i )
+			mThreads.push_back( std::thread( &WriterQueue::work, this ) );
+	}
+
+	//------------------------------
+	void WriterQueue::stopThreads()
+	{
+		{
+			std::lock_guard<std::mutex> lock( mMutex );
+			mStopping = true;
+		}
+		mTaskQueued.notify_all();
+		for ( size_t i = 0; i < mThreads.size(); ++i )
+			mThreads[i].join();
+		mThreads.clear();
+	}
+
+	//------------------------------
+	void WriterQueue::work()
+	{
+		std::unique_lock<std::mutex> lock( mMutex );
+		for ( ;; )
+		{
+			while ( mTasks.empty() && !mStopping )
+				mTaskQueued.wait( lock );
+			if ( mTasks.empty() )
+				return;
+
+			Task task = mTasks.front();
+			mTasks.pop_front();
+			++mExecutingCount;
+
+			// the writer is called without holding the lock
+			lock.unlock();
+			bool success = execute( task );
+			size_t size = task.getSize();
+			task.payload.reset();
+			lock.lock();
+
+			if ( task.synchronous )
+				mSynchronousSuccess = success;
+			if ( !success && mSuccess )
+			{
+				mSuccess = false;
+				mFirstFailedRecordType = task.recordType;
+			}
+			mQueuedBytes -= size;
+			--mExecutingCount;
+			mTaskExecuted.notify_all();
+		}
+	}
+
+	//------------------------------
+	bool WriterQueue::execute( const Task& task )
+	{
+		bool success = true;
+		switch ( task.type )
+		{
+		case TASK_START:
+			mWriter->start();
+			break;
+		case TASK_RECORD:
+			BinaryCacheLoader::loadPayload( task.recordType, task.payload->empty() ? 0 : &(*task.payload)[0],
+				task.payload->size(), mWriter, success );
+			break;
+		case TASK_OBJECT:
+			success = task.writeFunction( mWriter, task.object );
+			break;
+		case TASK_CANCEL:
+			mWriter->cancel( task.errorMessage );
+			break;
+		case TASK_FINISH:
+			mWriter->finish();
+			break;
+		}
+		return success;
+	}
+
+	//------------------------------
+	void WriterQueue::push( const Task& task, bool bounded )
+	{
+		size_t size = task.getSize();
+		{
+			std::unique_lock<std::mutex> lock( mMutex );
+			while ( bounded && (mQueuedBytes != 0) && (mQueuedBytes + size > mMaxQueuedBytes) )
+				mTaskExecuted.wait( lock );
+			mTasks.push_back( task );
+			mQueuedBytes += size;
+		}
+		mTaskQueued.notify_one();
+	}
+
+	//------------------------------
+	void WriterQueue::waitUntilIdle()
+	{
+		std::unique_lock<std::mutex> lock( mMutex );
+		while ( !mTasks.empty() || (mExecutingCount != 0) )
+			mTaskExecuted.wait( lock );
+	}
+
+	//------------------------------
+	void WriterQueue::dropObjects()
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+		std::deque<Task> keptTasks;
+		for ( size_t i = 0; i < mTasks.size(); ++i )
+		{
+			const Task& task = mTasks[i];
+			if ( (task.type == TASK_RECORD) || (task.type == TASK_OBJECT) )
+				mQueuedBytes -= task.getSize();
+			else
+				keptTasks.push_back( task );
+		}
+		mTasks.swap( keptTasks );
+	}
+
+	//------------------------------
+	size_t WriterQueue::getPendingCount() const
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+		return mTasks.size() + mExecutingCount;
+	}
+
+	//------------------------------
+	bool WriterQueue::getSynchronousSuccess() const
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+		return mSynchronousSuccess;
+	}
+
+	//------------------------------
+	bool WriterQueue::getSuccess() const
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+		return mSuccess;
+	}
+
+	//------------------------------
+	BinaryCacheFormat::RecordType WriterQueue::getFirstFailedRecordType() const
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+		return mFirstFailedRecordType;
+	}
+
+	//------------------------------
+	void WriterQueue::resetSuccess()
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+		mSuccess = true;
+		mFirstFailedRecordType = BinaryCacheFormat::RECORD_END;
+	}
+
+} // namespace COLLADASaxFWL
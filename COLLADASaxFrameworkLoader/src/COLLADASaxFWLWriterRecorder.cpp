@@ -0,0 +1,51 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADASaxFWLStableHeaders.h"
+#include "COLLADASaxFWLWriterRecorder.h"
+
+#include <cstdio>
+
+
+namespace COLLADASaxFWL
+{
+
+	//------------------------------
+	WriterRecorder::WriterRecorder( COLLADAFW::IWriter* writer, const String& spillFileName )
+		: BinaryCacheWriter( spillFileName, writer )
+		, mSpillFileName(spillFileName)
+	{
+	}
+
+	//------------------------------
+	WriterRecorder::~WriterRecorder()
+	{
+		if ( !mSpillFileName.empty() && isCacheWritten() )
+			remove( mSpillFileName.c_str() );
+	}
+
+	//------------------------------
+	bool WriterRecorder::replay( COLLADAFW::IWriter* writer, const BinaryCacheLoader::RecordTypeList& recordTypes )
+	{
+		if ( !writer || !isRecorded() )
+			return false;
+
+		BinaryCacheLoader loader;
+		loader.setRequiredSourceKey( getSourceKey() );
+		loader.setRecordTypes( recordTypes );
+		if ( mSpillFileName.empty() )
+		{
+			const std::vector<char>& content = getContent();
+			return loader.loadContent( &content[0], content.size(), writer );
+		}
+		return loader.loadDocument( mSpillFileName, writer );
+	}
+
+} // namespace COLLADASAXFWL
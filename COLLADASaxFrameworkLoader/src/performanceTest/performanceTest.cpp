@@ -0,0 +1,74 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADASaxFWLStableHeaders.h"
+#include "performanceTest.h"
+#include "SidAddressUnitTest.h"
+
+#include "COLLADABUTimer.h"
+
+#include <iostream>
+
+
+using COLLADASaxFWL::String;
+using COLLADASaxFWL::SidAddress;
+
+namespace
+{
+	/** The number of times each sid address is parsed.*/
+	const size_t iterationCount = 250000;
+
+	/** Typical sid addresses of animation channels and kinematics bindings.*/
+	const char* sidAddresses[] =
+	{
+		"node-12/rotateX.ANGLE",
+		"skinCluster/joint3/transform(2)(3)",
+		"node-12/translate.X",
+		"kscene/kmodel/joint0/axis0"
+	};
+
+	const size_t sidAddressCount = sizeof(sidAddresses) / sizeof(sidAddresses[0]);
+}
+
+//------------------------------
+void performanceTest()
+{
+	String sidAddressStrings[sidAddressCount];
+	for ( size_t i = 0; i < sidAddressCount; ++i )
+		sidAddressStrings[i] = sidAddresses[i];
+
+	size_t checkSum = 0;
+
+	COLLADABU::Timer timer;
+	for ( size_t i = 0; i < iterationCount; ++i )
+	{
+		for ( size_t j = 0; j < sidAddressCount; ++j )
+		{
+			SidAddress sidAddress;
+			pcreParseSidAddress( sidAddressStrings[j], sidAddress );
+			checkSum += sidAddress.getSids().size();
+		}
+	}
+	double pcreTime = timer.getElapsedSeconds();
+
+	timer.restart();
+	for ( size_t i = 0; i < iterationCount; ++i )
+	{
+		for ( size_t j = 0; j < sidAddressCount; ++j )
+		{
+			SidAddress sidAddress( sidAddressStrings[j] );
+			checkSum += sidAddress.getSids().size();
+		}
+	}
+	double scannerTime = timer.getElapsedSeconds();
+
+	std::cout << iterationCount * sidAddressCount << " sid addresses (check sum " << checkSum << ")" << std::endl;
+	std::cout << "SidAddress   pcre: " << pcreTime << "s   scanner: " << scannerTime << "s" << std::endl;
+}
@@ -0,0 +1,251 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "COLLADASaxFWLStableHeaders.h"
+#include "SidAddressUnitTest.h"
+
+#include "GeneratedSaxParserUtils.h"
+
+#include "pcre.h"
+
+#include <iostream>
+
+
+using COLLADASaxFWL::String;
+using COLLADASaxFWL::SidAddress;
+
+namespace
+{
+	const int regExpMatchesVectorLength = 30;    /* should be a multiple of 3 */
+
+	/** The number of random strings compared.*/
+	const size_t randomTestCount = 2000000;
+
+	/** The maximum length of the random strings.*/
+	const size_t randomTestMaxLength = 14;
+
+	/** The characters of the random strings, the ones with a meaning in a sid address and some others.*/
+	const char randomTestCharacters[] = "ab./()09\n";
+
+	/** The number of differences printed.*/
+	const size_t maxReportedErrors = 10;
+
+	size_t errorCount = 0;
+
+	/** Compiles @a pattern. The compiled pattern is never freed.*/
+	pcre* compilePattern( const char* pattern )
+	{
+		const char* error = 0;
+		int errorOffset = 0;
+		return pcre_compile( pattern, 0, &error, &errorOffset, 0 );
+	}
+
+	/** Assigns [@a begin, @a end) to the id of @a result, if @a hasId is false, otherwise appends it to the
+	sids of @a result.*/
+	void addIdOrSid( const char* begin, const char* end, bool& hasId, SidAddress& result )
+	{
+		if ( hasId )
+		{
+			result.appendSid( String( begin, end - begin ) );
+		}
+		else
+		{
+			if ( *begin != '.' )
+				result.setId( String( begin, end - begin ) );
+			hasId = true;
+		}
+	}
+
+	/** Deterministic random numbers, independent of the rand() of the platform.*/
+	unsigned int nextRandom( unsigned int& state )
+	{
+		state = state * 1103515245u + 12345u;
+		return (state >> 16) & 0x7fff;
+	}
+
+	String escape( const String& string )
+	{
+		String escaped;
+		for ( size_t i = 0; i < string.length(); ++i )
+		{
+			if ( string[i] == '\n' )
+				escaped += "\\n";
+			else
+				escaped += string[i];
+		}
+		return escaped;
+	}
+
+	void testSidAddress( const String& sidAddressString )
+	{
+		SidAddress expected;
+		pcreParseSidAddress( sidAddressString, expected );
+		SidAddress actual( sidAddressString );
+
+		bool equal = (expected.isValid() == actual.isValid())
+			&& (expected.getId() == actual.getId())
+			&& (expected.getSids() == actual.getSids())
+			&& (expected.getMemberSelection() == actual.getMemberSelection())
+			&& (expected.getMemberSelectionName() == actual.getMemberSelectionName())
+			&& (expected.getFirstIndex() == actual.getFirstIndex())
+			&& (expected.getSecondIndex() == actual.getSecondIndex());
+		if ( equal )
+			return;
+
+		if ( errorCount < maxReportedErrors )
+		{
+			std::cout << "      don't match     \"" << escape(sidAddressString) << "\": \""
+				<< escape(actual.getSidAddressString()) << "\" and \"" << escape(expected.getSidAddressString()) << "\"" << std::endl;
+		}
+		++errorCount;
+	}
+}
+
+//------------------------------
+void pcreParseSidAddress( const String& sidAddress, SidAddress& result )
+{
+	size_t lastSidSeparator = sidAddress.find_last_of( '/' );
+
+	bool hasId = false;
+	if ( lastSidSeparator != String::npos )
+	{
+		size_t nextTokenIndex = 0;
+		size_t startPos = 0;
+		while ( nextTokenIndex != lastSidSeparator )
+		{
+			nextTokenIndex = sidAddress.find_first_of( '/', startPos );
+			if ( hasId )
+			{
+				result.appendSid( String( sidAddress, startPos, nextTokenIndex - startPos ) );
+			}
+			else
+			{
+				if ( sidAddress[startPos] != '.' )
+					result.setId( String( sidAddress, startPos, nextTokenIndex - startPos ) );
+				hasId = true;
+			}
+			startPos = nextTokenIndex + 1;
+		}
+	}
+
+	const char* secondPart = sidAddress.c_str() + lastSidSeparator + 1;
+	int secondPartLength = (int)sidAddress.length() - (int)lastSidSeparator - 1;
+
+	static pcre* accessorNameRegex = compilePattern( "(.+)\\.(.+)" );
+
+	int accessorNameMatches[regExpMatchesVectorLength];
+	int accessorNameResult = pcre_exec( accessorNameRegex, 0, secondPart, secondPartLength, 0, 0,
+		accessorNameMatches, regExpMatchesVectorLength );
+	if ( accessorNameResult >= 0 )
+	{
+		addIdOrSid( secondPart + accessorNameMatches[2], secondPart + accessorNameMatches[3], hasId, result );
+		result.setMemberSelectionName( String( secondPart + accessorNameMatches[4], accessorNameMatches[5] - accessorNameMatches[4] ) );
+		result.setMemberSelection( SidAddress::MEMBER_SELECTION_NAME );
+		result.setIsValid( true );
+		return;
+	}
+
+	static pcre* accessorIndexRegex = compilePattern( "([^(]+)(?:\\(([0-9]+)\\))?(?:\\(([0-9]+)\\))?" );
+
+	int accessorIndexMatches[regExpMatchesVectorLength];
+	int accessorIndexResult = pcre_exec( accessorIndexRegex, 0, secondPart, secondPartLength, 0, 0,
+		accessorIndexMatches, regExpMatchesVectorLength );
+	if ( accessorIndexResult < 0 )
+	{
+		result.setIsValid( false );
+		return;
+	}
+
+	addIdOrSid( secondPart + accessorIndexMatches[2], secondPart + accessorIndexMatches[3], hasId, result );
+	result.setMemberSelection( SidAddress::MEMBER_SELECTION_NONE );
+
+	// pcre_exec returns the number of the highest group set plus one, unset groups are -1
+	if ( (accessorIndexResult > 2) && (accessorIndexMatches[4] >= 0) )
+	{
+		result.setMemberSelection( SidAddress::MEMBER_SELECTION_ONE_INDEX );
+		bool failed = false;
+		const char* bufferBegin = secondPart + accessorIndexMatches[4];
+		result.setFirstIndex( (size_t)GeneratedSaxParser::Utils::toUint32( &bufferBegin, secondPart + accessorIndexMatches[5], failed ) );
+		if ( failed )
+		{
+			result.setIsValid( false );
+			return;
+		}
+	}
+
+	if ( (accessorIndexResult > 3) && (accessorIndexMatches[6] >= 0) )
+	{
+		bool failed = false;
+		const char* bufferBegin = secondPart + accessorIndexMatches[6];
+		result.setMemberSelection( SidAddress::MEMBER_SELECTION_TWO_INDICES );
+		result.setSecondIndex( (size_t)GeneratedSaxParser::Utils::toUint32( &bufferBegin, secondPart + accessorIndexMatches[7], failed ) );
+		if ( failed )
+		{
+			result.setIsValid( false );
+			return;
+		}
+	}
+
+	result.setIsValid( true );
+}
+
+//------------------------------
+size_t sidAddressUnitTest()
+{
+	std::cout << "sidAddressUnitTest()" << std::endl;
+
+	errorCount = 0;
+
+	const char* sidAddresses[] =
+	{
+		"",
+		"/",
+		".",
+		"./sid",
+		"node-12/rotateX.ANGLE",
+		"node-12/rotateX(3)",
+		"skinCluster/joint3/transform(2)(3)",
+		"skinCluster/joint3/transform(2)(3)(4)",
+		"id/sid.",
+		"id/.name",
+		"id/sid.a.b",
+		"id/sid(",
+		"id/sid()",
+		"id/sid(x)",
+		"id/(1)",
+		"id/sid(4294967296)",
+		"id//sid",
+		"id/sid/",
+		"a\nb.c",
+		"id/sid.na\nme",
+		"kscene/kmodel/joint0/axis0",
+		"./joint0/value"
+	};
+
+	for ( size_t i = 0; i < sizeof(sidAddresses) / sizeof(sidAddresses[0]); ++i )
+		testSidAddress( sidAddresses[i] );
+
+	unsigned int randomState = 2;
+	const size_t characterCount = sizeof(randomTestCharacters) - 1;
+	for ( size_t i = 0; i < randomTestCount; ++i )
+	{
+		size_t length = nextRandom( randomState ) % (randomTestMaxLength + 1);
+		String sidAddress;
+		if ( nextRandom( randomState ) % 3 == 0 )
+			sidAddress = "id/";
+		for ( size_t j = 0; j < length; ++j )
+			sidAddress += randomTestCharacters[nextRandom( randomState ) % characterCount];
+		testSidAddress( sidAddress );
+	}
+
+	std::cout << "compared " << sizeof(sidAddresses) / sizeof(sidAddresses[0]) + randomTestCount << " sid addresses, "
+		<< errorCount << " differences" << std::endl;
+	return errorCount;
+}
@@ -0,0 +1,19 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of COLLADASaxFrameworkLoader.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#include "SidAddressUnitTest.h"
+
+
+int main()
+{
+	size_t errorCount = sidAddressUnitTest();
+
+	return errorCount == 0 ? 0 : 1;
+}
@@ -98,6 +98,9 @@ namespace MathML
             /** Sets fragment itself. */
             virtual void setFragment( INode* fragment );
 
+            /** Returns the clone flags, that tell if the fragment and the parameters are owned. */
+            virtual CloneFlags getCloneFlags() const;
+
             /** Returns the count of arguments. */
             virtual unsigned int getArgc() const;
 
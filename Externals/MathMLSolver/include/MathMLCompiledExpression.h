@@ -0,0 +1,212 @@
+/******************************************************************************
+Copyright (c) 2007 netAllied GmbH, Tettnang
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following
+conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+******************************************************************************/
+
+#ifndef __MATHML_COMPILED_EXPRESSION_H__
+#define __MATHML_COMPILED_EXPRESSION_H__
+
+#include "MathMLSolverPrerequisites.h"
+
+#include "MathMLString.h"
+#include "MathMLASTNode.h"
+#include "MathMLASTConstantExpression.h"
+#include "MathMLSymbolTable.h"
+
+#include <vector>
+
+
+namespace MathML
+{
+    /** Forward Declarations. */
+    class ErrorHandler;
+    class CompilerVisitor;
+
+    /** A formula compiled to a flat list of register instructions, see CompilerVisitor.
+    @par The registers hold the inputs of the formula, the constants and the temporary values. Variables
+    are resolved to input slots when the formula is compiled and constant sub expressions are folded, such
+    that evaluating the formula does neither walk the tree nor look up symbols. The batch evaluation runs
+    each instruction over a block of input sets, which lets the compiler vectorize the arithmetic.
+    @par The results are the same as the ones of the EvaluatorVisitor, including the long and bool
+    semantics of ConstantExpression.
+    */
+    class _MATHML_SOLVER_EXPORT CompiledExpression
+    {
+        friend class CompilerVisitor;
+
+    public:
+        /** The operations of the instructions. */
+        enum OpCode
+        {
+            OP_ADD,
+            OP_SUB,
+            OP_MUL,
+            OP_DIV,
+            OP_LONG_DIV,
+            OP_NEG,
+            OP_NOT,
+            OP_EQ,
+            OP_NEQ,
+            OP_LT,
+            OP_LTE,
+            OP_GT,
+            OP_GTE,
+            OP_AND,
+            OP_OR,
+            OP_XOR,
+            OP_MIN,
+            OP_MAX,
+            OP_POW,
+            OP_SIN,
+            OP_COS,
+            OP_TAN,
+            OP_EXP,
+            OP_LOGN,
+            OP_ABS,
+            OP_FLOOR,
+            OP_CEILING,
+            OP_CALL
+        };
+
+        /** An instruction writing the result of an operation on one or two registers to a register. */
+        struct Instruction
+        {
+            /** The operation. */
+            OpCode opCode;
+
+            /** The register the result is written to. */
+            unsigned int result;
+
+            /** The register of the first operand. The index of the function call for OP_CALL. */
+            unsigned int operand1;
+
+            /** The register of the second operand, if any. */
+            unsigned int operand2;
+        };
+
+        /** A function of the symbol table that has no native operation. */
+        struct FunctionCall
+        {
+            /** The function. */
+            SymbolTable::FunctionPtr function;
+
+            /** The registers of the arguments. */
+            std::vector<unsigned int> arguments;
+
+            /** The types the arguments are passed with. */
+            std::vector<AST::ConstantExpression::Type> argumentTypes;
+        };
+
+        /** The number of input sets the batch evaluation runs each instruction over. */
+        static const size_t BLOCK_SIZE = 64;
+
+    private:
+        /** The number of inputs, stored in the first registers. */
+        size_t mInputCount;
+
+        /** The constants, stored in the registers following the inputs. */
+        std::vector<double> mConstants;
+
+        /** The number of all registers. */
+        size_t mRegisterCount;
+
+        /** The instructions, in execution order. */
+        std::vector<Instruction> mInstructions;
+
+        /** The function calls referenced by OP_CALL instructions. */
+        std::vector<FunctionCall> mFunctionCalls;
+
+        /** The register holding the result. */
+        unsigned int mResultRegister;
+
+        /** The type of the result. */
+        AST::ConstantExpression::Type mResultType;
+
+        /** Error handler passed to the called functions. */
+        ErrorHandler* mErrorHandler;
+
+    public:
+        /** C-tor. Creates an empty expression that evaluates to 0. */
+        CompiledExpression();
+
+        /** D-tor. */
+        virtual ~CompiledExpression();
+
+        /** Compiles the formula @a node, see CompilerVisitor.
+        @param node The root node of the formula.
+        @param inputNames The names of the variables passed to evaluate(), in the order of the inputs.
+        @param symbolTable The functions and the variables that are not inputs.
+        @param errorHandler Error handler, also passed to the called functions.
+        @return False, if the formula can not be compiled. It has to be evaluated with the
+        EvaluatorVisitor then and this expression is left empty.
+        */
+        bool compile( const AST::INode* node, const StringVector& inputNames, SymbolTable& symbolTable, ErrorHandler* errorHandler );
+
+        /** Removes all instructions. */
+        void clear();
+
+        /** Returns the number of inputs expected by evaluate(). */
+        size_t getInputCount() const { return mInputCount; }
+
+        /** Returns the number of instructions. */
+        size_t getInstructionCount() const { return mInstructions.size(); }
+
+        /** Returns the type of the result. */
+        AST::ConstantExpression::Type getResultType() const { return mResultType; }
+
+        /** Evaluates the expression for one set of inputs.
+        @param inputs The values of the inputs, in the order of the input names passed to compile().
+        @return The value of the result, see ConstantExpression::getDoubleValue().
+        */
+        double evaluate( const double* inputs ) const;
+
+        /** Evaluates the expression for @a count sets of inputs.
+        @param inputs For each input, in the order of the input names passed to compile(), the array of
+        its @a count values.
+        @param count The number of input sets.
+        @param results The array the @a count results are written to.
+        */
+        void evaluate( const double* const* inputs, size_t count, double* results ) const;
+
+    private:
+        /** Disable default copy ctor. */
+        CompiledExpression( const CompiledExpression& pre );
+
+        /** Disable default assignment operator. */
+        const CompiledExpression& operator= ( const CompiledExpression& pre );
+
+        /** Executes the instructions for @a count sets of inputs. @a registers holds for each register
+        the array of its @a count values.
+        */
+        void execute( double* const* registers, size_t count ) const;
+
+        /** Calls the function of the OP_CALL instruction @a instruction with the values @a registers[i]
+        of the argument registers.
+        @return The value of the result.
+        */
+        double call( const Instruction& instruction, const double* const* registers, size_t i ) const;
+    };
+
+} //namespace MathML
+
+#endif //__MATHML_COMPILED_EXPRESSION_H__
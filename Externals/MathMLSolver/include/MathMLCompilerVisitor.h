@@ -0,0 +1,239 @@
+/******************************************************************************
+Copyright (c) 2007 netAllied GmbH, Tettnang
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following
+conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+******************************************************************************/
+
+#ifndef __MATHML_COMPILER_VISITOR_H__
+#define __MATHML_COMPILER_VISITOR_H__
+
+#include "MathMLSolverPrerequisites.h"
+
+#include "MathMLASTNode.h"
+#include "MathMLASTArithmeticExpression.h"
+#include "MathMLASTLogicExpression.h"
+#include "MathMLASTBinaryComparisionExpression.h"
+#include "MathMLASTConstantExpression.h"
+#include "MathMLASTUnaryArithmeticExpression.h"
+#include "MathMLASTFragmentExpression.h"
+#include "MathMLASTVariableExpression.h"
+#include "MathMLASTFunctionExpression.h"
+#include "MathMLASTVisitor.h"
+#include "MathMLSymbolTable.h"
+#include "MathMLCompiledExpression.h"
+
+#include <map>
+#include <set>
+#include <vector>
+
+
+namespace MathML
+{
+    /** Forward Declaration. */
+    class ErrorHandler;
+
+    /** Expression node visitor compiling a formula to a CompiledExpression.
+    @par Variables are resolved in the order: parameters of the enclosing fragments, inputs, variables
+    of the symbol table. Variables of the symbol table and fragment parameters are compiled in place of
+    their references. Operations on constant operands and calls of the extension functions, see
+    SolverFunctionExtentions, with constant arguments are folded.
+    @par The types of all values are known when the formula is compiled, results of functions not added
+    by SolverFunctionExtentions are taken as double values. Formulas with unknown variables or functions,
+    a wrong count of function arguments, user defined nodes or a constant long division by zero can not
+    be compiled.
+    */
+    class _MATHML_SOLVER_EXPORT CompilerVisitor : public AST::IVisitor
+    {
+    private:
+        /** The kinds of registers. Registers are numbered per kind while compiling. */
+        enum RegisterKind
+        {
+            REGISTER_INPUT,
+            REGISTER_CONSTANT,
+            REGISTER_TEMPORARY
+        };
+
+        /** A register while compiling. */
+        struct Register
+        {
+            RegisterKind kind;
+            unsigned int index;
+        };
+
+        /** An instruction while compiling. */
+        struct Instruction
+        {
+            CompiledExpression::OpCode opCode;
+            Register result;
+            Register operand1;
+            Register operand2;
+        };
+
+        /** A value computed by a branch. */
+        struct Value
+        {
+            /** True, if the value is known when compiling. */
+            bool isConstant;
+
+            /** The value, if it is constant. */
+            AST::ConstantExpression constant;
+
+            /** The register holding the value, if it is not constant. */
+            Register reg;
+
+            /** The type of the value. */
+            AST::ConstantExpression::Type type;
+        };
+
+        typedef std::map<String, unsigned int> InputIndexMap;
+
+        typedef std::vector<const AST::FragmentExpression::ParameterMap*> ScopeList;
+
+        /** Symbol table holding the functions and the variables that are not inputs. */
+        SymbolTable& mSymbolTable;
+
+        /** Error handler. */
+        ErrorHandler* mErrorHandler;
+
+        /** The number of inputs. */
+        unsigned int mInputCount;
+
+        /** The input slot of each input name. */
+        InputIndexMap mInputIndices;
+
+        /** The parameters of the fragments enclosing the current node, the innermost last. */
+        ScopeList mScopes;
+
+        /** The variables of the symbol table being compiled, to detect cycles. */
+        std::set<String> mVariablesBeingCompiled;
+
+        /** The value of the last compiled branch. */
+        Value mBranchValue;
+
+        std::vector<Instruction> mInstructions;
+
+        std::vector<CompiledExpression::FunctionCall> mFunctionCalls;
+
+        /** The argument registers of each function call. */
+        std::vector< std::vector<Register> > mCallArguments;
+
+        std::vector<double> mConstants;
+
+        /** The number of temporary registers. */
+        unsigned int mTemporaryCount;
+
+        /** Temporary registers no longer used by any value. */
+        std::vector<unsigned int> mFreeTemporaries;
+
+        /** True, if the formula can not be compiled. */
+        bool mFailed;
+
+    public:
+        /** Creates a new compiler.
+        @param inputNames The names of the variables passed to CompiledExpression::evaluate(), in the
+        order of the inputs.
+        @param symbolTable The functions and the variables that are not inputs.
+        @param errorHandler Error handler.
+        */
+        CompilerVisitor( const StringVector& inputNames, SymbolTable& symbolTable, ErrorHandler* errorHandler );
+
+        /** D-tor. */
+        virtual ~CompilerVisitor();
+
+        // see IVisitor::visit(const ArithmeticExpression&)
+        virtual void visit( const AST::ArithmeticExpression* const node );
+
+        // see IVisitor::visit(const BinaryComparisionExpression&)
+        virtual void visit( const AST::BinaryComparisonExpression* const node );
+
+        // see IVisitor::visit(const FragmentExpression&)
+        virtual void visit( const AST::FragmentExpression* const node );
+
+        // see IVisitor::visit(const LogicExpression&)
+        virtual void visit( const AST::LogicExpression* const node );
+
+        // see IVisitor::visit(const ConstantExpression&)
+        virtual void visit( const AST::ConstantExpression* const node );
+
+        // see IVisitor::visit(const FunctionExpression&)
+        virtual void visit( const AST::FunctionExpression* const node );
+
+        // see IVisitor::visit(const UnaryArithmeticExpression&)
+        virtual void visit( const AST::UnaryExpression* const node );
+
+        // see IVisitor::visit(const VariableExpression&)
+        virtual void visit( const AST::VariableExpression* const node );
+
+        // see IVisitor::visit(const INode&). User defined nodes can not be compiled.
+        virtual void visit( const AST::INode* const node );
+
+        /** Returns true, if the visited formula can not be compiled. */
+        bool hasFailed() const { return mFailed; }
+
+        /** Moves the instructions of the visited formula to @a expression.
+        @return False, if the formula can not be compiled.
+        */
+        bool getCompiledExpression( CompiledExpression& expression );
+
+    private:
+        /** Disable default copy ctor. */
+        CompilerVisitor( const CompilerVisitor& pre );
+
+        /** Disable default assignment operator. */
+        const CompilerVisitor& operator= ( const CompilerVisitor& pre );
+
+        /** Reports @a message and marks the formula as not compilable. */
+        void fail( const String& message );
+
+        /** Sets the branch value to the constant @a value. */
+        void setConstantValue( const AST::ConstantExpression& value );
+
+        /** Returns a register holding @a value. */
+        Register getRegister( const Value& value );
+
+        /** Marks the register of @a value as unused, if it is a temporary one. */
+        void releaseRegister( const Value& value );
+
+        /** Returns an unused temporary register. */
+        Register allocateTemporary();
+
+        /** Returns the index of @a reg in the registers of the compiled expression. */
+        unsigned int getRegisterIndex( const Register& reg ) const;
+
+        /** Emits an instruction and sets the branch value to its result.
+        @param operandCount 1 or 2, the operands are released.
+        */
+        void emit( CompiledExpression::OpCode opCode, const Value& operand1, const Value& operand2, int operandCount, AST::ConstantExpression::Type type );
+
+        /** Applies the arithmetic operation @a op to @a lhs and @a rhs. */
+        void compileArithmetic( AST::ArithmeticExpression::Operator op, const Value& lhs, const Value& rhs );
+
+        /** Applies the comparison @a op to @a lhs and @a rhs. */
+        void compileComparison( AST::BinaryComparisonExpression::Operator op, const Value& lhs, const Value& rhs );
+
+        /** Applies the logic operation @a op to @a lhs and @a rhs. */
+        void compileLogic( AST::LogicExpression::Operator op, const Value& lhs, const Value& rhs );
+    };
+
+} //namespace MathML
+
+#endif //__MATHML_COMPILER_VISITOR_H__
@@ -82,18 +82,21 @@ namespace MathML
 
         //-------------------------------------------------------------------------
         ConstantExpression::ConstantExpression( double val )
+                : mErrorHandler( 0 )
         {
             setValue( val );
         }
 
         //-------------------------------------------------------------------------
         ConstantExpression::ConstantExpression( long val )
+                : mErrorHandler( 0 )
         {
             setValue( val );
         }
 
         //-------------------------------------------------------------------------
         ConstantExpression::ConstantExpression( bool val )
+                : mErrorHandler( 0 )
         {
             setValue( val );
         }
@@ -68,6 +68,12 @@ namespace MathML
             mFragment = fragment;
         }
 
+        //---------------------------------------------------------------------------------
+        INode::CloneFlags FragmentExpression::getCloneFlags() const
+        {
+            return mCloneFlags;
+        }
+
         //---------------------------------------------------------------------------------
         const FragmentExpression::ParameterList& FragmentExpression::getParameterList() const
         {
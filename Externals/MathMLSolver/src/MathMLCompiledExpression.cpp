@@ -0,0 +1,234 @@
+#include "MathMLSolverStableHeaders.h"
+#include "MathMLCompiledExpression.h"
+#include "MathMLCompilerVisitor.h"
+
+namespace MathML
+{
+    namespace
+    {
+        /** The number of registers evaluate() keeps on the stack. */
+        const size_t STACK_REGISTER_COUNT = 64;
+
+        // The operations, with the semantics of ConstantExpression. Bool results are 1 or 0.
+        struct Add { static double apply( double a, double b ) { return a + b; } };
+        struct Sub { static double apply( double a, double b ) { return a - b; } };
+        struct Mul { static double apply( double a, double b ) { return a * b; } };
+        struct Div { static double apply( double a, double b ) { return a / b; } };
+        struct LongDiv
+        {
+            static double apply( double a, double b )
+            {
+                long divisor = static_cast<long>( b );
+                return ( divisor == 0 ) ? a / b : static_cast<double>( static_cast<long>( a ) / divisor );
+            }
+        };
+        struct Eq { static double apply( double a, double b ) { return ( a == b ) ? 1. : 0.; } };
+        struct Neq { static double apply( double a, double b ) { return ( a != b ) ? 1. : 0.; } };
+        struct Lt { static double apply( double a, double b ) { return ( a < b ) ? 1. : 0.; } };
+        struct Lte { static double apply( double a, double b ) { return ( a <= b ) ? 1. : 0.; } };
+        struct Gt { static double apply( double a, double b ) { return ( a > b ) ? 1. : 0.; } };
+        struct Gte { static double apply( double a, double b ) { return ( a >= b ) ? 1. : 0.; } };
+        struct And { static double apply( double a, double b ) { return ( ( a != 0. ) & ( b != 0. ) ) ? 1. : 0.; } };
+        struct Or { static double apply( double a, double b ) { return ( ( a != 0. ) | ( b != 0. ) ) ? 1. : 0.; } };
+        struct Xor { static double apply( double a, double b ) { return ( ( a != 0. ) != ( b != 0. ) ) ? 1. : 0.; } };
+        struct Min { static double apply( double a, double b ) { return std::min( a, b ); } };
+        struct Max { static double apply( double a, double b ) { return std::max( a, b ); } };
+        struct Pow { static double apply( double a, double b ) { return ::pow( a, b ); } };
+        struct Neg { static double apply( double a ) { return -a; } };
+        struct Not { static double apply( double a ) { return ( a == 0. ) ? 1. : 0.; } };
+        struct Sin { static double apply( double a ) { return ::sin( a ); } };
+        struct Cos { static double apply( double a ) { return ::cos( a ); } };
+        struct Tan { static double apply( double a ) { return ::tan( a ); } };
+        struct Exp { static double apply( double a ) { return ::exp( a ); } };
+        struct Logn { static double apply( double a ) { return ::log( a ); } };
+        struct Abs { static double apply( double a ) { return std::abs( a ); } };
+        struct Floor { static double apply( double a ) { return ::floor( a ); } };
+        struct Ceiling { static double apply( double a ) { return ::ceil( a ); } };
+
+        //----------------------------------------------------------------------------
+        template < typename Operation >
+        inline void applyBinary( double* result, const double* a, const double* b, size_t count )
+        {
+            for ( size_t i = 0; i < count; ++i )
+                result[ i ] = Operation::apply( a[ i ], b[ i ] );
+        }
+
+        //----------------------------------------------------------------------------
+        template < typename Operation >
+        inline void applyUnary( double* result, const double* a, size_t count )
+        {
+            for ( size_t i = 0; i < count; ++i )
+                result[ i ] = Operation::apply( a[ i ] );
+        }
+    }
+
+    //----------------------------------------------------------------------------
+    CompiledExpression::CompiledExpression()
+    {
+        clear();
+    }
+
+    //----------------------------------------------------------------------------
+    CompiledExpression::~CompiledExpression()
+    {}
+
+    //----------------------------------------------------------------------------
+    bool CompiledExpression::compile( const AST::INode* node, const StringVector& inputNames, SymbolTable& symbolTable, ErrorHandler* errorHandler )
+    {
+        CompilerVisitor compiler( inputNames, symbolTable, errorHandler );
+        node->accept( &compiler );
+        return compiler.getCompiledExpression( *this );
+    }
+
+    //----------------------------------------------------------------------------
+    void CompiledExpression::clear()
+    {
+        mInputCount = 0;
+        mConstants.assign( 1, 0. );
+        mRegisterCount = 1;
+        mInstructions.clear();
+        mFunctionCalls.clear();
+        mResultRegister = 0;
+        mResultType = AST::ConstantExpression::SCALAR_DOUBLE;
+        mErrorHandler = 0;
+    }
+
+    //----------------------------------------------------------------------------
+    double CompiledExpression::evaluate( const double* inputs ) const
+    {
+        double stackValues[ STACK_REGISTER_COUNT ];
+        double* stackRegisters[ STACK_REGISTER_COUNT ];
+        std::vector<double> heapValues;
+        std::vector<double*> heapRegisters;
+
+        double* values = stackValues;
+        double** registers = stackRegisters;
+        if ( mRegisterCount > STACK_REGISTER_COUNT )
+        {
+            heapValues.resize( mRegisterCount );
+            heapRegisters.resize( mRegisterCount );
+            values = &heapValues[ 0 ];
+            registers = &heapRegisters[ 0 ];
+        }
+
+        // inputs are only read
+        for ( size_t i = 0; i < mInputCount; ++i )
+            registers[ i ] = const_cast<double*>( inputs + i );
+        for ( size_t i = mInputCount; i < mRegisterCount; ++i )
+            registers[ i ] = values + i;
+        for ( size_t i = 0; i < mConstants.size(); ++i )
+            values[ mInputCount + i ] = mConstants[ i ];
+
+        execute( registers, 1 );
+        return *registers[ mResultRegister ];
+    }
+
+    //----------------------------------------------------------------------------
+    void CompiledExpression::evaluate( const double* const* inputs, size_t count, double* results ) const
+    {
+        if ( count == 0 )
+            return;
+
+        // one block of values for each constant and temporary register
+        std::vector<double> values( ( mRegisterCount - mInputCount ) * BLOCK_SIZE );
+        std::vector<double*> registers( mRegisterCount );
+        for ( size_t i = mInputCount; i < mRegisterCount; ++i )
+            registers[ i ] = &values[ ( i - mInputCount ) * BLOCK_SIZE ];
+        for ( size_t i = 0; i < mConstants.size(); ++i )
+            std::fill( registers[ mInputCount + i ], registers[ mInputCount + i ] + BLOCK_SIZE, mConstants[ i ] );
+
+        for ( size_t start = 0; start < count; start += BLOCK_SIZE )
+        {
+            size_t blockCount = count - start;
+            if ( blockCount > BLOCK_SIZE )
+                blockCount = BLOCK_SIZE;
+            for ( size_t i = 0; i < mInputCount; ++i )
+                registers[ i ] = const_cast<double*>( inputs[ i ] + start );
+
+            execute( &registers[ 0 ], blockCount );
+
+            const double* result = registers[ mResultRegister ];
+            std::copy( result, result + blockCount, results + start );
+        }
+    }
+
+    //----------------------------------------------------------------------------
+    void CompiledExpression::execute( double* const* registers, size_t count ) const
+    {
+        for ( size_t i = 0; i < mInstructions.size(); ++i )
+        {
+            const Instruction& instruction = mInstructions[ i ];
+            double* result = registers[ instruction.result ];
+            const double* a = registers[ instruction.operand1 ];
+            const double* b = registers[ instruction.operand2 ];
+
+            switch ( instruction.opCode )
+            {
+            case OP_ADD: applyBinary<Add>( result, a, b, count ); break;
+            case OP_SUB: applyBinary<Sub>( result, a, b, count ); break;
+            case OP_MUL: applyBinary<Mul>( result, a, b, count ); break;
+            case OP_DIV: applyBinary<Div>( result, a, b, count ); break;
+            case OP_LONG_DIV: applyBinary<LongDiv>( result, a, b, count ); break;
+            case OP_NEG: applyUnary<Neg>( result, a, count ); break;
+            case OP_NOT: applyUnary<Not>( result, a, count ); break;
+            case OP_EQ: applyBinary<Eq>( result, a, b, count ); break;
+            case OP_NEQ: applyBinary<Neq>( result, a, b, count ); break;
+            case OP_LT: applyBinary<Lt>( result, a, b, count ); break;
+            case OP_LTE: applyBinary<Lte>( result, a, b, count ); break;
+            case OP_GT: applyBinary<Gt>( result, a, b, count ); break;
+            case OP_GTE: applyBinary<Gte>( result, a, b, count ); break;
+            case OP_AND: applyBinary<And>( result, a, b, count ); break;
+            case OP_OR: applyBinary<Or>( result, a, b, count ); break;
+            case OP_XOR: applyBinary<Xor>( result, a, b, count ); break;
+            case OP_MIN: applyBinary<Min>( result, a, b, count ); break;
+            case OP_MAX: applyBinary<Max>( result, a, b, count ); break;
+            case OP_POW: applyBinary<Pow>( result, a, b, count ); break;
+            case OP_SIN: applyUnary<Sin>( result, a, count ); break;
+            case OP_COS: applyUnary<Cos>( result, a, count ); break;
+            case OP_TAN: applyUnary<Tan>( result, a, count ); break;
+            case OP_EXP: applyUnary<Exp>( result, a, count ); break;
+            case OP_LOGN: applyUnary<Logn>( result, a, count ); break;
+            case OP_ABS: applyUnary<Abs>( result, a, count ); break;
+            case OP_FLOOR: applyUnary<Floor>( result, a, count ); break;
+            case OP_CEILING: applyUnary<Ceiling>( result, a, count ); break;
+
+            case OP_CALL:
+                for ( size_t j = 0; j < count; ++j )
+                    result[ j ] = call( instruction, registers, j );
+                break;
+            }
+        }
+    }
+
+    //----------------------------------------------------------------------------
+    double CompiledExpression::call( const Instruction& instruction, const double* const* registers, size_t i ) const
+    {
+        const FunctionCall& functionCall = mFunctionCalls[ instruction.operand1 ];
+
+        ScalarList evaluatedArgs( functionCall.arguments.size() );
+        for ( size_t j = 0; j < functionCall.arguments.size(); ++j )
+        {
+            double value = registers[ functionCall.arguments[ j ] ][ i ];
+            switch ( functionCall.argumentTypes[ j ] )
+            {
+            case AST::ConstantExpression::SCALAR_BOOL:
+                evaluatedArgs[ j ].setValue( value != 0. );
+                break;
+
+            case AST::ConstantExpression::SCALAR_LONG:
+                evaluatedArgs[ j ].setValue( static_cast<long>( value ) );
+                break;
+
+            default:
+                evaluatedArgs[ j ].setValue( value );
+                break;
+            }
+        }
+
+        AST::ConstantExpression result;
+        result.setValue( 0. );
+        functionCall.function( result, evaluatedArgs, mErrorHandler );
+        return result.getDoubleValue();
+    }
+
+} //namespace MathML
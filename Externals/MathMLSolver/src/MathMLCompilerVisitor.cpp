@@ -0,0 +1,780 @@
+#include "MathMLSolverStableHeaders.h"
+#include "MathMLCompilerVisitor.h"
+#include "MathMLSolverFunctionExtensions.h"
+#include "MathMLError.h"
+
+#include <string.h>
+
+namespace MathML
+{
+    namespace
+    {
+        /** A function added by SolverFunctionExtentions. These functions have no side effects and are folded
+        for constant arguments. */
+        struct ExtensionFunction
+        {
+            /** The function. */
+            SymbolTable::FunctionPtr function;
+
+            /** The native operation, OP_CALL if there is none. */
+            CompiledExpression::OpCode opCode;
+
+            /** The type of the result. */
+            AST::ConstantExpression::Type resultType;
+        };
+
+        const ExtensionFunction EXTENSION_FUNCTIONS[] =
+        {
+            { SolverFunctionExtentions::sin, CompiledExpression::OP_SIN, AST::ConstantExpression::SCALAR_DOUBLE },
+            { SolverFunctionExtentions::cos, CompiledExpression::OP_COS, AST::ConstantExpression::SCALAR_DOUBLE },
+            { SolverFunctionExtentions::tan, CompiledExpression::OP_TAN, AST::ConstantExpression::SCALAR_DOUBLE },
+            { SolverFunctionExtentions::abs, CompiledExpression::OP_ABS, AST::ConstantExpression::SCALAR_DOUBLE },
+            { SolverFunctionExtentions::exp, CompiledExpression::OP_EXP, AST::ConstantExpression::SCALAR_DOUBLE },
+            { SolverFunctionExtentions::pow, CompiledExpression::OP_POW, AST::ConstantExpression::SCALAR_DOUBLE },
+            { SolverFunctionExtentions::logn, CompiledExpression::OP_LOGN, AST::ConstantExpression::SCALAR_DOUBLE },
+            { SolverFunctionExtentions::floor, CompiledExpression::OP_FLOOR, AST::ConstantExpression::SCALAR_DOUBLE },
+            { SolverFunctionExtentions::ceiling, CompiledExpression::OP_CEILING, AST::ConstantExpression::SCALAR_DOUBLE },
+            { SolverFunctionExtentions::min, CompiledExpression::OP_MIN, AST::ConstantExpression::SCALAR_DOUBLE },
+            { SolverFunctionExtentions::max, CompiledExpression::OP_MAX, AST::ConstantExpression::SCALAR_DOUBLE },
+
+            { SolverFunctionExtentions::sec, CompiledExpression::OP_CALL, AST::ConstantExpression::SCALAR_DOUBLE },
+            { SolverFunctionExtentions::cosec, CompiledExpression::OP_CALL, AST::ConstantExpression::SCALAR_DOUBLE },
+            { SolverFunctionExtentions::cotan, CompiledExpression::OP_CALL, AST::ConstantExpression::SCALAR_DOUBLE },
+            { SolverFunctionExtentions::sinh, CompiledExpression::OP_CALL, AST::ConstantExpression::SCALAR_DOUBLE },
+            { SolverFunctionExtentions::cosh, CompiledExpression::OP_CALL, AST::ConstantExpression::SCALAR_DOUBLE },
+            { SolverFunctionExtentions::tanh, CompiledExpression::OP_CALL, AST::ConstantExpression::SCALAR_DOUBLE },
+            { SolverFunctionExtentions::sech, CompiledExpression::OP_CALL, AST::ConstantExpression::SCALAR_DOUBLE },
+            { SolverFunctionExtentions::cosech, CompiledExpression::OP_CALL, AST::ConstantExpression::SCALAR_DOUBLE },
+            { SolverFunctionExtentions::cotanh, CompiledExpression::OP_CALL, AST::ConstantExpression::SCALAR_DOUBLE },
+            { SolverFunctionExtentions::arcsin, CompiledExpression::OP_CALL, AST::ConstantExpression::SCALAR_DOUBLE },
+            { SolverFunctionExtentions::arccos, CompiledExpression::OP_CALL, AST::ConstantExpression::SCALAR_DOUBLE },
+            { SolverFunctionExtentions::arctan, CompiledExpression::OP_CALL, AST::ConstantExpression::SCALAR_DOUBLE },
+            { SolverFunctionExtentions::arcsec, CompiledExpression::OP_CALL, AST::ConstantExpression::SCALAR_DOUBLE },
+            { SolverFunctionExtentions::arccsc, CompiledExpression::OP_CALL, AST::ConstantExpression::SCALAR_DOUBLE },
+            { SolverFunctionExtentions::arccotan, CompiledExpression::OP_CALL, AST::ConstantExpression::SCALAR_DOUBLE },
+            { SolverFunctionExtentions::arcsinh, CompiledExpression::OP_CALL, AST::ConstantExpression::SCALAR_DOUBLE },
+            { SolverFunctionExtentions::arccosh, CompiledExpression::OP_CALL, AST::ConstantExpression::SCALAR_DOUBLE },
+            { SolverFunctionExtentions::arctanh, CompiledExpression::OP_CALL, AST::ConstantExpression::SCALAR_DOUBLE },
+            { SolverFunctionExtentions::arcsech, CompiledExpression::OP_CALL, AST::ConstantExpression::SCALAR_DOUBLE },
+            { SolverFunctionExtentions::arccsch, CompiledExpression::OP_CALL, AST::ConstantExpression::SCALAR_DOUBLE },
+            { SolverFunctionExtentions::arccotanh, CompiledExpression::OP_CALL, AST::ConstantExpression::SCALAR_DOUBLE },
+            { SolverFunctionExtentions::gcd, CompiledExpression::OP_CALL, AST::ConstantExpression::SCALAR_DOUBLE },
+            { SolverFunctionExtentions::lcm, CompiledExpression::OP_CALL, AST::ConstantExpression::SCALAR_DOUBLE },
+            { SolverFunctionExtentions::rem, CompiledExpression::OP_CALL, AST::ConstantExpression::SCALAR_LONG },
+            { SolverFunctionExtentions::factorial, CompiledExpression::OP_CALL, AST::ConstantExpression::SCALAR_LONG },
+            { SolverFunctionExtentions::root, CompiledExpression::OP_CALL, AST::ConstantExpression::SCALAR_DOUBLE },
+            { SolverFunctionExtentions::log, CompiledExpression::OP_CALL, AST::ConstantExpression::SCALAR_DOUBLE }
+        };
+
+        //----------------------------------------------------------------------------
+        const ExtensionFunction* findExtensionFunction( SymbolTable::FunctionPtr function )
+        {
+            size_t count = sizeof( EXTENSION_FUNCTIONS ) / sizeof( EXTENSION_FUNCTIONS[ 0 ] );
+            for ( size_t i = 0; i < count; ++i )
+            {
+                if ( EXTENSION_FUNCTIONS[ i ].function == function )
+                    return &EXTENSION_FUNCTIONS[ i ];
+            }
+            return 0;
+        }
+
+        //----------------------------------------------------------------------------
+        /** Returns true, if ConstantExpression performs the arithmetic operation on long values. */
+        bool isLongArithmetic( AST::ConstantExpression::Type lhs, AST::ConstantExpression::Type rhs )
+        {
+            bool lhsIntegral = ( lhs == AST::ConstantExpression::SCALAR_LONG || lhs == AST::ConstantExpression::SCALAR_BOOL );
+            bool rhsIntegral = ( rhs == AST::ConstantExpression::SCALAR_LONG || rhs == AST::ConstantExpression::SCALAR_BOOL );
+            return lhsIntegral && rhsIntegral
+                   && ( lhs == AST::ConstantExpression::SCALAR_LONG || rhs == AST::ConstantExpression::SCALAR_LONG );
+        }
+    }
+
+    //----------------------------------------------------------------------------
+    CompilerVisitor::CompilerVisitor( const StringVector& inputNames, SymbolTable& symbolTable, ErrorHandler* errorHandler )
+            : mSymbolTable ( symbolTable )
+            , mErrorHandler ( errorHandler )
+            , mInputCount ( static_cast<unsigned int>( inputNames.size() ) )
+            , mTemporaryCount ( 0 )
+            , mFailed ( false )
+    {
+        for ( unsigned int i = 0; i < mInputCount; ++i )
+        {
+            // the first of equal names is used
+            mInputIndices.insert( std::make_pair( inputNames[ i ], i ) );
+        }
+
+        AST::ConstantExpression zero;
+        zero.setValue( 0. );
+        setConstantValue( zero );
+    }
+
+    //----------------------------------------------------------------------------
+    CompilerVisitor::~CompilerVisitor()
+    {}
+
+    //----------------------------------------------------------------------------
+    void CompilerVisitor::fail( const String& message )
+    {
+        if ( mFailed )
+            return;
+        mFailed = true;
+
+        if ( mErrorHandler )
+        {
+            Error err( Error::ERR_INVALIDPARAMS, "formula can not be compiled: " + message );
+            mErrorHandler->handleError( &err );
+        }
+    }
+
+    //----------------------------------------------------------------------------
+    void CompilerVisitor::setConstantValue( const AST::ConstantExpression& value )
+    {
+        mBranchValue.isConstant = true;
+        mBranchValue.constant = value;
+        mBranchValue.type = value.getType();
+    }
+
+    //----------------------------------------------------------------------------
+    CompilerVisitor::Register CompilerVisitor::getRegister( const Value& value )
+    {
+        if ( !value.isConstant )
+            return value.reg;
+
+        // constants are compared bitwise, to keep 0 and -0 apart
+        double constant = value.constant.getDoubleValue();
+        Register reg;
+        reg.kind = REGISTER_CONSTANT;
+        for ( reg.index = 0; reg.index < mConstants.size(); ++reg.index )
+        {
+            if ( memcmp( &mConstants[ reg.index ], &constant, sizeof( double ) ) == 0 )
+                return reg;
+        }
+        mConstants.push_back( constant );
+        return reg;
+    }
+
+    //----------------------------------------------------------------------------
+    void CompilerVisitor::releaseRegister( const Value& value )
+    {
+        if ( !value.isConstant && value.reg.kind == REGISTER_TEMPORARY )
+            mFreeTemporaries.push_back( value.reg.index );
+    }
+
+    //----------------------------------------------------------------------------
+    CompilerVisitor::Register CompilerVisitor::allocateTemporary()
+    {
+        Register reg;
+        reg.kind = REGISTER_TEMPORARY;
+        if ( mFreeTemporaries.empty() )
+        {
+            reg.index = mTemporaryCount++;
+        }
+        else
+        {
+            reg.index = mFreeTemporaries.back();
+            mFreeTemporaries.pop_back();
+        }
+        return reg;
+    }
+
+    //----------------------------------------------------------------------------
+    unsigned int CompilerVisitor::getRegisterIndex( const Register& reg ) const
+    {
+        switch ( reg.kind )
+        {
+        case REGISTER_INPUT:
+            return reg.index;
+
+        case REGISTER_CONSTANT:
+            return mInputCount + reg.index;
+
+        default:
+            return mInputCount + static_cast<unsigned int>( mConstants.size() ) + reg.index;
+        }
+    }
+
+    //----------------------------------------------------------------------------
+    void CompilerVisitor::emit( CompiledExpression::OpCode opCode, const Value& operand1, const Value& operand2, int operandCount, AST::ConstantExpression::Type type )
+    {
+        Instruction instruction;
+        instruction.opCode = opCode;
+        instruction.operand1 = getRegister( operand1 );
+        instruction.operand2 = ( operandCount == 2 ) ? getRegister( operand2 ) : instruction.operand1;
+
+        // the result may reuse the register of an operand
+        releaseRegister( operand1 );
+        if ( operandCount == 2 )
+            releaseRegister( operand2 );
+        instruction.result = allocateTemporary();
+        mInstructions.push_back( instruction );
+
+        mBranchValue.isConstant = false;
+        mBranchValue.reg = instruction.result;
+        mBranchValue.type = type;
+    }
+
+    //----------------------------------------------------------------------------
+    void CompilerVisitor::compileArithmetic( AST::ArithmeticExpression::Operator op, const Value& lhs, const Value& rhs )
+    {
+        bool longArithmetic = isLongArithmetic( lhs.type, rhs.type );
+
+        if ( lhs.isConstant && rhs.isConstant )
+        {
+            switch ( op )
+            {
+
+            case AST::ArithmeticExpression::ADD:
+                setConstantValue( lhs.constant + rhs.constant );
+                break;
+
+            case AST::ArithmeticExpression::SUB:
+                setConstantValue( lhs.constant - rhs.constant );
+                break;
+
+            case AST::ArithmeticExpression::MUL:
+                setConstantValue( lhs.constant * rhs.constant );
+                break;
+
+            case AST::ArithmeticExpression::DIV:
+                if ( longArithmetic && rhs.constant.getLongValue() == 0 )
+                {
+                    fail( "division by zero" );
+                    return;
+                }
+                setConstantValue( lhs.constant / rhs.constant );
+                break;
+
+            default:
+                fail( "invalid operator: " + AST::ArithmeticExpression::operatorString( op ) );
+                break;
+            }
+            return;
+        }
+
+        AST::ConstantExpression::Type type = longArithmetic ? AST::ConstantExpression::SCALAR_LONG : AST::ConstantExpression::SCALAR_DOUBLE;
+
+        switch ( op )
+        {
+
+        case AST::ArithmeticExpression::ADD:
+            emit( CompiledExpression::OP_ADD, lhs, rhs, 2, type );
+            break;
+
+        case AST::ArithmeticExpression::SUB:
+            emit( CompiledExpression::OP_SUB, lhs, rhs, 2, type );
+            break;
+
+        case AST::ArithmeticExpression::MUL:
+            emit( CompiledExpression::OP_MUL, lhs, rhs, 2, type );
+            break;
+
+        case AST::ArithmeticExpression::DIV:
+            emit( longArithmetic ? CompiledExpression::OP_LONG_DIV : CompiledExpression::OP_DIV, lhs, rhs, 2, type );
+            break;
+
+        default:
+            fail( "invalid operator: " + AST::ArithmeticExpression::operatorString( op ) );
+            break;
+        }
+    }
+
+    //----------------------------------------------------------------------------
+    void CompilerVisitor::compileComparison( AST::BinaryComparisonExpression::Operator op, const Value& lhs, const Value& rhs )
+    {
+        if ( lhs.isConstant && rhs.isConstant )
+        {
+            switch ( op )
+            {
+
+            case AST::BinaryComparisonExpression::EQ:
+                setConstantValue( lhs.constant == rhs.constant );
+                break;
+
+            case AST::BinaryComparisonExpression::NEQ:
+                setConstantValue( lhs.constant != rhs.constant );
+                break;
+
+            case AST::BinaryComparisonExpression::LTE:
+                setConstantValue( lhs.constant <= rhs.constant );
+                break;
+
+            case AST::BinaryComparisonExpression::GTE:
+                setConstantValue( lhs.constant >= rhs.constant );
+                break;
+
+            case AST::BinaryComparisonExpression::LT:
+                setConstantValue( lhs.constant < rhs.constant );
+                break;
+
+            case AST::BinaryComparisonExpression::GT:
+                setConstantValue( lhs.constant > rhs.constant );
+                break;
+
+            default:
+                fail( "invalid operator: " + AST::BinaryComparisonExpression::operatorString( op ) );
+                break;
+            }
+            return;
+        }
+
+        // bool values can only be compared for equality with bool values, everything else results in 0
+        if ( lhs.type == AST::ConstantExpression::SCALAR_BOOL || rhs.type == AST::ConstantExpression::SCALAR_BOOL )
+        {
+            if ( lhs.type != rhs.type || ( op != AST::BinaryComparisonExpression::EQ && op != AST::BinaryComparisonExpression::NEQ ) )
+            {
+                releaseRegister( lhs );
+                releaseRegister( rhs );
+                AST::ConstantExpression zero;
+                zero.setValue( 0. );
+                setConstantValue( zero );
+                return;
+            }
+        }
+
+        switch ( op )
+        {
+
+        case AST::BinaryComparisonExpression::EQ:
+            emit( CompiledExpression::OP_EQ, lhs, rhs, 2, AST::ConstantExpression::SCALAR_BOOL );
+            break;
+
+        case AST::BinaryComparisonExpression::NEQ:
+            emit( CompiledExpression::OP_NEQ, lhs, rhs, 2, AST::ConstantExpression::SCALAR_BOOL );
+            break;
+
+        case AST::BinaryComparisonExpression::LTE:
+            emit( CompiledExpression::OP_LTE, lhs, rhs, 2, AST::ConstantExpression::SCALAR_BOOL );
+            break;
+
+        case AST::BinaryComparisonExpression::GTE:
+            emit( CompiledExpression::OP_GTE, lhs, rhs, 2, AST::ConstantExpression::SCALAR_BOOL );
+            break;
+
+        case AST::BinaryComparisonExpression::LT:
+            emit( CompiledExpression::OP_LT, lhs, rhs, 2, AST::ConstantExpression::SCALAR_BOOL );
+            break;
+
+        case AST::BinaryComparisonExpression::GT:
+            emit( CompiledExpression::OP_GT, lhs, rhs, 2, AST::ConstantExpression::SCALAR_BOOL );
+            break;
+
+        default:
+            fail( "invalid operator: " + AST::BinaryComparisonExpression::operatorString( op ) );
+            break;
+        }
+    }
+
+    //----------------------------------------------------------------------------
+    void CompilerVisitor::compileLogic( AST::LogicExpression::Operator op, const Value& lhs, const Value& rhs )
+    {
+        if ( lhs.isConstant && rhs.isConstant )
+        {
+            switch ( op )
+            {
+
+            case AST::LogicExpression::AND:
+                setConstantValue( lhs.constant && rhs.constant );
+                break;
+
+            case AST::LogicExpression::OR:
+                setConstantValue( lhs.constant || rhs.constant );
+                break;
+
+            case AST::LogicExpression::XOR:
+                setConstantValue( lhs.constant ^ rhs.constant );
+                break;
+
+            default:
+                fail( "invalid operator: " + AST::LogicExpression::operatorString( op ) );
+                break;
+            }
+            return;
+        }
+
+        switch ( op )
+        {
+
+        case AST::LogicExpression::AND:
+            emit( CompiledExpression::OP_AND, lhs, rhs, 2, AST::ConstantExpression::SCALAR_BOOL );
+            break;
+
+        case AST::LogicExpression::OR:
+            emit( CompiledExpression::OP_OR, lhs, rhs, 2, AST::ConstantExpression::SCALAR_BOOL );
+            break;
+
+        case AST::LogicExpression::XOR:
+            emit( CompiledExpression::OP_XOR, lhs, rhs, 2, AST::ConstantExpression::SCALAR_BOOL );
+            break;
+
+        default:
+            fail( "invalid operator: " + AST::LogicExpression::operatorString( op ) );
+            break;
+        }
+    }
+
+    //----------------------------------------------------------------------------
+    void CompilerVisitor::visit( const AST::ArithmeticExpression* const node )
+    {
+        const AST::NodeList& operands = node->getOperands();
+        if ( operands.empty() )
+        {
+            fail( "arithmetic expression without operands" );
+            return;
+        }
+
+        // operands are applied from left to right, as by the EvaluatorVisitor
+        operands[ 0 ]->accept( this );
+        for ( size_t i = 1; i < operands.size() && !mFailed; ++i )
+        {
+            Value lhs = mBranchValue;
+            operands[ i ]->accept( this );
+            if ( mFailed )
+                return;
+            Value rhs = mBranchValue;
+            compileArithmetic( node->getOperator(), lhs, rhs );
+        }
+    }
+
+    //----------------------------------------------------------------------------
+    void CompilerVisitor::visit( const AST::BinaryComparisonExpression* const node )
+    {
+        node->getLeftOperand()->accept( this );
+        if ( mFailed )
+            return;
+        Value lhs = mBranchValue;
+
+        node->getRightOperand()->accept( this );
+        if ( mFailed )
+            return;
+        Value rhs = mBranchValue;
+
+        compileComparison( node->getOperator(), lhs, rhs );
+    }
+
+    //----------------------------------------------------------------------------
+    void CompilerVisitor::visit( const AST::FragmentExpression* const node )
+    {
+        AST::INode* fragment = node->getFragment();
+        if ( fragment == 0 )
+        {
+            fail( "symbol " + node->getName() + " not declared" );
+            return;
+        }
+
+        mScopes.push_back( &node->getParameterMap() );
+        fragment->accept( this );
+        mScopes.pop_back();
+    }
+
+    //----------------------------------------------------------------------------
+    void CompilerVisitor::visit( const AST::LogicExpression* const node )
+    {
+        const AST::NodeList& operands = node->getOperands();
+        if ( operands.empty() )
+        {
+            fail( "logic expression without operands" );
+            return;
+        }
+
+        operands[ 0 ]->accept( this );
+        for ( size_t i = 1; i < operands.size() && !mFailed; ++i )
+        {
+            Value lhs = mBranchValue;
+            operands[ i ]->accept( this );
+            if ( mFailed )
+                return;
+            Value rhs = mBranchValue;
+            compileLogic( node->getOperator(), lhs, rhs );
+        }
+    }
+
+    //----------------------------------------------------------------------------
+    void CompilerVisitor::visit( const AST::ConstantExpression* const node )
+    {
+        if ( node->getType() == AST::ConstantExpression::SCALAR_INVALID )
+        {
+            fail( "uninitialized constant" );
+            return;
+        }
+        setConstantValue( *node );
+    }
+
+    //----------------------------------------------------------------------------
+    void CompilerVisitor::visit( const AST::FunctionExpression* const node )
+    {
+        const String& name = node->getName();
+        if ( !mSymbolTable.existsFunction( name ) )
+        {
+            fail( "function " + name + " not found" );
+            return;
+        }
+        const SymbolTable::FunctionInfo* functionInfo = mSymbolTable.getFunction( name );
+
+        const AST::NodeList& params = node->getParameterList();
+        if ( functionInfo->argc != -1 && static_cast<size_t>( functionInfo->argc ) != params.size() )
+        {
+            fail( "wrong number of parameters for function " + name );
+            return;
+        }
+
+        std::vector<Value> arguments;
+        bool constantArguments = true;
+        for ( size_t i = 0; i < params.size(); ++i )
+        {
+            params[ i ]->accept( this );
+            if ( mFailed )
+                return;
+            arguments.push_back( mBranchValue );
+            constantArguments = constantArguments && mBranchValue.isConstant;
+        }
+
+        const ExtensionFunction* extensionFunction = findExtensionFunction( functionInfo->func );
+
+        // fold extension functions, but leave a constant remainder by zero to the evaluation
+        bool remainderByZero = ( functionInfo->func == SolverFunctionExtentions::rem )
+                               && arguments.size() == 2 && arguments[ 1 ].isConstant && arguments[ 1 ].constant.getLongValue() == 0;
+        if ( extensionFunction && constantArguments && !remainderByZero )
+        {
+            ScalarList evaluatedArgs;
+            for ( size_t i = 0; i < arguments.size(); ++i )
+                evaluatedArgs.push_back( arguments[ i ].constant );
+
+            AST::ConstantExpression result;
+            functionInfo->func( result, evaluatedArgs, mErrorHandler );
+            setConstantValue( result );
+            return;
+        }
+
+        if ( extensionFunction && extensionFunction->opCode != CompiledExpression::OP_CALL )
+        {
+            CompiledExpression::OpCode opCode = extensionFunction->opCode;
+
+            if ( opCode == CompiledExpression::OP_MIN || opCode == CompiledExpression::OP_MAX )
+            {
+                // the arguments are reduced from left to right, to a double value
+                Value current = arguments[ 0 ];
+                current.constant.setValue( current.constant.getDoubleValue() );
+                current.type = AST::ConstantExpression::SCALAR_DOUBLE;
+
+                for ( size_t i = 1; i < arguments.size(); ++i )
+                {
+                    if ( current.isConstant && arguments[ i ].isConstant )
+                    {
+                        double lhs = current.constant.getDoubleValue();
+                        double rhs = arguments[ i ].constant.getDoubleValue();
+                        current.constant.setValue( ( opCode == CompiledExpression::OP_MIN ) ? std::min( lhs, rhs ) : std::max( lhs, rhs ) );
+                        continue;
+                    }
+                    emit( opCode, current, arguments[ i ], 2, AST::ConstantExpression::SCALAR_DOUBLE );
+                    current = mBranchValue;
+                }
+                mBranchValue = current;
+            }
+
+            else if ( opCode == CompiledExpression::OP_POW )
+            {
+                emit( opCode, arguments[ 0 ], arguments[ 1 ], 2, AST::ConstantExpression::SCALAR_DOUBLE );
+            }
+
+            else
+            {
+                emit( opCode, arguments[ 0 ], arguments[ 0 ], 1, AST::ConstantExpression::SCALAR_DOUBLE );
+            }
+            return;
+        }
+
+        // generic call through the function pointer
+        CompiledExpression::FunctionCall functionCall;
+        functionCall.function = functionInfo->func;
+        std::vector<Register> argumentRegisters;
+        for ( size_t i = 0; i < arguments.size(); ++i )
+        {
+            argumentRegisters.push_back( getRegister( arguments[ i ] ) );
+            functionCall.argumentTypes.push_back( arguments[ i ].type );
+        }
+        for ( size_t i = 0; i < arguments.size(); ++i )
+            releaseRegister( arguments[ i ] );
+
+        Instruction instruction;
+        instruction.opCode = CompiledExpression::OP_CALL;
+        instruction.result = allocateTemporary();
+        instruction.operand1.kind = REGISTER_CONSTANT;
+        instruction.operand1.index = static_cast<unsigned int>( mFunctionCalls.size() );
+        instruction.operand2 = instruction.operand1;
+        mInstructions.push_back( instruction );
+        mFunctionCalls.push_back( functionCall );
+        mCallArguments.push_back( argumentRegisters );
+
+        mBranchValue.isConstant = false;
+        mBranchValue.reg = instruction.result;
+        mBranchValue.type = extensionFunction ? extensionFunction->resultType : AST::ConstantExpression::SCALAR_DOUBLE;
+    }
+
+    //----------------------------------------------------------------------------
+    void CompilerVisitor::visit( const AST::UnaryExpression* const node )
+    {
+        node->getOperand()->accept( this );
+        if ( mFailed )
+            return;
+        Value operand = mBranchValue;
+        AST::UnaryExpression::Operator op = node->getOperator();
+
+        // the unary plus leaves the value unchanged, as by the EvaluatorVisitor
+        if ( op == AST::UnaryExpression::ADD )
+            return;
+
+        if ( operand.isConstant )
+        {
+            switch ( op )
+            {
+
+            case AST::UnaryExpression::SUB:
+                setConstantValue( -operand.constant );
+                break;
+
+            case AST::UnaryExpression::NOT:
+                setConstantValue( !operand.constant );
+                break;
+
+            default:
+                fail( "invalid operator: " + AST::UnaryExpression::operatorString( op ) );
+                break;
+            }
+            return;
+        }
+
+        // only the logical not is applied to bool values, the negation results in 0
+        if ( operand.type == AST::ConstantExpression::SCALAR_BOOL && op != AST::UnaryExpression::NOT )
+        {
+            releaseRegister( operand );
+            AST::ConstantExpression zero;
+            zero.setValue( 0. );
+            setConstantValue( zero );
+            return;
+        }
+
+        switch ( op )
+        {
+
+        case AST::UnaryExpression::SUB:
+            emit( CompiledExpression::OP_NEG, operand, operand, 1, operand.type );
+            break;
+
+        case AST::UnaryExpression::NOT:
+            emit( CompiledExpression::OP_NOT, operand, operand, 1, operand.type );
+            break;
+
+        default:
+            fail( "invalid operator: " + AST::UnaryExpression::operatorString( op ) );
+            break;
+        }
+    }
+
+    //----------------------------------------------------------------------------
+    void CompilerVisitor::visit( const AST::VariableExpression* const node )
+    {
+        const String& name = node->getName();
+
+        // parameters of the enclosing fragments, compiled in the scope of the fragment
+        for ( size_t i = mScopes.size(); i > 0; --i )
+        {
+            const AST::FragmentExpression::ParameterMap* parameters = mScopes[ i - 1 ];
+            AST::FragmentExpression::ParameterMap::const_iterator it = parameters->find( name );
+            if ( it == parameters->end() )
+                continue;
+
+            ScopeList scopes = mScopes;
+            mScopes.resize( i - 1 );
+            it->second->accept( this );
+            mScopes = scopes;
+            return;
+        }
+
+        InputIndexMap::const_iterator inputIt = mInputIndices.find( name );
+        if ( inputIt != mInputIndices.end() )
+        {
+            mBranchValue.isConstant = false;
+            mBranchValue.reg.kind = REGISTER_INPUT;
+            mBranchValue.reg.index = inputIt->second;
+            mBranchValue.type = AST::ConstantExpression::SCALAR_DOUBLE;
+            return;
+        }
+
+        AST::INode* variableNode = mSymbolTable.getVariable( name );
+        if ( variableNode == 0 )
+        {
+            fail( "variable '" + name + "' could not be found" );
+            return;
+        }
+
+        if ( !mVariablesBeingCompiled.insert( name ).second )
+        {
+            fail( "variable '" + name + "' references itself" );
+            return;
+        }
+
+        ScopeList scopes;
+        scopes.swap( mScopes );
+        variableNode->accept( this );
+        mScopes.swap( scopes );
+        mVariablesBeingCompiled.erase( name );
+    }
+
+    //----------------------------------------------------------------------------
+    void CompilerVisitor::visit( const AST::INode* const node )
+    {
+        if ( node->getNodeType() == AST::INode::USERDEFINED )
+        {
+            fail( "user defined node" );
+            return;
+        }
+        AST::IVisitor::visit( node );
+    }
+
+    //----------------------------------------------------------------------------
+    bool CompilerVisitor::getCompiledExpression( CompiledExpression& expression )
+    {
+        expression.clear();
+        if ( mFailed )
+            return false;
+
+        Register resultRegister = getRegister( mBranchValue );
+
+        expression.mInputCount = mInputCount;
+        expression.mConstants = mConstants;
+        expression.mRegisterCount = mInputCount + mConstants.size() + mTemporaryCount;
+        expression.mResultRegister = getRegisterIndex( resultRegister );
+        expression.mResultType = mBranchValue.type;
+        expression.mErrorHandler = mErrorHandler;
+
+        expression.mInstructions.reserve( mInstructions.size() );
+        for ( size_t i = 0; i < mInstructions.size(); ++i )
+        {
+            const Instruction& instruction = mInstructions[ i ];
+            CompiledExpression::Instruction compiledInstruction;
+            compiledInstruction.opCode = instruction.opCode;
+            compiledInstruction.result = getRegisterIndex( instruction.result );
+            if ( instruction.opCode == CompiledExpression::OP_CALL )
+            {
+                compiledInstruction.operand1 = instruction.operand1.index;
+                compiledInstruction.operand2 = instruction.operand1.index;
+            }
+            else
+            {
+                compiledInstruction.operand1 = getRegisterIndex( instruction.operand1 );
+                compiledInstruction.operand2 = getRegisterIndex( instruction.operand2 );
+            }
+            expression.mInstructions.push_back( compiledInstruction );
+        }
+
+        expression.mFunctionCalls = mFunctionCalls;
+        for ( size_t i = 0; i < mFunctionCalls.size(); ++i )
+        {
+            const std::vector<Register>& arguments = mCallArguments[ i ];
+            for ( size_t j = 0; j < arguments.size(); ++j )
+                expression.mFunctionCalls[ i ].arguments.push_back( getRegisterIndex( arguments[ j ] ) );
+        }
+        return true;
+    }
+
+} //namespace MathML
@@ -0,0 +1,168 @@
+/******************************************************************************
+Copyright (c) 2007 netAllied GmbH, Tettnang
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following
+conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+******************************************************************************/
+
+#include "MathMLSolverStableHeaders.h"
+#include "performanceTest.h"
+#include "MathMLCompiledExpression.h"
+#include "MathMLEvaluatorVisitor.h"
+#include "MathMLSolverFunctionExtensions.h"
+
+#include <ctime>
+#include <iostream>
+#include <vector>
+
+
+using namespace MathML;
+using namespace MathML::AST;
+
+namespace
+{
+    /** The number of input sets each formula is evaluated with. */
+    const size_t inputSetCount = 100000;
+
+    INode* variable( const char* name )
+    {
+        return new VariableExpression( name );
+    }
+
+    INode* constant( double value )
+    {
+        ConstantExpression* constantExpression = new ConstantExpression();
+        constantExpression->setValue( value );
+        return constantExpression;
+    }
+
+    INode* arithmetic( ArithmeticExpression::Operator op, INode* operand1, INode* operand2 )
+    {
+        ArithmeticExpression* arithmeticExpression = new ArithmeticExpression();
+        arithmeticExpression->setOperator( op );
+        arithmeticExpression->addOperand( operand1 );
+        arithmeticExpression->addOperand( operand2 );
+        return arithmeticExpression;
+    }
+
+    INode* function( const char* name, INode* parameter )
+    {
+        FunctionExpression* functionExpression = new FunctionExpression( name );
+        functionExpression->addParameter( parameter );
+        return functionExpression;
+    }
+
+    double getElapsedSeconds( clock_t start )
+    {
+        return (double)( clock() - start ) / CLOCKS_PER_SEC;
+    }
+}
+
+//------------------------------
+void performanceTest()
+{
+    // a joint coupling formula: 0.5 * sin(x * 3.14159 / 180) * r + y * y / (z + 2) - cos(z) * (2 * 1.5)
+    INode* formula = arithmetic( ArithmeticExpression::SUB,
+        arithmetic( ArithmeticExpression::ADD,
+            arithmetic( ArithmeticExpression::MUL,
+                arithmetic( ArithmeticExpression::MUL, constant( 0.5 ),
+                    function( "sin", arithmetic( ArithmeticExpression::DIV, arithmetic( ArithmeticExpression::MUL, variable( "x" ), constant( 3.14159 ) ), constant( 180. ) ) ) ),
+                variable( "r" ) ),
+            arithmetic( ArithmeticExpression::DIV,
+                arithmetic( ArithmeticExpression::MUL, variable( "y" ), variable( "y" ) ),
+                arithmetic( ArithmeticExpression::ADD, variable( "z" ), constant( 2. ) ) ) ),
+        arithmetic( ArithmeticExpression::MUL, function( "cos", variable( "z" ) ), arithmetic( ArithmeticExpression::MUL, constant( 2. ), constant( 1.5 ) ) ) );
+
+    SymbolTable symbolTable( 0 );
+    SolverFunctionExtentions::addAllExtensionFunctions( symbolTable );
+    symbolTable.setVariable( "r", 0.25 );
+
+    StringVector inputNames;
+    inputNames.push_back( "x" );
+    inputNames.push_back( "y" );
+    inputNames.push_back( "z" );
+
+    CompiledExpression compiledExpression;
+    if ( !compiledExpression.compile( formula, inputNames, symbolTable, 0 ) )
+    {
+        std::cout << "the formula could not be compiled" << std::endl;
+        delete formula;
+        return;
+    }
+
+    std::vector<double> xs( inputSetCount );
+    std::vector<double> ys( inputSetCount );
+    std::vector<double> zs( inputSetCount );
+    for ( size_t i = 0; i < inputSetCount; ++i )
+    {
+        xs[i] = i * 0.01;
+        ys[i] = 1 + i * 0.001;
+        zs[i] = i * 0.0001;
+    }
+    std::vector<double> evaluatorResults( inputSetCount );
+    std::vector<double> compiledResults( inputSetCount );
+    std::vector<double> batchResults( inputSetCount );
+
+    clock_t start = clock();
+    for ( size_t i = 0; i < inputSetCount; ++i )
+    {
+        // the symbol table does not own its variables, the ones set by value are never deleted
+        ConstantExpression x, y, z;
+        x.setValue( xs[i] );
+        y.setValue( ys[i] );
+        z.setValue( zs[i] );
+        SymbolTable scope( symbolTable );
+        scope.setVariable( "x", &x );
+        scope.setVariable( "y", &y );
+        scope.setVariable( "z", &z );
+        EvaluatorVisitor evaluator( scope, 0 );
+        formula->accept( &evaluator );
+        evaluatorResults[i] = evaluator.getValue().getDoubleValue();
+    }
+    double evaluatorTime = getElapsedSeconds( start );
+
+    start = clock();
+    for ( size_t i = 0; i < inputSetCount; ++i )
+    {
+        double inputSet[3] = { xs[i], ys[i], zs[i] };
+        compiledResults[i] = compiledExpression.evaluate( inputSet );
+    }
+    double compiledTime = getElapsedSeconds( start );
+
+    start = clock();
+    const double* inputs[3] = { &xs[0], &ys[0], &zs[0] };
+    compiledExpression.evaluate( inputs, inputSetCount, &batchResults[0] );
+    double batchTime = getElapsedSeconds( start );
+
+    size_t differenceCount = 0;
+    for ( size_t i = 0; i < inputSetCount; ++i )
+    {
+        if ( ( evaluatorResults[i] != compiledResults[i] ) || ( evaluatorResults[i] != batchResults[i] ) )
+            ++differenceCount;
+    }
+
+    std::cout << compiledExpression.getInstructionCount() << " instructions, " << inputSetCount << " input sets, "
+        << differenceCount << " differences" << std::endl;
+    std::cout << "per evaluation   evaluator: " << evaluatorTime / inputSetCount * 1e9 << "ns   compiled: "
+        << compiledTime / inputSetCount * 1e9 << "ns   batch: " << batchTime / inputSetCount * 1e9 << "ns" << std::endl;
+
+    delete formula;
+}
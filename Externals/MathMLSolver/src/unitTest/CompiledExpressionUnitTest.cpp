@@ -0,0 +1,318 @@
+/******************************************************************************
+Copyright (c) 2007 netAllied GmbH, Tettnang
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following
+conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+******************************************************************************/
+
+#include "MathMLSolverStableHeaders.h"
+#include "CompiledExpressionUnitTest.h"
+#include "MathMLCompiledExpression.h"
+#include "MathMLEvaluatorVisitor.h"
+#include "MathMLSolverFunctionExtensions.h"
+#include "MathMLError.h"
+
+#include <cstring>
+#include <iostream>
+
+
+using namespace MathML;
+using namespace MathML::AST;
+
+namespace
+{
+    /** The number of random formulas compiled. */
+    const size_t formulaCount = 3000;
+
+    /** The number of input sets each formula is evaluated with. */
+    const size_t inputSetCount = 100;
+
+    /** The depth of the random formulas. */
+    const int formulaDepth = 5;
+
+    /** The number of differences printed. */
+    const size_t maxReportedErrors = 10;
+
+    /** The functions with one parameter used in the random formulas. */
+    const char* unaryFunctions[] = { "sin", "cos", "tan", "abs", "exp", "logn", "floor", "ceiling", "arcsin", "sinh", "twice" };
+
+    /** The functions with several parameters used in the random formulas. */
+    const char* naryFunctions[] = { "min", "max", "power", "root", "log" };
+
+    /** Deterministic random numbers, independent of the rand() of the platform. */
+    unsigned int nextRandom( unsigned int& state )
+    {
+        state = state * 1103515245u + 12345u;
+        return ( state >> 16 ) & 0x7fff;
+    }
+
+    /** A user defined function, that depends on the type of its parameter. */
+    void twice( ConstantExpression& result, const ScalarList& paramList, ErrorHandler* )
+    {
+        const ConstantExpression& param = paramList.at( 0 );
+        result.setValue( param.getDoubleValue() * 2 + ( param.getType() == ConstantExpression::SCALAR_BOOL ? 100 : 0 ) );
+    }
+
+    /** Counts the errors, e.g. of formulas that can not be compiled. */
+    class CountingErrorHandler : public ErrorHandler
+    {
+    public:
+        size_t errorCount;
+
+        CountingErrorHandler() : errorCount( 0 ) {}
+
+        virtual bool handleError( const Error* )
+        {
+            ++errorCount;
+            return true;
+        }
+    };
+
+    /** Returns @a node converted to double, by adding 0.0. */
+    INode* toDouble( INode* node )
+    {
+        ArithmeticExpression* sum = new ArithmeticExpression();
+        sum->setOperator( ArithmeticExpression::ADD );
+        sum->addOperand( node );
+        ConstantExpression* zero = new ConstantExpression();
+        zero->setValue( 0. );
+        sum->addOperand( zero );
+        return sum;
+    }
+
+    /** Creates a random formula of the inputs x, y and z, the variable k, that refers to a formula, and,
+    inside fragments, the fragment parameter p. Divisors are positive long constants or double values, since
+    the EvaluatorVisitor divides long values by zero. */
+    INode* createFormula( int depth, bool inFragment, unsigned int& randomState )
+    {
+        switch ( depth <= 0 ? nextRandom( randomState ) % 3 : nextRandom( randomState ) % 12 )
+        {
+        case 0:
+            {
+                const char* names[] = { "x", "y", "z", "k", "p" };
+                return new VariableExpression( names[ nextRandom( randomState ) % ( inFragment ? 5 : 4 ) ] );
+            }
+        case 1:
+            {
+                ConstantExpression* constant = new ConstantExpression();
+                switch ( nextRandom( randomState ) % 3 )
+                {
+                case 0:
+                    constant->setValue( ( (int)( nextRandom( randomState ) % 200 ) - 100 ) / 8. );
+                    break;
+                case 1:
+                    constant->setValue( (long)( nextRandom( randomState ) % 9 + 1 ) );
+                    break;
+                default:
+                    constant->setValue( nextRandom( randomState ) % 2 == 0 );
+                    break;
+                }
+                return constant;
+            }
+        case 3:
+        case 4:
+            {
+                ArithmeticExpression* arithmetic = new ArithmeticExpression();
+                ArithmeticExpression::Operator op = (ArithmeticExpression::Operator)( nextRandom( randomState ) % 4 );
+                arithmetic->setOperator( op );
+                size_t operandCount = 2 + nextRandom( randomState ) % 2;
+                for ( size_t i = 0; i < operandCount; ++i )
+                {
+                    INode* operand = createFormula( depth - 1, inFragment, randomState );
+                    if ( ( op == ArithmeticExpression::DIV ) && ( i > 0 ) )
+                    {
+                        if ( nextRandom( randomState ) % 2 == 0 )
+                        {
+                            delete operand;
+                            ConstantExpression* divisor = new ConstantExpression();
+                            divisor->setValue( (long)( nextRandom( randomState ) % 9 + 1 ) );
+                            operand = divisor;
+                        }
+                        else
+                        {
+                            operand = toDouble( operand );
+                        }
+                    }
+                    arithmetic->addOperand( operand );
+                }
+                return arithmetic;
+            }
+        case 5:
+            {
+                BinaryComparisonExpression* comparison = new BinaryComparisonExpression();
+                comparison->setOperator( (BinaryComparisonExpression::Operator)( nextRandom( randomState ) % 6 ) );
+                comparison->setLeftOperand( createFormula( depth - 1, inFragment, randomState ) );
+                comparison->setRightOperand( createFormula( depth - 1, inFragment, randomState ) );
+                return comparison;
+            }
+        case 6:
+            {
+                LogicExpression* logic = new LogicExpression();
+                logic->setOperator( (LogicExpression::Operator)( nextRandom( randomState ) % 3 ) );
+                logic->addOperand( createFormula( depth - 1, inFragment, randomState ) );
+                logic->addOperand( createFormula( depth - 1, inFragment, randomState ) );
+                return logic;
+            }
+        case 7:
+            {
+                UnaryExpression* unary = new UnaryExpression();
+                unary->setOperator( (UnaryExpression::Operator)( nextRandom( randomState ) % 3 ) );
+                unary->setOperand( createFormula( depth - 1, inFragment, randomState ) );
+                return unary;
+            }
+        case 8:
+            {
+                const size_t functionCount = sizeof( unaryFunctions ) / sizeof( unaryFunctions[0] );
+                FunctionExpression* function = new FunctionExpression( unaryFunctions[ nextRandom( randomState ) % functionCount ] );
+                function->addParameter( createFormula( depth - 1, inFragment, randomState ) );
+                return function;
+            }
+        case 9:
+            {
+                size_t index = nextRandom( randomState ) % ( sizeof( naryFunctions ) / sizeof( naryFunctions[0] ) );
+                FunctionExpression* function = new FunctionExpression( naryFunctions[index] );
+                // min and max take any number of parameters, the others two
+                size_t parameterCount = ( index < 2 ) ? 1 + nextRandom( randomState ) % 3 : 2;
+                for ( size_t i = 0; i < parameterCount; ++i )
+                    function->addParameter( createFormula( depth - 1, inFragment, randomState ) );
+                return function;
+            }
+        case 10:
+            {
+                FragmentExpression* fragment = new FragmentExpression( "fragment",
+                    (INode::CloneFlags)( INode::CLONEFLAG_DEEPCOPY_FRAGMENT | INode::CLONEFLAG_DEEPCOPY_FRAGMENT_PARAMS ) );
+                fragment->addParameter( "p", createFormula( depth - 1, false, randomState ) );
+                fragment->setFragment( createFormula( depth - 1, true, randomState ) );
+                return fragment;
+            }
+        case 2:
+            return new VariableExpression( "x" );
+        default:
+            return new VariableExpression( "y" );
+        }
+    }
+
+    /** Returns true, if @a a and @a b have the same bits or are both NaN. */
+    bool isSame( double a, double b )
+    {
+        if ( ( a != a ) && ( b != b ) )
+            return true;
+        return memcmp( &a, &b, sizeof( double ) ) == 0;
+    }
+}
+
+//------------------------------
+size_t compiledExpressionUnitTest()
+{
+    std::cout << "compiledExpressionUnitTest()" << std::endl;
+
+    size_t errorCount = 0;
+    size_t compiledCount = 0;
+    unsigned int randomState = 3;
+
+    // k refers to a formula, which is inlined by the compiler
+    ArithmeticExpression k;
+    k.setOperator( ArithmeticExpression::MUL );
+    k.addOperand( new VariableExpression( "x" ) );
+    k.addOperand( new VariableExpression( "y" ) );
+
+    SymbolTable symbolTable( 0 );
+    SolverFunctionExtentions::addAllExtensionFunctions( symbolTable );
+    symbolTable.addFunction( "twice", 1, twice );
+    symbolTable.setVariable( "k", &k );
+
+    StringVector inputNames;
+    inputNames.push_back( "x" );
+    inputNames.push_back( "y" );
+    inputNames.push_back( "z" );
+
+    CountingErrorHandler errorHandler;
+
+    for ( size_t formulaIndex = 0; formulaIndex < formulaCount; ++formulaIndex )
+    {
+        INode* formula = createFormula( formulaDepth, false, randomState );
+
+        CompiledExpression compiledExpression;
+        if ( !compiledExpression.compile( formula, inputNames, symbolTable, &errorHandler ) )
+        {
+            delete formula;
+            continue;
+        }
+        ++compiledCount;
+
+        double xs[inputSetCount];
+        double ys[inputSetCount];
+        double zs[inputSetCount];
+        for ( size_t i = 0; i < inputSetCount; ++i )
+        {
+            xs[i] = ( (int)( nextRandom( randomState ) % 64 ) - 32 ) / 4.;
+            ys[i] = ( (int)( nextRandom( randomState ) % 64 ) - 32 ) / 4.;
+            zs[i] = ( (int)( nextRandom( randomState ) % 64 ) - 32 ) / 4.;
+        }
+        const double* inputs[3] = { xs, ys, zs };
+        double batchResults[inputSetCount];
+        compiledExpression.evaluate( inputs, inputSetCount, batchResults );
+
+        for ( size_t i = 0; i < inputSetCount; ++i )
+        {
+            // the symbol table does not own its variables, the ones set by value are never deleted
+            ConstantExpression x, y, z;
+            x.setValue( xs[i] );
+            y.setValue( ys[i] );
+            z.setValue( zs[i] );
+            SymbolTable scope( symbolTable );
+            scope.setVariable( "x", &x );
+            scope.setVariable( "y", &y );
+            scope.setVariable( "z", &z );
+            EvaluatorVisitor evaluator( scope, 0 );
+            formula->accept( &evaluator );
+            double expected = evaluator.getValue().getDoubleValue();
+
+            double inputSet[3] = { xs[i], ys[i], zs[i] };
+            double result = compiledExpression.evaluate( inputSet );
+
+            if ( isSame( expected, result ) && isSame( expected, batchResults[i] )
+                && ( evaluator.getValue().getType() == compiledExpression.getResultType() ) )
+            {
+                continue;
+            }
+
+            if ( errorCount < maxReportedErrors )
+            {
+                std::cout << "      don't match     formula " << formulaIndex << " ";
+                StringVisitor stringVisitor( &std::cout );
+                formula->accept( &stringVisitor );
+                std::cout << " at (" << xs[i] << ", " << ys[i] << ", " << zs[i] << "): " << result << " and " << batchResults[i]
+                    << " of type " << compiledExpression.getResultType() << " and " << expected << " of type "
+                    << evaluator.getValue().getType() << std::endl;
+            }
+            ++errorCount;
+        }
+
+        delete formula;
+    }
+
+    std::cout << "compiled " << compiledCount << " of " << formulaCount << " formulas, evaluated each with "
+        << inputSetCount << " input sets, " << errorCount << " differences" << std::endl;
+
+    // without compiled formulas nothing has been compared
+    return compiledCount == 0 ? 1 : errorCount;
+}
@@ -42,6 +42,9 @@ namespace GeneratedSaxParser
 		size_t getLineNumer()const;
 		size_t getColumnNumer()const;
 
+	protected:
+		size_t getBytesConsumed()const;
+
 	private:
 		/** Disable default copy ctor. */
 		ExpatSaxParser( const SaxParser& pre );
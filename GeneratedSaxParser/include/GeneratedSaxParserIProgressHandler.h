@@ -0,0 +1,48 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of GeneratedSaxParser.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __GENERATEDSAXPARSER_IPROGRESSHANDLER_H__
+#define __GENERATEDSAXPARSER_IPROGRESSHANDLER_H__
+
+#include "GeneratedSaxParserPrerequisites.h"
+#include "GeneratedSaxParserTypes.h"
+
+
+namespace GeneratedSaxParser
+{
+
+	class IProgressHandler
+	{
+	public:
+		IProgressHandler(){};
+		virtual ~IProgressHandler(){};
+
+		/** Notification of the parsing progress. Called by the sax parser each time the configured number of
+		bytes has been parsed and once, when the document has been parsed completely.
+		@param bytesConsumed The number of bytes of the document parsed so far.
+		@param totalBytes The size of the document in bytes. 0, if the size is unknown.
+		@param topLevelElementName The name of the child element of the root element currently parsed.
+		Null, if no such element is open.
+		@returns If false is returned, the parser stops parsing immediately and the parse is reported as
+		failed.
+		*/
+		virtual bool handleProgress( size_t bytesConsumed, size_t totalBytes, const ParserChar* topLevelElementName ) = 0;
+
+	private:
+        /** Disable default copy ctor. */
+		IProgressHandler( const IProgressHandler& pre );
+        /** Disable default assignment operator. */
+		const IProgressHandler& operator= ( const IProgressHandler& pre );
+
+	};
+
+} // namespace GeneratedSaxParser
+
+#endif // __GENERATEDSAXPARSER_IPROGRESSHANDLER_H__
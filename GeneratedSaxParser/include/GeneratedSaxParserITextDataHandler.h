@@ -0,0 +1,43 @@
+/*
+    Copyright (c) 2008-2009 NetAllied Systems GmbH
+
+    This file is part of GeneratedSaxParser.
+
+    Licensed under the MIT Open Source License,
+    for details please see LICENSE file or the website
+    http://www.opensource.org/licenses/mit-license.php
+*/
+
+#ifndef __GENERATEDSAXPARSER_ITEXTDATAHANDLER_H__
+#define __GENERATEDSAXPARSER_ITEXTDATAHANDLER_H__
+
+#include "GeneratedSaxParserPrerequisites.h"
+#include "GeneratedSaxParserTypes.h"
+
+
+namespace GeneratedSaxParser
+{
+
+	class ITextDataHandler
+	{
+	public:
+		ITextDataHandler(){};
+		virtual ~ITextDataHandler(){};
+
+		/** Receives the raw character data of an element, the text data has been redirected to. The data
+		of one element might be split into several calls.
+		@returns If false is returned, the parser stops parsing and the parse is reported as failed.
+		*/
+		virtual bool textData( const ParserChar* text, size_t textLength ) = 0;
+
+	private:
+        /** Disable default copy ctor. */
+		ITextDataHandler( const ITextDataHandler& pre );
+        /** Disable default assignment operator. */
+		const ITextDataHandler& operator= ( const ITextDataHandler& pre );
+
+	};
+
+} // namespace GeneratedSaxParser
+
+#endif // __GENERATEDSAXPARSER_ITEXTDATAHANDLER_H__
@@ -39,6 +39,9 @@ namespace GeneratedSaxParser
 		size_t getLineNumer()const;
 		size_t getColumnNumer()const;
 
+	protected:
+		size_t getBytesConsumed()const;
+
 	private:
         /** Disable default copy ctor. */
 		LibxmlSaxParser( const LibxmlSaxParser& pre );
@@ -18,6 +18,7 @@
 #include "GeneratedSaxParserParserTemplateBase.h"
 #include "GeneratedSaxParserIUnknownElementHandler.h"
 #include "GeneratedSaxParserINamespaceHandler.h"
+#include "GeneratedSaxParserITextDataHandler.h"
 #include "GeneratedSaxParserNamespaceStack.h"
 
 
@@ -134,6 +135,15 @@ namespace GeneratedSaxParser
         size_t mUnknownElements;
         /** Number of elements that have been opened and are in a different namespace. */
         size_t mNamespaceElements;
+        /** True, if the element currently opened should be skipped, including its children. */
+        bool mSkipCurrentElement;
+        /** Handler the text data of the element currently opened should be redirected to. */
+        ITextDataHandler* mPendingTextDataHandler;
+        /** Handler that receives the text data of the element at mTextDataHandlerLevel instead of the
+        text data function of the element. */
+        ITextDataHandler* mTextDataHandler;
+        /** Size of mElementDataStack, while the element redirected to mTextDataHandler is open. */
+        size_t mTextDataHandlerLevel;
 
 
 	public:
@@ -147,7 +157,11 @@ namespace GeneratedSaxParser
               mLaxNamespaceHandling(false),
 			  mIgnoreElements(0),
               mUnknownElements(0),
-              mNamespaceElements(0)
+              mNamespaceElements(0),
+              mSkipCurrentElement(false),
+              mPendingTextDataHandler(0),
+              mTextDataHandler(0),
+              mTextDataHandlerLevel(0)
 		  {};
 		virtual ~ParserTemplate(){};
 
@@ -177,6 +191,16 @@ namespace GeneratedSaxParser
         /** Enables/Disables lax namespace handling. */
         void setLaxNamespaceHandling(bool value) {mLaxNamespaceHandling=value;}
 
+        /** Skips the element currently opened. Must only be called from within a begin function. The
+        element is ignored, including all its children. Neither its end function nor any of the callbacks
+        of its children are called. */
+        void skipCurrentElement() {mSkipCurrentElement = true;}
+
+        /** Passes the raw text data of the element currently opened to @a handler, instead of converting
+        and passing it to its data function. Must only be called from within a begin function. The end
+        function of the element is called as usual. */
+        void redirectCurrentElementTextData(ITextDataHandler* handler) {mPendingTextDataHandler = handler;}
+
     public:
 		bool elementBegin(const ParserChar* elementName, const ParserAttributes& attributes );
 
@@ -1824,6 +1848,10 @@ namespace GeneratedSaxParser
 
         if ( mElementDataStack.empty() )
             return false;
+        if ( mTextDataHandler && (mElementDataStack.size() == mTextDataHandlerLevel) )
+        {
+            return mTextDataHandler->textData( text, textLength );
+        }
         ElementData elementData = mElementDataStack.back();
         typename ElementFunctionMap::const_iterator it;
 
@@ -1882,6 +1910,11 @@ namespace GeneratedSaxParser
 
         if ( mElementDataStack.empty() )
             return false;
+        if ( mElementDataStack.size() == mTextDataHandlerLevel )
+        {
+            mTextDataHandler = 0;
+            mTextDataHandlerLevel = 0;
+        }
         ElementData elementData = mElementDataStack.back();
 
         const ElementFunctionMap* functionMapToUse;
@@ -2056,6 +2089,8 @@ namespace GeneratedSaxParser
 			return false;
         }
 
+		mSkipCurrentElement = false;
+		mPendingTextDataHandler = 0;
 		bool success = (static_cast<DerivedClass*>(this)->*functions.beginFunction)(attributeData);
 		if ( attributeData )
         {
@@ -2067,10 +2102,27 @@ namespace GeneratedSaxParser
             }
         }
 
+		if ( success && mSkipCurrentElement )
+		{
+            mSkipCurrentElement = false;
+            mPendingTextDataHandler = 0;
+            // the end validation function, that would release the validation data, is not called
+            if ( validationData )
+                mValidationDataStack.deleteObject();
+            mIgnoreElements = 1;
+            return true;
+		}
+
 		if ( success )
 		{
             mElementDataStack.push_back(newElementData);
 			newElementData.validationData = validationData;
+            if ( mPendingTextDataHandler )
+            {
+                mTextDataHandler = mPendingTextDataHandler;
+                mTextDataHandlerLevel = mElementDataStack.size();
+                mPendingTextDataHandler = 0;
+            }
 		}
 		return success;
 	}
@@ -12,17 +12,41 @@
 #define __COLLADAPARSER_SAXPARSER_H__
 
 #include "GeneratedSaxParserPrerequisites.h"
+#include "GeneratedSaxParserTypes.h"
 
 
 namespace GeneratedSaxParser
 {
 	class Parser;
+	class IProgressHandler;
 
 	class SaxParser
 	{
 
 	private:
 		Parser* mParser;
+
+		/** The handler the parsing progress is reported to. Might be null.*/
+		IProgressHandler* mProgressHandler;
+
+		/** The number of bytes parsed between two notifications of the progress handler.*/
+		size_t mProgressInterval;
+
+		/** The number of consumed bytes, at which the progress handler is notified the next time.*/
+		size_t mNextProgressBytes;
+
+		/** The size of the document currently parsed. 0, if unknown.*/
+		size_t mTotalBytes;
+
+		/** The depth of the element currently parsed. The root element has depth 1.*/
+		size_t mElementDepth;
+
+		/** The name of the currently open child element of the root element.*/
+		String mTopLevelElementName;
+
+		/** True, if the progress handler requested to stop parsing.*/
+		bool mCancelled;
+
 	public:
 		SaxParser(Parser* parser);
 		virtual ~SaxParser();
@@ -36,6 +60,44 @@ namespace GeneratedSaxParser
 		Parser* getParser(){return mParser;}
         void setParser( Parser* parser );
 
+		/** Sets the handler the parsing progress is reported to.
+		@param progressHandler The progress handler. Null disables the reporting.
+		@param progressInterval The number of bytes parsed between two notifications.*/
+		void setProgressHandler( IProgressHandler* progressHandler, size_t progressInterval );
+
+		/** Returns true, if the progress handler requested to stop the last parse.*/
+		bool isCancelled() const { return mCancelled; }
+
+	protected:
+		/** Returns the number of bytes of the document parsed so far.*/
+		virtual size_t getBytesConsumed() const = 0;
+
+		/** Returns true, if a progress handler is set. The implementations check this before calling one of
+		the other progress methods, to keep the overhead low if no handler is set.*/
+		bool hasProgressHandler() const { return mProgressHandler != 0; }
+
+		/** Prepares the progress reporting for a new document of size @a totalBytes.*/
+		void startProgress( size_t totalBytes );
+
+		/** Tracks the begin of an element and notifies the progress handler, if required.
+		@return False, if the parser should stop parsing.*/
+		bool elementBeginProgress( const ParserChar* elementName );
+
+		/** Tracks the end of an element and notifies the progress handler, if required.
+		@return False, if the parser should stop parsing.*/
+		bool elementEndProgress();
+
+		/** Notifies the progress handler, if the configured number of bytes has been parsed since the last 
+		notification.
+		@return False, if the parser should stop parsing.*/
+		bool updateProgress();
+
+		/** Notifies the progress handler, that the whole document has been parsed.*/
+		void finishProgress();
+
+		/** Returns the size of the file @a fileName in bytes or 0, if it could not be determined.*/
+		static size_t getFileSize( const char* fileName );
+
 	private:
         /** Disable default copy ctor. */
 		SaxParser( const SaxParser& pre );
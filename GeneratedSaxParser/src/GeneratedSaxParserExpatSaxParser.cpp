@@ -51,11 +51,15 @@ namespace GeneratedSaxParser
 
 		XML_Status status = XML_STATUS_OK;
 		bool isFinal = true;
+		if ( hasProgressHandler() )
+			startProgress( (size_t)length );
 		XML_Parse(mParser, buffer, (int)length, isFinal);
+		if ( hasProgressHandler() )
+			finishProgress();
 
 		XML_ParserFree(mParser);
 
-		return status != XML_STATUS_ERROR;
+		return (status != XML_STATUS_ERROR) && !isCancelled();
 	}
 	bool ExpatSaxParser::parseFile( const char* fileName )
 	{
@@ -77,23 +81,32 @@ namespace GeneratedSaxParser
 
 
 		XML_Status status = XML_STATUS_OK;
+		if ( hasProgressHandler() )
+			startProgress( getFileSize( fileName ) );
 		while (!feof(fd) && (status != XML_STATUS_ERROR) )
 		{
 			size_t length = fread(buffer, 1,  mBufferSize, fd);
 			status = XML_Parse(mParser, buffer, (int)length, feof(fd));
 		}
+		if ( hasProgressHandler() && (status != XML_STATUS_ERROR) )
+			finishProgress();
 
 		fclose (fd);
 		free (buffer);
 		XML_ParserFree(mParser);
 
-		return status != XML_STATUS_ERROR;
+		return (status != XML_STATUS_ERROR) && !isCancelled();
 	}
 
 	//--------------------------------------------------------------------
 	void ExpatSaxParser::startElement( void* user_data, const XML_Char* name, const XML_Char** attrs )
 	{
 		ExpatSaxParser* thisObject = (ExpatSaxParser*)user_data;
+		if ( thisObject->hasProgressHandler() && !thisObject->elementBeginProgress((const ParserChar*)name) )
+		{
+			thisObject->abortParsing();
+			return;
+		}
 		Parser* parser = thisObject->getParser();
 		if ( !parser->elementBegin((const ParserChar*)name, (const ParserChar**)attrs) )
 			thisObject->abortParsing();
@@ -107,6 +120,8 @@ namespace GeneratedSaxParser
 		Parser* parser = thisObject->getParser();
 		if ( !parser->elementEnd((const ParserChar*)name) )
 			thisObject->abortParsing();
+		else if ( thisObject->hasProgressHandler() && !thisObject->elementEndProgress() )
+			thisObject->abortParsing();
 	}
 
 
@@ -117,6 +132,8 @@ namespace GeneratedSaxParser
 		Parser* parser = thisObject->getParser();
 		if ( !parser->textData((const ParserChar*)name, (size_t)length) )
 			thisObject->abortParsing();
+		else if ( thisObject->hasProgressHandler() && !thisObject->updateProgress() )
+			thisObject->abortParsing();
 	}
 
 	//--------------------------------------------------------------------
@@ -132,6 +149,13 @@ namespace GeneratedSaxParser
 		return (size_t) XML_GetCurrentColumnNumber(mParser);
 	}
 
+	//--------------------------------------------------------------------
+	size_t ExpatSaxParser::getBytesConsumed() const
+	{
+		XML_Index byteIndex = XML_GetCurrentByteIndex(mParser);
+		return byteIndex < 0 ? 0 : (size_t)byteIndex;
+	}
+
 	//--------------------------------------------------------------------
 	void ExpatSaxParser::abortParsing()
 	{
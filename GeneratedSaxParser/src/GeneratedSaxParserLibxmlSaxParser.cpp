@@ -100,7 +100,11 @@ namespace GeneratedSaxParser
 			mParserContext->userData = (void*)this;
 
 			initializeParserContext();
+			if ( hasProgressHandler() )
+				startProgress( getFileSize( fileName ) );
 			xmlParseDocument(mParserContext);
+			if ( hasProgressHandler() )
+				finishProgress();
 
 			mParserContext->sax = 0;
 
@@ -113,7 +117,7 @@ namespace GeneratedSaxParser
 			xmlFreeParserCtxt(mParserContext);
 			mParserContext = 0;
 
-			return true;
+			return !isCancelled();
 	}
 
 	bool LibxmlSaxParser::parseBuffer( const char* uri, const char* buffer, int length )
@@ -149,7 +153,11 @@ namespace GeneratedSaxParser
         mParserContext->userData = (void*)this;
         
         initializeParserContext();
+        if ( hasProgressHandler() )
+            startProgress( (size_t)length );
         xmlParseDocument(mParserContext);
+        if ( hasProgressHandler() )
+            finishProgress();
         
         mParserContext->sax = 0;
         
@@ -162,7 +170,7 @@ namespace GeneratedSaxParser
         xmlFreeParserCtxt(mParserContext);
         mParserContext = 0;
         
-        return true;
+        return !isCancelled();
 	}
 
 	void LibxmlSaxParser::initializeParserContext()
@@ -175,6 +183,11 @@ namespace GeneratedSaxParser
 	void LibxmlSaxParser::startElement( void* user_data, const ::xmlChar* name, const ::xmlChar** attrs )
 	{
 		LibxmlSaxParser* thisObject = (LibxmlSaxParser*)user_data;
+		if ( thisObject->hasProgressHandler() && !thisObject->elementBeginProgress((const ParserChar*)name) )
+		{
+			thisObject->abortParsing();
+			return;
+		}
 		Parser* parser = thisObject->getParser();
 		if ( !parser->elementBegin((const ParserChar*)name, (const ParserChar**)attrs) )
 			thisObject->abortParsing();
@@ -186,6 +199,8 @@ namespace GeneratedSaxParser
 		Parser* parser = thisObject->getParser();
 		if ( !parser->elementEnd((const ParserChar*)name) )
 			thisObject->abortParsing();
+		else if ( thisObject->hasProgressHandler() && !thisObject->elementEndProgress() )
+			thisObject->abortParsing();
 	}
 
 
@@ -195,6 +210,8 @@ namespace GeneratedSaxParser
 		Parser* parser = thisObject->getParser();
 		if ( !parser->textData((const ParserChar*)name, (size_t)length) )
 			thisObject->abortParsing();
+		else if ( thisObject->hasProgressHandler() && !thisObject->updateProgress() )
+			thisObject->abortParsing();
 	}
 
 	void LibxmlSaxParser::abortParsing()
@@ -212,6 +229,12 @@ namespace GeneratedSaxParser
 		return (size_t)xmlSAX2GetColumnNumber(mParserContext);
 	}
 
+	size_t LibxmlSaxParser::getBytesConsumed() const
+	{
+		long bytesConsumed = xmlByteConsumed(mParserContext);
+		return bytesConsumed < 0 ? 0 : (size_t)bytesConsumed;
+	}
+
 	void LibxmlSaxParser::errorFunction( void *userData, const char *msg, ... )
 	{
         // if msg is just one string, get it. Otherwise ignore it.
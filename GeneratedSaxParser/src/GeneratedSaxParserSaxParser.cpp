@@ -10,12 +10,22 @@
 
 #include "GeneratedSaxParserSaxParser.h"
 #include "GeneratedSaxParserParser.h"
+#include "GeneratedSaxParserIProgressHandler.h"
+
+#include <sys/types.h>
+#include <sys/stat.h>
 
 namespace GeneratedSaxParser
 {
 
 	SaxParser::SaxParser( Parser* parser )
 		: mParser(parser)
+		, mProgressHandler(0)
+		, mProgressInterval(0)
+		, mNextProgressBytes(0)
+		, mTotalBytes(0)
+		, mElementDepth(0)
+		, mCancelled(false)
 	{
 		if ( parser )
 			mParser->setSaxParser(this);
@@ -36,4 +46,79 @@ namespace GeneratedSaxParser
         }
     }
 
+	//--------------------------------------------------------------------
+	void SaxParser::setProgressHandler( IProgressHandler* progressHandler, size_t progressInterval )
+	{
+		mProgressHandler = progressHandler;
+		mProgressInterval = progressInterval;
+	}
+
+	//--------------------------------------------------------------------
+	void SaxParser::startProgress( size_t totalBytes )
+	{
+		mNextProgressBytes = mProgressInterval;
+		mTotalBytes = totalBytes;
+		mElementDepth = 0;
+		mTopLevelElementName.clear();
+		mCancelled = false;
+	}
+
+	//--------------------------------------------------------------------
+	bool SaxParser::elementBeginProgress( const ParserChar* elementName )
+	{
+		if ( ++mElementDepth == 2 )
+			mTopLevelElementName = elementName;
+		return updateProgress();
+	}
+
+	//--------------------------------------------------------------------
+	bool SaxParser::elementEndProgress()
+	{
+		if ( mElementDepth-- == 2 )
+			mTopLevelElementName.clear();
+		return updateProgress();
+	}
+
+	//--------------------------------------------------------------------
+	bool SaxParser::updateProgress()
+	{
+		if ( mCancelled )
+			return false;
+
+		size_t bytesConsumed = getBytesConsumed();
+		if ( bytesConsumed < mNextProgressBytes )
+			return true;
+		mNextProgressBytes = bytesConsumed + mProgressInterval;
+
+		const ParserChar* topLevelElementName = mTopLevelElementName.empty() ? 0 : mTopLevelElementName.c_str();
+		if ( !mProgressHandler->handleProgress( bytesConsumed, mTotalBytes, topLevelElementName ) )
+			mCancelled = true;
+		return !mCancelled;
+	}
+
+	//--------------------------------------------------------------------
+	void SaxParser::finishProgress()
+	{
+		if ( mCancelled )
+			return;
+		size_t bytesConsumed = mTotalBytes ? mTotalBytes : getBytesConsumed();
+		if ( !mProgressHandler->handleProgress( bytesConsumed, mTotalBytes, 0 ) )
+			mCancelled = true;
+	}
+
+	//--------------------------------------------------------------------
+	size_t SaxParser::getFileSize( const char* fileName )
+	{
+#if defined(COLLADABU_OS_WIN)
+		struct _stat64 fileStatus;
+		if ( _stat64( fileName, &fileStatus ) != 0 )
+			return 0;
+#else
+		struct stat fileStatus;
+		if ( stat( fileName, &fileStatus ) != 0 )
+			return 0;
+#endif
+		return (size_t)fileStatus.st_size;
+	}
+
 } // namespace COLLADAPARSER
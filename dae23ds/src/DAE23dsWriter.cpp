@@ -19,6 +19,7 @@
 #include "DAE23dsMaterialsWriter.h"
 
 #include "COLLADASaxFWLLoader.h"
+#include "COLLADASaxFWLWriterRecorder.h"
 
 #include "COLLADAFWRoot.h"
 #include "COLLADAFWGeometry.h"
@@ -113,7 +114,10 @@ namespace DAE23ds
 	bool Writer::write()
 	{
 		COLLADASaxFWL::Loader loader;
-		COLLADAFW::Root root(&loader, this);
+		// the objects of the scene graph run are recorded, to replay the geometries without parsing the
+		// document again
+		COLLADASaxFWL::WriterRecorder recorder(this);
+		COLLADAFW::Root root(&loader, &recorder);
 
 		Common::FWriteBufferFlusher bufferFlusher( getOutputFile().toNativePath().c_str(), FLUSHERBUFFERSIZE );
 		Common::Buffer buffer( BUFFERSIZE, &bufferFlusher);
@@ -144,8 +148,18 @@ namespace DAE23ds
 
 		// load and write geometries
 		mCurrentRun = GEOMETRY_RUN;
-		if ( !root.loadDocument(mInputFile.toNativePath()) )
-			return false;
+		if ( recorder.isRecorded() )
+		{
+			COLLADASaxFWL::BinaryCacheLoader::RecordTypeList recordTypes( 1, COLLADASaxFWL::BinaryCacheFormat::RECORD_GEOMETRY );
+			if ( !recorder.replay(this, recordTypes) )
+				return false;
+		}
+		else
+		{
+			COLLADAFW::Root geometryRoot(&loader, this);
+			if ( !geometryRoot.loadDocument(mInputFile.toNativePath()) )
+				return false;
+		}
 
 		SceneGraphWriter sceneGraphWriter(this, mVisualScene, mLibraryNodesList);
 		sceneGraphWriter.write( sceneGraphHandler.getScenegraphLength() );
@@ -14,6 +14,7 @@ http://www.opensource.org/licenses/mit-license.php
 #include "DAE2OgreSceneGraphWriter.h"
 
 #include "COLLADASaxFWLLoader.h"
+#include "COLLADASaxFWLWriterRecorder.h"
 
 #include "COLLADAFWRoot.h"
 #include "COLLADAFWGeometry.h"
@@ -69,7 +70,10 @@ namespace DAE2Ogre
 	bool OgreWriter::write()
 	{
 		COLLADASaxFWL::Loader loader;
-		COLLADAFW::Root root(&loader, this);
+		// the objects of the scene graph run are recorded, to replay the geometries without parsing the
+		// document again
+		COLLADASaxFWL::WriterRecorder recorder(this);
+		COLLADAFW::Root root(&loader, &recorder);
 
 		// Load scene graph 
 		if ( !root.loadDocument(mInputFile.toNativePath()) )
@@ -84,8 +88,18 @@ namespace DAE2Ogre
 
 		// load and write geometries
 		mCurrentRun = GEOMETRY_RUN;
-		if ( !root.loadDocument(mInputFile.toNativePath()) )
-			return false;
+		if ( recorder.isRecorded() )
+		{
+			COLLADASaxFWL::BinaryCacheLoader::RecordTypeList recordTypes( 1, COLLADASaxFWL::BinaryCacheFormat::RECORD_GEOMETRY );
+			if ( !recorder.replay(this, recordTypes) )
+				return false;
+		}
+		else
+		{
+			COLLADAFW::Root geometryRoot(&loader, this);
+			if ( !geometryRoot.loadDocument(mInputFile.toNativePath()) )
+				return false;
+		}
 
 		return true;
 	}